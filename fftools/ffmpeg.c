@@ -68,6 +68,7 @@
 #include <conio.h>
 #endif
 
+#include "libavutil/avstring.h"
 #include "libavutil/bprint.h"
 #include "libavutil/dict.h"
 #include "libavutil/mem.h"
@@ -316,6 +317,7 @@ static void ffmpeg_cleanup(int ret)
     for (int i = 0; i < nb_filtergraphs; i++)
         fg_free(&filtergraphs[i]);
     av_freep(&filtergraphs);
+    nb_filtergraphs = 0;
 
     for (int i = 0; i < nb_output_files; i++)
         of_free(&output_files[i]);
@@ -326,6 +328,7 @@ static void ffmpeg_cleanup(int ret)
     for (int i = 0; i < nb_decoders; i++)
         dec_free(&decoders[i]);
     av_freep(&decoders);
+    nb_decoders = 0;
 
     if (vstats_file) {
         if (fclose(vstats_file))
@@ -341,7 +344,9 @@ static void ffmpeg_cleanup(int ret)
     av_freep(&filter_nbthreads);
 
     av_freep(&input_files);
+    nb_input_files = 0;
     av_freep(&output_files);
+    nb_output_files = 0;
 
     uninit_opts();
 
@@ -558,7 +563,8 @@ void update_benchmark(const char *fmt, ...)
     }
 }
 
-static void print_report(int is_last_report, int64_t timer_start, int64_t cur_time, int64_t pts)
+static void print_report(Scheduler *sch, int is_last_report,
+                         int64_t timer_start, int64_t cur_time, int64_t pts)
 {
     AVBPrint buf, buf_script;
     int64_t total_size = of_filesize(output_files[0]);
@@ -704,6 +710,7 @@ static void print_report(int is_last_report, int64_t timer_start, int64_t cur_ti
     av_bprint_finalize(&buf, NULL);
 
     if (progress_avio) {
+        sch_dump_queue_stats(sch, &buf_script);
         av_bprintf(&buf_script, "progress=%s\n",
                    is_last_report ? "end" : "continue");
         avio_write(progress_avio, buf_script.str,
@@ -904,7 +911,7 @@ static int transcode(Scheduler *sch)
                 break;
 
         /* dump report by using the output first video and audio streams */
-        print_report(0, timer_start, cur_time, transcode_ts);
+        print_report(sch, 0, timer_start, cur_time, transcode_ts);
     }
 
     ret = sch_stop(sch, &transcode_ts);
@@ -918,7 +925,7 @@ static int transcode(Scheduler *sch)
     term_exit();
 
     /* dump report by using the first video and audio streams */
-    print_report(1, timer_start, av_gettime_relative(), transcode_ts);
+    print_report(sch, 1, timer_start, av_gettime_relative(), transcode_ts);
 
     return ret;
 }
@@ -967,27 +974,13 @@ static int64_t getmaxrss(void)
 #endif
 }
 
-int main(int argc, char **argv)
+static int run_job(int argc, char **argv)
 {
     Scheduler *sch = NULL;
 
     int ret;
     BenchmarkTimeStamps ti;
 
-    init_dynload();
-
-    setvbuf(stderr,NULL,_IONBF,0); /* win32 runtime needs this */
-
-    av_log_set_flags(AV_LOG_SKIP_REPEATED);
-    parse_loglevel(argc, argv, options);
-
-#if CONFIG_AVDEVICE
-    avdevice_register_all();
-#endif
-    avformat_network_init();
-
-    show_banner(argc, argv, options);
-
     sch = sch_alloc();
     if (!sch) {
         ret = AVERROR(ENOMEM);
@@ -1038,3 +1031,135 @@ finish:
 
     return ret;
 }
+
+#define DAEMON_LINE_SIZE (1 << 16)
+#define DAEMON_MAX_ARGS  1024
+
+// Split a job line into arguments in-place; supports double quotes and
+// backslash escapes. Returns the number of arguments produced.
+static int daemon_split_args(char *line, char **argv, int max_args)
+{
+    char *p = line;
+    int argc = 0;
+
+    while (*p) {
+        char *out;
+
+        while (av_isspace(*p))
+            p++;
+        if (!*p)
+            break;
+        if (argc >= max_args)
+            return AVERROR(E2BIG);
+
+        argv[argc++] = out = p;
+        while (*p && !av_isspace(*p)) {
+            if (*p == '\\' && p[1]) {
+                p++;
+                *out++ = *p++;
+            } else if (*p == '"') {
+                p++;
+                while (*p && *p != '"') {
+                    if (*p == '\\' && p[1])
+                        p++;
+                    *out++ = *p++;
+                }
+                if (*p)
+                    p++;
+            } else
+                *out++ = *p++;
+        }
+        if (*p)
+            p++;
+        *out = 0;
+    }
+
+    return argc;
+}
+
+/**
+ * Daemon mode: run one job per line read from stdin through the regular
+ * transcoding machinery, amortizing process startup (dynamic loading, codec
+ * and network initialization) over many short jobs. Job status is reported
+ * through the log; the process exits on EOF or on a termination signal.
+ */
+static int daemon_run(const char *prog)
+{
+    char *line;
+    int ret = 0;
+
+    // stdin carries job lines, it cannot also be used for interaction
+    stdin_interaction = 0;
+
+    line = av_malloc(DAEMON_LINE_SIZE);
+    if (!line)
+        return AVERROR(ENOMEM);
+
+    while (fgets(line, DAEMON_LINE_SIZE, stdin)) {
+        char *argv[DAEMON_MAX_ARGS + 2];
+        size_t len = strlen(line);
+        int argc;
+
+        if (len && line[len - 1] == '\n')
+            line[len - 1] = 0;
+        else if (len == DAEMON_LINE_SIZE - 1) {
+            av_log(NULL, AV_LOG_ERROR, "Daemon job line too long, skipping\n");
+            // drain the rest of the oversized line
+            while (fgets(line, DAEMON_LINE_SIZE, stdin) &&
+                   strlen(line) == DAEMON_LINE_SIZE - 1 &&
+                   line[DAEMON_LINE_SIZE - 2] != '\n')
+                ;
+            continue;
+        }
+
+        argv[0] = (char*)prog;
+        argc = daemon_split_args(line, argv + 1, DAEMON_MAX_ARGS);
+        if (argc < 0) {
+            av_log(NULL, AV_LOG_ERROR, "Too many arguments in daemon job line\n");
+            continue;
+        }
+        if (!argc)
+            continue;
+        argv[argc + 1] = NULL;
+
+        ffmpeg_exited = 0;
+        atomic_store(&transcode_init_done, 0);
+
+        // rebalance the deinit done in ffmpeg_cleanup() at the end of
+        // the previous job
+        avformat_network_init();
+
+        ret = run_job(argc + 1, argv);
+
+        av_log(NULL, AV_LOG_INFO, "Daemon job finished with status %d\n", ret);
+
+        if (received_nb_signals)
+            break;
+    }
+
+    av_free(line);
+
+    return ret;
+}
+
+int main(int argc, char **argv)
+{
+    init_dynload();
+
+    setvbuf(stderr,NULL,_IONBF,0); /* win32 runtime needs this */
+
+    av_log_set_flags(AV_LOG_SKIP_REPEATED);
+    parse_loglevel(argc, argv, options);
+
+#if CONFIG_AVDEVICE
+    avdevice_register_all();
+#endif
+    avformat_network_init();
+
+    show_banner(argc, argv, options);
+
+    if (argc == 2 && !strcmp(argv[1], "-daemon"))
+        return daemon_run(argv[0]);
+
+    return run_job(argc, argv);
+}
@@ -109,6 +109,10 @@ typedef struct HWDevice {
     const char *name;
     enum AVHWDeviceType type;
     AVBufferRef *device_ref;
+    // device ordinal/path the context was created from, when created
+    // implicitly through hw_device_init_from_type(); used for sharing
+    // one context between all consumers of the same (type, device) pair
+    char *device;
 } HWDevice;
 
 enum ViewSpecifierType {
@@ -166,6 +170,7 @@ typedef struct OptionsContext {
     float readrate_catchup;
     double readrate_initial_burst;
     int accurate_seek;
+    int preroll_fast;
     int thread_queue_size;
     int input_sync_ref;
     int find_stream_info;
@@ -255,6 +260,8 @@ typedef struct OptionsContext {
     SpecifierOptList enc_stats_pre_fmt;
     SpecifierOptList enc_stats_post_fmt;
     SpecifierOptList mux_stats_fmt;
+    SpecifierOptList enc_stats_ring;
+    SpecifierOptList enc_stats_ring_size;
 } OptionsContext;
 
 enum IFilterFlags {
@@ -412,6 +419,9 @@ enum DecoderFlags {
     DECODER_FLAG_SEND_END_TS      = (1 << 4),
     // force bitexact decoding
     DECODER_FLAG_BITEXACT         = (1 << 5),
+    // speed up decoding of the discarded preroll before the accurate-seek
+    // target given by DecoderOpts.preroll_end_us
+    DECODER_FLAG_PREROLL_FAST     = (1 << 6),
 };
 
 enum CroppingType {
@@ -438,6 +448,11 @@ typedef struct DecoderOpts {
 
     AVRational                  time_base;
 
+    // End of the accurate-seek preroll in AV_TIME_BASE units; frames before
+    // it are discarded by the trim filter, so they may be decoded with
+    // quality-lowering shortcuts. Valid when DECODER_FLAG_PREROLL_FAST is set.
+    int64_t                     preroll_end_us;
+
     // Either forced (when DECODER_FLAG_FRAMERATE_FORCED is set) or
     // estimated (otherwise) video framerate.
     AVRational                  framerate;
@@ -589,12 +604,53 @@ typedef struct EncStats {
     int                 lock_initialized;
 } EncStats;
 
+/**
+ * Binary per-packet encoding stats ring shared with external observers
+ * through a memory-mapped file: a header followed by nb_records fixed-size
+ * records, all fields native-endian. There is a single writer (the encoder
+ * thread); readers sample lock-free by loading header.seq, copying the
+ * records of interest and then re-checking that each record's seq field is
+ * unchanged and non-zero, retrying on a mismatch (a torn read).
+ */
+typedef struct EncStatsRingHeader {
+    uint32_t magic;                 // ENC_STATS_RING_MAGIC
+    uint32_t version;               // ENC_STATS_RING_VERSION
+    uint32_t record_size;           // sizeof(EncStatsRingRecord)
+    uint32_t nb_records;            // ring capacity
+    atomic_uint_least64_t seq;      // total records published so far
+    uint8_t  pad[40];               // pad the header to a cacheline
+} EncStatsRingHeader;
+
+typedef struct EncStatsRingRecord {
+    atomic_uint_least64_t seq;      // 1-based publication counter; 0 while the record is rewritten
+    int64_t  pts;                   // in tb_num/tb_den
+    int64_t  dts;
+    int32_t  tb_num;
+    int32_t  tb_den;
+    int32_t  size;                  // packet size in bytes
+    int32_t  quality;               // as in AV_PKT_DATA_QUALITY_STATS, -1 if unknown
+    uint32_t flags;                 // AV_PKT_FLAG_*
+    uint32_t pict_type;             // AVPictureType, AV_PICTURE_TYPE_NONE if unknown
+    int64_t  wallclock_us;          // av_gettime() when the packet left the encoder
+    int64_t  enc_latency_us;        // time spent inside the encoder, -1 if unknown
+} EncStatsRingRecord;
+
+#define ENC_STATS_RING_MAGIC   MKTAG('F', 'E', 'S', 'R')
+#define ENC_STATS_RING_VERSION 1
+
+typedef struct EncStatsRing {
+    EncStatsRingHeader *header;     // NULL when the ring is disabled
+    EncStatsRingRecord *records;
+    size_t              map_size;
+} EncStatsRing;
+
 enum {
     KF_FORCE_SOURCE         = 1,
 #if FFMPEG_OPT_FORCE_KF_SOURCE_NO_DROP
     KF_FORCE_SOURCE_NO_DROP = 2,
 #endif
-    // force keyframe if lavfi.scd.time metadata is set
+    // force keyframe if lavfi.scd.time metadata is set, or when
+    // scd_max_interval seconds passed since the last forced keyframe
     KF_FORCE_SCD_METADATA = 3,
 };
 
@@ -611,6 +667,11 @@ typedef struct KeyframeForceCtx {
     AVExpr      *pexpr;
     double       expr_const_values[FKF_NB];
 
+    // for KF_FORCE_SCD_METADATA - upper bound on the distance between
+    // forced keyframes in seconds, 0 for no bound
+    double       scd_max_interval;
+    double       scd_prev_forced_t;
+
     int          dropped_keyframe;
 } KeyframeForceCtx;
 
@@ -672,6 +733,7 @@ typedef struct OutputStream {
 
     EncStats enc_stats_pre;
     EncStats enc_stats_post;
+    EncStatsRing enc_stats_ring;
 
     /*
      * bool on whether this stream should be utilized for splitting
@@ -835,6 +897,10 @@ void enc_stats_write(OutputStream *ost, EncStats *es,
                      const AVFrame *frame, const AVPacket *pkt,
                      uint64_t frame_num);
 
+int  enc_stats_ring_init(OutputStream *ost, EncStatsRing *ring,
+                         const char *path, int nb_records);
+void enc_stats_ring_close(EncStatsRing *ring);
+
 HWDevice *hw_device_get_by_name(const char *name);
 HWDevice *hw_device_get_by_type(enum AVHWDeviceType type);
 int hw_device_init_from_string(const char *arg, HWDevice **dev);
@@ -917,6 +983,19 @@ int64_t of_filesize(OutputFile *of);
 int ifile_open(const OptionsContext *o, const char *filename, Scheduler *sch);
 void ifile_close(InputFile **f);
 
+/**
+ * Open and probe the given inputs concurrently, using a bounded pool of
+ * worker threads, so that probe I/O and header parsing overlap.
+ *
+ * The results are picked up by the subsequent ifile_open() calls; inputs
+ * for which probing failed report their error from ifile_open(). Call
+ * ifile_probe_cleanup() once all the inputs were opened (or opening was
+ * aborted) to discard any unclaimed probe results.
+ */
+int ifile_probe_parallel(const OptionsContext *const *opts,
+                         const char *const *filenames, int nb);
+void ifile_probe_cleanup(void);
+
 int ist_use(InputStream *ist, int decoding_needed,
             const ViewSpecifier *vs, SchedulerNode *src);
 int ist_filter_add(InputStream *ist, InputFilter *ifilter, int is_simple,
@@ -961,6 +1040,7 @@ void opt_match_per_stream_group_dbl(void *logctx, const SpecifierOptList *sol,
 int view_specifier_parse(const char **pspec, ViewSpecifier *vs);
 
 int muxer_thread(void *arg);
+int muxer_packet_direct(void *arg, AVPacket *pkt, unsigned stream_idx);
 int encoder_thread(void *arg);
 
 #endif /* FFTOOLS_FFMPEG_H */
@@ -22,6 +22,7 @@
 #include "libavutil/dict.h"
 #include "libavutil/error.h"
 #include "libavutil/log.h"
+#include "libavutil/mathematics.h"
 #include "libavutil/mem.h"
 #include "libavutil/opt.h"
 #include "libavutil/pixdesc.h"
@@ -63,6 +64,13 @@ typedef struct DecoderPriv {
     unsigned            container_crop_left;
     unsigned            container_crop_right;
 
+    // end of the accurate-seek preroll in AV_TIME_BASE units, while the
+    // lowered skip_frame/skip_loop_filter settings below are in effect;
+    // AV_NOPTS_VALUE once full-quality decoding was restored
+    int64_t             preroll_end_us;
+    enum AVDiscard      preroll_skip_frame;
+    enum AVDiscard      preroll_skip_loop_filter;
+
     // pts/estimated duration of the last decoded frame
     // * in decoder timebase for video,
     // * in last_frame_tb (may change during decoding) for audio
@@ -745,6 +753,20 @@ static int packet_decode(DecoderPriv *dp, AVPacket *pkt, AVFrame *frame)
         pkt->dts = AV_NOPTS_VALUE;
     }
 
+    // restore full-quality decoding before the first packet at or past the
+    // accurate-seek target enters the decoder
+    if (dp->preroll_end_us != AV_NOPTS_VALUE &&
+        pkt && pkt->pts != AV_NOPTS_VALUE &&
+        av_compare_ts(pkt->pts, dec->pkt_timebase,
+                      dp->preroll_end_us, AV_TIME_BASE_Q) >= 0) {
+        dec->skip_frame       = dp->preroll_skip_frame;
+        dec->skip_loop_filter = dp->preroll_skip_loop_filter;
+        dp->preroll_end_us    = AV_NOPTS_VALUE;
+
+        av_log(dp, AV_LOG_VERBOSE,
+               "Reached the seek target, restoring full-quality decoding\n");
+    }
+
     if (pkt) {
         FrameData *fd = packet_data(pkt);
         if (!fd)
@@ -1661,6 +1683,23 @@ static int dec_open(DecoderPriv *dp, AVDictionary **dec_opts,
             dp->dec_ctx->extra_hw_frames = extra_frames;
     }
 
+    dp->preroll_end_us = AV_NOPTS_VALUE;
+    if ((o->flags & DECODER_FLAG_PREROLL_FAST) &&
+        dp->dec_ctx->codec_type == AVMEDIA_TYPE_VIDEO) {
+        // frames before the accurate-seek target only exist to be discarded
+        // by the trim filter, so skip decoding non-reference frames and
+        // in-loop filtering for them; packet_decode() restores the
+        // user-specified settings at the target
+        dp->preroll_end_us           = o->preroll_end_us;
+        dp->preroll_skip_frame       = dp->dec_ctx->skip_frame;
+        dp->preroll_skip_loop_filter = dp->dec_ctx->skip_loop_filter;
+
+        dp->dec_ctx->skip_frame       = FFMAX(dp->dec_ctx->skip_frame,
+                                              AVDISCARD_NONREF);
+        dp->dec_ctx->skip_loop_filter = FFMAX(dp->dec_ctx->skip_loop_filter,
+                                              AVDISCARD_ALL);
+    }
+
     dp->dec.subtitle_header      = dp->dec_ctx->subtitle_header;
     dp->dec.subtitle_header_size = dp->dec_ctx->subtitle_header_size;
 
@@ -125,6 +125,7 @@ typedef struct Demuxer {
 
     int64_t               recording_time;
     int                   accurate_seek;
+    int                   preroll_fast;
 
     /* number of times input stream should be looped */
     int                   loop;
@@ -990,6 +991,23 @@ int ist_use(InputStream *ist, int decoding_needed,
         } else
             ds->dec_opts.framerate  = ist->st->avg_frame_rate;
 
+        if (d->preroll_fast && d->accurate_seek &&
+            d->f.start_time != AV_NOPTS_VALUE &&
+            ist->st->codecpar->codec_type == AVMEDIA_TYPE_VIDEO) {
+            // same target as the trim filter cutting off the preroll,
+            // cf. ist_filter_add()
+            int64_t preroll_end = 0;
+
+            if (copy_ts) {
+                preroll_end = d->f.start_time;
+                if (!start_at_zero && d->f.ctx->start_time != AV_NOPTS_VALUE)
+                    preroll_end += d->f.ctx->start_time;
+            }
+
+            ds->dec_opts.flags         |= DECODER_FLAG_PREROLL_FAST;
+            ds->dec_opts.preroll_end_us = preroll_end;
+        }
+
         ds->dec_opts.apply_cropping = ds->apply_cropping;
 
         sd = av_packet_side_data_get(ist->par->coded_side_data,
@@ -1822,55 +1840,21 @@ static Demuxer *demux_alloc(void)
     return d;
 }
 
-int ifile_open(const OptionsContext *o, const char *filename, Scheduler *sch)
+static int ifile_open_format(const OptionsContext *o, const char *filename,
+                             void *logctx, AVFormatContext **pic)
 {
-    Demuxer   *d;
-    InputFile *f;
     AVFormatContext *ic;
     const AVInputFormat *file_iformat = NULL;
     int err, ret = 0;
-    int64_t timestamp;
-    AVDictionary *opts_used = NULL;
     const char*    video_codec_name = NULL;
     const char*    audio_codec_name = NULL;
     const char* subtitle_codec_name = NULL;
     const char*     data_codec_name = NULL;
     int scan_all_pmts_set = 0;
 
-    int64_t start_time     = o->start_time;
-    int64_t start_time_eof = o->start_time_eof;
-    int64_t stop_time      = o->stop_time;
-    int64_t recording_time = o->recording_time;
-
-    d = demux_alloc();
-    if (!d)
-        return AVERROR(ENOMEM);
-
-    f = &d->f;
-
-    ret = sch_add_demux(sch, input_thread, d);
-    if (ret < 0)
-        return ret;
-    d->sch = sch;
-
-    if (stop_time != INT64_MAX && recording_time != INT64_MAX) {
-        stop_time = INT64_MAX;
-        av_log(d, AV_LOG_WARNING, "-t and -to cannot be used together; using -t.\n");
-    }
-
-    if (stop_time != INT64_MAX && recording_time == INT64_MAX) {
-        int64_t start = start_time == AV_NOPTS_VALUE ? 0 : start_time;
-        if (stop_time <= start) {
-            av_log(d, AV_LOG_ERROR, "-to value smaller than -ss; aborting.\n");
-            return AVERROR(EINVAL);
-        } else {
-            recording_time = stop_time - start;
-        }
-    }
-
     if (o->format) {
         if (!(file_iformat = av_find_input_format(o->format))) {
-            av_log(d, AV_LOG_FATAL, "Unknown input format: '%s'\n", o->format);
+            av_log(logctx, AV_LOG_FATAL, "Unknown input format: '%s'\n", o->format);
             return AVERROR(EINVAL);
         }
     }
@@ -1878,10 +1862,6 @@ int ifile_open(const OptionsContext *o, const char *filename, Scheduler *sch)
     if (!strcmp(filename, "-"))
         filename = "fd:";
 
-    stdin_interaction &= strncmp(filename, "pipe:", 5) &&
-                         strcmp(filename, "fd:") &&
-                         strcmp(filename, "/dev/stdin");
-
     /* get default parameters from command line */
     ic = avformat_alloc_context();
     if (!ic)
@@ -1964,16 +1944,12 @@ int ifile_open(const OptionsContext *o, const char *filename, Scheduler *sch)
     err = avformat_open_input(&ic, filename, file_iformat, &o->g->format_opts);
     if (err < 0) {
         if (err != AVERROR_EXIT)
-            av_log(d, AV_LOG_ERROR,
+            av_log(logctx, AV_LOG_ERROR,
                    "Error opening input: %s\n", av_err2str(err));
         if (err == AVERROR_PROTOCOL_NOT_FOUND)
-            av_log(d, AV_LOG_ERROR, "Did you mean file:%s?\n", filename);
+            av_log(logctx, AV_LOG_ERROR, "Did you mean file:%s?\n", filename);
         return err;
     }
-    f->ctx = ic;
-
-    av_strlcat(d->log_name, "/",               sizeof(d->log_name));
-    av_strlcat(d->log_name, ic->iformat->name, sizeof(d->log_name));
 
     if (scan_all_pmts_set)
         av_dict_set(&o->g->format_opts, "scan_all_pmts", NULL, AV_DICT_MATCH_CASE);
@@ -1981,15 +1957,15 @@ int ifile_open(const OptionsContext *o, const char *filename, Scheduler *sch)
 
     ret = check_avoptions(o->g->format_opts);
     if (ret < 0)
-        return ret;
+        goto fail;
 
     /* apply forced codec ids */
     for (int i = 0; i < ic->nb_streams; i++) {
         const AVCodec *dummy;
-        ret = choose_decoder(o, f, ic, ic->streams[i], HWACCEL_NONE, AV_HWDEVICE_TYPE_NONE,
+        ret = choose_decoder(o, logctx, ic, ic->streams[i], HWACCEL_NONE, AV_HWDEVICE_TYPE_NONE,
                              &dummy);
         if (ret < 0)
-            return ret;
+            goto fail;
     }
 
     if (o->find_stream_info) {
@@ -1998,7 +1974,7 @@ int ifile_open(const OptionsContext *o, const char *filename, Scheduler *sch)
 
         ret = setup_find_stream_info_opts(ic, o->g->codec_opts, &opts);
         if (ret < 0)
-            return ret;
+            goto fail;
 
         /* If not enough info to get the stream parameters, we decode the
            first frames to get it. (used in mpeg case for example) */
@@ -2009,12 +1985,180 @@ int ifile_open(const OptionsContext *o, const char *filename, Scheduler *sch)
         av_freep(&opts);
 
         if (ret < 0) {
-            av_log(d, AV_LOG_FATAL, "could not find codec parameters\n");
+            av_log(logctx, AV_LOG_FATAL, "could not find codec parameters\n");
             if (ic->nb_streams == 0)
-                return ret;
+                goto fail;
         }
     }
 
+    *pic = ic;
+
+    return 0;
+
+fail:
+    avformat_close_input(&ic);
+    return ret;
+}
+
+typedef struct ProbePool {
+    struct {
+        const OptionsContext *o;
+        const char           *filename;
+        AVFormatContext      *ic;
+        int                   ret;
+    }          *probes;
+    int         nb_probes;
+    atomic_int  next;
+} ProbePool;
+
+static ProbePool probe_pool;
+
+#define IFILE_PROBE_MAX_THREADS 8
+
+static void *input_probe_thread(void *arg)
+{
+    ProbePool *pp = arg;
+    int idx;
+
+    while ((idx = atomic_fetch_add(&pp->next, 1)) < pp->nb_probes)
+        pp->probes[idx].ret = ifile_open_format(pp->probes[idx].o,
+                                                pp->probes[idx].filename,
+                                                NULL, &pp->probes[idx].ic);
+
+    return NULL;
+}
+
+int ifile_probe_parallel(const OptionsContext *const *opts,
+                         const char *const *filenames, int nb)
+{
+    pthread_t workers[IFILE_PROBE_MAX_THREADS];
+    int nb_workers = FFMIN(nb, IFILE_PROBE_MAX_THREADS);
+    int started = 0;
+
+    if (nb < 2)
+        return 0;
+
+    probe_pool.probes = av_calloc(nb, sizeof(*probe_pool.probes));
+    if (!probe_pool.probes)
+        return AVERROR(ENOMEM);
+    probe_pool.nb_probes = nb;
+    atomic_init(&probe_pool.next, 0);
+
+    for (int i = 0; i < nb; i++) {
+        probe_pool.probes[i].o        = opts[i];
+        probe_pool.probes[i].filename = filenames[i];
+    }
+
+    av_log(NULL, AV_LOG_VERBOSE, "Probing %d input files using %d threads\n",
+           nb, nb_workers);
+
+    while (started < nb_workers &&
+           !pthread_create(&workers[started], NULL, input_probe_thread, &probe_pool))
+        started++;
+
+    if (!started) {
+        // no workers could be created, ifile_open() will fall back to
+        // opening each input synchronously
+        av_freep(&probe_pool.probes);
+        probe_pool.nb_probes = 0;
+        return 0;
+    }
+
+    // workers left unstarted are not a problem, the started ones drain
+    // the whole list through the shared counter
+    for (int i = 0; i < started; i++)
+        pthread_join(workers[i], NULL);
+
+    return 0;
+}
+
+static int ifile_probe_result(const OptionsContext *o, AVFormatContext **pic)
+{
+    *pic = NULL;
+
+    for (int i = 0; i < probe_pool.nb_probes; i++) {
+        if (probe_pool.probes[i].o != o)
+            continue;
+
+        probe_pool.probes[i].o = NULL;
+        *pic                   = probe_pool.probes[i].ic;
+        probe_pool.probes[i].ic = NULL;
+        return probe_pool.probes[i].ret;
+    }
+
+    return 0;
+}
+
+void ifile_probe_cleanup(void)
+{
+    for (int i = 0; i < probe_pool.nb_probes; i++)
+        avformat_close_input(&probe_pool.probes[i].ic);
+    av_freep(&probe_pool.probes);
+    probe_pool.nb_probes = 0;
+}
+
+int ifile_open(const OptionsContext *o, const char *filename, Scheduler *sch)
+{
+    Demuxer   *d;
+    InputFile *f;
+    AVFormatContext *ic;
+    int err, ret = 0;
+    int64_t timestamp;
+    AVDictionary *opts_used = NULL;
+
+    int64_t start_time     = o->start_time;
+    int64_t start_time_eof = o->start_time_eof;
+    int64_t stop_time      = o->stop_time;
+    int64_t recording_time = o->recording_time;
+
+    d = demux_alloc();
+    if (!d)
+        return AVERROR(ENOMEM);
+
+    f = &d->f;
+
+    ret = sch_add_demux(sch, input_thread, d);
+    if (ret < 0)
+        return ret;
+    d->sch = sch;
+
+    if (stop_time != INT64_MAX && recording_time != INT64_MAX) {
+        stop_time = INT64_MAX;
+        av_log(d, AV_LOG_WARNING, "-t and -to cannot be used together; using -t.\n");
+    }
+
+    if (stop_time != INT64_MAX && recording_time == INT64_MAX) {
+        int64_t start = start_time == AV_NOPTS_VALUE ? 0 : start_time;
+        if (stop_time <= start) {
+            av_log(d, AV_LOG_ERROR, "-to value smaller than -ss; aborting.\n");
+            return AVERROR(EINVAL);
+        } else {
+            recording_time = stop_time - start;
+        }
+    }
+
+    if (!strcmp(filename, "-"))
+        filename = "fd:";
+
+    stdin_interaction &= strncmp(filename, "pipe:", 5) &&
+                         strcmp(filename, "fd:") &&
+                         strcmp(filename, "/dev/stdin");
+
+    /* pick up the result of a parallel probe if there is one for this input,
+     * otherwise open and probe it synchronously */
+    err = ifile_probe_result(o, &ic);
+    if (err < 0)
+        return err;
+    if (!ic) {
+        err = ifile_open_format(o, filename, d, &ic);
+        if (err < 0)
+            return err;
+    }
+    f->ctx = ic;
+
+    av_strlcat(d->log_name, "/",               sizeof(d->log_name));
+    av_strlcat(d->log_name, ic->iformat->name, sizeof(d->log_name));
+
     if (start_time != AV_NOPTS_VALUE && start_time_eof != AV_NOPTS_VALUE) {
         av_log(d, AV_LOG_WARNING, "Cannot use -ss and -sseof both, using -ss\n");
         start_time_eof = AV_NOPTS_VALUE;
@@ -2069,6 +2213,7 @@ int ifile_open(const OptionsContext *o, const char *filename, Scheduler *sch)
     f->input_ts_offset = o->input_ts_offset;
     f->ts_offset  = o->input_ts_offset - (copy_ts ? (start_at_zero && ic->start_time != AV_NOPTS_VALUE ? ic->start_time : 0) : timestamp);
     d->accurate_seek   = o->accurate_seek;
+    d->preroll_fast    = o->preroll_fast;
     d->loop = o->loop;
     d->nb_streams_warn = ic->nb_streams;
 
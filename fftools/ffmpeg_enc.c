@@ -51,6 +51,8 @@ typedef struct EncoderPriv {
     uint64_t packets_encoded;
 
     int opened;
+    // the actual open was left to be performed by the encoder thread
+    int open_deferred;
     int attach_par;
 
     Scheduler      *sch;
@@ -181,6 +183,40 @@ static int hw_device_setup_for_encode(Encoder *e, AVCodecContext *enc_ctx,
     return 0;
 }
 
+static int enc_open_finish(OutputStream *ost)
+{
+    Encoder              *e = ost->enc;
+    EncoderPriv         *ep = ep_from_enc(e);
+    AVCodecContext *enc_ctx = e->enc_ctx;
+    const AVCodec      *enc = enc_ctx->codec;
+    OutputFile          *of = ost->file;
+    int frame_samples = 0;
+    int ret;
+
+    if ((ret = avcodec_open2(enc_ctx, enc, NULL)) < 0) {
+        if (ret != AVERROR_EXPERIMENTAL)
+            av_log(e, AV_LOG_ERROR, "Error while opening encoder - maybe "
+                   "incorrect parameters such as bit_rate, rate, width or height.\n");
+        return ret;
+    }
+
+    ep->opened = 1;
+
+    if (enc_ctx->frame_size)
+        frame_samples = enc_ctx->frame_size;
+
+    if (enc_ctx->bit_rate && enc_ctx->bit_rate < 1000 &&
+        enc_ctx->codec_id != AV_CODEC_ID_CODEC2 /* don't complain about 700 bit/s modes */)
+        av_log(e, AV_LOG_WARNING, "The bitrate parameter is set too low."
+                                    " It takes bits/s as argument, not kbits/s\n");
+
+    ret = of_stream_init(of, ost, enc_ctx);
+    if (ret < 0)
+        return ret;
+
+    return frame_samples;
+}
+
 int enc_open(void *opaque, const AVFrame *frame)
 {
     OutputStream *ost = opaque;
@@ -190,9 +226,7 @@ int enc_open(void *opaque, const AVFrame *frame)
     AVCodecContext *enc_ctx = e->enc_ctx;
     Decoder            *dec = NULL;
     const AVCodec      *enc = enc_ctx->codec;
-    OutputFile          *of = ost->file;
     FrameData *fd;
-    int frame_samples = 0;
     int ret;
 
     if (ep->opened)
@@ -267,6 +301,22 @@ int enc_open(void *opaque, const AVFrame *frame)
         enc_ctx->colorspace             = frame->colorspace;
         enc_ctx->alpha_mode             = frame->alpha_mode;
 
+        /* carry metadata-only cropping to muxers that can store it */
+        if (frame->crop_top || frame->crop_bottom ||
+            frame->crop_left || frame->crop_right) {
+            AVPacketSideData *sd =
+                av_packet_side_data_new(&enc_ctx->coded_side_data,
+                                        &enc_ctx->nb_coded_side_data,
+                                        AV_PKT_DATA_FRAME_CROPPING,
+                                        sizeof(uint32_t) * 4, 0);
+            if (!sd)
+                return AVERROR(ENOMEM);
+            AV_WL32(sd->data +  0, frame->crop_top);
+            AV_WL32(sd->data +  4, frame->crop_bottom);
+            AV_WL32(sd->data +  8, frame->crop_left);
+            AV_WL32(sd->data + 12, frame->crop_right);
+        }
+
         /* Video properties which are not part of filter graph negotiation */
         if (enc_ctx->chroma_sample_location == AVCHROMA_LOC_UNSPECIFIED) {
             enc_ctx->chroma_sample_location = frame->chroma_location;
@@ -341,28 +391,19 @@ int enc_open(void *opaque, const AVFrame *frame)
         return ret;
     }
 
-    if ((ret = avcodec_open2(enc_ctx, enc, NULL)) < 0) {
-        if (ret != AVERROR_EXPERIMENTAL)
-            av_log(e, AV_LOG_ERROR, "Error while opening encoder - maybe "
-                   "incorrect parameters such as bit_rate, rate, width or height.\n");
-        return ret;
+    /* This is called from the thread sending us frames, which feeds all the
+     * outputs of its filtergraph in sequence, so opening the encoder here
+     * would serialize potentially expensive opens (lookahead buffers, codec
+     * thread pools) across outputs. Leave the actual open for video encoders
+     * to the per-encoder threads, so they run concurrently. Audio encoders
+     * must be opened right away, as the scheduler needs to know the audio
+     * frame size before any frames pass through the sync queue. */
+    if (enc_ctx->codec_type == AVMEDIA_TYPE_VIDEO) {
+        ep->open_deferred = 1;
+        return 0;
     }
 
-    ep->opened = 1;
-
-    if (enc_ctx->frame_size)
-        frame_samples = enc_ctx->frame_size;
-
-    if (enc_ctx->bit_rate && enc_ctx->bit_rate < 1000 &&
-        enc_ctx->codec_id != AV_CODEC_ID_CODEC2 /* don't complain about 700 bit/s modes */)
-        av_log(e, AV_LOG_WARNING, "The bitrate parameter is set too low."
-                                    " It takes bits/s as argument, not kbits/s\n");
-
-    ret = of_stream_init(of, ost, enc_ctx);
-    if (ret < 0)
-        return ret;
-
-    return frame_samples;
+    return enc_open_finish(ost);
 }
 
 static int check_recording_time(OutputStream *ost, int64_t ts, AVRational tb)
@@ -543,6 +584,36 @@ static inline double psnr(double d)
     return -10.0 * log10(d);
 }
 
+static void enc_stats_ring_write(EncStatsRing *ring, const AVPacket *pkt,
+                                 const FrameData *fd)
+{
+    EncStatsRingHeader *h = ring->header;
+    uint64_t seq = atomic_load_explicit(&h->seq, memory_order_relaxed);
+    EncStatsRingRecord *rec = &ring->records[seq % h->nb_records];
+    const uint8_t *sd = av_packet_get_side_data(pkt, AV_PKT_DATA_QUALITY_STATS,
+                                                NULL);
+
+    /* Mark the slot as being rewritten, then publish it under the new
+     * sequence number; samplers detect torn reads by re-checking seq. */
+    atomic_store_explicit(&rec->seq, 0, memory_order_release);
+
+    rec->pts            = pkt->pts;
+    rec->dts            = pkt->dts;
+    rec->tb_num         = pkt->time_base.num;
+    rec->tb_den         = pkt->time_base.den;
+    rec->size           = pkt->size;
+    rec->quality        = sd ? AV_RL32(sd) : -1;
+    rec->flags          = pkt->flags;
+    rec->pict_type      = sd ? sd[4] : AV_PICTURE_TYPE_NONE;
+    rec->wallclock_us   = av_gettime();
+    rec->enc_latency_us = fd->wallclock[LATENCY_PROBE_ENC_PRE] != INT64_MIN ?
+                          fd->wallclock[LATENCY_PROBE_ENC_POST] -
+                          fd->wallclock[LATENCY_PROBE_ENC_PRE] : -1;
+
+    atomic_store_explicit(&rec->seq, seq + 1, memory_order_release);
+    atomic_store_explicit(&h->seq,   seq + 1, memory_order_release);
+}
+
 static int update_video_stats(OutputStream *ost, const AVPacket *pkt, int write_vstats)
 {
     Encoder        *e = ost->enc;
@@ -707,6 +778,9 @@ static int encode_frame(OutputFile *of, OutputStream *ost, AVFrame *frame,
             enc_stats_write(ost, &ost->enc_stats_post, NULL, pkt,
                             ep->packets_encoded);
 
+        if (ost->enc_stats_ring.header)
+            enc_stats_ring_write(&ost->enc_stats_ring, pkt, fd);
+
         if (debug_ts) {
             av_log(e, AV_LOG_INFO, "encoder -> type:%s "
                    "pkt_pts:%s pkt_pts_time:%s pkt_dts:%s pkt_dts_time:%s "
@@ -768,9 +842,16 @@ static enum AVPictureType forced_kf_apply(void *logctx, KeyframeForceCtx *kf,
         }
     } else if (kf->type == KF_FORCE_SOURCE && (frame->flags & AV_FRAME_FLAG_KEY)) {
         goto force_keyframe;
-    } else if (kf->type == KF_FORCE_SCD_METADATA &&
-               av_dict_get(frame->metadata, "lavfi.scd.time", NULL, 0)) {
-        goto force_keyframe;
+    } else if (kf->type == KF_FORCE_SCD_METADATA) {
+        /* The decision depends only on frame metadata and timestamps, so
+         * every rendition fed the same frames forces the same keyframes. */
+        if (av_dict_get(frame->metadata, "lavfi.scd.time", NULL, 0) ||
+            isnan(kf->scd_prev_forced_t) ||
+            (kf->scd_max_interval > 0 &&
+             pts_time - kf->scd_prev_forced_t >= kf->scd_max_interval)) {
+            kf->scd_prev_forced_t = pts_time;
+            goto force_keyframe;
+        }
     }
 
     return AV_PICTURE_TYPE_NONE;
@@ -888,6 +969,12 @@ int encoder_thread(void *arg)
         if (input_status < 0) {
             if (input_status == AVERROR_EOF) {
                 av_log(e, AV_LOG_VERBOSE, "Encoder thread received EOF\n");
+                if (ep->open_deferred) {
+                    ep->open_deferred = 0;
+                    ret = enc_open_finish(ost);
+                    if (ret < 0)
+                        goto finish;
+                }
                 if (ep->opened)
                     break;
 
@@ -906,6 +993,13 @@ int encoder_thread(void *arg)
             name_set = 1;
         }
 
+        if (ep->open_deferred) {
+            ep->open_deferred = 0;
+            ret = enc_open_finish(ost);
+            if (ret < 0)
+                goto finish;
+        }
+
         ret = frame_encode(ost, et.frame, et.pkt);
 
         av_packet_unref(et.pkt);
@@ -173,6 +173,8 @@ typedef struct InputFilterPriv {
 
     struct {
         AVFrame *frame;
+        /// cached all-transparent canvas, pushed by reference between subtitles
+        AVFrame *blank;
 
         int64_t last_pts;
         int64_t end_pts;
@@ -303,9 +305,10 @@ static void filter_command_free(void *opaque, uint8_t *data)
     av_free(data);
 }
 
-static int sub2video_get_blank_frame(InputFilterPriv *ifp)
+static int sub2video_get_blank_frame(InputFilterPriv *ifp, int writable)
 {
     AVFrame *frame = ifp->sub2video.frame;
+    AVFrame *blank = ifp->sub2video.blank;
     int ret;
 
     av_frame_unref(frame);
@@ -317,13 +320,52 @@ static int sub2video_get_blank_frame(InputFilterPriv *ifp)
     frame->color_range = ifp->color_range;
     frame->alpha_mode = ifp->alpha_mode;
 
-    ret = av_frame_get_buffer(frame, 0);
-    if (ret < 0)
-        return ret;
+    if (writable) {
+        ret = av_frame_get_buffer(frame, 0);
+        if (ret < 0)
+            return ret;
 
-    memset(frame->data[0], 0, frame->height * frame->linesize[0]);
+        memset(frame->data[0], 0, frame->height * frame->linesize[0]);
 
-    return 0;
+        return 0;
+    }
+
+    /* nothing will be drawn on the canvas, so a reference to a cached
+     * all-transparent frame is enough */
+    if (blank && (blank->width       != frame->width      ||
+                  blank->height      != frame->height     ||
+                  blank->format      != frame->format     ||
+                  blank->colorspace  != frame->colorspace ||
+                  blank->color_range != frame->color_range ||
+                  blank->alpha_mode  != frame->alpha_mode))
+        av_frame_free(&ifp->sub2video.blank);
+
+    if (!ifp->sub2video.blank) {
+        blank = av_frame_alloc();
+        if (!blank)
+            return AVERROR(ENOMEM);
+
+        ret = av_frame_copy_props(blank, frame);
+        if (ret < 0) {
+            av_frame_free(&blank);
+            return ret;
+        }
+        blank->width  = frame->width;
+        blank->height = frame->height;
+        blank->format = frame->format;
+
+        ret = av_frame_get_buffer(blank, 0);
+        if (ret < 0) {
+            av_frame_free(&blank);
+            return ret;
+        }
+
+        memset(blank->data[0], 0, blank->height * blank->linesize[0]);
+
+        ifp->sub2video.blank = blank;
+    }
+
+    return av_frame_ref(frame, ifp->sub2video.blank);
 }
 
 static void sub2video_copy_rect(uint8_t *dst, int dst_linesize, int w, int h,
@@ -398,7 +440,7 @@ static void sub2video_update(InputFilterPriv *ifp, int64_t heartbeat_pts,
         end_pts   = INT64_MAX;
         num_rects = 0;
     }
-    if (sub2video_get_blank_frame(ifp) < 0) {
+    if (sub2video_get_blank_frame(ifp, num_rects > 0) < 0) {
         av_log(ifp->ifilter.graph, AV_LOG_ERROR,
                "Impossible to get a blank canvas.\n");
         return;
@@ -1070,6 +1112,7 @@ void fg_free(FilterGraph **pfg)
             av_fifo_freep2(&ifp->frame_queue);
         }
         av_frame_free(&ifp->sub2video.frame);
+        av_frame_free(&ifp->sub2video.blank);
 
         av_frame_free(&ifp->frame);
         av_frame_free(&ifp->opts.fallback);
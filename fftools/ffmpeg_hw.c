@@ -246,15 +246,38 @@ int hw_device_init_from_type(enum AVHWDeviceType type,
 {
     AVBufferRef *device_ref = NULL;
     HWDevice *dev;
-    char *name;
+    char *name = NULL, *device_copy = NULL;
     int err;
 
+    // reuse an existing implicitly-created context for the same
+    // (type, device) pair, so that e.g. a multi-rendition job decoding and
+    // encoding on the same GPU initializes a single device context shared
+    // by all consumers; devices set up explicitly with -init_hw_device are
+    // never matched here
+    for (int i = 0; i < nb_hw_devices; i++) {
+        dev = hw_devices[i];
+
+        if (dev->type != type || !dev->device)
+            continue;
+        if (!strcmp(dev->device, device ? device : "")) {
+            if (dev_out)
+                *dev_out = dev;
+            return 0;
+        }
+    }
+
     name = hw_device_default_name(type);
     if (!name) {
         err = AVERROR(ENOMEM);
         goto fail;
     }
 
+    device_copy = av_strdup(device ? device : "");
+    if (!device_copy) {
+        err = AVERROR(ENOMEM);
+        goto fail;
+    }
+
     err = av_hwdevice_ctx_create(&device_ref, type, device, NULL, 0);
     if (err < 0) {
         av_log(NULL, AV_LOG_ERROR,
@@ -271,6 +294,7 @@ int hw_device_init_from_type(enum AVHWDeviceType type,
     dev->name = name;
     dev->type = type;
     dev->device_ref = device_ref;
+    dev->device = device_copy;
 
     if (dev_out)
         *dev_out = dev;
@@ -279,6 +303,7 @@ int hw_device_init_from_type(enum AVHWDeviceType type,
 
 fail:
     av_freep(&name);
+    av_freep(&device_copy);
     av_buffer_unref(&device_ref);
     return err;
 }
@@ -288,6 +313,7 @@ void hw_device_free_all(void)
     int i;
     for (i = 0; i < nb_hw_devices; i++) {
         av_freep(&hw_devices[i]->name);
+        av_freep(&hw_devices[i]->device);
         av_buffer_unref(&hw_devices[i]->device_ref);
         av_freep(&hw_devices[i]);
     }
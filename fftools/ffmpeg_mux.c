@@ -38,11 +38,6 @@
 #include "libavformat/avformat.h"
 #include "libavformat/avio.h"
 
-typedef struct MuxThreadContext {
-    AVPacket *pkt;
-    AVPacket *fix_sub_duration_pkt;
-} MuxThreadContext;
-
 static Muxer *mux_from_of(OutputFile *of)
 {
     return (Muxer*)of;
@@ -379,7 +374,8 @@ static void thread_set_name(Muxer *mux)
 
 static void mux_thread_uninit(MuxThreadContext *mt)
 {
-    av_packet_free(&mt->pkt);
+    for (int i = 0; i < MUX_RECV_BATCH; i++)
+        av_packet_free(&mt->recv_pkts[i]);
     av_packet_free(&mt->fix_sub_duration_pkt);
 
     memset(mt, 0, sizeof(*mt));
@@ -389,9 +385,11 @@ static int mux_thread_init(MuxThreadContext *mt)
 {
     memset(mt, 0, sizeof(*mt));
 
-    mt->pkt = av_packet_alloc();
-    if (!mt->pkt)
-        goto fail;
+    for (int i = 0; i < MUX_RECV_BATCH; i++) {
+        mt->recv_pkts[i] = av_packet_alloc();
+        if (!mt->recv_pkts[i])
+            goto fail;
+    }
 
     mt->fix_sub_duration_pkt = av_packet_alloc();
     if (!mt->fix_sub_duration_pkt)
@@ -420,35 +418,51 @@ int muxer_thread(void *arg)
     thread_set_name(mux);
 
     while (1) {
-        OutputStream *ost;
-        int stream_idx, stream_eof = 0;
+        int nb_pkts;
 
-        ret = sch_mux_receive(mux->sch, of->index, mt.pkt);
-        stream_idx = mt.pkt->stream_index;
-        if (stream_idx < 0) {
+        nb_pkts = sch_mux_receive_multi(mux->sch, of->index, mt.recv_pkts,
+                                        MUX_RECV_BATCH);
+        if (nb_pkts < 0 && mt.recv_pkts[0]->stream_index < 0) {
             av_log(mux, AV_LOG_VERBOSE, "All streams finished\n");
             ret = 0;
             break;
         }
 
-        ost = of->streams[mux->sch_stream_idx[stream_idx]];
-        mt.pkt->stream_index = ost->index;
-        mt.pkt->flags       &= ~AV_PKT_FLAG_TRUSTED;
-
-        ret = mux_packet_filter(mux, &mt, ost, ret < 0 ? NULL : mt.pkt, &stream_eof);
-        av_packet_unref(mt.pkt);
-        if (ret == AVERROR_EOF) {
-            if (stream_eof) {
-                sch_mux_receive_finish(mux->sch, of->index, stream_idx);
-            } else {
-                av_log(mux, AV_LOG_VERBOSE, "Muxer returned EOF\n");
-                ret = 0;
-                break;
+        // on a per-stream EOF (nb_pkts < 0 here) a single NULL packet is
+        // passed through the filtering path to flush the stream
+        for (int i = 0; i < FFMAX(nb_pkts, 1); i++) {
+            AVPacket     *pkt = mt.recv_pkts[i];
+            int    stream_idx = pkt->stream_index;
+            int    stream_eof = 0;
+            OutputStream *ost = of->streams[mux->sch_stream_idx[stream_idx]];
+
+            pkt->stream_index = ost->index;
+            pkt->flags       &= ~AV_PKT_FLAG_TRUSTED;
+
+            ret = mux_packet_filter(mux, &mt, ost, nb_pkts < 0 ? NULL : pkt,
+                                    &stream_eof);
+            av_packet_unref(pkt);
+            if (ret == AVERROR_EOF) {
+                if (stream_eof) {
+                    sch_mux_receive_finish(mux->sch, of->index, stream_idx);
+                    ret = 0;
+                } else {
+                    av_log(mux, AV_LOG_VERBOSE, "Muxer returned EOF\n");
+                    ret = 0;
+                    goto drain;
+                }
+            } else if (ret < 0) {
+                av_log(mux, AV_LOG_ERROR, "Error muxing a packet\n");
+                goto drain;
             }
-        } else if (ret < 0) {
-            av_log(mux, AV_LOG_ERROR, "Error muxing a packet\n");
-            break;
         }
+        continue;
+
+drain:
+        // release any packets of the batch left unprocessed
+        for (int i = 0; i < nb_pkts; i++)
+            av_packet_unref(mt.recv_pkts[i]);
+        break;
     }
 
 finish:
@@ -457,6 +471,41 @@ finish:
     return ret;
 }
 
+int muxer_packet_direct(void *arg, AVPacket *pkt, unsigned stream_idx)
+{
+    Muxer     *mux = arg;
+    OutputFile *of = &mux->of;
+    OutputStream *ost;
+    int stream_eof = 0;
+    int ret;
+
+    if (!mux->mt_valid) {
+        ret = mux_thread_init(&mux->mt);
+        if (ret < 0)
+            return ret;
+        mux->mt_valid = 1;
+    }
+
+    ost = of->streams[mux->sch_stream_idx[stream_idx]];
+
+    if (pkt) {
+        pkt->stream_index = ost->index;
+        pkt->flags       &= ~AV_PKT_FLAG_TRUSTED;
+    }
+
+    ret = mux_packet_filter(mux, &mux->mt, ost, pkt, &stream_eof);
+    if (pkt)
+        av_packet_unref(pkt);
+
+    // per-stream EOF is tracked by the scheduler on the direct path
+    if (ret == AVERROR_EOF && stream_eof)
+        ret = 0;
+    else if (ret < 0 && ret != AVERROR_EOF)
+        av_log(mux, AV_LOG_ERROR, "Error muxing a packet\n");
+
+    return ret;
+}
+
 static int of_streamcopy(OutputFile *of, OutputStream *ost, AVPacket *pkt)
 {
     MuxStream  *ms = ms_from_ost(ost);
@@ -841,6 +890,8 @@ static void ost_free(OutputStream **post)
     enc_stats_uninit(&ost->enc_stats_post);
     enc_stats_uninit(&ms->stats);
 
+    enc_stats_ring_close(&ost->enc_stats_ring);
+
     av_freep(post);
 }
 
@@ -880,6 +931,9 @@ void of_free(OutputFile **pof)
 
     av_packet_free(&mux->sq_pkt);
 
+    if (mux->mt_valid)
+        mux_thread_uninit(&mux->mt);
+
     fc_close(&mux->fc);
 
     av_freep(pof);
@@ -92,6 +92,15 @@ typedef struct MuxStream {
     const char     *apad;
 } MuxStream;
 
+// number of packets the muxer thread tries to pull from its input queue
+// in one batch
+#define MUX_RECV_BATCH 8
+
+typedef struct MuxThreadContext {
+    AVPacket *recv_pkts[MUX_RECV_BATCH];
+    AVPacket *fix_sub_duration_pkt;
+} MuxThreadContext;
+
 typedef struct Muxer {
     OutputFile              of;
 
@@ -119,6 +128,11 @@ typedef struct Muxer {
 
     SyncQueue              *sq_mux;
     AVPacket               *sq_pkt;
+
+    // muxing state for muxer_packet_direct(), initialized lazily when the
+    // scheduler muxes the first packet inline
+    MuxThreadContext        mt;
+    int                     mt_valid;
 } Muxer;
 
 int mux_check_init(void *arg);
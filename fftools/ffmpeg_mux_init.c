@@ -20,6 +20,15 @@
 
 #include <string.h>
 
+#include "config.h"
+
+#if HAVE_MMAP
+#include <errno.h>
+#include <fcntl.h>
+#include <sys/mman.h>
+#include <unistd.h>
+#endif
+
 #include "cmdutils.h"
 #include "ffmpeg.h"
 #include "ffmpeg_mux.h"
@@ -195,6 +204,65 @@ static int enc_stats_get_file(AVIOContext **io, const char *path)
     return 0;
 }
 
+int enc_stats_ring_init(OutputStream *ost, EncStatsRing *ring,
+                        const char *path, int nb_records)
+{
+#if HAVE_MMAP
+    EncStatsRingHeader *h;
+    size_t size = sizeof(*h) + (size_t)nb_records * sizeof(EncStatsRingRecord);
+    int fd;
+
+    fd = open(path, O_RDWR | O_CREAT | O_TRUNC, 0644);
+    if (fd < 0) {
+        av_log(ost, AV_LOG_ERROR, "Error opening stats ring file '%s': %s\n",
+               path, av_err2str(AVERROR(errno)));
+        return AVERROR(errno);
+    }
+
+    if (ftruncate(fd, size) < 0) {
+        int err = AVERROR(errno);
+        av_log(ost, AV_LOG_ERROR, "Error sizing stats ring file '%s': %s\n",
+               path, av_err2str(err));
+        close(fd);
+        return err;
+    }
+
+    h = mmap(NULL, size, PROT_READ | PROT_WRITE, MAP_SHARED, fd, 0);
+    close(fd);
+    if (h == MAP_FAILED) {
+        av_log(ost, AV_LOG_ERROR, "Error mapping stats ring file '%s': %s\n",
+               path, av_err2str(AVERROR(errno)));
+        return AVERROR(errno);
+    }
+
+    h->record_size = sizeof(EncStatsRingRecord);
+    h->nb_records  = nb_records;
+    h->version     = ENC_STATS_RING_VERSION;
+    // write the magic last, so samplers never see a half-initialized header
+    h->magic       = ENC_STATS_RING_MAGIC;
+
+    ring->header   = h;
+    ring->records  = (EncStatsRingRecord *)(h + 1);
+    ring->map_size = size;
+
+    return 0;
+#else
+    av_log(ost, AV_LOG_ERROR,
+           "-stats_enc_ring is not supported on this platform (no mmap)\n");
+    return AVERROR(ENOSYS);
+#endif
+}
+
+void enc_stats_ring_close(EncStatsRing *ring)
+{
+#if HAVE_MMAP
+    if (ring->header)
+        munmap(ring->header, ring->map_size);
+#endif
+    ring->header  = NULL;
+    ring->records = NULL;
+}
+
 void of_enc_stats_close(void)
 {
     for (int i = 0; i < nb_enc_stats_files; i++) {
@@ -1313,6 +1381,7 @@ static int ost_add(Muxer *mux, const OptionsContext *o, enum AVMediaType type,
         AVIOContext *s = NULL;
         char *buf = NULL, *arg = NULL;
         const char *enc_stats_pre = NULL, *enc_stats_post = NULL, *mux_stats = NULL;
+        const char *enc_stats_ring = NULL;
         const char *enc_time_base = NULL, *preset = NULL;
 
         ret = filter_codec_opts(o->g->codec_opts, enc->id,
@@ -1377,6 +1446,24 @@ static int ost_add(Muxer *mux, const OptionsContext *o, enum AVMediaType type,
                 goto fail;
         }
 
+        opt_match_per_stream_str(ost, &o->enc_stats_ring, oc, st, &enc_stats_ring);
+        if (enc_stats_ring &&
+            (type == AVMEDIA_TYPE_VIDEO || type == AVMEDIA_TYPE_AUDIO)) {
+            int ring_size = 4096;
+
+            opt_match_per_stream_int(ost, &o->enc_stats_ring_size, oc, st, &ring_size);
+            if (ring_size <= 0) {
+                av_log(ost, AV_LOG_FATAL, "Invalid stats ring size: %d\n", ring_size);
+                ret = AVERROR(EINVAL);
+                goto fail;
+            }
+
+            ret = enc_stats_ring_init(ost, &ost->enc_stats_ring, enc_stats_ring,
+                                      ring_size);
+            if (ret < 0)
+                goto fail;
+        }
+
         opt_match_per_stream_str(ost, &o->mux_stats, oc, st, &mux_stats);
         if (mux_stats &&
             (type == AVMEDIA_TYPE_VIDEO || type == AVMEDIA_TYPE_AUDIO)) {
@@ -3284,8 +3371,24 @@ static int process_forced_keyframes(Muxer *mux, const OptionsContext *o)
                    "-force_key_frames is deprecated, use just 'source'\n");
             ost->kf.type = KF_FORCE_SOURCE;
 #endif
-        } else if (!strcmp(forced_keyframes, "scd_metadata")) {
-            ost->kf.type = KF_FORCE_SCD_METADATA;
+        } else if (!strncmp(forced_keyframes, "scd_metadata", 12)) {
+            if (forced_keyframes[12] == ':') {
+                char *tail;
+                double max_interval = av_strtod(forced_keyframes + 13, &tail);
+                if (*tail || !(max_interval > 0)) {
+                    av_log(ost, AV_LOG_ERROR,
+                           "Invalid scd_metadata max keyframe interval '%s'\n",
+                           forced_keyframes + 13);
+                    return AVERROR(EINVAL);
+                }
+                ost->kf.scd_max_interval = max_interval;
+            } else if (forced_keyframes[12]) {
+                av_log(ost, AV_LOG_ERROR,
+                       "Invalid force_key_frames value '%s'\n", forced_keyframes);
+                return AVERROR(EINVAL);
+            }
+            ost->kf.type              = KF_FORCE_SCD_METADATA;
+            ost->kf.scd_prev_forced_t = NAN;
         } else {
             int ret = parse_forced_key_frames(ost, &ost->kf, mux, forced_keyframes);
             if (ret < 0)
@@ -3401,6 +3504,8 @@ int of_open(const OptionsContext *o, const char *filename, Scheduler *sch)
     mux->sch     = sch;
     mux->sch_idx = err;
 
+    sch_mux_set_direct(sch, mux->sch_idx, muxer_packet_direct);
+
     /* create all output streams for this file */
     err = create_streams(mux, o);
     if (err < 0)
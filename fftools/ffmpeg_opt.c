@@ -712,6 +712,22 @@ static int opt_sdp_file(void *optctx, const char *opt, const char *arg)
     return sch_sdp_filename(go->sch, arg);
 }
 
+static int opt_sched_mode(void *optctx, const char *opt, const char *arg)
+{
+    GlobalOptionsContext *go = optctx;
+
+    if (!strcmp(arg, "thread"))
+        sch_set_mode(go->sch, SCH_MODE_THREAD);
+    else if (!strcmp(arg, "compact"))
+        sch_set_mode(go->sch, SCH_MODE_COMPACT);
+    else {
+        av_log(NULL, AV_LOG_ERROR, "Invalid scheduling mode '%s'\n", arg);
+        return AVERROR(EINVAL);
+    }
+
+    return 0;
+}
+
 #if CONFIG_VAAPI
 static int opt_vaapi_device(void *optctx, const char *opt, const char *arg)
 {
@@ -1462,6 +1478,71 @@ static int open_files(OptionGroupList *l, const char *inout, Scheduler *sch,
     return 0;
 }
 
+static int open_input_files(OptionGroupList *l, Scheduler *sch)
+{
+    OptionsContext *opts = NULL;
+    const OptionsContext **opts_ptr = NULL;
+    const char **filenames = NULL;
+    int nb_parsed = 0, ret;
+
+    if (!l->nb_groups)
+        return 0;
+
+    opts      = av_calloc(l->nb_groups, sizeof(*opts));
+    opts_ptr  = av_calloc(l->nb_groups, sizeof(*opts_ptr));
+    filenames = av_calloc(l->nb_groups, sizeof(*filenames));
+    if (!opts || !opts_ptr || !filenames) {
+        ret = AVERROR(ENOMEM);
+        goto fail;
+    }
+
+    /* parse the options for all the inputs first, so that they can all be
+     * probed in parallel before being opened one by one below */
+    for (int i = 0; i < l->nb_groups; i++) {
+        OptionGroup *g = &l->groups[i];
+        OptionsContext *o = &opts[i];
+
+        init_options(o);
+        o->g = g;
+        nb_parsed++;
+
+        ret = parse_optgroup(o, g, options);
+        if (ret < 0) {
+            av_log(NULL, AV_LOG_ERROR, "Error parsing options for input file "
+                   "%s.\n", g->arg);
+            goto fail;
+        }
+
+        opts_ptr[i]  = o;
+        filenames[i] = g->arg;
+    }
+
+    ret = ifile_probe_parallel(opts_ptr, filenames, l->nb_groups);
+    if (ret < 0)
+        goto fail;
+
+    for (int i = 0; i < l->nb_groups; i++) {
+        av_log(NULL, AV_LOG_DEBUG, "Opening an input file: %s.\n", filenames[i]);
+        ret = ifile_open(&opts[i], filenames[i], sch);
+        if (ret < 0) {
+            av_log(NULL, AV_LOG_ERROR, "Error opening input file %s.\n",
+                   filenames[i]);
+            goto fail;
+        }
+        av_log(NULL, AV_LOG_DEBUG, "Successfully opened the file.\n");
+    }
+
+    ret = 0;
+fail:
+    ifile_probe_cleanup();
+    for (int i = 0; i < nb_parsed; i++)
+        uninit_options(&opts[i]);
+    av_freep(&opts);
+    av_freep(&opts_ptr);
+    av_freep(&filenames);
+    return ret;
+}
+
 int ffmpeg_parse_options(int argc, char **argv, Scheduler *sch)
 {
     GlobalOptionsContext go = { .sch = sch };
@@ -1498,7 +1579,7 @@ int ffmpeg_parse_options(int argc, char **argv, Scheduler *sch)
     }
 
     /* open input files */
-    ret = open_files(&octx.groups[GROUP_INFILE], "input", sch, ifile_open);
+    ret = open_input_files(&octx.groups[GROUP_INFILE], sch);
     if (ret < 0) {
         errmsg = "opening input files";
         goto fail;
@@ -1673,6 +1754,9 @@ const OptionDef options[] = {
     { "accurate_seek",          OPT_TYPE_BOOL, OPT_OFFSET | OPT_EXPERT | OPT_INPUT,
         { .off = OFFSET(accurate_seek) },
         "enable/disable accurate seeking with -ss" },
+    { "preroll_fast",           OPT_TYPE_BOOL, OPT_OFFSET | OPT_EXPERT | OPT_INPUT,
+        { .off = OFFSET(preroll_fast) },
+        "enable/disable fast decoding of the discarded preroll with -ss" },
     { "isync",                  OPT_TYPE_INT, OPT_OFFSET | OPT_EXPERT | OPT_INPUT,
         { .off = OFFSET(input_sync_ref) },
         "Indicate the input index for sync reference", "sync ref" },
@@ -1857,6 +1941,9 @@ const OptionDef options[] = {
     { "thread_queue_size",   OPT_TYPE_INT,  OPT_OFFSET | OPT_EXPERT | OPT_INPUT | OPT_OUTPUT,
         { .off = OFFSET(thread_queue_size) },
         "set the maximum number of queued packets from the demuxer" },
+    { "sched_mode",          OPT_TYPE_FUNC, OPT_FUNC_ARG | OPT_EXPERT,
+        { .func_arg = opt_sched_mode },
+        "set the scheduler threading mode ('thread' or 'compact')", "mode" },
     { "find_stream_info",    OPT_TYPE_BOOL, OPT_INPUT | OPT_EXPERT | OPT_OFFSET,
         { .off = OFFSET(find_stream_info) },
         "read and decode the streams to fill missing information with heuristics" },
@@ -1882,6 +1969,12 @@ const OptionDef options[] = {
     { "stats_mux_pre_fmt",  OPT_TYPE_STRING, OPT_PERSTREAM | OPT_EXPERT | OPT_OUTPUT,
         { .off = OFFSET(mux_stats_fmt)      },
         "format of the stats written with -stats_mux_pre" },
+    { "stats_enc_ring",     OPT_TYPE_STRING, OPT_PERSTREAM | OPT_EXPERT | OPT_OUTPUT,
+        { .off = OFFSET(enc_stats_ring)     },
+        "write per-packet encoding stats into a memory-mapped binary ring" },
+    { "stats_enc_ring_size", OPT_TYPE_INT,   OPT_PERSTREAM | OPT_EXPERT | OPT_OUTPUT,
+        { .off = OFFSET(enc_stats_ring_size) },
+        "number of records in the ring written with -stats_enc_ring" },
 
     /* video options */
     { "vframes",                    OPT_TYPE_FUNC,   OPT_VIDEO | OPT_FUNC_ARG | OPT_PERFILE | OPT_OUTPUT | OPT_EXPERT | OPT_HAS_CANON,
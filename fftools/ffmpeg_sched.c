@@ -22,6 +22,8 @@
 #include <stdatomic.h>
 #include <stddef.h>
 #include <stdint.h>
+#include <stdio.h>
+#include <stdlib.h>
 
 #include "cmdutils.h"
 #include "ffmpeg_sched.h"
@@ -32,6 +34,7 @@
 #include "libavcodec/packet.h"
 
 #include "libavutil/avassert.h"
+#include "libavutil/bprint.h"
 #include "libavutil/error.h"
 #include "libavutil/fifo.h"
 #include "libavutil/frame.h"
@@ -44,6 +47,11 @@
 // FIXME: some other value? make this dynamic?
 #define SCHEDULE_TOLERANCE (100 * 1000)
 
+// Stack reservation for node threads in SCH_MODE_COMPACT. The node loops
+// themselves need very little stack, but they call into the libraries, so
+// leave a comfortable margin.
+#define SCH_COMPACT_STACK_SIZE (1 << 20)
+
 enum QueueType {
     QUEUE_PACKETS,
     QUEUE_FRAMES,
@@ -198,6 +206,9 @@ typedef struct SchMuxStream {
     // an EOF was generated while flushing the pre-mux queue
     int                 init_eof;
 
+    // EOF was sent for this stream on the direct muxing path
+    uint8_t             direct_eof;
+
     ////////////////////////////////////////////////////////////
     // The following are protected by Scheduler.schedule_lock //
 
@@ -218,6 +229,19 @@ typedef struct SchMux {
 
     int               (*init)(void *arg);
 
+    // optional callback for muxing a packet directly in the thread that
+    // produced it; see sch_mux_set_direct()
+    int               (*direct_cb)(void *arg, struct AVPacket *pkt,
+                                   unsigned stream_idx);
+    // this muxer has no thread of its own, all its streams are muxed
+    // inline in the feeding demuxer thread
+    int                 direct;
+    unsigned            nb_direct_eof;
+
+    // set once mux_done() ran for this muxer; protected by
+    // Scheduler.finish_lock
+    int                 done;
+
     SchTask             task;
     /**
      * Set to 1 after starting the muxer task and flushing the
@@ -304,11 +328,17 @@ struct Scheduler {
     int                 sdp_auto;
 
     enum SchedulerState state;
+    enum SchedulerMode  mode;
     atomic_int          terminate;
 
     pthread_mutex_t     schedule_lock;
 
     atomic_int_least64_t last_dts;
+
+    // per-operation queue trace, enabled through the FFMPEG_SCHED_TRACE
+    // environment variable; see tools/sched-trace-analyze.py
+    FILE               *trace_file;
+    pthread_mutex_t     trace_lock;
 };
 
 /**
@@ -369,7 +399,21 @@ static void waiter_uninit(SchWaiter *w)
     pthread_cond_destroy(&w->cond);
 }
 
-static int queue_alloc(ThreadQueue **ptq, unsigned nb_streams, unsigned queue_size,
+static void queue_trace_cb(void *opaque, const char *name,
+                           unsigned stream_idx, char op,
+                           size_t fill, int64_t blocked_us)
+{
+    Scheduler *sch = opaque;
+
+    pthread_mutex_lock(&sch->trace_lock);
+    fprintf(sch->trace_file, "%"PRId64" %s %u %c %zu %"PRId64"\n",
+            av_gettime_relative(), name, stream_idx, op, fill, blocked_us);
+    pthread_mutex_unlock(&sch->trace_lock);
+}
+
+static int queue_alloc(Scheduler *sch, ThreadQueue **ptq,
+                       const char *name, unsigned node_idx,
+                       unsigned nb_streams, unsigned queue_size,
                        enum QueueType type)
 {
     ThreadQueue *tq;
@@ -395,10 +439,48 @@ static int queue_alloc(ThreadQueue **ptq, unsigned nb_streams, unsigned queue_si
     if (!tq)
         return AVERROR(ENOMEM);
 
+    if (sch->trace_file) {
+        char tq_name[16];
+
+        snprintf(tq_name, sizeof(tq_name), "%s%u", name, node_idx);
+        tq_set_trace(tq, queue_trace_cb, sch, tq_name);
+    }
+
     *ptq = tq;
     return 0;
 }
 
+static void queue_stats_bprint(AVBPrint *bp, const char *name, unsigned idx,
+                               ThreadQueue *tq)
+{
+    ThreadQueueStats stats;
+
+    if (!tq)
+        return;
+
+    tq_get_stats(tq, &stats);
+
+    av_bprintf(bp, "queue_%s%u_fill=%zu\n",     name, idx, stats.fill);
+    av_bprintf(bp, "queue_%s%u_fill_max=%zu\n", name, idx, stats.max_fill);
+    av_bprintf(bp, "queue_%s%u_sent=%"PRIu64"\n", name, idx, stats.nb_sent);
+    av_bprintf(bp, "queue_%s%u_send_blocked_us=%"PRId64"\n",
+               name, idx, stats.send_blocked_us);
+    av_bprintf(bp, "queue_%s%u_recv_blocked_us=%"PRId64"\n",
+               name, idx, stats.recv_blocked_us);
+}
+
+void sch_dump_queue_stats(Scheduler *sch, AVBPrint *bp)
+{
+    for (unsigned i = 0; i < sch->nb_dec; i++)
+        queue_stats_bprint(bp, "dec", i, sch->dec[i].queue);
+    for (unsigned i = 0; i < sch->nb_filters; i++)
+        queue_stats_bprint(bp, "fg", i, sch->filters[i].queue);
+    for (unsigned i = 0; i < sch->nb_enc; i++)
+        queue_stats_bprint(bp, "enc", i, sch->enc[i].queue);
+    for (unsigned i = 0; i < sch->nb_mux; i++)
+        queue_stats_bprint(bp, "mux", i, sch->mux[i].queue);
+}
+
 static void *task_wrapper(void *arg);
 
 static int task_start(SchTask *task)
@@ -412,6 +494,20 @@ static int task_start(SchTask *task)
 
     av_assert0(!task->thread_running);
 
+#if HAVE_PTHREADS
+    if (task->parent->mode == SCH_MODE_COMPACT) {
+        pthread_attr_t attr;
+
+        ret = pthread_attr_init(&attr);
+        if (ret)
+            return AVERROR(ret);
+
+        pthread_attr_setstacksize(&attr, SCH_COMPACT_STACK_SIZE);
+
+        ret = pthread_create(&task->thread, &attr, task_wrapper, task);
+        pthread_attr_destroy(&attr);
+    } else
+#endif
     ret = pthread_create(&task->thread, NULL, task_wrapper, task);
     if (ret) {
         av_log(task->func_arg, AV_LOG_ERROR, "pthread_create() failed: %s\n",
@@ -584,6 +680,10 @@ void sch_free(Scheduler **psch)
     pthread_mutex_destroy(&sch->finish_lock);
     pthread_cond_destroy(&sch->finish_cond);
 
+    if (sch->trace_file)
+        fclose(sch->trace_file);
+    pthread_mutex_destroy(&sch->trace_lock);
+
     av_freep(psch);
 }
 
@@ -594,6 +694,7 @@ static const AVClass scheduler_class = {
 
 Scheduler *sch_alloc(void)
 {
+    const char *trace_path;
     Scheduler *sch;
     int ret;
 
@@ -620,12 +721,31 @@ Scheduler *sch_alloc(void)
     if (ret)
         goto fail;
 
+    ret = pthread_mutex_init(&sch->trace_lock, NULL);
+    if (ret)
+        goto fail;
+
+    trace_path = getenv("FFMPEG_SCHED_TRACE");
+    if (trace_path) {
+        sch->trace_file = fopen(trace_path, "w");
+        if (!sch->trace_file)
+            av_log(sch, AV_LOG_WARNING,
+                   "Could not open scheduler trace file '%s', "
+                   "tracing disabled\n", trace_path);
+    }
+
     return sch;
 fail:
     sch_free(&sch);
     return NULL;
 }
 
+void sch_set_mode(Scheduler *sch, enum SchedulerMode mode)
+{
+    av_assert0(sch->state == SCH_STATE_UNINIT);
+    sch->mode = mode;
+}
+
 int sch_sdp_filename(Scheduler *sch, const char *sdp_filename)
 {
     av_freep(&sch->sdp_filename);
@@ -663,6 +783,14 @@ int sch_add_mux(Scheduler *sch, SchThreadFunc func, int (*init)(void *),
     return idx;
 }
 
+void sch_mux_set_direct(Scheduler *sch, unsigned mux_idx,
+                        int (*mux_packet)(void *arg, AVPacket *pkt,
+                                          unsigned stream_idx))
+{
+    av_assert0(mux_idx < sch->nb_mux);
+    sch->mux[mux_idx].direct_cb = mux_packet;
+}
+
 int sch_add_mux_stream(Scheduler *sch, unsigned mux_idx)
 {
     SchMux       *mux;
@@ -779,7 +907,7 @@ int sch_add_dec(Scheduler *sch, SchThreadFunc func, void *ctx, int send_end_ts)
     if (ret < 0)
         return ret;
 
-    ret = queue_alloc(&dec->queue, 1, 0, QUEUE_PACKETS);
+    ret = queue_alloc(sch, &dec->queue, "dec", idx, 1, 0, QUEUE_PACKETS);
     if (ret < 0)
         return ret;
 
@@ -823,7 +951,7 @@ int sch_add_enc(Scheduler *sch, SchThreadFunc func, void *ctx,
     if (!enc->send_pkt)
         return AVERROR(ENOMEM);
 
-    ret = queue_alloc(&enc->queue, 1, 0, QUEUE_FRAMES);
+    ret = queue_alloc(sch, &enc->queue, "enc", idx, 1, 0, QUEUE_FRAMES);
     if (ret < 0)
         return ret;
 
@@ -871,7 +999,8 @@ int sch_add_filtergraph(Scheduler *sch, unsigned nb_inputs, unsigned nb_outputs,
     if (ret < 0)
         return ret;
 
-    ret = queue_alloc(&fg->queue, fg->nb_inputs + 1, 0, QUEUE_FRAMES);
+    ret = queue_alloc(sch, &fg->queue, "fg", idx, fg->nb_inputs + 1, 0,
+                      QUEUE_FRAMES);
     if (ret < 0)
         return ret;
 
@@ -1112,13 +1241,45 @@ int sch_connect(Scheduler *sch, SchedulerNode src, SchedulerNode dst)
     return 0;
 }
 
+static int mux_done(Scheduler *sch, unsigned mux_idx);
+
+// Mux a packet (or per-stream EOF, when pkt is NULL) in the calling thread,
+// for muxers that do not have a thread of their own.
+static int mux_send_direct(Scheduler *sch, SchMux *mux, unsigned stream_idx,
+                           AVPacket *pkt)
+{
+    SchMuxStream *ms = &mux->streams[stream_idx];
+    int ret;
+
+    if (!pkt) {
+        if (ms->direct_eof)
+            return 0;
+        ms->direct_eof = 1;
+
+        ret = mux->direct_cb(mux->task.func_arg, NULL, stream_idx);
+
+        if (++mux->nb_direct_eof == mux->nb_streams)
+            ret = err_merge(ret, mux_done(sch, mux - sch->mux));
+
+        return ret;
+    }
+
+    if (ms->direct_eof)
+        return AVERROR_EOF;
+
+    return mux->direct_cb(mux->task.func_arg, pkt, stream_idx);
+}
+
 static int mux_task_start(SchMux *mux)
 {
+    Scheduler *sch = mux->task.parent;
     int ret = 0;
 
-    ret = task_start(&mux->task);
-    if (ret < 0)
-        return ret;
+    if (!mux->direct) {
+        ret = task_start(&mux->task);
+        if (ret < 0)
+            return ret;
+    }
 
     /* flush the pre-muxing queues */
     while (1) {
@@ -1154,12 +1315,18 @@ static int mux_task_start(SchMux *mux)
 
             if (pkt) {
                 if (!ms->init_eof)
-                    ret = tq_send(mux->queue, min_stream, pkt);
+                    ret = mux->direct ?
+                          mux_send_direct(sch, mux, min_stream, pkt) :
+                          tq_send(mux->queue, min_stream, pkt);
                 av_packet_free(&pkt);
                 if (ret == AVERROR_EOF)
                     ms->init_eof = 1;
                 else if (ret < 0)
                     return ret;
+            } else if (mux->direct) {
+                ret = mux_send_direct(sch, mux, min_stream, NULL);
+                if (ret < 0)
+                    return ret;
             } else
                 tq_send_finish(mux->queue, min_stream);
 
@@ -1658,8 +1825,31 @@ static int start_prepare(Scheduler *sch)
             }
         }
 
-        ret = queue_alloc(&mux->queue, mux->nb_streams, mux->queue_size,
-                          QUEUE_PACKETS);
+        // a pure streamcopy output fed by a single demuxer is muxed directly
+        // in the demuxer thread, avoiding the per-packet handoff to a
+        // separate muxer thread
+        if (mux->direct_cb && mux->nb_streams) {
+            int direct = 1;
+
+            for (unsigned j = 0; j < mux->nb_streams; j++) {
+                SchMuxStream *ms = &mux->streams[j];
+
+                if (ms->src.type != SCH_NODE_TYPE_DEMUX ||
+                    ms->src.idx  != mux->streams[0].src.idx) {
+                    direct = 0;
+                    break;
+                }
+            }
+
+            mux->direct = direct;
+            if (direct)
+                av_log(mux, AV_LOG_VERBOSE,
+                       "Pure streamcopy output, muxing directly in the "
+                       "demuxer thread\n");
+        }
+
+        ret = queue_alloc(sch, &mux->queue, "mux", i, mux->nb_streams,
+                          mux->queue_size, QUEUE_PACKETS);
         if (ret < 0)
             return ret;
     }
@@ -1999,7 +2189,12 @@ static int send_to_mux(Scheduler *sch, SchMux *mux, unsigned stream_idx,
         if (ms->init_eof)
             return AVERROR_EOF;
 
-        ret = tq_send(mux->queue, stream_idx, pkt);
+        ret = mux->direct ? mux_send_direct(sch, mux, stream_idx, pkt) :
+                            tq_send(mux->queue, stream_idx, pkt);
+        if (ret < 0)
+            return ret;
+    } else if (mux->direct) {
+        int ret = mux_send_direct(sch, mux, stream_idx, NULL);
         if (ret < 0)
             return ret;
     } else
@@ -2191,6 +2386,25 @@ int sch_mux_receive(Scheduler *sch, unsigned mux_idx, AVPacket *pkt)
     return ret;
 }
 
+int sch_mux_receive_multi(Scheduler *sch, unsigned mux_idx, AVPacket **pkts,
+                          unsigned nb_pkts)
+{
+    SchMux *mux;
+    int ret, stream_idx;
+
+    av_assert0(mux_idx < sch->nb_mux);
+    mux = &sch->mux[mux_idx];
+
+    ret = tq_receive_multi(mux->queue, &stream_idx, (void**)pkts, nb_pkts);
+
+    for (int i = 0; i < ret; i++)
+        pkts[i]->stream_index = stream_idx;
+    if (ret < 0 && nb_pkts)
+        pkts[0]->stream_index = stream_idx;
+
+    return ret;
+}
+
 void sch_mux_receive_finish(Scheduler *sch, unsigned mux_idx, unsigned stream_idx)
 {
     SchMux *mux;
@@ -2239,6 +2453,16 @@ static int mux_done(Scheduler *sch, unsigned mux_idx)
 {
     SchMux *mux = &sch->mux[mux_idx];
 
+    // direct muxers are marked done when their last stream receives EOF,
+    // but their (never started) task is still stopped in sch_stop()
+    pthread_mutex_lock(&sch->finish_lock);
+    if (mux->done) {
+        pthread_mutex_unlock(&sch->finish_lock);
+        return 0;
+    }
+    mux->done = 1;
+    pthread_mutex_unlock(&sch->finish_lock);
+
     pthread_mutex_lock(&sch->schedule_lock);
 
     for (unsigned i = 0; i < mux->nb_streams; i++) {
@@ -27,6 +27,8 @@
 
 #include "ffmpeg_utils.h"
 
+#include "libavutil/bprint.h"
+
 /*
  * This file contains the API for the transcode scheduler.
  *
@@ -108,6 +110,24 @@ typedef struct SchedulerNode {
 
 typedef int (*SchThreadFunc)(void *arg);
 
+/**
+ * Threading modes for the scheduler node tasks.
+ */
+enum SchedulerMode {
+    /**
+     * One thread with the platform-default stack size per node; the default.
+     */
+    SCH_MODE_THREAD = 0,
+    /**
+     * Like SCH_MODE_THREAD, but node threads are created with a small fixed
+     * stack reservation. Reduces address-space consumption on dense graphs
+     * with many nodes (e.g. many parallel outputs), at the cost of less
+     * headroom for deeply-recursive library code.
+     */
+    SCH_MODE_COMPACT,
+    SCH_NB_MODES
+};
+
 #define SCH_DSTREAM(file, stream)                           \
     (SchedulerNode){ .type = SCH_NODE_TYPE_DEMUX,           \
                      .idx = file, .idx_stream = stream }
@@ -133,9 +153,22 @@ typedef int (*SchThreadFunc)(void *arg);
 Scheduler *sch_alloc(void);
 void sch_free(Scheduler **sch);
 
+/**
+ * Set the threading mode used for the node tasks. Must be called before
+ * sch_start().
+ */
+void sch_set_mode(Scheduler *sch, enum SchedulerMode mode);
+
 int sch_start(Scheduler *sch);
 int sch_stop(Scheduler *sch, int64_t *finish_ts);
 
+/**
+ * Append occupancy and blocking statistics for every inter-node queue to the
+ * given buffer, as 'key=value' lines suitable for -progress output. May be
+ * called from any thread while transcoding is running.
+ */
+void sch_dump_queue_stats(Scheduler *sch, AVBPrint *bp);
+
 /**
  * Wait until transcoding terminates or the specified timeout elapses.
  *
@@ -250,6 +283,25 @@ void sch_remove_filtergraph(Scheduler *sch, int idx);
 int sch_add_mux(Scheduler *sch, SchThreadFunc func, int (*init)(void *),
                 void *ctx, int sdp_auto, unsigned thread_queue_size);
 
+/**
+ * Set a callback the scheduler may use for muxing a packet directly in the
+ * thread that produced it, bypassing the muxer thread and its packet queue.
+ *
+ * The direct path is only taken for outputs where every stream is a streamcopy
+ * fed by the same demuxer, in which case packet interleaving is already
+ * determined by the demuxer and no other thread ever sends to the muxer. The
+ * decision is made in sch_start(); muxers that do not qualify keep their own
+ * thread.
+ *
+ * @param mux_idx index previously returned by sch_add_mux()
+ * @param mux_packet Callback for muxing one packet; stream_idx is an index
+ *                   previously returned by sch_add_mux_stream(). A NULL pkt
+ *                   signals EOF for the given stream.
+ */
+void sch_mux_set_direct(Scheduler *sch, unsigned mux_idx,
+                        int (*mux_packet)(void *arg, struct AVPacket *pkt,
+                                          unsigned stream_idx));
+
 /**
  * Default size of a packet thread queue.  For muxing this can be overridden by
  * the thread_queue_size option as passed to a call to sch_add_mux().
@@ -257,9 +309,12 @@ int sch_add_mux(Scheduler *sch, SchThreadFunc func, int (*init)(void *),
 #define DEFAULT_PACKET_THREAD_QUEUE_SIZE 8
 
 /**
- * Default size of a frame thread queue.
+ * Default size of a frame thread queue.  Deep enough to absorb scheduling
+ * jitter between the decoder/filter/encoder threads without stalling the
+ * downstream consumer, while keeping the number of in-flight frames (and
+ * thus fixed-size frame pool requirements) small.
  */
-#define DEFAULT_FRAME_THREAD_QUEUE_SIZE 2
+#define DEFAULT_FRAME_THREAD_QUEUE_SIZE 4
 
 /**
  * Add a muxed stream for a previously added muxer.
@@ -498,6 +553,18 @@ int sch_enc_send   (Scheduler *sch, unsigned enc_idx, struct AVPacket *pkt);
  */
 int sch_mux_receive(Scheduler *sch, unsigned mux_idx, struct AVPacket *pkt);
 
+/**
+ * Like sch_mux_receive(), but may return a batch of up to nb_pkts consecutive
+ * packets, all belonging to the same stream. Amortizes per-packet locking and
+ * wakeup costs for high-packet-rate streams.
+ *
+ * @retval ">0" Number of packets delivered into pkts.
+ * @retval AVERROR_EOF Same semantics as for sch_mux_receive(), with the
+ *                     stream index stored in pkts[0]->stream_index.
+ */
+int sch_mux_receive_multi(Scheduler *sch, unsigned mux_idx,
+                          struct AVPacket **pkts, unsigned nb_pkts);
+
 /**
  * Called by muxer tasks to signal that a stream will no longer accept input.
  *
@@ -255,6 +255,14 @@ typedef struct VideoState {
     int frame_drops_early;
     int frame_drops_late;
 
+#define PACING_NB_BUCKETS 10
+    /* frame pacing telemetry: histogram of how late each picture was
+     * presented relative to its target time, in power-of-two ms buckets */
+    int pacing_late[PACING_NB_BUCKETS];
+    int pacing_count;
+    double pacing_late_sum;
+    double pacing_late_max;
+
     enum ShowMode {
         SHOW_MODE_NONE = -1, SHOW_MODE_VIDEO = 0, SHOW_MODE_WAVES, SHOW_MODE_RDFT, SHOW_MODE_NB
     } show_mode;
@@ -336,6 +344,7 @@ static int exit_on_keydown;
 static int exit_on_mousedown;
 static int loop = 1;
 static int framedrop = -1;
+static int pacing_stats = 0;
 static int infinite_buffer = -1;
 static enum ShowMode show_mode = SHOW_MODE_NONE;
 static const char *audio_codec_name;
@@ -1307,6 +1316,28 @@ static void stream_component_close(VideoState *is, int stream_index)
     }
 }
 
+static void dump_pacing_stats(VideoState *is)
+{
+    if (!is->pacing_count)
+        return;
+
+    av_log(NULL, AV_LOG_INFO,
+           "Frame pacing: %d frames, lateness avg %.2f ms max %.2f ms, "
+           "%d early + %d late drops\n",
+           is->pacing_count,
+           is->pacing_late_sum / is->pacing_count, is->pacing_late_max,
+           is->frame_drops_early, is->frame_drops_late);
+    for (int i = 0; i < PACING_NB_BUCKETS; i++) {
+        if (i < PACING_NB_BUCKETS - 1)
+            av_log(NULL, AV_LOG_INFO, "  <%4d ms:", 1 << i);
+        else
+            av_log(NULL, AV_LOG_INFO, " >=%4d ms:", 1 << (i - 1));
+        av_log(NULL, AV_LOG_INFO, " %8d (%5.1f%%)\n",
+               is->pacing_late[i],
+               100.0 * is->pacing_late[i] / is->pacing_count);
+    }
+}
+
 static void stream_close(VideoState *is)
 {
     /* XXX: use a special url_shutdown call to abort parse cleanly */
@@ -1333,6 +1364,8 @@ static void stream_close(VideoState *is)
     frame_queue_destroy(&is->subpq);
     SDL_DestroyCond(is->continue_read_thread);
     sws_freeContext(is->sub_convert_ctx);
+    if (pacing_stats)
+        dump_pacing_stats(is);
     av_free(is->filename);
     if (is->vis_texture)
         SDL_DestroyTexture(is->vis_texture);
@@ -1679,6 +1712,17 @@ retry:
             }
 
             is->frame_timer += delay;
+            if (pacing_stats) {
+                double late_ms = (time - is->frame_timer) * 1000.0;
+                int bucket = 0;
+
+                while (bucket < PACING_NB_BUCKETS - 1 && late_ms >= (1 << bucket))
+                    bucket++;
+                is->pacing_late[bucket]++;
+                is->pacing_count++;
+                is->pacing_late_sum += late_ms;
+                is->pacing_late_max  = FFMAX(is->pacing_late_max, late_ms);
+            }
             if (delay > 0 && time - is->frame_timer > AV_SYNC_THRESHOLD_MAX)
                 is->frame_timer = time;
 
@@ -3772,6 +3816,7 @@ static const OptionDef options[] = {
     { "exitonmousedown",    OPT_TYPE_BOOL,   OPT_EXPERT, { &exit_on_mousedown }, "exit on mouse down", "" },
     { "loop",               OPT_TYPE_INT,    OPT_EXPERT, { &loop }, "set number of times the playback shall be looped", "loop count" },
     { "framedrop",          OPT_TYPE_BOOL,   OPT_EXPERT, { &framedrop }, "drop frames when cpu is too slow", "" },
+    { "pacingstats",        OPT_TYPE_BOOL,   OPT_EXPERT, { &pacing_stats }, "print a frame pacing histogram on exit", "" },
     { "infbuf",             OPT_TYPE_BOOL,   OPT_EXPERT, { &infinite_buffer }, "don't limit the input buffer size (useful with realtime streams)", "" },
     { "window_title",       OPT_TYPE_STRING,          0, { &window_title }, "set window title", "window title" },
     { "left",               OPT_TYPE_INT,    OPT_EXPERT, { &screen_left }, "set the x position for the left of the window", "x pos" },
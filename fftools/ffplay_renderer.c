@@ -77,6 +77,12 @@ typedef struct RendererContext {
 
     AVBufferRef *hw_device_ref;
     AVBufferRef *hw_frame_ref;
+    // Derived from the source frames context for zero-copy import. NULL when
+    // derivation is not supported for the source device.
+    AVBufferRef *derived_frames_ref;
+    // Data pointer of the frames context derived_frames_ref was created from,
+    // so that a source change triggers re-derivation.
+    void *derived_frames_src;
     enum AVPixelFormat *transfer_formats;
     AVHWFramesConstraints *constraints;
 
@@ -627,6 +633,44 @@ static inline int move_to_output_frame(RendererContext *ctx, AVFrame *frame)
     return 0;
 }
 
+static int map_frame_derived(VkRenderer *renderer, AVFrame *frame)
+{
+    RendererContext *ctx = (RendererContext *) renderer;
+    int ret;
+
+    if (ctx->derived_frames_src != frame->hw_frames_ctx->data) {
+        av_buffer_unref(&ctx->derived_frames_ref);
+        ret = av_hwframe_ctx_create_derived(&ctx->derived_frames_ref,
+                                            AV_PIX_FMT_VULKAN,
+                                            ctx->hw_device_ref,
+                                            frame->hw_frames_ctx,
+                                            AV_HWFRAME_MAP_READ);
+        if (ret < 0)
+            av_log(renderer, AV_LOG_VERBOSE,
+                   "Derive frames context failed: %s, zero-copy import "
+                   "disabled\n", av_err2str(ret));
+        // Remember the source either way so a failed derivation is not
+        // retried on every frame.
+        ctx->derived_frames_src = frame->hw_frames_ctx->data;
+    }
+
+    if (!ctx->derived_frames_ref)
+        return AVERROR(ENOSYS);
+
+    av_frame_unref(ctx->vk_frame);
+    ctx->vk_frame->hw_frames_ctx = av_buffer_ref(ctx->derived_frames_ref);
+    if (!ctx->vk_frame->hw_frames_ctx)
+        return AVERROR(ENOMEM);
+    ctx->vk_frame->format = AV_PIX_FMT_VULKAN;
+    ret = av_hwframe_map(ctx->vk_frame, frame, AV_HWFRAME_MAP_READ);
+    if (!ret)
+        return move_to_output_frame(ctx, frame);
+
+    // Mapping can fail per-frame, fallback to the copy paths.
+    av_frame_unref(ctx->vk_frame);
+    return AVERROR(ENOSYS);
+}
+
 static int map_frame(VkRenderer *renderer, AVFrame *frame, int use_hw_frame)
 {
     RendererContext *ctx = (RendererContext *) renderer;
@@ -681,6 +725,12 @@ static int convert_frame(VkRenderer *renderer, AVFrame *frame)
     if (frame->format == AV_PIX_FMT_VULKAN)
         return 0;
 
+    // Prefer zero-copy import through a frames context derived from the
+    // source, which needs no intermediate Vulkan frame pool at all.
+    ret = map_frame_derived(renderer, frame);
+    if (ret != AVERROR(ENOSYS))
+        return ret;
+
     ret = create_hw_frame(renderer, frame);
     if (ret < 0)
         return ret;
@@ -788,6 +838,7 @@ static void destroy(VkRenderer *renderer)
     av_freep(&ctx->transfer_formats);
     av_hwframe_constraints_free(&ctx->constraints);
     av_buffer_unref(&ctx->hw_frame_ref);
+    av_buffer_unref(&ctx->derived_frames_ref);
 
     if (ctx->placebo_vulkan) {
         for (int i = 0; i < FF_ARRAY_ELEMS(ctx->tex); i++)
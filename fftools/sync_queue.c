@@ -24,6 +24,7 @@
 #include "libavutil/channel_layout.h"
 #include "libavutil/cpu.h"
 #include "libavutil/error.h"
+#include "libavutil/macros.h"
 #include "libavutil/mathematics.h"
 #include "libavutil/mem.h"
 #include "libavutil/samplefmt.h"
@@ -109,6 +110,24 @@ struct SyncQueue {
     int have_limiting;
 
     uintptr_t align_mask;
+
+    /* min-heap of limiting streams ordered by head timestamp, so that
+     * the queue head can be maintained in O(log n) rather than by
+     * rescanning all streams */
+    unsigned int *head_heap;
+    unsigned int  nb_head_heap;
+    /* position of each stream in head_heap, UINT_MAX for streams not in it */
+    unsigned int *head_pos;
+
+    /* min-heap of readable streams ordered by the end timestamp of their
+     * tail frame, i.e. by the order in which they can release frames */
+    unsigned int *tail_heap;
+    unsigned int  nb_tail_heap;
+    /* position of each stream in tail_heap, UINT_MAX for streams not in it */
+    unsigned int *tail_pos;
+    /* cached tail end timestamp of each stream, in its own timebase;
+     * AV_NOPTS_VALUE sorts first as such frames pass unconditionally */
+    int64_t      *tail_key;
 };
 
 /**
@@ -158,6 +177,116 @@ static void tb_update(const SyncQueue *sq, SyncQueueStream *st,
     st->tb = tb;
 }
 
+/* order limiting streams by their head timestamp; streams with no timestamp
+ * yet sort first, so they bubble up to the top of the heap and block the
+ * queue head from being determined until they see one */
+static int head_cmp(const SyncQueue *sq, unsigned int a, unsigned int b)
+{
+    const SyncQueueStream *sta = &sq->streams[a];
+    const SyncQueueStream *stb = &sq->streams[b];
+
+    if (sta->head_ts == AV_NOPTS_VALUE || stb->head_ts == AV_NOPTS_VALUE)
+        return (sta->head_ts != AV_NOPTS_VALUE) - (stb->head_ts != AV_NOPTS_VALUE);
+
+    return av_compare_ts(sta->head_ts, sta->tb, stb->head_ts, stb->tb);
+}
+
+/* order readable streams by their tail end timestamp; frames with no
+ * timestamps are released unconditionally, so they sort first */
+static int tail_cmp(const SyncQueue *sq, unsigned int a, unsigned int b)
+{
+    const int64_t ka = sq->tail_key[a];
+    const int64_t kb = sq->tail_key[b];
+
+    if (ka == AV_NOPTS_VALUE || kb == AV_NOPTS_VALUE)
+        return (ka != AV_NOPTS_VALUE) - (kb != AV_NOPTS_VALUE);
+
+    return av_compare_ts(ka, sq->streams[a].tb, kb, sq->streams[b].tb);
+}
+
+/* restore the min-heap property around element i, moving it up or down
+ * as needed; pos maps stream indices to their heap positions */
+static void heap_sift(SyncQueue *sq, unsigned int *heap, unsigned int *pos,
+                      unsigned int nb,
+                      int (*cmp)(const SyncQueue *, unsigned int, unsigned int),
+                      unsigned int i)
+{
+    while (i > 0) {
+        unsigned int parent = (i - 1) / 2;
+
+        if (cmp(sq, heap[i], heap[parent]) >= 0)
+            break;
+
+        FFSWAP(unsigned int, heap[i], heap[parent]);
+        pos[heap[i]]      = i;
+        pos[heap[parent]] = parent;
+        i = parent;
+    }
+
+    while (1) {
+        unsigned int smallest = i;
+        unsigned int l = 2 * i + 1, r = 2 * i + 2;
+
+        if (l < nb && cmp(sq, heap[l], heap[smallest]) < 0)
+            smallest = l;
+        if (r < nb && cmp(sq, heap[r], heap[smallest]) < 0)
+            smallest = r;
+        if (smallest == i)
+            break;
+
+        FFSWAP(unsigned int, heap[i], heap[smallest]);
+        pos[heap[i]]        = i;
+        pos[heap[smallest]] = smallest;
+        i = smallest;
+    }
+}
+
+static void tail_heap_remove(SyncQueue *sq, unsigned int stream_idx)
+{
+    unsigned int pos = sq->tail_pos[stream_idx];
+
+    if (pos == UINT_MAX)
+        return;
+
+    sq->tail_pos[stream_idx] = UINT_MAX;
+    sq->nb_tail_heap--;
+    if (pos < sq->nb_tail_heap) {
+        sq->tail_heap[pos]               = sq->tail_heap[sq->nb_tail_heap];
+        sq->tail_pos[sq->tail_heap[pos]] = pos;
+        heap_sift(sq, sq->tail_heap, sq->tail_pos, sq->nb_tail_heap,
+                  tail_cmp, pos);
+    }
+}
+
+/* (re)compute the tail key of the given stream after its state changed and
+ * restore the heap property; streams with nothing to read are removed */
+static void tail_update(SyncQueue *sq, unsigned int stream_idx)
+{
+    SyncQueueStream *st = &sq->streams[stream_idx];
+    SyncQueueFrame peek;
+    int nb_samples;
+
+    if (!av_container_fifo_can_read(st->fifo) ||
+        (st->frame_samples > st->samples_queued && !st->finished)) {
+        tail_heap_remove(sq, stream_idx);
+        return;
+    }
+
+    nb_samples = st->frame_samples;
+    if (st->finished)
+        nb_samples = FFMIN(nb_samples, st->samples_queued);
+
+    av_container_fifo_peek(st->fifo, (void**)&peek, 0);
+    sq->tail_key[stream_idx] = frame_end(sq, peek, nb_samples);
+
+    if (sq->tail_pos[stream_idx] == UINT_MAX) {
+        sq->tail_heap[sq->nb_tail_heap] = stream_idx;
+        sq->tail_pos[stream_idx]        = sq->nb_tail_heap++;
+    }
+    heap_sift(sq, sq->tail_heap, sq->tail_pos, sq->nb_tail_heap,
+              tail_cmp, sq->tail_pos[stream_idx]);
+}
+
 static void finish_stream(SyncQueue *sq, unsigned int stream_idx)
 {
     SyncQueueStream *st = &sq->streams[stream_idx];
@@ -169,6 +298,9 @@ static void finish_stream(SyncQueue *sq, unsigned int stream_idx)
 
     st->finished = 1;
 
+    /* finishing may make a partial audio frame readable */
+    tail_update(sq, stream_idx);
+
     if (st->limiting && st->head_ts != AV_NOPTS_VALUE) {
         /* check if this stream is the new finished head */
         if (sq->head_finished_stream < 0 ||
@@ -191,6 +323,7 @@ static void finish_stream(SyncQueue *sq, unsigned int stream_idx)
                            av_ts2timestr(st1->head_ts, &st1->tb));
 
                 st1->finished = 1;
+                tail_update(sq, i);
             }
         }
     }
@@ -207,36 +340,15 @@ static void finish_stream(SyncQueue *sq, unsigned int stream_idx)
 
 static void queue_head_update(SyncQueue *sq)
 {
-    av_assert0(sq->have_limiting);
-
-    if (sq->head_stream < 0) {
-        unsigned first_limiting = UINT_MAX;
-
-        /* wait for one timestamp in each stream before determining
-         * the queue head */
-        for (unsigned int i = 0; i < sq->nb_streams; i++) {
-            SyncQueueStream *st = &sq->streams[i];
-            if (!st->limiting)
-                continue;
-            if (st->head_ts == AV_NOPTS_VALUE)
-                return;
-            if (first_limiting == UINT_MAX)
-                first_limiting = i;
-        }
+    unsigned int top;
 
-        // placeholder value, correct one will be found below
-        av_assert0(first_limiting < UINT_MAX);
-        sq->head_stream = first_limiting;
-    }
+    av_assert0(sq->have_limiting && sq->nb_head_heap);
 
-    for (unsigned int i = 0; i < sq->nb_streams; i++) {
-        SyncQueueStream *st_head  = &sq->streams[sq->head_stream];
-        SyncQueueStream *st_other = &sq->streams[i];
-        if (st_other->limiting && st_other->head_ts != AV_NOPTS_VALUE &&
-            av_compare_ts(st_other->head_ts, st_other->tb,
-                          st_head->head_ts,  st_head->tb) < 0)
-            sq->head_stream = i;
-    }
+    /* the queue head is the limiting stream with the smallest head
+     * timestamp, i.e. the top of the heap; a top with no timestamp means
+     * some limiting stream has not seen one yet, so the head stays unset */
+    top = sq->head_heap[0];
+    sq->head_stream = (sq->streams[top].head_ts == AV_NOPTS_VALUE) ? -1 : (int)top;
 }
 
 /* update this stream's head timestamp */
@@ -258,10 +370,13 @@ static void stream_update_ts(SyncQueue *sq, unsigned int stream_idx, int64_t ts)
                       ts, st->tb) <= 0)
         finish_stream(sq, stream_idx);
 
-    /* update the overall head timestamp if it could have changed */
-    if (st->limiting &&
-        (sq->head_stream < 0 || sq->head_stream == stream_idx))
+    /* update the overall head timestamp if it could have changed;
+     * head_ts only ever increases, so the stream can only move down the heap */
+    if (st->limiting) {
+        heap_sift(sq, sq->head_heap, sq->head_pos, sq->nb_head_heap,
+                  head_cmp, sq->head_pos[stream_idx]);
         queue_head_update(sq);
+    }
 }
 
 /* If the queue for the given stream (or all streams when stream_idx=-1)
@@ -371,6 +486,8 @@ int sq_send(SyncQueue *sq, unsigned int stream_idx, SyncQueueFrame frame)
     st->samples_queued += nb_samples;
     st->samples_sent   += nb_samples;
 
+    tail_update(sq, stream_idx);
+
     if (st->frame_samples)
         st->frames_sent = st->samples_sent / st->frame_samples;
     else
@@ -545,6 +662,8 @@ static int receive_for_stream(SyncQueue *sq, unsigned int stream_idx,
                 st->samples_queued -= frame_samples(sq, frame);
             }
 
+            tail_update(sq, stream_idx);
+
             av_log(sq->logctx, AV_LOG_DEBUG,
                    "sq: receive %u ts %s queue head %d ts %s\n", stream_idx,
                    av_ts2timestr(frame_end(sq, frame, 0), &st->tb),
@@ -561,7 +680,6 @@ static int receive_for_stream(SyncQueue *sq, unsigned int stream_idx,
 
 static int receive_internal(SyncQueue *sq, int stream_idx, SyncQueueFrame frame)
 {
-    int nb_eof = 0;
     int ret;
 
     /* read a frame for a specific stream */
@@ -570,17 +688,28 @@ static int receive_internal(SyncQueue *sq, int stream_idx, SyncQueueFrame frame)
         return (ret < 0) ? ret : stream_idx;
     }
 
-    /* read a frame for any stream with available output */
-    for (unsigned int i = 0; i < sq->nb_streams; i++) {
-        ret = receive_for_stream(sq, i, frame);
-        if (ret == AVERROR_EOF || ret == AVERROR(EAGAIN)) {
-            nb_eof += (ret == AVERROR_EOF);
+    /* Read a frame for any stream with available output. The tail heap top is
+     * the readable stream whose tail frame ends first; when even it cannot be
+     * released, no other stream can either, so only the top ever needs
+     * examining. */
+    while (sq->nb_tail_heap) {
+        unsigned int idx = sq->tail_heap[0];
+
+        ret = receive_for_stream(sq, idx, frame);
+        if (ret >= 0)
+            return idx;
+        if (ret == AVERROR_EOF) {
+            /* the queue is finished and this stream's remaining frames end
+             * after the queue head, so they will never become eligible */
+            tail_heap_remove(sq, idx);
             continue;
         }
-        return (ret < 0) ? ret : i;
+        if (ret != AVERROR(EAGAIN))
+            return ret;
+        break;
     }
 
-    return (nb_eof == sq->nb_streams) ? AVERROR_EOF : AVERROR(EAGAIN);
+    return sq->finished ? AVERROR_EOF : AVERROR(EAGAIN);
 }
 
 int sq_receive(SyncQueue *sq, int stream_idx, SyncQueueFrame frame)
@@ -598,12 +727,37 @@ int sq_receive(SyncQueue *sq, int stream_idx, SyncQueueFrame frame)
 int sq_add_stream(SyncQueue *sq, int limiting)
 {
     SyncQueueStream *tmp, *st;
+    unsigned int *tmpu;
+    int64_t *tmpk;
 
     tmp = av_realloc_array(sq->streams, sq->nb_streams + 1, sizeof(*sq->streams));
     if (!tmp)
         return AVERROR(ENOMEM);
     sq->streams = tmp;
 
+#define GROW(arr)                                                           \
+    do {                                                                    \
+        tmpu = av_realloc_array(sq->arr, sq->nb_streams + 1,                \
+                                sizeof(*sq->arr));                          \
+        if (!tmpu)                                                          \
+            return AVERROR(ENOMEM);                                         \
+        sq->arr = tmpu;                                                     \
+    } while (0)
+    GROW(head_heap);
+    GROW(head_pos);
+    GROW(tail_heap);
+    GROW(tail_pos);
+#undef GROW
+    tmpk = av_realloc_array(sq->tail_key, sq->nb_streams + 1,
+                            sizeof(*sq->tail_key));
+    if (!tmpk)
+        return AVERROR(ENOMEM);
+    sq->tail_key = tmpk;
+
+    sq->head_pos[sq->nb_streams] = UINT_MAX;
+    sq->tail_pos[sq->nb_streams] = UINT_MAX;
+    sq->tail_key[sq->nb_streams] = AV_NOPTS_VALUE;
+
     st = &sq->streams[sq->nb_streams];
     memset(st, 0, sizeof(*st));
 
@@ -622,6 +776,14 @@ int sq_add_stream(SyncQueue *sq, int limiting)
 
     sq->have_limiting |= limiting;
 
+    if (limiting) {
+        /* insert with no timestamp yet, which sorts first */
+        sq->head_heap[sq->nb_head_heap] = sq->nb_streams;
+        sq->head_pos[sq->nb_streams]    = sq->nb_head_heap++;
+        heap_sift(sq, sq->head_heap, sq->head_pos, sq->nb_head_heap,
+                  head_cmp, sq->head_pos[sq->nb_streams]);
+    }
+
     return sq->nb_streams++;
 }
 
@@ -680,5 +842,11 @@ void sq_free(SyncQueue **psq)
 
     av_freep(&sq->streams);
 
+    av_freep(&sq->head_heap);
+    av_freep(&sq->head_pos);
+    av_freep(&sq->tail_heap);
+    av_freep(&sq->tail_pos);
+    av_freep(&sq->tail_key);
+
     av_freep(psq);
 }
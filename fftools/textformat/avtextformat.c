@@ -289,6 +289,13 @@ void avtext_print_section_footer(AVTextFormatContext *tctx)
     if (tctx->formatter->print_section_footer)
         tctx->formatter->print_section_footer(tctx);
     tctx->level--;
+
+    // each element of a top-level array (packet, frame, stream, ...) is
+    // complete at this point, push it out so that consumers reading e.g.
+    // -show_packets output from a pipe see records as they are parsed
+    if (tctx->level == 1 &&
+        (tctx->section[tctx->level]->flags & AV_TEXTFORMAT_SECTION_FLAG_IS_ARRAY))
+        avtextwriter_flush(tctx->writer);
 }
 
 void avtext_print_integer(AVTextFormatContext *tctx, const char *key, int64_t val, int flags)
@@ -645,6 +652,12 @@ fail:
     return ret;
 }
 
+void avtextwriter_flush(AVTextWriterContext *wctx)
+{
+    if (wctx && wctx->writer->writer_flush)
+        wctx->writer->writer_flush(wctx);
+}
+
 static const AVTextFormatter *registered_formatters[7 + 1];
 
 static void formatters_register_all(void)
@@ -37,6 +37,7 @@ typedef struct AVTextWriter {
     void (*writer_w8)(AVTextWriterContext *wctx, int b);
     void (*writer_put_str)(AVTextWriterContext *wctx, const char *str);
     void (*writer_vprintf)(AVTextWriterContext *wctx, const char *fmt, va_list vl);
+    void (*writer_flush)(AVTextWriterContext *wctx);
 } AVTextWriter;
 
 typedef struct AVTextWriterContext {
@@ -51,6 +52,8 @@ int avtextwriter_context_open(AVTextWriterContext **pwctx, const AVTextWriter *w
 
 void avtextwriter_context_close(AVTextWriterContext **pwctx);
 
+void avtextwriter_flush(AVTextWriterContext *wctx);
+
 int avtextwriter_create_stdout(AVTextWriterContext **pwctx);
 
 int avtextwriter_create_avio(AVTextWriterContext **pwctx, AVIOContext *avio_ctx, int close_on_uninit);
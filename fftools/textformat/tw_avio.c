@@ -64,6 +64,12 @@ static void io_vprintf(AVTextWriterContext *wctx, const char *fmt, va_list vl)
     avio_vprintf(ctx->avio_context, fmt, vl);
 }
 
+static void io_flush(AVTextWriterContext *wctx)
+{
+    IOWriterContext *ctx = wctx->priv;
+    avio_flush(ctx->avio_context);
+}
+
 
 const AVTextWriter avtextwriter_avio = {
     .name                 = WRITER_NAME,
@@ -71,7 +77,8 @@ const AVTextWriter avtextwriter_avio = {
     .uninit               = iowriter_uninit,
     .writer_put_str       = io_put_str,
     .writer_vprintf       = io_vprintf,
-    .writer_w8            = io_w8
+    .writer_w8            = io_w8,
+    .writer_flush         = io_flush
 };
 
 int avtextwriter_create_file(AVTextWriterContext **pwctx, const char *output_filename)
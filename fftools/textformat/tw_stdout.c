@@ -58,6 +58,11 @@ static inline void stdout_vprintf(AVTextWriterContext *wctx, const char *fmt, va
     vprintf(fmt, vl);
 }
 
+static inline void stdout_flush(AVTextWriterContext *wctx)
+{
+    fflush(stdout);
+}
+
 
 static const AVTextWriter avtextwriter_stdout = {
     .name                 = WRITER_NAME,
@@ -65,7 +70,8 @@ static const AVTextWriter avtextwriter_stdout = {
     .priv_class           = &stdoutwriter_class,
     .writer_put_str       = stdout_put_str,
     .writer_vprintf       = stdout_vprintf,
-    .writer_w8            = stdout_w8
+    .writer_w8            = stdout_w8,
+    .writer_flush         = stdout_flush
 };
 
 int avtextwriter_create_stdout(AVTextWriterContext **pwctx)
@@ -20,13 +20,16 @@
 #include <string.h>
 
 #include "libavutil/avassert.h"
+#include "libavutil/avstring.h"
 #include "libavutil/container_fifo.h"
 #include "libavutil/error.h"
 #include "libavutil/fifo.h"
 #include "libavutil/frame.h"
 #include "libavutil/intreadwrite.h"
+#include "libavutil/macros.h"
 #include "libavutil/mem.h"
 #include "libavutil/thread.h"
+#include "libavutil/time.h"
 
 #include "libavcodec/packet.h"
 
@@ -48,7 +51,16 @@ struct ThreadQueue {
     AVFifo          *fifo_stream_index;
 
     pthread_mutex_t lock;
-    pthread_cond_t  cond;
+    pthread_cond_t  cond_send; /* waited on by producers needing space */
+    pthread_cond_t  cond_recv; /* waited on by consumers needing data */
+    unsigned int    send_waiters;
+    unsigned int    recv_waiters;
+
+    ThreadQueueStats stats;
+
+    TQTraceCallback trace_cb;
+    void           *trace_opaque;
+    char            trace_name[16];
 };
 
 void tq_free(ThreadQueue **ptq)
@@ -63,7 +75,8 @@ void tq_free(ThreadQueue **ptq)
 
     av_freep(&tq->finished);
 
-    pthread_cond_destroy(&tq->cond);
+    pthread_cond_destroy(&tq->cond_send);
+    pthread_cond_destroy(&tq->cond_recv);
     pthread_mutex_destroy(&tq->lock);
 
     av_freep(ptq);
@@ -79,15 +92,23 @@ ThreadQueue *tq_alloc(unsigned int nb_streams, size_t queue_size,
     if (!tq)
         return NULL;
 
-    ret = pthread_cond_init(&tq->cond, NULL);
+    ret = pthread_cond_init(&tq->cond_send, NULL);
+    if (ret) {
+        av_freep(&tq);
+        return NULL;
+    }
+
+    ret = pthread_cond_init(&tq->cond_recv, NULL);
     if (ret) {
+        pthread_cond_destroy(&tq->cond_send);
         av_freep(&tq);
         return NULL;
     }
 
     ret = pthread_mutex_init(&tq->lock, NULL);
     if (ret) {
-        pthread_cond_destroy(&tq->cond);
+        pthread_cond_destroy(&tq->cond_send);
+        pthread_cond_destroy(&tq->cond_recv);
         av_freep(&tq);
         return NULL;
     }
@@ -116,6 +137,7 @@ fail:
 
 int tq_send(ThreadQueue *tq, unsigned int stream_idx, void *data)
 {
+    int64_t blocked = 0;
     int *finished;
     int ret;
 
@@ -129,13 +151,25 @@ int tq_send(ThreadQueue *tq, unsigned int stream_idx, void *data)
         goto finish;
     }
 
-    while (!(*finished & FINISHED_RECV) && !av_fifo_can_write(tq->fifo_stream_index))
-        pthread_cond_wait(&tq->cond, &tq->lock);
+    if (!(*finished & FINISHED_RECV) && !av_fifo_can_write(tq->fifo_stream_index)) {
+        int64_t wait_start = av_gettime_relative();
+
+        while (!(*finished & FINISHED_RECV) && !av_fifo_can_write(tq->fifo_stream_index)) {
+            tq->send_waiters++;
+            pthread_cond_wait(&tq->cond_send, &tq->lock);
+            tq->send_waiters--;
+        }
+
+        blocked = av_gettime_relative() - wait_start;
+        tq->stats.send_blocked_us += blocked;
+    }
 
     if (*finished & FINISHED_RECV) {
         ret = AVERROR_EOF;
         *finished |= FINISHED_SEND;
     } else {
+        size_t fill;
+
         ret = av_fifo_write(tq->fifo_stream_index, &stream_idx, 1);
         if (ret < 0)
             goto finish;
@@ -144,7 +178,16 @@ int tq_send(ThreadQueue *tq, unsigned int stream_idx, void *data)
         if (ret < 0)
             goto finish;
 
-        pthread_cond_broadcast(&tq->cond);
+        tq->stats.nb_sent++;
+        fill = av_container_fifo_can_read(tq->fifo);
+        tq->stats.max_fill = FFMAX(tq->stats.max_fill, fill);
+
+        if (tq->trace_cb)
+            tq->trace_cb(tq->trace_opaque, tq->trace_name, stream_idx, 's',
+                         fill, blocked);
+
+        if (tq->recv_waiters)
+            pthread_cond_broadcast(&tq->cond_recv);
     }
 
 finish:
@@ -174,6 +217,7 @@ static int receive_locked(ThreadQueue *tq, int *stream_idx,
         }
 
         *stream_idx = idx;
+        tq->stats.nb_received++;
         return 0;
     }
 
@@ -196,6 +240,7 @@ static int receive_locked(ThreadQueue *tq, int *stream_idx,
 
 int tq_receive(ThreadQueue *tq, int *stream_idx, void *data)
 {
+    int64_t blocked = 0;
     int ret;
 
     *stream_idx = -1;
@@ -207,23 +252,101 @@ int tq_receive(ThreadQueue *tq, int *stream_idx, void *data)
 
         ret = receive_locked(tq, stream_idx, data);
 
-        // signal other threads if the fifo state changed
-        if (can_read != av_container_fifo_can_read(tq->fifo))
-            pthread_cond_broadcast(&tq->cond);
+        // wake up blocked producers if space was freed
+        if (can_read != av_container_fifo_can_read(tq->fifo) && tq->send_waiters)
+            pthread_cond_broadcast(&tq->cond_send);
 
         if (ret == AVERROR(EAGAIN)) {
-            pthread_cond_wait(&tq->cond, &tq->lock);
+            int64_t wait_start = av_gettime_relative();
+            int64_t waited;
+
+            tq->recv_waiters++;
+            pthread_cond_wait(&tq->cond_recv, &tq->lock);
+            tq->recv_waiters--;
+            waited   = av_gettime_relative() - wait_start;
+            blocked += waited;
+            tq->stats.recv_blocked_us += waited;
             continue;
         }
 
         break;
     }
 
+    if (tq->trace_cb && ret >= 0)
+        tq->trace_cb(tq->trace_opaque, tq->trace_name, *stream_idx, 'r',
+                     av_container_fifo_can_read(tq->fifo), blocked);
+
     pthread_mutex_unlock(&tq->lock);
 
     return ret;
 }
 
+int tq_receive_multi(ThreadQueue *tq, int *stream_idx, void **data,
+                     unsigned int nb_items)
+{
+    unsigned int nb_recv = 0;
+    int64_t blocked = 0;
+    int ret;
+
+    *stream_idx = -1;
+
+    if (!nb_items)
+        return 0;
+
+    pthread_mutex_lock(&tq->lock);
+
+    while (1) {
+        size_t can_read = av_container_fifo_can_read(tq->fifo);
+
+        ret = receive_locked(tq, stream_idx, data[0]);
+
+        if (ret >= 0) {
+            unsigned idx;
+
+            nb_recv = 1;
+
+            // drain any immediately following items belonging to the same
+            // stream, so per-item lock and wakeup costs are amortized
+            while (nb_recv < nb_items                                     &&
+                   av_fifo_peek(tq->fifo_stream_index, &idx, 1, 0) >= 0   &&
+                   idx == (unsigned)*stream_idx) {
+                if (av_container_fifo_read(tq->fifo, data[nb_recv], 0) < 0)
+                    break;
+                av_fifo_drain2(tq->fifo_stream_index, 1);
+                tq->stats.nb_received++;
+                nb_recv++;
+            }
+        }
+
+        // wake up blocked producers if space was freed
+        if (can_read != av_container_fifo_can_read(tq->fifo) && tq->send_waiters)
+            pthread_cond_broadcast(&tq->cond_send);
+
+        if (ret == AVERROR(EAGAIN)) {
+            int64_t wait_start = av_gettime_relative();
+            int64_t waited;
+
+            tq->recv_waiters++;
+            pthread_cond_wait(&tq->cond_recv, &tq->lock);
+            tq->recv_waiters--;
+            waited   = av_gettime_relative() - wait_start;
+            blocked += waited;
+            tq->stats.recv_blocked_us += waited;
+            continue;
+        }
+
+        break;
+    }
+
+    if (tq->trace_cb && ret >= 0)
+        tq->trace_cb(tq->trace_opaque, tq->trace_name, *stream_idx, 'r',
+                     av_container_fifo_can_read(tq->fifo), blocked);
+
+    pthread_mutex_unlock(&tq->lock);
+
+    return ret < 0 ? ret : (int)nb_recv;
+}
+
 void tq_send_finish(ThreadQueue *tq, unsigned int stream_idx)
 {
     av_assert0(stream_idx < tq->nb_streams);
@@ -235,7 +358,8 @@ void tq_send_finish(ThreadQueue *tq, unsigned int stream_idx)
      * an EOF and recv-finished flag will be set */
     tq->finished[stream_idx] |= FINISHED_SEND;
     tq->choked = 0;
-    pthread_cond_broadcast(&tq->cond);
+    if (tq->recv_waiters)
+        pthread_cond_broadcast(&tq->cond_recv);
 
     pthread_mutex_unlock(&tq->lock);
 }
@@ -250,7 +374,28 @@ void tq_receive_finish(ThreadQueue *tq, unsigned int stream_idx)
      * next time the producer thread tries to send for this stream, it will
      * get an EOF and send-finished flag will be set */
     tq->finished[stream_idx] |= FINISHED_RECV;
-    pthread_cond_broadcast(&tq->cond);
+    if (tq->send_waiters)
+        pthread_cond_broadcast(&tq->cond_send);
+    if (tq->recv_waiters)
+        pthread_cond_broadcast(&tq->cond_recv);
+
+    pthread_mutex_unlock(&tq->lock);
+}
+
+void tq_set_trace(ThreadQueue *tq, TQTraceCallback cb, void *opaque,
+                  const char *name)
+{
+    tq->trace_cb     = cb;
+    tq->trace_opaque = opaque;
+    av_strlcpy(tq->trace_name, name, sizeof(tq->trace_name));
+}
+
+void tq_get_stats(ThreadQueue *tq, ThreadQueueStats *stats)
+{
+    pthread_mutex_lock(&tq->lock);
+
+    *stats      = tq->stats;
+    stats->fill = av_container_fifo_can_read(tq->fifo);
 
     pthread_mutex_unlock(&tq->lock);
 }
@@ -261,8 +406,8 @@ void tq_choke(ThreadQueue *tq, int choked)
 
     int prev_choked = tq->choked;
     tq->choked = choked;
-    if (choked != prev_choked)
-        pthread_cond_broadcast(&tq->cond);
+    if (choked != prev_choked && tq->recv_waiters)
+        pthread_cond_broadcast(&tq->cond_recv);
 
     pthread_mutex_unlock(&tq->lock);
 }
@@ -19,6 +19,7 @@
 #ifndef FFTOOLS_THREAD_QUEUE_H
 #define FFTOOLS_THREAD_QUEUE_H
 
+#include <stdint.h>
 #include <string.h>
 
 enum ThreadQueueType {
@@ -28,6 +29,20 @@ enum ThreadQueueType {
 
 typedef struct ThreadQueue ThreadQueue;
 
+typedef struct ThreadQueueStats {
+    /// number of items currently queued
+    size_t   fill;
+    /// highest number of items ever queued at once
+    size_t   max_fill;
+    /// number of items ever sent/received
+    uint64_t nb_sent;
+    uint64_t nb_received;
+    /// cumulative time the producer spent blocked on a full queue
+    int64_t  send_blocked_us;
+    /// cumulative time the consumer spent blocked on an empty queue
+    int64_t  recv_blocked_us;
+} ThreadQueueStats;
+
 /**
  * Allocate a queue for sending data between threads.
  *
@@ -82,9 +97,52 @@ void tq_choke(ThreadQueue *tq, int choked);
  *   for each stream. When *stream_idx is -1, all streams are done.
  */
 int tq_receive(ThreadQueue *tq, int *stream_idx, void *data);
+
+/**
+ * Read a batch of consecutive items belonging to the same stream from the
+ * queue, under a single lock acquisition. Blocks until at least one item is
+ * available, like tq_receive().
+ *
+ * @param stream_idx the index of the stream the returned items belong to, or
+ *                   -1, with the same semantics as for tq_receive()
+ * @param data array of nb_items destination items; on a positive return value
+ *             the first that many entries have been filled
+ * @return number of items read on success, otherwise an error code with the
+ *         same meaning as for tq_receive()
+ */
+int tq_receive_multi(ThreadQueue *tq, int *stream_idx, void **data,
+                     unsigned int nb_items);
 /**
  * Mark the given stream finished from the receiving side.
  */
 void tq_receive_finish(ThreadQueue *tq, unsigned int stream_idx);
 
+/**
+ * Retrieve a consistent snapshot of the queue occupancy/blocking counters.
+ * May be called from any thread.
+ */
+void tq_get_stats(ThreadQueue *tq, ThreadQueueStats *stats);
+
+/**
+ * Called after every completed queue operation, with the queue lock held.
+ *
+ * @param opaque     the pointer passed to tq_set_trace()
+ * @param name       the queue name passed to tq_set_trace()
+ * @param stream_idx stream the item belongs to
+ * @param op         's' for a send, 'r' for a receive
+ * @param fill       queue fill level after the operation
+ * @param blocked_us time the calling thread spent blocked waiting for this
+ *                   operation to become possible
+ */
+typedef void (*TQTraceCallback)(void *opaque, const char *name,
+                                unsigned stream_idx, char op,
+                                size_t fill, int64_t blocked_us);
+
+/**
+ * Install a callback invoked on every send/receive, for tracing queue
+ * activity. Must be called before the queue is used from multiple threads.
+ */
+void tq_set_trace(ThreadQueue *tq, TQTraceCallback cb, void *opaque,
+                  const char *name);
+
 #endif // FFTOOLS_THREAD_QUEUE_H
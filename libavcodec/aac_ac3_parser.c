@@ -29,6 +29,32 @@
 #include "ac3_parser_internal.h"
 #include "adts_header.h"
 
+/**
+ * Check whether the buffer holds exactly one frame, starting at its first
+ * byte, so containers that already deliver whole frames (e.g. the ADTS
+ * demuxer) can bypass the byte-wise sync search and the ParseContext.
+ *
+ * @return the frame size, or 0 if the buffer is not a single whole frame
+ */
+static int whole_frame_size(AACAC3ParseContext *s, const uint8_t *buf,
+                            int buf_size)
+{
+    uint64_t state = 0;
+    int need_next_header, new_frame_start, len;
+
+    if (s->pc.index || s->remaining_size || s->need_next_header ||
+        buf_size < s->header_size)
+        return 0;
+
+    for (int i = 0; i < s->header_size; i++)
+        state = (state << 8) | buf[i];
+    len = s->sync(state, &need_next_header, &new_frame_start);
+    if (len != buf_size || need_next_header || !new_frame_start)
+        return 0;
+
+    return len;
+}
+
 int ff_aac_ac3_parse(AVCodecParserContext *s1,
                      AVCodecContext *avctx,
                      const uint8_t **poutbuf, int *poutbuf_size,
@@ -42,7 +68,8 @@ int ff_aac_ac3_parse(AVCodecParserContext *s1,
 
     s1->key_frame = -1;
 
-    if (s1->flags & PARSER_FLAG_COMPLETE_FRAMES) {
+    if (s1->flags & PARSER_FLAG_COMPLETE_FRAMES ||
+        whole_frame_size(s, buf, buf_size) > 0) {
         i = buf_size;
         got_frame = 1;
     } else {
@@ -30,6 +30,8 @@ typedef struct AACEncDSPContext {
     void (*quant_bands)(int *out, const float *in, const float *scaled,
                         int size, int is_signed, int maxval, const float Q34,
                         const float rounding);
+    void (*energy_form_factor)(float *energy, float *form,
+                               const float *coefs, int size);
 } AACEncDSPContext;
 
 void ff_aacenc_dsp_init_riscv(AACEncDSPContext *s);
@@ -58,10 +60,25 @@ static inline void quantize_bands(int *out, const float *in, const float *scaled
     }
 }
 
+static inline void energy_form_factor_c(float *energy, float *form,
+                                        const float *coefs, int size)
+{
+    float e = 0.0f, f = 0.0f;
+
+    for (int i = 0; i < size; i++) {
+        float c = coefs[i];
+        e += c * c;
+        f += sqrtf(fabsf(c));
+    }
+    *energy = e;
+    *form   = f;
+}
+
 static inline void ff_aacenc_dsp_init(AACEncDSPContext *s)
 {
     s->abs_pow34   = abs_pow34_v;
     s->quant_bands = quantize_bands;
+    s->energy_form_factor = energy_form_factor_c;
 
 #if ARCH_RISCV
     ff_aacenc_dsp_init_riscv(s);
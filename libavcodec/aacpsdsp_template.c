@@ -231,5 +231,9 @@ av_cold void AAC_RENAME(ff_psdsp_init)(PSDSPContext *s)
 #elif ARCH_X86
     ff_psdsp_init_x86(s);
 #endif
+#else
+#if ARCH_AARCH64
+    ff_psdsp_init_fixed_aarch64(s);
+#endif
 #endif /* !USE_FIXED */
 }
@@ -0,0 +1,45 @@
+/*
+ * This file is part of Librempeg
+ *
+ * Librempeg is free software; you can redistribute it and/or modify
+ * it under the terms of the GNU General Public License as published by
+ * the Free Software Foundation; either version 3 of the License, or
+ * (at your option) any later version.
+ *
+ * Librempeg is distributed in the hope that it will be useful,
+ * but WITHOUT ANY WARRANTY; without even the implied warranty of
+ * MERCHANTABILITY or FITNESS FOR A PARTICULAR PURPOSE.  See the
+ * GNU General Public License for more details.
+ *
+ * You should have received a copy of the GNU General Public License along
+ * with Librempeg; if not, write to the Free Software Foundation, Inc.,
+ * 51 Franklin Street, Fifth Floor, Boston, MA 02110-1301 USA.
+ */
+
+#define USE_FIXED 1
+
+#include "config.h"
+#include "libavutil/aarch64/cpu.h"
+#include "libavutil/attributes.h"
+#include "libavcodec/sbrdsp.h"
+
+void ff_sbr_sum64x5_fixed_neon(int *z);
+void ff_sbr_neg_odd_64_fixed_neon(int *x);
+void ff_sbr_qmf_pre_shuffle_fixed_neon(int *z);
+void ff_sbr_qmf_post_shuffle_fixed_neon(int W[32][2], const int *z);
+void ff_sbr_qmf_deint_neg_fixed_neon(int *v, const int *src);
+void ff_sbr_qmf_deint_bfly_fixed_neon(int *v, const int *src0, const int *src1);
+
+av_cold void ff_sbrdsp_init_fixed_aarch64(SBRDSPContext *s)
+{
+    int cpu_flags = av_get_cpu_flags();
+
+    if (have_neon(cpu_flags)) {
+        s->sum64x5 = ff_sbr_sum64x5_fixed_neon;
+        s->neg_odd_64 = ff_sbr_neg_odd_64_fixed_neon;
+        s->qmf_pre_shuffle = ff_sbr_qmf_pre_shuffle_fixed_neon;
+        s->qmf_post_shuffle = ff_sbr_qmf_post_shuffle_fixed_neon;
+        s->qmf_deint_neg = ff_sbr_qmf_deint_neg_fixed_neon;
+        s->qmf_deint_bfly = ff_sbr_qmf_deint_bfly_fixed_neon;
+    }
+}
@@ -304,5 +304,6 @@ const FFCodec ff_adpcm_adx_decoder = {
     .flush          = adx_decode_flush,
     .p.capabilities = AV_CODEC_CAP_CHANNEL_CONF |
                       AV_CODEC_CAP_DR1,
+    .caps_internal  = FF_CODEC_CAP_NEW_EXTRADATA,
     CODEC_SAMPLEFMTS(AV_SAMPLE_FMT_S16P),
 };
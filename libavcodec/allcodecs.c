@@ -1058,17 +1058,20 @@ static const AVCodec *find_codec(enum AVCodecID id, int (*x)(const AVCodec *))
     const AVCodec *p, *experimental = NULL;
     void *i = 0;
 
+    if (id == AV_CODEC_ID_NONE)
+        return NULL;
+
     id = remap_deprecated_codec_id(id);
 
     while ((p = av_codec_iterate(&i))) {
-        if (!x(p))
+        /* Check the id first: it saves an indirect call per non-matching
+         * entry on a scan over hundreds of registry entries. */
+        if (p->id != id || !x(p))
             continue;
-        if (p->id == id) {
-            if (p->capabilities & AV_CODEC_CAP_EXPERIMENTAL && !experimental) {
-                experimental = p;
-            } else
-                return p;
-        }
+        if (p->capabilities & AV_CODEC_CAP_EXPERIMENTAL && !experimental) {
+            experimental = p;
+        } else
+            return p;
     }
 
     return experimental;
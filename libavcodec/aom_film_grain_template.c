@@ -242,12 +242,13 @@ static void FUNC(fgy_32x32xn_c)(pixel *const dst_row, const pixel *const src_row
             offsets[0][i] = get_random_number(8, &seed[i]);
 
 #define add_noise_y(x, y, grain)                                                \
-        src = (const pixel*)((const char*)src_row + (y) * stride) + (x) + bx;   \
-        dst = (pixel*)((char*)dst_row + (y) * stride) + (x) + bx;               \
-        noise = round2(scaling[ *src ] * (grain), data->scaling_shift);         \
-        *dst = av_clip(*src + noise, min_value, max_value);
+        noise = round2(scaling[ src[x] ] * (grain), data->scaling_shift);       \
+        dst[x] = av_clip(src[x] + noise, min_value, max_value);
 
         for (int y = ystart; y < bh; y++) {
+            src = (const pixel*)((const char*)src_row + y * stride) + bx;
+            dst = (pixel*)((char*)dst_row + y * stride) + bx;
+
             // Non-overlapped image region (straightforward)
             for (int x = xstart; x < bw; x++) {
                 int grain = FUNC(sample_lut)(grain_lut, offsets, 0, 0, 0, 0, x, y);
@@ -265,6 +266,9 @@ static void FUNC(fgy_32x32xn_c)(pixel *const dst_row, const pixel *const src_row
         }
 
         for (int y = 0; y < ystart; y++) {
+            src = (const pixel*)((const char*)src_row + y * stride) + bx;
+            dst = (pixel*)((char*)dst_row + y * stride) + bx;
+
             // Special case for overlapped row (sans corner)
             for (int x = xstart; x < bw; x++) {
                 int grain = FUNC(sample_lut)(grain_lut, offsets, 0, 0, 0, 0, x, y);
@@ -336,7 +340,7 @@ FUNC(fguv_32x32xn_c)(pixel *const dst_row, const pixel *const src_row,
     // process this row in FG_BLOCK_SIZE^2 blocks (subsampled)
     for (unsigned bx = 0; bx < pw; bx += FG_BLOCK_SIZE >> sx) {
         const int bw = FFMIN(FG_BLOCK_SIZE >> sx, (int)(pw - bx));
-        int val, lx, ly, noise;
+        int val, lx, noise;
         const pixel *src, *luma;
         pixel *dst, avg;
 
@@ -360,26 +364,27 @@ FUNC(fguv_32x32xn_c)(pixel *const dst_row, const pixel *const src_row,
             offsets[0][i] = get_random_number(8, &seed[i]);
 
 #define add_noise_uv(x, y, grain)                                               \
-            lx = (bx + x) << sx;                                                \
-            ly = y << sy;                                                       \
-            luma = (const pixel*)((const char*)luma_row + ly * luma_stride) + lx;\
-            avg = luma[0];                                                      \
+            lx = (x) << sx;                                                     \
+            avg = luma[lx];                                                     \
             if (sx)                                                             \
-                avg = (avg + luma[1] + 1) >> 1;                                 \
-            src = (const pixel*)((const char *)src_row + (y) * stride) + bx + (x);\
-            dst = (pixel *) ((char *) dst_row + (y) * stride) + bx + (x);       \
+                avg = (avg + luma[lx + 1] + 1) >> 1;                            \
             val = avg;                                                          \
             if (!data->chroma_scaling_from_luma) {                              \
                 const int combined = avg * data->uv_mult_luma[uv] +             \
-                                    *src * data->uv_mult[uv];                   \
+                                   src[x] * data->uv_mult[uv];                  \
                 val = av_clip( (combined >> 6) +                                \
                                (data->uv_offset[uv] * (1 << bitdepth_min_8)),   \
                                0, bitdepth_max );                               \
             }                                                                   \
             noise = round2(scaling[ val ] * (grain), data->scaling_shift);      \
-            *dst = av_clip(*src + noise, min_value, max_value);
+            dst[x] = av_clip(src[x] + noise, min_value, max_value);
 
         for (int y = ystart; y < bh; y++) {
+            src  = (const pixel*)((const char*)src_row + y * stride) + bx;
+            dst  = (pixel*)((char*)dst_row + y * stride) + bx;
+            luma = (const pixel*)((const char*)luma_row +
+                                  (y << sy) * luma_stride) + (bx << sx);
+
             // Non-overlapped image region (straightforward)
             for (int x = xstart; x < bw; x++) {
                 int grain = FUNC(sample_lut)(grain_lut, offsets, sx, sy, 0, 0, x, y);
@@ -397,6 +402,11 @@ FUNC(fguv_32x32xn_c)(pixel *const dst_row, const pixel *const src_row,
         }
 
         for (int y = 0; y < ystart; y++) {
+            src  = (const pixel*)((const char*)src_row + y * stride) + bx;
+            dst  = (pixel*)((char*)dst_row + y * stride) + bx;
+            luma = (const pixel*)((const char*)luma_row +
+                                  (y << sy) * luma_stride) + (bx << sx);
+
             // Special case for overlapped row (sans corner)
             for (int x = xstart; x < bw; x++) {
                 int grain = FUNC(sample_lut)(grain_lut, offsets, sx, sy, 0, 0, x, y);
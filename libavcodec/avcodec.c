@@ -408,6 +408,17 @@ void avcodec_flush_buffers(AVCodecContext *avctx)
         ffcodec(avctx->codec)->flush(avctx);
 }
 
+int avcodec_reconfigure(AVCodecContext *avctx, const AVCodecParameters *par)
+{
+    if (!avcodec_is_open(avctx) || !par)
+        return AVERROR(EINVAL);
+
+    if (av_codec_is_encoder(avctx->codec))
+        return AVERROR(ENOSYS);
+
+    return ff_decode_reconfigure(avctx, par);
+}
+
 void avsubtitle_free(AVSubtitle *sub)
 {
     int i;
@@ -457,11 +468,15 @@ av_cold void ff_codec_close(AVCodecContext *avctx)
 
         av_refstruct_unref(&avci->pool);
         av_refstruct_pool_uninit(&avci->progress_frame_pool);
+        av_buffer_pool_uninit(&avci->mv_export_pool);
 
         ff_hwaccel_uninit(avctx);
 
         av_bsf_free(&avci->bsf);
 
+        if (av_codec_is_decoder(avctx->codec))
+            ff_decode_internal_uninit(avctx);
+
 #if CONFIG_LCMS2
         ff_icc_context_uninit(&avci->icc);
 #endif
@@ -720,6 +735,94 @@ int avcodec_receive_frame(AVCodecContext *avctx, AVFrame *frame)
     return avcodec_receive_frame_flags(avctx, frame, 0);
 }
 
+int attribute_align_arg avcodec_decode_batch(AVCodecContext *avctx,
+                                             AVPacket * const *pkts, int nb_pkts,
+                                             AVFrame * const *frames, int nb_frames)
+{
+    int nb_out = 0, ret;
+
+    if (!avcodec_is_open(avctx) || !ff_codec_is_decoder(avctx->codec))
+        return AVERROR(EINVAL);
+
+    if (!avctx->codec_descriptor ||
+        !(avctx->codec_descriptor->props & AV_CODEC_PROP_INTRA_ONLY))
+        return AVERROR(ENOSYS);
+
+    if (nb_pkts < 0 || nb_frames < nb_pkts)
+        return AVERROR(EINVAL);
+
+    for (int i = 0; i <= nb_pkts; i++) {
+        /* the iteration past the last packet drains the pipeline, so that
+         * frames still being decoded by worker threads are returned */
+        const AVPacket *pkt = i < nb_pkts ? pkts[i] : NULL;
+
+        do {
+            ret = avcodec_send_packet(avctx, pkt);
+            if (ret == AVERROR_EOF)
+                ret = 0; /* already draining */
+            else if (ret < 0 && ret != AVERROR(EAGAIN))
+                goto end;
+
+            while (nb_out < nb_frames) {
+                int err = avcodec_receive_frame(avctx, frames[nb_out]);
+                if (err >= 0) {
+                    nb_out++;
+                } else if (err == AVERROR_EOF) {
+                    ret = 0;
+                    goto end;
+                } else if (err == AVERROR(EAGAIN)) {
+                    break;
+                } else {
+                    ret = err;
+                    goto end;
+                }
+            }
+            if (ret == AVERROR(EAGAIN) && nb_out == nb_frames) {
+                ret = AVERROR(ENOSPC);
+                goto end;
+            }
+        } while (ret == AVERROR(EAGAIN));
+    }
+    ret = 0;
+end:
+    /* intra-only decoders carry no state between frames, so flushing
+     * merely rearms the context after draining */
+    avcodec_flush_buffers(avctx);
+    return ret < 0 ? ret : nb_out;
+}
+
+int attribute_align_arg avcodec_decode_batch_multi(AVCodecContext * const *avctxs,
+                                                   int nb_streams,
+                                                   AVPacket * const *pkts,
+                                                   AVFrame * const *frames,
+                                                   int *results)
+{
+    int nb_out = 0;
+
+    if (nb_streams < 0)
+        return AVERROR(EINVAL);
+
+    for (int i = 0; i < nb_streams; i++) {
+        AVCodecContext *avctx = avctxs[i];
+        int ret;
+
+        if (!pkts[i] || !avcodec_is_open(avctx) ||
+            !ff_codec_is_decoder(avctx->codec)) {
+            results[i] = AVERROR(EINVAL);
+            continue;
+        }
+
+        ret = avcodec_send_packet(avctx, pkts[i]);
+        if (ret >= 0)
+            ret = avcodec_receive_frame(avctx, frames[i]);
+        results[i] = ret;
+        if (ret >= 0)
+            nb_out++;
+    }
+
+    return nb_out;
+}
+
 #define WRAP_CONFIG(allowed_type, field, var, field_type, sentinel_check)   \
     do {                                                                    \
         if (codec->type != (allowed_type))                                  \
@@ -343,6 +343,15 @@ typedef struct RcOverride{
  * Place global headers at every keyframe instead of in extradata.
  */
 #define AV_CODEC_FLAG2_LOCAL_HEADER   (1 <<  3)
+/**
+ * Submit slice-threading jobs to a process-wide worker pool shared by
+ * all codec contexts with this flag set, instead of creating a private
+ * pool per context. Useful when running many codec instances in one
+ * process, where per-context pools would create an excessive number of
+ * threads. Slice batches of different contexts are serialized over the
+ * shared workers.
+ */
+#define AV_CODEC_FLAG2_SHARED_SLICE_POOL (1 << 4)
 
 /**
  * Input bitstream might be truncated at a packet boundaries
@@ -1938,6 +1947,30 @@ typedef struct AVCodecContext {
      * - decoding: Set by libavcodec
      */
     enum AVAlphaMode alpha_mode;
+
+    /**
+     * Target wall-clock decode time per frame, in microseconds, or 0 to
+     * disable load shedding. When the smoothed per-frame decode time
+     * exceeds the deadline, the decoder steps up skip_loop_filter and then
+     * skip_frame to shed load, and steps back down once it has caught up;
+     * the user-configured skip values act as the baseline that shedding
+     * never goes below. Only meaningful for video decoding.
+     * - encoding: unused
+     * - decoding: Set by user.
+     */
+    int64_t frame_deadline;
+
+    /**
+     * If set, pin each frame-decoding worker thread to a single CPU chosen
+     * round-robin from the set the process is allowed to run on. Keeping a
+     * worker on one CPU for its lifetime keeps it on one NUMA node, so the
+     * frame buffers it allocates stay node-local under the kernel's
+     * first-touch placement policy. A no-op on platforms without thread
+     * affinity support and with other threading types.
+     * - encoding: unused
+     * - decoding: Set by user.
+     */
+    int thread_affinity;
 } AVCodecContext;
 
 /**
@@ -2386,6 +2419,64 @@ int avcodec_receive_frame_flags(AVCodecContext *avctx, AVFrame *frame, unsigned
  */
 int avcodec_receive_frame(AVCodecContext *avctx, AVFrame *frame);
 
+/**
+ * Decode a batch of packets of an intra-only codec in one call.
+ *
+ * This is a convenience wrapper around avcodec_send_packet() and
+ * avcodec_receive_frame() for decoders of formats whose frames are coded
+ * independently (codec descriptors with @ref AV_CODEC_PROP_INTRA_ONLY).
+ * All packets are fed to the decoder, the pipeline is drained and the
+ * resulting frames are returned in presentation order; with frame
+ * threading enabled the packets are decoded in parallel. The context is
+ * flushed before this function returns, so consecutive batches are
+ * independent of each other.
+ *
+ * @param avctx     codec context of an opened intra-only decoder
+ * @param pkts      array of packets to decode; the packets are not modified
+ * @param nb_pkts   number of entries in pkts
+ * @param frames    array of allocated frames that receive the output;
+ *                  entries are filled in order, any excess entries are
+ *                  left untouched
+ * @param nb_frames number of entries in frames, must be at least nb_pkts
+ *
+ * @return the number of frames written to frames on success, a negative
+ *         error code on failure. AVERROR(ENOSYS) is returned if the codec
+ *         is not intra-only.
+ */
+int avcodec_decode_batch(AVCodecContext *avctx,
+                         AVPacket * const *pkts, int nb_pkts,
+                         AVFrame * const *frames, int nb_frames);
+
+/**
+ * Decode one packet on each of a batch of independent codec contexts.
+ *
+ * For every stream this is equivalent to one avcodec_send_packet() call
+ * followed by one avcodec_receive_frame() call, but performing the whole
+ * batch back-to-back keeps the decoder code and its shared static tables
+ * warm in the caches, which matters when many small streams (e.g. voice
+ * channels) are decoded together. The contexts must not be used
+ * concurrently from other threads while the call is in progress.
+ *
+ * This is primarily useful for audio decoders that output one frame per
+ * packet; decoders that buffer frames internally report AVERROR(EAGAIN)
+ * for the affected stream and deliver the frame on a later call.
+ *
+ * @param avctxs     array of opened decoder contexts, one per stream
+ * @param nb_streams number of entries in avctxs, pkts, frames and results
+ * @param pkts       array of packets, one per stream; entries must be
+ *                   non-NULL (flush streams through the regular API)
+ * @param frames     array of allocated frames that receive the output
+ * @param results    per-stream status: 0 if a frame was returned in the
+ *                   corresponding frames entry, a negative error code
+ *                   from sending or receiving otherwise
+ *
+ * @return the number of frames returned across all streams, or
+ *         AVERROR(EINVAL) if nb_streams is invalid
+ */
+int avcodec_decode_batch_multi(AVCodecContext * const *avctxs, int nb_streams,
+                               AVPacket * const *pkts, AVFrame * const *frames,
+                               int *results);
+
 /**
  * Supply a raw video or audio frame to the encoder. Use avcodec_receive_packet()
  * to retrieve buffered output packets.
@@ -2951,6 +3042,29 @@ int avcodec_fill_audio_frame(AVFrame *frame, int nb_channels,
  */
 void avcodec_flush_buffers(AVCodecContext *avctx);
 
+/**
+ * Rebind an opened decoder to the parameters of a new stream of the same
+ * codec, keeping expensive state (worker threads, tables, buffer pools)
+ * alive. This is a cheaper alternative to closing the context and opening a
+ * new one when processing several streams or segments sequentially.
+ *
+ * The internal state is flushed as by avcodec_flush_buffers() and the stream
+ * parameters from par are applied to the context. If the extradata differs,
+ * it is passed on to the decoder before the next packet is decoded; this is
+ * only supported by decoders that can reinitialize from new extradata, for
+ * others this function returns AVERROR(ENOSYS) and the caller has to fall
+ * back to reopening the codec.
+ *
+ * @param avctx an opened decoder context
+ * @param par   codec parameters of the new stream; codec_type and codec_id
+ *              must match the opened decoder
+ * @return 0 on success, AVERROR(EINVAL) if the context is not an opened
+ *         decoder or the parameters belong to a different codec,
+ *         AVERROR(ENOSYS) if the decoder cannot be rebound in place
+ */
+int avcodec_reconfigure(AVCodecContext *avctx,
+                        const struct AVCodecParameters *par);
+
 /**
  * Return audio frame duration.
  *
@@ -68,9 +68,20 @@ int ff_decode_preinit(struct AVCodecContext *avctx);
 void ff_decode_flush_buffers(struct AVCodecContext *avctx);
 void ff_encode_flush_buffers(struct AVCodecContext *avctx);
 
+/**
+ * avcodec_reconfigure() implementation for decoders.
+ */
+int ff_decode_reconfigure(struct AVCodecContext *avctx,
+                          const struct AVCodecParameters *par);
+
 struct AVCodecInternal *ff_decode_internal_alloc(void);
 struct AVCodecInternal *ff_encode_internal_alloc(void);
 
+/**
+ * Free the decode-specific per-context state. Called by ff_codec_close().
+ */
+void ff_decode_internal_uninit(struct AVCodecContext *avctx);
+
 void ff_codec_close(struct AVCodecContext *avctx);
 
 int ff_thread_init(struct AVCodecContext *s);
@@ -19,6 +19,8 @@
  * 51 Franklin Street, Fifth Floor, Boston, MA 02110-1301 USA.
  */
 
+#include "libavutil/intreadwrite.h"
+
 #include "adts_header.h"
 #include "adts_parser.h"
 #include "bsf.h"
@@ -30,6 +32,7 @@
 
 typedef struct AACBSFContext {
     int first_frame_done;
+    uint32_t fixed_header; ///< 28-bit fixed header of the last CRC-less ADTS frame
 } AACBSFContext;
 
 /**
@@ -54,6 +57,15 @@ static int aac_adtstoasc_filter(AVBSFContext *bsfc, AVPacket *pkt)
     if (pkt->size < AV_AAC_ADTS_HEADER_SIZE)
         goto packet_too_small;
 
+    /* The fixed header never changes mid-stream, so once the first frame
+     * has been seen a comparison against it replaces the full reparse. */
+    if (ctx->first_frame_done && pkt->size > AV_AAC_ADTS_HEADER_SIZE &&
+        (AV_RB32(pkt->data) & 0xFFFFFFF0) == ctx->fixed_header) {
+        pkt->data += AV_AAC_ADTS_HEADER_SIZE;
+        pkt->size -= AV_AAC_ADTS_HEADER_SIZE;
+        return 0;
+    }
+
     if (ff_adts_header_parse_buf(pkt->data, &hdr) < 0) {
         av_log(bsfc, AV_LOG_ERROR, "Error parsing ADTS frame header!\n");
         ret = AVERROR_INVALIDDATA;
@@ -67,6 +79,9 @@ static int aac_adtstoasc_filter(AVBSFContext *bsfc, AVPacket *pkt)
         goto fail;
     }
 
+    if (hdr.crc_absent)
+        ctx->fixed_header = AV_RB32(pkt->data) & 0xFFFFFFF0;
+
     pkt->size -= AV_AAC_ADTS_HEADER_SIZE + 2 * !hdr.crc_absent;
     if (pkt->size <= 0)
         goto packet_too_small;
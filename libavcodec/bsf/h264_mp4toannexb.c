@@ -53,10 +53,16 @@ enum PsSource {
 };
 
 static void count_or_copy(uint8_t **out, uint64_t *out_size,
-                          const uint8_t *in, int in_size, enum PsSource ps, int copy)
+                          const uint8_t *in, int in_size, enum PsSource ps,
+                          int copy, int *plain)
 {
     uint8_t start_code_size;
 
+    /* anything but a single NAL unit with a 4-byte start code rules out
+     * rewriting the packet in place */
+    if (ps != PS_NONE || *out_size)
+        *plain = 0;
+
     if (ps == PS_OUT_OF_BAND)
         /* start code already present in out-of-band ps data, so don't need to
          * add it manually again
@@ -283,6 +289,7 @@ static int h264_mp4toannexb_filter(AVBSFContext *ctx, AVPacket *opkt)
     const uint8_t *buf_end;
     uint8_t *out;
     uint64_t out_size;
+    int plain;
     int ret;
     size_t extradata_size;
     uint8_t *extradata;
@@ -322,6 +329,7 @@ static int h264_mp4toannexb_filter(AVBSFContext *ctx, AVPacket *opkt)
         sps_seen = s->idr_sps_seen;
         pps_seen = s->idr_pps_seen;
         out_size = 0;
+        plain    = 1;
 
         do {
             uint32_t nal_size = 0;
@@ -340,8 +348,10 @@ static int h264_mp4toannexb_filter(AVBSFContext *ctx, AVPacket *opkt)
                 goto fail;
             }
 
-            if (!nal_size)
+            if (!nal_size) {
+                plain = 0;
                 continue;
+            }
 
             unit_type = *buf & 0x1f;
 
@@ -353,8 +363,9 @@ static int h264_mp4toannexb_filter(AVBSFContext *ctx, AVPacket *opkt)
                 if (!sps_seen) {
                     if (!s->sps_size) {
                         LOG_ONCE(ctx, AV_LOG_WARNING, "SPS not present in the stream, nor in AVCC, stream may be unreadable\n");
+                        plain = 0;
                     } else {
-                        count_or_copy(&out, &out_size, s->sps, s->sps_size, PS_OUT_OF_BAND, j);
+                        count_or_copy(&out, &out_size, s->sps, s->sps_size, PS_OUT_OF_BAND, j, &plain);
                         sps_seen = 1;
                     }
                 }
@@ -371,11 +382,11 @@ static int h264_mp4toannexb_filter(AVBSFContext *ctx, AVPacket *opkt)
             if (unit_type == H264_NAL_SEI && buf[1] == SEI_TYPE_BUFFERING_PERIOD &&
                 !sps_seen && !pps_seen) {
                 if (s->sps_size) {
-                    count_or_copy(&out, &out_size, s->sps, s->sps_size, PS_OUT_OF_BAND, j);
+                    count_or_copy(&out, &out_size, s->sps, s->sps_size, PS_OUT_OF_BAND, j, &plain);
                     sps_seen = 1;
                 }
                 if (s->pps_size) {
-                    count_or_copy(&out, &out_size, s->pps, s->pps_size, PS_OUT_OF_BAND, j);
+                    count_or_copy(&out, &out_size, s->pps, s->pps_size, PS_OUT_OF_BAND, j, &plain);
                     pps_seen = 1;
                 }
             }
@@ -383,16 +394,17 @@ static int h264_mp4toannexb_filter(AVBSFContext *ctx, AVPacket *opkt)
             /* prepend only to the first type 5 NAL unit of an IDR picture, if no sps/pps are already present */
             if (new_idr && unit_type == H264_NAL_IDR_SLICE && !sps_seen && !pps_seen) {
                 if (s->sps_size)
-                    count_or_copy(&out, &out_size, s->sps, s->sps_size, PS_OUT_OF_BAND, j);
+                    count_or_copy(&out, &out_size, s->sps, s->sps_size, PS_OUT_OF_BAND, j, &plain);
                 if (s->pps_size)
-                    count_or_copy(&out, &out_size, s->pps, s->pps_size, PS_OUT_OF_BAND, j);
+                    count_or_copy(&out, &out_size, s->pps, s->pps_size, PS_OUT_OF_BAND, j, &plain);
                 new_idr = 0;
             /* if only SPS has been seen, also insert PPS */
             } else if (new_idr && unit_type == H264_NAL_IDR_SLICE && sps_seen && !pps_seen) {
                 if (!s->pps_size) {
                     LOG_ONCE(ctx, AV_LOG_WARNING, "PPS not present in the stream, nor in AVCC, stream may be unreadable\n");
+                    plain = 0;
                 } else {
-                    count_or_copy(&out, &out_size, s->pps, s->pps_size, PS_OUT_OF_BAND, j);
+                    count_or_copy(&out, &out_size, s->pps, s->pps_size, PS_OUT_OF_BAND, j, &plain);
                 }
             }
 
@@ -400,7 +412,7 @@ static int h264_mp4toannexb_filter(AVBSFContext *ctx, AVPacket *opkt)
                 ps = PS_IN_BAND;
             else
                 ps = PS_NONE;
-            count_or_copy(&out, &out_size, buf, nal_size, ps, j);
+            count_or_copy(&out, &out_size, buf, nal_size, ps, j, &plain);
             if (unit_type == H264_NAL_SLICE) {
                 new_idr  = 1;
                 sps_seen = 0;
@@ -415,6 +427,23 @@ static int h264_mp4toannexb_filter(AVBSFContext *ctx, AVPacket *opkt)
                 ret = AVERROR_INVALIDDATA;
                 goto fail;
             }
+            /* If the packet is a single NAL unit and nothing needs to be
+             * inserted, the only change is the 4-byte length field becoming
+             * a 4-byte start code; rewrite it in place instead of copying. */
+            if (plain && s->length_size == 4 && out_size == in->size) {
+                ret = av_packet_make_writable(in);
+                if (ret < 0)
+                    goto fail;
+                AV_WB32(in->data, 1);
+
+                s->new_idr      = new_idr;
+                s->idr_sps_seen = sps_seen;
+                s->idr_pps_seen = pps_seen;
+
+                av_packet_move_ref(opkt, in);
+                av_packet_free(&in);
+                return 0;
+            }
             ret = av_new_packet(opkt, out_size);
             if (ret < 0)
                 goto fail;
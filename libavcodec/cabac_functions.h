@@ -163,6 +163,32 @@ av_unused static int get_cabac_bypass(CABACContext *c){
 }
 #endif
 
+#ifndef get_cabac_bypass_bits
+/**
+ * Decode n bypass-coded bins and return them MSB-first.
+ *
+ * Bypass bins do not renormalize the range, so the comparison value is
+ * hoisted out of the loop and each bin is extracted branchlessly; the
+ * only remaining branch is the refill, taken once per CABAC_BITS bins.
+ */
+static av_always_inline unsigned get_cabac_bypass_bits(CABACContext *c, int n)
+{
+    const int range = c->range << (CABAC_BITS + 1);
+    unsigned bits = 0;
+
+    while (n-- > 0) {
+        int sign;
+        c->low += c->low;
+        if (!(c->low & CABAC_MASK))
+            refill(c);
+        sign = (c->low - range) >> 31; // -1 if the bin is 0
+        bits = (bits << 1) + sign + 1;
+        c->low -= range & ~sign;
+    }
+    return bits;
+}
+#endif
+
 #ifndef get_cabac_bypass_sign
 static av_always_inline int get_cabac_bypass_sign(CABACContext *c, int val){
     int range, mask;
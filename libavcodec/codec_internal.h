@@ -87,6 +87,12 @@
  * encoders do.
  */
 #define FF_CODEC_CAP_EOF_FLUSH              (1 << 10)
+/**
+ * The decoder can (re)initialize from AV_PKT_DATA_NEW_EXTRADATA packet side
+ * data, so avcodec_reconfigure() may change the extradata without reopening
+ * the decoder.
+ */
+#define FF_CODEC_CAP_NEW_EXTRADATA          (1 << 11)
 
 /**
  * FFCodec.codec_tags termination value
@@ -21,6 +21,8 @@
 
 #include "config_components.h"
 
+#include <inttypes.h>
+
 #include "compat/cuda/dynlink_loader.h"
 
 #include "libavutil/buffer.h"
@@ -93,6 +95,12 @@ typedef struct CuvidContext
     int internal_error;
     int decoder_flushing;
 
+    /* aggregate session utilization, logged on close */
+    uint64_t nb_decode_calls;
+    uint64_t nb_output_frames;
+    int peak_queue_depth;
+    int nb_session_inits;
+
     int *key_frame;
 
     cudaVideoCodec codec_type;
@@ -401,6 +409,7 @@ static int CUDAAPI cuvid_handle_video_sequence(void *opaque, CUVIDEOFORMAT* form
     ctx->internal_error = CHECK_CU(ctx->cvdl->cuvidCreateDecoder(&ctx->cudecoder, &cuinfo));
     if (ctx->internal_error < 0)
         return 0;
+    ctx->nb_session_inits++;
 
     if (!hwframe_ctx->pool) {
         hwframe_ctx->format = AV_PIX_FMT_CUDA;
@@ -436,6 +445,8 @@ static int CUDAAPI cuvid_handle_picture_decode(void *opaque, CUVIDPICPARAMS* pic
     if (ctx->internal_error < 0)
         return 0;
 
+    ctx->nb_decode_calls++;
+
     return 1;
 }
 
@@ -470,6 +481,10 @@ static int CUDAAPI cuvid_handle_picture_display(void *opaque, CUVIDPARSERDISPINF
         }
     }
 
+    ctx->nb_output_frames++;
+    ctx->peak_queue_depth = FFMAX(ctx->peak_queue_depth,
+                                  (int)av_fifo_can_read(ctx->frame_queue));
+
     return 1;
 }
 
@@ -764,6 +779,13 @@ static av_cold int cuvid_decode_end(AVCodecContext *avctx)
     AVCUDADeviceContext *device_hwctx = device_ctx ? device_ctx->hwctx : NULL;
     CUcontext dummy, cuda_ctx = device_hwctx ? device_hwctx->cuda_ctx : NULL;
 
+    if (ctx->nb_decode_calls)
+        av_log(avctx, AV_LOG_VERBOSE, "NVDEC session: %"PRIu64" pictures decoded, "
+               "%"PRIu64" frames output, peak output queue depth %d with "
+               "%d surfaces, %d decoder session init(s).\n",
+               ctx->nb_decode_calls, ctx->nb_output_frames,
+               ctx->peak_queue_depth, ctx->nb_surfaces, ctx->nb_session_inits);
+
     av_fifo_freep2(&ctx->frame_queue);
 
     if (cuda_ctx) {
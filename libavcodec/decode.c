@@ -40,6 +40,7 @@
 #include "libavutil/mem.h"
 #include "libavutil/stereo3d.h"
 #include "libavutil/threadprogress.h"
+#include "libavutil/time.h"
 
 #include "avcodec.h"
 #include "avcodec_internal.h"
@@ -92,6 +93,22 @@ typedef struct DecodeContext {
      * (global or attached to packets) side data over bytestream.
      */
     uint64_t side_data_pref_mask;
+
+    /**
+     * Extradata from avcodec_reconfigure() to be attached to the next packet
+     * as AV_PKT_DATA_NEW_EXTRADATA side data.
+     */
+    uint8_t *new_extradata;
+    size_t   new_extradata_size;
+
+    /* load shedding state for AVCodecContext.frame_deadline, see qos_update() */
+    int qos_level;
+    int qos_hold;                        ///< frames to wait before the next step
+    int64_t qos_ema;                     ///< smoothed decode time per frame, in us
+    int64_t qos_degraded_start;
+    int64_t qos_degraded_time;           ///< total time spent degraded, in us
+    enum AVDiscard qos_skip_frame;       ///< user-configured baseline
+    enum AVDiscard qos_skip_loop_filter; ///< user-configured baseline
 } DecodeContext;
 
 static DecodeContext *decode_ctx(AVCodecInternal *avci)
@@ -220,6 +237,18 @@ static int decode_get_packet(AVCodecContext *avctx, AVPacket *pkt)
     if (ret < 0)
         return ret;
 
+    if (decode_ctx(avci)->new_extradata) {
+        DecodeContext *dc = decode_ctx(avci);
+
+        ret = av_packet_add_side_data(pkt, AV_PKT_DATA_NEW_EXTRADATA,
+                                      dc->new_extradata,
+                                      dc->new_extradata_size);
+        if (ret < 0)
+            goto finish;
+        dc->new_extradata      = NULL;
+        dc->new_extradata_size = 0;
+    }
+
     if (!(ffcodec(avctx->codec)->caps_internal & FF_CODEC_CAP_SETS_FRAME_PROPS)) {
         ret = extract_packet_props(avctx->internal, pkt);
         if (ret < 0)
@@ -402,6 +431,65 @@ static int discard_samples(AVCodecContext *avctx, AVFrame *frame, int64_t *disca
  * returning any output, so this function needs to be called in a loop until it
  * returns EAGAIN.
  **/
+#define QOS_MAX_LEVEL 4
+
+static void qos_apply(AVCodecContext *avctx, DecodeContext *dc)
+{
+    static const enum AVDiscard skip_lf[QOS_MAX_LEVEL + 1] = {
+        AVDISCARD_DEFAULT, AVDISCARD_NONKEY, AVDISCARD_ALL,
+        AVDISCARD_ALL,     AVDISCARD_ALL,
+    };
+    static const enum AVDiscard skip_frame[QOS_MAX_LEVEL + 1] = {
+        AVDISCARD_DEFAULT, AVDISCARD_DEFAULT, AVDISCARD_DEFAULT,
+        AVDISCARD_NONREF,  AVDISCARD_BIDIR,
+    };
+
+    avctx->skip_loop_filter = FFMAX(dc->qos_skip_loop_filter, skip_lf[dc->qos_level]);
+    avctx->skip_frame       = FFMAX(dc->qos_skip_frame,       skip_frame[dc->qos_level]);
+}
+
+/* Track the smoothed wall-clock cost of decoding a frame against
+ * AVCodecContext.frame_deadline and engage progressively stronger skip
+ * settings while we are behind, restoring them as we catch up. The hold
+ * counter gives the smoothed estimate time to react to the previous step
+ * before the next one is taken. */
+static void qos_update(AVCodecContext *avctx, DecodeContext *dc, int64_t duration)
+{
+    dc->qos_ema += (duration - dc->qos_ema) / 8;
+
+    if (dc->qos_hold > 0) {
+        dc->qos_hold--;
+        return;
+    }
+
+    if (dc->qos_ema > avctx->frame_deadline && dc->qos_level < QOS_MAX_LEVEL) {
+        if (!dc->qos_level) {
+            dc->qos_skip_frame       = avctx->skip_frame;
+            dc->qos_skip_loop_filter = avctx->skip_loop_filter;
+            dc->qos_degraded_start   = av_gettime_relative();
+        }
+        dc->qos_level++;
+        dc->qos_hold = 8;
+        qos_apply(avctx, dc);
+        av_log(avctx, AV_LOG_VERBOSE,
+               "QoS: %"PRId64" us/frame over a %"PRId64" us deadline, "
+               "degradation level %d\n",
+               dc->qos_ema, avctx->frame_deadline, dc->qos_level);
+    } else if (dc->qos_level &&
+               dc->qos_ema < avctx->frame_deadline - avctx->frame_deadline / 4) {
+        dc->qos_level--;
+        dc->qos_hold = 8;
+        qos_apply(avctx, dc);
+        if (!dc->qos_level) {
+            avctx->skip_frame       = dc->qos_skip_frame;
+            avctx->skip_loop_filter = dc->qos_skip_loop_filter;
+            dc->qos_degraded_time  += av_gettime_relative() - dc->qos_degraded_start;
+        }
+        av_log(avctx, AV_LOG_VERBOSE, "QoS: caught up, degradation level %d\n",
+               dc->qos_level);
+    }
+}
+
 static inline int decode_simple_internal(AVCodecContext *avctx, AVFrame *frame, int64_t *discarded_samples)
 {
     AVCodecInternal   *avci = avctx->internal;
@@ -409,6 +497,7 @@ static inline int decode_simple_internal(AVCodecContext *avctx, AVFrame *frame,
     AVPacket     *const pkt = avci->in_pkt;
     const FFCodec *const codec = ffcodec(avctx->codec);
     int got_frame, consumed;
+    int64_t qos_time;
     int ret;
 
     if (!pkt->data && !avci->draining) {
@@ -429,10 +518,17 @@ static inline int decode_simple_internal(AVCodecContext *avctx, AVFrame *frame,
 
     got_frame = 0;
 
+    qos_time = avctx->frame_deadline > 0 && pkt->data &&
+               avctx->codec->type == AVMEDIA_TYPE_VIDEO
+                   ? av_gettime_relative() : 0;
+
     frame->pict_type = dc->initial_pict_type;
     frame->flags    |= dc->intra_only_flag;
     consumed = codec->cb.decode(avctx, frame, &got_frame, pkt);
 
+    if (qos_time)
+        qos_update(avctx, dc, av_gettime_relative() - qos_time);
+
     if (!(codec->caps_internal & FF_CODEC_CAP_SETS_PKT_DTS))
         frame->pkt_dts = pkt->dts;
     emms_c();
@@ -2231,11 +2327,76 @@ av_cold void ff_decode_flush_buffers(AVCodecContext *avctx)
     dc->draining_started   = 0;
 }
 
+int ff_decode_reconfigure(AVCodecContext *avctx, const AVCodecParameters *par)
+{
+    DecodeContext *dc = decode_ctx(avctx->internal);
+    uint8_t *extradata = NULL;
+    int extradata_size = 0;
+    int extradata_changed, ret;
+
+    if (par->codec_type != avctx->codec_type ||
+        par->codec_id   != avctx->codec_id)
+        return AVERROR(EINVAL);
+
+    extradata_changed = par->extradata_size != avctx->extradata_size ||
+                        (par->extradata_size &&
+                         memcmp(par->extradata, avctx->extradata,
+                                par->extradata_size));
+    if (extradata_changed &&
+        !(ffcodec(avctx->codec)->caps_internal & FF_CODEC_CAP_NEW_EXTRADATA))
+        return AVERROR(ENOSYS);
+
+    avcodec_flush_buffers(avctx);
+
+    if (!extradata_changed) {
+        /* the decoder may hold references into the extradata,
+         * keep the existing buffer */
+        extradata             = avctx->extradata;
+        extradata_size        = avctx->extradata_size;
+        avctx->extradata      = NULL;
+        avctx->extradata_size = 0;
+    }
+    ret = avcodec_parameters_to_context(avctx, par);
+    if (!extradata_changed) {
+        av_free(avctx->extradata);
+        avctx->extradata      = extradata;
+        avctx->extradata_size = extradata_size;
+    }
+    if (ret < 0)
+        return ret;
+
+    if (extradata_changed && par->extradata_size) {
+        av_free(dc->new_extradata);
+        dc->new_extradata = av_mallocz(par->extradata_size +
+                                       AV_INPUT_BUFFER_PADDING_SIZE);
+        if (!dc->new_extradata)
+            return AVERROR(ENOMEM);
+        memcpy(dc->new_extradata, par->extradata, par->extradata_size);
+        dc->new_extradata_size = par->extradata_size;
+    }
+
+    return 0;
+}
+
 av_cold AVCodecInternal *ff_decode_internal_alloc(void)
 {
     return av_mallocz(sizeof(DecodeContext));
 }
 
+av_cold void ff_decode_internal_uninit(AVCodecContext *avctx)
+{
+    DecodeContext *dc = decode_ctx(avctx->internal);
+
+    if (dc->qos_level)
+        dc->qos_degraded_time += av_gettime_relative() - dc->qos_degraded_start;
+    if (dc->qos_degraded_time)
+        av_log(avctx, AV_LOG_INFO, "QoS: spent %.2f seconds in degraded decoding\n",
+               dc->qos_degraded_time / 1000000.0);
+
+    av_freep(&dc->new_extradata);
+    dc->new_extradata_size = 0;
+}
+
 static int attach_displaymatrix(AVCodecContext *avctx, AVFrame *frame, int orientation)
 {
     AVFrameSideData *sd = NULL;
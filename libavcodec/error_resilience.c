@@ -37,7 +37,6 @@
 #include "me_cmp.h"
 #include "mpegutils.h"
 #include "mpegvideo.h"
-#include "threadframe.h"
 
 /**
  * @param stride the number of MVs to get to the next row
@@ -413,12 +412,8 @@ static void guess_mv(ERContext *s)
     set_mv_strides(s, &mot_step, &mot_stride);
 
     num_avail = 0;
-    if (s->last_pic.motion_val[0]) {
-        if (s->last_pic.tf)
-            ff_thread_await_progress(s->last_pic.tf, mb_height-1, 0);
-        else
-            ff_thread_progress_await(s->last_pic.progress, mb_height - 1);
-    }
+    if (s->last_pic.motion_val[0])
+        ff_thread_progress_await(s->last_pic.progress, mb_height - 1);
     for (i = 0; i < mb_width * mb_height; i++) {
         const int mb_xy = s->mb_index2xy[i];
         int f = 0;
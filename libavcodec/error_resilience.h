@@ -40,7 +40,6 @@ typedef struct MPVEncContext MPVEncContext;
 
 typedef struct ERPicture {
     AVFrame *f;
-    const struct ThreadFrame *tf;
     const struct ThreadProgress *progress;
 
     // it is the caller's responsibility to allocate these buffers
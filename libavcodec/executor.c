@@ -64,6 +64,7 @@ struct FFExecutor {
     AVMutex lock;
     AVCond cond;
     int die;
+    int idle;
 
     Queue *q;
 };
@@ -121,7 +122,9 @@ static void *executor_worker_task(void *data)
 
         if (!run_one_task(e, lc)) {
             //no task in one loop
+            e->idle++;
             ff_cond_wait(&e->cond, &e->lock);
+            e->idle--;
         }
     }
     ff_mutex_unlock(&e->lock);
@@ -217,7 +220,12 @@ void ff_executor_execute(FFExecutor *e, FFTask *t)
     if (t)
         add_task(e->q + t->priority % e->cb.priorities, t);
     if (e->thread_count) {
-        ff_cond_signal(&e->cond);
+        // Only wake a worker if one is actually waiting; when all of
+        // them are busy, the next one to finish its task will pick the
+        // new one up before going to sleep. With fine-grained tasks this
+        // skips one kernel wakeup per submission.
+        if (e->idle)
+            ff_cond_signal(&e->cond);
         ff_mutex_unlock(&e->lock);
     }
 
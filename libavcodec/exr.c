@@ -1492,12 +1492,24 @@ static int decode_block(AVCodecContext *avctx, void *tdata,
                     memset(ptr, 0, bxmin);
 
                 if (s->pixel_type == EXR_FLOAT) {
-                    for (int x = 0; x < xsize; x++, ptr_x += step)
-                        AV_WN32A(ptr_x, bytestream_get_le32(&src));
+                    if (!HAVE_BIGENDIAN && step == 4) {
+                        /* unit stride (planar output): samples are already
+                         * in place, copy the whole row at once */
+                        memcpy(ptr_x, src, xsize * 4);
+                        ptr_x += xsize * 4;
+                    } else {
+                        for (int x = 0; x < xsize; x++, ptr_x += step)
+                            AV_WN32A(ptr_x, bytestream_get_le32(&src));
+                    }
                 } else if (s->pixel_type == EXR_HALF) {
                     // 16-bit
-                    for (int x = 0; x < xsize; x++, ptr_x += step)
-                        AV_WN16A(ptr_x, bytestream_get_le16(&src));
+                    if (!HAVE_BIGENDIAN && step == 2) {
+                        memcpy(ptr_x, src, xsize * 2);
+                        ptr_x += xsize * 2;
+                    } else {
+                        for (int x = 0; x < xsize; x++, ptr_x += step)
+                            AV_WN16A(ptr_x, bytestream_get_le16(&src));
+                    }
                 }
 
                 // Zero out the end if xmax+1 is not w
@@ -75,13 +75,27 @@ static void flac_lpc_32_c(int32_t *decoded, const int coeffs[32],
 {
     int i, j;
 
-    for (i = pred_order; i < len; i++, decoded++) {
+    for (i = pred_order; i < len - 1; i += 2, decoded += 2) {
+        int64_t c = coeffs[0];
+        int64_t d = decoded[0];
+        uint64_t s0 = 0, s1 = 0;
+        for (j = 1; j < pred_order; j++) {
+            s0 += c * d;
+            d   = decoded[j];
+            s1 += c * d;
+            c   = coeffs[j];
+        }
+        s0 += c * d;
+        d   = decoded[j] += (int64_t)s0 >> qlevel;
+        s1 += c * d;
+        decoded[j + 1] += (int64_t)s1 >> qlevel;
+    }
+    if (i < len) {
         int64_t sum = 0;
         for (j = 0; j < pred_order; j++)
             sum += (int64_t)coeffs[j] * decoded[j];
         decoded[j] += sum >> qlevel;
     }
-
 }
 
 static void flac_lpc_33_c(int64_t *decoded, const int32_t *residual,
@@ -90,7 +104,22 @@ static void flac_lpc_33_c(int64_t *decoded, const int32_t *residual,
 {
     int i, j;
 
-    for (i = pred_order; i < len; i++, decoded++) {
+    for (i = pred_order; i < len - 1; i += 2, decoded += 2) {
+        uint64_t c = coeffs[0];
+        uint64_t d = decoded[0];
+        uint64_t s0 = 0, s1 = 0;
+        for (j = 1; j < pred_order; j++) {
+            s0 += c * d;
+            d   = decoded[j];
+            s1 += c * d;
+            c   = coeffs[j];
+        }
+        s0 += c * d;
+        d   = decoded[j] = (uint64_t)residual[i] + (uint64_t)((int64_t)s0 >> qlevel);
+        s1 += c * d;
+        decoded[j + 1] = (uint64_t)residual[i + 1] + (uint64_t)((int64_t)s1 >> qlevel);
+    }
+    if (i < len) {
         int64_t sum = 0;
         for (j = 0; j < pred_order; j++)
             sum += (int64_t)coeffs[j] * (uint64_t)decoded[j];
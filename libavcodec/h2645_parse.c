@@ -468,7 +468,7 @@ int ff_h2645_packet_split(H2645Packet *pkt, const uint8_t *buf, int length,
                           enum AVCodecID codec_id, int flags)
 {
     GetByteContext bc;
-    int consumed, ret = 0;
+    int consumed, small_padding, ret = 0;
     int next_avc = (flags & H2645_FLAG_IS_NALFF) ? 0 : length;
     int64_t padding = (flags & H2645_FLAG_SMALL_PADDING) ? 0 : MAX_MBPAIR_SIZE;
 
@@ -550,8 +550,18 @@ int ff_h2645_packet_split(H2645Packet *pkt, const uint8_t *buf, int length,
         }
         nal = &pkt->nals[pkt->nb_nals];
 
+        small_padding = !!(flags & H2645_FLAG_SMALL_PADDING);
+        /* Callers that overread past the end of a NAL (and therefore do not
+         * set H2645_FLAG_SMALL_PADDING) can still reference the source
+         * buffer directly when the following NALs provide enough bytes to
+         * serve as padding; only NALs close to the end of the packet have
+         * to be copied out then. */
+        if (!small_padding &&
+            length - (bytestream2_tell(&bc) + (int64_t)extract_length) >= padding)
+            small_padding = 1;
+
         consumed = ff_h2645_extract_rbsp(bc.buffer, extract_length, &pkt->rbsp, nal,
-                                         !!(flags & H2645_FLAG_SMALL_PADDING));
+                                         small_padding);
         if (consumed < 0)
             return consumed;
 
@@ -1531,9 +1531,7 @@ static int decode_cabac_mb_mvd(H264SliceContext *sl, int ctxbase, int amvd, int
                 return INT_MIN;
             }
         }
-        while( k-- ) {
-            mvd += get_cabac_bypass( &sl->cabac )<<k;
-        }
+        mvd += get_cabac_bypass_bits( &sl->cabac, k );
         *mvda=mvd < 70 ? mvd : 70;
     }else
         *mvda=mvd;
@@ -1747,11 +1745,7 @@ decode_cabac_residual_internal(const H264Context *h, H264SliceContext *sl,
                     j++; \
                 } \
 \
-                coeff_abs=1; \
-                while( j-- ) { \
-                    coeff_abs += coeff_abs + get_cabac_bypass( CC ); \
-                } \
-                coeff_abs+= 14U; \
+                coeff_abs = ((1U << j) | get_cabac_bypass_bits( CC, j )) + 14U; \
             } \
 \
             if( is_dc ) { \
@@ -30,7 +30,6 @@
 #include "h264_ps.h"
 #include "mpegutils.h"
 #include "rectangle.h"
-#include "threadframe.h"
 
 #include <assert.h>
 
@@ -190,10 +189,9 @@ static void await_reference_mb_row(const H264Context *const h, H264Ref *ref,
     /* FIXME: It can be safe to access mb stuff
      * even if pixels aren't deblocked yet. */
 
-    ff_thread_await_progress(&ref->parent->tf,
+    ff_thread_progress_await(&ref->parent->progress[ref_field_picture && ref_field],
                              FFMIN(16 * mb_y >> ref_field_picture,
-                                   ref_height - 1),
-                             ref_field_picture && ref_field);
+                                   ref_height - 1));
 }
 
 static void pred_spatial_direct_motion(const H264Context *const h, H264SliceContext *sl,
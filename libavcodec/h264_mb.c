@@ -35,7 +35,6 @@
 #include "h264_ps.h"
 #include "qpeldsp.h"
 #include "rectangle.h"
-#include "threadframe.h"
 
 static inline int get_lowest_part_list_y(H264SliceContext *sl,
                                          int n, int height, int y_offset, int list)
@@ -178,26 +177,21 @@ static void await_references(const H264Context *h, H264SliceContext *sl)
 
                 if (!FIELD_PICTURE(h) && ref_field_picture) { // frame referencing two fields
                     av_assert2((ref_pic->parent->reference & 3) == 3);
-                    ff_thread_await_progress(&ref_pic->parent->tf,
+                    ff_thread_progress_await(&ref_pic->parent->progress[1],
                                              FFMIN((row >> 1) - !(row & 1),
-                                                   pic_height - 1),
-                                             1);
-                    ff_thread_await_progress(&ref_pic->parent->tf,
-                                             FFMIN((row >> 1), pic_height - 1),
-                                             0);
+                                                   pic_height - 1));
+                    ff_thread_progress_await(&ref_pic->parent->progress[0],
+                                             FFMIN((row >> 1), pic_height - 1));
                 } else if (FIELD_PICTURE(h) && !ref_field_picture) { // field referencing one field of a frame
-                    ff_thread_await_progress(&ref_pic->parent->tf,
+                    ff_thread_progress_await(&ref_pic->parent->progress[0],
                                              FFMIN(row * 2 + ref_field,
-                                                   pic_height - 1),
-                                             0);
+                                                   pic_height - 1));
                 } else if (FIELD_PICTURE(h)) {
-                    ff_thread_await_progress(&ref_pic->parent->tf,
-                                             FFMIN(row, pic_height - 1),
-                                             ref_field);
+                    ff_thread_progress_await(&ref_pic->parent->progress[ref_field],
+                                             FFMIN(row, pic_height - 1));
                 } else {
-                    ff_thread_await_progress(&ref_pic->parent->tf,
-                                             FFMIN(row, pic_height - 1),
-                                             0);
+                    ff_thread_progress_await(&ref_pic->parent->progress[0],
+                                             FFMIN(row, pic_height - 1));
                 }
             }
         }
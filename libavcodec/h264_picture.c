@@ -45,6 +45,7 @@ void ff_h264_unref_picture(H264Picture *pic)
         return;
 
     ff_thread_release_ext_buffer(&pic->tf);
+    av_refstruct_unref(&pic->progress);
     av_frame_unref(pic->f_grain);
     av_refstruct_unref(&pic->hwaccel_picture_private);
 
@@ -62,6 +63,7 @@ void ff_h264_unref_picture(H264Picture *pic)
 
 static void h264_copy_picture_params(H264Picture *dst, const H264Picture *src)
 {
+    av_refstruct_replace(&dst->progress, src->progress);
     av_refstruct_replace(&dst->qscale_table_base, src->qscale_table_base);
     av_refstruct_replace(&dst->mb_type_base,      src->mb_type_base);
     av_refstruct_replace(&dst->pps, src->pps);
@@ -174,7 +176,7 @@ void ff_h264_set_erpic(ERPicture *dst, const H264Picture *src)
         return;
 
     dst->f = src->f;
-    dst->tf = &src->tf;
+    dst->progress = src->progress;
 
     for (i = 0; i < 2; i++) {
         dst->motion_val[i] = src->motion_val[i];
@@ -224,8 +226,8 @@ int ff_h264_field_end(H264Context *h, H264SliceContext *sl, int in_setup)
     }
 
     if (!in_setup && !h->droppable)
-        ff_thread_report_progress(&cur->tf, INT_MAX,
-                                  h->picture_structure == PICT_BOTTOM_FIELD);
+        ff_thread_progress_report(&cur->progress[h->picture_structure == PICT_BOTTOM_FIELD],
+                                  INT_MAX);
     emms_c();
 
     h->current_slice = 0;
@@ -185,6 +185,14 @@ static int init_table_pools(H264Context *h)
     return 0;
 }
 
+static void h264_progress_free(AVRefStructOpaque unused, void *obj)
+{
+    ThreadProgress *progress = obj;
+
+    ff_thread_progress_destroy(&progress[0]);
+    ff_thread_progress_destroy(&progress[1]);
+}
+
 static int alloc_picture(H264Context *h, H264Picture *pic)
 {
     int i, ret = 0;
@@ -197,6 +205,19 @@ static int alloc_picture(H264Context *h, H264Picture *pic)
     if (ret < 0)
         goto fail;
 
+    pic->progress = av_refstruct_alloc_ext(2 * sizeof(*pic->progress), 0,
+                                           NULL, h264_progress_free);
+    if (!pic->progress) {
+        ret = AVERROR(ENOMEM);
+        goto fail;
+    }
+    for (i = 0; i < 2; i++) {
+        ret = ff_thread_progress_init(&pic->progress[i],
+                                      h->avctx->active_thread_type & FF_THREAD_FRAME);
+        if (ret < 0)
+            goto fail;
+    }
+
     if (pic->needs_fg) {
         pic->f_grain->format = pic->f->format;
         pic->f_grain->width = pic->f->width;
@@ -1452,7 +1473,7 @@ static int h264_field_start(H264Context *h, const H264SliceContext *sl,
 
         /* Mark old field/frame as completed */
         if (h->cur_pic_ptr->tf.owner[last_field] == h->avctx) {
-            ff_thread_report_progress(&h->cur_pic_ptr->tf, INT_MAX, last_field);
+            ff_thread_progress_report(&h->cur_pic_ptr->progress[last_field], INT_MAX);
         }
 
         /* figure out if we have a complementary field pair */
@@ -1460,8 +1481,8 @@ static int h264_field_start(H264Context *h, const H264SliceContext *sl,
             /* Previous field is unmatched. Don't display it, but let it
              * remain for reference if marked as such. */
             if (last_pic_structure != PICT_FRAME) {
-                ff_thread_report_progress(&h->cur_pic_ptr->tf, INT_MAX,
-                                          last_pic_structure == PICT_TOP_FIELD);
+                ff_thread_progress_report(&h->cur_pic_ptr->progress[last_pic_structure == PICT_TOP_FIELD],
+                                          INT_MAX);
             }
         } else {
             if (h->cur_pic_ptr->frame_num != h->poc.frame_num) {
@@ -1470,8 +1491,8 @@ static int h264_field_start(H264Context *h, const H264SliceContext *sl,
                  * pair. Throw away previous field except for reference
                  * purposes. */
                 if (last_pic_structure != PICT_FRAME) {
-                    ff_thread_report_progress(&h->cur_pic_ptr->tf, INT_MAX,
-                                              last_pic_structure == PICT_TOP_FIELD);
+                    ff_thread_progress_report(&h->cur_pic_ptr->progress[last_pic_structure == PICT_TOP_FIELD],
+                                              INT_MAX);
                 }
             } else {
                 /* Second field in complementary pair */
@@ -1514,8 +1535,8 @@ static int h264_field_start(H264Context *h, const H264SliceContext *sl,
         h->poc.prev_frame_num        %= 1 << sps->log2_max_frame_num;
         h->cur_pic_ptr->frame_num = h->poc.prev_frame_num;
         h->cur_pic_ptr->invalid_gap = !sps->gaps_in_frame_num_allowed_flag;
-        ff_thread_report_progress(&h->cur_pic_ptr->tf, INT_MAX, 0);
-        ff_thread_report_progress(&h->cur_pic_ptr->tf, INT_MAX, 1);
+        ff_thread_progress_report(&h->cur_pic_ptr->progress[0], INT_MAX);
+        ff_thread_progress_report(&h->cur_pic_ptr->progress[1], INT_MAX);
 
         h->explicit_ref_marking = 0;
         ret = ff_h264_execute_ref_pic_marking(h);
@@ -1540,9 +1561,9 @@ static int h264_field_start(H264Context *h, const H264SliceContext *sl,
                 h->short_ref[0]->f->width == prev->f->width &&
                 h->short_ref[0]->f->height == prev->f->height &&
                 h->short_ref[0]->f->format == prev->f->format) {
-                ff_thread_await_progress(&prev->tf, INT_MAX, 0);
+                ff_thread_progress_await(&prev->progress[0], INT_MAX);
                 if (prev->field_picture)
-                    ff_thread_await_progress(&prev->tf, INT_MAX, 1);
+                    ff_thread_progress_await(&prev->progress[1], INT_MAX);
                 ff_thread_release_ext_buffer(&h->short_ref[0]->tf);
                 h->short_ref[0]->tf.f = h->short_ref[0]->f;
                 ret = ff_thread_ref_frame(&h->short_ref[0]->tf, &prev->tf);
@@ -1550,9 +1571,9 @@ static int h264_field_start(H264Context *h, const H264SliceContext *sl,
                     return ret;
                 h->short_ref[0]->poc = prev->poc + 2U;
                 h->short_ref[0]->gray = prev->gray;
-                ff_thread_report_progress(&h->short_ref[0]->tf, INT_MAX, 0);
+                ff_thread_progress_report(&h->short_ref[0]->progress[0], INT_MAX);
                 if (h->short_ref[0]->field_picture)
-                    ff_thread_report_progress(&h->short_ref[0]->tf, INT_MAX, 1);
+                    ff_thread_progress_report(&h->short_ref[0]->progress[1], INT_MAX);
             } else if (!h->frame_recovered) {
                 if (!h->avctx->hwaccel)
                     color_frame(h->short_ref[0]->f, c);
@@ -1580,8 +1601,8 @@ static int h264_field_start(H264Context *h, const H264SliceContext *sl,
         } else {
             h->missing_fields = 0;
             if (h->cur_pic_ptr->frame_num != h->poc.frame_num) {
-                ff_thread_report_progress(&h->cur_pic_ptr->tf, INT_MAX,
-                                          h->picture_structure==PICT_BOTTOM_FIELD);
+                ff_thread_progress_report(&h->cur_pic_ptr->progress[h->picture_structure==PICT_BOTTOM_FIELD],
+                                          INT_MAX);
                 /* This and the previous field had different frame_nums.
                  * Consider this field first in pair. Throw away previous
                  * one except for reference purposes. */
@@ -2102,8 +2123,8 @@ int ff_h264_queue_decode_slice(H264Context *h, const H2645NAL *nal)
             } else if (h->cur_pic_ptr && !FIELD_PICTURE(h) && !h->first_field && h->nal_unit_type  == H264_NAL_IDR_SLICE) {
                 av_log(h->avctx, AV_LOG_WARNING, "Broken frame packetizing\n");
                 ret = ff_h264_field_end(h, h->slice_ctx, 1);
-                ff_thread_report_progress(&h->cur_pic_ptr->tf, INT_MAX, 0);
-                ff_thread_report_progress(&h->cur_pic_ptr->tf, INT_MAX, 1);
+                ff_thread_progress_report(&h->cur_pic_ptr->progress[0], INT_MAX);
+                ff_thread_progress_report(&h->cur_pic_ptr->progress[1], INT_MAX);
                 h->cur_pic_ptr = NULL;
                 if (ret < 0)
                     return ret;
@@ -2113,8 +2134,8 @@ int ff_h264_queue_decode_slice(H264Context *h, const H2645NAL *nal)
 
         if (!h->first_field) {
             if (h->cur_pic_ptr && !h->droppable) {
-                ff_thread_report_progress(&h->cur_pic_ptr->tf, INT_MAX,
-                                          h->picture_structure == PICT_BOTTOM_FIELD);
+                ff_thread_progress_report(&h->cur_pic_ptr->progress[h->picture_structure == PICT_BOTTOM_FIELD],
+                                          INT_MAX);
             }
             h->cur_pic_ptr = NULL;
         }
@@ -2532,8 +2553,8 @@ static void decode_finish_row(const H264Context *h, H264SliceContext *sl)
     if (h->droppable || h->er.error_occurred)
         return;
 
-    ff_thread_report_progress(&h->cur_pic_ptr->tf, top + height - 1,
-                              h->picture_structure == PICT_BOTTOM_FIELD);
+    ff_thread_progress_report(&h->cur_pic_ptr->progress[h->picture_structure == PICT_BOTTOM_FIELD],
+                              top + height - 1);
 }
 
 static void er_add_slice(H264SliceContext *sl,
@@ -817,8 +817,8 @@ end:
 #endif /* CONFIG_ERROR_RESILIENCE */
     /* clean up */
     if (h->cur_pic_ptr && !h->droppable && h->has_slice) {
-        ff_thread_report_progress(&h->cur_pic_ptr->tf, INT_MAX,
-                                  h->picture_structure == PICT_BOTTOM_FIELD);
+        ff_thread_progress_report(&h->cur_pic_ptr->progress[h->picture_structure == PICT_BOTTOM_FIELD],
+                                  INT_MAX);
     }
 
     return (ret < 0) ? ret : buf_size;
@@ -1149,7 +1149,8 @@ const FFCodec ff_h264_decoder = {
                                NULL
                            },
     .caps_internal         = FF_CODEC_CAP_EXPORTS_CROPPING |
-                             FF_CODEC_CAP_INIT_CLEANUP,
+                             FF_CODEC_CAP_INIT_CLEANUP |
+                             FF_CODEC_CAP_NEW_EXTRADATA,
     .flush                 = h264_decode_flush,
     UPDATE_THREAD_CONTEXT(ff_h264_update_thread_context),
     UPDATE_THREAD_CONTEXT_FOR_USER(ff_h264_update_thread_context_for_user),
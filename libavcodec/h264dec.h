@@ -29,6 +29,7 @@
 #define AVCODEC_H264DEC_H
 
 #include "libavutil/mem_internal.h"
+#include "libavutil/threadprogress.h"
 
 #include "cabac.h"
 #include "error_resilience.h"
@@ -113,6 +114,15 @@ typedef struct H264Picture {
     AVFrame *f;
     ThreadFrame tf;
 
+    /**
+     * RefStruct reference to an array of two ThreadProgress, one per
+     * field, shared between all references to the same picture.
+     * Replaces the ThreadFrame progress mechanism: reports and
+     * already-satisfied waits are plain atomic operations instead of
+     * taking a per-thread mutex and broadcasting a condition variable.
+     */
+    ThreadProgress *progress;
+
     AVFrame *f_grain;
 
     int8_t *qscale_table_base;        ///< RefStruct reference
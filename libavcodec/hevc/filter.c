@@ -24,8 +24,10 @@
 
 #include "libavutil/common.h"
 #include "libavutil/internal.h"
+#include "libavutil/pixdesc.h"
 
 #include "hevcdec.h"
+#include "mpegutils.h"
 #include "progressframe.h"
 
 #define LUMA 0
@@ -869,6 +871,37 @@ void ff_hevc_deblocking_boundary_strengths(HEVCLocalContext *lc, const HEVCLayer
 #undef CB
 #undef CR
 
+static void draw_horiz_band(const HEVCContext *s, int y, int height)
+{
+    AVCodecContext *avctx = s->avctx;
+    const AVFrame   *src  = s->cur_frame->f;
+    const AVPixFmtDescriptor *desc;
+    int offset[AV_NUM_DATA_POINTERS];
+    int vshift;
+
+    if (!avctx->draw_horiz_band)
+        return;
+
+    if (y < 0) {
+        height += y;
+        y       = 0;
+    }
+    height = FFMIN(height, avctx->height - y);
+    if (height <= 0)
+        return;
+
+    desc   = av_pix_fmt_desc_get(avctx->pix_fmt);
+    vshift = desc->log2_chroma_h;
+
+    offset[0] = y * src->linesize[0];
+    offset[1] =
+    offset[2] = (y >> vshift) * src->linesize[1];
+    for (int i = 3; i < AV_NUM_DATA_POINTERS; i++)
+        offset[i] = 0;
+
+    avctx->draw_horiz_band(avctx, src, offset, y, PICT_FRAME, height);
+}
+
 void ff_hevc_hls_filter(HEVCLocalContext *lc, const HEVCLayerContext *l,
                         const HEVCPPS *pps,
                         int x, int y, int ctb_size)
@@ -876,16 +909,7 @@ void ff_hevc_hls_filter(HEVCLocalContext *lc, const HEVCLayerContext *l,
     const HEVCSPS   *const sps = pps->sps;
     const HEVCContext *const s = lc->parent;
     int x_end = x >= sps->width  - ctb_size;
-    int skip = 0;
-    if (s->avctx->skip_loop_filter >= AVDISCARD_ALL ||
-        (s->avctx->skip_loop_filter >= AVDISCARD_NONKEY && !IS_IDR(s)) ||
-        (s->avctx->skip_loop_filter >= AVDISCARD_NONINTRA &&
-         s->sh.slice_type != HEVC_SLICE_I) ||
-        (s->avctx->skip_loop_filter >= AVDISCARD_BIDIR &&
-         s->sh.slice_type == HEVC_SLICE_B) ||
-        (s->avctx->skip_loop_filter >= AVDISCARD_NONREF &&
-        ff_hevc_nal_is_nonref(s->nal_unit_type)))
-        skip = 1;
+    int skip = s->sh.skip_loop_filter;
 
     if (!skip)
         deblocking_filter_CTB(s, l, pps, sps, x, y);
@@ -897,16 +921,25 @@ void ff_hevc_hls_filter(HEVCLocalContext *lc, const HEVCLayerContext *l,
             sao_filter_CTB(lc, l, s, pps, sps, x - ctb_size, y);
         if (y && x_end) {
             sao_filter_CTB(lc, l, s, pps, sps, x, y - ctb_size);
+            draw_horiz_band(s, y - ctb_size, ctb_size);
             if (s->avctx->active_thread_type & FF_THREAD_FRAME )
                 ff_progress_frame_report(&s->cur_frame->tf, y);
         }
         if (x_end && y_end) {
             sao_filter_CTB(lc, l, s, pps, sps, x , y);
+            draw_horiz_band(s, y, ctb_size);
             if (s->avctx->active_thread_type & FF_THREAD_FRAME )
                 ff_progress_frame_report(&s->cur_frame->tf, y + ctb_size);
         }
-    } else if (s->avctx->active_thread_type & FF_THREAD_FRAME && x_end)
-        ff_progress_frame_report(&s->cur_frame->tf, y + ctb_size - 4);
+    } else if (x_end) {
+        int y_end = y >= sps->height - ctb_size;
+
+        /* the deblocking of the next CTB row may still modify
+         * the last 4 lines of this one */
+        draw_horiz_band(s, y - 4, y_end ? ctb_size + 4 : ctb_size);
+        if (s->avctx->active_thread_type & FF_THREAD_FRAME)
+            ff_progress_frame_report(&s->cur_frame->tf, y + ctb_size - 4);
+    }
 }
 
 void ff_hevc_hls_filters(HEVCLocalContext *lc, const HEVCLayerContext *l,
@@ -1181,6 +1181,16 @@ static int hls_slice_header(SliceHeader *sh, const HEVCContext *s, GetBitContext
         return AVERROR_INVALIDDATA;
     }
 
+    sh->skip_loop_filter =
+        s->avctx->skip_loop_filter >= AVDISCARD_ALL ||
+        (s->avctx->skip_loop_filter >= AVDISCARD_NONKEY && !IS_IDR(s)) ||
+        (s->avctx->skip_loop_filter >= AVDISCARD_NONINTRA &&
+         sh->slice_type != HEVC_SLICE_I) ||
+        (s->avctx->skip_loop_filter >= AVDISCARD_BIDIR &&
+         sh->slice_type == HEVC_SLICE_B) ||
+        (s->avctx->skip_loop_filter >= AVDISCARD_NONREF &&
+         ff_hevc_nal_is_nonref(s->nal_unit_type));
+
     sh->slice_ctb_addr_rs = sh->slice_segment_addr;
 
     if (sh->dependent_slice_segment_flag &&
@@ -4035,6 +4045,12 @@ static int hevc_update_thread_context(AVCodecContext *dst,
             if (ret < 0)
                 return ret;
         }
+
+        /* Use the source context's table pools rather than per-context ones,
+         * so that entries released by one frame thread can be reused by the
+         * others instead of every thread caching its own. */
+        av_refstruct_replace(&l->tab_mvf_pool, l0->tab_mvf_pool);
+        av_refstruct_replace(&l->rpl_tab_pool, l0->rpl_tab_pool);
     }
 
     for (int i = 0; i < FF_ARRAY_ELEMS(s->ps.vps_list); i++)
@@ -4245,10 +4261,12 @@ const FFCodec ff_hevc_decoder = {
     .flush                 = hevc_decode_flush,
     UPDATE_THREAD_CONTEXT(hevc_update_thread_context),
     .p.capabilities        = AV_CODEC_CAP_DR1 | AV_CODEC_CAP_DELAY |
+                             AV_CODEC_CAP_DRAW_HORIZ_BAND |
                              AV_CODEC_CAP_SLICE_THREADS | AV_CODEC_CAP_FRAME_THREADS,
     .caps_internal         = FF_CODEC_CAP_EXPORTS_CROPPING |
                              FF_CODEC_CAP_USES_PROGRESSFRAMES |
-                             FF_CODEC_CAP_INIT_CLEANUP,
+                             FF_CODEC_CAP_INIT_CLEANUP |
+                             FF_CODEC_CAP_NEW_EXTRADATA,
     .p.profiles            = NULL_IF_CONFIG_SMALL(ff_hevc_profiles),
     .hw_configs            = (const AVCodecHWConfigInternal *const []) {
 #if CONFIG_HEVC_DXVA2_HWACCEL
@@ -241,6 +241,7 @@ typedef struct SliceHeader {
 
     uint8_t cabac_init_flag;
     uint8_t disable_deblocking_filter_flag; ///< slice_header_disable_deblocking_filter_flag
+    uint8_t skip_loop_filter; ///< derived from avctx->skip_loop_filter for this slice
     uint8_t slice_loop_filter_across_slices_enabled_flag;
     uint8_t collocated_list;
 
@@ -70,6 +70,13 @@ typedef struct AVCodecInternal {
 
     struct AVRefStructPool *progress_frame_pool;
 
+    /**
+     * Buffer pool used for the AV_FRAME_DATA_MOTION_VECTORS side data, so
+     * that exporting motion vectors on every frame does not allocate.
+     */
+    AVBufferPool *mv_export_pool;
+    size_t mv_export_pool_size;
+
     void *thread_ctx;
 
     /**
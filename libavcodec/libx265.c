@@ -71,6 +71,7 @@ typedef struct libx265Context {
     char *preset;
     char *tune;
     char *profile;
+    char *pools;
     char *stats;
     AVDictionary *x265_opts;
 
@@ -496,6 +497,13 @@ static av_cold int libx265_encode_init(AVCodecContext *avctx)
             return ret;
     }
 
+    if (ctx->pools) {
+        if (ctx->api->param_parse(ctx->params, "pools", ctx->pools) == X265_PARAM_BAD_VALUE) {
+            av_log(avctx, AV_LOG_ERROR, "Invalid value \"%s\" for param \"pools\".\n", ctx->pools);
+            return AVERROR(EINVAL);
+        }
+    }
+
     {
         const AVDictionaryEntry *en = NULL;
         while ((en = av_dict_iterate(ctx->x265_opts, en))) {
@@ -1028,6 +1036,7 @@ static const AVOption options[] = {
     { "preset",      "set the x265 preset",                                                         OFFSET(preset),    AV_OPT_TYPE_STRING, { 0 }, 0, 0, VE },
     { "tune",        "set the x265 tune parameter",                                                 OFFSET(tune),      AV_OPT_TYPE_STRING, { 0 }, 0, 0, VE },
     { "profile",     "set the x265 profile",                                                        OFFSET(profile),   AV_OPT_TYPE_STRING, { 0 }, 0, 0, VE },
+    { "pools",       "set the x265 thread pools, one per NUMA node by default",                     OFFSET(pools),     AV_OPT_TYPE_STRING, { 0 }, 0, 0, VE },
     { "x265-stats",  "Filename for 2 pass stats",                                                   OFFSET(stats),     AV_OPT_TYPE_STRING, { 0 }, 0, 0, VE },
     { "udu_sei",     "Use user data unregistered SEI if available",                                 OFFSET(udu_sei),   AV_OPT_TYPE_BOOL,   { .i64 = 0 }, 0, 1, VE },
     { "a53cc",       "Use A53 Closed Captions (if available)",                                      OFFSET(a53_cc),    AV_OPT_TYPE_BOOL,   { .i64 = 0 }, 0, 1, VE },
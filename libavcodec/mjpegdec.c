@@ -795,35 +795,36 @@ int ff_mjpeg_decode_sof(MJpegDecodeContext *s)
     return 0;
 }
 
-static inline int mjpeg_decode_dc(MJpegDecodeContext *s, int dc_index, int *val)
+static inline int mjpeg_decode_dc(MJpegDecodeContext *s, GetBitContext *gb,
+                                  int dc_index, int *val)
 {
     int code;
-    code = get_vlc2(&s->gb, s->vlcs[0][dc_index].table, 9, 2);
+    code = get_vlc2(gb, s->vlcs[0][dc_index].table, 9, 2);
     if (code < 0 || code > 16) {
         av_log(s->avctx, AV_LOG_ERROR,
                "mjpeg_decode_dc: bad vlc: %d\n", dc_index);
         return AVERROR_INVALIDDATA;
     }
 
-    *val = code ? get_xbits(&s->gb, code) : 0;
+    *val = code ? get_xbits(gb, code) : 0;
     return 0;
 }
 
 /* decode block and dequantize */
-static int decode_block(MJpegDecodeContext *s, int16_t *block, int component,
+static int decode_block(MJpegDecodeContext *s, GetBitContext *gb, int *last_dc,
+                        int16_t *block, int component,
                         int dc_index, int ac_index, uint16_t *quant_matrix)
 {
     const uint8_t *permutated_scantable = s->permutated_scantable;
-    GetBitContext *gb = &s->gb;
     int code, i, j, level, val;
 
     /* DC coef */
-    int ret = mjpeg_decode_dc(s, dc_index, &val);
+    int ret = mjpeg_decode_dc(s, gb, dc_index, &val);
     if (ret < 0)
         return ret;
 
-    val = val * (unsigned)quant_matrix[0] + s->last_dc[component];
-    s->last_dc[component] = val;
+    val = val * (unsigned)quant_matrix[0] + last_dc[component];
+    last_dc[component] = val;
     block[0] = av_clip_int16(val);
     /* AC coefs */
     i = 0;
@@ -853,7 +854,7 @@ static int decode_dc_progressive(MJpegDecodeContext *s, int16_t *block,
 {
     unsigned val;
     s->bdsp.clear_block(block);
-    int ret = mjpeg_decode_dc(s, dc_index, &val);
+    int ret = mjpeg_decode_dc(s, &s->gb, dc_index, &val);
     if (ret < 0)
         return ret;
 
@@ -1092,7 +1093,7 @@ static int ljpeg_decode_rgb_scan(MJpegDecodeContext *s)
                 topleft[i] = top[i];
                 top[i]     = buffer[mb_x][i];
 
-                ret = mjpeg_decode_dc(s, s->dc_index[i], &dc);
+                ret = mjpeg_decode_dc(s, &s->gb, s->dc_index[i], &dc);
                 if (ret < 0)
                     return ret;
 
@@ -1230,7 +1231,7 @@ static int ljpeg_decode_yuv_scan(MJpegDecodeContext *s)
                     for (j=0; j<n; j++) {
                         int pred, dc;
 
-                        ret = mjpeg_decode_dc(s, s->dc_index[i], &dc);
+                        ret = mjpeg_decode_dc(s, &s->gb, s->dc_index[i], &dc);
                         if (ret < 0)
                             return ret;
 
@@ -1298,7 +1299,7 @@ static int ljpeg_decode_yuv_scan(MJpegDecodeContext *s)
                     for (j = 0; j < n; j++) {
                         int pred;
 
-                        ret = mjpeg_decode_dc(s, s->dc_index[i], &dc);
+                        ret = mjpeg_decode_dc(s, &s->gb, s->dc_index[i], &dc);
                         if (ret < 0)
                             return ret;
 
@@ -1364,6 +1365,253 @@ static void shift_output(MJpegDecodeContext *s, uint8_t *ptr, int linesize)
     }
 }
 
+/* Restart-interval parallel decoding of a baseline scan.
+ *
+ * Restart markers reset the DC predictors and are byte aligned, so the
+ * entropy-coded segments between them are fully independent and every MCU
+ * position is known in advance. The escaped scan data is split at the
+ * markers (unambiguous there, as entropy 0xFF bytes are still stuffed),
+ * and each segment is unescaped and decoded on the slice thread pool.
+ * Anything unexpected in the bitstream makes the caller fall back to the
+ * sequential path, which re-decodes the scan and reports errors as usual.
+ */
+typedef struct MJpegRestartSegment {
+    const uint8_t *start;     ///< first escaped byte of the segment
+    int size;                 ///< escaped size, markers excluded
+} MJpegRestartSegment;
+
+typedef struct MJpegParallelScanContext {
+    MJpegRestartSegment *seg;
+    int nb_segments;
+    int mcus_per_segment;
+    int total_mcus;
+    int chroma_width, chroma_height;
+    const uint8_t *scan_end;  ///< where the sequential parser would leave gB
+} MJpegParallelScanContext;
+
+static int scan_restart_segments(MJpegDecodeContext *s,
+                                 MJpegParallelScanContext *ps)
+{
+    const uint8_t *buf = s->gB.buffer;
+    const uint8_t *end = buf + bytestream2_get_bytes_left(&s->gB);
+    const uint8_t *p = buf, *seg_start = buf;
+    int i = 0;
+
+    while (i < ps->nb_segments) {
+        const uint8_t *ff = memchr(p, 0xff, end - p);
+        const uint8_t *q;
+
+        if (!ff || ff + 1 >= end) {
+            /* the last segment may run to the end of the buffer */
+            if (i != ps->nb_segments - 1)
+                return AVERROR_INVALIDDATA;
+            ps->seg[i].start = seg_start;
+            ps->seg[i].size  = (ff ? ff : end) - seg_start;
+            ps->scan_end     = end;
+            return 0;
+        }
+        q = ff + 1;
+        while (q < end && *q == 0xff)
+            q++;
+        if (q >= end) {
+            if (i != ps->nb_segments - 1)
+                return AVERROR_INVALIDDATA;
+            ps->seg[i].start = seg_start;
+            ps->seg[i].size  = ff - seg_start;
+            ps->scan_end     = end;
+            return 0;
+        }
+        if (*q == 0x00) {
+            /* stuffed byte (or trailing fill), not a marker */
+            p = q + 1;
+            continue;
+        }
+        ps->seg[i].start = seg_start;
+        ps->seg[i].size  = ff - seg_start;
+        i++;
+        if (*q >= RST0 && *q <= RST7) {
+            if (i == ps->nb_segments || *q != RST0 + ((i - 1) & 7))
+                return AVERROR_INVALIDDATA;
+            seg_start = p = q + 1;
+        } else {
+            /* a real marker must terminate the final segment */
+            if (i != ps->nb_segments)
+                return AVERROR_INVALIDDATA;
+            ps->scan_end = q - 1;
+            return 0;
+        }
+    }
+    return AVERROR_INVALIDDATA;
+}
+
+static int unescape_segment(const uint8_t *src, int size, uint8_t *dst)
+{
+    const uint8_t *end = src + size, *p = src, *cs = src;
+    uint8_t *dst0 = dst;
+
+    while ((p = memchr(p, 0xff, end - p))) {
+        memcpy(dst, cs, p - cs);
+        dst += p - cs;
+        p++;
+        /* discard multiple optional 0xFF fill bytes */
+        while (p < end && *p == 0xff)
+            p++;
+        if (p >= end || *p != 0x00)
+            return AVERROR_INVALIDDATA;
+        *dst++ = 0xff;
+        p++;
+        cs = p;
+    }
+    memcpy(dst, cs, end - cs);
+    dst += end - cs;
+    return dst - dst0;
+}
+
+static int decode_restart_segment(AVCodecContext *avctx, void *arg,
+                                  int jobnr, int threadnr)
+{
+    MJpegDecodeContext *s = avctx->priv_data;
+    const MJpegParallelScanContext *ps = arg;
+    const MJpegRestartSegment *seg = &ps->seg[jobnr];
+    const int bytes_per_pixel = 1 + (s->bits > 8);
+    const int lowres = avctx->lowres;
+    DECLARE_ALIGNED(32, int16_t, block)[64];
+    int last_dc[MAX_COMPONENTS];
+    GetBitContext gb;
+    uint8_t *unescaped;
+    int mcu     = jobnr * ps->mcus_per_segment;
+    int mcu_end = FFMIN(mcu + ps->mcus_per_segment, ps->total_mcus);
+    int size, ret = 0;
+
+    unescaped = av_malloc(seg->size + AV_INPUT_BUFFER_PADDING_SIZE);
+    if (!unescaped)
+        return AVERROR(ENOMEM);
+    size = unescape_segment(seg->start, seg->size, unescaped);
+    if (size < 0) {
+        av_free(unescaped);
+        return size;
+    }
+    memset(unescaped + size, 0, AV_INPUT_BUFFER_PADDING_SIZE);
+    init_get_bits8(&gb, unescaped, size);
+
+    for (int i = 0; i < s->nb_components_sos; i++)
+        last_dc[i] = (4 << s->bits);
+
+    for (; mcu < mcu_end && ret >= 0; mcu++) {
+        const int mb_x = mcu % s->mb_width;
+        const int mb_y = mcu / s->mb_width;
+
+        for (int i = 0; i < s->nb_components_sos && ret >= 0; i++) {
+            const int ac_index = s->ac_index[i];
+            const int dc_index = s->dc_index[i];
+            const int c = s->comp_index[i];
+            const int plane_height = (c == 1) || (c == 2) ? ps->chroma_height : s->height;
+            const int plane_width  = (c == 1) || (c == 2) ? ps->chroma_width  : s->width;
+            const int linesizec = s->linesize[c];
+            const int n = s->nb_blocks[i];
+            const int h = s->h_scount[i];
+            const int v = s->v_scount[i];
+            const int h_mb_x = h * mb_x;
+            const int v_mb_y = v * mb_y;
+            int x = 0, y = 0;
+
+            for (int j = 0; j < n; j++) {
+                int block_offset = (((linesizec * (v_mb_y + y) * 8) +
+                                     (h_mb_x + x) * 8 * bytes_per_pixel) >> lowres);
+                uint8_t *ptr;
+
+                if (8 * (h_mb_x + x) < plane_width &&
+                    8 * (v_mb_y + y) < plane_height) {
+                    ptr = s->picture_ptr->data[c] + block_offset;
+                } else
+                    ptr = NULL;
+
+                s->bdsp.clear_block(block);
+                if (decode_block(s, &gb, last_dc, block, i,
+                                 dc_index, ac_index,
+                                 s->quant_matrixes[s->quant_sindex[i]]) < 0) {
+                    ret = AVERROR_INVALIDDATA;
+                    break;
+                }
+                if (ptr && linesizec) {
+                    s->idsp.idct_put(ptr, linesizec, block);
+                    if (s->bits & 7)
+                        shift_output(s, ptr, linesizec);
+                }
+                if (++x == h) {
+                    x = 0;
+                    y++;
+                }
+            }
+        }
+        if (get_bits_left(&gb) < 0)
+            ret = AVERROR_INVALIDDATA;
+    }
+
+    /* up to 7 padding bits may remain before the next marker */
+    if (ret >= 0 && get_bits_left(&gb) > 7)
+        ret = AVERROR_INVALIDDATA;
+
+    av_free(unescaped);
+    return ret;
+}
+
+/* Return 0 when the scan was decoded in parallel, AVERROR(EAGAIN) when the
+ * sequential path has to be taken instead. */
+static int mjpeg_decode_scan_parallel(MJpegDecodeContext *s)
+{
+    int total_mcus = s->mb_width * s->mb_height;
+    int nb_segments, chroma_h_shift, chroma_v_shift;
+    MJpegParallelScanContext ps = { 0 };
+    int *jret = NULL;
+    int ret, i;
+
+    if (total_mcus <= 0)
+        return AVERROR(EAGAIN);
+    nb_segments = (total_mcus + s->restart_interval - 1) / s->restart_interval;
+    if (nb_segments < 2)
+        return AVERROR(EAGAIN);
+
+    ps.seg = av_malloc_array(nb_segments, sizeof(*ps.seg));
+    jret   = av_malloc_array(nb_segments, sizeof(*jret));
+    if (!ps.seg || !jret) {
+        ret = AVERROR(ENOMEM);
+        goto end;
+    }
+    ps.nb_segments      = nb_segments;
+    ps.mcus_per_segment = s->restart_interval;
+    ps.total_mcus       = total_mcus;
+
+    av_pix_fmt_get_chroma_sub_sample(s->avctx->pix_fmt, &chroma_h_shift,
+                                     &chroma_v_shift);
+    ps.chroma_width  = AV_CEIL_RSHIFT(s->width,  chroma_h_shift);
+    ps.chroma_height = AV_CEIL_RSHIFT(s->height, chroma_v_shift);
+
+    ret = scan_restart_segments(s, &ps);
+    if (ret < 0) {
+        ret = AVERROR(EAGAIN);
+        goto end;
+    }
+
+    ret = s->avctx->execute2(s->avctx, decode_restart_segment, &ps, jret,
+                             nb_segments);
+    if (ret < 0)
+        goto end;
+    for (i = 0; i < nb_segments; i++) {
+        if (jret[i] < 0) {
+            ret = jret[i] == AVERROR(ENOMEM) ? jret[i] : AVERROR(EAGAIN);
+            goto end;
+        }
+    }
+
+    bytestream2_skipu(&s->gB, ps.scan_end - s->gB.buffer);
+    ret = 0;
+end:
+    av_freep(&ps.seg);
+    av_freep(&jret);
+    return ret;
+}
+
 static int mjpeg_decode_scan(MJpegDecodeContext *s)
 {
     int nb_components = s->nb_components_sos;
@@ -1414,6 +1662,17 @@ static int mjpeg_decode_scan(MJpegDecodeContext *s)
         s->coefs_finished[c] |= 1;
     }
 
+    if (!progressive && !mb_bitmask && s->restart_interval     &&
+        s->avctx->codec_id != AV_CODEC_ID_THP                  &&
+        s->avctx->codec_id != AV_CODEC_ID_MJPEGB               &&
+        s->avctx->codec_id != AV_CODEC_ID_MEDIA100             &&
+        (s->avctx->active_thread_type & FF_THREAD_SLICE)       &&
+        s->avctx->thread_count > 1) {
+        ret = mjpeg_decode_scan_parallel(s);
+        if (ret != AVERROR(EAGAIN))
+            return ret;
+    }
+
     s->restart_count = -1;
 
     for (mb_y = 0; mb_y < s->mb_height; mb_y++) {
@@ -1479,7 +1738,7 @@ static int mjpeg_decode_scan(MJpegDecodeContext *s)
 
                         } else {
                             s->bdsp.clear_block(block);
-                            if (decode_block(s, block, i,
+                            if (decode_block(s, gb, s->last_dc, block, i,
                                              dc_index, ac_index,
                                              s->quant_matrixes[s->quant_sindex[i]]) < 0) {
                                 av_log(s->avctx, AV_LOG_ERROR,
@@ -2907,7 +3166,8 @@ const FFCodec ff_mjpeg_decoder = {
     .close          = ff_mjpeg_decode_end,
     FF_CODEC_DECODE_CB(ff_mjpeg_decode_frame),
     .flush          = decode_flush,
-    .p.capabilities = AV_CODEC_CAP_DR1 | AV_CODEC_CAP_FRAME_THREADS,
+    .p.capabilities = AV_CODEC_CAP_DR1 | AV_CODEC_CAP_FRAME_THREADS |
+                      AV_CODEC_CAP_SLICE_THREADS,
     .p.max_lowres   = 3,
     .p.priv_class   = &mjpegdec_class,
     .p.profiles     = NULL_IF_CONFIG_SMALL(ff_mjpeg_profiles),
@@ -90,6 +90,7 @@ static inline void init_ref(MotionEstContext *c, uint8_t *const src[3],
         ((y*c->uvstride + x)>>1),
     };
     int i;
+    c->hint_set = 0;
     for(i=0; i<3; i++){
         c->src[0][i]= src[i] ? src[i] + offset[i] : NULL;
         c->ref[0][i]= ref[i] ? ref[i] + offset[i] : NULL;
@@ -961,6 +962,17 @@ void ff_estimate_p_frame_motion(MPVEncContext *const s,
             c->pred_x = P_LEFT[0];
             c->pred_y = P_LEFT[1];
         }
+
+        if (c->mv_hints) {
+            const int16_t *const hint = c->mv_hints[s->c.mb_stride * mb_y + mb_x];
+
+            if (hint[0] != INT16_MIN) {
+                c->hint_mv[0] = hint[0];
+                c->hint_mv[1] = hint[1];
+                c->hint_set   = 1;
+            }
+        }
+
         dmin = ff_epzs_motion_search(s, &mx, &my, P, 0, 0, s->p_mv_table, (1<<16)>>shift, 0, 16);
     }
 
@@ -76,6 +76,9 @@ typedef struct MotionEstContext {
     int ymax;
     int pred_x;
     int pred_y;
+    const int16_t (*mv_hints)[2];   ///< per-MB fullpel hints from side data, INT16_MIN = none
+    int hint_mv[2];                 ///< fullpel search hint for the current MB
+    int hint_set;                   ///< whether hint_mv is valid for the current MB
     const uint8_t *src[4][4];
     const uint8_t *ref[4][4];
     int stride;
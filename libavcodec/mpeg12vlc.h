@@ -30,6 +30,11 @@
 
 #include "vlc.h"
 
+#ifndef BUILD_TABLES
+#include "config.h"
+#define BUILD_TABLES !CONFIG_HARDCODED_TABLES
+#endif
+
 #define DC_VLC_BITS 9
 #define MV_VLC_BITS 8
 #define TEX_VLC_BITS 9
@@ -39,6 +44,15 @@
 #define MB_PTYPE_VLC_BITS 6
 #define MB_BTYPE_VLC_BITS 6
 
+#if !BUILD_TABLES
+extern const VLCElem ff_dc_lum_vlc[];
+extern const VLCElem ff_dc_chroma_vlc[];
+extern const VLCElem ff_mbincr_vlc[];
+extern const VLCElem ff_mb_ptype_vlc[];
+extern const VLCElem ff_mb_btype_vlc[];
+extern const VLCElem ff_mb_pat_vlc[];
+extern const VLCElem ff_mv_vlc[];
+#else
 extern VLCElem ff_dc_lum_vlc[];
 extern VLCElem ff_dc_chroma_vlc[];
 extern VLCElem ff_mbincr_vlc[];
@@ -46,6 +60,7 @@ extern VLCElem ff_mb_ptype_vlc[];
 extern VLCElem ff_mb_btype_vlc[];
 extern VLCElem ff_mb_pat_vlc[];
 extern VLCElem ff_mv_vlc[];
+#endif
 
 void ff_mpeg12_init_vlcs(void);
 
@@ -57,8 +72,13 @@ extern const int8_t ff_mpeg12_run[MPEG12_RL_NB_ELEMS];
 extern const uint16_t ff_mpeg1_vlc_table[MPEG12_RL_NB_ELEMS + 2][2];
 extern const uint16_t ff_mpeg2_vlc_table[MPEG12_RL_NB_ELEMS + 2][2];
 
+#if !BUILD_TABLES
+extern const RL_VLC_ELEM ff_mpeg1_rl_vlc[];
+extern const RL_VLC_ELEM ff_mpeg2_rl_vlc[];
+#else
 extern RL_VLC_ELEM ff_mpeg1_rl_vlc[];
 extern RL_VLC_ELEM ff_mpeg2_rl_vlc[];
+#endif
 
 void ff_init_2d_vlc_rl(const uint16_t table_vlc[][2], RL_VLC_ELEM rl_vlc[],
                        const int8_t table_run[], const uint8_t table_level[],
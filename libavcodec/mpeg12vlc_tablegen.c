@@ -0,0 +1,47 @@
+/*
+ * Generate a header file for hardcoded MPEG-1/2 VLC tables
+ *
+ * This file is part of Librempeg
+ *
+ * Librempeg is free software; you can redistribute it and/or modify
+ * it under the terms of the GNU General Public License as published by
+ * the Free Software Foundation; either version 3 of the License, or
+ * (at your option) any later version.
+ *
+ * Librempeg is distributed in the hope that it will be useful,
+ * but WITHOUT ANY WARRANTY; without even the implied warranty of
+ * MERCHANTABILITY or FITNESS FOR A PARTICULAR PURPOSE.  See the
+ * GNU General Public License for more details.
+ *
+ * You should have received a copy of the GNU General Public License along
+ * with Librempeg; if not, write to the Free Software Foundation, Inc.,
+ * 51 Franklin Street, Fifth Floor, Boston, MA 02110-1301 USA.
+ */
+
+#include <stdlib.h>
+#define BUILD_TABLES 1
+#include "mpegutils.h"
+#include "tableprint_vlc.h"
+#include "mpeg12vlc_tablegen.h"
+
+int main(void)
+{
+    mpeg12_init_vlcs();
+
+    write_fileheader();
+
+    WRITE_VLC_TABLE("const", ff_mv_vlc);
+
+    WRITE_VLC_TABLE("const", ff_dc_lum_vlc);
+    WRITE_VLC_TABLE("const", ff_dc_chroma_vlc);
+
+    WRITE_VLC_TABLE("const", ff_mbincr_vlc);
+    WRITE_VLC_TABLE("const", ff_mb_ptype_vlc);
+    WRITE_VLC_TABLE("const", ff_mb_btype_vlc);
+    WRITE_VLC_TABLE("const", ff_mb_pat_vlc);
+
+    WRITE_ARRAY("const", RL_VLC_ELEM, ff_mpeg1_rl_vlc);
+    WRITE_ARRAY("const", RL_VLC_ELEM, ff_mpeg2_rl_vlc);
+
+    return 0;
+}
@@ -30,6 +30,7 @@
 #include "libavutil/avassert.h"
 
 #include "avcodec.h"
+#include "internal.h"
 #include "mpegutils.h"
 
 static int add_mb(AVMotionVector *mb, uint32_t mb_type,
@@ -162,6 +163,7 @@ void ff_print_debug_info2(AVCodecContext *avctx, AVFrame *pict,
                                       is_h264 ? MB_TYPE_L1 : MB_TYPE_BACKWARD_MV };
 
     if ((avctx->export_side_data & AV_CODEC_EXPORT_DATA_MVS) && mbtype_table && motion_val[0]) {
+        AVCodecInternal *const avci = avctx->internal;
         const int shift = 1 + quarter_sample;
         const int scale = 1 << shift;
         const int mv_sample_log2 = is_h264 ? 2 : 1;
@@ -170,9 +172,23 @@ void ff_print_debug_info2(AVCodecContext *avctx, AVFrame *pict,
 
         /* size is width * height * 2 * 4 where 2 is for directions and 4 is
          * for the maximum number of MB (4 MB in case of IS_8x8) */
-        AVMotionVector *mvs = av_malloc_array(mb_width * mb_height, 2 * 4 * sizeof(AVMotionVector));
-        if (!mvs)
+        const size_t max_size = sizeof(AVMotionVector) * mb_width * mb_height * 2 * 4;
+        AVBufferRef *mvbuf;
+        AVMotionVector *mvs;
+
+        /* The buffers are recycled through a pool once downstream drops its
+         * references, so exporting on every frame does not allocate. */
+        if (avci->mv_export_pool_size != max_size) {
+            av_buffer_pool_uninit(&avci->mv_export_pool);
+            avci->mv_export_pool      = av_buffer_pool_init(max_size, NULL);
+            avci->mv_export_pool_size = avci->mv_export_pool ? max_size : 0;
+        }
+        if (!avci->mv_export_pool)
+            return;
+        mvbuf = av_buffer_pool_get(avci->mv_export_pool);
+        if (!mvbuf)
             return;
+        mvs = (AVMotionVector *)mvbuf->data;
 
         for (mb_y = 0; mb_y < mb_height; mb_y++) {
             for (mb_x = 0; mb_x < mb_width; mb_x++) {
@@ -232,15 +248,14 @@ void ff_print_debug_info2(AVCodecContext *avctx, AVFrame *pict,
             AVFrameSideData *sd;
 
             av_log(avctx, AV_LOG_DEBUG, "Adding %d MVs info to frame %"PRId64"\n", mbcount, avctx->frame_num);
-            sd = av_frame_new_side_data(pict, AV_FRAME_DATA_MOTION_VECTORS, mbcount * sizeof(AVMotionVector));
+            mvbuf->size = mbcount * sizeof(AVMotionVector);
+            sd = av_frame_new_side_data_from_buf(pict, AV_FRAME_DATA_MOTION_VECTORS, mvbuf);
             if (!sd) {
-                av_freep(&mvs);
+                av_buffer_unref(&mvbuf);
                 return;
             }
-            memcpy(sd->data, mvs, mbcount * sizeof(AVMotionVector));
-        }
-
-        av_freep(&mvs);
+        } else
+            av_buffer_unref(&mvbuf);
     }
 
     /* TODO: export all the following to make them accessible for users (and filters) */
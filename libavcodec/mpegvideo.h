@@ -277,6 +277,9 @@ typedef struct MpegEncContext {
     void (*dct_unquantize_inter)(const MPVContext *s, // unquantizer to use (MPEG-4 can use both)
                                  int16_t *block/*align 16*/, int n, int qscale);
 
+    /// MB reconstruction specialized for lowres and codec family, set at frame start
+    void (*reconstruct_mb)(MPVContext *s, int16_t block[12][64]);
+
     /* flag to indicate a reinitialization is required, e.g. after
      * a frame size change */
     int context_reinit;
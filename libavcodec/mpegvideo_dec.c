@@ -344,11 +344,14 @@ int ff_mpv_alloc_dummy_frames(MpegEncContext *s)
  * generic function called after decoding
  * the header and before a frame is decoded.
  */
+static void select_reconstruct_mb(MpegEncContext *s);
+
 int ff_mpv_frame_start(MpegEncContext *s, AVCodecContext *avctx)
 {
     int ret;
 
     s->mb_skipped = 0;
+    select_reconstruct_mb(s);
 
     if (!ff_thread_can_start_frame(avctx)) {
         av_log(avctx, AV_LOG_ERROR, "Attempt to start a frame outside SETUP state\n");
@@ -1121,6 +1124,44 @@ static av_cold void debug_dct_coeffs(MPVContext *s, const int16_t block[][64])
     }
 }
 
+#if !CONFIG_SMALL
+static void reconstruct_mb_mpeg12_h261(MPVContext *s, int16_t block[12][64])
+{
+    mpv_reconstruct_mb_internal(s, block, 0, DEFINITELY_MPEG12_H261);
+}
+
+static void reconstruct_mb_generic(MPVContext *s, int16_t block[12][64])
+{
+    mpv_reconstruct_mb_internal(s, block, 0, NOT_MPEG12_H261);
+}
+#else
+static void reconstruct_mb_generic(MPVContext *s, int16_t block[12][64])
+{
+    mpv_reconstruct_mb_internal(s, block, 0, MAY_BE_MPEG12_H261);
+}
+#endif
+
+static void reconstruct_mb_lowres(MPVContext *s, int16_t block[12][64])
+{
+    mpv_reconstruct_mb_internal(s, block, 1, MAY_BE_MPEG12_H261);
+}
+
+/* Bind the reconstruction kernel matching lowres and the codec family
+ * once per frame instead of re-dispatching on every macroblock. */
+static void select_reconstruct_mb(MpegEncContext *s)
+{
+    av_assert2((s->out_format <= FMT_H261) == (s->out_format == FMT_H261 || s->out_format == FMT_MPEG1));
+    if (!s->avctx->lowres) {
+#if !CONFIG_SMALL
+        s->reconstruct_mb = s->out_format <= FMT_H261 ? reconstruct_mb_mpeg12_h261
+                                                      : reconstruct_mb_generic;
+#else
+        s->reconstruct_mb = reconstruct_mb_generic;
+#endif
+    } else
+        s->reconstruct_mb = reconstruct_mb_lowres;
+}
+
 void ff_mpv_reconstruct_mb(MPVContext *s, int16_t block[][64])
 {
     const int mb_xy = s->mb_y * s->mb_stride + s->mb_x;
@@ -1142,16 +1183,5 @@ void ff_mpv_reconstruct_mb(MPVContext *s, int16_t block[][64])
     if (s->avctx->debug & FF_DEBUG_DCT_COEFF)
         debug_dct_coeffs(s, block);
 
-    av_assert2((s->out_format <= FMT_H261) == (s->out_format == FMT_H261 || s->out_format == FMT_MPEG1));
-    if (!s->avctx->lowres) {
-#if !CONFIG_SMALL
-        if (s->out_format <= FMT_H261)
-            mpv_reconstruct_mb_internal(s, block, 0, DEFINITELY_MPEG12_H261);
-        else
-            mpv_reconstruct_mb_internal(s, block, 0, NOT_MPEG12_H261);
-#else
-        mpv_reconstruct_mb_internal(s, block, 0, MAY_BE_MPEG12_H261);
-#endif
-    } else
-        mpv_reconstruct_mb_internal(s, block, 1, MAY_BE_MPEG12_H261);
+    s->reconstruct_mb(s, block);
 }
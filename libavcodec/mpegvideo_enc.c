@@ -42,6 +42,7 @@
 #include "libavutil/mathematics.h"
 #include "libavutil/mem.h"
 #include "libavutil/mem_internal.h"
+#include "libavutil/motion_vector.h"
 #include "libavutil/opt.h"
 #include "libavutil/thread.h"
 #include "avcodec.h"
@@ -1134,6 +1135,7 @@ av_cold int ff_mpv_encode_end(AVCodecContext *avctx)
     av_freep(&avctx->stats_out);
 
     av_freep(&m->mv_table_base);
+    av_freep(&m->mv_hint_table);
     av_freep(&s->p_field_select_table[0]);
     av_freep(&m->dct_error_sum_base);
 
@@ -1273,6 +1275,23 @@ static int get_intra_count(MPVEncContext *const s, const uint8_t *src,
     return acc;
 }
 
+typedef struct BFrameScoreJob {
+    MPVEncContext *s;
+    MPVPicture *pic;
+    const MPVPicture *ref;
+} BFrameScoreJob;
+
+static int b_frame_score_thread(AVCodecContext *avctx, void *arg)
+{
+    BFrameScoreJob *const job = arg;
+
+    job->pic->b_frame_score =
+        get_intra_count(job->s, job->pic->f->data[0],
+                        job->ref->f->data[0], job->s->c.linesize) + 1;
+
+    return 0;
+}
+
 /**
  * Allocates new buffers for an AVFrame and copies the properties
  * from another AVFrame.
@@ -1719,16 +1738,24 @@ static int set_bframe_chain_length(MPVMainEncContext *const m)
             while (b_frames && !m->input_picture[b_frames])
                 b_frames--;
         } else if (m->b_frame_strategy == 1) {
+            BFrameScoreJob jobs[MPVENC_MAX_B_FRAMES];
+            int nb_jobs = 0;
+
+            // the comparisons against the preceding input frame are
+            // independent of each other, so they can use the slice threads
             for (int i = 1; i < m->max_b_frames + 1; i++) {
                 if (m->input_picture[i] &&
                     m->input_picture[i]->b_frame_score == 0) {
-                    m->input_picture[i]->b_frame_score =
-                        get_intra_count(s,
-                                        m->input_picture[i    ]->f->data[0],
-                                        m->input_picture[i - 1]->f->data[0],
-                                        s->c.linesize) + 1;
+                    jobs[nb_jobs++] = (BFrameScoreJob) {
+                        .s   = s,
+                        .pic = m->input_picture[i],
+                        .ref = m->input_picture[i - 1],
+                    };
                 }
             }
+            if (nb_jobs)
+                s->c.avctx->execute(s->c.avctx, b_frame_score_thread,
+                                    jobs, NULL, nb_jobs, sizeof(jobs[0]));
             for (int i = 0;; i++) {
                 if (i >= m->max_b_frames + 1 ||
                     !m->input_picture[i] ||
@@ -3708,9 +3735,59 @@ static void set_frame_distances(MPVEncContext *const s)
     }
 }
 
+/**
+ * Turn motion-vector side data attached to the input frame (e.g. exported
+ * by a decoder with AV_CODEC_FLAG2_EXPORT_MVS during a transcode) into
+ * per-MB fullpel hints to seed the motion search with.
+ *
+ * @return the hint table, or NULL if no usable side data is present
+ */
+static const int16_t (*setup_mv_hints(MPVMainEncContext *const m))[2]
+{
+    MPVEncContext *const s = &m->s;
+    const int mb_count = s->c.mb_stride * s->c.mb_height;
+    const AVFrameSideData *sd;
+    const AVMotionVector *mvs;
+
+    if (s->c.pict_type != AV_PICTURE_TYPE_P)
+        return NULL;
+    sd = av_frame_get_side_data(s->new_pic, AV_FRAME_DATA_MOTION_VECTORS);
+    if (!sd || sd->size % sizeof(*mvs))
+        return NULL;
+    if (!m->mv_hint_table) {
+        m->mv_hint_table = av_malloc_array(mb_count, sizeof(*m->mv_hint_table));
+        if (!m->mv_hint_table) // hints are optional, so this is no error
+            return NULL;
+    }
+    for (int i = 0; i < mb_count; i++)
+        m->mv_hint_table[i][0] = m->mv_hint_table[i][1] = INT16_MIN;
+
+    mvs = (const AVMotionVector *)sd->data;
+    for (size_t i = 0; i < sd->size / sizeof(*mvs); i++) {
+        const AVMotionVector *const mv = &mvs[i];
+        int mb_x, mb_y;
+
+        // only vectors referencing the past are useful predictors
+        // for our own forward search
+        if (mv->source >= 0 || !mv->motion_scale ||
+            mv->dst_x < 0 || mv->dst_y < 0)
+            continue;
+        mb_x = mv->dst_x >> 4;
+        mb_y = mv->dst_y >> 4;
+        if (mb_x >= s->c.mb_width || mb_y >= s->c.mb_height)
+            continue;
+        m->mv_hint_table[mb_y * s->c.mb_stride + mb_x][0] =
+            av_clip(mv->motion_x / mv->motion_scale, INT16_MIN + 1, INT16_MAX);
+        m->mv_hint_table[mb_y * s->c.mb_stride + mb_x][1] =
+            av_clip(mv->motion_y / mv->motion_scale, INT16_MIN + 1, INT16_MAX);
+    }
+    return m->mv_hint_table;
+}
+
 static int encode_picture(MPVMainEncContext *const m, const AVPacket *pkt)
 {
     MPVEncContext *const s = &m->s;
+    const int16_t (*mv_hints)[2];
     int i, ret;
     int bits;
     int context_count = s->c.slice_context_count;
@@ -3743,6 +3820,8 @@ static int encode_picture(MPVMainEncContext *const m, const AVPacket *pkt)
         update_qscale(m);
     }
 
+    mv_hints = setup_mv_hints(m);
+
     s->c.mb_intra = 0; //for the rate distortion & bit compare functions
     for (int i = 0; i < context_count; i++) {
         MPVEncContext *const slice = s->c.enc_contexts[i];
@@ -3760,6 +3839,7 @@ static int encode_picture(MPVMainEncContext *const m, const AVPacket *pkt)
             slice->lambda2 = s->lambda2;
         }
         slice->me.temp = slice->me.scratchpad = slice->c.sc.scratchpad_buf;
+        slice->me.mv_hints = mv_hints;
         ff_me_init_pic(slice);
     }
 
@@ -272,6 +272,7 @@ typedef struct MPVMainEncContext {
     char *me_map_base;             ///< backs MotionEstContext.(map|score_map)
     char *dct_error_sum_base;      ///< backs dct_error_sum
     int16_t (*mv_table_base)[2];
+    int16_t (*mv_hint_table)[2];   ///< fullpel ME hints from input-frame side data
 } MPVMainEncContext;
 
 static inline const MPVMainEncContext *slice_to_mainenc(const MPVEncContext *s)
@@ -269,8 +269,15 @@ int ff_nvdec_decode_uninit(AVCodecContext *avctx)
     ctx->nb_slices               = 0;
     ctx->slice_offsets_allocated = 0;
 
+    if (ctx->nb_surface_requests)
+        av_log(avctx, AV_LOG_VERBOSE, "Surface pool served %"PRIu64" frame "
+               "requests with %u surfaces (%"PRIu64" recycled).\n",
+               ctx->nb_surface_requests, ctx->frame_pool->nb_allocated,
+               ctx->nb_surface_requests - ctx->frame_pool->nb_allocated);
+
     av_refstruct_unref(&ctx->decoder);
     av_refstruct_pool_uninit(&ctx->decoder_pool);
+    ctx->frame_pool = NULL;
 
     return 0;
 }
@@ -447,6 +454,7 @@ int ff_nvdec_decode_init(AVCodecContext *avctx)
         ret = AVERROR(ENOMEM);
         goto fail;
     }
+    ctx->frame_pool = pool;
 
     return 0;
 fail:
@@ -597,6 +605,7 @@ int ff_nvdec_start_frame(AVCodecContext *avctx, AVFrame *frame)
         ret = AVERROR(ENOMEM);
         goto fail;
     }
+    ctx->nb_surface_requests++;
     cf->ref_idx = cf->idx = *cf->idx_ref;
 
     fdd->hwaccel_priv      = cf;
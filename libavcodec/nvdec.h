@@ -58,6 +58,8 @@ typedef struct NVDECContext {
     CUVIDPICPARAMS pic_params;
 
     struct AVRefStructPool *decoder_pool;
+    struct NVDECFramePool *frame_pool; ///< owned by decoder_pool as its opaque
+    uint64_t      nb_surface_requests;
 
     struct NVDECDecoder  *decoder; ///< RefStruct reference
 
@@ -33,6 +33,7 @@
 #include "libavutil/internal.h"
 #include "libavutil/mem.h"
 #include "libavutil/opt.h"
+#include "libavutil/thread.h"
 #include <string.h>
 
 FF_DISABLE_DEPRECATION_WARNINGS
@@ -87,19 +88,40 @@ static const AVClass av_codec_context_class = {
     .get_category            = get_category,
 };
 
-static int init_context_defaults(AVCodecContext *s, const AVCodec *codec)
+/* Fully constructed contexts for each media type with distinct option
+ * defaults, initialized once and then copied into every new context.
+ * This turns the AVOption defaults walk, which dominates the cost of
+ * avcodec_alloc_context3(), into a memcpy(). None of the AVCodecContext
+ * option defaults allocate, so the copies own no pointers into the
+ * templates; this must be preserved if allocating defaults (non-NULL
+ * string/dict/channel layout) are ever added to the options table. */
+enum {
+    CONTEXT_TEMPLATE_OTHER,
+    CONTEXT_TEMPLATE_VIDEO,
+    CONTEXT_TEMPLATE_AUDIO,
+    CONTEXT_TEMPLATE_SUBTITLE,
+    NB_CONTEXT_TEMPLATES
+};
+
+static AVCodecContext context_templates[NB_CONTEXT_TEMPLATES];
+
+static int context_template_index(enum AVMediaType type)
+{
+    switch (type) {
+    case AVMEDIA_TYPE_VIDEO:    return CONTEXT_TEMPLATE_VIDEO;
+    case AVMEDIA_TYPE_AUDIO:    return CONTEXT_TEMPLATE_AUDIO;
+    case AVMEDIA_TYPE_SUBTITLE: return CONTEXT_TEMPLATE_SUBTITLE;
+    default:                    return CONTEXT_TEMPLATE_OTHER;
+    }
+}
+
+static void init_context_template(AVCodecContext *s, enum AVMediaType codec_type)
 {
-    const FFCodec *const codec2 = ffcodec(codec);
     int flags=0;
-    memset(s, 0, sizeof(AVCodecContext));
 
     s->av_class = &av_codec_context_class;
 
-    s->codec_type = codec ? codec->type : AVMEDIA_TYPE_UNKNOWN;
-    if (codec) {
-        s->codec = codec;
-        s->codec_id = codec->id;
-    }
+    s->codec_type = codec_type;
 
     if(s->codec_type == AVMEDIA_TYPE_AUDIO)
         flags= AV_OPT_FLAG_AUDIO_PARAM;
@@ -124,6 +146,31 @@ static int init_context_defaults(AVCodecContext *s, const AVCodec *codec)
     s->pix_fmt             = AV_PIX_FMT_NONE;
     s->sw_pix_fmt          = AV_PIX_FMT_NONE;
     s->sample_fmt          = AV_SAMPLE_FMT_NONE;
+}
+
+static void init_context_templates(void)
+{
+    init_context_template(&context_templates[CONTEXT_TEMPLATE_OTHER],    AVMEDIA_TYPE_UNKNOWN);
+    init_context_template(&context_templates[CONTEXT_TEMPLATE_VIDEO],    AVMEDIA_TYPE_VIDEO);
+    init_context_template(&context_templates[CONTEXT_TEMPLATE_AUDIO],    AVMEDIA_TYPE_AUDIO);
+    init_context_template(&context_templates[CONTEXT_TEMPLATE_SUBTITLE], AVMEDIA_TYPE_SUBTITLE);
+}
+
+static int init_context_defaults(AVCodecContext *s, const AVCodec *codec)
+{
+    static AVOnce init_static_once = AV_ONCE_INIT;
+    const FFCodec *const codec2 = ffcodec(codec);
+    enum AVMediaType codec_type = codec ? codec->type : AVMEDIA_TYPE_UNKNOWN;
+
+    ff_thread_once(&init_static_once, init_context_templates);
+
+    memcpy(s, &context_templates[context_template_index(codec_type)], sizeof(*s));
+
+    s->codec_type = codec_type;
+    if (codec) {
+        s->codec = codec;
+        s->codec_id = codec->id;
+    }
 
     if(codec && codec2->priv_data_size){
         s->priv_data = av_mallocz(codec2->priv_data_size);
@@ -111,20 +111,21 @@ static void step_collect_psy_metrics(OpusPsyContext *s, int index)
 
     for (ch = 0; ch < s->avctx->ch_layout.nb_channels; ch++) {
         for (i = 0; i < CELT_MAX_BANDS; i++) {
-            float avg_c_s, energy = 0.0f, dist_dev = 0.0f;
+            float energy = 0.0f, energy_sq = 0.0f, dist_dev;
             const int range = ff_celt_freq_range[i] << s->bsize_analysis;
             const float *coeffs = st->bands[ch][i];
-            for (j = 0; j < range; j++)
-                energy += coeffs[j]*coeffs[j];
-
-            st->energy[ch][i] += sqrtf(energy);
-            silence |= !!st->energy[ch][i];
-            avg_c_s = energy / range;
 
+            /* sum((avg - c²)²) expanded so one pass over the band yields
+             * both the energy and the deviation used as tonality */
             for (j = 0; j < range; j++) {
                 const float c_s = coeffs[j]*coeffs[j];
-                dist_dev += (avg_c_s - c_s)*(avg_c_s - c_s);
+                energy    += c_s;
+                energy_sq += c_s*c_s;
             }
+            dist_dev = FFMAX(energy_sq - energy*energy/range, 0.0f);
+
+            st->energy[ch][i] += sqrtf(energy);
+            silence |= !!st->energy[ch][i];
 
             st->tone[ch][i] += sqrtf(dist_dev);
         }
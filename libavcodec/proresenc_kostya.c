@@ -649,7 +649,9 @@ static int estimate_dcs(int *error, int16_t *blocks, int blocks_per_slice,
 
     for (i = 1; i < blocks_per_slice; i++, blocks += 64) {
         dc       = (blocks[0] - 0x4000) / scale;
-        *error  += FFABS(blocks[0] - 0x4000) % scale;
+        /* derive the quantisation error from the level to avoid a second
+         * division per coefficient */
+        *error  += FFABS(blocks[0] - 0x4000 - dc * scale);
         delta    = dc - prev_dc;
         new_sign = GET_SIGN(delta);
         delta    = (delta ^ sign) - sign;
@@ -677,9 +679,11 @@ static int estimate_acs(int *error, int16_t *blocks, int blocks_per_slice,
     run        = 0;
 
     for (i = 1; i < 64; i++) {
+        const int q = qmat[scan[i]];
+
         for (idx = scan[i]; idx < max_coeffs; idx += 64) {
-            level   = blocks[idx] / qmat[scan[i]];
-            *error += FFABS(blocks[idx]) % qmat[scan[i]];
+            level   = blocks[idx] / q;
+            *error += FFABS(blocks[idx] - level * q);
             if (level) {
                 abs_level = FFABS(level);
                 bits += estimate_vlc(ff_prores_run_to_cb[prev_run], run);
@@ -22,6 +22,16 @@
  * @see doc/multithreading.txt
  */
 
+#include "config.h"
+
+#if HAVE_PTHREAD_SETAFFINITY_NP && HAVE_SCHED_GETAFFINITY
+#ifndef _GNU_SOURCE
+# define _GNU_SOURCE
+#endif
+#include <sched.h>
+#endif
+
+#include <inttypes.h>
 #include <stdatomic.h>
 
 #include "avcodec.h"
@@ -146,6 +156,15 @@ typedef struct FrameThreadContext {
     int next_decoding;             ///< The next context to submit a packet to.
     int next_finished;             ///< The next context to return output from.
 
+    int active_threads;            ///< The number of worker contexts packets are rotated over.
+    int auto_threads;              ///< thread_count was picked by a heuristic, allow auto-tuning.
+
+    /* measured scaling used to auto-tune active_threads at flush points */
+    uint64_t nb_results;           ///< results requested since the last tune
+    uint64_t nb_stalls;            ///< requested results that were not finished yet
+    uint64_t nb_results_total;
+    uint64_t nb_stalls_total;
+
     /* hwaccel state for thread-unsafe hwaccels is temporarily stored here in
      * order to transfer its ownership to the next decoding thread without the
      * need for extra synchronization */
@@ -554,7 +573,7 @@ static int submit_packet(PerThreadContext *p, AVCodecContext *user_avctx,
     pthread_mutex_unlock(&p->mutex);
 
     fctx->prev_thread = p;
-    fctx->next_decoding = (fctx->next_decoding + 1) % p->avctx->thread_count;
+    fctx->next_decoding = (fctx->next_decoding + 1) % fctx->active_threads;
 
     return 0;
 }
@@ -594,9 +613,13 @@ int ff_thread_receive_frame(AVCodecContext *avctx, AVFrame *frame, unsigned flag
 
     wait_for_result:
         p                   = &fctx->threads[fctx->next_finished];
-        fctx->next_finished = (fctx->next_finished + 1) % avctx->thread_count;
+        fctx->next_finished = (fctx->next_finished + 1) % fctx->active_threads;
 
+        fctx->nb_results++;
+        fctx->nb_results_total++;
         if (atomic_load(&p->state) != STATE_INPUT_READY) {
+            fctx->nb_stalls++;
+            fctx->nb_stalls_total++;
             pthread_mutex_lock(&p->progress_mutex);
             while (atomic_load_explicit(&p->state, memory_order_relaxed) != STATE_INPUT_READY)
                 pthread_cond_wait(&p->output_cond, &p->progress_mutex);
@@ -755,6 +778,13 @@ av_cold void ff_frame_thread_free(AVCodecContext *avctx, int thread_count)
 
     park_frame_worker_threads(fctx, thread_count);
 
+    if (fctx->nb_results_total)
+        av_log(avctx, AV_LOG_VERBOSE,
+               "Frame threading: %d of %d threads in use at close, "
+               "%"PRIu64" of %"PRIu64" results waited on.\n",
+               fctx->active_threads, thread_count,
+               fctx->nb_stalls_total, fctx->nb_results_total);
+
     for (i = 0; i < thread_count; i++) {
         PerThreadContext *p = &fctx->threads[i];
         AVCodecContext *ctx = p->avctx;
@@ -814,6 +844,38 @@ av_cold void ff_frame_thread_free(AVCodecContext *avctx, int thread_count)
     av_freep(&avctx->internal->thread_ctx);
 }
 
+#if HAVE_PTHREAD_SETAFFINITY_NP && HAVE_SCHED_GETAFFINITY && defined(CPU_COUNT)
+/* Pin a worker to one of the CPUs the process may run on, chosen round-robin
+ * by worker index. Keeping a worker on a single CPU for its lifetime also
+ * keeps it on a single NUMA node, so the frame buffers it allocates remain
+ * node-local under the kernel's first-touch placement policy. */
+static av_cold void pin_worker_thread(AVCodecContext *avctx, pthread_t thread,
+                                      int idx)
+{
+    cpu_set_t procset, set;
+    int nb_cpus, cpu, pos = 0;
+
+    if (sched_getaffinity(0, sizeof(procset), &procset))
+        return;
+    nb_cpus = CPU_COUNT(&procset);
+    if (nb_cpus <= 1)
+        return;
+
+    idx %= nb_cpus;
+    for (cpu = 0; cpu < CPU_SETSIZE; cpu++)
+        if (CPU_ISSET(cpu, &procset) && pos++ == idx)
+            break;
+    if (cpu >= CPU_SETSIZE)
+        return;
+
+    CPU_ZERO(&set);
+    CPU_SET(cpu, &set);
+    if (!pthread_setaffinity_np(thread, sizeof(set), &set))
+        av_log(avctx, AV_LOG_DEBUG, "Frame worker %d pinned to CPU %d\n",
+               idx, cpu);
+}
+#endif
+
 static av_cold int init_thread(PerThreadContext *p, int *threads_to_free,
                                FrameThreadContext *fctx, AVCodecContext *avctx,
                                const FFCodec *codec, int first)
@@ -907,6 +969,11 @@ static av_cold int init_thread(PerThreadContext *p, int *threads_to_free,
         return err;
     p->thread_init = INITIALIZED;
 
+#if HAVE_PTHREAD_SETAFFINITY_NP && HAVE_SCHED_GETAFFINITY && defined(CPU_COUNT)
+    if (avctx->thread_affinity)
+        pin_worker_thread(avctx, p->thread, (int)(p - fctx->threads));
+#endif
+
     return 0;
 }
 
@@ -917,6 +984,8 @@ av_cold int ff_frame_thread_init(AVCodecContext *avctx)
     FrameThreadContext *fctx;
     int err, i = 0;
 
+    int auto_threads = !thread_count;
+
     if (!thread_count) {
         int nb_cpus = av_cpu_count();
         // use number of cores + 1 as thread count if there is more than one
@@ -947,6 +1016,8 @@ av_cold int ff_frame_thread_init(AVCodecContext *avctx)
         return AVERROR(ENOMEM);
 
     fctx->async_lock = 1;
+    fctx->active_threads = thread_count;
+    fctx->auto_threads   = auto_threads;
 
     if (codec->p.type == AVMEDIA_TYPE_VIDEO)
         avctx->delay = avctx->thread_count - 1;
@@ -973,6 +1044,39 @@ error:
     return err;
 }
 
+/**
+ * Adjust the number of worker contexts packets are rotated over based on
+ * the scaling measured since the last adjustment. Must only be called with
+ * all workers parked and the submission ring empty, i.e. at flush points.
+ */
+static av_cold void tune_thread_count(AVCodecContext *avctx, FrameThreadContext *fctx)
+{
+    int active = fctx->active_threads;
+
+    /* too few results since the last adjustment to judge the scaling */
+    if (!fctx->auto_threads || fctx->nb_results < 4U * avctx->thread_count)
+        return;
+
+    /* When the oldest worker is almost always finished by the time its
+     * output is requested, decoding is not limited by the workers and the
+     * surplus ones only add latency and footprint; retire a quarter of
+     * them. When requests mostly have to wait, scale back up towards the
+     * configured count. */
+    if (fctx->nb_stalls * 20 < fctx->nb_results)
+        active = FFMAX(2, active - (active + 3) / 4);
+    else if (fctx->nb_stalls * 2 > fctx->nb_results)
+        active = FFMIN(avctx->thread_count, active + (active + 1) / 2);
+
+    if (active != fctx->active_threads) {
+        av_log(avctx, AV_LOG_VERBOSE,
+               "Frame threading: using %d of %d threads after %"PRIu64" results "
+               "(%"PRIu64" waited on)\n",
+               active, avctx->thread_count, fctx->nb_results, fctx->nb_stalls);
+        fctx->active_threads = active;
+    }
+    fctx->nb_results = fctx->nb_stalls = 0;
+}
+
 av_cold void ff_thread_flush(AVCodecContext *avctx)
 {
     int i;
@@ -989,6 +1093,8 @@ av_cold void ff_thread_flush(AVCodecContext *avctx)
     fctx->next_decoding = fctx->next_finished = 0;
     fctx->prev_thread = NULL;
 
+    tune_thread_count(avctx, fctx);
+
     decoded_frames_flush(&fctx->df);
     fctx->result = 0;
 
@@ -33,6 +33,7 @@
 #include "libavutil/macros.h"
 #include "libavutil/mem.h"
 #include "libavutil/slicethread.h"
+#include "libavutil/thread.h"
 
 typedef int (action_func)(AVCodecContext *c, void *arg);
 typedef int (action_func2)(AVCodecContext *c, void *arg, int jobnr, int threadnr);
@@ -40,6 +41,7 @@ typedef int (main_func)(AVCodecContext *c);
 
 typedef struct SliceThreadContext {
     AVSliceThread *thread;
+    struct SharedPool *pool;
     action_func *func;
     action_func2 *func2;
     main_func *mainfunc;
@@ -48,6 +50,23 @@ typedef struct SliceThreadContext {
     int job_size;
 } SliceThreadContext;
 
+/**
+ * Process-wide worker pool shared by all contexts opened with
+ * AV_CODEC_FLAG2_SHARED_SLICE_POOL. Created on first use and torn down
+ * when its last user closes; slice batches of different contexts are
+ * serialized through exec_lock.
+ */
+typedef struct SharedPool {
+    AVSliceThread *thread;
+    int thread_count;
+    int refcount;
+    AVMutex exec_lock;
+    AVCodecContext *cur; ///< context whose batch is running, protected by exec_lock
+} SharedPool;
+
+static SharedPool shared_pool;
+static AVMutex shared_pool_lock = AV_MUTEX_INITIALIZER;
+
 static void main_function(void *priv) {
     AVCodecContext *avctx = priv;
     SliceThreadContext *c = avctx->internal->thread_ctx;
@@ -66,11 +85,64 @@ static void worker_func(void *priv, int jobnr, int threadnr, int nb_jobs, int nb
         c->rets[jobnr] = ret;
 }
 
+static void shared_worker_func(void *priv, int jobnr, int threadnr, int nb_jobs, int nb_threads)
+{
+    SharedPool *p = priv;
+    worker_func(p->cur, jobnr, threadnr, nb_jobs, nb_threads);
+}
+
+static void shared_main_function(void *priv)
+{
+    SharedPool *p = priv;
+    main_function(p->cur);
+}
+
+static av_cold int shared_pool_get(SliceThreadContext *c)
+{
+    int ret = 0;
+
+    ff_mutex_lock(&shared_pool_lock);
+    if (!shared_pool.refcount) {
+        int count = FFMIN(av_cpu_count() + 1, MAX_AUTO_THREADS);
+
+        ff_mutex_init(&shared_pool.exec_lock, NULL);
+        count = avpriv_slicethread_create(&shared_pool.thread, &shared_pool,
+                                          shared_worker_func,
+                                          shared_main_function, count);
+        if (count <= 1) {
+            avpriv_slicethread_free(&shared_pool.thread);
+            ff_mutex_destroy(&shared_pool.exec_lock);
+            ret = count < 0 ? count : AVERROR(ENOSYS);
+            goto end;
+        }
+        shared_pool.thread_count = count;
+    }
+    shared_pool.refcount++;
+    c->pool = &shared_pool;
+end:
+    ff_mutex_unlock(&shared_pool_lock);
+    return ret;
+}
+
+static av_cold void shared_pool_put(SliceThreadContext *c)
+{
+    ff_mutex_lock(&shared_pool_lock);
+    if (!--shared_pool.refcount) {
+        avpriv_slicethread_free(&shared_pool.thread);
+        ff_mutex_destroy(&shared_pool.exec_lock);
+    }
+    c->pool = NULL;
+    ff_mutex_unlock(&shared_pool_lock);
+}
+
 av_cold void ff_slice_thread_free(AVCodecContext *avctx)
 {
     SliceThreadContext *c = avctx->internal->thread_ctx;
 
-    avpriv_slicethread_free(&c->thread);
+    if (c->pool)
+        shared_pool_put(c);
+    else
+        avpriv_slicethread_free(&c->thread);
 
     av_freep(&avctx->internal->thread_ctx);
 }
@@ -90,7 +162,14 @@ static int thread_execute(AVCodecContext *avctx, action_func* func, void *arg, i
     c->func = func;
     c->rets = ret;
 
-    avpriv_slicethread_execute(c->thread, job_count, !!c->mainfunc  );
+    if (c->pool) {
+        ff_mutex_lock(&c->pool->exec_lock);
+        c->pool->cur = avctx;
+        avpriv_slicethread_execute(c->pool->thread, job_count, !!c->mainfunc);
+        c->pool->cur = NULL;
+        ff_mutex_unlock(&c->pool->exec_lock);
+    } else
+        avpriv_slicethread_execute(c->thread, job_count, !!c->mainfunc  );
     return 0;
 }
 
@@ -134,6 +213,17 @@ av_cold int ff_slice_thread_init(AVCodecContext *avctx)
     avctx->internal->thread_ctx = c = av_mallocz(sizeof(*c));
     if (!c)
         return AVERROR(ENOMEM);
+
+    if (avctx->flags2 & AV_CODEC_FLAG2_SHARED_SLICE_POOL) {
+        if (shared_pool_get(c) >= 0) {
+            avctx->thread_count = c->pool->thread_count;
+            avctx->execute  = thread_execute;
+            avctx->execute2 = thread_execute2;
+            return 0;
+        }
+        /* could not bring up the shared pool, use a private one */
+    }
+
     mainfunc = ffcodec(avctx->codec)->caps_internal & FF_CODEC_CAP_SLICE_THREAD_HAS_MF ? &main_function : NULL;
     thread_count = avpriv_slicethread_create(&c->thread, avctx, worker_func,
                                              mainfunc, thread_count);
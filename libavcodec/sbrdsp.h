@@ -48,6 +48,7 @@ extern const INTFLOAT AAC_RENAME(ff_sbr_noise_table)[][2];
 void AAC_RENAME(ff_sbrdsp_init)(SBRDSPContext *s);
 void ff_sbrdsp_init_arm(SBRDSPContext *s);
 void ff_sbrdsp_init_aarch64(SBRDSPContext *s);
+void ff_sbrdsp_init_fixed_aarch64(SBRDSPContext *s);
 void ff_sbrdsp_init_riscv(SBRDSPContext *s);
 void ff_sbrdsp_init_x86(SBRDSPContext *s);
 
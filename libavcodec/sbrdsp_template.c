@@ -105,6 +105,10 @@ av_cold void AAC_RENAME(ff_sbrdsp_init)(SBRDSPContext *s)
 #elif ARCH_X86
     ff_sbrdsp_init_x86(s);
 #endif
+#else
+#if ARCH_AARCH64
+    ff_sbrdsp_init_fixed_aarch64(s);
+#endif
 #endif /* !USE_FIXED */
 }
 
@@ -66,10 +66,12 @@ void write_uint16_t_array   (const uint16_t *, int);
 void write_uint32_t_array   (const uint32_t *, int);
 void write_int32_t_array    (const int32_t  *, int);
 void write_float_array      (const float    *, int);
+void write_double_array     (const double   *, int);
 void write_int8_t_2d_array  (const void *, int, int);
 void write_uint8_t_2d_array (const void *, int, int);
 void write_uint32_t_2d_array(const void *, int, int);
 void write_float_2d_array   (const void *, int, int);
+void write_double_2d_array  (const void *, int, int);
 /** @} */ // end of printfuncs group
 
 /*
@@ -119,11 +121,13 @@ WRITE_1D_FUNC(int16_t,  "%5"PRIi16, 7)
 WRITE_1D_FUNC(uint32_t, "0x%08"PRIx32, 7)
 WRITE_1D_FUNC(int32_t,  "0x%08"PRIx32, 7)
 WRITE_1D_FUNC(float,    "%.18e", 3)
+WRITE_1D_FUNC(double,   "%.18e", 3)
 
 WRITE_2D_FUNC(int8_t)
 WRITE_2D_FUNC(uint8_t)
 WRITE_2D_FUNC(uint32_t)
 WRITE_2D_FUNC(float)
+WRITE_2D_FUNC(double)
 
 static inline void write_fileheader(void)
 {
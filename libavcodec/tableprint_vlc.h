@@ -44,6 +44,9 @@
 WRITE_1D_FUNC_ARGV(VLCElem, 3, "{ .sym =%5" PRId16 ", .len =%2"PRIi16 " }",
                    data[i].sym, data[i].len)
 
+WRITE_1D_FUNC_ARGV(RL_VLC_ELEM, 2, "{ .level =%5" PRId16 ", .len8 =%3" PRId8 ", .run =%3" PRIu8 " }",
+                   data[i].level, data[i].len8, data[i].run)
+
 static void write_vlc_type(const VLC *vlc, const VLCElem *base_table, const char *base_table_name)
 {
     printf("    .bits = %i,\n", vlc->bits);
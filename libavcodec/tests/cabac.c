@@ -186,5 +186,35 @@ int main(void){
         ret = 1;
     }
 
+    // decode the same stream again, reading the bypass bins in
+    // multi-bin batches of varying size
+    ff_init_cabac_decoder(&c.dec, b, SIZE);
+
+    memset(state, 0, sizeof(state));
+
+    for (i = 0; i < SIZE;) {
+        int n = 1 + (av_lfg_get(&prng) % 23);
+        unsigned expect = 0;
+        n = FFMIN(n, SIZE - i);
+        for (int j = 0; j < n; j++)
+            expect = (expect << 1) | (r[i + j] & 1);
+        if (get_cabac_bypass_bits(&c.dec, n) != expect) {
+            av_log(NULL, AV_LOG_ERROR, "CABAC multi-bin bypass failure at %d\n", i);
+            ret = 1;
+        }
+        i += n;
+    }
+
+    for(i=0; i<SIZE; i++){
+        if ((r[i] & 1) != get_cabac_noinline(&c.dec, state)) {
+            av_log(NULL, AV_LOG_ERROR, "CABAC failure at %d\n", i);
+            ret = 1;
+        }
+    }
+    if (!get_cabac_terminate(&c.dec)) {
+        av_log(NULL, AV_LOG_ERROR, "where's the Terminator?\n");
+        ret = 1;
+    }
+
     return ret;
 }
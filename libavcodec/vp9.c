@@ -1499,6 +1499,11 @@ int loopfilter_proc(AVCodecContext *avctx)
     int bytesperpixel = s->bytesperpixel, col, i;
     AVFrame *f;
 
+    // no point in synchronizing against the tile workers row by row
+    // when nothing gets filtered
+    if (!s->s.h.filter.level)
+        return 0;
+
     f = s->s.frames[CUR_FRAME].tf.f;
     ls_y = f->linesize[0];
     ls_uv =f->linesize[1];
@@ -1506,16 +1511,14 @@ int loopfilter_proc(AVCodecContext *avctx)
     for (i = 0; i < s->sb_rows; i++) {
         vp9_await_tile_progress(s, i, s->s.h.tiling.tile_cols);
 
-        if (s->s.h.filter.level) {
-            yoff = (ls_y * 64)*i;
-            uvoff =  (ls_uv * 64 >> s->ss_v)*i;
-            lflvl_ptr = s->lflvl+s->sb_cols*i;
-            for (col = 0; col < s->cols;
-                 col += 8, yoff += 64 * bytesperpixel,
-                 uvoff += 64 * bytesperpixel >> s->ss_h, lflvl_ptr++) {
-                ff_vp9_loopfilter_sb(avctx, lflvl_ptr, i << 3, col,
-                                     yoff, uvoff);
-            }
+        yoff = (ls_y * 64)*i;
+        uvoff =  (ls_uv * 64 >> s->ss_v)*i;
+        lflvl_ptr = s->lflvl+s->sb_cols*i;
+        for (col = 0; col < s->cols;
+             col += 8, yoff += 64 * bytesperpixel,
+             uvoff += 64 * bytesperpixel >> s->ss_h, lflvl_ptr++) {
+            ff_vp9_loopfilter_sb(avctx, lflvl_ptr, i << 3, col,
+                                 yoff, uvoff);
         }
     }
     return 0;
@@ -81,6 +81,29 @@ CLEAR_BLOCKS 1
 INIT_YMM avx
 CLEAR_BLOCKS 1
 
+%if HAVE_AVX512_EXTERNAL
+; blocks are only guaranteed to be 32-byte aligned, so use unaligned stores
+INIT_ZMM avx512
+cglobal clear_block, 1, 1, 1, blocks
+    ZERO       m0, m0, m0
+    movu  [blocksq+mmsize*0], m0
+    movu  [blocksq+mmsize*1], m0
+    RET
+
+cglobal clear_blocks, 1, 2, 1, blocks, len
+    add   blocksq, 768
+    mov      lenq, -768
+    ZERO       m0, m0, m0
+.loop:
+    movu  [blocksq+lenq+mmsize*0], m0
+    movu  [blocksq+lenq+mmsize*1], m0
+    movu  [blocksq+lenq+mmsize*2], m0
+    movu  [blocksq+lenq+mmsize*3], m0
+    add   lenq, mmsize*4
+    js .loop
+    RET
+%endif
+
 ;-----------------------------------------
 ; void ff_fill_block_tab_%1(uint8_t *block, uint8_t value,
 ;                           ptrdiff_t line_size, int h);
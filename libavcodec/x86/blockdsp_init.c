@@ -26,8 +26,10 @@
 
 void ff_clear_block_sse(int16_t *block);
 void ff_clear_block_avx(int16_t *block);
+void ff_clear_block_avx512(int16_t *block);
 void ff_clear_blocks_sse(int16_t *blocks);
 void ff_clear_blocks_avx(int16_t *blocks);
+void ff_clear_blocks_avx512(int16_t *blocks);
 
 void ff_fill_block_tab_16_sse2(uint8_t *block, uint8_t value, ptrdiff_t line_size, int h);
 void ff_fill_block_tab_8_sse2(uint8_t *block, uint8_t value, ptrdiff_t line_size, int h);
@@ -55,5 +57,9 @@ av_cold void ff_blockdsp_init_x86(BlockDSPContext *c)
         c->fill_block_tab[0] = ff_fill_block_tab_16_avx2;
         c->fill_block_tab[1] = ff_fill_block_tab_8_avx2;
     }
+    if (EXTERNAL_AVX512(cpu_flags)) {
+        c->clear_block  = ff_clear_block_avx512;
+        c->clear_blocks = ff_clear_blocks_avx512;
+    }
 #endif /* HAVE_X86ASM */
 }
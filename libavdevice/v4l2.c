@@ -99,6 +99,7 @@ struct video_data {
     atomic_int buffers_queued;
     void **buf_start;
     unsigned int *buf_len;
+    struct buff_data *buf_desc; ///< one preallocated descriptor per mapped buffer
     char *standard;
     v4l2_std_id std_id;
     int channel;
@@ -388,6 +389,17 @@ static int mmap_init(AVFormatContext *ctx)
         av_freep(&s->buf_start);
         return AVERROR(ENOMEM);
     }
+    s->buf_desc = av_malloc_array(s->buffers, sizeof(*s->buf_desc));
+    if (!s->buf_desc) {
+        av_log(ctx, AV_LOG_ERROR, "Cannot allocate buffer descriptors\n");
+        av_freep(&s->buf_start);
+        av_freep(&s->buf_len);
+        return AVERROR(ENOMEM);
+    }
+    for (i = 0; i < s->buffers; i++) {
+        s->buf_desc[i].s     = s;
+        s->buf_desc[i].index = i;
+    }
 
     for (i = 0; i < req.count; i++) {
         unsigned int buf_length, buf_offset;
@@ -464,7 +476,6 @@ static void mmap_release_buffer(void *opaque, uint8_t *data)
     buf.index = buf_descriptor->index;
     buf.m.planes = s->multiplanar ? planes : NULL;
     buf.length   = s->multiplanar ? VIDEO_MAX_PLANES : 0;
-    av_free(buf_descriptor);
 
     enqueue_buffer(s, &buf);
 }
@@ -609,30 +620,14 @@ static int mmap_read_frame(AVFormatContext *ctx, AVPacket *pkt)
             return res;
         }
     } else {
-        struct buff_data *buf_descriptor;
-
         pkt->data     = s->buf_start[buf.index];
         pkt->size     = bytesused;
 
-        buf_descriptor = av_malloc(sizeof(struct buff_data));
-        if (!buf_descriptor) {
-            /* Something went wrong... Since av_malloc() failed, we cannot even
-             * allocate a buffer for memcpying into it
-             */
-            av_log(ctx, AV_LOG_ERROR, "Failed to allocate a buffer descriptor\n");
-            enqueue_buffer(s, &buf);
-
-            return AVERROR(ENOMEM);
-        }
-        buf_descriptor->index = buf.index;
-        buf_descriptor->s     = s;
-
         pkt->buf = av_buffer_create(pkt->data, pkt->size, mmap_release_buffer,
-                                    buf_descriptor, 0);
+                                    &s->buf_desc[buf.index], 0);
         if (!pkt->buf) {
             av_log(ctx, AV_LOG_ERROR, "Failed to create a buffer\n");
             enqueue_buffer(s, &buf);
-            av_freep(&buf_descriptor);
             return AVERROR(ENOMEM);
         }
     }
@@ -693,6 +688,7 @@ static void mmap_close(struct video_data *s)
     }
     av_freep(&s->buf_start);
     av_freep(&s->buf_len);
+    av_freep(&s->buf_desc);
 }
 
 static int v4l2_set_parameters(AVFormatContext *ctx)
@@ -104,6 +104,8 @@ typedef struct AudioFIRContext {
     int one2many;
     int prev_is_disabled;
     int *loading;
+    int conv_selir;
+    int conv_nb_taps;
 
     AudioIR *irs;
 
@@ -50,6 +50,11 @@
 #define DURATION_SHORTEST 1
 #define DURATION_FIRST    2
 
+/* samples accumulated per cache block; 1024 floats are 4 KiB per plane,
+ * small enough for block and input to stay resident in L1 while every
+ * input is summed */
+#define MIX_BLOCK_SAMPLES 1024
+
 typedef struct InputContext {
     AVFrame *frame;
     uint8_t input_state;       /**< current state of each input */
@@ -233,7 +238,7 @@ static int output_frame(AVFilterLink *outlink)
     AVFilterContext *ctx = outlink->src;
     MixContext      *s = ctx->priv;
     AVFrame *out;
-    int nb_samples, got_pts = 0;
+    int nb_samples, align, planes, out_plane_size, sample_size, is_float;
 
     switch (s->duration_mode) {
     case DURATION_FIRST:
@@ -267,46 +272,81 @@ static int output_frame(AVFilterLink *outlink)
         return AVERROR(ENOMEM);
     }
 
-    av_samples_set_silence(out->extended_data, 0, out->nb_samples,
-                           out->ch_layout.nb_channels,
-                           out->format);
+    sample_size    = av_get_bytes_per_sample(out->format);
+    align          = av_cpu_max_align();
+    planes         = s->planar ? s->nb_channels : 1;
+    out_plane_size = out->nb_samples * (s->planar ? 1 : s->nb_channels);
+    is_float       = out->format == AV_SAMPLE_FMT_FLT ||
+                     out->format == AV_SAMPLE_FMT_FLTP;
 
     out->nb_samples = nb_samples;
-    for (int i = 0; i < s->nb_inputs; i++) {
-        InputContext *ic = &s->inputs[i];
 
-        if (ic->frame) {
-            int align, planes, plane_size, sample_size;
-
-            sample_size= av_get_bytes_per_sample(out->format);
-            align      = av_cpu_max_align();
-            nb_samples = s->inputs[i].frame->nb_samples;
-            planes     = s->planar ? s->nb_channels : 1;
-            plane_size = nb_samples * (s->planar ? 1 : s->nb_channels);
-            plane_size = FFALIGN(plane_size, align / sample_size);
-            plane_size = plane_size & (~15);
-            if (plane_size <= 0)
-                continue;
-
-            if (out->format == AV_SAMPLE_FMT_FLT ||
-                out->format == AV_SAMPLE_FMT_FLTP) {
-                for (int p = 0; p < planes; p++) {
-                    s->fdsp->vector_fmac_scalar((float *)out->extended_data[p],
-                                                (float *) ic->frame->extended_data[p],
-                                                ic->input_scale, plane_size);
+    /* Accumulate in blocks small enough to stay in the data cache while
+     * every input is summed into them, instead of streaming the whole
+     * output through memory once per input. The first input contributing
+     * to a block initializes it with a scaled copy, so no separate silence
+     * pass over the output is needed; only regions no input covers are
+     * zeroed. */
+    for (int p = 0; p < planes; p++) {
+        for (int off = 0; off < out_plane_size; off += MIX_BLOCK_SAMPLES) {
+            int block_end = FFMIN(off + MIX_BLOCK_SAMPLES, out_plane_size);
+            int init = 0;
+
+            for (int i = 0; i < s->nb_inputs; i++) {
+                InputContext *ic = &s->inputs[i];
+                int plane_size, len;
+
+                if (!ic->frame)
+                    continue;
+
+                plane_size = ic->frame->nb_samples * (s->planar ? 1 : s->nb_channels);
+                plane_size = FFALIGN(plane_size, align / sample_size);
+                plane_size = plane_size & (~15);
+
+                /* all lengths are multiples of 16 here, satisfying the
+                 * fdsp length constraints */
+                len = FFMIN(plane_size, block_end) - off;
+                if (len <= 0)
+                    continue;
+
+                if (is_float) {
+                    float       *dst = (float *)out->extended_data[p] + off;
+                    const float *src = (const float *)ic->frame->extended_data[p] + off;
+
+                    if (!init)
+                        s->fdsp->vector_fmul_scalar(dst, src, ic->input_scale, len);
+                    else
+                        s->fdsp->vector_fmac_scalar(dst, src, ic->input_scale, len);
+                } else {
+                    double       *dst = (double *)out->extended_data[p] + off;
+                    const double *src = (const double *)ic->frame->extended_data[p] + off;
+
+                    if (!init)
+                        s->fdsp->vector_dmul_scalar(dst, src, ic->input_scale, len);
+                    else
+                        s->fdsp->vector_dmac_scalar(dst, src, ic->input_scale, len);
                 }
-            } else {
-                for (int p = 0; p < planes; p++) {
-                    s->fdsp->vector_dmac_scalar((double *)out->extended_data[p],
-                                                (double *) ic->frame->extended_data[p],
-                                                ic->input_scale, plane_size);
+
+                if (!init) {
+                    if (len < block_end - off)
+                        memset(out->extended_data[p] + (off + len) * sample_size, 0,
+                               (block_end - off - len) * sample_size);
+                    init = 1;
                 }
             }
 
-            if (!got_pts) {
-                got_pts = 1;
-                av_frame_copy_props(out, ic->frame);
-            }
+            if (!init)
+                memset(out->extended_data[p] + off * sample_size, 0,
+                       (block_end - off) * sample_size);
+        }
+    }
+
+    for (int i = 0; i < s->nb_inputs; i++) {
+        InputContext *ic = &s->inputs[i];
+
+        if (ic->frame) {
+            av_frame_copy_props(out, ic->frame);
+            break;
         }
     }
 
@@ -68,6 +68,12 @@ typedef struct AudioFragment {
     // fast waveform alignment via correlation in frequency domain:
     float *xdat_in;
     float *xdat;
+
+    // position and length of the down-mixed mono data in xdat_in,
+    // used to reuse the overlapping samples when the fragment is
+    // reloaded at an adjusted position:
+    int64_t xdat_position;
+    int xdat_nsamples;
 } AudioFragment;
 
 /**
@@ -202,10 +208,12 @@ static void yae_clear(ATempoContext *atempo)
     atempo->frag[0].position[0] = 0;
     atempo->frag[0].position[1] = 0;
     atempo->frag[0].nsamples    = 0;
+    atempo->frag[0].xdat_nsamples = 0;
 
     atempo->frag[1].position[0] = 0;
     atempo->frag[1].position[1] = 0;
     atempo->frag[1].nsamples    = 0;
+    atempo->frag[1].xdat_nsamples = 0;
 
     // shift left position of 1st fragment by half a window
     // so that no re-normalization would be required for
@@ -353,9 +361,9 @@ static int yae_update(AVFilterContext *ctx)
 #define yae_init_xdat(scalar_type, scalar_max)                          \
     do {                                                                \
         const uint8_t *src_end = src +                                  \
-            frag->nsamples * atempo->channels * sizeof(scalar_type);    \
+            (i1 - i0) * atempo->channels * sizeof(scalar_type);         \
                                                                         \
-        float *xdat = frag->xdat_in;                                    \
+        float *xdat = frag->xdat_in + i0;                               \
         scalar_type tmp;                                                \
                                                                         \
         if (atempo->channels == 1) {                                    \
@@ -397,16 +405,14 @@ static int yae_update(AVFilterContext *ctx)
     } while (0)
 
 /**
- * Initialize complex data buffer of a given audio fragment
- * with down-mixed mono data of appropriate scalar type.
+ * Down-mix the [i0, i1) sample range of a given audio fragment
+ * into its mono data buffer.
  */
-static void yae_downmix(ATempoContext *atempo, AudioFragment *frag)
+static void yae_downmix_samples(ATempoContext *atempo, AudioFragment *frag,
+                                const int i0, const int i1)
 {
     // shortcuts:
-    const uint8_t *src = frag->data;
-
-    // init complex data buffer used for FFT and Correlation:
-    memset(frag->xdat_in, 0, sizeof(AVComplexFloat) * (atempo->window + 1));
+    const uint8_t *src = frag->data + i0 * atempo->stride;
 
     if (atempo->format == AV_SAMPLE_FMT_U8) {
         yae_init_xdat(uint8_t, 127);
@@ -421,6 +427,49 @@ static void yae_downmix(ATempoContext *atempo, AudioFragment *frag)
     }
 }
 
+/**
+ * Initialize complex data buffer of a given audio fragment
+ * with down-mixed mono data of appropriate scalar type.
+ */
+static void yae_downmix(ATempoContext *atempo, AudioFragment *frag)
+{
+    // init complex data buffer used for FFT and Correlation:
+    memset(frag->xdat_in, 0, sizeof(AVComplexFloat) * (atempo->window + 1));
+
+    yae_downmix_samples(atempo, frag, 0, frag->nsamples);
+
+    frag->xdat_position = frag->position[0];
+    frag->xdat_nsamples = frag->nsamples;
+}
+
+/**
+ * Refresh the down-mixed mono data of a fragment that was reloaded at
+ * an adjusted position, shifting the samples it shares with the
+ * previous down-mix instead of re-reducing all channels.
+ */
+static void yae_downmix_shifted(ATempoContext *atempo, AudioFragment *frag)
+{
+    float *xdat = frag->xdat_in;
+    const int window = atempo->window;
+    const int64_t shift = frag->position[0] - frag->xdat_position;
+
+    if (frag->xdat_nsamples != window || frag->nsamples != window ||
+        !shift || FFABS(shift) >= window) {
+        yae_downmix(atempo, frag);
+        return;
+    }
+
+    if (shift > 0) {
+        memmove(xdat, xdat + shift, (window - shift) * sizeof(*xdat));
+        yae_downmix_samples(atempo, frag, window - shift, window);
+    } else {
+        memmove(xdat - shift, xdat, (window + shift) * sizeof(*xdat));
+        yae_downmix_samples(atempo, frag, 0, -shift);
+    }
+
+    frag->xdat_position = frag->position[0];
+}
+
 /**
  * Populate the internal data buffer on as-needed basis.
  *
@@ -866,8 +915,8 @@ yae_apply(ATempoContext *atempo,
                 break;
             }
 
-            // down-mix to mono:
-            yae_downmix(atempo, yae_curr_frag(atempo));
+            // down-mix to mono, reusing the overlap with the previous mix:
+            yae_downmix_shifted(atempo, yae_curr_frag(atempo));
 
             // apply rDFT:
             atempo->r2c_fn(atempo->real_to_complex, yae_curr_frag(atempo)->xdat, yae_curr_frag(atempo)->xdat_in, sizeof(float));
@@ -118,6 +118,60 @@ static av_always_inline void update(AVFilterContext *ctx, AVFrame *insamples,
     }
 }
 
+/* Process a whole run of samples sharing the same silence state in one go:
+ * a silent run either just advances the null counter or crosses the notify
+ * threshold at a known sample, a loud run collapses into a single update()
+ * at its first sample since every following one is a no-op. */
+static void process_run(AVFilterContext *ctx, AVFrame *insamples,
+                        int is_silence, int64_t base_index, int64_t len,
+                        int idx_step, int64_t nb_samples_notify,
+                        AVRational time_base)
+{
+    SilenceDetectContext *s = ctx->priv;
+    int channel = base_index % s->independent_channels;
+
+    if (is_silence) {
+        if (s->start[channel] == INT64_MIN) {
+            const int64_t need = FFMAX(nb_samples_notify - s->nb_null_samples[channel], 1);
+
+            if (len >= need) {
+                s->nb_null_samples[channel] = FFMAX(nb_samples_notify, 1) - 1;
+                update(ctx, insamples, 1, base_index + (need - 1) * idx_step,
+                       nb_samples_notify, time_base);
+            } else {
+                s->nb_null_samples[channel] += len;
+            }
+        }
+    } else {
+        update(ctx, insamples, 0, base_index, nb_samples_notify, time_base);
+    }
+}
+
+/* Return the number of leading samples whose silence state matches state.
+ * The contiguous path is scanned in fixed-size chunks so the comparisons
+ * vectorize; memory bandwidth is the limit on long runs. */
+#define SILENCE_RUN(name, type)                                                  \
+static int silence_run_##name(const type *p, int n, ptrdiff_t stride,            \
+                              type noise, int state)                             \
+{                                                                                \
+    int i = 0;                                                                   \
+                                                                                 \
+    if (stride == 1) {                                                           \
+        for (; i + 16 <= n; i += 16) {                                           \
+            int m = 0;                                                           \
+                                                                                 \
+            for (int j = 0; j < 16; j++)                                         \
+                m += p[i + j] < noise && p[i + j] > -noise;                      \
+            if (m != (state ? 16 : 0))                                           \
+                break;                                                           \
+        }                                                                        \
+    }                                                                            \
+    for (; i < n; i++)                                                           \
+        if ((p[i * stride] < noise && p[i * stride] > -noise) != state)          \
+            break;                                                               \
+    return i;                                                                    \
+}
+
 #define SILENCE_DETECT(name, type)                                               \
 static void silencedetect_##name(AVFilterContext *ctx, AVFrame *insamples,       \
                                  int nb_samples, int64_t nb_samples_notify,      \
@@ -126,11 +180,24 @@ static void silencedetect_##name(AVFilterContext *ctx, AVFrame *insamples,
     SilenceDetectContext *s         = ctx->priv;                                 \
     const type *p = (const type *)insamples->data[0];                            \
     const type noise = s->noise;                                                 \
-    int i;                                                                       \
+    const int ic = s->independent_channels;                                      \
+    const int stream_samples = nb_samples / ic;                                  \
+                                                                                 \
+    for (int ch = 0; ch < ic; ch++) {                                            \
+        const type *q = p + ch;                                                  \
                                                                                  \
-    for (i = 0; i < nb_samples; i++, p++)                                        \
-        update(ctx, insamples, *p < noise && *p > -noise, i,                     \
-               nb_samples_notify, time_base);                                    \
+        for (int i = 0; i < stream_samples;) {                                   \
+            const type v = q[(ptrdiff_t)i * ic];                                 \
+            const int state = v < noise && v > -noise;                           \
+            const int run = silence_run_##name(q + (ptrdiff_t)i * ic,            \
+                                               stream_samples - i, ic,           \
+                                               noise, state);                    \
+                                                                                 \
+            process_run(ctx, insamples, state, ch + (int64_t)i * ic, run, ic,    \
+                        nb_samples_notify, time_base);                           \
+            i += run;                                                            \
+        }                                                                        \
+    }                                                                            \
 }
 
 #define SILENCE_DETECT_PLANAR(name, type)                                        \
@@ -143,21 +210,67 @@ static void silencedetect_##name(AVFilterContext *ctx, AVFrame *insamples,
     const type noise = s->noise;                                                 \
                                                                                  \
     nb_samples /= channels;                                                      \
-    for (int i = 0; i < nb_samples; i++) {                                       \
-        for (int ch = 0; ch < insamples->ch_layout.nb_channels; ch++) {          \
+    if (s->mono) {                                                               \
+        for (int ch = 0; ch < channels; ch++) {                                  \
             const type *p = (const type *)insamples->extended_data[ch];          \
-            update(ctx, insamples, p[i] < noise && p[i] > -noise,                \
-                   channels * i + ch,                                            \
-                   nb_samples_notify, time_base);                                \
+                                                                                 \
+            for (int i = 0; i < nb_samples;) {                                   \
+                const int state = p[i] < noise && p[i] > -noise;                 \
+                const int run = silence_run_##name(p + i, nb_samples - i, 1,     \
+                                                   noise, state);                \
+                                                                                 \
+                process_run(ctx, insamples, state, (int64_t)channels * i + ch,   \
+                            run, channels, nb_samples_notify, time_base);        \
+                i += run;                                                        \
+            }                                                                    \
+        }                                                                        \
+    } else {                                                                     \
+        for (int i = 0; i < nb_samples;) {                                       \
+            const type *p0 = (const type *)insamples->extended_data[0];          \
+            const int state = p0[i] < noise && p0[i] > -noise;                   \
+            int run = nb_samples - i;                                            \
+                                                                                 \
+            /* length of the run where all channels share the state */           \
+            for (int ch = 0; ch < channels && run; ch++) {                       \
+                const type *p = (const type *)insamples->extended_data[ch];      \
+                run = FFMIN(run, silence_run_##name(p + i, run, 1,               \
+                                                    noise, state));              \
+            }                                                                    \
+                                                                                 \
+            if (run > 0) {                                                       \
+                process_run(ctx, insamples, state, (int64_t)channels * i,        \
+                            (int64_t)run * channels, 1,                          \
+                            nb_samples_notify, time_base);                       \
+                i += run;                                                        \
+            } else {                                                             \
+                /* mixed sample, keep the per-sample bookkeeping */              \
+                for (int ch = 0; ch < channels; ch++) {                          \
+                    const type *p = (const type *)insamples->extended_data[ch];  \
+                                                                                 \
+                    update(ctx, insamples, p[i] < noise && p[i] > -noise,        \
+                           channels * i + ch, nb_samples_notify, time_base);     \
+                }                                                                \
+                i++;                                                             \
+            }                                                                    \
         }                                                                        \
     }                                                                            \
 }
 
+SILENCE_RUN(dbl, double)
+SILENCE_RUN(flt, float)
+SILENCE_RUN(s32, int32_t)
+SILENCE_RUN(s16, int16_t)
+
 SILENCE_DETECT(dbl, double)
 SILENCE_DETECT(flt, float)
 SILENCE_DETECT(s32, int32_t)
 SILENCE_DETECT(s16, int16_t)
 
+#define silence_run_dblp silence_run_dbl
+#define silence_run_fltp silence_run_flt
+#define silence_run_s32p silence_run_s32
+#define silence_run_s16p silence_run_s16
+
 SILENCE_DETECT_PLANAR(dblp, double)
 SILENCE_DETECT_PLANAR(fltp, float)
 SILENCE_DETECT_PLANAR(s32p, int32_t)
@@ -178,6 +178,35 @@ static void fn(convert_channel)(AVFilterContext *ctx, AudioFIRContext *s, const
     av_log(ctx, AV_LOG_DEBUG, "input_offset: %d\n", seg->input_offset);
 }
 
+static int fn(convert_channels)(AVFilterContext *ctx, void *arg, int jobnr, int nb_jobs)
+{
+    AudioFIRContext *s = ctx->priv;
+    AudioIR *ir = &s->irs[s->conv_selir];
+    const int nb_taps = s->conv_nb_taps;
+    const int start = (s->nb_channels *  jobnr     ) / nb_jobs;
+    const int end   = (s->nb_channels * (jobnr + 1)) / nb_jobs;
+
+    for (int ch = start; ch < end; ch++) {
+        const ftype *tsrc = (const ftype *)ir->ir->extended_data[!s->one2many * ch];
+        ftype *time = (ftype *)ir->norm_ir->extended_data[ch];
+
+        memcpy(time, tsrc, sizeof(*time) * nb_taps);
+        for (int i = FFMAX(1, s->length * nb_taps); i < nb_taps; i++)
+            time[i] = F(0.0);
+
+        fn(ir_scale)(ctx, s, nb_taps, ch, time, ir->ch_gain[ch]);
+
+        for (int n = 0; n < ir->nb_segments; n++) {
+            AudioFIRSegment *seg = &ir->seg[n];
+
+            for (int i = 0; i < seg->nb_partitions; i++)
+                fn(convert_channel)(ctx, s, ch, seg, i, s->conv_selir);
+        }
+    }
+
+    return 0;
+}
+
 static int fn(ir_convert)(AVFilterContext *ctx, AudioFIRContext *s,
                           const int selir)
 {
@@ -249,29 +278,22 @@ static int fn(ir_convert)(AVFilterContext *ctx, AudioFIRContext *s,
 
     av_log(ctx, AV_LOG_DEBUG, "nb_segments: %d\n", ir->nb_segments);
 
-    for (int ch = 0; ch < s->nb_channels; ch++) {
-        const ftype *tsrc = (const ftype *)ir->ir->extended_data[!s->one2many * ch];
-        ftype *time = (ftype *)ir->norm_ir->extended_data[ch];
-
-        memcpy(time, tsrc, sizeof(*time) * nb_taps);
-        for (int i = FFMAX(1, s->length * nb_taps); i < nb_taps; i++)
-            time[i] = F(0.0);
+    for (int n = 0; n < ir->nb_segments; n++) {
+        AudioFIRSegment *seg = &ir->seg[n];
 
-        fn(ir_scale)(ctx, s, nb_taps, ch, time, ir->ch_gain[ch]);
-
-        for (int n = 0; n < ir->nb_segments; n++) {
-            AudioFIRSegment *seg = &ir->seg[n];
-
-            if (!seg->coeff)
-                seg->coeff = ff_get_audio_buffer(ctx->inputs[0], seg->nb_partitions * seg->coeff_size * 2);
-            if (!seg->coeff)
-                return AVERROR(ENOMEM);
-
-            for (int i = 0; i < seg->nb_partitions; i++)
-                fn(convert_channel)(ctx, s, ch, seg, i, selir);
-        }
+        if (!seg->coeff)
+            seg->coeff = ff_get_audio_buffer(ctx->inputs[0], seg->nb_partitions * seg->coeff_size * 2);
+        if (!seg->coeff)
+            return AVERROR(ENOMEM);
     }
 
+    /* scaling and transforming the coefficients is fully independent
+     * between channels, so spread it over the worker threads */
+    s->conv_selir   = selir;
+    s->conv_nb_taps = nb_taps;
+    ff_filter_execute(ctx, fn(convert_channels), NULL, NULL,
+                      FFMIN(s->nb_channels, ff_filter_get_nb_threads(ctx)));
+
     ir->have_coeffs = 1;
     ir->delay = delay;
 
@@ -235,6 +235,7 @@ extern const FFFilter ff_vf_alphamerge;
 extern const FFFilter ff_vf_amplify;
 extern const FFFilter ff_vf_ass;
 extern const FFFilter ff_vf_atadenoise;
+extern const FFFilter ff_vf_autoroi;
 extern const FFFilter ff_vf_avgblur;
 extern const FFFilter ff_vf_avgblur_opencl;
 extern const FFFilter ff_vf_avgblur_vulkan;
@@ -301,6 +302,7 @@ extern const FFFilter ff_vf_deblock;
 extern const FFFilter ff_vf_decimate;
 extern const FFFilter ff_vf_deconvolve;
 extern const FFFilter ff_vf_dedot;
+extern const FFFilter ff_vf_dedup;
 extern const FFFilter ff_vf_deflate;
 extern const FFFilter ff_vf_deflicker;
 extern const FFFilter ff_vf_deinterlace_qsv;
@@ -416,6 +418,7 @@ extern const FFFilter ff_vf_maskedmin;
 extern const FFFilter ff_vf_maskedthreshold;
 extern const FFFilter ff_vf_maskfun;
 extern const FFFilter ff_vf_mcdeint;
+extern const FFFilter ff_vf_mcdenoise;
 extern const FFFilter ff_vf_median;
 extern const FFFilter ff_vf_mergeplanes;
 extern const FFFilter ff_vf_mestimate;
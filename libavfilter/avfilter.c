@@ -1558,6 +1558,18 @@ size_t ff_inlink_queued_frames(AVFilterLink *link)
     return ff_framequeue_queued_frames(&li->fifo);
 }
 
+size_t ff_inlink_queued_bytes(AVFilterLink *link)
+{
+    FilterLinkInternal * const li = ff_link_internal(link);
+    return ff_framequeue_queued_bytes(&li->fifo);
+}
+
+size_t ff_inlink_peak_queued_bytes(AVFilterLink *link)
+{
+    FilterLinkInternal * const li = ff_link_internal(link);
+    return ff_framequeue_peak_queued_bytes(&li->fifo);
+}
+
 int ff_inlink_check_available_frame(AVFilterLink *link)
 {
     FilterLinkInternal * const li = ff_link_internal(link);
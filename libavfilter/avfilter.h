@@ -643,6 +643,16 @@ typedef struct AVFilterGraph {
      * avfilter_graph_config().
      */
     unsigned max_buffered_frames;
+
+    /**
+     * Sets the maximum total size, in bytes, of the frames buffered in the
+     * filtergraph combined. When the limit is exceeded, activating source
+     * filters is deferred until queued frames have been consumed.
+     *
+     * Zero means no limit. This field must be set before calling
+     * avfilter_graph_config().
+     */
+    int64_t max_buffered_bytes;
 } AVFilterGraph;
 
 /**
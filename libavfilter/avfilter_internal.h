@@ -174,6 +174,12 @@ typedef struct FFFilterGraph {
 
     AVFifo *fifo_empty_frames;
     AVMutex fifo_lock;
+
+    /** video frame pools shared by all links in the graph,
+     *  keyed by (width, height, format, align) */
+    struct FFFramePool **frame_pools;
+    int nb_frame_pools;
+    AVMutex frame_pools_lock;
 } FFFilterGraph;
 
 static inline FFFilterGraph *fffiltergraph(AVFilterGraph *graph)
@@ -204,6 +210,16 @@ FilterLinkInternal *ff_link_alloc(AVFilterGraph *graph, enum AVMediaType type);
  */
 void ff_filter_graph_remove_filter(AVFilterGraph *graph, AVFilterContext *filter);
 
+/**
+ * Get a video frame pool with the given properties, shared by all links in
+ * the graph. The pool is owned by the graph and stays valid until the graph
+ * is freed.
+ */
+struct FFFramePool *ff_graph_video_frame_pool(FFFilterGraph *graph,
+                                              int width, int height,
+                                              enum AVPixelFormat format,
+                                              int align);
+
 int ff_filter_activate(AVFilterContext *filter);
 
 /**
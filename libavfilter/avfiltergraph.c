@@ -39,6 +39,7 @@
 #include "buffersink.h"
 #include "filters.h"
 #include "formats.h"
+#include "framepool.h"
 #include "framequeue.h"
 #include "video.h"
 
@@ -60,6 +61,8 @@ static const AVOption filtergraph_options[] = {
         AV_OPT_TYPE_STRING, {.str = NULL}, 0, 0, F|A },
     {"max_buffered_frames"  , "maximum number of buffered frames allowed", OFFSET(max_buffered_frames),
         AV_OPT_TYPE_UINT,   {.i64 = 0}, 0, UINT_MAX, F|V|A },
+    {"max_buffered_bytes"   , "maximum total size of buffered frames allowed", OFFSET(max_buffered_bytes),
+        AV_OPT_TYPE_INT64,  {.i64 = 0}, 0, INT64_MAX, F|V|A },
     { NULL },
 };
 
@@ -116,6 +119,12 @@ AVFilterGraph *avfilter_graph_alloc(void)
         return NULL;
     }
 
+    err = ff_mutex_init(&graph->frame_pools_lock, NULL);
+    if (err) {
+        av_freep(&graph);
+        return NULL;
+    }
+
     ret = &graph->p;
     ret->av_class = &filtergraph_class;
     av_opt_set_defaults(ret);
@@ -177,10 +186,55 @@ void avfilter_graph_free(AVFilterGraph **graphp)
     }
     av_fifo_freep2(&graphi->fifo_empty_frames);
 
+    for (int i = 0; i < graphi->nb_frame_pools; i++)
+        ff_frame_pool_uninit(&graphi->frame_pools[i]);
+    av_freep(&graphi->frame_pools);
+    ff_mutex_destroy(&graphi->frame_pools_lock);
+
     av_freep(&graph->filters);
     av_freep(graphp);
 }
 
+FFFramePool *ff_graph_video_frame_pool(FFFilterGraph *graph,
+                                       int width, int height,
+                                       enum AVPixelFormat format, int align)
+{
+    FFFramePool *pool = NULL;
+
+    ff_mutex_lock(&graph->frame_pools_lock);
+
+    for (int i = 0; i < graph->nb_frame_pools; i++) {
+        int pool_width, pool_height, pool_align;
+        enum AVPixelFormat pool_format;
+
+        if (ff_frame_pool_get_video_config(graph->frame_pools[i],
+                                           &pool_width, &pool_height,
+                                           &pool_format, &pool_align) < 0)
+            continue;
+
+        if (pool_width == width && pool_height == height &&
+            pool_format == format && pool_align == align) {
+            pool = graph->frame_pools[i];
+            break;
+        }
+    }
+
+    if (!pool) {
+        pool = ff_frame_pool_video_init(CONFIG_MEMORY_POISONING
+                                            ? NULL
+                                            : av_buffer_allocz,
+                                        width, height, format, align);
+        if (pool &&
+            av_dynarray_add_nofree(&graph->frame_pools,
+                                   &graph->nb_frame_pools, pool) < 0)
+            ff_frame_pool_uninit(&pool);
+    }
+
+    ff_mutex_unlock(&graph->frame_pools_lock);
+
+    return pool;
+}
+
 int avfilter_graph_create_filter(AVFilterContext **filt_ctx, const AVFilter *filt,
                                  const char *name, const char *args, void *opaque,
                                  AVFilterGraph *graph_ctx)
@@ -1632,6 +1686,8 @@ int avfilter_graph_config(AVFilterGraph *graphctx, void *log_ctx)
 
     if (graphctx->max_buffered_frames)
         fffiltergraph(graphctx)->frame_queues.max_queued = graphctx->max_buffered_frames;
+    if (graphctx->max_buffered_bytes)
+        fffiltergraph(graphctx)->frame_queues.max_queued_bytes = graphctx->max_buffered_bytes;
     if ((ret = graph_check_validity(graphctx, log_ctx)))
         return ret;
     if ((ret = graph_config_formats(graphctx, log_ctx)))
@@ -1806,18 +1862,32 @@ int avfilter_graph_request_oldest(AVFilterGraph *graph)
 
 int ff_filter_graph_run_once(AVFilterGraph *graph)
 {
-    FFFilterContext *ctxi;
+    FFFrameQueueGlobal *fqg = &fffiltergraph(graph)->frame_queues;
+    int over_budget = fqg->queued_bytes > fqg->max_queued_bytes;
+    FFFilterContext *ctxi = NULL, *src_ctxi = NULL;
 
     av_assert0(graph->nb_filters);
-    ctxi = fffilterctx(graph->filters[0]);
-    for (unsigned i = 1; i < graph->nb_filters; i++) {
+    for (unsigned i = 0; i < graph->nb_filters; i++) {
         FFFilterContext *ctxi_other = fffilterctx(graph->filters[i]);
 
-        if (ctxi_other->ready > ctxi->ready)
+        if (!ctxi_other->ready)
+            continue;
+        /* when over the frame memory budget, hold sources back and drain
+           the queues first */
+        if (over_budget && !ctxi_other->p.nb_inputs) {
+            if (!src_ctxi || ctxi_other->ready > src_ctxi->ready)
+                src_ctxi = ctxi_other;
+            continue;
+        }
+        if (!ctxi || ctxi_other->ready > ctxi->ready)
             ctxi = ctxi_other;
     }
 
-    if (!ctxi->ready)
+    /* if only sources can progress, activate one anyway to avoid
+       stalling the graph */
+    if (!ctxi)
+        ctxi = src_ctxi;
+    if (!ctxi)
         return AVERROR(EAGAIN);
     return ff_filter_activate(&ctxi->p);
 }
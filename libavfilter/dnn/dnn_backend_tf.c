@@ -32,12 +32,24 @@
 #include "libavcodec/defs.h"
 #include "dnn_io_proc.h"
 #include "dnn_backend_common.h"
+#include "dnn_model_cache.h"
 #include "safe_queue.h"
 #include <tensorflow/c/c_api.h>
 
+/**
+ * The loaded graph and its session, shared between all models built
+ * from the same file through the process-wide model cache.
+ * TF_SessionRun is thread-safe, so concurrent users need no locking.
+ */
+typedef struct TFSharedModel {
+    TF_Graph *graph;
+    TF_Session *session;
+} TFSharedModel;
+
 typedef struct TFModel {
     DNNModel model;
     DnnContext *ctx;
+    TFSharedModel *shared; ///< owned by the model cache when set
     TF_Graph *graph;
     TF_Session *session;
     TF_Status *status;
@@ -478,6 +490,18 @@ static int load_tf_model(TFModel *tf_model, const char *model_filename)
     return 0;
 }
 
+static void tf_free_shared_model(void *handle)
+{
+    TFSharedModel *shared = handle;
+    TF_Status *status = TF_NewStatus();
+
+    TF_DeleteGraph(shared->graph);
+    TF_CloseSession(shared->session, status);
+    TF_DeleteSession(shared->session, status);
+    TF_DeleteStatus(status);
+    av_freep(&shared);
+}
+
 static void dnn_free_model_tf(DNNModel **model)
 {
     TFModel *tf_model;
@@ -506,12 +530,17 @@ static void dnn_free_model_tf(DNNModel **model)
     }
     ff_queue_destroy(tf_model->task_queue);
 
-    if (tf_model->graph){
-        TF_DeleteGraph(tf_model->graph);
-    }
-    if (tf_model->session){
-        TF_CloseSession(tf_model->session, tf_model->status);
-        TF_DeleteSession(tf_model->session, tf_model->status);
+    if (tf_model->shared) {
+        // the graph and session may still be in use by other models
+        ff_dnn_model_cache_release(tf_model->shared);
+    } else {
+        if (tf_model->graph){
+            TF_DeleteGraph(tf_model->graph);
+        }
+        if (tf_model->session){
+            TF_CloseSession(tf_model->session, tf_model->status);
+            TF_DeleteSession(tf_model->session, tf_model->status);
+        }
     }
     if (tf_model->status){
         TF_DeleteStatus(tf_model->status);
@@ -524,6 +553,7 @@ static DNNModel *dnn_load_model_tf(DnnContext *ctx, DNNFunctionType func_type, A
 {
     DNNModel *model = NULL;
     TFModel *tf_model = NULL;
+    char *cache_key = NULL;
 
     tf_model = av_mallocz(sizeof(TFModel));
     if (!tf_model)
@@ -531,10 +561,38 @@ static DNNModel *dnn_load_model_tf(DnnContext *ctx, DNNFunctionType func_type, A
     model = &tf_model->model;
     tf_model->ctx = ctx;
 
-    if (load_tf_model(tf_model, ctx->model_filename) != 0){
-        av_log(ctx, AV_LOG_ERROR, "Failed to load TensorFlow model: \"%s\"\n", ctx->model_filename);
+    cache_key = av_asprintf("tf\n%s\n%s", ctx->model_filename,
+                            ctx->tf_option.sess_config ? ctx->tf_option.sess_config : "");
+    if (!cache_key)
         goto err;
+
+    tf_model->shared = ff_dnn_model_cache_acquire(cache_key);
+    if (tf_model->shared) {
+        av_log(ctx, AV_LOG_VERBOSE, "Reusing cached TensorFlow model \"%s\"\n",
+               ctx->model_filename);
+        tf_model->graph   = tf_model->shared->graph;
+        tf_model->session = tf_model->shared->session;
+        tf_model->status  = TF_NewStatus();
+    } else {
+        TFSharedModel *shared;
+
+        if (load_tf_model(tf_model, ctx->model_filename) != 0){
+            av_log(ctx, AV_LOG_ERROR, "Failed to load TensorFlow model: \"%s\"\n", ctx->model_filename);
+            goto err;
+        }
+
+        shared = av_mallocz(sizeof(*shared));
+        if (!shared)
+            goto err;
+        shared->graph   = tf_model->graph;
+        shared->session = tf_model->session;
+        if (ff_dnn_model_cache_add(cache_key, shared, tf_free_shared_model) < 0) {
+            av_freep(&shared);
+            goto err;
+        }
+        tf_model->shared = shared;
     }
+    av_freep(&cache_key);
 
     if (ctx->nireq <= 0) {
         ctx->nireq = av_cpu_count() / 2 + 1;
@@ -592,6 +650,7 @@ static DNNModel *dnn_load_model_tf(DnnContext *ctx, DNNFunctionType func_type, A
 
     return model;
 err:
+    av_freep(&cache_key);
     dnn_free_model_tf(&model);
     return NULL;
 }
@@ -0,0 +1,134 @@
+/*
+ * This file is part of Librempeg
+ *
+ * Librempeg is free software; you can redistribute it and/or modify
+ * it under the terms of the GNU General Public License as published by
+ * the Free Software Foundation; either version 3 of the License, or
+ * (at your option) any later version.
+ *
+ * Librempeg is distributed in the hope that it will be useful,
+ * but WITHOUT ANY WARRANTY; without even the implied warranty of
+ * MERCHANTABILITY or FITNESS FOR A PARTICULAR PURPOSE.  See the
+ * GNU General Public License for more details.
+ *
+ * You should have received a copy of the GNU General Public License along
+ * with Librempeg; if not, write to the Free Software Foundation, Inc.,
+ * 51 Franklin Street, Fifth Floor, Boston, MA 02110-1301 USA.
+ */
+
+/**
+ * @file
+ * Process-wide cache of loaded DNN models.
+ */
+
+#include <stdint.h>
+#include <string.h>
+
+#include "libavutil/avassert.h"
+#include "libavutil/mem.h"
+#include "libavutil/thread.h"
+#include "dnn_model_cache.h"
+
+/* how many unreferenced models may stay resident */
+#define CACHE_MAX_UNUSED 2
+
+typedef struct DNNModelCacheEntry {
+    char *key;
+    void *handle;
+    void (*free_handle)(void *handle);
+    unsigned refcount;
+    uint64_t last_use;              /* eviction order for unused entries */
+    struct DNNModelCacheEntry *next;
+} DNNModelCacheEntry;
+
+static AVMutex cache_lock = AV_MUTEX_INITIALIZER;
+static DNNModelCacheEntry *cache_entries;
+static uint64_t cache_counter;
+
+static void cache_entry_free(DNNModelCacheEntry *entry)
+{
+    entry->free_handle(entry->handle);
+    av_freep(&entry->key);
+    av_freep(&entry);
+}
+
+/* evict the longest-unused entries beyond the warm limit, with the lock held */
+static void cache_trim(void)
+{
+    for (;;) {
+        DNNModelCacheEntry **oldest = NULL, **ep;
+        unsigned nb_unused = 0;
+
+        for (ep = &cache_entries; *ep; ep = &(*ep)->next) {
+            if ((*ep)->refcount)
+                continue;
+            nb_unused++;
+            if (!oldest || (*ep)->last_use < (*oldest)->last_use)
+                oldest = ep;
+        }
+        if (nb_unused <= CACHE_MAX_UNUSED)
+            return;
+
+        DNNModelCacheEntry *entry = *oldest;
+        *oldest = entry->next;
+        cache_entry_free(entry);
+    }
+}
+
+void *ff_dnn_model_cache_acquire(const char *key)
+{
+    void *handle = NULL;
+
+    ff_mutex_lock(&cache_lock);
+    for (DNNModelCacheEntry *entry = cache_entries; entry; entry = entry->next) {
+        if (!strcmp(entry->key, key)) {
+            entry->refcount++;
+            entry->last_use = ++cache_counter;
+            handle = entry->handle;
+            break;
+        }
+    }
+    ff_mutex_unlock(&cache_lock);
+
+    return handle;
+}
+
+int ff_dnn_model_cache_add(const char *key, void *handle, void (*free_handle)(void *handle))
+{
+    DNNModelCacheEntry *entry;
+
+    entry = av_mallocz(sizeof(*entry));
+    if (!entry)
+        return AVERROR(ENOMEM);
+    entry->key = av_strdup(key);
+    if (!entry->key) {
+        av_freep(&entry);
+        return AVERROR(ENOMEM);
+    }
+    entry->handle      = handle;
+    entry->free_handle = free_handle;
+    entry->refcount    = 1;
+
+    ff_mutex_lock(&cache_lock);
+    entry->last_use = ++cache_counter;
+    entry->next     = cache_entries;
+    cache_entries   = entry;
+    ff_mutex_unlock(&cache_lock);
+
+    return 0;
+}
+
+void ff_dnn_model_cache_release(void *handle)
+{
+    ff_mutex_lock(&cache_lock);
+    for (DNNModelCacheEntry *entry = cache_entries; entry; entry = entry->next) {
+        if (entry->handle == handle) {
+            av_assert0(entry->refcount > 0);
+            entry->refcount--;
+            entry->last_use = ++cache_counter;
+            break;
+        }
+    }
+    cache_trim();
+    ff_mutex_unlock(&cache_lock);
+}
@@ -0,0 +1,64 @@
+/*
+ * This file is part of Librempeg
+ *
+ * Librempeg is free software; you can redistribute it and/or modify
+ * it under the terms of the GNU General Public License as published by
+ * the Free Software Foundation; either version 3 of the License, or
+ * (at your option) any later version.
+ *
+ * Librempeg is distributed in the hope that it will be useful,
+ * but WITHOUT ANY WARRANTY; without even the implied warranty of
+ * MERCHANTABILITY or FITNESS FOR A PARTICULAR PURPOSE.  See the
+ * GNU General Public License for more details.
+ *
+ * You should have received a copy of the GNU General Public License along
+ * with Librempeg; if not, write to the Free Software Foundation, Inc.,
+ * 51 Franklin Street, Fifth Floor, Boston, MA 02110-1301 USA.
+ */
+
+/**
+ * @file
+ * Process-wide cache of loaded DNN models.
+ *
+ * Loading and compiling a model is by far the most expensive part of
+ * instantiating a DNN filter, so the backends register their loaded
+ * model handles here and look them up before loading again. Entries
+ * are refcounted; a bounded number of unused entries is kept warm so
+ * that tearing down one filter graph and building the next one with
+ * the same model skips the reload entirely.
+ */
+
+#ifndef AVFILTER_DNN_DNN_MODEL_CACHE_H
+#define AVFILTER_DNN_DNN_MODEL_CACHE_H
+
+/**
+ * Look up a cached model handle.
+ *
+ * The key must encode everything the handle depends on (backend,
+ * model path, device, relevant backend options). On a hit the entry's
+ * refcount is incremented and the handle as passed to
+ * ff_dnn_model_cache_add() is returned, NULL on a miss.
+ */
+void *ff_dnn_model_cache_acquire(const char *key);
+
+/**
+ * Insert a freshly loaded model handle with a refcount of one.
+ *
+ * free_handle is called when the entry is eventually evicted.
+ * The key is copied.
+ *
+ * @return 0 on success, a negative error code otherwise; on error the
+ *         caller keeps ownership of the handle.
+ */
+int ff_dnn_model_cache_add(const char *key, void *handle, void (*free_handle)(void *handle));
+
+/**
+ * Drop one reference to a cached handle.
+ *
+ * Unreferenced entries are not freed immediately but kept warm for
+ * later ff_dnn_model_cache_acquire() calls; only the oldest ones are
+ * evicted once more than a few of them accumulate.
+ */
+void ff_dnn_model_cache_release(void *handle);
+
+#endif
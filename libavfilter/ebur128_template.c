@@ -51,77 +51,6 @@
 #define fn2(a,b)   fn3(a,b)
 #define fn(a)      fn2(a, SAMPLE_FORMAT)
 
-static av_always_inline void fn(process_ebur128)(const ftype **ch_samples,
-                                                 const unsigned nb_channels,
-                                                 const unsigned i3000_cache_size,
-                                                 const unsigned i400_cache_size,
-                                                 unsigned *i3000_cache_pos,
-                                                 unsigned *i400_cache_pos,
-                                                 unsigned *i3000_filled,
-                                                 unsigned *i400_filled,
-                                                 const double *ch_weighting,
-                                                 const struct filter_coeffs *cf,
-                                                 double *i3000_cache,
-                                                 double *i400_cache,
-                                                 double *i3000_sum,
-                                                 double *i400_sum,
-                                                 double *t0)
-{
-    const unsigned bin_id_3000 = i3000_cache_pos[0];
-    const unsigned bin_id_400  = i400_cache_pos[0];
-    const double *pre_a = cf->pre_a;
-    const double *pre_b = cf->pre_b;
-    const double *rlb_a = cf->rlb_a;
-    const double *rlb_b = cf->rlb_b;
-
-#define MOVE_TO_NEXT_CACHED_ENTRY(time) do { \
-    i##time##_cache_pos[0]++;                \
-    if (i##time##_cache_pos[0] >=            \
-        i##time##_cache_size) {              \
-        i##time##_filled[0]    = 1;          \
-        i##time##_cache_pos[0] = 0;          \
-    }                                        \
-} while (0)
-
-    MOVE_TO_NEXT_CACHED_ENTRY(400);
-    MOVE_TO_NEXT_CACHED_ENTRY(3000);
-
-    for (unsigned ch = 0; ch < nb_channels; ch++) {
-        const double sample = SCALE(*ch_samples[ch]++);
-        const int ch4 = ch * 4;
-        double *tt0 = t0 + ch4;
-        double *tt1 = tt0 + 2;
-        double bin, out;
-
-        if (ch_weighting && !ch_weighting[ch])
-            continue;
-
-#define FILTER(y, x, t, NUM, DEN) do {                       \
-        y = NUM[0] * x + t[0];                               \
-        t[0] = NUM[1] * x + t[1] - DEN[1] * y;               \
-        t[1] = NUM[2] * x        - DEN[2] * y;               \
-} while (0)
-
-        // TODO: merge both filters in one?
-        FILTER(out, sample, tt0, pre_b, pre_a);  // apply pre-filter
-        FILTER(bin, out,    tt1, rlb_b, rlb_a);  // apply RLB-filter
-
-        bin *= bin;
-
-        /* add the new value, and limit the sum to the cache size (400ms or 3s)
-         * by removing the oldest one */
-        i400_sum [ch] += bin - i400_cache [bin_id_400];
-        i3000_sum[ch] += bin - i3000_cache[bin_id_3000];
-
-        /* override old cache entry with the new value */
-        i400_cache [bin_id_400 ] = bin;
-        i3000_cache[bin_id_3000] = bin;
-
-        i400_cache  += i400_cache_size;
-        i3000_cache += i3000_cache_size;
-    }
-}
-
 static void fn(process_block)(const ftype **ch_samples,
                               const unsigned nb_channels,
                               const unsigned i3000_cache_size,
@@ -140,26 +69,84 @@ static void fn(process_block)(const ftype **ch_samples,
                               const int samples_to_process,
                               const int nozero_ch_weighting)
 {
-    if (nozero_ch_weighting && nb_channels == 2) {
-        for (int n = 0; n < samples_to_process; n++)
-            fn(process_ebur128)(ch_samples, 2,
-                                i3000_cache_size, i400_cache_size,
-                                i3000_cache_pos, i400_cache_pos,
-                                i3000_filled, i400_filled,
-                                NULL, cf,
-                                i3000_cache, i400_cache,
-                                i3000_sum, i400_sum,
-                                t0);
-    } else {
-        for (int n = 0; n < samples_to_process; n++)
-            fn(process_ebur128)(ch_samples, nb_channels,
-                                i3000_cache_size, i400_cache_size,
-                                i3000_cache_pos, i400_cache_pos,
-                                i3000_filled, i400_filled,
-                                ch_weighting, cf,
-                                i3000_cache, i400_cache,
-                                i3000_sum, i400_sum,
-                                t0);
+    const double *weighting = nozero_ch_weighting ? NULL : ch_weighting;
+    const double pre_a1 = cf->pre_a[1], pre_a2 = cf->pre_a[2];
+    const double pre_b0 = cf->pre_b[0], pre_b1 = cf->pre_b[1], pre_b2 = cf->pre_b[2];
+    const double rlb_a1 = cf->rlb_a[1], rlb_a2 = cf->rlb_a[2];
+    const double rlb_b0 = cf->rlb_b[0], rlb_b1 = cf->rlb_b[1], rlb_b2 = cf->rlb_b[2];
+    int n = 0;
+
+    /* Walk the input in runs which do not wrap either cache ring, one
+     * channel at a time, so the filter state stays in registers and both
+     * the samples and the cache entries are streamed contiguously. */
+    while (n < samples_to_process) {
+        const unsigned pos_400  = i400_cache_pos[0];
+        const unsigned pos_3000 = i3000_cache_pos[0];
+        int run = samples_to_process - n;
+
+        run = FFMIN(run, (int)(i400_cache_size  - pos_400));
+        run = FFMIN(run, (int)(i3000_cache_size - pos_3000));
+
+        for (unsigned ch = 0; ch < nb_channels; ch++) {
+            const ftype *src = ch_samples[ch];
+            double *c400  = i400_cache  + ch * i400_cache_size  + pos_400;
+            double *c3000 = i3000_cache + ch * i3000_cache_size + pos_3000;
+            double *tt = t0 + ch * 4;
+            double t00 = tt[0], t01 = tt[1], t10 = tt[2], t11 = tt[3];
+            double sum_400 = 0.0, sum_3000 = 0.0;
+
+            ch_samples[ch] += run;
+
+            if (weighting && !weighting[ch])
+                continue;
+
+            for (int i = 0; i < run; i++) {
+                const double sample = SCALE(src[i]);
+                double bin, out;
+
+                // TODO: merge both filters in one?
+                /* apply pre-filter, then RLB-filter */
+                out = pre_b0 * sample + t00;
+                t00 = pre_b1 * sample + t01 - pre_a1 * out;
+                t01 = pre_b2 * sample       - pre_a2 * out;
+                bin = rlb_b0 * out + t10;
+                t10 = rlb_b1 * out + t11 - rlb_a1 * bin;
+                t11 = rlb_b2 * out       - rlb_a2 * bin;
+
+                bin *= bin;
+
+                /* add the new value, and limit the sum to the cache size
+                 * (400ms or 3s) by removing the oldest one */
+                sum_400  += bin - c400[i];
+                sum_3000 += bin - c3000[i];
+
+                /* override old cache entry with the new value */
+                c400[i]  = bin;
+                c3000[i] = bin;
+            }
+
+            i400_sum [ch] += sum_400;
+            i3000_sum[ch] += sum_3000;
+
+            tt[0] = t00;
+            tt[1] = t01;
+            tt[2] = t10;
+            tt[3] = t11;
+        }
+
+        i400_cache_pos[0] = pos_400 + run;
+        if (i400_cache_pos[0] == i400_cache_size) {
+            i400_filled[0]    = 1;
+            i400_cache_pos[0] = 0;
+        }
+
+        i3000_cache_pos[0] = pos_3000 + run;
+        if (i3000_cache_pos[0] == i3000_cache_size) {
+            i3000_filled[0]    = 1;
+            i3000_cache_pos[0] = 0;
+        }
+
+        n += run;
     }
 }
 
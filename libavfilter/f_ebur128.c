@@ -33,6 +33,7 @@
 #include "libavutil/channel_layout.h"
 #include "libavutil/dict.h"
 #include "libavutil/ffmath.h"
+#include "libavutil/file_open.h"
 #include "libavutil/mem.h"
 #include "libavutil/xga_font_data.h"
 #include "libavutil/opt.h"
@@ -1327,6 +1328,8 @@ typedef struct LoudNormContext {
     double measured_lra;
     double measured_tp;
     double measured_thresh;
+    char *import_file_str;
+    char *export_file_str;
     double offset;
     int linear_mode;
     int dual_mono;
@@ -1357,11 +1360,72 @@ typedef struct LoudNormContext {
     EBUR128Context r128_out;
 } LoudNormContext;
 
+static int loudnorm_import_state(AVFilterContext *ctx)
+{
+    LoudNormContext *s = ctx->priv;
+    char line[256];
+    FILE *f;
+
+    f = avpriv_fopen_utf8(s->import_file_str, "r");
+    if (!f) {
+        av_log(ctx, AV_LOG_ERROR, "Cannot open measured stats file '%s'.\n",
+               s->import_file_str);
+        return AVERROR(EINVAL);
+    }
+
+    while (fgets(line, sizeof(line), f)) {
+        double v;
+
+        if (sscanf(line, "measured_i=%lf", &v) == 1)
+            s->measured_i = v;
+        else if (sscanf(line, "measured_lra=%lf", &v) == 1)
+            s->measured_lra = v;
+        else if (sscanf(line, "measured_tp=%lf", &v) == 1)
+            s->measured_tp = v;
+        else if (sscanf(line, "measured_thresh=%lf", &v) == 1)
+            s->measured_thresh = v;
+    }
+
+    fclose(f);
+
+    av_log(ctx, AV_LOG_VERBOSE, "Loaded measured stats: I:%g LRA:%g TP:%g thresh:%g\n",
+           s->measured_i, s->measured_lra, s->measured_tp, s->measured_thresh);
+
+    return 0;
+}
+
+static void loudnorm_export_state(AVFilterContext *ctx)
+{
+    LoudNormContext *s = ctx->priv;
+    EBUR128Context *r128_in = &s->r128_in;
+    FILE *f;
+
+    f = avpriv_fopen_utf8(s->export_file_str, "w");
+    if (!f) {
+        av_log(ctx, AV_LOG_ERROR, "Cannot open measured stats file '%s' for writing.\n",
+               s->export_file_str);
+        return;
+    }
+
+    fprintf(f, "measured_i=%f\n",      r128_in->integrated_loudness);
+    fprintf(f, "measured_lra=%f\n",    r128_in->loudness_range);
+    fprintf(f, "measured_tp=%f\n",     r128_in->true_peak);
+    fprintf(f, "measured_thresh=%f\n", r128_in->i3000.rel_threshold);
+
+    fclose(f);
+}
+
 static av_cold int loudnorm_init(AVFilterContext *ctx)
 {
     LoudNormContext *s = ctx->priv;
     int ret;
 
+    if (s->import_file_str) {
+        ret = loudnorm_import_state(ctx);
+        if (ret < 0)
+            return ret;
+    }
+
     ret = init_ebur128(ctx, &s->r128_in);
     if (ret < 0)
         return ret;
@@ -1394,6 +1458,9 @@ static av_cold void loudnorm_uninit(AVFilterContext *ctx)
     EBUR128Context *r128_out = &s->r128_out;
     EBUR128Context *r128_in = &s->r128_in;
 
+    if (s->nb_channels > 0 && s->export_file_str)
+        loudnorm_export_state(ctx);
+
     if (s->nb_channels > 0) {
     switch (s->print_format) {
     case NONE:
@@ -1617,17 +1684,22 @@ static int loudnorm_filter_frame(AVFilterLink *inlink, AVFrame *in)
     for (int ch = 0; ch < nb_channels && in; ch++)
         ch_samples_f64[ch] = ((const double *)samples[ch]) + r128_in->idx_insample;
 
-    for (int idx_insample = r128_in->idx_insample; idx_insample < nb_samples; idx_insample++) {
-        process_ebur128_dblp(ch_samples_f64, nb_channels,
-                             i3000_cache_size, i400_cache_size,
-                             i3000_cache_pos, i400_cache_pos,
-                             i3000_filled, i400_filled,
-                             ch_weighting, cf,
-                             i3000_cache, i400_cache,
-                             i3000_sum, i400_sum,
-                             t0);
-
-        if (++r128_in->sample_count == block_samples) {
+    for (int idx_insample = r128_in->idx_insample; idx_insample < nb_samples;) {
+        const int run = FFMIN(nb_samples - idx_insample, block_samples - r128_in->sample_count);
+
+        process_block_dblp(ch_samples_f64, nb_channels,
+                           i3000_cache_size, i400_cache_size,
+                           i3000_cache_pos, i400_cache_pos,
+                           i3000_filled, i400_filled,
+                           ch_weighting, cf,
+                           i3000_cache, i400_cache,
+                           i3000_sum, i400_sum,
+                           t0, run, r128_in->nozero_ch_weighting);
+
+        idx_insample += run;
+        r128_in->sample_count += run;
+
+        if (r128_in->sample_count == block_samples) {
             double peak;
 
             ebur128_loudness(inlink, r128_in, &s->i400, &s->i3000, &s->integrated, &peak);
@@ -1725,17 +1797,22 @@ static int loudnorm_filter_frame(AVFilterLink *inlink, AVFrame *in)
         for (int ch = 0; ch < nb_channels; ch++)
             ch_samples_f64[ch] = ((const double *)samples[ch]) + r128_out->idx_insample;
 
-        for (int idx_insample = r128_out->idx_insample; idx_insample < out->nb_samples; idx_insample++) {
-            process_ebur128_dblp(ch_samples_f64, nb_channels,
-                                 i3000_cache_size, i400_cache_size,
-                                 i3000_cache_pos, i400_cache_pos,
-                                 i3000_filled, i400_filled,
-                                 ch_weighting, cf,
-                                 i3000_cache, i400_cache,
-                                 i3000_sum, i400_sum,
-                                 t0);
-
-            if (++r128_out->sample_count == inlink->sample_rate / 10) {
+        for (int idx_insample = r128_out->idx_insample; idx_insample < out->nb_samples;) {
+            const int run = FFMIN(out->nb_samples - idx_insample, block_samples - r128_out->sample_count);
+
+            process_block_dblp(ch_samples_f64, nb_channels,
+                               i3000_cache_size, i400_cache_size,
+                               i3000_cache_pos, i400_cache_pos,
+                               i3000_filled, i400_filled,
+                               ch_weighting, cf,
+                               i3000_cache, i400_cache,
+                               i3000_sum, i400_sum,
+                               t0, run, r128_out->nozero_ch_weighting);
+
+            idx_insample += run;
+            r128_out->sample_count += run;
+
+            if (r128_out->sample_count == block_samples) {
                 double loudness_400, loudness_3000, loudness_integrated, peak;
                 ebur128_loudness(inlink, r128_out, &loudness_400, &loudness_3000, &loudness_integrated, &peak);
             }
@@ -1809,6 +1886,8 @@ static const AVOption loudnorm_options[] = {
     { "measured_TP",      "measured true peak of input file",  OFFSET(measured_tp),      AV_OPT_TYPE_DOUBLE,  {.dbl =  99.},   -99.,       99.,  FLAGS },
     { "measured_tp",      "measured true peak of input file",  OFFSET(measured_tp),      AV_OPT_TYPE_DOUBLE,  {.dbl =  99.},   -99.,       99.,  FLAGS },
     { "measured_thresh",  "measured threshold of input file",  OFFSET(measured_thresh),  AV_OPT_TYPE_DOUBLE,  {.dbl = -70.},   -99.,        0.,  FLAGS },
+    { "import_file",      "load measured stats of input file", OFFSET(import_file_str),  AV_OPT_TYPE_STRING,  {.str = NULL},      0,         0,  FLAGS },
+    { "export_file",      "write measured stats of input file",OFFSET(export_file_str),  AV_OPT_TYPE_STRING,  {.str = NULL},      0,         0,  FLAGS },
     { "offset",           "set offset gain",                   OFFSET(offset),           AV_OPT_TYPE_DOUBLE,  {.dbl =  0.},    -99.,       99.,  FLAGS },
     { "linear",           "normalize linearly if possible",    OFFSET(linear_mode),      AV_OPT_TYPE_BOOL,    {.i64 =  1},        0,         1,  FLAGS },
     { "dual_mono",        "treat mono input as dual-mono",     OFFSET(dual_mono),        AV_OPT_TYPE_BOOL,    {.i64 =  0},        0,         1,  FLAGS },
@@ -90,6 +90,8 @@ enum {
     FLAG_FC_DELTA = 1 << 14,
     FLAG_SC_DELTA = 1 << 15,
     FLAG_DISABLED = 1 << 16,
+    FLAG_BYTES = 1 << 17,
+    FLAG_BYTES_PEAK = 1 << 18,
 };
 
 #define OFFSET(x) offsetof(GraphMonitorContext, x)
@@ -129,6 +131,8 @@ static const AVOption graphmonitor_options[] = {
         { "sample_count_out", NULL, 0, AV_OPT_TYPE_CONST, {.i64=FLAG_SCIN},    0, 0, VFR, .unit = "flags" },
         { "sample_count_delta",NULL,0, AV_OPT_TYPE_CONST, {.i64=FLAG_SC_DELTA},0, 0, VFR, .unit = "flags" },
         { "disabled",         NULL, 0, AV_OPT_TYPE_CONST, {.i64=FLAG_DISABLED},0, 0, VFR, .unit = "flags" },
+        { "queued_bytes",     NULL, 0, AV_OPT_TYPE_CONST, {.i64=FLAG_BYTES},   0, 0, VFR, .unit = "flags" },
+        { "queued_bytes_peak",NULL, 0, AV_OPT_TYPE_CONST, {.i64=FLAG_BYTES_PEAK},0,0,VFR, .unit = "flags" },
     { "rate", "set video rate", OFFSET(frame_rate), AV_OPT_TYPE_VIDEO_RATE, {.str = "25"}, 0, INT_MAX, VF },
     { "r",    "set video rate", OFFSET(frame_rate), AV_OPT_TYPE_VIDEO_RATE, {.str = "25"}, 0, INT_MAX, VF },
     { NULL }
@@ -308,6 +312,16 @@ static int draw_items(AVFilterContext *ctx,
         drawtext(out, xpos, ypos, buffer, len, frames > 0 ? frames >= 10 ? frames >= 50 ? s->red : s->yellow : s->green : s->white);
         xpos += len * 8;
     }
+    if ((flags & FLAG_BYTES) && (!(mode & MODE_NOZERO) || ff_inlink_queued_bytes(l))) {
+        len = snprintf(buffer, sizeof(buffer)-1, " | bytes: %zu", ff_inlink_queued_bytes(l));
+        drawtext(out, xpos, ypos, buffer, len, s->white);
+        xpos += len * 8;
+    }
+    if ((flags & FLAG_BYTES_PEAK) && (!(mode & MODE_NOZERO) || ff_inlink_peak_queued_bytes(l))) {
+        len = snprintf(buffer, sizeof(buffer)-1, " | peak_bytes: %zu", ff_inlink_peak_queued_bytes(l));
+        drawtext(out, xpos, ypos, buffer, len, s->white);
+        xpos += len * 8;
+    }
     if ((flags & FLAG_FCIN) && (!(mode & MODE_NOZERO) || fl->frame_count_in)) {
         len = snprintf(buffer, sizeof(buffer)-1, " | in: %"PRId64, fl->frame_count_in);
         drawtext(out, xpos, ypos, buffer, len, s->white);
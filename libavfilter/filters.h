@@ -553,6 +553,18 @@ void ff_filter_set_ready(AVFilterContext *filter, unsigned priority);
  */
 size_t ff_inlink_queued_frames(AVFilterLink *link);
 
+/**
+ * Get the total size of the frame data queued on the link.
+ * @return the size in bytes of the frames in the link fifo.
+ */
+size_t ff_inlink_queued_bytes(AVFilterLink *link);
+
+/**
+ * Get the largest total size of the frame data ever queued on the link.
+ * @return the high-water mark in bytes of the link fifo.
+ */
+size_t ff_inlink_peak_queued_bytes(AVFilterLink *link);
+
 /**
  * Test if a frame is available on the link.
  * @return  >0 if a frame is available
@@ -95,6 +95,7 @@ do {                                                                       \
 static int merge_formats_internal(AVFilterFormats *a, AVFilterFormats *b,
                                   enum AVMediaType type, int check)
 {
+    uint64_t in_b[(AV_PIX_FMT_NB + 63) / 64] = { 0 };
     int i, j, k = 0;
     int alpha1=0, alpha2=0;
     int chroma1=0, chroma2=0;
@@ -112,7 +113,7 @@ static int merge_formats_internal(AVFilterFormats *a, AVFilterFormats *b,
        possibly causing a lossy conversion elsewhere in the graph.
        To avoid that, pretend that there are no common formats to force the
        insertion of a conversion filter. */
-    if (type == AVMEDIA_TYPE_VIDEO) {
+    if (type == AVMEDIA_TYPE_VIDEO && (a->flags || b->flags)) {
         for (i = 0; i < a->nb_formats; i++) {
             const AVPixFmtDescriptor *const adesc = av_pix_fmt_desc_get(a->formats[i]);
             for (j = 0; j < b->nb_formats; j++) {
@@ -123,7 +124,7 @@ static int merge_formats_internal(AVFilterFormats *a, AVFilterFormats *b,
                     alpha1 |= adesc->flags & AV_PIX_FMT_FLAG_ALPHA;
                     chroma1|= adesc->nb_components > 1;
                 }
-                if (check && (a->flags || b->flags)) {
+                if (check) {
                     int add_param = 1;
 
                     if ((a->flags & FILTER_SAME_BITDEPTH) || (b->flags & FILTER_SAME_BITDEPTH)) {
@@ -162,9 +163,32 @@ static int merge_formats_internal(AVFilterFormats *a, AVFilterFormats *b,
         }
 
         if (check) {
-            if (a->flags || b->flags) {
-                if (same_params == 0)
-                    return 0;
+            if (same_params == 0)
+                return 0;
+        }
+    } else if (type == AVMEDIA_TYPE_VIDEO) {
+        /* Without FILTER_SAME_* flags only plain membership matters, so
+           mark the formats of b in a bitmap and avoid walking all pairs
+           of formats; repeatedly instantiated graphs spend most of their
+           negotiation time merging full format lists here. */
+        uint64_t b_flags = 0;
+        int b_chroma = 0;
+
+        for (j = 0; j < b->nb_formats; j++) {
+            const AVPixFmtDescriptor *bdesc = av_pix_fmt_desc_get(b->formats[j]);
+
+            in_b[b->formats[j] / 64] |= UINT64_C(1) << (b->formats[j] % 64);
+            b_flags  |= bdesc->flags;
+            b_chroma |= bdesc->nb_components > 1;
+        }
+        for (i = 0; i < a->nb_formats; i++) {
+            const AVPixFmtDescriptor *const adesc = av_pix_fmt_desc_get(a->formats[i]);
+
+            alpha2 |= adesc->flags & b_flags & AV_PIX_FMT_FLAG_ALPHA;
+            chroma2|= adesc->nb_components > 1 && b_chroma;
+            if (in_b[a->formats[i] / 64] & (UINT64_C(1) << (a->formats[i] % 64))) {
+                alpha1 |= adesc->flags & AV_PIX_FMT_FLAG_ALPHA;
+                chroma1|= adesc->nb_components > 1;
             }
         }
     }
@@ -173,55 +197,47 @@ static int merge_formats_internal(AVFilterFormats *a, AVFilterFormats *b,
     if (alpha2 > alpha1 || chroma2 > chroma1)
         return 0;
 
-    if (type == AVMEDIA_TYPE_VIDEO) {
+    if (type == AVMEDIA_TYPE_VIDEO && (a->flags || b->flags)) {
         for (i = 0; i < a->nb_formats; i++) {
             const AVPixFmtDescriptor *const adesc = av_pix_fmt_desc_get(a->formats[i]);
             for (j = 0; j < b->nb_formats; j++) {
                 const AVPixFmtDescriptor *bdesc = av_pix_fmt_desc_get(b->formats[j]);
-                if (a->flags || b->flags) {
-                    int add_format = 1;
-
-                    if ((a->flags & FILTER_SAME_BITDEPTH) || (b->flags & FILTER_SAME_BITDEPTH)) {
-                        const int afloat = !!(adesc->flags & AV_PIX_FMT_FLAG_FLOAT);
-                        const int bfloat = !!(bdesc->flags & AV_PIX_FMT_FLAG_FLOAT);
-                        const int abits = adesc->comp[0].depth;
-                        const int bbits = bdesc->comp[0].depth;
+                int add_format = 1;
 
-                        add_format &= (abits == bbits && afloat == bfloat);
-                    }
-                    if ((a->flags & FILTER_SAME_ENDIANNESS) || (b->flags & FILTER_SAME_ENDIANNESS)) {
-                        const int abe = !!(adesc->flags & AV_PIX_FMT_FLAG_BE);
-                        const int bbe = !!(bdesc->flags & AV_PIX_FMT_FLAG_BE);
+                if ((a->flags & FILTER_SAME_BITDEPTH) || (b->flags & FILTER_SAME_BITDEPTH)) {
+                    const int afloat = !!(adesc->flags & AV_PIX_FMT_FLAG_FLOAT);
+                    const int bfloat = !!(bdesc->flags & AV_PIX_FMT_FLAG_FLOAT);
+                    const int abits = adesc->comp[0].depth;
+                    const int bbits = bdesc->comp[0].depth;
 
-                        add_format &= (abe == bbe);
-                    }
-                    if ((a->flags & FILTER_SAME_RGB_FLAG) || (b->flags & FILTER_SAME_RGB_FLAG)) {
-                        const int argb = !!(adesc->flags & AV_PIX_FMT_FLAG_RGB);
-                        const int brgb = !!(bdesc->flags & AV_PIX_FMT_FLAG_RGB);
+                    add_format &= (abits == bbits && afloat == bfloat);
+                }
+                if ((a->flags & FILTER_SAME_ENDIANNESS) || (b->flags & FILTER_SAME_ENDIANNESS)) {
+                    const int abe = !!(adesc->flags & AV_PIX_FMT_FLAG_BE);
+                    const int bbe = !!(bdesc->flags & AV_PIX_FMT_FLAG_BE);
 
-                        add_format &= (argb == brgb);
-                    }
-                    if ((a->flags & FILTER_SAME_PLANAR_FLAG) || (b->flags & FILTER_SAME_PLANAR_FLAG)) {
-                        const int aplanar = !!(adesc->flags & AV_PIX_FMT_FLAG_PLANAR);
-                        const int bplanar = !!(bdesc->flags & AV_PIX_FMT_FLAG_PLANAR);
+                    add_format &= (abe == bbe);
+                }
+                if ((a->flags & FILTER_SAME_RGB_FLAG) || (b->flags & FILTER_SAME_RGB_FLAG)) {
+                    const int argb = !!(adesc->flags & AV_PIX_FMT_FLAG_RGB);
+                    const int brgb = !!(bdesc->flags & AV_PIX_FMT_FLAG_RGB);
 
-                        add_format &= (aplanar == bplanar);
-                    }
-                    if ((a->flags & FILTER_SAME_SUBSAMPLING) || (b->flags & FILTER_SAME_SUBSAMPLING)) {
-                        const int wsubs = adesc->log2_chroma_w == bdesc->log2_chroma_w;
-                        const int hsubs = adesc->log2_chroma_h == bdesc->log2_chroma_h;
+                    add_format &= (argb == brgb);
+                }
+                if ((a->flags & FILTER_SAME_PLANAR_FLAG) || (b->flags & FILTER_SAME_PLANAR_FLAG)) {
+                    const int aplanar = !!(adesc->flags & AV_PIX_FMT_FLAG_PLANAR);
+                    const int bplanar = !!(bdesc->flags & AV_PIX_FMT_FLAG_PLANAR);
 
-                        add_format &= (wsubs && hsubs);
-                    }
+                    add_format &= (aplanar == bplanar);
+                }
+                if ((a->flags & FILTER_SAME_SUBSAMPLING) || (b->flags & FILTER_SAME_SUBSAMPLING)) {
+                    const int wsubs = adesc->log2_chroma_w == bdesc->log2_chroma_w;
+                    const int hsubs = adesc->log2_chroma_h == bdesc->log2_chroma_h;
 
-                    if (add_format) {
-                        if (check)
-                            return 1;
+                    add_format &= (wsubs && hsubs);
+                }
 
-                        a->formats[k++] = a->formats[i];
-                        break;
-                    }
-                } else if (a->formats[i] == b->formats[j]) {
+                if (add_format) {
                     if (check)
                         return 1;
 
@@ -230,6 +246,15 @@ static int merge_formats_internal(AVFilterFormats *a, AVFilterFormats *b,
                 }
             }
         }
+    } else if (type == AVMEDIA_TYPE_VIDEO) {
+        for (i = 0; i < a->nb_formats; i++) {
+            if (in_b[a->formats[i] / 64] & (UINT64_C(1) << (a->formats[i] % 64))) {
+                if (check)
+                    return 1;
+
+                a->formats[k++] = a->formats[i];
+            }
+        }
     }
 
     if (type == AVMEDIA_TYPE_AUDIO) {
@@ -32,6 +32,20 @@ void ff_framequeue_global_init(FFFrameQueueGlobal *fqg)
 {
     fqg->max_queued = SIZE_MAX;
     fqg->queued = 0;
+    fqg->max_queued_bytes = SIZE_MAX;
+    fqg->queued_bytes = 0;
+}
+
+static size_t frame_bytes(const AVFrame *frame)
+{
+    size_t bytes = 0;
+    int i;
+
+    for (i = 0; i < AV_NUM_DATA_POINTERS && frame->buf[i]; i++)
+        bytes += frame->buf[i]->size;
+    for (i = 0; i < frame->nb_extended_buf; i++)
+        bytes += frame->extended_buf[i]->size;
+    return bytes;
 }
 
 static void check_consistency(FFFrameQueue *fq)
@@ -93,8 +107,12 @@ int ff_framequeue_add(FFFrameQueue *fq, AVFrame *frame)
     }
     b = bucket(fq, fq->queued);
     b->frame = frame;
+    b->bytes = frame_bytes(frame);
     fq->queued++;
     fq->global->queued++;
+    fq->queued_bytes += b->bytes;
+    fq->global->queued_bytes += b->bytes;
+    fq->peak_queued_bytes = FFMAX(fq->peak_queued_bytes, fq->queued_bytes);
     fq->total_frames_head++;
     fq->total_samples_head += frame->nb_samples;
     check_consistency(fq);
@@ -110,6 +128,8 @@ AVFrame *ff_framequeue_take(FFFrameQueue *fq)
     b = bucket(fq, 0);
     fq->queued--;
     fq->global->queued--;
+    fq->queued_bytes -= b->bytes;
+    fq->global->queued_bytes -= b->bytes;
     fq->tail++;
     fq->tail &= fq->allocated - 1;
     fq->total_frames_tail++;
@@ -33,6 +33,7 @@
 
 typedef struct FFFrameBucket {
     AVFrame *frame;
+    size_t bytes;
 } FFFrameBucket;
 
 /**
@@ -52,6 +53,16 @@ typedef struct FFFrameQueueGlobal {
      * Total number of queued frames in the queues combined.
      */
     size_t queued;
+
+    /**
+     * Maximum total size of frame data allowed in the queues combined.
+     */
+    size_t max_queued_bytes;
+
+    /**
+     * Total size of the frame data in the queues combined.
+     */
+    size_t queued_bytes;
 } FFFrameQueueGlobal;
 
 /**
@@ -112,6 +123,16 @@ typedef struct FFFrameQueue {
      */
     uint64_t total_samples_tail;
 
+    /**
+     * Total size of the frame data currently in the queue.
+     */
+    size_t queued_bytes;
+
+    /**
+     * Largest total size of the frame data ever in the queue.
+     */
+    size_t peak_queued_bytes;
+
     /**
      * Indicate that samples are skipped
      */
@@ -160,6 +181,22 @@ static inline size_t ff_framequeue_queued_frames(const FFFrameQueue *fq)
     return fq->queued;
 }
 
+/**
+ * Get the total size of the frame data currently in the queue.
+ */
+static inline size_t ff_framequeue_queued_bytes(const FFFrameQueue *fq)
+{
+    return fq->queued_bytes;
+}
+
+/**
+ * Get the largest total size of the frame data ever in the queue.
+ */
+static inline size_t ff_framequeue_peak_queued_bytes(const FFFrameQueue *fq)
+{
+    return fq->peak_queued_bytes;
+}
+
 /**
  * Get the number of queued samples.
  */
@@ -439,6 +439,10 @@ int ff_framesync_dualinput_get_writable(FFFrameSync *fs, AVFrame **f0, AVFrame *
     ret = ff_framesync_dualinput_get(fs, f0, f1);
     if (ret < 0)
         return ret;
+    /* Without a second frame the caller passes the main frame through
+     * untouched; do not force a full copy of a shared frame then. */
+    if (!*f1)
+        return 0;
     ret = ff_inlink_make_frame_writable(fs->parent->inputs[0], f0);
     if (ret < 0) {
         av_frame_free(f0);
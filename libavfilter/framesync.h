@@ -314,6 +314,8 @@ int ff_framesync_dualinput_get(FFFrameSync *fs, AVFrame **f0, AVFrame **f1);
 
 /**
  * Same as ff_framesync_dualinput_get(), but make sure that f0 is writable.
+ * When no second frame is available (f1 is NULL), f0 is left as is, since
+ * callers pass it through unmodified in that case.
  */
 int ff_framesync_dualinput_get_writable(FFFrameSync *fs, AVFrame **f0, AVFrame **f1);
 
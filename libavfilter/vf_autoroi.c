@@ -0,0 +1,322 @@
+/*
+ * This file is part of Librempeg
+ *
+ * Librempeg is free software; you can redistribute it and/or modify
+ * it under the terms of the GNU General Public License as published by
+ * the Free Software Foundation; either version 3 of the License, or
+ * (at your option) any later version.
+ *
+ * Librempeg is distributed in the hope that it will be useful,
+ * but WITHOUT ANY WARRANTY; without even the implied warranty of
+ * MERCHANTABILITY or FITNESS FOR A PARTICULAR PURPOSE.  See the
+ * GNU General Public License for more details.
+ *
+ * You should have received a copy of the GNU General Public License along
+ * with Librempeg; if not, write to the Free Software Foundation, Inc.,
+ * 51 Franklin Street, Fifth Floor, Boston, MA 02110-1301 USA.
+ */
+
+/**
+ * @file
+ * Generate regions of interest from block activity.
+ *
+ * The luma plane is split into blocks; for each block a spatial activity
+ * measure (variance) and a temporal one (SAD against the previous frame)
+ * are combined into a score, which is mapped to a quantisation offset:
+ * busy or moving blocks are favoured, flat static ones give bits back.
+ * The result is attached as AV_FRAME_DATA_REGIONS_OF_INTEREST for ROI
+ * capable encoders downstream.
+ */
+
+#include "libavutil/intreadwrite.h"
+#include "libavutil/mem.h"
+#include "libavutil/opt.h"
+#include "libavutil/pixdesc.h"
+
+#include "avfilter.h"
+#include "filters.h"
+#include "scene_sad.h"
+#include "video.h"
+
+typedef struct AutoROIContext {
+    const AVClass *class;
+
+    int block_size;
+    int nb_levels;
+    double temporal;
+    AVRational qoffset_min;
+    AVRational qoffset_max;
+
+    int depth;
+    int nb_bw, nb_bh;
+    double *scores;
+    uint8_t *levels;
+    ff_scene_sad_fn sad;
+    AVFrame *prev;
+} AutoROIContext;
+
+typedef struct ThreadData {
+    const AVFrame *cur;
+    const AVFrame *prev;
+} ThreadData;
+
+static int config_input(AVFilterLink *inlink)
+{
+    AVFilterContext *avctx = inlink->dst;
+    AutoROIContext     *s  = avctx->priv;
+    const AVPixFmtDescriptor *desc = av_pix_fmt_desc_get(inlink->format);
+
+    s->depth = desc->comp[0].depth;
+    s->nb_bw = (inlink->w + s->block_size - 1) / s->block_size;
+    s->nb_bh = (inlink->h + s->block_size - 1) / s->block_size;
+
+    s->sad = ff_scene_sad_get_fn(s->depth <= 8 ? 8 : 16);
+    if (!s->sad)
+        return AVERROR(EINVAL);
+
+    av_freep(&s->scores);
+    av_freep(&s->levels);
+    s->scores = av_calloc(s->nb_bw * s->nb_bh, sizeof(*s->scores));
+    s->levels = av_calloc(s->nb_bw * s->nb_bh, sizeof(*s->levels));
+    if (!s->scores || !s->levels)
+        return AVERROR(ENOMEM);
+
+    av_frame_free(&s->prev);
+
+    return 0;
+}
+
+static int analyze_slice(AVFilterContext *avctx, void *arg,
+                         int jobnr, int nb_jobs)
+{
+    AutoROIContext *s = avctx->priv;
+    const ThreadData *td = arg;
+    const AVFrame *cur  = td->cur;
+    const AVFrame *prev = td->prev;
+    const int bs    = s->block_size;
+    const int start = (s->nb_bh *  jobnr)      / nb_jobs;
+    const int end   = (s->nb_bh * (jobnr + 1)) / nb_jobs;
+    const int step  = s->depth <= 8 ? 1 : 2;
+    const double scale = 1.0 / ((1 << s->depth) - 1);
+
+    for (int by = start; by < end; by++) {
+        const int y  = by * bs;
+        const int bh = FFMIN(bs, cur->height - y);
+
+        for (int bx = 0; bx < s->nb_bw; bx++) {
+            const int x  = bx * bs;
+            const int bw = FFMIN(bs, cur->width - x);
+            const uint8_t *src = cur->data[0] + y * cur->linesize[0] + step * x;
+            const double nb_pixels = bw * bh;
+            int64_t sum = 0, sum2 = 0;
+            double mean, var, score;
+
+            if (step == 1) {
+                for (int j = 0; j < bh; j++) {
+                    for (int i = 0; i < bw; i++) {
+                        int v = src[i];
+                        sum  += v;
+                        sum2 += v * v;
+                    }
+                    src += cur->linesize[0];
+                }
+            } else {
+                for (int j = 0; j < bh; j++) {
+                    for (int i = 0; i < bw; i++) {
+                        int v = AV_RN16(src + 2 * i);
+                        sum  += v;
+                        sum2 += (int64_t)v * v;
+                    }
+                    src += cur->linesize[0];
+                }
+            }
+            mean  = sum / nb_pixels;
+            var   = sum2 / nb_pixels - mean * mean;
+            score = sqrt(FFMAX(var, 0.0)) * scale;
+
+            if (prev) {
+                uint64_t sad;
+
+                s->sad(cur->data[0]  + y * cur->linesize[0]  + step * x,
+                       cur->linesize[0],
+                       prev->data[0] + y * prev->linesize[0] + step * x,
+                       prev->linesize[0],
+                       bw, bh, &sad);
+                score += s->temporal * (sad / nb_pixels) * scale;
+            }
+
+            s->scores[by * s->nb_bw + bx] = score;
+        }
+    }
+
+    return 0;
+}
+
+static int set_roi_side_data(AutoROIContext *s, AVFrame *frame)
+{
+    const double qmin = av_q2d(s->qoffset_min);
+    const double qmax = av_q2d(s->qoffset_max);
+    const int bs = s->block_size;
+    double score_min = s->scores[0], score_max = s->scores[0];
+    AVRegionOfInterest *roi;
+    AVBufferRef *roi_ref;
+    AVFrameSideData *sd;
+    int nb_roi = 0;
+
+    for (int i = 1; i < s->nb_bw * s->nb_bh; i++) {
+        score_min = FFMIN(score_min, s->scores[i]);
+        score_max = FFMAX(score_max, s->scores[i]);
+    }
+    /* uniform frame, no information to act on */
+    if (score_max - score_min < 1e-6)
+        return 0;
+
+    /* quantize the scores so that runs of equal offsets can be merged */
+    for (int i = 0; i < s->nb_bw * s->nb_bh; i++)
+        s->levels[i] = lrint((s->scores[i] - score_min) /
+                             (score_max - score_min) * (s->nb_levels - 1));
+
+    for (int by = 0; by < s->nb_bh; by++)
+        for (int bx = 0; bx < s->nb_bw; bx++)
+            if (!bx || s->levels[by * s->nb_bw + bx] !=
+                       s->levels[by * s->nb_bw + bx - 1])
+                nb_roi++;
+
+    roi_ref = av_buffer_alloc(nb_roi * sizeof(*roi));
+    if (!roi_ref)
+        return AVERROR(ENOMEM);
+    roi = (AVRegionOfInterest *)roi_ref->data;
+
+    for (int by = 0; by < s->nb_bh; by++) {
+        for (int bx = 0; bx < s->nb_bw;) {
+            const int level = s->levels[by * s->nb_bw + bx];
+            int run = 1;
+
+            while (bx + run < s->nb_bw &&
+                   s->levels[by * s->nb_bw + bx + run] == level)
+                run++;
+
+            *roi++ = (AVRegionOfInterest) {
+                .self_size = sizeof(*roi),
+                .top       = by * bs,
+                .bottom    = FFMIN((by + 1) * bs, frame->height),
+                .left      = bx * bs,
+                .right     = FFMIN((bx + run) * bs, frame->width),
+                /* busiest blocks get qoffset_min, flattest qoffset_max */
+                .qoffset   = av_d2q(qmax + (qmin - qmax) * level /
+                                    (s->nb_levels - 1), 1 << 8),
+            };
+            bx += run;
+        }
+    }
+
+    av_frame_remove_side_data(frame, AV_FRAME_DATA_REGIONS_OF_INTEREST);
+    sd = av_frame_new_side_data_from_buf(frame,
+                                         AV_FRAME_DATA_REGIONS_OF_INTEREST,
+                                         roi_ref);
+    if (!sd) {
+        av_buffer_unref(&roi_ref);
+        return AVERROR(ENOMEM);
+    }
+
+    return 0;
+}
+
+static int filter_frame(AVFilterLink *inlink, AVFrame *frame)
+{
+    AVFilterContext *avctx = inlink->dst;
+    AVFilterLink *outlink  = avctx->outputs[0];
+    AutoROIContext *s      = avctx->priv;
+    ThreadData td;
+    int ret;
+
+    td.cur  = frame;
+    td.prev = s->prev;
+    ff_filter_execute(avctx, analyze_slice, &td, NULL,
+                      FFMIN(s->nb_bh, ff_filter_get_nb_threads(avctx)));
+
+    ret = set_roi_side_data(s, frame);
+    if (ret < 0)
+        goto fail;
+
+    av_frame_free(&s->prev);
+    s->prev = av_frame_clone(frame);
+    if (!s->prev) {
+        ret = AVERROR(ENOMEM);
+        goto fail;
+    }
+
+    return ff_filter_frame(outlink, frame);
+
+fail:
+    av_frame_free(&frame);
+    return ret;
+}
+
+static av_cold void uninit(AVFilterContext *avctx)
+{
+    AutoROIContext *s = avctx->priv;
+
+    av_frame_free(&s->prev);
+    av_freep(&s->scores);
+    av_freep(&s->levels);
+}
+
+static const enum AVPixelFormat pix_fmts[] = {
+    AV_PIX_FMT_GRAY8,
+    AV_PIX_FMT_YUV410P, AV_PIX_FMT_YUV411P,
+    AV_PIX_FMT_YUV420P, AV_PIX_FMT_YUVJ420P,
+    AV_PIX_FMT_YUV422P, AV_PIX_FMT_YUVJ422P,
+    AV_PIX_FMT_YUV440P, AV_PIX_FMT_YUVJ440P,
+    AV_PIX_FMT_YUV444P, AV_PIX_FMT_YUVJ444P,
+    AV_PIX_FMT_YUV420P9,  AV_PIX_FMT_YUV422P9,  AV_PIX_FMT_YUV444P9,
+    AV_PIX_FMT_YUV420P10, AV_PIX_FMT_YUV422P10, AV_PIX_FMT_YUV444P10,
+    AV_PIX_FMT_YUV420P12, AV_PIX_FMT_YUV422P12, AV_PIX_FMT_YUV444P12,
+    AV_PIX_FMT_NONE
+};
+
+#define OFFSET(x) offsetof(AutoROIContext, x)
+#define FLAGS AV_OPT_FLAG_VIDEO_PARAM | AV_OPT_FLAG_FILTERING_PARAM
+static const AVOption autoroi_options[] = {
+    { "block", "Analysis block size.",
+      OFFSET(block_size), AV_OPT_TYPE_INT, { .i64 = 32 }, 8, 256, FLAGS },
+
+    { "qmin", "Quantisation offset for the most active blocks.",
+      OFFSET(qoffset_min), AV_OPT_TYPE_RATIONAL, { .dbl = -0.2 }, -1, +1, FLAGS },
+    { "qmax", "Quantisation offset for the least active blocks.",
+      OFFSET(qoffset_max), AV_OPT_TYPE_RATIONAL, { .dbl = +0.2 }, -1, +1, FLAGS },
+
+    { "temporal", "Weight of the temporal activity in the block score.",
+      OFFSET(temporal), AV_OPT_TYPE_DOUBLE, { .dbl = 2.0 }, 0, 10, FLAGS },
+
+    { "levels", "Number of distinct quantisation offsets to use.",
+      OFFSET(nb_levels), AV_OPT_TYPE_INT, { .i64 = 8 }, 2, 32, FLAGS },
+
+    { NULL }
+};
+
+AVFILTER_DEFINE_CLASS(autoroi);
+
+static const AVFilterPad autoroi_inputs[] = {
+    {
+        .name         = "default",
+        .type         = AVMEDIA_TYPE_VIDEO,
+        .config_props = config_input,
+        .filter_frame = filter_frame,
+    },
+};
+
+const FFFilter ff_vf_autoroi = {
+    .p.name        = "autoroi",
+    .p.description = NULL_IF_CONFIG_SMALL("Generate regions of interest from block activity."),
+    .p.priv_class  = &autoroi_class,
+    .p.flags       = AVFILTER_FLAG_SLICE_THREADS,
+
+    .uninit        = uninit,
+
+    .priv_size     = sizeof(AutoROIContext),
+
+    FILTER_INPUTS(autoroi_inputs),
+    FILTER_OUTPUTS(ff_video_default_filterpad),
+    FILTER_PIXFMTS_ARRAY(pix_fmts),
+};
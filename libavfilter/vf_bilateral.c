@@ -498,7 +498,8 @@ const FFFilter ff_vf_bilateral = {
     .p.description = NULL_IF_CONFIG_SMALL("Apply Bilateral filter."),
     .p.priv_class  = &bilateral_class,
     .p.flags       = AVFILTER_FLAG_SUPPORT_TIMELINE_GENERIC |
-                     AVFILTER_FLAG_SLICE_THREADS,
+                     AVFILTER_FLAG_SLICE_THREADS |
+                     AVFILTER_FLAG_FRAME_THREADS,
     .priv_size     = sizeof(BilateralContext),
     .uninit        = uninit,
     FILTER_INPUTS(bilateral_inputs),
@@ -81,6 +81,7 @@ typedef struct CropContext {
     AVRational out_sar; ///< output sample aspect ratio
     int keep_aspect;    ///< keep display aspect ratio when cropping
     int exact;          ///< exact cropping, for subsampled formats
+    int metadata;       ///< set only the cropping fields, keep frame data untouched
 
     int max_step[4];    ///< max pixel step for each plane, expressed as a number of bytes
     int hsub, vsub;     ///< chroma subsampling
@@ -235,9 +236,9 @@ static int config_output(AVFilterLink *link)
     CropContext *s = link->src->priv;
     const AVPixFmtDescriptor *desc = av_pix_fmt_desc_get(link->format);
 
-    if (desc->flags & AV_PIX_FMT_FLAG_HWACCEL) {
-        // Hardware frames adjust the cropping regions rather than
-        // changing the frame size.
+    if (desc->flags & AV_PIX_FMT_FLAG_HWACCEL || s->metadata) {
+        // Hardware frames and metadata-only cropping adjust the cropping
+        // regions rather than changing the frame size.
     } else {
         link->w = s->w;
         link->h = s->h;
@@ -283,7 +284,7 @@ static int filter_frame(AVFilterLink *link, AVFrame *frame)
             (int)s->var_values[VAR_N], s->var_values[VAR_T],
             s->x, s->y, s->x+s->w, s->y+s->h);
 
-    if (desc->flags & AV_PIX_FMT_FLAG_HWACCEL) {
+    if (desc->flags & AV_PIX_FMT_FLAG_HWACCEL || s->metadata) {
         frame->crop_top   += s->y;
         frame->crop_left  += s->x;
         frame->crop_bottom = frame->height - frame->crop_top - frame->crop_bottom - s->h;
@@ -362,6 +363,7 @@ static const AVOption crop_options[] = {
     { "y",           "set the y crop area expression",       OFFSET(y_expr), AV_OPT_TYPE_STRING, {.str = "(in_h-out_h)/2"}, 0, 0, TFLAGS },
     { "keep_aspect", "keep aspect ratio",                    OFFSET(keep_aspect), AV_OPT_TYPE_BOOL, {.i64=0}, 0, 1, FLAGS },
     { "exact",       "do exact cropping",                    OFFSET(exact),  AV_OPT_TYPE_BOOL, {.i64=0}, 0, 1, FLAGS },
+    { "metadata",    "set only cropping metadata, keep frame data untouched", OFFSET(metadata), AV_OPT_TYPE_BOOL, {.i64=0}, 0, 1, FLAGS },
     { NULL }
 };
 
@@ -816,7 +816,8 @@ const FFFilter ff_vf_dctdnoiz = {
     .p.name        = "dctdnoiz",
     .p.description = NULL_IF_CONFIG_SMALL("Denoise frames using 2D DCT."),
     .p.priv_class  = &dctdnoiz_class,
-    .p.flags       = AVFILTER_FLAG_SUPPORT_TIMELINE_GENERIC | AVFILTER_FLAG_SLICE_THREADS,
+    .p.flags       = AVFILTER_FLAG_SUPPORT_TIMELINE_GENERIC | AVFILTER_FLAG_SLICE_THREADS |
+                     AVFILTER_FLAG_FRAME_THREADS,
     .priv_size     = sizeof(DCTdnoizContext),
     .init          = init,
     .uninit        = uninit,
@@ -0,0 +1,223 @@
+/*
+ * This file is part of Librempeg
+ *
+ * Librempeg is free software; you can redistribute it and/or modify
+ * it under the terms of the GNU General Public License as published by
+ * the Free Software Foundation; either version 3 of the License, or
+ * (at your option) any later version.
+ *
+ * Librempeg is distributed in the hope that it will be useful,
+ * but WITHOUT ANY WARRANTY; without even the implied warranty of
+ * MERCHANTABILITY or FITNESS FOR A PARTICULAR PURPOSE.  See the
+ * GNU General Public License for more details.
+ *
+ * You should have received a copy of the GNU General Public License along
+ * with Librempeg; if not, write to the Free Software Foundation, Inc.,
+ * 51 Franklin Street, Fifth Floor, Boston, MA 02110-1301 USA.
+ */
+
+/**
+ * @file
+ * exact duplicate frame elimination filter
+ */
+
+#include "libavutil/imgutils.h"
+#include "libavutil/murmur3.h"
+#include "libavutil/mem.h"
+#include "libavutil/opt.h"
+#include "libavutil/pixdesc.h"
+
+#include "avfilter.h"
+#include "filters.h"
+#include "video.h"
+
+#define HASH_SIZE 16
+
+enum DedupMode {
+    MODE_DROP,
+    MODE_MARK,
+    MODE_NB
+};
+
+typedef struct DedupContext {
+    const AVClass *class;
+
+    int mode;
+
+    ptrdiff_t width[4];          ///< bytes to hash per row, per plane
+    int height[4];
+
+    int nb_jobs;
+    struct AVMurMur3 **hctx;     ///< one hash context per job
+    uint8_t *hashes;             ///< HASH_SIZE bytes per job, current frame
+    uint8_t *prev_hashes;        ///< HASH_SIZE bytes per job, previous frame
+    int have_prev;
+
+    int64_t nb_frames;
+    int64_t nb_dups;
+
+    AVFrame *cur;                ///< frame being hashed by the slice jobs
+} DedupContext;
+
+#define OFFSET(x) offsetof(DedupContext, x)
+#define V AV_OPT_FLAG_VIDEO_PARAM
+#define F AV_OPT_FLAG_FILTERING_PARAM
+
+static const AVOption dedup_options[] = {
+    { "mode", "set how duplicate frames are handled", OFFSET(mode), AV_OPT_TYPE_INT, {.i64=MODE_DROP}, 0, MODE_NB-1, V|F, .unit = "mode" },
+    {   "drop", "drop exact duplicates",                       0, AV_OPT_TYPE_CONST, {.i64=MODE_DROP}, 0, 0, V|F, .unit = "mode" },
+    {   "mark", "pass duplicates tagged with frame metadata",  0, AV_OPT_TYPE_CONST, {.i64=MODE_MARK}, 0, 0, V|F, .unit = "mode" },
+    {NULL}
+};
+
+AVFILTER_DEFINE_CLASS(dedup);
+
+static const enum AVPixelFormat pix_fmts[] = {
+    AV_PIX_FMT_YUV420P, AV_PIX_FMT_YUYV422, AV_PIX_FMT_RGB24,
+    AV_PIX_FMT_BGR24, AV_PIX_FMT_YUV422P, AV_PIX_FMT_YUV444P,
+    AV_PIX_FMT_YUV410P, AV_PIX_FMT_YUV411P, AV_PIX_FMT_GRAY8,
+    AV_PIX_FMT_YUVJ420P, AV_PIX_FMT_YUVJ422P, AV_PIX_FMT_YUVJ444P,
+    AV_PIX_FMT_UYVY422, AV_PIX_FMT_NV12, AV_PIX_FMT_NV21, AV_PIX_FMT_ARGB,
+    AV_PIX_FMT_RGBA, AV_PIX_FMT_ABGR, AV_PIX_FMT_BGRA, AV_PIX_FMT_GRAY16,
+    AV_PIX_FMT_YUV440P, AV_PIX_FMT_YUVJ440P, AV_PIX_FMT_YUVA420P,
+    AV_PIX_FMT_YUV420P16, AV_PIX_FMT_YUV422P16, AV_PIX_FMT_YUV444P16,
+    AV_PIX_FMT_YA8, AV_PIX_FMT_YUV420P9, AV_PIX_FMT_YUV420P10,
+    AV_PIX_FMT_YUV422P10, AV_PIX_FMT_YUV444P9, AV_PIX_FMT_YUV444P10,
+    AV_PIX_FMT_YUV422P9, AV_PIX_FMT_GBRP, AV_PIX_FMT_GBRP9,
+    AV_PIX_FMT_GBRP10, AV_PIX_FMT_GBRP16, AV_PIX_FMT_YUVA422P,
+    AV_PIX_FMT_YUVA444P, AV_PIX_FMT_YUVA420P9, AV_PIX_FMT_YUVA422P9,
+    AV_PIX_FMT_YUVA444P9, AV_PIX_FMT_YUVA420P10, AV_PIX_FMT_YUVA422P10,
+    AV_PIX_FMT_YUVA444P10, AV_PIX_FMT_YUVA420P16, AV_PIX_FMT_YUVA422P16,
+    AV_PIX_FMT_YUVA444P16, AV_PIX_FMT_NV16, AV_PIX_FMT_YVYU422,
+    AV_PIX_FMT_GBRAP, AV_PIX_FMT_GBRAP16, AV_PIX_FMT_YUV420P12,
+    AV_PIX_FMT_YUV420P14, AV_PIX_FMT_YUV422P12, AV_PIX_FMT_YUV422P14,
+    AV_PIX_FMT_YUV444P12, AV_PIX_FMT_YUV444P14, AV_PIX_FMT_GBRP12,
+    AV_PIX_FMT_GBRP14, AV_PIX_FMT_YUVJ411P, AV_PIX_FMT_YUV440P10,
+    AV_PIX_FMT_YUV440P12, AV_PIX_FMT_GBRAP12, AV_PIX_FMT_GBRAP10,
+    AV_PIX_FMT_GRAY12, AV_PIX_FMT_GRAY10, AV_PIX_FMT_GRAY9,
+    AV_PIX_FMT_GRAY14,
+    AV_PIX_FMT_NONE
+};
+
+static int hash_frame_slice(AVFilterContext *ctx, void *arg, int jobnr, int nb_jobs)
+{
+    DedupContext *s = ctx->priv;
+    const AVFrame *frame = s->cur;
+    struct AVMurMur3 *h = s->hctx[jobnr];
+
+    av_murmur3_init(h);
+    for (int plane = 0; plane < 4; plane++) {
+        const ptrdiff_t width = s->width[plane];
+        const int height = s->height[plane];
+        const int slice_start = (height * jobnr) / nb_jobs;
+        const int slice_end = (height * (jobnr + 1)) / nb_jobs;
+        const uint8_t *src = frame->data[plane] +
+            slice_start * (ptrdiff_t)frame->linesize[plane];
+
+        if (!width)
+            continue;
+        for (int y = slice_start; y < slice_end; y++) {
+            av_murmur3_update(h, src, width);
+            src += frame->linesize[plane];
+        }
+    }
+    av_murmur3_final(h, s->hashes + HASH_SIZE * jobnr);
+
+    return 0;
+}
+
+static int config_input(AVFilterLink *inlink)
+{
+    AVFilterContext *ctx = inlink->dst;
+    DedupContext *s = ctx->priv;
+    const AVPixFmtDescriptor *pix_desc = av_pix_fmt_desc_get(inlink->format);
+
+    for (int plane = 0; plane < 4; plane++) {
+        ptrdiff_t line_size = av_image_get_linesize(inlink->format, inlink->w, plane);
+        s->width[plane] = FFMAX(line_size, 0);
+        s->height[plane] = inlink->h >> ((plane == 1 || plane == 2) ? pix_desc->log2_chroma_h : 0);
+    }
+
+    s->nb_jobs = FFMIN(ff_filter_get_nb_threads(ctx), FFMAX(inlink->h / 16, 1));
+    s->hctx = av_calloc(s->nb_jobs, sizeof(*s->hctx));
+    s->hashes = av_calloc(s->nb_jobs, HASH_SIZE);
+    s->prev_hashes = av_calloc(s->nb_jobs, HASH_SIZE);
+    if (!s->hctx || !s->hashes || !s->prev_hashes)
+        return AVERROR(ENOMEM);
+    for (int i = 0; i < s->nb_jobs; i++) {
+        s->hctx[i] = av_murmur3_alloc();
+        if (!s->hctx[i])
+            return AVERROR(ENOMEM);
+    }
+
+    return 0;
+}
+
+static int filter_frame(AVFilterLink *inlink, AVFrame *in)
+{
+    AVFilterContext *ctx = inlink->dst;
+    AVFilterLink *outlink = ctx->outputs[0];
+    DedupContext *s = ctx->priv;
+    int dup;
+
+    s->cur = in;
+    ff_filter_execute(ctx, hash_frame_slice, NULL, NULL, s->nb_jobs);
+    s->cur = NULL;
+
+    dup = s->have_prev &&
+          !memcmp(s->hashes, s->prev_hashes, s->nb_jobs * HASH_SIZE);
+    FFSWAP(uint8_t *, s->hashes, s->prev_hashes);
+    s->have_prev = 1;
+    s->nb_frames++;
+
+    if (dup) {
+        s->nb_dups++;
+        if (s->mode == MODE_MARK) {
+            av_dict_set(&in->metadata, "lavfi.dedup.duplicate", "1", 0);
+            return ff_filter_frame(outlink, in);
+        }
+        av_log(ctx, AV_LOG_DEBUG, "dropping duplicate frame %"PRId64"\n",
+               s->nb_frames - 1);
+        av_frame_free(&in);
+        return 0;
+    }
+
+    return ff_filter_frame(outlink, in);
+}
+
+static av_cold void uninit(AVFilterContext *ctx)
+{
+    DedupContext *s = ctx->priv;
+
+    if (s->nb_frames)
+        av_log(ctx, AV_LOG_VERBOSE, "%"PRId64" of %"PRId64" frames were exact duplicates\n",
+               s->nb_dups, s->nb_frames);
+
+    if (s->hctx)
+        for (int i = 0; i < s->nb_jobs; i++)
+            av_freep(&s->hctx[i]);
+    av_freep(&s->hctx);
+    av_freep(&s->hashes);
+    av_freep(&s->prev_hashes);
+}
+
+static const AVFilterPad dedup_inputs[] = {
+    {
+        .name         = "default",
+        .type         = AVMEDIA_TYPE_VIDEO,
+        .config_props = config_input,
+        .filter_frame = filter_frame,
+    },
+};
+
+const FFFilter ff_vf_dedup = {
+    .p.name        = "dedup",
+    .p.description = NULL_IF_CONFIG_SMALL("Drop or tag exact duplicate frames."),
+    .p.priv_class  = &dedup_class,
+    .p.flags       = AVFILTER_FLAG_SLICE_THREADS,
+    .priv_size     = sizeof(DedupContext),
+    .uninit        = uninit,
+    FILTER_INPUTS(dedup_inputs),
+    FILTER_OUTPUTS(ff_video_default_filterpad),
+    FILTER_PIXFMTS_ARRAY(pix_fmts),
+};
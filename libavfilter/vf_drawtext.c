@@ -315,8 +315,14 @@ typedef struct DrawTextContext {
     int tab_count;                  ///< the number of tab characters
     int blank_advance64;            ///< the size of the space character
     int tab_warning_printed;        ///< ensure the tab warning to be printed only once
+
+    AVBPrint shaped_text;           ///< the text that the cached lines were shaped for
+    unsigned int shaped_fontsize;   ///< the fontsize that the cached lines were shaped with
+    TextMetrics shaped_metrics;     ///< text metrics of the cached lines
 } DrawTextContext;
 
+static void free_shaped_lines(DrawTextContext *s);
+
 #define OFFSET(x) offsetof(DrawTextContext, x)
 #define FLAGS AV_OPT_FLAG_FILTERING_PARAM|AV_OPT_FLAG_VIDEO_PARAM
 #define TFLAGS AV_OPT_FLAG_FILTERING_PARAM|AV_OPT_FLAG_VIDEO_PARAM|AV_OPT_FLAG_RUNTIME_PARAM
@@ -1068,6 +1074,7 @@ static av_cold int init(AVFilterContext *ctx)
 
     av_bprint_init(&s->expanded_text, 0, AV_BPRINT_SIZE_UNLIMITED);
     av_bprint_init(&s->expanded_fontcolor, 0, AV_BPRINT_SIZE_UNLIMITED);
+    av_bprint_init(&s->shaped_text, 0, AV_BPRINT_SIZE_UNLIMITED);
 
     return 0;
 }
@@ -1134,8 +1141,11 @@ static av_cold void uninit(AVFilterContext *ctx)
     FT_Stroker_Done(s->stroker);
     FT_Done_FreeType(s->library);
 
+    free_shaped_lines(s);
+
     av_bprint_finalize(&s->expanded_text, NULL);
     av_bprint_finalize(&s->expanded_fontcolor, NULL);
+    av_bprint_finalize(&s->shaped_text, NULL);
 }
 
 static int config_input(AVFilterLink *inlink)
@@ -1145,6 +1155,9 @@ static int config_input(AVFilterLink *inlink)
     char *expr;
     int ret;
 
+    /* shaping-relevant options may have changed (e.g. via a command) */
+    free_shaped_lines(s);
+
     ret = ff_draw_init_from_link(&s->dc, inlink, FF_DRAW_PROCESS_ALPHA);
     if (ret < 0)
         return ret;
@@ -1393,6 +1406,18 @@ static void hb_destroy(HarfbuzzData *hb)
     hb->glyph_pos = NULL;
 }
 
+static void free_shaped_lines(DrawTextContext *s)
+{
+    for (int l = 0; l < s->line_count; ++l) {
+        TextLine *line = &s->lines[l];
+        av_freep(&line->glyphs);
+        hb_destroy(&line->hb_data);
+    }
+    av_freep(&s->lines);
+    av_freep(&s->tab_clusters);
+    s->line_count = 0;
+}
+
 static int measure_text(AVFilterContext *ctx, TextMetrics *metrics)
 {
     DrawTextContext *s = ctx->priv;
@@ -1436,6 +1461,7 @@ continue_on_failed:
         hb_destroy(&hb_data);
     }
 
+    free_shaped_lines(s);
     s->line_count = line_count;
     s->lines = av_mallocz(line_count * sizeof(TextLine));
     s->tab_clusters = av_mallocz(s->tab_count * sizeof(uint32_t));
@@ -1624,8 +1650,23 @@ static int draw_text(AVFilterContext *ctx, AVFrame *frame)
         return ret;
     }
 
-    if ((ret = measure_text(ctx, &metrics)) < 0) {
-        return ret;
+    /* Shaping and measuring only depend on the text and the fontsize, so the
+     * cached result can be reused as long as neither changed; this turns the
+     * per-frame cost for static text into mere glyph-cache blits. */
+    if (s->lines && s->fontsize == s->shaped_fontsize &&
+        !strcmp(s->shaped_text.str, s->expanded_text.str)) {
+        metrics = s->shaped_metrics;
+    } else {
+        if ((ret = measure_text(ctx, &metrics)) < 0) {
+            free_shaped_lines(s);
+            return ret;
+        }
+        av_bprint_clear(&s->shaped_text);
+        av_bprintf(&s->shaped_text, "%s", s->expanded_text.str);
+        if (!av_bprint_is_complete(&s->shaped_text))
+            return AVERROR(ENOMEM);
+        s->shaped_fontsize = s->fontsize;
+        s->shaped_metrics  = metrics;
     }
 
     s->max_glyph_h = POS_CEIL(metrics.max_y64 - metrics.min_y64, 64);
@@ -1720,7 +1761,11 @@ static int draw_text(AVFilterContext *ctx, AVFrame *frame)
     for (int l = 0; l < s->line_count; ++l) {
         TextLine *line = &s->lines[l];
         HarfbuzzData *hb = &line->hb_data;
-        line->glyphs = av_mallocz(hb->glyph_count * sizeof(GlyphInfo));
+        if (!line->glyphs) {
+            line->glyphs = av_mallocz(hb->glyph_count * sizeof(GlyphInfo));
+            if (!line->glyphs)
+                return AVERROR(ENOMEM);
+        }
 
         for (int t = 0; t < hb->glyph_count; ++t) {
             GlyphInfo *g_info = &line->glyphs[t];
@@ -1816,15 +1861,6 @@ static int draw_text(AVFilterContext *ctx, AVFrame *frame)
         }
     }
 
-    // FREE data structures
-    for (int l = 0; l < s->line_count; ++l) {
-        TextLine *line = &s->lines[l];
-        av_freep(&line->glyphs);
-        hb_destroy(&line->hb_data);
-    }
-    av_freep(&s->lines);
-    av_freep(&s->tab_clusters);
-
     return 0;
 }
 
@@ -53,6 +53,7 @@ typedef struct HistogramContext {
     int            display_mode;
     int            colors_mode;
     int            levels_mode;
+    int            subsample;
     const AVPixFmtDescriptor *desc, *odesc;
     int            components;
     float          fgopacity;
@@ -77,7 +78,9 @@ typedef struct HistogramContext {
         { "linear",      NULL, 0, AV_OPT_TYPE_CONST, {.i64=0}, 0, 0, FLAGS, .unit = "levels_mode" }, \
         { "logarithmic", NULL, 0, AV_OPT_TYPE_CONST, {.i64=1}, 0, 0, FLAGS, .unit = "levels_mode" }, \
     { "components", "set color components to display", OFFSET(components), AV_OPT_TYPE_INT, {.i64=7}, 1, 15, FLAGS}, \
-    { "c",          "set color components to display", OFFSET(components), AV_OPT_TYPE_INT, {.i64=7}, 1, 15, FLAGS},
+    { "c",          "set color components to display", OFFSET(components), AV_OPT_TYPE_INT, {.i64=7}, 1, 15, FLAGS}, \
+    { "subsample", "set pixel subsampling step", OFFSET(subsample), AV_OPT_TYPE_INT, {.i64=1}, 1, 64, FLAGS}, \
+    { "u",         "set pixel subsampling step", OFFSET(subsample), AV_OPT_TYPE_INT, {.i64=1}, 1, 64, FLAGS},
 
 static const AVOption histogram_options[] = {
     { "level_height", "set level height", OFFSET(level_height), AV_OPT_TYPE_INT, {.i64=200}, 50, 2048, FLAGS},
@@ -403,15 +406,15 @@ static int filter_frame(AVFilterLink *inlink, AVFrame *in)
         }
 
         if (s->histogram_size <= 256) {
-            for (i = 0; i < height; i++) {
+            for (i = 0; i < height; i += s->subsample) {
                 const uint8_t *src = in->data[p] + i * in->linesize[p];
-                for (j = 0; j < width; j++)
+                for (j = 0; j < width; j += s->subsample)
                     s->histogram[src[j]]++;
             }
         } else {
-            for (i = 0; i < height; i++) {
+            for (i = 0; i < height; i += s->subsample) {
                 const uint16_t *src = (const uint16_t *)(in->data[p] + i * in->linesize[p]);
-                for (j = 0; j < width; j++)
+                for (j = 0; j < width; j += s->subsample)
                     s->histogram[src[j]]++;
             }
         }
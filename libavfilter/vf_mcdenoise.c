@@ -0,0 +1,346 @@
+/*
+ * This file is part of Librempeg
+ *
+ * Librempeg is free software; you can redistribute it and/or modify
+ * it under the terms of the GNU General Public License as published by
+ * the Free Software Foundation; either version 3 of the License, or
+ * (at your option) any later version.
+ *
+ * Librempeg is distributed in the hope that it will be useful,
+ * but WITHOUT ANY WARRANTY; without even the implied warranty of
+ * MERCHANTABILITY or FITNESS FOR A PARTICULAR PURPOSE.  See the
+ * GNU General Public License for more details.
+ *
+ * You should have received a copy of the GNU General Public License along
+ * with Librempeg; if not, write to the Free Software Foundation, Inc.,
+ * 51 Franklin Street, Fifth Floor, Boston, MA 02110-1301 USA.
+ */
+
+/**
+ * @file
+ * Motion-compensated temporal denoise filter.
+ *
+ * Each macroblock of the current frame is matched against the previous
+ * output frame using the shared block motion estimation, then blended
+ * with the motion-compensated reference.  The blend weight falls off
+ * with the residual SAD of the match so that badly predicted blocks
+ * (occlusions, scene changes) pass through unfiltered, and a per-pixel
+ * guard keeps detail that differs strongly from the reference.
+ */
+
+#include "libavutil/common.h"
+#include "libavutil/internal.h"
+#include "libavutil/opt.h"
+#include "libavutil/pixdesc.h"
+#include "avfilter.h"
+#include "filters.h"
+#include "motion_estimation.h"
+#include "video.h"
+
+typedef struct MCDenoiseContext {
+    const AVClass *class;
+
+    double sigma;
+    int mb_size;
+    int search_param;
+    int me_method;
+
+    int log2_mb_size;
+    int log2_chroma_w;
+    int log2_chroma_h;
+    int nb_planes;
+    int b_width;
+    int b_height;
+    int thr;            ///< block SAD at which the blend weight reaches zero
+    int guard;          ///< per-pixel difference above which pixels pass through
+
+    AVMotionEstContext me_ctx;
+    uint64_t (*search)(AVMotionEstContext *me_ctx, int x_mb, int y_mb, int *mv);
+
+    AVFrame *prev;      ///< previous output frame, used as reference
+} MCDenoiseContext;
+
+#define OFFSET(x) offsetof(MCDenoiseContext, x)
+#define FLAGS AV_OPT_FLAG_VIDEO_PARAM|AV_OPT_FLAG_FILTERING_PARAM
+#define CONST(name, help, val, u) { name, help, 0, AV_OPT_TYPE_CONST, {.i64=val}, 0, 0, FLAGS, .unit = u }
+
+static const AVOption mcdenoise_options[] = {
+    { "sigma", "denoising strength", OFFSET(sigma), AV_OPT_TYPE_DOUBLE, {.dbl = 6.}, 1, 64, FLAGS },
+    { "mb_size", "macroblock size", OFFSET(mb_size), AV_OPT_TYPE_INT, {.i64 = 16}, 4, 16, FLAGS },
+    { "search_param", "motion search parameter", OFFSET(search_param), AV_OPT_TYPE_INT, {.i64 = 16}, 4, INT_MAX, FLAGS },
+    { "me", "motion estimation method", OFFSET(me_method), AV_OPT_TYPE_INT, {.i64 = AV_ME_METHOD_HEXBS}, AV_ME_METHOD_ESA, AV_ME_METHOD_HEXBS, FLAGS, .unit = "me" },
+        CONST("esa",    "exhaustive search",                  AV_ME_METHOD_ESA,   "me"),
+        CONST("tss",    "three step search",                  AV_ME_METHOD_TSS,   "me"),
+        CONST("tdls",   "two dimensional logarithmic search", AV_ME_METHOD_TDLS,  "me"),
+        CONST("ntss",   "new three step search",              AV_ME_METHOD_NTSS,  "me"),
+        CONST("fss",    "four step search",                   AV_ME_METHOD_FSS,   "me"),
+        CONST("ds",     "diamond search",                     AV_ME_METHOD_DS,    "me"),
+        CONST("hexbs",  "hexagon-based search",               AV_ME_METHOD_HEXBS, "me"),
+    { NULL }
+};
+
+AVFILTER_DEFINE_CLASS(mcdenoise);
+
+static const enum AVPixelFormat pix_fmts[] = {
+    AV_PIX_FMT_YUV410P, AV_PIX_FMT_YUV411P,
+    AV_PIX_FMT_YUV420P, AV_PIX_FMT_YUV422P,
+    AV_PIX_FMT_YUV440P, AV_PIX_FMT_YUV444P,
+    AV_PIX_FMT_YUVJ444P, AV_PIX_FMT_YUVJ440P,
+    AV_PIX_FMT_YUVJ422P, AV_PIX_FMT_YUVJ420P,
+    AV_PIX_FMT_YUVJ411P,
+    AV_PIX_FMT_GRAY8,
+    AV_PIX_FMT_NONE
+};
+
+/* Current and reference frames can come from different allocators, so
+ * the single linesize in AVMotionEstContext cannot be used; carry both
+ * strides next to the context and recover them in the cost callback. */
+typedef struct MEJobContext {
+    AVMotionEstContext me_ctx;
+    ptrdiff_t cur_linesize;
+    ptrdiff_t ref_linesize;
+} MEJobContext;
+
+typedef struct ThreadData {
+    AVFrame *in, *out;
+} ThreadData;
+
+static uint64_t me_cmp_sad(AVMotionEstContext *me_ctx, int x_mb, int y_mb,
+                           int x_mv, int y_mv)
+{
+    const MEJobContext *job = (const MEJobContext *)me_ctx;
+    const uint8_t *cur = me_ctx->data_cur + y_mb * job->cur_linesize + x_mb;
+    const uint8_t *ref = me_ctx->data_ref + y_mv * job->ref_linesize + x_mv;
+    uint64_t sad = 0;
+
+    for (int j = 0; j < me_ctx->mb_size; j++) {
+        for (int i = 0; i < me_ctx->mb_size; i++)
+            sad += FFABS(ref[i] - cur[i]);
+        cur += job->cur_linesize;
+        ref += job->ref_linesize;
+    }
+
+    return sad;
+}
+
+static uint64_t block_sad(const uint8_t *cur, ptrdiff_t cur_linesize,
+                          const uint8_t *ref, ptrdiff_t ref_linesize,
+                          int w, int h)
+{
+    uint64_t sad = 0;
+
+    for (int j = 0; j < h; j++) {
+        for (int i = 0; i < w; i++)
+            sad += FFABS(ref[i] - cur[i]);
+        cur += cur_linesize;
+        ref += ref_linesize;
+    }
+
+    return sad;
+}
+
+static void blend_block(uint8_t *dst, ptrdiff_t dst_linesize,
+                        const uint8_t *cur, ptrdiff_t cur_linesize,
+                        const uint8_t *ref, ptrdiff_t ref_linesize,
+                        int w, int h, int weight, int guard)
+{
+    if (!weight) {
+        for (int j = 0; j < h; j++) {
+            memcpy(dst, cur, w);
+            dst += dst_linesize;
+            cur += cur_linesize;
+        }
+        return;
+    }
+
+    for (int j = 0; j < h; j++) {
+        for (int i = 0; i < w; i++) {
+            const int d = ref[i] - cur[i];
+
+            dst[i] = FFABS(d) > guard ? cur[i]
+                                      : cur[i] + ((weight * d + 64) >> 7);
+        }
+        dst += dst_linesize;
+        cur += cur_linesize;
+        ref += ref_linesize;
+    }
+}
+
+static int filter_slice(AVFilterContext *ctx, void *arg, int jobnr, int nb_jobs)
+{
+    MCDenoiseContext *s = ctx->priv;
+    ThreadData *td = arg;
+    AVFrame *in = td->in, *out = td->out, *prev = s->prev;
+    const int bw_all = AV_CEIL_RSHIFT(in->width,  s->log2_mb_size);
+    const int bh_all = AV_CEIL_RSHIFT(in->height, s->log2_mb_size);
+    const int mb_y_start = (bh_all *  jobnr)      / nb_jobs;
+    const int mb_y_end   = (bh_all * (jobnr + 1)) / nb_jobs;
+    MEJobContext job;
+
+    job.me_ctx = s->me_ctx;
+    job.me_ctx.data_cur = in->data[0];
+    job.me_ctx.data_ref = prev->data[0];
+    job.me_ctx.linesize = in->linesize[0];
+    job.cur_linesize = in->linesize[0];
+    job.ref_linesize = prev->linesize[0];
+
+    for (int mb_y = mb_y_start; mb_y < mb_y_end; mb_y++) {
+        for (int mb_x = 0; mb_x < bw_all; mb_x++) {
+            const int x  = mb_x << s->log2_mb_size;
+            const int y  = mb_y << s->log2_mb_size;
+            const int bw = FFMIN(s->mb_size, in->width  - x);
+            const int bh = FFMIN(s->mb_size, in->height - y);
+            int mv[2] = { x, y };
+            uint64_t sad;
+            int64_t thr;
+            int weight;
+
+            if (mb_x < s->b_width && mb_y < s->b_height) {
+                sad = s->search(&job.me_ctx, x, y, mv);
+                thr = s->thr;
+            } else {
+                /* partial blocks at the right/bottom edge are too thin
+                 * to match reliably, blend them against the co-located
+                 * reference with an area-scaled threshold */
+                sad = block_sad(in->data[0]   + y * in->linesize[0]   + x, in->linesize[0],
+                                prev->data[0] + y * prev->linesize[0] + x, prev->linesize[0],
+                                bw, bh);
+                thr = ((int64_t)s->thr * bw * bh) >> (2 * s->log2_mb_size);
+            }
+
+            weight = sad >= thr ? 0 : (int)(128 * (thr - sad) / thr);
+
+            for (int p = 0; p < s->nb_planes; p++) {
+                const int cw  = p == 1 || p == 2 ? s->log2_chroma_w : 0;
+                const int ch  = p == 1 || p == 2 ? s->log2_chroma_h : 0;
+                const int px  = x >> cw;
+                const int py  = y >> ch;
+                const int rx  = mv[0] >> cw;
+                const int ry  = mv[1] >> ch;
+                const int pw  = AV_CEIL_RSHIFT(in->width,  cw);
+                const int ph  = AV_CEIL_RSHIFT(in->height, ch);
+                const int pbw = FFMIN(AV_CEIL_RSHIFT(bw, cw), pw - px);
+                const int pbh = FFMIN(AV_CEIL_RSHIFT(bh, ch), ph - py);
+
+                blend_block(out->data[p]  + py * out->linesize[p]  + px, out->linesize[p],
+                            in->data[p]   + py * in->linesize[p]   + px, in->linesize[p],
+                            prev->data[p] + ry * prev->linesize[p] + rx, prev->linesize[p],
+                            pbw, pbh, weight, s->guard);
+            }
+        }
+    }
+
+    return 0;
+}
+
+static int config_input(AVFilterLink *inlink)
+{
+    AVFilterContext *ctx = inlink->dst;
+    MCDenoiseContext *s = ctx->priv;
+    const AVPixFmtDescriptor *desc = av_pix_fmt_desc_get(inlink->format);
+
+    s->log2_chroma_w = desc->log2_chroma_w;
+    s->log2_chroma_h = desc->log2_chroma_h;
+    s->nb_planes = av_pix_fmt_count_planes(inlink->format);
+
+    s->log2_mb_size = av_ceil_log2_c(s->mb_size);
+    s->mb_size = 1 << s->log2_mb_size;
+    s->b_width  = inlink->w >> s->log2_mb_size;
+    s->b_height = inlink->h >> s->log2_mb_size;
+
+    s->thr   = FFMAX((int)(2.0 * s->sigma * s->mb_size * s->mb_size), 1);
+    s->guard = FFMIN((int)(3.0 * s->sigma), 255);
+
+    ff_me_init_context(&s->me_ctx, s->mb_size, s->search_param,
+                       inlink->w, inlink->h,
+                       0, FFMAX(inlink->w - s->mb_size, 0),
+                       0, FFMAX(inlink->h - s->mb_size, 0));
+    s->me_ctx.get_cost = &me_cmp_sad;
+
+    switch (s->me_method) {
+    case AV_ME_METHOD_ESA:   s->search = ff_me_search_esa;   break;
+    case AV_ME_METHOD_TSS:   s->search = ff_me_search_tss;   break;
+    case AV_ME_METHOD_TDLS:  s->search = ff_me_search_tdls;  break;
+    case AV_ME_METHOD_NTSS:  s->search = ff_me_search_ntss;  break;
+    case AV_ME_METHOD_FSS:   s->search = ff_me_search_fss;   break;
+    case AV_ME_METHOD_DS:    s->search = ff_me_search_ds;    break;
+    case AV_ME_METHOD_HEXBS: s->search = ff_me_search_hexbs; break;
+    }
+
+    return 0;
+}
+
+static int filter_frame(AVFilterLink *inlink, AVFrame *in)
+{
+    AVFilterContext *ctx = inlink->dst;
+    AVFilterLink *outlink = ctx->outputs[0];
+    MCDenoiseContext *s = ctx->priv;
+    const int bh_all = AV_CEIL_RSHIFT(in->height, s->log2_mb_size);
+    ThreadData td;
+    AVFrame *out;
+    int ret;
+
+    if (!s->prev) {
+        s->prev = av_frame_clone(in);
+        if (!s->prev) {
+            av_frame_free(&in);
+            return AVERROR(ENOMEM);
+        }
+        return ff_filter_frame(outlink, in);
+    }
+
+    out = ff_get_video_buffer(outlink, outlink->w, outlink->h);
+    if (!out) {
+        av_frame_free(&in);
+        return AVERROR(ENOMEM);
+    }
+    ret = av_frame_copy_props(out, in);
+    if (ret < 0) {
+        av_frame_free(&in);
+        av_frame_free(&out);
+        return ret;
+    }
+
+    td.in  = in;
+    td.out = out;
+    ff_filter_execute(ctx, filter_slice, &td, NULL,
+                      FFMIN(bh_all, ff_filter_get_nb_threads(ctx)));
+
+    av_frame_free(&in);
+    av_frame_free(&s->prev);
+    s->prev = av_frame_clone(out);
+    if (!s->prev) {
+        av_frame_free(&out);
+        return AVERROR(ENOMEM);
+    }
+
+    return ff_filter_frame(outlink, out);
+}
+
+static av_cold void uninit(AVFilterContext *ctx)
+{
+    MCDenoiseContext *s = ctx->priv;
+
+    av_frame_free(&s->prev);
+}
+
+static const AVFilterPad mcdenoise_inputs[] = {
+    {
+        .name         = "default",
+        .type         = AVMEDIA_TYPE_VIDEO,
+        .filter_frame = filter_frame,
+        .config_props = config_input,
+    },
+};
+
+const FFFilter ff_vf_mcdenoise = {
+    .p.name        = "mcdenoise",
+    .p.description = NULL_IF_CONFIG_SMALL("Apply a Motion-Compensated Temporal Denoiser."),
+    .p.priv_class  = &mcdenoise_class,
+    .p.flags       = AVFILTER_FLAG_SLICE_THREADS,
+    .priv_size     = sizeof(MCDenoiseContext),
+    .uninit        = uninit,
+    FILTER_INPUTS(mcdenoise_inputs),
+    FILTER_OUTPUTS(ff_video_default_filterpad),
+    FILTER_PIXFMTS_ARRAY(pix_fmts),
+};
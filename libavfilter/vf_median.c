@@ -273,7 +273,8 @@ const FFFilter ff_vf_median = {
     .p.name        = "median",
     .p.description = NULL_IF_CONFIG_SMALL("Apply Median filter."),
     .p.priv_class  = &median_class,
-    .p.flags       = AVFILTER_FLAG_SUPPORT_TIMELINE_GENERIC | AVFILTER_FLAG_SLICE_THREADS,
+    .p.flags       = AVFILTER_FLAG_SUPPORT_TIMELINE_GENERIC | AVFILTER_FLAG_SLICE_THREADS |
+                     AVFILTER_FLAG_FRAME_THREADS,
     .priv_size     = sizeof(MedianContext),
     .uninit        = uninit,
     FILTER_INPUTS(median_inputs),
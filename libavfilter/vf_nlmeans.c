@@ -321,23 +321,39 @@ static int nlmeans_slice(AVFilterContext *ctx, void *arg, int jobnr, int nb_jobs
     return 0;
 }
 
-static void weight_averages(uint8_t *dst, ptrdiff_t dst_linesize,
-                            const uint8_t *src, ptrdiff_t src_linesize,
-                            float *total_weight, float *sum, ptrdiff_t linesize,
-                            int w, int h)
+struct averages_thread_data {
+    uint8_t *dst;
+    ptrdiff_t dst_linesize;
+    const uint8_t *src;
+    ptrdiff_t src_linesize;
+    int w, h;
+};
+
+static int weight_averages_slice(AVFilterContext *ctx, void *arg,
+                                 int jobnr, int nb_jobs)
 {
-    for (int y = 0; y < h; y++) {
-        for (int x = 0; x < w; x++) {
+    NLMeansContext *s = ctx->priv;
+    const struct averages_thread_data *td = arg;
+    const int slice_start = (td->h *  jobnr   ) / nb_jobs;
+    const int slice_end   = (td->h * (jobnr+1)) / nb_jobs;
+    uint8_t *dst = td->dst + slice_start*td->dst_linesize;
+    const uint8_t *src = td->src + slice_start*td->src_linesize;
+    float *total_weight = s->total_weight + slice_start*s->linesize;
+    float *sum = s->sum + slice_start*s->linesize;
+
+    for (int y = slice_start; y < slice_end; y++) {
+        for (int x = 0; x < td->w; x++) {
             // Also weight the centered pixel
             total_weight[x] += 1.f;
             sum[x] += 1.f * src[x];
             dst[x] = av_clip_uint8(sum[x] / total_weight[x] + 0.5f);
         }
-        dst += dst_linesize;
-        src += src_linesize;
-        total_weight += linesize;
-        sum += linesize;
+        dst += td->dst_linesize;
+        src += td->src_linesize;
+        total_weight += s->linesize;
+        sum += s->linesize;
     }
+    return 0;
 }
 
 static int nlmeans_plane(AVFilterContext *ctx, int w, int h, int p, int r,
@@ -377,8 +393,16 @@ static int nlmeans_plane(AVFilterContext *ctx, int w, int h, int p, int r,
         }
     }
 
-    weight_averages(dst, dst_linesize, src, src_linesize,
-                    s->total_weight, s->sum, s->linesize, w, h);
+    struct averages_thread_data td = {
+        .dst          = dst,
+        .dst_linesize = dst_linesize,
+        .src          = src,
+        .src_linesize = src_linesize,
+        .w            = w,
+        .h            = h,
+    };
+    ff_filter_execute(ctx, weight_averages_slice, &td, NULL,
+                      FFMIN(h, ff_filter_get_nb_threads(ctx)));
 
     return 0;
 }
@@ -476,7 +500,8 @@ const FFFilter ff_vf_nlmeans = {
     .p.name        = "nlmeans",
     .p.description = NULL_IF_CONFIG_SMALL("Non-local means denoiser."),
     .p.priv_class  = &nlmeans_class,
-    .p.flags       = AVFILTER_FLAG_SUPPORT_TIMELINE_GENERIC | AVFILTER_FLAG_SLICE_THREADS,
+    .p.flags       = AVFILTER_FLAG_SUPPORT_TIMELINE_GENERIC | AVFILTER_FLAG_SLICE_THREADS |
+                     AVFILTER_FLAG_FRAME_THREADS,
     .priv_size     = sizeof(NLMeansContext),
     .init          = init,
     .uninit        = uninit,
@@ -360,7 +360,7 @@ const FFFilter ff_vf_owdenoise = {
     .p.name        = "owdenoise",
     .p.description = NULL_IF_CONFIG_SMALL("Denoise using wavelets."),
     .p.priv_class  = &owdenoise_class,
-    .p.flags       = AVFILTER_FLAG_SUPPORT_TIMELINE_GENERIC,
+    .p.flags       = AVFILTER_FLAG_SUPPORT_TIMELINE_GENERIC | AVFILTER_FLAG_FRAME_THREADS,
     .priv_size     = sizeof(OWDenoiseContext),
     .uninit        = uninit,
     FILTER_INPUTS(owdenoise_inputs),
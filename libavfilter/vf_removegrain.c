@@ -635,7 +635,8 @@ const FFFilter ff_vf_removegrain = {
     .p.name        = "removegrain",
     .p.description = NULL_IF_CONFIG_SMALL("Remove grain."),
     .p.priv_class  = &removegrain_class,
-    .p.flags       = AVFILTER_FLAG_SUPPORT_TIMELINE_GENERIC | AVFILTER_FLAG_SLICE_THREADS,
+    .p.flags       = AVFILTER_FLAG_SUPPORT_TIMELINE_GENERIC | AVFILTER_FLAG_SLICE_THREADS |
+                     AVFILTER_FLAG_FRAME_THREADS,
     .priv_size     = sizeof(RemoveGrainContext),
     FILTER_INPUTS(removegrain_inputs),
     FILTER_OUTPUTS(ff_video_default_filterpad),
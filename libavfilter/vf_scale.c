@@ -384,7 +384,10 @@ static av_cold int init(AVFilterContext *ctx)
     threads = scale->sws->threads ? scale->sws->threads :
                                     ff_filter_get_nb_threads(ctx);
     if ((ctx->thread_type & AVFILTER_THREAD_FRAME_FILTER)) {
-        scale->sws->threads = 1;
+        // each frame thread scales on its own, but an explicitly set sws
+        // 'threads' option still enables slice threading inside the workers
+        if (!scale->sws->threads)
+            scale->sws->threads = 1;
 
         // we are the main context - export thread count to generic code
         if (!ff_filter_is_frame_thread(ctx))
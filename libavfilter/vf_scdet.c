@@ -22,6 +22,7 @@
  */
 
 #include "libavutil/imgutils.h"
+#include "libavutil/mem.h"
 #include "libavutil/opt.h"
 #include "libavutil/pixdesc.h"
 #include "libavutil/timestamp.h"
@@ -39,6 +40,7 @@ typedef struct SCDetContext {
     int nb_planes;
     int bitdepth;
     ff_scene_sad_fn sad;
+    uint64_t *plane_sad;
     double prev_mafd;
     double scene_score;
     AVFrame *prev_picref;
@@ -95,6 +97,11 @@ static int config_input(AVFilterLink *inlink)
     if (!s->sad)
         return AVERROR(EINVAL);
 
+    av_freep(&s->plane_sad);
+    s->plane_sad = av_calloc(ff_filter_get_nb_threads(ctx), sizeof(*s->plane_sad));
+    if (!s->plane_sad)
+        return AVERROR(ENOMEM);
+
     return 0;
 }
 
@@ -103,6 +110,38 @@ static av_cold void uninit(AVFilterContext *ctx)
     SCDetContext *s = ctx->priv;
 
     av_frame_free(&s->prev_picref);
+    av_freep(&s->plane_sad);
+}
+
+typedef struct ThreadData {
+    const AVFrame *prev, *cur;
+} ThreadData;
+
+static int scene_sad_slice(AVFilterContext *ctx, void *arg, int jobnr, int nb_jobs)
+{
+    SCDetContext *s = ctx->priv;
+    const ThreadData *td = arg;
+    uint64_t sad = 0;
+
+    for (int plane = 0; plane < s->nb_planes; plane++) {
+        const ptrdiff_t slice_start = (s->height[plane] *  jobnr)      / nb_jobs;
+        const ptrdiff_t slice_end   = (s->height[plane] * (jobnr + 1)) / nb_jobs;
+        uint64_t plane_sad;
+
+        if (slice_end <= slice_start)
+            continue;
+
+        s->sad(td->prev->data[plane] + slice_start * td->prev->linesize[plane],
+               td->prev->linesize[plane],
+               td->cur->data[plane] + slice_start * td->cur->linesize[plane],
+               td->cur->linesize[plane],
+               s->width[plane], slice_end - slice_start, &plane_sad);
+        sad += plane_sad;
+    }
+
+    s->plane_sad[jobnr] = sad;
+
+    return 0;
 }
 
 static double get_scene_score(AVFilterContext *ctx, AVFrame *frame)
@@ -113,18 +152,18 @@ static double get_scene_score(AVFilterContext *ctx, AVFrame *frame)
 
     if (prev_picref && frame->height == prev_picref->height
                     && frame->width  == prev_picref->width) {
+        ThreadData td = { prev_picref, frame };
+        const int nb_jobs = FFMIN(ff_filter_get_nb_threads(ctx), s->height[0]);
         uint64_t sad = 0;
         double mafd, diff;
         uint64_t count = 0;
 
-        for (int plane = 0; plane < s->nb_planes; plane++) {
-            uint64_t plane_sad;
-            s->sad(prev_picref->data[plane], prev_picref->linesize[plane],
-                    frame->data[plane], frame->linesize[plane],
-                    s->width[plane], s->height[plane], &plane_sad);
-            sad += plane_sad;
+        ff_filter_execute(ctx, scene_sad_slice, &td, NULL, nb_jobs);
+
+        for (int i = 0; i < nb_jobs; i++)
+            sad += s->plane_sad[i];
+        for (int plane = 0; plane < s->nb_planes; plane++)
             count += s->width[plane] * s->height[plane];
-        }
 
         mafd = (double)sad * 100. / count / (1ULL << s->bitdepth);
         diff = fabs(mafd - s->prev_mafd);
@@ -197,7 +236,7 @@ const FFFilter ff_vf_scdet = {
     .p.name        = "scdet",
     .p.description = NULL_IF_CONFIG_SMALL("Detect video scene change"),
     .p.priv_class  = &scdet_class,
-    .p.flags       = AVFILTER_FLAG_METADATA_ONLY,
+    .p.flags       = AVFILTER_FLAG_METADATA_ONLY | AVFILTER_FLAG_SLICE_THREADS,
     .priv_size     = sizeof(SCDetContext),
     .uninit        = uninit,
     FILTER_INPUTS(scdet_inputs),
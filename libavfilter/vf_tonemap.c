@@ -50,6 +50,8 @@ enum TonemapAlgorithm {
     TONEMAP_MAX,
 };
 
+#define TONEMAP_LUT_SIZE 1024
+
 typedef struct TonemapContext {
     const AVClass *class;
 
@@ -59,6 +61,12 @@ typedef struct TonemapContext {
     double peak;
 
     const AVLumaCoefficients *coeffs;
+    float cr, cg, cb;
+
+    /* scale factor as a function of the signal, evaluated at
+     * sig = lut_peak * i / TONEMAP_LUT_SIZE */
+    float lut[TONEMAP_LUT_SIZE + 1];
+    double lut_peak;
 } TonemapContext;
 
 static av_cold int init(AVFilterContext *ctx)
@@ -106,38 +114,8 @@ static float mobius(float in, float j, double peak)
 }
 
 #define MIX(x,y,a) (x) * (1 - (a)) + (y) * (a)
-static void tonemap(TonemapContext *s, AVFrame *out, const AVFrame *in,
-                    const AVPixFmtDescriptor *desc, int x, int y, double peak)
+static float tonemap_curve(const TonemapContext *s, float sig, double peak)
 {
-    int map[3] = { desc->comp[0].plane, desc->comp[1].plane, desc->comp[2].plane };
-    const float *r_in = (const float *)(in->data[map[0]] + x * desc->comp[map[0]].step + y * in->linesize[map[0]]);
-    const float *g_in = (const float *)(in->data[map[1]] + x * desc->comp[map[1]].step + y * in->linesize[map[1]]);
-    const float *b_in = (const float *)(in->data[map[2]] + x * desc->comp[map[2]].step + y * in->linesize[map[2]]);
-    float *r_out = (float *)(out->data[map[0]] + x * desc->comp[map[0]].step + y * out->linesize[map[0]]);
-    float *g_out = (float *)(out->data[map[1]] + x * desc->comp[map[1]].step + y * out->linesize[map[1]]);
-    float *b_out = (float *)(out->data[map[2]] + x * desc->comp[map[2]].step + y * out->linesize[map[2]]);
-    float sig, sig_orig;
-
-    /* load values */
-    *r_out = *r_in;
-    *g_out = *g_in;
-    *b_out = *b_in;
-
-    /* desaturate to prevent unnatural colors */
-    if (s->desat > 0) {
-        float luma = av_q2d(s->coeffs->cr) * *r_in + av_q2d(s->coeffs->cg) * *g_in + av_q2d(s->coeffs->cb) * *b_in;
-        float overbright = FFMAX(luma - s->desat, 1e-6) / FFMAX(luma, 1e-6);
-        *r_out = MIX(*r_in, luma, overbright);
-        *g_out = MIX(*g_in, luma, overbright);
-        *b_out = MIX(*b_in, luma, overbright);
-    }
-
-    /* pick the brightest component, reducing the value range as necessary
-     * to keep the entire signal in range and preventing discoloration due to
-     * out-of-bounds clipping */
-    sig = FFMAX(FFMAX3(*r_out, *g_out, *b_out), 1e-6);
-    sig_orig = sig;
-
     switch(s->tonemap) {
     default:
     case TONEMAP_NONE:
@@ -163,12 +141,22 @@ static void tonemap(TonemapContext *s, AVFrame *out, const AVFrame *in,
         sig = mobius(sig, s->param, peak);
         break;
     }
+    return sig;
+}
+
+/* Tabulate the scale factor over [0, peak] so that the per-pixel loop only
+ * does a linear interpolation instead of evaluating the curve (with its
+ * pow() calls and branches) for every pixel. */
+static void update_lut(TonemapContext *s, double peak)
+{
+    if (s->lut_peak == peak)
+        return;
 
-    /* apply the computed scale factor to the color,
-     * linearly to prevent discoloration */
-    *r_out *= sig / sig_orig;
-    *g_out *= sig / sig_orig;
-    *b_out *= sig / sig_orig;
+    for (int i = 0; i <= TONEMAP_LUT_SIZE; i++) {
+        float sig = FFMAX(peak * i / TONEMAP_LUT_SIZE, 1e-6);
+        s->lut[i] = tonemap_curve(s, sig, peak) / sig;
+    }
+    s->lut_peak = peak;
 }
 
 typedef struct ThreadData {
@@ -186,11 +174,55 @@ static int tonemap_slice(AVFilterContext *ctx, void *arg, int jobnr, int nb_jobs
     const AVPixFmtDescriptor *desc = td->desc;
     const int slice_start = (in->height * jobnr) / nb_jobs;
     const int slice_end = (in->height * (jobnr+1)) / nb_jobs;
-    double peak = td->peak;
+    const float peak = td->peak;
+    const float lut_mult = TONEMAP_LUT_SIZE / peak;
+    const float desat = s->desat;
+    const float cr = s->cr, cg = s->cg, cb = s->cb;
+    const float *lut = s->lut;
+    const int rp = desc->comp[0].plane;
+    const int gp = desc->comp[1].plane;
+    const int bp = desc->comp[2].plane;
+
+    for (int y = slice_start; y < slice_end; y++) {
+        const float *r_in = (const float *)(in->data[rp] + y * in->linesize[rp]);
+        const float *g_in = (const float *)(in->data[gp] + y * in->linesize[gp]);
+        const float *b_in = (const float *)(in->data[bp] + y * in->linesize[bp]);
+        float *r_out = (float *)(out->data[rp] + y * out->linesize[rp]);
+        float *g_out = (float *)(out->data[gp] + y * out->linesize[gp]);
+        float *b_out = (float *)(out->data[bp] + y * out->linesize[bp]);
+
+        for (int x = 0; x < out->width; x++) {
+            float r = r_in[x], g = g_in[x], b = b_in[x];
+            float sig, pos, frac, scale;
+            int idx;
+
+            /* desaturate to prevent unnatural colors */
+            if (desat > 0) {
+                float luma = cr * r + cg * g + cb * b;
+                float overbright = FFMAX(luma - desat, 1e-6f) / FFMAX(luma, 1e-6f);
+                r = MIX(r, luma, overbright);
+                g = MIX(g, luma, overbright);
+                b = MIX(b, luma, overbright);
+            }
 
-    for (int y = slice_start; y < slice_end; y++)
-        for (int x = 0; x < out->width; x++)
-            tonemap(s, out, in, desc, x, y, peak);
+            /* pick the brightest component, reducing the value range as
+             * necessary to keep the entire signal in range and preventing
+             * discoloration due to out-of-bounds clipping; signals above the
+             * nominal peak are mapped like the peak */
+            sig = av_clipf(FFMAX3(r, g, b), 1e-6f, peak);
+
+            /* apply the interpolated scale factor to the color,
+             * linearly to prevent discoloration */
+            pos   = sig * lut_mult;
+            idx   = FFMIN((int)pos, TONEMAP_LUT_SIZE - 1);
+            frac  = pos - idx;
+            scale = lut[idx] + (lut[idx + 1] - lut[idx]) * frac;
+
+            r_out[x] = r * scale;
+            g_out[x] = g * scale;
+            b_out[x] = b * scale;
+        }
+    }
 
     return 0;
 }
@@ -249,6 +281,13 @@ static int filter_frame(AVFilterLink *link, AVFrame *in)
         av_log(ctx, AV_LOG_WARNING, "desaturation is disabled\n");
         s->desat = 0;
     }
+    if (s->coeffs) {
+        s->cr = av_q2d(s->coeffs->cr);
+        s->cg = av_q2d(s->coeffs->cg);
+        s->cb = av_q2d(s->coeffs->cb);
+    }
+
+    update_lut(s, peak);
 
     /* do the tone map */
     td.out = out;
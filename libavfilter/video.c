@@ -50,11 +50,8 @@ AVFrame *ff_default_get_video_buffer2(AVFilterLink *link, int w, int h, int alig
 {
     FilterLinkInternal *const li = ff_link_internal(link);
     FFFilterGraph *graphi;
+    FFFramePool *pool;
     AVFrame *frame = NULL;
-    int pool_width = 0;
-    int pool_height = 0;
-    int pool_align = 0;
-    enum AVPixelFormat pool_format = AV_PIX_FMT_NONE;
 
     if (li->l.hw_frames_ctx &&
         ((AVHWFramesContext*)li->l.hw_frames_ctx->data)->format == link->format) {
@@ -71,42 +68,19 @@ AVFrame *ff_default_get_video_buffer2(AVFilterLink *link, int w, int h, int alig
         return frame;
     }
 
-    if (!li->frame_pool) {
-        li->frame_pool = ff_frame_pool_video_init(CONFIG_MEMORY_POISONING
-                                                     ? NULL
-                                                     : av_buffer_allocz,
-                                                  w, h, link->format, align);
-        if (!li->frame_pool)
-            return NULL;
-    } else {
-        if (ff_frame_pool_get_video_config(li->frame_pool,
-                                           &pool_width, &pool_height,
-                                           &pool_format, &pool_align) < 0) {
-            return NULL;
-        }
-
-        if (pool_width != w || pool_height != h ||
-            pool_format != link->format || pool_align != align) {
-
-            ff_frame_pool_uninit(&li->frame_pool);
-            li->frame_pool = ff_frame_pool_video_init(CONFIG_MEMORY_POISONING
-                                                         ? NULL
-                                                         : av_buffer_allocz,
-                                                      w, h, link->format, align);
-            if (!li->frame_pool)
-                return NULL;
-        }
-    }
-
     if (link->src) {
         graphi = fffiltergraph(link->src->graph);
     } else if (link->dst) {
         graphi = fffiltergraph(link->dst->graph);
     } else {
-        graphi = NULL;
+        return NULL;
     }
 
-    frame = ff_frame_pool_get(li->frame_pool, graphi);
+    pool = ff_graph_video_frame_pool(graphi, w, h, link->format, align);
+    if (!pool)
+        return NULL;
+
+    frame = ff_frame_pool_get(pool, graphi);
     if (!frame)
         return NULL;
 
@@ -36,7 +36,7 @@ av_cold void ff_overlay_init_x86(AVFilterContext *ctx)
 {
     OverlayContext *s = ctx->priv;
     const AVFilterLink *main = ctx->inputs[0];
-    const AVFilterLink *overlay = ctx->inputs[0];
+    const AVFilterLink *overlay = ctx->inputs[1];
     int cpu_flags = av_get_cpu_flags();
     int main_has_alpha = s->main_has_alpha;
 
@@ -44,6 +44,8 @@
 #define BUFFER_CAPACITY         (4 * 1024 * 1024)
 #define READ_BACK_CAPACITY      (4 * 1024 * 1024)
 #define SHORT_SEEK_THRESHOLD    (256 * 1024)
+/* maximum amount requested from the inner protocol in one read */
+#define READ_CHUNK              (64 * 1024)
 
 typedef struct RingBuffer
 {
@@ -71,6 +73,17 @@ typedef struct AsyncContext {
     int64_t         logical_size;
     RingBuffer      ring;
 
+    /* options */
+    int             buffer_capacity;
+    int             read_back_capacity;
+    int             short_seek_size;
+    int             high_watermark;
+    int             low_watermark;
+
+    /* moving average of recent forward seek distances, used to widen the
+     * read-through window when the caller hops between interleaved ranges */
+    int64_t         seek_hop_avg;
+
     pthread_cond_t  cond_wakeup_main;
     pthread_cond_t  cond_wakeup_background;
     pthread_mutex_t mutex;
@@ -221,8 +234,10 @@ static void *async_buffer_task(void *arg)
             continue;
         }
 
-        fifo_space = ring_space(ring);
+        fifo_space = FFMIN(ring_space(ring), c->high_watermark - ring_size(ring));
         if (c->io_eof_reached || fifo_space <= 0) {
+            /* filled up to the high watermark; the main thread wakes us up
+             * again once the buffer drains below the low watermark */
             pthread_cond_signal(&c->cond_wakeup_main);
             pthread_cond_wait(&c->cond_wakeup_background, &c->mutex);
             pthread_mutex_unlock(&c->mutex);
@@ -230,7 +245,7 @@ static void *async_buffer_task(void *arg)
         }
         pthread_mutex_unlock(&c->mutex);
 
-        to_copy = FFMIN(4096, fifo_space);
+        to_copy = FFMIN(READ_CHUNK, fifo_space);
         ret = ring_write(ring, h, to_copy);
 
         pthread_mutex_lock(&c->mutex);
@@ -255,7 +270,13 @@ static int async_open(URLContext *h, const char *arg, int flags, AVDictionary **
 
     av_strstart(arg, "async:", &arg);
 
-    ret = ring_init(&c->ring, BUFFER_CAPACITY, READ_BACK_CAPACITY);
+    if (!c->high_watermark || c->high_watermark > c->buffer_capacity)
+        c->high_watermark = c->buffer_capacity;
+    if (!c->low_watermark)
+        c->low_watermark = c->high_watermark / 2;
+    c->low_watermark = av_clip(c->low_watermark, 1, c->high_watermark);
+
+    ret = ring_init(&c->ring, c->buffer_capacity, c->read_back_capacity);
     if (ret < 0)
         goto fifo_fail;
 
@@ -378,7 +399,10 @@ static int async_read_internal(URLContext *h, void *dest, int size)
         pthread_cond_wait(&c->cond_wakeup_main, &c->mutex);
     }
 
-    pthread_cond_signal(&c->cond_wakeup_background);
+    /* only wake the background thread once the buffer has drained below the
+     * low watermark, so that it refills in larger batches */
+    if (ring_size(ring) < c->low_watermark || c->io_eof_reached)
+        pthread_cond_signal(&c->cond_wakeup_background);
     pthread_mutex_unlock(&c->mutex);
 
     return ret;
@@ -395,6 +419,8 @@ static int64_t async_seek(URLContext *h, int64_t pos, int whence)
     RingBuffer   *ring = &c->ring;
     int64_t       ret;
     int64_t       new_logical_pos;
+    int64_t       delta;
+    int64_t       short_seek;
     int fifo_size;
     int fifo_size_of_read_back;
 
@@ -413,13 +439,26 @@ static int64_t async_seek(URLContext *h, int64_t pos, int whence)
     if (new_logical_pos < 0)
         return AVERROR(EINVAL);
 
+    /* learn the typical distance of forward hops, so that the alternating
+     * reads produced by interleaved a/v chunks (e.g. in mov) are served by
+     * reading through the gap instead of seeking on the inner protocol */
+    delta = new_logical_pos - c->logical_pos;
+    if (delta > 0 && delta <= 2 * (int64_t)c->buffer_capacity)
+        c->seek_hop_avg = c->seek_hop_avg ? (3 * c->seek_hop_avg + delta) / 4
+                                          : delta;
+
+    short_seek = c->short_seek_size;
+    if (c->seek_hop_avg > 0)
+        short_seek = av_clip64(4 * c->seek_hop_avg, short_seek,
+                               2 * (int64_t)c->buffer_capacity);
+
     fifo_size = ring_size(ring);
     fifo_size_of_read_back = ring_size_of_read_back(ring);
     if (new_logical_pos == c->logical_pos) {
         /* current position */
         return c->logical_pos;
     } else if ((new_logical_pos >= (c->logical_pos - fifo_size_of_read_back)) &&
-               (new_logical_pos < (c->logical_pos + fifo_size + SHORT_SEEK_THRESHOLD))) {
+               (new_logical_pos < (c->logical_pos + fifo_size + short_seek))) {
         int pos_delta = (int)(new_logical_pos - c->logical_pos);
         /* fast seek */
         av_log(h, AV_LOG_TRACE, "async_seek: fask_seek %"PRId64" from %d dist:%d/%d\n",
@@ -476,6 +515,16 @@ static int64_t async_seek(URLContext *h, int64_t pos, int whence)
 #define D AV_OPT_FLAG_DECODING_PARAM
 
 static const AVOption options[] = {
+    { "buffer_size", "maximum number of bytes buffered ahead of the read position",
+        OFFSET(buffer_capacity), AV_OPT_TYPE_INT, { .i64 = BUFFER_CAPACITY }, 65536, INT_MAX / 2, D },
+    { "read_back_size", "maximum number of bytes kept behind the read position for backward seeks",
+        OFFSET(read_back_capacity), AV_OPT_TYPE_INT, { .i64 = READ_BACK_CAPACITY }, 0, INT_MAX / 2, D },
+    { "short_seek_size", "seek distance below which to read through instead of seeking on the inner protocol",
+        OFFSET(short_seek_size), AV_OPT_TYPE_INT, { .i64 = SHORT_SEEK_THRESHOLD }, 0, INT_MAX / 2, D },
+    { "high_watermark", "stop refilling once this many bytes are buffered (0 means buffer_size)",
+        OFFSET(high_watermark), AV_OPT_TYPE_INT, { .i64 = 0 }, 0, INT_MAX / 2, D },
+    { "low_watermark", "resume refilling once the buffer drains below this (0 means high_watermark/2)",
+        OFFSET(low_watermark), AV_OPT_TYPE_INT, { .i64 = 0 }, 0, INT_MAX / 2, D },
     {NULL},
 };
 
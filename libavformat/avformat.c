@@ -181,6 +181,15 @@ void avformat_free_context(AVFormatContext *s)
     av_packet_free(&si->pkt);
     av_packet_free(&si->parse_pkt);
     avpriv_packet_list_free(&si->packet_buffer);
+    if (s->oformat) {
+        PacketListEntry *pktl = fci->packet_pool;
+        while (pktl) {
+            PacketListEntry *next = pktl->next;
+            av_free(pktl);
+            pktl = next;
+        }
+        fci->packet_pool = NULL;
+    }
     av_freep(&s->streams);
     av_freep(&s->stream_groups);
     if (s->iformat)
@@ -2179,8 +2179,9 @@ int avformat_open_input(AVFormatContext **ps, const char *url,
  * @note this function isn't guaranteed to open all the codecs, so
  *       options being non-empty at return is a perfectly normal behavior.
  *
- * @todo Let the user decide somehow what information is needed so that
- *       we do not waste time getting stuff the user does not need.
+ * @note for streams whose discard flag is set to AVDISCARD_ALL before
+ *       this call, probing stops once basic codec parameters are known;
+ *       framerate and timestamp analysis is skipped for them.
  */
 int avformat_find_stream_info(AVFormatContext *ic, AVDictionary **options);
 
@@ -2748,6 +2749,76 @@ const AVIndexEntry *avformat_index_get_entry_from_timestamp(AVStream *st,
 int av_add_index_entry(AVStream *st, int64_t pos, int64_t timestamp,
                        int size, int distance, int flags);
 
+/**
+ * Serialize the seek indexes of all streams into a compact binary blob.
+ *
+ * The blob can be stored by the caller and handed to
+ * avformat_index_import() on a later context opened on the same file,
+ * avoiding the I/O that would otherwise be needed to rebuild the index.
+ * The format of the blob is private to libavformat, but stable across
+ * platforms and library versions.
+ *
+ * @param s    media file handle
+ * @param data on success set to the allocated blob, to be freed by the
+ *             caller with av_free()
+ * @param size on success set to the size of the blob in bytes
+ * @return 0 on success, a negative AVERROR code on failure
+ */
+int avformat_index_export(AVFormatContext *s, uint8_t **data, size_t *size);
+
+/**
+ * Replace the seek indexes of all streams with a blob previously
+ * created by avformat_index_export().
+ *
+ * The blob must have been exported from a context with the same number
+ * of streams, i.e. from another instance of the same file. On failure
+ * the existing indexes are left unchanged.
+ *
+ * @param s    media file handle
+ * @param data the blob to import
+ * @param size the size of the blob in bytes
+ * @return 0 on success, a negative AVERROR code on failure
+ */
+int avformat_index_import(AVFormatContext *s, const uint8_t *data, size_t size);
+
+/**
+ * Opaque snapshot of the read state of a demuxing context.
+ */
+typedef struct AVFormatReadState AVFormatReadState;
+
+/**
+ * Save the current read state of a demuxing context.
+ *
+ * Together with avformat_read_state_restore() this allows bookmarking a
+ * position in the input and rewinding to it later on the same context,
+ * without re-opening or re-probing the input. Saving flushes internal
+ * buffering, like avformat_flush(), so that the recorded position is
+ * exact: the packets delivered after a save are the same packets that
+ * are delivered after restoring the state.
+ *
+ * @param s     media file handle
+ * @param state on success set to the newly allocated state, to be freed
+ *              with avformat_read_state_free()
+ * @return 0 on success, a negative AVERROR code on failure
+ */
+int avformat_read_state_save(AVFormatContext *s, AVFormatReadState **state);
+
+/**
+ * Rewind a demuxing context to a previously saved read state.
+ *
+ * The state must have been saved from the same context, or from a
+ * context opened on the same input with the same number of streams.
+ *
+ * @param s     media file handle
+ * @param state state to restore
+ * @return 0 on success, a negative AVERROR code on failure
+ */
+int avformat_read_state_restore(AVFormatContext *s, const AVFormatReadState *state);
+
+/**
+ * Free a read state and set the pointer to NULL.
+ */
+void avformat_read_state_free(AVFormatReadState **state);
 
 /**
  * Split a URL string into components.
@@ -59,6 +59,12 @@ typedef struct FormatContextInternal {
             int (*interleave_packet)(struct AVFormatContext *s, AVPacket *pkt,
                                      int flush, int has_packet);
 
+            /**
+             * Recycled interleave queue nodes, linked through their next
+             * pointers. Avoids one malloc/free pair per muxed packet.
+             */
+            PacketListEntry *packet_pool;
+
 #if FF_API_COMPUTE_PKT_FIELDS2
             int missing_ts_warning;
 #endif
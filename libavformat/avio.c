@@ -20,6 +20,7 @@
  */
 
 #include "libavutil/avstring.h"
+#include "libavutil/buffer.h"
 #include "libavutil/dict.h"
 #include "libavutil/mem.h"
 #include "libavutil/opt.h"
@@ -61,6 +62,7 @@ static const AVOption options[] = {
     {"protocol_whitelist", "List of protocols that are allowed to be used", OFFSET(protocol_whitelist), AV_OPT_TYPE_STRING, { .str = NULL },  0, 0, D },
     {"protocol_blacklist", "List of protocols that are not allowed to be used", OFFSET(protocol_blacklist), AV_OPT_TYPE_STRING, { .str = NULL },  0, 0, D },
     {"rw_timeout", "Timeout for IO operations (in microseconds)", offsetof(URLContext, rw_timeout), AV_OPT_TYPE_INT64, { .i64 = 0 }, 0, INT64_MAX, AV_OPT_FLAG_ENCODING_PARAM | AV_OPT_FLAG_DECODING_PARAM },
+    {"rw_rate_limit", "Maximum average IO rate (in bytes per second)", offsetof(URLContext, rw_rate_limit), AV_OPT_TYPE_INT64, { .i64 = 0 }, 0, INT64_MAX, AV_OPT_FLAG_ENCODING_PARAM | AV_OPT_FLAG_DECODING_PARAM },
     { NULL }
 };
 
@@ -469,6 +471,15 @@ int ffio_fdopen(AVIOContext **sp, URLContext *h)
     }
     ((FFIOContext*)s)->short_seek_get = ffurl_get_short_seek;
     s->av_class = &ff_avio_class;
+
+#if HAVE_MMAP
+    if ((h->flags & (AVIO_FLAG_READ | AVIO_FLAG_WRITE)) == AVIO_FLAG_READ &&
+        h->prot && h->prot->priv_data_class) {
+        int64_t use_mmap = 0;
+        if (av_opt_get_int(h->priv_data, "mmap", 0, &use_mmap) >= 0 && use_mmap)
+            ffio_try_map(s, ffurl_get_file_handle(h));
+    }
+#endif
     return 0;
 }
 
@@ -504,6 +515,23 @@ int avio_open(AVIOContext **s, const char *filename, int flags)
 }
 
 
+/* Refill the token bucket implementing rw_rate_limit and return how many
+ * bytes may be transferred right now, at most size. */
+static int rate_limit_chunk(URLContext *h, int size)
+{
+    /* allow short bursts of an eighth of a second at the configured rate */
+    int64_t burst = FFMAX(h->rw_rate_limit / 8, 1);
+    int64_t now   = av_gettime_relative();
+
+    if (!h->rate_last_time)
+        h->rate_tokens = burst;
+    else
+        h->rate_tokens = FFMIN(burst, h->rate_tokens +
+                               (now - h->rate_last_time) * h->rw_rate_limit / 1000000);
+    h->rate_last_time = now;
+    return FFMIN(size, h->rate_tokens);
+}
+
 static inline int retry_transfer_wrapper(URLContext *h, uint8_t *buf,
                                          const uint8_t *cbuf,
                                          int size, int size_min,
@@ -515,10 +543,21 @@ static inline int retry_transfer_wrapper(URLContext *h, uint8_t *buf,
 
     len = 0;
     while (len < size_min) {
+        int chunk = size - len;
+
         if (ff_check_interrupt(&h->interrupt_callback))
             return AVERROR_EXIT;
-        ret = read ? h->prot->url_read (h, buf + len, size - len):
-                     h->prot->url_write(h, cbuf + len, size - len);
+        if (h->rw_rate_limit > 0) {
+            chunk = rate_limit_chunk(h, chunk);
+            if (chunk <= 0) {
+                if (h->flags & AVIO_FLAG_NONBLOCK)
+                    return len ? len : AVERROR(EAGAIN);
+                av_usleep(1000);
+                continue;
+            }
+        }
+        ret = read ? h->prot->url_read (h, buf + len, chunk):
+                     h->prot->url_write(h, cbuf + len, chunk);
         if (ret == AVERROR(EINTR))
             continue;
         if (h->flags & AVIO_FLAG_NONBLOCK)
@@ -543,6 +582,8 @@ static inline int retry_transfer_wrapper(URLContext *h, uint8_t *buf,
         if (ret) {
             fast_retries = FFMAX(fast_retries, 2);
             wait_since = 0;
+            if (h->rw_rate_limit > 0)
+                h->rate_tokens -= ret;
         }
         len += ret;
     }
@@ -630,6 +671,10 @@ int avio_close(AVIOContext *s)
     h         = s->opaque;
     s->opaque = NULL;
 
+    if (ctx->mapped_buf) {
+        av_buffer_unref(&ctx->mapped_buf);
+        s->buffer = NULL;
+    }
     av_freep(&s->buffer);
     if (s->write_flag)
         av_log(s, AV_LOG_VERBOSE,
@@ -25,6 +25,14 @@
 
 extern const AVClass ff_avio_class;
 
+/**
+ * Packet buffer size classes served by FFIOContext.pkt_pools; class i
+ * holds buffers of 1 << (FFIO_PKT_POOL_MIN_LOG2 + i) bytes.
+ */
+#define FFIO_PKT_POOL_MIN_LOG2 10
+#define FFIO_PKT_POOL_MAX_LOG2 20
+#define FFIO_PKT_POOL_CLASSES  (FFIO_PKT_POOL_MAX_LOG2 - FFIO_PKT_POOL_MIN_LOG2 + 1)
+
 typedef struct FFIOContext {
     AVIOContext pub;
     /**
@@ -71,6 +79,36 @@ typedef struct FFIOContext {
      */
     int orig_buffer_size;
 
+    /**
+     * When the input is a memory mapping of the whole file, a reference
+     * to it. pub.buffer is then a window into the mapping that is slid
+     * by fill_buffer() and avio_seek(), and readers may return
+     * refcounted slices of the mapping without copying.
+     */
+    struct AVBufferRef *mapped_buf;
+
+    /**
+     * Whether av_get_packet() may return packets referencing mapped_buf
+     * instead of copying. Such packets are read-only and their padding
+     * holds file data rather than zeroes, so this must only be set by
+     * demuxers audited not to rely on either property.
+     */
+    int mapped_pkts_enabled;
+
+    /**
+     * Pools of refcounted packet buffers, one per power-of-two size
+     * class, created on demand by av_get_packet(). Recycling buffers
+     * avoids per-packet allocator traffic on the demuxing hot path.
+     */
+    struct AVBufferPool *pkt_pools[FFIO_PKT_POOL_CLASSES];
+
+    /**
+     * Whether av_get_packet() may draw buffers from pkt_pools. Only set
+     * for heap-allocated contexts, whose teardown through
+     * avio_context_free() releases the pools.
+     */
+    int pkt_pools_enabled;
+
     /**
      * Written output size
      * is updated each time a successful writeout ends up further position-wise
@@ -97,6 +135,13 @@ void ffio_init_context(FFIOContext *s,
  */
 void ffio_init_read_context(FFIOContext *s, const uint8_t *buffer, int buffer_size);
 
+/**
+ * Try to memory-map the whole regular file behind fd and serve all
+ * further reads of the context from the mapping. A no-op if the fd is
+ * not a mappable regular file or mapping fails.
+ */
+void ffio_try_map(AVIOContext *s, int fd);
+
 /**
  * Wrap a buffer in an AVIOContext for writing.
  */
@@ -19,7 +19,16 @@
  * 51 Franklin Street, Fifth Floor, Boston, MA 02110-1301 USA.
  */
 
+#include "config.h"
+
+#if HAVE_MMAP
+#include <sys/mman.h>
+#include <sys/stat.h>
+#include <unistd.h>
+#endif
+
 #include "libavutil/bprint.h"
+#include "libavutil/buffer.h"
 #include "libavutil/crc.h"
 #include "libavutil/dict.h"
 #include "libavutil/intreadwrite.h"
@@ -42,6 +51,12 @@
  */
 #define SHORT_SEEK_THRESHOLD 32768
 
+/**
+ * Size of the buffer window slid over a memory-mapped input. Only bounds
+ * pointer arithmetic, no memory of this size is allocated or touched.
+ */
+#define MMAP_WINDOW_SIZE (1 << 25)
+
 static void fill_buffer(AVIOContext *s);
 static int url_resetbuf(AVIOContext *s, int flags);
 /** @warning must be called before any I/O */
@@ -106,6 +121,57 @@ void ffio_init_write_context(FFIOContext *s, uint8_t *buffer, int buffer_size)
     ffio_init_context(s, buffer, buffer_size, 1, NULL, NULL, NULL, NULL);
 }
 
+#if HAVE_MMAP
+static void mmap_buffer_free(void *opaque, uint8_t *data)
+{
+    munmap(data, (size_t)(uintptr_t)opaque);
+}
+#endif
+
+void ffio_try_map(AVIOContext *s, int fd)
+{
+#if HAVE_MMAP
+    FFIOContext *const ctx = ffiocontext(s);
+    struct stat st;
+    AVBufferRef *ref;
+    void *map;
+
+    if (fd < 0 || fstat(fd, &st) < 0 || !S_ISREG(st.st_mode) ||
+        st.st_size <= 0 || (uint64_t)st.st_size > SIZE_MAX)
+        return;
+
+    map = mmap(NULL, st.st_size, PROT_READ, MAP_PRIVATE, fd, 0);
+    if (map == MAP_FAILED) {
+        av_log(s, AV_LOG_WARNING, "Cannot map input file: %s\n",
+               av_err2str(AVERROR(errno)));
+        return;
+    }
+
+    ref = av_buffer_create(map, st.st_size, mmap_buffer_free,
+                           (void *)(uintptr_t)st.st_size,
+                           AV_BUFFER_FLAG_READONLY);
+    if (!ref) {
+        munmap(map, st.st_size);
+        return;
+    }
+
+    /* A window into the mapping replaces the allocated buffer; reads and
+     * seeks are served by sliding it, without going back to the protocol. */
+    av_free(s->buffer);
+    ctx->mapped_buf = ref;
+    s->buffer       = ref->data;
+    s->buffer_size  = FFMIN(st.st_size, MMAP_WINDOW_SIZE);
+    s->buf_ptr      =
+    s->buf_ptr_max  = s->buffer;
+    s->buf_end      = s->buffer + s->buffer_size;
+    s->pos          = s->buffer_size;
+    s->read_packet  = NULL;
+    s->seek         = NULL;
+    s->seekable     = AVIO_SEEKABLE_NORMAL;
+    ctx->maxsize    = st.st_size;
+#endif
+}
+
 AVIOContext *avio_alloc_context(
                   unsigned char *buffer,
                   int buffer_size,
@@ -120,6 +186,7 @@ AVIOContext *avio_alloc_context(
         return NULL;
     ffio_init_context(s, buffer, buffer_size, write_flag, opaque,
                   read_packet, write_packet, seek);
+    s->pkt_pools_enabled = 1;
     return &s->pub;
 }
 
@@ -127,6 +194,9 @@ void avio_context_free(AVIOContext **ps)
 {
     AVIOContext *s = *ps;
     if (s) {
+        FFIOContext *const ctx = ffiocontext(s);
+        for (int i = 0; i < FFIO_PKT_POOL_CLASSES; i++)
+            av_buffer_pool_uninit(&ctx->pkt_pools[i]);
         av_freep(&s->protocol_whitelist);
         av_freep(&s->protocol_blacklist);
     }
@@ -207,7 +277,12 @@ void avio_write(AVIOContext *s, const unsigned char *buf, int size)
 {
     if (size <= 0)
         return;
-    if (s->direct && !s->update_checksum) {
+    /* Writes at least as large as the buffer bypass it: flush what is
+     * pending and hand the caller's data to the protocol directly,
+     * avoiding the copy. Packetized protocols still need the buffer to
+     * split writes into max_packet_size chunks. */
+    if ((s->direct || (size >= s->buffer_size && !s->max_packet_size)) &&
+        !s->update_checksum) {
         avio_flush(s);
         writeout(s, buf, size);
         return;
@@ -246,7 +321,8 @@ int64_t avio_seek(AVIOContext *s, int64_t offset, int whence)
         return AVERROR(EINVAL);
 
     if ((whence & AVSEEK_SIZE))
-        return s->seek ? s->seek(s->opaque, offset, AVSEEK_SIZE) : AVERROR(ENOSYS);
+        return ctx->mapped_buf ? ctx->mapped_buf->size :
+               s->seek ? s->seek(s->opaque, offset, AVSEEK_SIZE) : AVERROR(ENOSYS);
 
     buffer_size = s->buf_end - s->buffer;
     // pos is the absolute position that the beginning of s->buffer corresponds to in the file
@@ -278,6 +354,22 @@ int64_t avio_seek(AVIOContext *s, int64_t offset, int whence)
         offset1 >= 0 && offset1 <= (s->write_flag ? s->buf_ptr_max - s->buffer : buffer_size)) {
         /* can do the seek inside the buffer */
         s->buf_ptr = s->buffer + offset1;
+    } else if (ctx->mapped_buf && !s->write_flag) {
+        /* jump the buffer window to the target offset in the mapping */
+        int64_t size = ctx->mapped_buf->size;
+        int len;
+
+        if (offset > size)
+            return AVERROR(EINVAL);
+        len = FFMIN(size - offset, MMAP_WINDOW_SIZE);
+        s->buffer       = ctx->mapped_buf->data + offset;
+        s->buffer_size  = len;
+        s->checksum_ptr =
+        s->buf_ptr      =
+        s->buf_ptr_max  = s->buffer;
+        s->buf_end      = s->buffer + len;
+        s->pos          = offset + len;
+        ctx->seek_count++;
     } else if ((!(s->seekable & AVIO_SEEKABLE_NORMAL) ||
                offset1 <= buffer_size + short_seek) &&
                !s->write_flag && offset1 >= 0 &&
@@ -334,6 +426,9 @@ int64_t avio_size(AVIOContext *s)
     if (ctx->written_output_size)
         return ctx->written_output_size;
 
+    if (ctx->mapped_buf)
+        return ctx->mapped_buf->size;
+
     if (!s->seek)
         return AVERROR(ENOSYS);
     size = s->seek(s->opaque, 0, AVSEEK_SIZE);
@@ -359,6 +454,14 @@ int avio_feof(AVIOContext *s)
 
 void avio_wl32(AVIOContext *s, unsigned int val)
 {
+    /* store directly into the buffer when there is room, as headers are
+     * serialized field by field and the per-byte path is measurable there;
+     * the byte-wise fallback flushes and handles the buffer end */
+    if (s->buf_end - s->buf_ptr >= 4) {
+        AV_WL32(s->buf_ptr, val);
+        s->buf_ptr += 4;
+        return;
+    }
     avio_w8(s, (uint8_t) val       );
     avio_w8(s, (uint8_t)(val >> 8 ));
     avio_w8(s, (uint8_t)(val >> 16));
@@ -367,6 +470,11 @@ void avio_wl32(AVIOContext *s, unsigned int val)
 
 void avio_wb32(AVIOContext *s, unsigned int val)
 {
+    if (s->buf_end - s->buf_ptr >= 4) {
+        AV_WB32(s->buf_ptr, val);
+        s->buf_ptr += 4;
+        return;
+    }
     avio_w8(s,           val >> 24 );
     avio_w8(s, (uint8_t)(val >> 16));
     avio_w8(s, (uint8_t)(val >> 8 ));
@@ -427,36 +535,66 @@ PUT_STR16(be, 1)
 
 void avio_wl64(AVIOContext *s, uint64_t val)
 {
+    if (s->buf_end - s->buf_ptr >= 8) {
+        AV_WL64(s->buf_ptr, val);
+        s->buf_ptr += 8;
+        return;
+    }
     avio_wl32(s, (uint32_t)(val & 0xffffffff));
     avio_wl32(s, (uint32_t)(val >> 32));
 }
 
 void avio_wb64(AVIOContext *s, uint64_t val)
 {
+    if (s->buf_end - s->buf_ptr >= 8) {
+        AV_WB64(s->buf_ptr, val);
+        s->buf_ptr += 8;
+        return;
+    }
     avio_wb32(s, (uint32_t)(val >> 32));
     avio_wb32(s, (uint32_t)(val & 0xffffffff));
 }
 
 void avio_wl16(AVIOContext *s, unsigned int val)
 {
+    if (s->buf_end - s->buf_ptr >= 2) {
+        AV_WL16(s->buf_ptr, val);
+        s->buf_ptr += 2;
+        return;
+    }
     avio_w8(s, (uint8_t)val);
     avio_w8(s, (int)val >> 8);
 }
 
 void avio_wb16(AVIOContext *s, unsigned int val)
 {
+    if (s->buf_end - s->buf_ptr >= 2) {
+        AV_WB16(s->buf_ptr, val);
+        s->buf_ptr += 2;
+        return;
+    }
     avio_w8(s, (int)val >> 8);
     avio_w8(s, (uint8_t)val);
 }
 
 void avio_wl24(AVIOContext *s, unsigned int val)
 {
+    if (s->buf_end - s->buf_ptr >= 3) {
+        AV_WL24(s->buf_ptr, val);
+        s->buf_ptr += 3;
+        return;
+    }
     avio_wl16(s, val & 0xffff);
     avio_w8(s, (int)val >> 16);
 }
 
 void avio_wb24(AVIOContext *s, unsigned int val)
 {
+    if (s->buf_end - s->buf_ptr >= 3) {
+        AV_WB24(s->buf_ptr, val);
+        s->buf_ptr += 3;
+        return;
+    }
     avio_wb16(s, (int)val >> 8);
     avio_w8(s, (uint8_t)val);
 }
@@ -520,6 +658,28 @@ static void fill_buffer(AVIOContext *s)
                           s->buf_end : s->buffer;
     int len             = s->buffer_size - (dst - s->buffer);
 
+    if (ctx->mapped_buf) {
+        int64_t left = ctx->mapped_buf->size - s->pos;
+
+        if (s->eof_reached)
+            return;
+        if (left <= 0) {
+            s->eof_reached = 1;
+            return;
+        }
+        /* slide the window over the mapping; the checksum region stays
+         * contiguous in memory, so checksum_ptr is left alone */
+        len = FFMIN(left, MMAP_WINDOW_SIZE);
+        s->buffer      = ctx->mapped_buf->data + s->pos;
+        s->buffer_size = len;
+        s->buf_ptr     = s->buffer;
+        s->buf_end     = s->buffer + len;
+        s->pos        += len;
+        ctx->bytes_read += len;
+        s->bytes_read = ctx->bytes_read;
+        return;
+    }
+
     /* can't fill the buffer without read_packet, just set EOF if appropriate */
     if (!s->read_packet && s->buf_ptr >= s->buf_end)
         s->eof_reached = 1;
@@ -1090,6 +1250,11 @@ int ffio_limit(AVIOContext *s, int size)
 static int set_buf_size(AVIOContext *s, int buf_size)
 {
     uint8_t *buffer;
+
+    /* the buffer is a window into the mapping, leave it alone */
+    if (ffiocontext(s)->mapped_buf)
+        return 0;
+
     buffer = av_malloc(buf_size);
     if (!buffer)
         return AVERROR(ENOMEM);
@@ -1108,6 +1273,9 @@ int ffio_realloc_buf(AVIOContext *s, int buf_size)
     uint8_t *buffer;
     int data_size;
 
+    if (ffiocontext(s)->mapped_buf)
+        return 0;
+
     if (!s->buffer_size)
         return set_buf_size(s, buf_size);
 
@@ -1160,6 +1328,13 @@ int ffio_rewind_with_probe_data(AVIOContext *s, unsigned char **bufp, int buf_si
         return AVERROR(EINVAL);
     }
 
+    if (ffiocontext(s)->mapped_buf) {
+        /* the mapping already holds the probe data, just seek back */
+        int64_t pos = avio_seek(s, 0, SEEK_SET);
+        av_freep(bufp);
+        return FFMIN(pos, 0);
+    }
+
     buffer_size = s->buf_end - s->buffer;
 
     /* the buffers must touch or overlap */
@@ -1271,22 +1446,117 @@ int avio_read_to_bprint(AVIOContext *h, AVBPrint *pb, size_t max_size)
 
 /* output in a dynamic buffer */
 
+#define DYN_BUF_MIN_BLOCK (1 << 15)
+#define DYN_BUF_MAX_BLOCK (1 << 23)
+
+typedef struct DynBufferBlock {
+    struct DynBufferBlock *next;
+    int size, capacity;
+    uint8_t data[];
+} DynBufferBlock;
+
 typedef struct DynBuffer {
     int pos, size, allocated_size;
     uint8_t *buffer;
+    /**
+     * Chain of append-only blocks used while all writes are sequential.
+     * Growing the chain never copies already written data; the chain is
+     * linearized into buffer once, on the first backward seek or when
+     * the caller asks for the contiguous buffer.
+     */
+    DynBufferBlock *blocks, *blocks_tail;
+    int linear;
     int io_buffer_size;
     uint8_t io_buffer[1];
 } DynBuffer;
 
+static void dyn_buf_free_blocks(DynBuffer *d)
+{
+    DynBufferBlock *b = d->blocks;
+
+    while (b) {
+        DynBufferBlock *next = b->next;
+        av_free(b);
+        b = next;
+    }
+    d->blocks = d->blocks_tail = NULL;
+}
+
+static int dyn_buf_linearize(DynBuffer *d)
+{
+    uint8_t *p;
+
+    if (d->linear)
+        return 0;
+    d->linear = 1;
+
+    if (d->size > 0) {
+        d->buffer = av_malloc(d->size);
+        if (!d->buffer) {
+            dyn_buf_free_blocks(d);
+            d->allocated_size = 0;
+            d->size = 0;
+            return AVERROR(ENOMEM);
+        }
+        d->allocated_size = d->size;
+        p = d->buffer;
+        for (DynBufferBlock *b = d->blocks; b; b = b->next) {
+            memcpy(p, b->data, b->size);
+            p += b->size;
+        }
+    }
+    dyn_buf_free_blocks(d);
+    return 0;
+}
+
 static int dyn_buf_write(void *opaque, const uint8_t *buf, int buf_size)
 {
     DynBuffer *d = opaque;
     unsigned new_size;
 
-    /* reallocate buffer if needed */
     new_size = (unsigned)d->pos + buf_size;
     if (new_size < d->pos || new_size > INT_MAX)
         return AVERROR(ERANGE);
+
+    if (!d->linear) {
+        int total = buf_size;
+
+        /* sequential so far: append to the block chain, leaving the
+         * data written earlier in place */
+        while (buf_size > 0) {
+            DynBufferBlock *b = d->blocks_tail;
+            int space = b ? b->capacity - b->size : 0;
+            int copy;
+
+            if (!space) {
+                int cap = b ? FFMIN(b->capacity * 2, DYN_BUF_MAX_BLOCK)
+                            : DYN_BUF_MIN_BLOCK;
+                cap = FFMAX(cap, buf_size);
+                b   = av_malloc(sizeof(*b) + cap);
+                if (!b)
+                    return AVERROR(ENOMEM);
+                b->next     = NULL;
+                b->size     = 0;
+                b->capacity = cap;
+                if (d->blocks_tail)
+                    d->blocks_tail->next = b;
+                else
+                    d->blocks = b;
+                d->blocks_tail = b;
+                space = cap;
+            }
+            copy = FFMIN(space, buf_size);
+            memcpy(b->data + b->size, buf, copy);
+            b->size  += copy;
+            buf      += copy;
+            buf_size -= copy;
+            d->pos   += copy;
+        }
+        d->size = d->pos;
+        return total;
+    }
+
+    /* reallocate buffer if needed */
     if (new_size > d->allocated_size) {
         unsigned new_allocated_size = d->allocated_size ? d->allocated_size
                                                         : new_size;
@@ -1337,6 +1607,11 @@ static int64_t dyn_buf_seek(void *opaque, int64_t offset, int whence)
         return AVERROR(EINVAL);
     if (offset > INT_MAX)
         return AVERROR(ERANGE);
+    if (!d->linear && offset != d->size) {
+        int ret = dyn_buf_linearize(d);
+        if (ret < 0)
+            return ret;
+    }
     d->pos = offset;
     return 0;
 }
@@ -1391,6 +1666,12 @@ int avio_get_dyn_buf(AVIOContext *s, uint8_t **pbuffer)
 
     avio_flush(s);
 
+    if (dyn_buf_linearize(d) < 0) {
+        s->error = AVERROR(ENOMEM);
+        *pbuffer = NULL;
+        return 0;
+    }
+
     *pbuffer = d->buffer;
 
     return d->size;
@@ -1404,6 +1685,10 @@ void ffio_reset_dyn_buf(AVIOContext *s)
     ffio_init_context(ffiocontext(s), d->io_buffer, d->io_buffer_size,
                       1, d, NULL, s->write_packet, s->seek);
     s->max_packet_size = max_packet_size;
+    dyn_buf_free_blocks(d);
+    /* keep writing into an already linearized buffer, it is retained
+     * for later use */
+    d->linear = !!d->buffer;
     d->pos = d->size = 0;
 }
 
@@ -1427,6 +1712,8 @@ int avio_close_dyn_buf(AVIOContext *s, uint8_t **pbuffer)
     avio_flush(s);
 
     d = s->opaque;
+    if (dyn_buf_linearize(d) < 0)
+        padding = 0;
     *pbuffer = d->buffer;
     size = d->size;
 
@@ -1443,6 +1730,7 @@ void ffio_free_dyn_buf(AVIOContext **s)
         return;
 
     d = (*s)->opaque;
+    dyn_buf_free_blocks(d);
     av_free(d->buffer);
     avio_context_free(s);
 }
@@ -52,21 +52,99 @@ typedef struct CacheEntry {
     int size;
 } CacheEntry;
 
+/* In-memory copy of recently returned data, kept in an LRU list above
+ * the temp file tier so that re-reads of hot regions (indexes, moov)
+ * do not touch the disk at all. */
+typedef struct MemBlock {
+    struct MemBlock *prev, *next;
+    int64_t logical_pos;
+    int size;
+    uint8_t data[];
+} MemBlock;
+
 typedef struct CacheContext {
     AVClass *class;
     int fd;
     char *filename;
     struct AVTreeNode *root;
+    MemBlock *mem_head, *mem_tail;
+    int64_t mem_size;
     int64_t logical_pos;
     int64_t cache_pos;
     int64_t inner_pos;
     int64_t end;
     int is_true_eof;
     URLContext *inner;
-    int64_t cache_hit, cache_miss;
+    int64_t cache_hit, cache_miss, mem_hit;
     int read_ahead_limit;
+    int64_t mem_cache_size;
 } CacheContext;
 
+static void mem_block_unlink(CacheContext *c, MemBlock *b)
+{
+    if (b->prev)
+        b->prev->next = b->next;
+    else
+        c->mem_head = b->next;
+    if (b->next)
+        b->next->prev = b->prev;
+    else
+        c->mem_tail = b->prev;
+    b->prev = b->next = NULL;
+}
+
+static void mem_block_push_front(CacheContext *c, MemBlock *b)
+{
+    b->prev = NULL;
+    b->next = c->mem_head;
+    if (c->mem_head)
+        c->mem_head->prev = b;
+    c->mem_head = b;
+    if (!c->mem_tail)
+        c->mem_tail = b;
+}
+
+static int mem_cache_read(CacheContext *c, unsigned char *buf, int size)
+{
+    for (MemBlock *b = c->mem_head; b; b = b->next) {
+        int64_t in_block_pos = c->logical_pos - b->logical_pos;
+        if (in_block_pos >= 0 && in_block_pos < b->size) {
+            int r = FFMIN(size, b->size - in_block_pos);
+            memcpy(buf, b->data + in_block_pos, r);
+            if (b != c->mem_head) {
+                mem_block_unlink(c, b);
+                mem_block_push_front(c, b);
+            }
+            return r;
+        }
+    }
+    return 0;
+}
+
+static void mem_cache_add(CacheContext *c, const unsigned char *buf, int size)
+{
+    MemBlock *b;
+
+    if (size <= 0 || size > c->mem_cache_size)
+        return;
+
+    b = av_malloc(sizeof(*b) + size);
+    if (!b)
+        return;
+    b->logical_pos = c->logical_pos;
+    b->size        = size;
+    memcpy(b->data, buf, size);
+    mem_block_push_front(c, b);
+    c->mem_size += size;
+
+    while (c->mem_size > c->mem_cache_size && c->mem_tail != c->mem_head) {
+        MemBlock *last = c->mem_tail;
+        mem_block_unlink(c, last);
+        c->mem_size -= last->size;
+        av_free(last);
+    }
+}
+
 static int cmp(const void *key, const void *node)
 {
     return FFDIFFSIGN(*(const int64_t *)key, ((const CacheEntry *) node)->logical_pos);
@@ -166,6 +244,13 @@ static int cache_read(URLContext *h, unsigned char *buf, int size)
     CacheEntry *entry, *next[2] = {NULL, NULL};
     int64_t r;
 
+    r = mem_cache_read(c, buf, size);
+    if (r > 0) {
+        c->logical_pos += r;
+        c->mem_hit ++;
+        return r;
+    }
+
     entry = av_tree_find(c->root, &c->logical_pos, cmp, (void**)next);
 
     if (!entry)
@@ -188,6 +273,7 @@ static int cache_read(URLContext *h, unsigned char *buf, int size)
             }
 
             if (r > 0) {
+                mem_cache_add(c, buf, r);
                 c->cache_pos += r;
                 c->logical_pos += r;
                 c->cache_hit ++;
@@ -219,6 +305,7 @@ static int cache_read(URLContext *h, unsigned char *buf, int size)
     c->cache_miss ++;
 
     add_entry(h, buf, r);
+    mem_cache_add(c, buf, r);
     c->logical_pos += r;
     c->end = FFMAX(c->end, c->logical_pos);
 
@@ -301,8 +388,14 @@ static int cache_close(URLContext *h)
     CacheContext *c = h->priv_data;
     int ret;
 
-    av_log(h, AV_LOG_INFO, "Statistics, cache hits:%"PRId64" cache misses:%"PRId64"\n",
-           c->cache_hit, c->cache_miss);
+    av_log(h, AV_LOG_INFO, "Statistics, cache hits:%"PRId64" cache misses:%"PRId64" memory hits:%"PRId64"\n",
+           c->cache_hit, c->cache_miss, c->mem_hit);
+
+    while (c->mem_head) {
+        MemBlock *b = c->mem_head;
+        mem_block_unlink(c, b);
+        av_free(b);
+    }
 
     close(c->fd);
     if (c->filename) {
@@ -323,6 +416,7 @@ static int cache_close(URLContext *h)
 
 static const AVOption options[] = {
     { "read_ahead_limit", "Amount in bytes that may be read ahead when seeking isn't supported, -1 for unlimited", OFFSET(read_ahead_limit), AV_OPT_TYPE_INT, { .i64 = 65536 }, -1, INT_MAX, D },
+    { "mem_cache_size", "Amount in bytes of recently read data kept in memory, 0 to disable", OFFSET(mem_cache_size), AV_OPT_TYPE_INT64, { .i64 = 4 * 1024 * 1024 }, 0, INT64_MAX, D },
     {NULL},
 };
 
@@ -18,6 +18,8 @@
  * 51 Franklin Street, Fifth Floor, Boston, MA 02110-1301 USA.
  */
 
+#include "config.h"
+
 #include "libavutil/avstring.h"
 #include "libavutil/avassert.h"
 #include "libavutil/bprint.h"
@@ -25,6 +27,7 @@
 #include "libavutil/mem.h"
 #include "libavutil/opt.h"
 #include "libavutil/parseutils.h"
+#include "libavutil/thread.h"
 #include "libavutil/timestamp.h"
 #include "libavcodec/codec_desc.h"
 #include "libavcodec/bsf.h"
@@ -72,6 +75,16 @@ typedef struct {
     ConcatMatchMode stream_match_mode;
     unsigned auto_convert;
     int segment_time_metadata;
+    int prefetch;             /**< maximum number of files opened ahead of the consumer */
+#if HAVE_THREADS
+    pthread_t prefetch_thread;
+    pthread_mutex_t prefetch_lock;
+    pthread_cond_t prefetch_cond;
+    struct ConcatPrefetchSlot *prefetch_slots;
+    unsigned cur_fileno;      /**< file the consumer is currently reading */
+    int prefetch_started;
+    int prefetch_exit;
+#endif
 } ConcatContext;
 
 static int concat_probe(const AVProbeData *probe)
@@ -332,35 +345,38 @@ static int64_t get_best_effort_duration(ConcatFile *file, AVFormatContext *avf)
     return AV_NOPTS_VALUE;
 }
 
-static int open_file(AVFormatContext *avf, unsigned fileno)
+static int open_input_file(AVFormatContext *avf, ConcatFile *file,
+                           AVFormatContext **pavf)
 {
-    ConcatContext *cat = avf->priv_data;
-    ConcatFile *file = &cat->files[fileno];
     AVDictionary *options = NULL;
+    AVFormatContext *child;
     int ret;
 
-    if (cat->avf)
-        avformat_close_input(&cat->avf);
+    *pavf = NULL;
 
-    cat->avf = avformat_alloc_context();
-    if (!cat->avf)
+    child = avformat_alloc_context();
+    if (!child)
         return AVERROR(ENOMEM);
 
-    cat->avf->flags |= avf->flags & ~AVFMT_FLAG_CUSTOM_IO;
-    cat->avf->interrupt_callback = avf->interrupt_callback;
+    child->flags |= avf->flags & ~AVFMT_FLAG_CUSTOM_IO;
+    child->interrupt_callback = avf->interrupt_callback;
 
-    if ((ret = ff_copy_whiteblacklists(cat->avf, avf)) < 0)
+    if ((ret = ff_copy_whiteblacklists(child, avf)) < 0) {
+        avformat_close_input(&child);
         return ret;
+    }
 
     ret = av_dict_copy(&options, file->options, 0);
-    if (ret < 0)
+    if (ret < 0) {
+        avformat_close_input(&child);
         return ret;
+    }
 
-    if ((ret = avformat_open_input(&cat->avf, file->url, NULL, &options)) < 0 ||
-        (ret = avformat_find_stream_info(cat->avf, NULL)) < 0) {
+    if ((ret = avformat_open_input(&child, file->url, NULL, &options)) < 0 ||
+        (ret = avformat_find_stream_info(child, NULL)) < 0) {
         av_log(avf, AV_LOG_ERROR, "Impossible to open '%s'\n", file->url);
         av_dict_free(&options);
-        avformat_close_input(&cat->avf);
+        avformat_close_input(&child);
         return ret;
     }
     if (options) {
@@ -368,6 +384,184 @@ static int open_file(AVFormatContext *avf, unsigned fileno)
         /* TODO log unused options once we have a proper string API */
         av_dict_free(&options);
     }
+    *pavf = child;
+    return 0;
+}
+
+#if HAVE_THREADS
+typedef struct ConcatPrefetchSlot {
+    unsigned fileno;
+    int state;                /**< SLOT_EMPTY/OPENING/READY */
+    int ret;
+    AVFormatContext *avf;
+} ConcatPrefetchSlot;
+
+enum {
+    SLOT_EMPTY = 0,
+    SLOT_OPENING,
+    SLOT_READY,
+};
+
+static ConcatPrefetchSlot *prefetch_find(ConcatContext *cat, unsigned fileno)
+{
+    for (int i = 0; i < cat->prefetch; i++)
+        if (cat->prefetch_slots[i].state != SLOT_EMPTY &&
+            cat->prefetch_slots[i].fileno == fileno)
+            return &cat->prefetch_slots[i];
+    return NULL;
+}
+
+static void *concat_prefetch_thread(void *arg)
+{
+    AVFormatContext *avf = arg;
+    ConcatContext *cat = avf->priv_data;
+
+    ff_thread_setname("concat-prefetch");
+
+    pthread_mutex_lock(&cat->prefetch_lock);
+    while (!cat->prefetch_exit) {
+        unsigned last = FFMIN(cat->nb_files - 1, cat->cur_fileno + cat->prefetch);
+        ConcatPrefetchSlot *slot = NULL;
+        AVFormatContext *stale, *child;
+        unsigned fileno;
+        int ret;
+
+        /* first file in the prefetch window without a slot */
+        for (fileno = cat->cur_fileno + 1; fileno <= last; fileno++)
+            if (!prefetch_find(cat, fileno))
+                break;
+        if (fileno > last) {
+            pthread_cond_wait(&cat->prefetch_cond, &cat->prefetch_lock);
+            continue;
+        }
+
+        /* reuse a free slot, or one that fell outside the window (e.g.
+         * after a seek); slots being taken by the consumer stay untouched */
+        for (int i = 0; i < cat->prefetch; i++) {
+            ConcatPrefetchSlot *s = &cat->prefetch_slots[i];
+            if (s->state == SLOT_EMPTY ||
+                (s->state == SLOT_READY &&
+                 (s->fileno <= cat->cur_fileno || s->fileno > last))) {
+                slot = s;
+                break;
+            }
+        }
+        if (!slot) {
+            pthread_cond_wait(&cat->prefetch_cond, &cat->prefetch_lock);
+            continue;
+        }
+
+        stale        = slot->avf;
+        slot->avf    = NULL;
+        slot->fileno = fileno;
+        slot->state  = SLOT_OPENING;
+
+        pthread_mutex_unlock(&cat->prefetch_lock);
+        avformat_close_input(&stale);
+        ret = open_input_file(avf, &cat->files[fileno], &child);
+        pthread_mutex_lock(&cat->prefetch_lock);
+
+        slot->avf   = child;
+        slot->ret   = ret;
+        slot->state = SLOT_READY;
+        pthread_cond_broadcast(&cat->prefetch_cond);
+    }
+    pthread_mutex_unlock(&cat->prefetch_lock);
+    return NULL;
+}
+
+/**
+ * Take the prefetched context for fileno if the prefetch thread has it,
+ * waiting shortly when the open is still in flight. Also advances the
+ * prefetch window. Return 1 if *pavf and *err were filled, 0 otherwise.
+ */
+static int prefetch_take(ConcatContext *cat, unsigned fileno,
+                         AVFormatContext **pavf, int *err)
+{
+    ConcatPrefetchSlot *slot;
+    int taken = 0;
+
+    pthread_mutex_lock(&cat->prefetch_lock);
+    while ((slot = prefetch_find(cat, fileno)) &&
+           slot->state == SLOT_OPENING && !cat->prefetch_exit)
+        pthread_cond_wait(&cat->prefetch_cond, &cat->prefetch_lock);
+    if (slot && slot->state == SLOT_READY) {
+        *pavf       = slot->avf;
+        *err        = slot->ret;
+        slot->avf   = NULL;
+        slot->state = SLOT_EMPTY;
+        taken = 1;
+    }
+    cat->cur_fileno = fileno;
+    pthread_cond_broadcast(&cat->prefetch_cond);
+    pthread_mutex_unlock(&cat->prefetch_lock);
+    return taken;
+}
+
+static int prefetch_start(AVFormatContext *avf)
+{
+    ConcatContext *cat = avf->priv_data;
+    int ret;
+
+    cat->prefetch = FFMIN(cat->prefetch, (int)cat->nb_files - 1);
+    cat->prefetch_slots = av_calloc(cat->prefetch, sizeof(*cat->prefetch_slots));
+    if (!cat->prefetch_slots)
+        return AVERROR(ENOMEM);
+    pthread_mutex_init(&cat->prefetch_lock, NULL);
+    pthread_cond_init(&cat->prefetch_cond, NULL);
+
+    ret = pthread_create(&cat->prefetch_thread, NULL, concat_prefetch_thread, avf);
+    if (ret) {
+        pthread_cond_destroy(&cat->prefetch_cond);
+        pthread_mutex_destroy(&cat->prefetch_lock);
+        av_freep(&cat->prefetch_slots);
+        return AVERROR(ret);
+    }
+    cat->prefetch_started = 1;
+    return 0;
+}
+
+static void prefetch_stop(AVFormatContext *avf)
+{
+    ConcatContext *cat = avf->priv_data;
+
+    if (cat->prefetch_started) {
+        pthread_mutex_lock(&cat->prefetch_lock);
+        cat->prefetch_exit = 1;
+        pthread_cond_broadcast(&cat->prefetch_cond);
+        pthread_mutex_unlock(&cat->prefetch_lock);
+        pthread_join(cat->prefetch_thread, NULL);
+        pthread_cond_destroy(&cat->prefetch_cond);
+        pthread_mutex_destroy(&cat->prefetch_lock);
+        for (int i = 0; i < cat->prefetch; i++)
+            if (cat->prefetch_slots[i].avf)
+                avformat_close_input(&cat->prefetch_slots[i].avf);
+        cat->prefetch_started = 0;
+    }
+    av_freep(&cat->prefetch_slots);
+}
+#endif /* HAVE_THREADS */
+
+static int open_file(AVFormatContext *avf, unsigned fileno)
+{
+    ConcatContext *cat = avf->priv_data;
+    ConcatFile *file = &cat->files[fileno];
+    AVFormatContext *new_avf = NULL;
+    int ret = 0, prefetched = 0;
+
+#if HAVE_THREADS
+    if (cat->prefetch_started)
+        prefetched = prefetch_take(cat, fileno, &new_avf, &ret);
+#endif
+    if (!prefetched)
+        ret = open_input_file(avf, file, &new_avf);
+    if (ret < 0)
+        return ret;
+
+    if (cat->avf)
+        avformat_close_input(&cat->avf);
+    cat->avf = new_avf;
+
     cat->cur_file = file;
     file->start_time = !fileno ? 0 :
                        cat->files[fileno - 1].start_time +
@@ -396,6 +590,10 @@ static int concat_read_close(AVFormatContext *avf)
     ConcatContext *cat = avf->priv_data;
     unsigned i, j;
 
+#if HAVE_THREADS
+    prefetch_stop(avf);
+#endif
+
     for (i = 0; i < cat->nb_files; i++) {
         av_freep(&cat->files[i].url);
         for (j = 0; j < cat->files[i].nb_streams; j++) {
@@ -699,6 +897,16 @@ static int concat_read_header(AVFormatContext *avf)
     if ((ret = open_file(avf, 0)) < 0)
         return ret;
 
+    if (cat->prefetch > 0 && cat->nb_files > 1) {
+#if HAVE_THREADS
+        if ((ret = prefetch_start(avf)) < 0)
+            return ret;
+#else
+        av_log(avf, AV_LOG_WARNING,
+               "Prefetching requires threading support, option ignored\n");
+#endif
+    }
+
     return 0;
 }
 
@@ -939,6 +1147,8 @@ static const AVOption options[] = {
       OFFSET(auto_convert), AV_OPT_TYPE_BOOL, {.i64 = 1}, 0, 1, DEC },
     { "segment_time_metadata", "output file segment start time and duration as packet metadata",
       OFFSET(segment_time_metadata), AV_OPT_TYPE_BOOL, {.i64 = 0}, 0, 1, DEC },
+    { "prefetch", "number of upcoming files to open and probe in a background thread (0 = off)",
+      OFFSET(prefetch), AV_OPT_TYPE_INT, {.i64 = 0}, 0, 16, DEC },
     { NULL }
 };
 
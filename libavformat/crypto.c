@@ -23,12 +23,26 @@
 #include "libavutil/avstring.h"
 #include "libavutil/mem.h"
 #include "libavutil/opt.h"
+#include "libavutil/thread.h"
 #include "url.h"
 
 // encourage reads of 4096 bytes - 1 block is always retained.
 #define MAX_BUFFER_BLOCKS 257
 #define BLOCKSIZE 16
 
+// backpressure limit for the background write thread
+#define MAX_QUEUED_BYTES (4 * 1024 * 1024)
+
+#if HAVE_THREADS
+typedef struct CryptoWriteJob {
+    struct CryptoWriteJob *next;
+    int size;
+    uint8_t data[];
+} CryptoWriteJob;
+
+static void *crypto_write_thread(void *arg);
+#endif
+
 typedef struct CryptoContext {
     const AVClass *class;
     URLContext *hd;
@@ -57,6 +71,18 @@ typedef struct CryptoContext {
     unsigned int write_buf_size;
     uint8_t pad[BLOCKSIZE];
     int pad_len;
+    int async_write;
+#if HAVE_THREADS
+    int thread_started;
+    pthread_t write_thread;
+    pthread_mutex_t mutex;
+    pthread_cond_t cond_wakeup_main;
+    pthread_cond_t cond_wakeup_background;
+    CryptoWriteJob *queue_head, *queue_tail;
+    int64_t queued_bytes;
+    int write_eof;
+    int write_ret;  ///< first error seen by the background thread
+#endif
 } CryptoContext;
 
 #define OFFSET(x) offsetof(CryptoContext, x)
@@ -69,6 +95,7 @@ static const AVOption crypto_options[] = {
     {"decryption_iv",  "AES decryption initialization vector", OFFSET(decrypt_iv),  AV_OPT_TYPE_BINARY, .flags = D },
     {"encryption_key", "AES encryption key",                   OFFSET(encrypt_key), AV_OPT_TYPE_BINARY, .flags = E },
     {"encryption_iv",  "AES encryption initialization vector", OFFSET(encrypt_iv),  AV_OPT_TYPE_BINARY, .flags = E },
+    {"async_write", "encrypt and write in a background thread", OFFSET(async_write), AV_OPT_TYPE_BOOL, {.i64 = 0}, 0, 1, E },
     { NULL }
 };
 
@@ -172,6 +199,33 @@ static int crypto_open2(URLContext *h, const char *uri, int flags, AVDictionary
         // for write, we must be streamed
         // - linear write only for crypto aes-128-cbc
         h->is_streamed = 1;
+
+#if HAVE_THREADS
+        if (c->async_write) {
+            ret = AVERROR(pthread_mutex_init(&c->mutex, NULL));
+            if (ret < 0)
+                goto err;
+            ret = AVERROR(pthread_cond_init(&c->cond_wakeup_main, NULL));
+            if (ret < 0) {
+                pthread_mutex_destroy(&c->mutex);
+                goto err;
+            }
+            ret = AVERROR(pthread_cond_init(&c->cond_wakeup_background, NULL));
+            if (ret < 0) {
+                pthread_cond_destroy(&c->cond_wakeup_main);
+                pthread_mutex_destroy(&c->mutex);
+                goto err;
+            }
+            ret = AVERROR(pthread_create(&c->write_thread, NULL, crypto_write_thread, h));
+            if (ret < 0) {
+                pthread_cond_destroy(&c->cond_wakeup_background);
+                pthread_cond_destroy(&c->cond_wakeup_main);
+                pthread_mutex_destroy(&c->mutex);
+                goto err;
+            }
+            c->thread_started = 1;
+        }
+#endif
     }
 
 err:
@@ -322,7 +376,7 @@ static int64_t crypto_seek(URLContext *h, int64_t pos, int whence)
     return c->position;
 }
 
-static int crypto_write(URLContext *h, const unsigned char *buf, int size)
+static int crypto_write_sync(URLContext *h, const unsigned char *buf, int size)
 {
     CryptoContext *c = h->priv_data;
     int total_size, blocks, pad_len, out_size;
@@ -363,12 +417,107 @@ static int crypto_write(URLContext *h, const unsigned char *buf, int size)
     return size;
 }
 
+#if HAVE_THREADS
+static void *crypto_write_thread(void *arg)
+{
+    URLContext *h = arg;
+    CryptoContext *c = h->priv_data;
+
+    pthread_mutex_lock(&c->mutex);
+    while (1) {
+        CryptoWriteJob *job;
+        int ret;
+
+        while (!c->queue_head && !c->write_eof)
+            pthread_cond_wait(&c->cond_wakeup_background, &c->mutex);
+        job = c->queue_head;
+        if (!job)
+            break;
+        c->queue_head = job->next;
+        if (!c->queue_head)
+            c->queue_tail = NULL;
+        ret = c->write_ret;
+        pthread_mutex_unlock(&c->mutex);
+
+        if (ret >= 0)
+            ret = crypto_write_sync(h, job->data, job->size);
+
+        pthread_mutex_lock(&c->mutex);
+        c->queued_bytes -= job->size;
+        if (ret < 0 && c->write_ret >= 0)
+            c->write_ret = ret;
+        av_free(job);
+        pthread_cond_signal(&c->cond_wakeup_main);
+    }
+    pthread_mutex_unlock(&c->mutex);
+
+    return NULL;
+}
+#endif
+
+static int crypto_write(URLContext *h, const unsigned char *buf, int size)
+{
+    CryptoContext *c = h->priv_data;
+
+#if HAVE_THREADS
+    if (c->thread_started) {
+        CryptoWriteJob *job;
+        int ret;
+
+        job = av_malloc(sizeof(*job) + size);
+        if (!job)
+            return AVERROR(ENOMEM);
+        job->next = NULL;
+        job->size = size;
+        memcpy(job->data, buf, size);
+
+        pthread_mutex_lock(&c->mutex);
+        while (c->queued_bytes > MAX_QUEUED_BYTES && c->write_ret >= 0)
+            pthread_cond_wait(&c->cond_wakeup_main, &c->mutex);
+        ret = c->write_ret;
+        if (ret >= 0) {
+            if (c->queue_tail)
+                c->queue_tail->next = job;
+            else
+                c->queue_head = job;
+            c->queue_tail = job;
+            c->queued_bytes += size;
+            pthread_cond_signal(&c->cond_wakeup_background);
+        }
+        pthread_mutex_unlock(&c->mutex);
+
+        if (ret < 0) {
+            av_free(job);
+            return ret;
+        }
+        return size;
+    }
+#endif
+
+    return crypto_write_sync(h, buf, size);
+}
+
 static int crypto_close(URLContext *h)
 {
     CryptoContext *c = h->priv_data;
     int ret = 0;
 
-    if (c->aes_encrypt) {
+#if HAVE_THREADS
+    if (c->thread_started) {
+        pthread_mutex_lock(&c->mutex);
+        c->write_eof = 1;
+        pthread_cond_signal(&c->cond_wakeup_background);
+        pthread_mutex_unlock(&c->mutex);
+        pthread_join(c->write_thread, NULL);
+        pthread_mutex_destroy(&c->mutex);
+        pthread_cond_destroy(&c->cond_wakeup_main);
+        pthread_cond_destroy(&c->cond_wakeup_background);
+        c->thread_started = 0;
+        ret = c->write_ret;
+    }
+#endif
+
+    if (c->aes_encrypt && ret >= 0) {
         uint8_t out_buf[BLOCKSIZE];
         int pad = BLOCKSIZE - c->pad_len;
 
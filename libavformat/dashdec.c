@@ -24,12 +24,14 @@
 #include "libavutil/bprint.h"
 #include "libavutil/mem.h"
 #include "libavutil/opt.h"
+#include "libavutil/thread.h"
 #include "libavutil/time.h"
 #include "libavutil/parseutils.h"
 #include "internal.h"
 #include "avio_internal.h"
 #include "dash.h"
 #include "demux.h"
+#include "http.h"
 #include "url.h"
 
 #define INITIAL_BUFFER_SIZE 32768
@@ -118,8 +120,37 @@ struct representation {
     uint32_t init_sec_buf_read_offset;
     int64_t cur_timestamp;
     int is_restart_needed;
+
+    /* current segment prefetched into memory, served instead of input */
+    uint8_t *seg_buf;
+    uint32_t seg_buf_len;
+    uint32_t seg_buf_read_offset;
+};
+
+#if HAVE_THREADS
+enum PrefetchJobState {
+    JOB_QUEUED,
+    JOB_RUNNING,
+    JOB_DONE,
 };
 
+typedef struct PrefetchJob {
+    struct PrefetchJob *next;
+    struct representation *pls;
+    int64_t seq_no;
+    char *url;
+    AVDictionary *opts;
+
+    uint8_t *buf;
+    uint32_t data_len;
+    /* bytes counted against the prefetch memory budget */
+    int64_t accounted;
+
+    int ret;
+    enum PrefetchJobState state;
+} PrefetchJob;
+#endif
+
 typedef struct DASHContext {
     const AVClass *class;
     char *base_url;
@@ -160,6 +191,21 @@ typedef struct DASHContext {
     int is_init_section_common_audio;
     int is_init_section_common_subtitle;
 
+    /* segment prefetching */
+    int prefetch_segments;
+    int prefetch_threads;
+    int64_t prefetch_max_bytes;
+#if HAVE_THREADS
+    pthread_mutex_t prefetch_lock;
+    pthread_cond_t  prefetch_cond;      /* signalled when new jobs are queued */
+    pthread_cond_t  prefetch_done_cond; /* signalled when a job completes */
+    PrefetchJob    *prefetch_jobs;
+    pthread_t      *prefetch_workers;
+    int             nb_prefetch_workers;
+    int             prefetch_abort;
+    int64_t         prefetch_bytes;
+#endif
+
 } DASHContext;
 
 static int ishttp(char *url)
@@ -355,6 +401,7 @@ static void free_representation(struct representation *pls)
     free_fragment(&pls->cur_seg);
     free_fragment(&pls->init_section);
     av_freep(&pls->init_sec_buf);
+    av_freep(&pls->seg_buf);
     av_freep(&pls->pb.pub.buffer);
     ff_format_io_close(pls->parent, &pls->input);
     if (pls->ctx) {
@@ -1780,6 +1827,361 @@ static int update_init_section(struct representation *pls)
     return 0;
 }
 
+#if HAVE_THREADS
+
+/* nominal size charged against the memory budget until a segment has
+ * actually been downloaded and its real size is known */
+#define PREFETCH_SEG_ESTIMATE (4 * 1024 * 1024)
+
+static int prefetch_check_interrupt(void *opaque)
+{
+    DASHContext *c = opaque;
+    return c->prefetch_abort;
+}
+
+/* unlink and free the job pointed to by *pjob; called with the lock held */
+static void prefetch_free_job(DASHContext *c, PrefetchJob **pjob)
+{
+    PrefetchJob *job = *pjob;
+
+    *pjob = job->next;
+    c->prefetch_bytes -= job->accounted;
+    av_dict_free(&job->opts);
+    av_freep(&job->buf);
+    av_freep(&job->url);
+    av_free(job);
+}
+
+/* download a whole segment into job->buf; *pb is the persistent connection
+ * of the calling worker, reused across segments on the same host */
+static int prefetch_download(AVFormatContext *s, PrefetchJob *job, AVIOContext **pb)
+{
+    DASHContext *c = s->priv_data;
+    AVIOInterruptCB int_cb = { prefetch_check_interrupt, c };
+    uint32_t buf_size = 0;
+    int ret = 0, reused = 0;
+
+#if CONFIG_HTTP_PROTOCOL
+    if (*pb && av_strstart(job->url, "http", NULL)) {
+        URLContext *uc = ffio_geturlcontext(*pb);
+
+        if (uc) {
+            (*pb)->eof_reached = 0;
+            reused = ff_http_do_new_request(uc, job->url) >= 0;
+        }
+        if (!reused)
+            avio_closep(pb);
+    }
+#endif
+    if (!reused) {
+        avio_closep(pb);
+        ret = ffio_open_whitelist(pb, job->url, AVIO_FLAG_READ, &int_cb,
+                                  &job->opts, s->protocol_whitelist,
+                                  s->protocol_blacklist);
+        if (ret < 0)
+            return ret;
+    }
+
+    while (1) {
+        if (job->data_len == buf_size) {
+            uint8_t *tmp;
+
+            if (buf_size >= c->prefetch_max_bytes) {
+                ret = AVERROR(ENOMEM);
+                break;
+            }
+            buf_size = FFMIN(buf_size + (256 << 10), c->prefetch_max_bytes);
+            tmp = av_realloc(job->buf, buf_size);
+            if (!tmp) {
+                ret = AVERROR(ENOMEM);
+                break;
+            }
+            job->buf = tmp;
+        }
+
+        ret = avio_read(*pb, job->buf + job->data_len, buf_size - job->data_len);
+        if (ret <= 0) {
+            if (ret == AVERROR_EOF || ret == 0)
+                ret = 0;
+            break;
+        }
+        job->data_len += ret;
+    }
+
+    if (ret < 0) {
+        av_freep(&job->buf);
+        job->data_len = 0;
+        /* connection state is unknown after a failure */
+        avio_closep(pb);
+    }
+
+    return ret;
+}
+
+static void *prefetch_worker(void *arg)
+{
+    AVFormatContext *s = arg;
+    DASHContext *c = s->priv_data;
+    AVIOContext *pb = NULL;
+
+    ff_thread_setname("dash-prefetch");
+
+    pthread_mutex_lock(&c->prefetch_lock);
+    while (!c->prefetch_abort) {
+        PrefetchJob *job;
+        int ret;
+
+        for (job = c->prefetch_jobs; job; job = job->next)
+            if (job->state == JOB_QUEUED)
+                break;
+        if (!job) {
+            pthread_cond_wait(&c->prefetch_cond, &c->prefetch_lock);
+            continue;
+        }
+
+        job->state = JOB_RUNNING;
+        pthread_mutex_unlock(&c->prefetch_lock);
+
+        ret = prefetch_download(s, job, &pb);
+
+        pthread_mutex_lock(&c->prefetch_lock);
+        job->ret   = ret;
+        job->state = JOB_DONE;
+        c->prefetch_bytes += (int64_t)job->data_len - job->accounted;
+        job->accounted = job->data_len;
+        pthread_cond_broadcast(&c->prefetch_done_cond);
+    }
+    pthread_mutex_unlock(&c->prefetch_lock);
+
+    avio_closep(&pb);
+    return NULL;
+}
+
+/* queue downloads of the next prefetch_segments segments of pls and drop
+ * jobs that fell outside the window (e.g. after a seek) */
+static void prefetch_schedule(AVFormatContext *s, struct representation *pls)
+{
+    DASHContext *c = s->priv_data;
+    PrefetchJob **pj;
+    int64_t seq;
+
+    /* only template/timeline VOD representations are prefetched: live
+     * segments may not be available yet and SegmentURL lists can be byte
+     * ranges of one file, which the seek_data() path relies on */
+    if (!c->nb_prefetch_workers || c->is_live || pls->n_fragments ||
+        !pls->url_template)
+        return;
+
+    pthread_mutex_lock(&c->prefetch_lock);
+
+    pj = &c->prefetch_jobs;
+    while (*pj) {
+        PrefetchJob *job = *pj;
+
+        if (job->pls == pls && job->state != JOB_RUNNING &&
+            (job->seq_no <= pls->cur_seq_no ||
+             job->seq_no >  pls->cur_seq_no + c->prefetch_segments)) {
+            prefetch_free_job(c, pj);
+            continue;
+        }
+        pj = &job->next;
+    }
+
+    for (seq = pls->cur_seq_no + 1;
+         seq <= FFMIN(pls->cur_seq_no + c->prefetch_segments, pls->last_seq_no);
+         seq++) {
+        PrefetchJob *job;
+        char *tmpfilename, *url;
+
+        for (job = c->prefetch_jobs; job; job = job->next)
+            if (job->pls == pls && job->seq_no == seq)
+                break;
+        if (job)
+            continue;
+
+        if (c->prefetch_bytes + PREFETCH_SEG_ESTIMATE > c->prefetch_max_bytes)
+            break;
+
+        tmpfilename = av_mallocz(c->max_url_size);
+        url         = av_mallocz(c->max_url_size);
+        job         = av_mallocz(sizeof(*job));
+        if (!tmpfilename || !url || !job) {
+            av_free(tmpfilename);
+            av_free(url);
+            av_free(job);
+            break;
+        }
+
+        ff_dash_fill_tmpl_params(tmpfilename, c->max_url_size,
+                                 pls->url_template, 0, seq, 0,
+                                 get_segment_start_time_based_on_timeline(pls, seq));
+        ff_make_absolute_url(url, c->max_url_size, c->base_url, tmpfilename);
+        av_free(tmpfilename);
+
+        job->pls       = pls;
+        job->seq_no    = seq;
+        job->url       = url;
+        job->state     = JOB_QUEUED;
+        job->accounted = PREFETCH_SEG_ESTIMATE;
+        av_dict_copy(&job->opts, c->avio_opts, 0);
+
+        c->prefetch_bytes += job->accounted;
+
+        /* append, so that workers pick jobs up in submission order */
+        for (pj = &c->prefetch_jobs; *pj; pj = &(*pj)->next)
+            ;
+        *pj = job;
+
+        pthread_cond_signal(&c->prefetch_cond);
+    }
+
+    pthread_mutex_unlock(&c->prefetch_lock);
+}
+
+/* take over the downloaded data for the current segment of pls, waiting for
+ * its job to complete if it is still in flight
+ *
+ * @return 1 if the segment was attached to pls->seg_buf, 0 otherwise
+ */
+static int prefetch_fetch(AVFormatContext *s, struct representation *pls)
+{
+    DASHContext *c = s->priv_data;
+    PrefetchJob **pj, *job;
+    int ret = 0;
+
+    if (!c->nb_prefetch_workers)
+        return 0;
+
+    pthread_mutex_lock(&c->prefetch_lock);
+
+    for (pj = &c->prefetch_jobs; *pj; pj = &(*pj)->next)
+        if ((*pj)->pls == pls && (*pj)->seq_no == pls->cur_seq_no)
+            break;
+    job = *pj;
+    if (job) {
+        while (job->state != JOB_DONE && !c->prefetch_abort)
+            pthread_cond_wait(&c->prefetch_done_cond, &c->prefetch_lock);
+
+        if (job->state == JOB_DONE) {
+            if (job->ret >= 0) {
+                pls->seg_buf             = job->buf;
+                pls->seg_buf_len         = job->data_len;
+                pls->seg_buf_read_offset = 0;
+                job->buf      = NULL;
+                job->data_len = 0;
+                ret = 1;
+            } else {
+                av_log(s, AV_LOG_WARNING,
+                       "Prefetching segment %"PRId64" failed: %s\n",
+                       job->seq_no, av_err2str(job->ret));
+            }
+            prefetch_free_job(c, pj);
+        }
+    }
+
+    pthread_mutex_unlock(&c->prefetch_lock);
+
+    return ret;
+}
+
+static int prefetch_init(AVFormatContext *s)
+{
+    DASHContext *c = s->priv_data;
+    int ret;
+
+    if (!c->prefetch_segments || c->is_live)
+        return 0;
+
+    ret = pthread_mutex_init(&c->prefetch_lock, NULL);
+    if (ret)
+        return AVERROR(ret);
+    ret = pthread_cond_init(&c->prefetch_cond, NULL);
+    if (ret)
+        goto cond_fail;
+    ret = pthread_cond_init(&c->prefetch_done_cond, NULL);
+    if (ret)
+        goto done_cond_fail;
+
+    c->prefetch_workers = av_calloc(c->prefetch_threads,
+                                    sizeof(*c->prefetch_workers));
+    if (!c->prefetch_workers) {
+        ret = ENOMEM;
+        goto workers_fail;
+    }
+
+    for (int i = 0; i < c->prefetch_threads; i++) {
+        ret = pthread_create(&c->prefetch_workers[i], NULL, prefetch_worker, s);
+        if (ret)
+            break;
+        c->nb_prefetch_workers++;
+    }
+
+    if (!c->nb_prefetch_workers) {
+        av_freep(&c->prefetch_workers);
+        goto workers_fail;
+    }
+
+    return 0;
+
+workers_fail:
+    pthread_cond_destroy(&c->prefetch_done_cond);
+done_cond_fail:
+    pthread_cond_destroy(&c->prefetch_cond);
+cond_fail:
+    pthread_mutex_destroy(&c->prefetch_lock);
+    av_log(s, AV_LOG_WARNING, "Failed to start prefetching threads: %s\n",
+           av_err2str(AVERROR(ret)));
+    return 0;
+}
+
+static void prefetch_uninit(AVFormatContext *s)
+{
+    DASHContext *c = s->priv_data;
+
+    if (!c->nb_prefetch_workers)
+        return;
+
+    pthread_mutex_lock(&c->prefetch_lock);
+    c->prefetch_abort = 1;
+    pthread_cond_broadcast(&c->prefetch_cond);
+    pthread_cond_broadcast(&c->prefetch_done_cond);
+    pthread_mutex_unlock(&c->prefetch_lock);
+
+    for (int i = 0; i < c->nb_prefetch_workers; i++)
+        pthread_join(c->prefetch_workers[i], NULL);
+    c->nb_prefetch_workers = 0;
+    av_freep(&c->prefetch_workers);
+
+    while (c->prefetch_jobs)
+        prefetch_free_job(c, &c->prefetch_jobs);
+
+    pthread_cond_destroy(&c->prefetch_done_cond);
+    pthread_cond_destroy(&c->prefetch_cond);
+    pthread_mutex_destroy(&c->prefetch_lock);
+}
+
+#else /* HAVE_THREADS */
+
+static void prefetch_schedule(AVFormatContext *s, struct representation *pls)
+{
+}
+
+static int prefetch_fetch(AVFormatContext *s, struct representation *pls)
+{
+    return 0;
+}
+
+static int prefetch_init(AVFormatContext *s)
+{
+    return 0;
+}
+
+static void prefetch_uninit(AVFormatContext *s)
+{
+}
+
+#endif /* HAVE_THREADS */
+
 static int64_t seek_data(void *opaque, int64_t offset, int whence)
 {
     struct representation *v = opaque;
@@ -1797,7 +2199,7 @@ static int read_data(void *opaque, uint8_t *buf, int buf_size)
     DASHContext *c = v->parent->priv_data;
 
 restart:
-    if (!v->input) {
+    if (!v->input && !v->seg_buf) {
         free_fragment(&v->cur_seg);
         v->cur_seg = get_current_fragment(v);
         if (!v->cur_seg) {
@@ -1810,16 +2212,20 @@ restart:
         if (ret)
             goto end;
 
-        ret = open_input(c, v, v->cur_seg);
-        if (ret < 0) {
-            if (ff_check_interrupt(c->interrupt_callback)) {
-                ret = AVERROR_EXIT;
-                goto end;
+        if (!prefetch_fetch(v->parent, v)) {
+            ret = open_input(c, v, v->cur_seg);
+            if (ret < 0) {
+                if (ff_check_interrupt(c->interrupt_callback)) {
+                    ret = AVERROR_EXIT;
+                    goto end;
+                }
+                av_log(v->parent, AV_LOG_WARNING, "Failed to open fragment of playlist\n");
+                v->cur_seq_no++;
+                goto restart;
             }
-            av_log(v->parent, AV_LOG_WARNING, "Failed to open fragment of playlist\n");
-            v->cur_seq_no++;
-            goto restart;
         }
+
+        prefetch_schedule(v->parent, v);
     }
 
     if (v->init_sec_buf_read_offset < v->init_sec_data_len) {
@@ -1831,6 +2237,22 @@ restart:
         goto end;
     }
 
+    if (v->seg_buf) {
+        /* serve the prefetched segment from memory */
+        int copy_size = FFMIN((int)(v->seg_buf_len - v->seg_buf_read_offset),
+                              buf_size);
+        if (copy_size > 0) {
+            memcpy(buf, v->seg_buf + v->seg_buf_read_offset, copy_size);
+            v->seg_buf_read_offset += copy_size;
+            ret = copy_size;
+            goto end;
+        }
+        av_freep(&v->seg_buf);
+        v->seg_buf_len = v->seg_buf_read_offset = 0;
+        ret = 0;
+        goto segment_eof;
+    }
+
     /* check the v->cur_seg, if it is null, get current and double check if the new v->cur_seg*/
     if (!v->cur_seg) {
         v->cur_seg = get_current_fragment(v);
@@ -1843,6 +2265,8 @@ restart:
     if (ret > 0)
         goto end;
 
+segment_eof:
+
     if (c->is_live || v->cur_seq_no < v->last_seq_no) {
         if (!v->is_restart_needed)
             v->cur_seq_no++;
@@ -2058,6 +2482,10 @@ static int dash_read_header(AVFormatContext *s)
         av_dict_set(&c->avio_opts, "seekable", "0", 0);
     }
 
+    ret = prefetch_init(s);
+    if (ret < 0)
+        return ret;
+
     if(c->n_videos)
         c->is_init_section_common_video = is_common_init_section_exist(c->videos, c->n_videos);
 
@@ -2240,6 +2668,7 @@ static int dash_read_packet(AVFormatContext *s, AVPacket *pkt)
 static int dash_close(AVFormatContext *s)
 {
     DASHContext *c = s->priv_data;
+    prefetch_uninit(s);
     free_audio_list(c);
     free_video_list(c);
     free_subtitle_list(c);
@@ -2269,6 +2698,8 @@ static int dash_seek(AVFormatContext *s, struct representation *pls, int64_t see
     }
 
     ff_format_io_close(pls->parent, &pls->input);
+    av_freep(&pls->seg_buf);
+    pls->seg_buf_len = pls->seg_buf_read_offset = 0;
 
     // find the nearest fragment
     if (pls->n_timelines > 0 && pls->fragment_timescale > 0) {
@@ -2367,6 +2798,12 @@ static const AVOption dash_options[] = {
         {.str = "aac,m4a,m4s,m4v,mov,mp4,webm,ts"},
         INT_MIN, INT_MAX, FLAGS},
     { "cenc_decryption_key", "Media decryption key (hex)", OFFSET(cenc_decryption_key), AV_OPT_TYPE_STRING, {.str = NULL}, INT_MIN, INT_MAX, .flags = FLAGS },
+    { "prefetch_segments", "number of upcoming segments downloaded ahead of time per representation",
+        OFFSET(prefetch_segments), AV_OPT_TYPE_INT, {.i64 = 0}, 0, 16, FLAGS },
+    { "prefetch_threads", "number of download threads shared by all representations",
+        OFFSET(prefetch_threads), AV_OPT_TYPE_INT, {.i64 = 4}, 1, 16, FLAGS },
+    { "prefetch_max_bytes", "maximum total memory used for prefetched segments",
+        OFFSET(prefetch_max_bytes), AV_OPT_TYPE_INT64, {.i64 = 64 * 1024 * 1024}, 1024 * 1024, INT_MAX, FLAGS },
     {NULL}
 };
 
@@ -25,6 +25,7 @@
 
 #include "libavutil/avassert.h"
 #include "libavutil/avstring.h"
+#include "libavutil/cpu.h"
 #include "libavutil/dict.h"
 #include "libavutil/internal.h"
 #include "libavutil/intreadwrite.h"
@@ -32,6 +33,7 @@
 #include "libavutil/mem.h"
 #include "libavutil/opt.h"
 #include "libavutil/pixfmt.h"
+#include "libavutil/thread.h"
 #include "libavutil/time.h"
 #include "libavutil/timestamp.h"
 
@@ -1055,7 +1057,13 @@ static void compute_pkt_fields(AVFormatContext *s, AVStream *st,
             pkt->dts = AV_NOPTS_VALUE;
     }
 
-    duration = av_mul_q((AVRational) {pkt->duration, 1}, st->time_base);
+    if (pkt->duration == sti->last_duration && sti->last_duration_sec.den) {
+        duration = sti->last_duration_sec;
+    } else {
+        duration = av_mul_q((AVRational) {pkt->duration, 1}, st->time_base);
+        sti->last_duration     = pkt->duration;
+        sti->last_duration_sec = duration;
+    }
     if (pkt->duration <= 0) {
         compute_frame_duration(s, &num, &den, st, pc, pkt);
         if (den && num) {
@@ -1248,11 +1256,14 @@ static int parse_packet(AVFormatContext *s, AVPacket *pkt,
         if (!out_pkt->size)
             continue;
 
-        if (pkt->buf && out_pkt->data == pkt->data) {
-            /* reference pkt->buf only when out_pkt->data is guaranteed to point
-             * to data in it and not in the parser's internal buffer. */
-            /* XXX: Ensure this is the case with all parsers when sti->parser->flags
-             * is PARSER_FLAG_COMPLETE_FRAMES and check for that instead? */
+        if (pkt->buf && out_pkt->data >= pkt->data &&
+            out_pkt->data + out_pkt->size <= pkt->data + pkt->size) {
+            /* The parser returned a range inside the input packet, as happens
+             * when it passes complete frames through or finds a frame end
+             * within the current packet without having buffered data of its
+             * own; reference pkt->buf instead of copying the frame out.
+             * Input packets are padded, so any range ending at or before
+             * pkt->size satisfies the padding requirement. */
             out_pkt->buf = av_buffer_ref(pkt->buf);
             if (!out_pkt->buf) {
                 ret = AVERROR(ENOMEM);
@@ -1268,11 +1279,19 @@ static int parse_packet(AVFormatContext *s, AVPacket *pkt,
         out_pkt->duration = (sti->parser->flags & PARSER_FLAG_COMPLETE_FRAMES) ? pkt->duration : 0;
         if (st->codecpar->codec_type == AVMEDIA_TYPE_AUDIO) {
             if (sti->avctx->sample_rate > 0) {
-                out_pkt->duration =
-                    av_rescale_q_rnd(sti->parser->duration,
-                                     (AVRational) { 1, sti->avctx->sample_rate },
-                                     st->time_base,
-                                     AV_ROUND_DOWN);
+                if (sti->parser->duration   == sti->last_parser_duration &&
+                    sti->avctx->sample_rate == sti->last_parser_sample_rate) {
+                    out_pkt->duration = sti->last_parser_duration_tb;
+                } else {
+                    out_pkt->duration =
+                        av_rescale_q_rnd(sti->parser->duration,
+                                         (AVRational) { 1, sti->avctx->sample_rate },
+                                         st->time_base,
+                                         AV_ROUND_DOWN);
+                    sti->last_parser_duration    = sti->parser->duration;
+                    sti->last_parser_sample_rate = sti->avctx->sample_rate;
+                    sti->last_parser_duration_tb = out_pkt->duration;
+                }
             }
         } else if (st->codecpar->codec_id == AV_CODEC_ID_GIF) {
             if (st->time_base.num > 0 && st->time_base.den > 0 &&
@@ -2132,8 +2151,11 @@ static int has_codec_parameters(const AVStream *st, const char **errmsg_ptr)
 }
 
 /* returns 1 or 0 if or if not decoded data was returned, or a negative error */
+/* codec_info_nb_frames is passed in explicitly because the decode may run on
+ * a worker thread while sti->codec_info_nb_frames is updated by the caller. */
 static int try_decode_frame(AVFormatContext *s, AVStream *st,
-                            const AVPacket *pkt, AVDictionary **options)
+                            const AVPacket *pkt, AVDictionary **options,
+                            int codec_info_nb_frames)
 {
     FFStream *const sti = ffstream(st);
     AVCodecContext *const avctx = sti->avctx;
@@ -2195,7 +2217,7 @@ static int try_decode_frame(AVFormatContext *s, AVStream *st,
     while ((pkt_to_send || (!pkt->data && got_picture)) &&
            ret >= 0 &&
            (!has_codec_parameters(st, NULL) || !has_decode_delay_been_guessed(st) ||
-            (!sti->codec_info_nb_frames &&
+            (!codec_info_nb_frames &&
              (avctx->codec->capabilities & AV_CODEC_CAP_CHANNEL_CONF)))) {
         got_picture = 0;
         if (avctx->codec_type == AVMEDIA_TYPE_VIDEO ||
@@ -2234,6 +2256,285 @@ fail:
     return ret;
 }
 
+#if HAVE_THREADS
+
+#define STREAM_INFO_MAX_QUEUED_BYTES (16 * 1024 * 1024)
+#define STREAM_INFO_MAX_WORKERS 16
+
+typedef struct StreamInfoTask {
+    struct StreamInfoTask *next;
+    AVPacket *pkt;
+    AVStream *st;
+    AVDictionary **options;
+    int codec_info_nb_frames;
+} StreamInfoTask;
+
+typedef struct StreamInfoWorker {
+    struct StreamInfoPool *pool;
+    pthread_t thread;
+    StreamInfoTask *head, *tail;
+} StreamInfoWorker;
+
+/* Pool of worker threads decoding probe frames during
+ * avformat_find_stream_info(). Streams are independent of each other, so
+ * with many streams the decodes can run in parallel; tasks for one stream
+ * always go to the same worker to preserve the decode order. The main
+ * thread must wait for a stream to become idle before it touches state
+ * that try_decode_frame() also touches (sti->avctx, sti->info). */
+typedef struct StreamInfoPool {
+    AVFormatContext *ic;
+    pthread_mutex_t lock;
+    pthread_cond_t task_cond;
+    pthread_cond_t done_cond;
+    StreamInfoWorker *workers;
+    int nb_workers;
+    /* number of queued or running tasks per stream, grown on demand */
+    int *pending;
+    unsigned pending_size;
+    int nb_pending;
+    int64_t queued_bytes;
+    int exit;
+} StreamInfoPool;
+
+static void *stream_info_worker(void *arg)
+{
+    StreamInfoWorker *w = arg;
+    StreamInfoPool *pool = w->pool;
+
+    pthread_mutex_lock(&pool->lock);
+    while (1) {
+        StreamInfoTask *t = w->head;
+        if (!t) {
+            if (pool->exit)
+                break;
+            pthread_cond_wait(&pool->task_cond, &pool->lock);
+            continue;
+        }
+        w->head = t->next;
+        if (!w->head)
+            w->tail = NULL;
+        pthread_mutex_unlock(&pool->lock);
+
+        try_decode_frame(pool->ic, t->st, t->pkt, t->options,
+                         t->codec_info_nb_frames);
+
+        pthread_mutex_lock(&pool->lock);
+        pool->queued_bytes -= t->pkt->size;
+        pool->pending[t->st->index]--;
+        pool->nb_pending--;
+        av_packet_free(&t->pkt);
+        av_freep(&t);
+        pthread_cond_broadcast(&pool->done_cond);
+    }
+    pthread_mutex_unlock(&pool->lock);
+    return NULL;
+}
+
+static void stream_info_pool_free(StreamInfoPool **ppool)
+{
+    StreamInfoPool *pool = *ppool;
+
+    if (!pool)
+        return;
+
+    pthread_mutex_lock(&pool->lock);
+    pool->exit = 1;
+    /* discard tasks that have not started yet */
+    for (int i = 0; i < pool->nb_workers; i++) {
+        StreamInfoWorker *w = &pool->workers[i];
+        while (w->head) {
+            StreamInfoTask *t = w->head;
+            w->head = t->next;
+            pool->queued_bytes -= t->pkt->size;
+            pool->pending[t->st->index]--;
+            pool->nb_pending--;
+            av_packet_free(&t->pkt);
+            av_freep(&t);
+        }
+        w->tail = NULL;
+    }
+    pthread_cond_broadcast(&pool->task_cond);
+    pthread_cond_broadcast(&pool->done_cond);
+    pthread_mutex_unlock(&pool->lock);
+
+    for (int i = 0; i < pool->nb_workers; i++)
+        pthread_join(pool->workers[i].thread, NULL);
+
+    pthread_cond_destroy(&pool->done_cond);
+    pthread_cond_destroy(&pool->task_cond);
+    pthread_mutex_destroy(&pool->lock);
+    av_freep(&pool->pending);
+    av_freep(&pool->workers);
+    av_freep(ppool);
+}
+
+static StreamInfoPool *stream_info_pool_init(AVFormatContext *ic)
+{
+    int nb_workers = FFMIN3(av_cpu_count(), (int)ic->nb_streams,
+                            STREAM_INFO_MAX_WORKERS);
+    StreamInfoPool *pool;
+
+    /* a single busy stream gains nothing from an extra thread */
+    if (nb_workers < 2)
+        return NULL;
+
+    pool = av_mallocz(sizeof(*pool));
+    if (!pool)
+        return NULL;
+    pool->ic      = ic;
+    pool->workers = av_calloc(nb_workers, sizeof(*pool->workers));
+    if (!pool->workers) {
+        av_freep(&pool);
+        return NULL;
+    }
+    pthread_mutex_init(&pool->lock, NULL);
+    pthread_cond_init(&pool->task_cond, NULL);
+    pthread_cond_init(&pool->done_cond, NULL);
+
+    for (int i = 0; i < nb_workers; i++) {
+        StreamInfoWorker *w = &pool->workers[i];
+        w->pool = pool;
+        if (pthread_create(&w->thread, NULL, stream_info_worker, w))
+            break;
+        pool->nb_workers++;
+    }
+    if (pool->nb_workers < 2)
+        stream_info_pool_free(&pool);
+    return pool;
+}
+
+static int stream_info_pool_submit(StreamInfoPool *pool, AVStream *st,
+                                   const AVPacket *pkt, AVDictionary **options,
+                                   int codec_info_nb_frames)
+{
+    StreamInfoWorker *w = &pool->workers[st->index % pool->nb_workers];
+    StreamInfoTask *t;
+    int ret;
+
+    if ((unsigned)st->index >= pool->pending_size) {
+        unsigned new_size = FFMAX(2 * pool->pending_size, st->index + 1);
+        int *pending = av_realloc_array(pool->pending, new_size,
+                                        sizeof(*pending));
+        if (!pending)
+            return AVERROR(ENOMEM);
+        memset(pending + pool->pending_size, 0,
+               (new_size - pool->pending_size) * sizeof(*pending));
+        pool->pending      = pending;
+        pool->pending_size = new_size;
+    }
+
+    t = av_mallocz(sizeof(*t));
+    if (!t)
+        return AVERROR(ENOMEM);
+    t->pkt = av_packet_alloc();
+    if (!t->pkt) {
+        av_freep(&t);
+        return AVERROR(ENOMEM);
+    }
+    /* A blank packet (for flushing) must stay blank: referencing it would
+     * give it a data pointer, which try_decode_frame() uses to tell the
+     * two apart. */
+    if (pkt->data) {
+        ret = av_packet_ref(t->pkt, pkt);
+        if (ret < 0) {
+            av_packet_free(&t->pkt);
+            av_freep(&t);
+            return ret;
+        }
+    }
+    t->st                   = st;
+    t->options              = options;
+    t->codec_info_nb_frames = codec_info_nb_frames;
+
+    pthread_mutex_lock(&pool->lock);
+    /* keep the amount of queued compressed data bounded */
+    while (pool->nb_pending &&
+           pool->queued_bytes + pkt->size > STREAM_INFO_MAX_QUEUED_BYTES)
+        pthread_cond_wait(&pool->done_cond, &pool->lock);
+    pool->queued_bytes += pkt->size;
+    pool->pending[st->index]++;
+    pool->nb_pending++;
+    if (w->tail)
+        w->tail->next = t;
+    else
+        w->head = t;
+    w->tail = t;
+    pthread_cond_broadcast(&pool->task_cond);
+    pthread_mutex_unlock(&pool->lock);
+
+    return 0;
+}
+
+static void stream_info_pool_wait_stream(StreamInfoPool *pool, const AVStream *st)
+{
+    if (!pool || (unsigned)st->index >= pool->pending_size)
+        return;
+    pthread_mutex_lock(&pool->lock);
+    while (pool->pending[st->index])
+        pthread_cond_wait(&pool->done_cond, &pool->lock);
+    pthread_mutex_unlock(&pool->lock);
+}
+
+static int stream_info_pool_stream_busy(StreamInfoPool *pool, const AVStream *st)
+{
+    int busy;
+
+    if (!pool || (unsigned)st->index >= pool->pending_size)
+        return 0;
+    pthread_mutex_lock(&pool->lock);
+    busy = pool->pending[st->index] > 0;
+    pthread_mutex_unlock(&pool->lock);
+    return busy;
+}
+
+static void stream_info_pool_drain(StreamInfoPool *pool)
+{
+    if (!pool)
+        return;
+    pthread_mutex_lock(&pool->lock);
+    while (pool->nb_pending)
+        pthread_cond_wait(&pool->done_cond, &pool->lock);
+    pthread_mutex_unlock(&pool->lock);
+}
+
+#else /* HAVE_THREADS */
+
+typedef struct StreamInfoPool StreamInfoPool;
+
+static inline StreamInfoPool *stream_info_pool_init(AVFormatContext *ic)
+{
+    return NULL;
+}
+
+static inline void stream_info_pool_free(StreamInfoPool **ppool)
+{
+}
+
+static inline int stream_info_pool_submit(StreamInfoPool *pool, AVStream *st,
+                                          const AVPacket *pkt,
+                                          AVDictionary **options,
+                                          int codec_info_nb_frames)
+{
+    return AVERROR(ENOSYS);
+}
+
+static inline void stream_info_pool_wait_stream(StreamInfoPool *pool,
+                                                const AVStream *st)
+{
+}
+
+static inline int stream_info_pool_stream_busy(StreamInfoPool *pool,
+                                               const AVStream *st)
+{
+    return 0;
+}
+
+static inline void stream_info_pool_drain(StreamInfoPool *pool)
+{
+}
+
+#endif /* HAVE_THREADS */
+
 static int chapter_start_cmp(const void *p1, const void *p2)
 {
     const AVChapter *const ch1 = *(AVChapter**)p1;
@@ -2616,6 +2917,7 @@ int avformat_find_stream_info(AVFormatContext *ic, AVDictionary **options)
     int64_t max_subtitle_analyze_duration;
     int64_t probesize = ic->probesize;
     int eof_reached = 0;
+    StreamInfoPool *pool = NULL;
 
     flush_codecs = probesize > 0;
 
@@ -2695,6 +2997,10 @@ int avformat_find_stream_info(AVFormatContext *ic, AVDictionary **options)
             av_dict_free(&thread_opt);
     }
 
+    /* Probe decoding of independent streams can run in parallel. */
+    if (ic->nb_streams > 1)
+        pool = stream_info_pool_init(ic);
+
     read_size = 0;
     for (;;) {
         const AVPacket *pkt;
@@ -2709,6 +3015,14 @@ int avformat_find_stream_info(AVFormatContext *ic, AVDictionary **options)
             break;
         }
 
+        /* update_stream_avctx() below reinitializes the codec context of
+         * streams flagged by the demuxer; those must not have a probe
+         * decode in flight. */
+        if (pool)
+            for (i = 0; i < ic->nb_streams; i++)
+                if (ffstream(ic->streams[i])->need_context_update)
+                    stream_info_pool_wait_stream(pool, ic->streams[i]);
+
         /* read_frame_internal() in a previous iteration of this loop may
          * have made changes to streams without returning a packet for them.
          * Handle that here. */
@@ -2723,8 +3037,17 @@ int avformat_find_stream_info(AVFormatContext *ic, AVDictionary **options)
             int fps_analyze_framecount = 20;
             int count;
 
+            /* A probe decode for this stream is still in flight and its
+             * result may change the checks below; keep probing. */
+            if (stream_info_pool_stream_busy(pool, st))
+                break;
             if (!has_codec_parameters(st, NULL))
                 break;
+            /* The caller does not want this stream's data, so basic codec
+             * parameters are all that is needed; skip the framerate and
+             * timestamp analysis. */
+            if (st->discard >= AVDISCARD_ALL)
+                continue;
             /* If the timebase is coarse (like the usual millisecond precision
              * of mkv), we need to analyze more frames to reliably arrive at
              * the correct fps. */
@@ -2817,6 +3140,11 @@ int avformat_find_stream_info(AVFormatContext *ic, AVDictionary **options)
 
         st  = ic->streams[pkt->stream_index];
         sti = ffstream(st);
+
+        /* Wait for in-flight probe decoding of this stream: the code below
+         * inspects and updates state that the decode task also touches. */
+        stream_info_pool_wait_stream(pool, st);
+
         if (!(st->disposition & AV_DISPOSITION_ATTACHED_PIC))
             read_size += pkt->size;
 
@@ -2930,8 +3258,14 @@ int avformat_find_stream_info(AVFormatContext *ic, AVDictionary **options)
          * least one frame of codec data, this makes sure the codec initializes
          * the channel configuration and does not only trust the values from
          * the container. */
-        try_decode_frame(ic, st, pkt,
-                         (options && i < orig_nb_streams) ? &options[i] : NULL);
+        if (st->discard < AVDISCARD_ALL || !has_codec_parameters(st, NULL)) {
+            AVDictionary **opts = (options && i < orig_nb_streams) ? &options[i] : NULL;
+
+            if (!pool ||
+                stream_info_pool_submit(pool, st, pkt, opts,
+                                        sti->codec_info_nb_frames) < 0)
+                try_decode_frame(ic, st, pkt, opts, sti->codec_info_nb_frames);
+        }
 
         if (ic->flags & AVFMT_FLAG_NOBUFFER)
             av_packet_unref(pkt1);
@@ -2940,6 +3274,9 @@ int avformat_find_stream_info(AVFormatContext *ic, AVDictionary **options)
         count++;
     }
 
+    /* wait for outstanding probe decodes before inspecting their results */
+    stream_info_pool_drain(pool);
+
     if (eof_reached) {
         for (unsigned stream_index = 0; stream_index < ic->nb_streams; stream_index++) {
             AVStream *const st = ic->streams[stream_index];
@@ -2976,16 +3313,24 @@ int avformat_find_stream_info(AVFormatContext *ic, AVDictionary **options)
 
             /* flush the decoders */
             if (sti->info->found_decoder == 1) {
-                err = try_decode_frame(ic, st, empty_pkt,
-                                        (options && i < orig_nb_streams)
-                                        ? &options[i] : NULL);
-
-                if (err < 0) {
-                    av_log(ic, AV_LOG_INFO,
-                        "decoding for stream %d failed\n", st->index);
+                AVDictionary **opts = (options && i < orig_nb_streams)
+                                      ? &options[i] : NULL;
+
+                if (!pool ||
+                    stream_info_pool_submit(pool, st, empty_pkt, opts,
+                                            sti->codec_info_nb_frames) < 0) {
+                    err = try_decode_frame(ic, st, empty_pkt, opts,
+                                           sti->codec_info_nb_frames);
+
+                    if (err < 0) {
+                        av_log(ic, AV_LOG_INFO,
+                            "decoding for stream %d failed\n", st->index);
+                    }
                 }
             }
         }
+
+        stream_info_pool_drain(pool);
     }
 
     ff_rfps_calculate(ic);
@@ -3161,6 +3506,7 @@ int avformat_find_stream_info(AVFormatContext *ic, AVDictionary **options)
     }
 
 find_stream_info_err:
+    stream_info_pool_free(&pool);
     for (unsigned i = 0; i < ic->nb_streams; i++) {
         AVStream *const st  = ic->streams[i];
         FFStream *const sti = ffstream(st);
@@ -39,6 +39,9 @@
 #endif
 #include <sys/stat.h>
 #include <stdlib.h>
+#if CONFIG_LIBURING
+#include <liburing.h>
+#endif
 #include "os_support.h"
 #include "url.h"
 
@@ -89,6 +92,21 @@
 
 /* standard file protocol */
 
+#if CONFIG_LIBURING
+/* number of readahead requests kept in flight and the size of each */
+#define URING_SLOTS    8
+#define URING_SLOT_LEN (256 * 1024)
+
+typedef struct URingSlot {
+    uint8_t *buf;
+    int64_t  offset;  ///< file offset of buf[0]
+    int      len;     ///< number of valid bytes, filled in on completion
+    int      pos;     ///< number of bytes already returned to the caller
+    int      err;     ///< error from a failed read
+    int      pending; ///< submitted, completion not reaped yet
+} URingSlot;
+#endif
+
 typedef struct FileContext {
     const AVClass *class;
     int fd;
@@ -97,9 +115,27 @@ typedef struct FileContext {
     int pkt_size;
     int follow;
     int seekable;
+    int use_mmap;
+#if defined(SEEK_HOLE) && defined(SEEK_DATA)
+    int use_sparse;
+    int64_t data_start; ///< bounds of the last region known to contain data
+    int64_t data_end;
+#endif
 #if HAVE_DIRENT_H
     DIR *dir;
 #endif
+#if CONFIG_LIBURING
+    int use_io_uring;
+    int uring_active;
+    int bufs_registered;
+    struct io_uring ring;
+    URingSlot slots[URING_SLOTS];
+    unsigned slot_head;     ///< oldest slot in flight or ready
+    unsigned nb_slots_used;
+    int64_t read_pos;       ///< logical position of the next file_read()
+    int64_t submit_pos;     ///< file offset of the next readahead submission
+    int64_t eof_pos;        ///< file size learned from a short read, -1 if unknown
+#endif
 } FileContext;
 
 static const AVOption file_options[] = {
@@ -108,6 +144,15 @@ static const AVOption file_options[] = {
     { "follow", "Follow a file as it is being written", offsetof(FileContext, follow), AV_OPT_TYPE_INT, { .i64 = 0 }, 0, 1, AV_OPT_FLAG_DECODING_PARAM },
     { "seekable", "Sets if the file is seekable", offsetof(FileContext, seekable), AV_OPT_TYPE_INT, { .i64 = -1 }, -1, 0, AV_OPT_FLAG_DECODING_PARAM | AV_OPT_FLAG_ENCODING_PARAM },
     { "pkt_size", "Maximum packet size", offsetof(FileContext, pkt_size), AV_OPT_TYPE_INT, { .i64 = 0 }, 0, INT_MAX, AV_OPT_FLAG_DECODING_PARAM | AV_OPT_FLAG_ENCODING_PARAM },
+#if HAVE_MMAP
+    { "mmap", "Memory-map the file and serve reads from the mapping", offsetof(FileContext, use_mmap), AV_OPT_TYPE_BOOL, { .i64 = 0 }, 0, 1, AV_OPT_FLAG_DECODING_PARAM },
+#endif
+#if CONFIG_LIBURING
+    { "io_uring", "Read via io_uring, with readahead", offsetof(FileContext, use_io_uring), AV_OPT_TYPE_BOOL, { .i64 = 0 }, 0, 1, AV_OPT_FLAG_DECODING_PARAM },
+#endif
+#if defined(SEEK_HOLE) && defined(SEEK_DATA)
+    { "sparse", "Synthesize zeroes for file holes instead of reading them", offsetof(FileContext, use_sparse), AV_OPT_TYPE_BOOL, { .i64 = 0 }, 0, 1, AV_OPT_FLAG_DECODING_PARAM },
+#endif
     { NULL }
 };
 
@@ -135,11 +180,317 @@ static const AVClass fd_class = {
     .version    = LIBAVUTIL_VERSION_INT,
 };
 
+#if CONFIG_LIBURING
+/* queue readahead reads until all slots are in flight or EOF is reached,
+ * batching them into a single submission */
+static void uring_fill(FileContext *c)
+{
+    int queued = 0;
+
+    while (c->nb_slots_used < URING_SLOTS &&
+           (c->eof_pos < 0 || c->submit_pos < c->eof_pos)) {
+        unsigned idx = (c->slot_head + c->nb_slots_used) % URING_SLOTS;
+        URingSlot *slot = &c->slots[idx];
+        struct io_uring_sqe *sqe = io_uring_get_sqe(&c->ring);
+
+        if (!sqe)
+            break;
+
+        if (c->bufs_registered)
+            io_uring_prep_read_fixed(sqe, c->fd, slot->buf, URING_SLOT_LEN,
+                                     c->submit_pos, idx);
+        else
+            io_uring_prep_read(sqe, c->fd, slot->buf, URING_SLOT_LEN,
+                               c->submit_pos);
+        io_uring_sqe_set_data(sqe, slot);
+
+        slot->offset  = c->submit_pos;
+        slot->len     = 0;
+        slot->pos     = 0;
+        slot->err     = 0;
+        slot->pending = 1;
+
+        c->submit_pos += URING_SLOT_LEN;
+        c->nb_slots_used++;
+        queued++;
+    }
+
+    if (queued > 0)
+        io_uring_submit(&c->ring);
+}
+
+/* reap completions until the given slot has one */
+static int uring_complete(FileContext *c, URingSlot *want)
+{
+    while (want->pending) {
+        struct io_uring_cqe *cqe;
+        URingSlot *slot;
+        int ret = io_uring_wait_cqe(&c->ring, &cqe);
+        if (ret < 0)
+            return ret;
+
+        slot = io_uring_cqe_get_data(cqe);
+        if (cqe->res < 0) {
+            slot->err = cqe->res;
+        } else {
+            slot->len = cqe->res;
+            /* a short read on a regular file means we hit its end */
+            if (cqe->res < URING_SLOT_LEN &&
+                (c->eof_pos < 0 || slot->offset + cqe->res < c->eof_pos))
+                c->eof_pos = slot->offset + cqe->res;
+        }
+        slot->pending = 0;
+        io_uring_cqe_seen(&c->ring, cqe);
+    }
+
+    return 0;
+}
+
+/* wait for all in-flight reads and discard their data */
+static int uring_drain(FileContext *c)
+{
+    while (c->nb_slots_used) {
+        URingSlot *slot = &c->slots[c->slot_head];
+
+        if (slot->pending) {
+            int ret = uring_complete(c, slot);
+            if (ret < 0)
+                return ret;
+        }
+        c->slot_head = (c->slot_head + 1) % URING_SLOTS;
+        c->nb_slots_used--;
+    }
+
+    return 0;
+}
+
+static int file_read_uring(URLContext *h, unsigned char *buf, int size)
+{
+    FileContext *c = h->priv_data;
+    int ret;
+
+    size = FFMIN(size, c->blocksize);
+
+    while (1) {
+        URingSlot *slot;
+        int n;
+
+        if (c->eof_pos >= 0 && c->read_pos >= c->eof_pos && !c->nb_slots_used)
+            return AVERROR_EOF;
+
+        uring_fill(c);
+        if (!c->nb_slots_used)
+            return AVERROR_EOF;
+
+        slot = &c->slots[c->slot_head];
+        if (slot->pending) {
+            ret = uring_complete(c, slot);
+            if (ret < 0)
+                return ret;
+        }
+
+        if (slot->err) {
+            ret = slot->err;
+            /* drop everything so that a retry restarts cleanly */
+            uring_drain(c);
+            c->submit_pos = c->read_pos;
+            return ret;
+        }
+
+        n = FFMIN(slot->len - slot->pos, size);
+        if (n > 0) {
+            memcpy(buf, slot->buf + slot->pos, n);
+            slot->pos   += n;
+            c->read_pos += n;
+        }
+
+        if (slot->pos == slot->len) {
+            if (slot->len == URING_SLOT_LEN) {
+                c->slot_head = (c->slot_head + 1) % URING_SLOTS;
+                c->nb_slots_used--;
+                uring_fill(c);
+            } else {
+                /* short read - already-submitted readahead no longer lines
+                 * up with our position, restart it from here */
+                ret = uring_drain(c);
+                if (ret < 0)
+                    return ret;
+                c->submit_pos = c->read_pos;
+            }
+        }
+
+        if (n > 0)
+            return n;
+    }
+}
+
+static int64_t file_seek_uring(URLContext *h, int64_t pos, int whence)
+{
+    FileContext *c = h->priv_data;
+    int64_t target;
+    int ret;
+
+    if (whence == AVSEEK_SIZE || whence == SEEK_END) {
+        struct stat st;
+        ret = fstat(c->fd, &st);
+        if (ret < 0)
+            return AVERROR(errno);
+        if (whence == AVSEEK_SIZE)
+            return st.st_size;
+        target = st.st_size + pos;
+    } else if (whence == SEEK_CUR) {
+        target = c->read_pos + pos;
+    } else if (whence == SEEK_SET) {
+        target = pos;
+    } else
+        return AVERROR(EINVAL);
+
+    if (target < 0)
+        return AVERROR(EINVAL);
+
+    if (target != c->read_pos) {
+        ret = uring_drain(c);
+        if (ret < 0)
+            return ret;
+        c->read_pos   = target;
+        c->submit_pos = target;
+        /* the file may have grown since we last saw its end */
+        c->eof_pos    = -1;
+    }
+
+    return target;
+}
+
+static void uring_init(URLContext *h)
+{
+    FileContext *c = h->priv_data;
+    struct iovec iov[URING_SLOTS];
+    int ret;
+
+    ret = io_uring_queue_init(URING_SLOTS, &c->ring, 0);
+    if (ret < 0) {
+        av_log(h, AV_LOG_WARNING, "io_uring setup failed: %s, "
+               "falling back to blocking reads\n", av_err2str(ret));
+        return;
+    }
+
+    for (int i = 0; i < URING_SLOTS; i++) {
+        c->slots[i].buf = av_malloc(URING_SLOT_LEN);
+        if (!c->slots[i].buf)
+            goto fail;
+        iov[i].iov_base = c->slots[i].buf;
+        iov[i].iov_len  = URING_SLOT_LEN;
+    }
+
+    /* registered buffers avoid per-request page pinning; not fatal if the
+     * kernel refuses them */
+    ret = io_uring_register_buffers(&c->ring, iov, URING_SLOTS);
+    c->bufs_registered = ret >= 0;
+    if (ret < 0)
+        av_log(h, AV_LOG_VERBOSE, "io_uring buffer registration failed: %s\n",
+               av_err2str(ret));
+
+    c->read_pos     = 0;
+    c->submit_pos   = 0;
+    c->eof_pos      = -1;
+    c->uring_active = 1;
+
+    /* start reading ahead right away, the first refill usually follows
+     * immediately after open */
+    uring_fill(c);
+    return;
+
+fail:
+    for (int i = 0; i < URING_SLOTS; i++)
+        av_freep(&c->slots[i].buf);
+    io_uring_queue_exit(&c->ring);
+}
+
+static void uring_close(FileContext *c)
+{
+    if (!c->uring_active)
+        return;
+
+    uring_drain(c);
+    io_uring_queue_exit(&c->ring);
+    for (int i = 0; i < URING_SLOTS; i++)
+        av_freep(&c->slots[i].buf);
+    c->uring_active = 0;
+}
+#endif /* CONFIG_LIBURING */
+
+#if defined(SEEK_HOLE) && defined(SEEK_DATA)
+/* If the current position lies inside a hole, synthesize up to size zero
+ * bytes instead of reading them and advance the file position past them.
+ * Returns the number of bytes synthesized, 0 if the position lies within
+ * data (so the caller should read normally), or a negative error code. */
+static int file_read_hole(URLContext *h, unsigned char *buf, int size)
+{
+    FileContext *c = h->priv_data;
+    int64_t pos, data, hole;
+    int n;
+
+    pos = lseek(c->fd, 0, SEEK_CUR);
+    if (pos < 0)
+        return AVERROR(errno);
+
+    /* the previous probe already told us this region holds data */
+    if (pos >= c->data_start && pos < c->data_end)
+        return 0;
+
+    data = lseek(c->fd, pos, SEEK_DATA);
+    if (data < 0) {
+        struct stat st;
+
+        if (errno != ENXIO) {
+            /* the filesystem does not report holes, stop probing */
+            c->use_sparse = 0;
+            return 0;
+        }
+        /* in a hole that runs to the end of the file */
+        if (fstat(c->fd, &st) < 0)
+            return AVERROR(errno);
+        data = st.st_size;
+        if (pos >= data)
+            return 0; /* a plain read turns this into EOF */
+    }
+
+    if (data == pos) {
+        /* remember where the data ends so subsequent reads skip the probe */
+        hole = lseek(c->fd, pos, SEEK_HOLE);
+        if (hole > pos) {
+            c->data_start = pos;
+            c->data_end   = hole;
+        }
+        if (lseek(c->fd, pos, SEEK_SET) < 0)
+            return AVERROR(errno);
+        return 0;
+    }
+
+    n = FFMIN(data - pos, size);
+    memset(buf, 0, n);
+    if (lseek(c->fd, pos + n, SEEK_SET) < 0)
+        return AVERROR(errno);
+    return n;
+}
+#endif /* SEEK_HOLE && SEEK_DATA */
+
 static int file_read(URLContext *h, unsigned char *buf, int size)
 {
     FileContext *c = h->priv_data;
     int ret;
+#if CONFIG_LIBURING
+    if (c->uring_active)
+        return file_read_uring(h, buf, size);
+#endif
     size = FFMIN(size, c->blocksize);
+#if defined(SEEK_HOLE) && defined(SEEK_DATA)
+    if (c->use_sparse) {
+        ret = file_read_hole(h, buf, size);
+        if (ret)
+            return ret;
+    }
+#endif
     ret = read(c->fd, buf, size);
     if (ret == 0 && c->follow)
         return AVERROR(EAGAIN);
@@ -220,7 +571,11 @@ static int fd_dup(URLContext *h, int oldfd)
 static int file_close(URLContext *h)
 {
     FileContext *c = h->priv_data;
-    int ret = close(c->fd);
+    int ret;
+#if CONFIG_LIBURING
+    uring_close(c);
+#endif
+    ret = close(c->fd);
     return (ret == -1) ? AVERROR(errno) : 0;
 }
 
@@ -230,6 +585,11 @@ static int64_t file_seek(URLContext *h, int64_t pos, int whence)
     FileContext *c = h->priv_data;
     int64_t ret;
 
+#if CONFIG_LIBURING
+    if (c->uring_active)
+        return file_seek_uring(h, pos, whence);
+#endif
+
     if (whence == AVSEEK_SIZE) {
         struct stat st;
         ret = fstat(c->fd, &st);
@@ -325,6 +685,32 @@ static int file_open(URLContext *h, const char *filename, int flags)
     if (c->seekable >= 0)
         h->is_streamed = !c->seekable;
 
+    /* a mapping has a fixed size, it cannot follow a growing file */
+    if (c->follow)
+        c->use_mmap = 0;
+
+#if defined(SEEK_HOLE) && defined(SEEK_DATA)
+    /* holes are only meaningful (and stable) in regular files that we do
+     * not write to ourselves */
+    if (c->use_sparse &&
+        ((flags & AVIO_FLAG_WRITE) || c->follow ||
+         fstat(fd, &st) || !S_ISREG(st.st_mode)))
+        c->use_sparse = 0;
+#endif
+
+#if CONFIG_LIBURING
+    /* with mmap the buffered reads never reach the protocol, so the
+     * io_uring readahead would only waste memory and I/O */
+    if (c->use_io_uring && !c->use_mmap) {
+        if ((flags & (AVIO_FLAG_READ | AVIO_FLAG_WRITE)) == AVIO_FLAG_READ &&
+            !c->follow && !fstat(fd, &st) && S_ISREG(st.st_mode))
+            uring_init(h);
+        else
+            av_log(h, AV_LOG_VERBOSE,
+                   "io_uring is only implemented for reading regular files\n");
+    }
+#endif
+
     return 0;
 }
 
@@ -24,6 +24,8 @@
 #include "libavutil/avstring.h"
 #include "libavutil/mem.h"
 #include "libavutil/opt.h"
+#include "libavutil/thread.h"
+#include "libavutil/time.h"
 
 #include "avio_internal.h"
 #include "avformat.h"
@@ -153,21 +155,103 @@ const AVInputFormat *av_find_input_format(const char *short_name)
     return NULL;
 }
 
+enum nodat {
+    NO_ID3,
+    ID3_ALMOST_GREATER_PROBE,
+    ID3_GREATER_PROBE,
+    ID3_GREATER_MAX_PROBE,
+};
+
+/* Formats that recently won a probe with a perfect score, most recent
+ * first. Applications that keep opening the same few container types can
+ * then skip the scan over all registered demuxers. */
+#define PROBE_MRU_SIZE 8
+static const AVInputFormat *probe_mru[PROBE_MRU_SIZE];
+static AVMutex probe_mru_mutex = AV_MUTEX_INITIALIZER;
+
+static void probe_mru_insert(const AVInputFormat *fmt)
+{
+    int j;
+
+    ff_mutex_lock(&probe_mru_mutex);
+    for (j = 0; j < PROBE_MRU_SIZE - 1; j++)
+        if (probe_mru[j] == fmt)
+            break;
+    for (; j > 0; j--)
+        probe_mru[j] = probe_mru[j - 1];
+    probe_mru[0] = fmt;
+    ff_mutex_unlock(&probe_mru_mutex);
+}
+
+/* Well-known container magics, used to nominate a candidate demuxer before
+ * scanning the whole registry. The candidate's own read_probe() still has to
+ * confirm with a perfect score, so a stale match only costs one extra probe. */
+static const struct probe_signature {
+    const char *name;               ///< demuxer (short) name
+    uint8_t offset;                 ///< byte offset of the magic in the buffer
+    uint8_t len;                    ///< number of magic bytes
+    uint8_t magic[8];
+} probe_signatures[] = {
+    { "mov",      4, 4, { 'f','t','y','p' } },
+    { "matroska", 0, 4, { 0x1A, 0x45, 0xDF, 0xA3 } },
+    { "avi",      8, 4, { 'A','V','I',' ' } },
+    { "flv",      0, 3, { 'F','L','V' } },
+    { "ogg",      0, 4, { 'O','g','g','S' } },
+    { "flac",     0, 4, { 'f','L','a','C' } },
+    { "aiff",     8, 4, { 'A','I','F','F' } },
+    { "asf",      0, 8, { 0x30, 0x26, 0xB2, 0x75, 0x8E, 0x66, 0xCF, 0x11 } },
+};
+
+static int probe_format_score(const AVInputFormat *fmt1, const AVProbeData *lpd,
+                              enum nodat nodat)
+{
+    int score = 0;
+
+    if (ffifmt(fmt1)->read_probe) {
+        score = ffifmt(fmt1)->read_probe(lpd);
+        if (score)
+            av_log(NULL, AV_LOG_TRACE, "Probing %s score:%d size:%d\n", fmt1->name, score, lpd->buf_size);
+        if (fmt1->extensions && av_match_ext(lpd->filename, fmt1->extensions)) {
+            switch (nodat) {
+            case NO_ID3:
+                score = FFMAX(score, 1);
+                break;
+            case ID3_GREATER_PROBE:
+            case ID3_ALMOST_GREATER_PROBE:
+                score = FFMAX(score, AVPROBE_SCORE_EXTENSION / 2 - 1);
+                break;
+            case ID3_GREATER_MAX_PROBE:
+                score = FFMAX(score, AVPROBE_SCORE_EXTENSION);
+                break;
+            }
+        }
+    } else if (fmt1->extensions) {
+        if (av_match_ext(lpd->filename, fmt1->extensions))
+            score = AVPROBE_SCORE_EXTENSION;
+    }
+    if (av_match_name(lpd->mime_type, fmt1->mime_type)) {
+        int old_score = score;
+        score += AVPROBE_SCORE_MIME_BONUS;
+        if (score > AVPROBE_SCORE_MAX) score = AVPROBE_SCORE_MAX;
+        av_log(NULL, AV_LOG_DEBUG, "Probing %s score:%d increased to %d due to MIME type\n", fmt1->name, old_score, score);
+    }
+
+    return score;
+}
+
 const AVInputFormat *av_probe_input_format3(const AVProbeData *pd,
                                             int is_opened, int *score_ret)
 {
     AVProbeData lpd = *pd;
     const AVInputFormat *fmt1 = NULL;
     const AVInputFormat *fmt = NULL;
-    int score, score_max = 0;
+    const AVInputFormat *mru[PROBE_MRU_SIZE];
+    const AVInputFormat *worst_fmt = NULL;
+    int64_t total_time = 0, worst_time = 0;
+    int score, score_max = 0, account;
     void *i = 0;
     const static uint8_t zerobuffer[AVPROBE_PADDING_SIZE];
-    enum nodat {
-        NO_ID3,
-        ID3_ALMOST_GREATER_PROBE,
-        ID3_GREATER_PROBE,
-        ID3_GREATER_MAX_PROBE,
-    } nodat = NO_ID3;
+    enum nodat nodat = NO_ID3;
 
     if (!lpd.buf)
         lpd.buf = (unsigned char *) zerobuffer;
@@ -188,39 +272,65 @@ const AVInputFormat *av_probe_input_format3(const AVProbeData *pd,
         }
     }
 
+    /* A perfect score cannot be beaten, so try recent winners first.
+     * Skipped when the score would be clamped below the maximum. */
+    if (nodat != ID3_GREATER_PROBE) {
+        ff_mutex_lock(&probe_mru_mutex);
+        memcpy(mru, probe_mru, sizeof(mru));
+        ff_mutex_unlock(&probe_mru_mutex);
+
+        for (int j = 0; j < PROBE_MRU_SIZE && mru[j]; j++) {
+            fmt1 = mru[j];
+            if (!is_opened == !(fmt1->flags & AVFMT_NOFILE) && strcmp(fmt1->name, "image2"))
+                continue;
+            if (probe_format_score(fmt1, &lpd, nodat) >= AVPROBE_SCORE_MAX) {
+                probe_mru_insert(fmt1);
+                *score_ret = AVPROBE_SCORE_MAX;
+                return fmt1;
+            }
+        }
+
+        /* Next tier: match well-known magics and let the nominated demuxer
+         * confirm, which resolves most real-world files without scanning
+         * the whole registry. */
+        for (int j = 0; lpd.buf_size >= 16 && j < FF_ARRAY_ELEMS(probe_signatures); j++) {
+            const struct probe_signature *sig = &probe_signatures[j];
+
+            if (memcmp(lpd.buf + sig->offset, sig->magic, sig->len))
+                continue;
+            fmt1 = av_find_input_format(sig->name);
+            if (!fmt1 || (fmt1->flags & AVFMT_EXPERIMENTAL))
+                continue;
+            if (!is_opened == !(fmt1->flags & AVFMT_NOFILE) && strcmp(fmt1->name, "image2"))
+                continue;
+            if (probe_format_score(fmt1, &lpd, nodat) >= AVPROBE_SCORE_MAX) {
+                av_log(NULL, AV_LOG_TRACE, "Probing %s resolved by signature\n", fmt1->name);
+                probe_mru_insert(fmt1);
+                *score_ret = AVPROBE_SCORE_MAX;
+                return fmt1;
+            }
+        }
+    }
+
+    account = av_log_get_level() >= AV_LOG_DEBUG;
+
     while ((fmt1 = av_demuxer_iterate(&i))) {
+        int64_t probe_time = 0;
+
         if (fmt1->flags & AVFMT_EXPERIMENTAL)
             continue;
         if (!is_opened == !(fmt1->flags & AVFMT_NOFILE) && strcmp(fmt1->name, "image2"))
             continue;
-        score = 0;
-        if (ffifmt(fmt1)->read_probe) {
-            score = ffifmt(fmt1)->read_probe(&lpd);
-            if (score)
-                av_log(NULL, AV_LOG_TRACE, "Probing %s score:%d size:%d\n", fmt1->name, score, lpd.buf_size);
-            if (fmt1->extensions && av_match_ext(lpd.filename, fmt1->extensions)) {
-                switch (nodat) {
-                case NO_ID3:
-                    score = FFMAX(score, 1);
-                    break;
-                case ID3_GREATER_PROBE:
-                case ID3_ALMOST_GREATER_PROBE:
-                    score = FFMAX(score, AVPROBE_SCORE_EXTENSION / 2 - 1);
-                    break;
-                case ID3_GREATER_MAX_PROBE:
-                    score = FFMAX(score, AVPROBE_SCORE_EXTENSION);
-                    break;
-                }
+        if (account)
+            probe_time = av_gettime_relative();
+        score = probe_format_score(fmt1, &lpd, nodat);
+        if (account) {
+            probe_time = av_gettime_relative() - probe_time;
+            total_time += probe_time;
+            if (probe_time > worst_time) {
+                worst_time = probe_time;
+                worst_fmt  = fmt1;
             }
-        } else if (fmt1->extensions) {
-            if (av_match_ext(lpd.filename, fmt1->extensions))
-                score = AVPROBE_SCORE_EXTENSION;
-        }
-        if (av_match_name(lpd.mime_type, fmt1->mime_type)) {
-            int old_score = score;
-            score += AVPROBE_SCORE_MIME_BONUS;
-            if (score > AVPROBE_SCORE_MAX) score = AVPROBE_SCORE_MAX;
-            av_log(NULL, AV_LOG_DEBUG, "Probing %s score:%d increased to %d due to MIME type\n", fmt1->name, old_score, score);
         }
         if (score > score_max) {
             score_max = score;
@@ -228,10 +338,18 @@ const AVInputFormat *av_probe_input_format3(const AVProbeData *pd,
         } else if (score == score_max)
             fmt = NULL;
     }
+
+    if (account && worst_fmt)
+        av_log(NULL, AV_LOG_DEBUG,
+               "Full probe scan of %d bytes took %"PRId64"us, most expensive: %s (%"PRId64"us)\n",
+               lpd.buf_size, total_time, worst_fmt->name, worst_time);
     if (nodat == ID3_GREATER_PROBE)
         score_max = FFMIN(AVPROBE_SCORE_EXTENSION / 2 - 1, score_max);
     *score_ret = score_max;
 
+    if (fmt && score_max >= AVPROBE_SCORE_MAX)
+        probe_mru_insert(fmt);
+
     return fmt;
 }
 
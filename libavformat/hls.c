@@ -38,6 +38,7 @@
 #include "libavutil/mem.h"
 #include "libavutil/opt.h"
 #include "libavutil/dict.h"
+#include "libavutil/thread.h"
 #include "libavutil/time.h"
 #include "avformat.h"
 #include "demux.h"
@@ -134,6 +135,12 @@ struct playlist {
     int64_t cur_seg_offset;
     int64_t last_load_time;
 
+    /* Playlist data fetched ahead of time by the refresh thread,
+     * waiting to be parsed. Guarded by HLSContext.refresh_lock. */
+    uint8_t *refresh_buf;
+    int refresh_buf_len;
+    int64_t refresh_fetch_time;
+
     /* Currently active Media Initialization Section */
     struct segment *cur_init_section;
     uint8_t *init_sec_buf;
@@ -231,8 +238,15 @@ typedef struct HLSContext {
     int http_multiple;
     int http_seekable;
     int seg_max_retry;
+    int playlist_refresh;
     AVIOContext *playlist_pb;
     HLSCryptoContext  crypto_ctx;
+#if HAVE_THREADS
+    pthread_mutex_t refresh_lock;
+    pthread_t refresh_thread;
+    int refresh_thread_started;
+    int refresh_abort;
+#endif
 } HLSContext;
 
 static void free_segment_dynarray(struct segment **segments, int n_segments)
@@ -276,6 +290,7 @@ static void free_playlist_list(HLSContext *c)
         av_freep(&pls->id3_buf);
         av_dict_free(&pls->id3_initial);
         ff_id3v2_free_extra_meta(&pls->id3_deferred_extra);
+        av_freep(&pls->refresh_buf);
         av_freep(&pls->init_sec_buf);
         av_packet_free(&pls->pkt);
         av_freep(&pls->pb.pub.buffer);
@@ -1556,6 +1571,179 @@ static int playlist_needed(struct playlist *pls)
     return 0;
 }
 
+#if HAVE_THREADS
+static int refresh_check_interrupt(void *opaque)
+{
+    HLSContext *c = opaque;
+    return c->refresh_abort;
+}
+
+static int refresh_fetch(HLSContext *c, const char *url, AVDictionary **opts,
+                         uint8_t **pbuf, int *plen)
+{
+    AVIOInterruptCB int_cb = { refresh_check_interrupt, c };
+    AVIOContext *in = NULL;
+    uint8_t *buf = NULL;
+    unsigned int buf_size = 0;
+    int len = 0, ret;
+
+    ret = ffio_open_whitelist(&in, url, AVIO_FLAG_READ, &int_cb, opts,
+                              c->ctx->protocol_whitelist,
+                              c->ctx->protocol_blacklist);
+    if (ret < 0)
+        return ret;
+
+    for (;;) {
+        uint8_t *tmp = av_fast_realloc(buf, &buf_size, len + 16384);
+        if (!tmp) {
+            ret = AVERROR(ENOMEM);
+            break;
+        }
+        buf = tmp;
+        ret = avio_read(in, buf + len, 16384);
+        if (ret <= 0)
+            break;
+        len += ret;
+    }
+    avio_close(in);
+
+    if (ret < 0 && ret != AVERROR_EOF) {
+        av_freep(&buf);
+        return ret;
+    }
+
+    *pbuf = buf;
+    *plen = len;
+    return 0;
+}
+
+static void *refresh_thread_routine(void *arg)
+{
+    HLSContext *c = arg;
+
+    pthread_mutex_lock(&c->refresh_lock);
+    while (!c->refresh_abort) {
+        int64_t now = av_gettime_relative();
+        int i;
+
+        for (i = 0; i < c->n_playlists && !c->refresh_abort; i++) {
+            struct playlist *pls = c->playlists[i];
+            /* target_duration rather than the last segment duration, so
+             * the segment list is never touched from this thread */
+            int64_t interval = pls->target_duration ? pls->target_duration
+                                                    : AV_TIME_BASE;
+            AVDictionary *opts = NULL;
+            uint8_t *buf = NULL;
+            int len = 0, ret;
+
+            if (pls->finished || !pls->needed)
+                continue;
+
+            /* Fetch at half the reload interval, so a reasonably fresh
+             * copy is on hand by the time the demuxer wants one. Failed
+             * fetches back off for the same amount of time. */
+            if (now - pls->refresh_fetch_time < interval / 2)
+                continue;
+            pls->refresh_fetch_time = now;
+
+            av_dict_copy(&opts, c->avio_opts, 0);
+            pthread_mutex_unlock(&c->refresh_lock);
+            ret = refresh_fetch(c, pls->url, &opts, &buf, &len);
+            av_dict_free(&opts);
+            pthread_mutex_lock(&c->refresh_lock);
+
+            if (c->refresh_abort) {
+                av_freep(&buf);
+                break;
+            }
+            if (ret >= 0) {
+                av_freep(&pls->refresh_buf);
+                pls->refresh_buf     = buf;
+                pls->refresh_buf_len = len;
+            }
+        }
+
+        pthread_mutex_unlock(&c->refresh_lock);
+        av_usleep(100 * 1000);
+        pthread_mutex_lock(&c->refresh_lock);
+    }
+    pthread_mutex_unlock(&c->refresh_lock);
+
+    return NULL;
+}
+
+static void refresh_thread_start(HLSContext *c)
+{
+    int live = 0, i;
+
+    for (i = 0; i < c->n_playlists; i++)
+        live |= !c->playlists[i]->finished;
+    if (!live)
+        return;
+
+    if (pthread_mutex_init(&c->refresh_lock, NULL))
+        return;
+    if (pthread_create(&c->refresh_thread, NULL, refresh_thread_routine, c)) {
+        av_log(c->ctx, AV_LOG_WARNING,
+               "Failed to start the playlist refresh thread, "
+               "playlists will be reloaded inline\n");
+        pthread_mutex_destroy(&c->refresh_lock);
+        return;
+    }
+    c->refresh_thread_started = 1;
+}
+
+static void refresh_thread_stop(HLSContext *c)
+{
+    if (!c->refresh_thread_started)
+        return;
+
+    pthread_mutex_lock(&c->refresh_lock);
+    c->refresh_abort = 1;
+    pthread_mutex_unlock(&c->refresh_lock);
+    pthread_join(c->refresh_thread, NULL);
+    pthread_mutex_destroy(&c->refresh_lock);
+    c->refresh_thread_started = 0;
+}
+#endif
+
+/* Reload a playlist, parsing data fetched ahead of time by the refresh
+ * thread when a sufficiently recent copy is available instead of going
+ * back to the network. */
+static int parse_playlist_reload(HLSContext *c, struct playlist *pls)
+{
+#if HAVE_THREADS
+    if (c->refresh_thread_started) {
+        uint8_t *buf = NULL;
+        int len = 0;
+
+        pthread_mutex_lock(&c->refresh_lock);
+        if (pls->refresh_buf &&
+            av_gettime_relative() - pls->refresh_fetch_time <
+            default_reload_interval(pls)) {
+            buf = pls->refresh_buf;
+            len = pls->refresh_buf_len;
+        } else {
+            av_freep(&pls->refresh_buf);
+        }
+        pls->refresh_buf     = NULL;
+        pls->refresh_buf_len = 0;
+        pthread_mutex_unlock(&c->refresh_lock);
+
+        if (buf) {
+            FFIOContext mem;
+            int ret;
+
+            ffio_init_read_context(&mem, buf, len);
+            ret = parse_playlist(c, pls->url, pls, &mem.pub);
+            av_free(buf);
+            return ret;
+        }
+    }
+#endif
+    return parse_playlist(c, pls->url, pls, NULL);
+}
+
 static int reload_playlist(struct playlist *v, HLSContext *c)
 {
     int ret = 0;
@@ -1589,7 +1777,7 @@ reload:
             return AVERROR_EOF;
         if (!v->finished &&
             av_gettime_relative() - v->last_load_time >= reload_interval) {
-            if ((ret = parse_playlist(c, v->url, v, NULL)) < 0) {
+            if ((ret = parse_playlist_reload(c, v)) < 0) {
                 if (ret != AVERROR_EXIT)
                     av_log(v->parent, AV_LOG_WARNING, "Failed to reload playlist %d\n",
                            v->index);
@@ -1945,7 +2133,7 @@ static int64_t select_cur_seq_no(HLSContext *c, struct playlist *pls)
     if (!pls->finished && !c->first_packet &&
         av_gettime_relative() - pls->last_load_time >= default_reload_interval(pls))
         /* reload the playlist since it was suspended */
-        parse_playlist(c, pls->url, pls, NULL);
+        parse_playlist_reload(c, pls);
 
     /* If playback is already in progress (we are just selecting a new
      * playlist) and this is a complete file, find the matching segment
@@ -2113,6 +2301,10 @@ static int hls_close(AVFormatContext *s)
 {
     HLSContext *c = s->priv_data;
 
+#if HAVE_THREADS
+    refresh_thread_stop(c);
+#endif
+
     free_playlist_list(c);
     free_variant_list(c);
     free_rendition_list(c);
@@ -2424,6 +2616,11 @@ static int hls_read_header(AVFormatContext *s)
 
     update_noheader_flag(s);
 
+#if HAVE_THREADS
+    if (c->playlist_refresh)
+        refresh_thread_start(c);
+#endif
+
     return 0;
 }
 
@@ -2830,6 +3027,8 @@ static const AVOption hls_options[] = {
         OFFSET(seg_format_opts), AV_OPT_TYPE_DICT, {.str = NULL}, 0, 0, FLAGS},
     {"seg_max_retry", "Maximum number of times to reload a segment on error.",
      OFFSET(seg_max_retry), AV_OPT_TYPE_INT, {.i64 = 0}, 0, INT_MAX, FLAGS},
+    {"playlist_refresh", "Refresh live playlists from a background thread",
+        OFFSET(playlist_refresh), AV_OPT_TYPE_BOOL, {.i64 = 1}, 0, 1, FLAGS},
     {NULL}
 };
 
@@ -1901,6 +1901,7 @@ static int hls_start(AVFormatContext *s, VariantStream *vs)
             if (c->key_info_file || c->encrypt) {
                 av_dict_set(&options, "encryption_key", vs->key_string, 0);
                 av_dict_set(&options, "encryption_iv", vs->iv_string, 0);
+                av_dict_set(&options, "async_write", "1", 0);
 
                 /* Write temp file with cryption content */
                 av_freep(&vs->basename_tmp);
@@ -2647,6 +2648,7 @@ static int hls_write_packet(AVFormatContext *s, AVPacket *pkt)
                 if (hls->key_info_file || hls->encrypt) {
                     av_dict_set(&options, "encryption_key", vs->key_string, 0);
                     av_dict_set(&options, "encryption_iv", vs->iv_string, 0);
+                    av_dict_set(&options, "async_write", "1", 0);
                     filename = av_asprintf("crypto:%s", oc->url);
                 } else {
                     filename = av_asprintf("%s", oc->url);
@@ -2846,6 +2848,7 @@ static int hls_write_trailer(struct AVFormatContext *s)
         if (hls->key_info_file || hls->encrypt) {
             av_dict_set(&options, "encryption_key", vs->key_string, 0);
             av_dict_set(&options, "encryption_iv", vs->iv_string, 0);
+            av_dict_set(&options, "async_write", "1", 0);
             filename = av_asprintf("crypto:%s", oc->url);
         } else {
             filename = av_asprintf("%s", oc->url);
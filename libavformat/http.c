@@ -58,6 +58,7 @@
 #define BUFFER_SIZE   (MAX_URL_SIZE + HTTP_HEADERS_SIZE)
 #define MAX_REDIRECTS 8
 #define MAX_CACHED_REDIRECTS 32
+#define MAX_REDIRECT_BODY 8192
 #define HTTP_SINGLE   1
 #define HTTP_MUTLI    2
 #define MAX_DATE_LEN  19
@@ -383,6 +384,49 @@ static int redirect_cache_set(HTTPContext *s, const char *source, const char *de
     return 0;
 }
 
+static int http_same_origin(const char *url1, const char *url2)
+{
+    char proto1[10], proto2[10], hostname1[1024], hostname2[1024];
+    int port1, port2;
+
+    av_url_split(proto1, sizeof(proto1), NULL, 0,
+                 hostname1, sizeof(hostname1), &port1,
+                 NULL, 0, url1);
+    av_url_split(proto2, sizeof(proto2), NULL, 0,
+                 hostname2, sizeof(hostname2), &port2,
+                 NULL, 0, url2);
+
+    return port1 == port2 && !strcmp(proto1, proto2) &&
+           !strcmp(hostname1, hostname2);
+}
+
+/* Discard the body of a redirect response so the connection can be
+ * reused for the next request. Only bodies with a known, small
+ * Content-Length are drained; anything else is not worth avoiding a
+ * reconnect for. */
+static int http_drain_redirect(URLContext *h)
+{
+    HTTPContext *s = h->priv_data;
+    uint64_t remaining;
+    uint8_t buf[4096];
+
+    if (s->willclose || s->chunksize != UINT64_MAX ||
+        s->filesize == UINT64_MAX || s->filesize > MAX_REDIRECT_BODY)
+        return AVERROR(EIO);
+
+    remaining  = s->filesize;
+    remaining -= FFMIN(remaining, s->buf_end - s->buf_ptr);
+
+    while (remaining > 0) {
+        int len = ffurl_read(s->hd, buf, FFMIN(sizeof(buf), remaining));
+        if (len <= 0)
+            return len < 0 ? len : AVERROR(EIO);
+        remaining -= len;
+    }
+
+    return 0;
+}
+
 /* return non zero if error */
 static int http_open_cnx(URLContext *h, AVDictionary **options)
 {
@@ -465,9 +509,18 @@ redo:
          s->http_code == 303 || s->http_code == 307 || s->http_code == 308) &&
         s->new_location) {
         /* url moved, get next */
-        ffurl_closep(&s->hd);
-        if (redirects++ >= MAX_REDIRECTS)
+        if (redirects++ >= MAX_REDIRECTS) {
+            ffurl_closep(&s->hd);
             return AVERROR(EIO);
+        }
+
+        /* Redirects commonly point back at the same server; keep the
+         * connection open in that case and issue the next request on it
+         * rather than paying for a fresh TCP (and possibly TLS)
+         * handshake. */
+        if (!http_same_origin(s->location, s->new_location) ||
+            http_drain_redirect(h) < 0)
+            ffurl_closep(&s->hd);
 
         if (!s->expires) {
             s->expires = (s->http_code == 301 || s->http_code == 308) ? INT64_MAX : -1;
@@ -22,9 +22,12 @@
 #ifndef AVFORMAT_IMG2_H
 #define AVFORMAT_IMG2_H
 
+#include "config.h"
+
 #include <stdint.h>
 #include "avformat.h"
 #include "libavutil/opt.h"
+#include "libavutil/thread.h"
 
 #if HAVE_GLOB
 #include <glob.h>
@@ -60,6 +63,20 @@ typedef struct VideoDemuxData {
     int frame_size;
     int ts_from_file;
     int export_path_metadata; /**< enabled when set to 1. */
+    int prefetch;             /**< maximum number of files read ahead of the consumer */
+#if HAVE_THREADS
+    pthread_t prefetch_thread;
+    pthread_mutex_t prefetch_lock;
+    pthread_cond_t prefetch_cond;
+    struct ImgPrefetchEntry *prefetch_queue; /**< ring buffer of prefetch entries */
+    int prefetch_head;
+    int prefetch_count;
+    int prefetch_fetch_number; /**< img_number the prefetch thread reads next */
+    int prefetch_ret;          /**< error that stopped the prefetch thread */
+    int prefetch_eof;
+    int prefetch_started;
+    int prefetch_exit;
+#endif
 } VideoDemuxData;
 
 typedef struct IdStrMap {
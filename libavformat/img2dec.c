@@ -356,65 +356,292 @@ static int add_filename_as_pkt_side_data(char *filename, AVPacket *pkt) {
     return 0;
 }
 
-int ff_img_read_packet(AVFormatContext *s1, AVPacket *pkt)
+static int img_get_filename(AVFormatContext *s1, AVBPrint *filename,
+                            int img_number)
 {
     VideoDemuxData *s = s1->priv_data;
-    AVCodecParameters *par = s1->streams[0]->codecpar;
+
+    if (s->pattern_type == PT_NONE) {
+        av_bprintf(filename, "%s", s1->url);
+    } else if (s->use_glob) {
+#if HAVE_GLOB
+        if (img_number >= s->globstate.gl_pathc)
+            return AVERROR_EOF;
+        av_bprintf(filename, "%s", s->globstate.gl_pathv[img_number]);
+#endif
+    } else {
+        int ret = ff_bprint_get_frame_filename(filename, s1->url, img_number, 0);
+        if (ret < 0)
+            return ret;
+    }
+
+    if (!av_bprint_is_complete(filename))
+        return AVERROR(ENOMEM);
+
+    return 0;
+}
+
+/**
+ * Read the whole image file with the given sequence number into pkt.
+ * The packet is padded and zero-filled beyond the number of bytes read,
+ * which is stored in pkt->size.
+ */
+static int img_read_file(AVFormatContext *s1, AVPacket *pkt, int img_number)
+{
     AVBPrint filename;
     AVIOContext *f = NULL;
+    int64_t full_size;
     int size, ret;
 
     av_bprint_init(&filename, 0, AV_BPRINT_SIZE_UNLIMITED);
+    ret = img_get_filename(s1, &filename, img_number);
+    if (ret < 0)
+        goto fail;
 
-    if (s->pattern_type == PT_NONE && s->img_number - s->img_first >= 1)
-        return AVERROR_EOF;
+    ret = s1->io_open(s1, &f, filename.str, AVIO_FLAG_READ, NULL);
+    if (ret < 0)
+        goto fail;
 
-    if (!s->is_pipe) {
-        int64_t full_size;
+    full_size = avio_size(f);
+    if (full_size <= 0 || full_size > INT_MAX) {
+        ret = AVERROR(EINVAL);
+        goto fail;
+    }
+    size = full_size;
 
-        if (s->pattern_type == PT_NONE) {
-            av_bprintf(&filename, "%s", s1->url);
-        } else if (s->use_glob) {
-#if HAVE_GLOB
-            av_bprintf(&filename, "%s", s->globstate.gl_pathv[s->img_number]);
-#endif
-        } else {
-            int ret = ff_bprint_get_frame_filename(&filename, s1->url, s->img_number, 0);
-            if (ret < 0) {
-                av_bprint_finalize(&filename, NULL);
-                return ret;
-            }
+    ret = av_new_packet(pkt, size);
+    if (ret < 0)
+        goto fail;
+
+    ret = avio_read(f, pkt->data, size);
+    if (ret < 0)
+        goto fail;
+    memset(pkt->data + ret, 0, size - ret + AV_INPUT_BUFFER_PADDING_SIZE);
+    pkt->size = ret;
+    ret = 0;
+
+fail:
+    ff_format_io_close(s1, &f);
+    av_bprint_finalize(&filename, NULL);
+    return ret;
+}
+
+#if HAVE_THREADS
+typedef struct ImgPrefetchEntry {
+    AVPacket *pkt;
+    int img_number;
+    int ret;
+} ImgPrefetchEntry;
+
+static void *img_prefetch_thread(void *arg)
+{
+    AVFormatContext *s1 = arg;
+    VideoDemuxData *s = s1->priv_data;
+
+    pthread_mutex_lock(&s->prefetch_lock);
+    while (!s->prefetch_exit) {
+        ImgPrefetchEntry e = { 0 };
+
+        if (s->prefetch_count == s->prefetch || s->prefetch_eof) {
+            pthread_cond_wait(&s->prefetch_cond, &s->prefetch_lock);
+            continue;
         }
+        e.img_number = s->prefetch_fetch_number;
+        pthread_mutex_unlock(&s->prefetch_lock);
 
-        if (!av_bprint_is_complete(&filename)) {
-            av_bprint_finalize(&filename, NULL);
-            return AVERROR(ENOMEM);
+        e.pkt = av_packet_alloc();
+        if (!e.pkt)
+            e.ret = AVERROR(ENOMEM);
+        else
+            e.ret = img_read_file(s1, e.pkt, e.img_number);
+
+        pthread_mutex_lock(&s->prefetch_lock);
+        if (e.img_number != s->prefetch_fetch_number) {
+            /* a seek flushed the queue while we were reading */
+            av_packet_free(&e.pkt);
+            continue;
         }
+        s->prefetch_fetch_number++;
+        if (e.ret < 0) {
+            /* stop at the end of the sequence (or on a real error) until
+             * a seek makes more files interesting again */
+            s->prefetch_eof = 1;
+            s->prefetch_ret = e.ret;
+        }
+        s->prefetch_queue[(s->prefetch_head + s->prefetch_count) % s->prefetch] = e;
+        s->prefetch_count++;
+        pthread_cond_broadcast(&s->prefetch_cond);
+    }
+    pthread_mutex_unlock(&s->prefetch_lock);
 
-        ret = s1->io_open(s1, &f, filename.str, AVIO_FLAG_READ, NULL);
+    return NULL;
+}
+
+static int img_prefetch_start(AVFormatContext *s1)
+{
+    VideoDemuxData *s = s1->priv_data;
+    int ret;
+
+    s->prefetch_queue = av_calloc(s->prefetch, sizeof(*s->prefetch_queue));
+    if (!s->prefetch_queue)
+        return AVERROR(ENOMEM);
+
+    pthread_mutex_init(&s->prefetch_lock, NULL);
+    pthread_cond_init(&s->prefetch_cond, NULL);
+    s->prefetch_fetch_number = s->img_number;
+
+    ret = pthread_create(&s->prefetch_thread, NULL, img_prefetch_thread, s1);
+    if (ret) {
+        pthread_cond_destroy(&s->prefetch_cond);
+        pthread_mutex_destroy(&s->prefetch_lock);
+        av_freep(&s->prefetch_queue);
+        return AVERROR(ret);
+    }
+    s->prefetch_started = 1;
+
+    return 0;
+}
+
+static int img_prefetch_get(AVFormatContext *s1, AVPacket *pkt)
+{
+    VideoDemuxData *s = s1->priv_data;
+    ImgPrefetchEntry e;
+    int ret;
+
+    if (!s->prefetch)
+        return AVERROR(ENOSYS);
+
+    if (!s->prefetch_started) {
+        ret = img_prefetch_start(s1);
+        if (ret < 0) {
+            av_log(s1, AV_LOG_WARNING,
+                   "Could not start the prefetch thread, reading synchronously\n");
+            s->prefetch = 0;
+            return AVERROR(ENOSYS);
+        }
+    }
+
+    pthread_mutex_lock(&s->prefetch_lock);
+    for (;;) {
+        /* drop entries made stale by a seek */
+        while (s->prefetch_count &&
+               s->prefetch_queue[s->prefetch_head].img_number != s->img_number) {
+            av_packet_free(&s->prefetch_queue[s->prefetch_head].pkt);
+            s->prefetch_head = (s->prefetch_head + 1) % s->prefetch;
+            s->prefetch_count--;
+            pthread_cond_broadcast(&s->prefetch_cond);
+        }
+        if (s->prefetch_count)
+            break;
+        if (s->prefetch_eof) {
+            ret = s->prefetch_ret;
+            pthread_mutex_unlock(&s->prefetch_lock);
+            return ret;
+        }
+        pthread_cond_wait(&s->prefetch_cond, &s->prefetch_lock);
+    }
+    e = s->prefetch_queue[s->prefetch_head];
+    s->prefetch_head = (s->prefetch_head + 1) % s->prefetch;
+    s->prefetch_count--;
+    pthread_cond_broadcast(&s->prefetch_cond);
+    pthread_mutex_unlock(&s->prefetch_lock);
+
+    ret = e.ret;
+    if (ret >= 0)
+        av_packet_move_ref(pkt, e.pkt);
+    av_packet_free(&e.pkt);
+
+    return ret;
+}
+
+static void img_prefetch_flush(AVFormatContext *s1)
+{
+    VideoDemuxData *s = s1->priv_data;
+
+    if (!s->prefetch_started)
+        return;
+
+    pthread_mutex_lock(&s->prefetch_lock);
+    while (s->prefetch_count) {
+        av_packet_free(&s->prefetch_queue[s->prefetch_head].pkt);
+        s->prefetch_head = (s->prefetch_head + 1) % s->prefetch;
+        s->prefetch_count--;
+    }
+    s->prefetch_fetch_number = s->img_number;
+    s->prefetch_eof = 0;
+    pthread_cond_broadcast(&s->prefetch_cond);
+    pthread_mutex_unlock(&s->prefetch_lock);
+}
+
+static void img_prefetch_stop(AVFormatContext *s1)
+{
+    VideoDemuxData *s = s1->priv_data;
+
+    if (s->prefetch_started) {
+        pthread_mutex_lock(&s->prefetch_lock);
+        s->prefetch_exit = 1;
+        pthread_cond_broadcast(&s->prefetch_cond);
+        pthread_mutex_unlock(&s->prefetch_lock);
+        pthread_join(s->prefetch_thread, NULL);
+        while (s->prefetch_count) {
+            av_packet_free(&s->prefetch_queue[s->prefetch_head].pkt);
+            s->prefetch_head = (s->prefetch_head + 1) % s->prefetch;
+            s->prefetch_count--;
+        }
+        pthread_cond_destroy(&s->prefetch_cond);
+        pthread_mutex_destroy(&s->prefetch_lock);
+        s->prefetch_started = 0;
+    }
+    av_freep(&s->prefetch_queue);
+}
+#else
+static int img_prefetch_get(AVFormatContext *s1, AVPacket *pkt)
+{
+    return AVERROR(ENOSYS);
+}
+
+static void img_prefetch_flush(AVFormatContext *s1)
+{
+}
+
+static void img_prefetch_stop(AVFormatContext *s1)
+{
+}
+#endif
+
+int ff_img_read_packet(AVFormatContext *s1, AVPacket *pkt)
+{
+    VideoDemuxData *s = s1->priv_data;
+    AVCodecParameters *par = s1->streams[0]->codecpar;
+    AVBPrint filename;
+    int size, ret;
+
+    av_bprint_init(&filename, 0, AV_BPRINT_SIZE_UNLIMITED);
+
+    if (s->pattern_type == PT_NONE && s->img_number - s->img_first >= 1)
+        return AVERROR_EOF;
+
+    if (!s->is_pipe) {
+        ret = img_get_filename(s1, &filename, s->img_number);
         if (ret < 0)
             goto fail;
 
-        full_size = avio_size(f);
-        if (full_size <= 0 || full_size > INT_MAX) {
-            ret = AVERROR(EINVAL);
+        ret = img_prefetch_get(s1, pkt);
+        if (ret == AVERROR(ENOSYS))
+            ret = img_read_file(s1, pkt, s->img_number);
+        if (ret < 0)
             goto fail;
-        }
-        size = full_size;
+        size = pkt->size;
 
         if (par->codec_id == AV_CODEC_ID_NONE) {
             AVProbeData pd = { 0 };
             const FFInputFormat *ifmt;
-            uint8_t header[PROBE_BUF_MIN + AVPROBE_PADDING_SIZE];
+            uint8_t header[PROBE_BUF_MIN + AVPROBE_PADDING_SIZE] = { 0 };
             int score = 0;
 
-            ret = avio_read(f, header, PROBE_BUF_MIN);
-            if (ret < 0)
-                return ret;
-            memset(header + ret, 0, sizeof(header) - ret);
-            avio_skip(f, -ret);
+            memcpy(header, pkt->data, FFMIN(size, PROBE_BUF_MIN));
             pd.buf = header;
-            pd.buf_size = ret;
+            pd.buf_size = FFMIN(size, PROBE_BUF_MIN);
             pd.filename = filename.str;
 
             ifmt = ffifmt(av_probe_input_format3(&pd, 1, &score));
@@ -438,11 +665,18 @@ int ff_img_read_packet(AVFormatContext *s1, AVPacket *pkt)
         } else {
             size = 4096;
         }
+
+        ret = av_new_packet(pkt, size);
+        if (ret < 0)
+            goto fail;
+        pkt->pos = avio_tell(s1->pb);
+        ret = avio_read(s1->pb, pkt->data, size);
+        if (ret < 0)
+            goto fail;
+        memset(pkt->data + ret, 0, size - ret + AV_INPUT_BUFFER_PADDING_SIZE);
+        pkt->size = ret;
     }
 
-    ret = av_new_packet(pkt, size);
-    if (ret < 0)
-        goto fail;
     pkt->stream_index = 0;
     pkt->flags       |= AV_PKT_FLAG_KEY;
     if (s->ts_from_file) {
@@ -464,9 +698,6 @@ int ff_img_read_packet(AVFormatContext *s1, AVPacket *pkt)
         av_add_index_entry(s1->streams[0], s->img_number, pkt->pts, 0, 0, AVINDEX_KEYFRAME);
     }
 
-    if (s->is_pipe)
-        pkt->pos = avio_tell(s1->pb);
-
     /*
      * export_path_metadata must be explicitly enabled via
      * command line options for path metadata to be exported
@@ -479,19 +710,8 @@ int ff_img_read_packet(AVFormatContext *s1, AVPacket *pkt)
     }
 
     av_bprint_finalize(&filename, NULL);
-
-    ret = avio_read(f ? f : s1->pb, pkt->data, size);
-    if (f)
-        ff_format_io_close(s1, &f);
-
-    if (ret < 0) {
-        goto fail;
-    } else {
-        memset(pkt->data + ret, 0, size - ret + AV_INPUT_BUFFER_PADDING_SIZE);
-        pkt->size = ret;
-        s->img_number++;
-        return 0;
-    }
+    s->img_number++;
+    return 0;
 
 fail:
     av_bprint_finalize(&filename, NULL);
@@ -500,8 +720,10 @@ fail:
 
 static int img_read_close(struct AVFormatContext* s1)
 {
-#if HAVE_GLOB
     VideoDemuxData *s = s1->priv_data;
+
+    img_prefetch_stop(s1);
+#if HAVE_GLOB
     if (s->use_glob) {
         globfree(&s->globstate);
     }
@@ -519,6 +741,7 @@ static int img_read_seek(AVFormatContext *s, int stream_index, int64_t timestamp
     if (index < 0)
         return -1;
     s1->img_number = ffstream(st)->index_entries[index].timestamp + s1->img_first;
+    img_prefetch_flush(s);
     return 0;
 }
 
@@ -543,6 +766,7 @@ const AVOption ff_img_options[] = {
     { "sec",  "second precision",       0, AV_OPT_TYPE_CONST,    {.i64 = 1   }, 0, 2,       DEC, .unit = "ts_type" },
     { "ns",   "nano second precision",  0, AV_OPT_TYPE_CONST,    {.i64 = 2   }, 0, 2,       DEC, .unit = "ts_type" },
     { "export_path_metadata", "enable metadata containing input path information", OFFSET(export_path_metadata), AV_OPT_TYPE_BOOL,   {.i64 = 0   }, 0, 1,       DEC }, \
+    { "prefetch",     "set number of image files to read ahead in a background thread (0 = off)", OFFSET(prefetch), AV_OPT_TYPE_INT, {.i64 = 0}, 0, 256, DEC },
     COMMON_OPTIONS
 };
 
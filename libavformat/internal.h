@@ -305,6 +305,17 @@ typedef struct FFStream {
     int64_t last_IP_pts;
     int last_IP_duration;
 
+    /**
+     * Memoization for the per-packet duration conversions in
+     * compute_pkt_fields() and parse_packet(); their inputs repeat for
+     * every packet of fixed-frame-size audio and constant-rate video.
+     */
+    int64_t last_duration;            ///< packet duration last_duration_sec was computed from
+    AVRational last_duration_sec;     ///< last_duration in seconds, invalid if den is 0
+    int last_parser_sample_rate;
+    int64_t last_parser_duration;
+    int64_t last_parser_duration_tb;  ///< last_parser_duration rescaled to the stream time base
+
     /**
      * Number of packets to buffer for codec probing
      */
@@ -170,6 +170,30 @@ typedef struct MOVIndexRange {
     int64_t end;
 } MOVIndexRange;
 
+/**
+ * State of the on-demand sample index builder, so that
+ * ffstream(st)->index_entries can be materialized in batches during
+ * reading instead of all at once when the header is parsed.
+ */
+typedef struct MOVIndexCursor {
+    int active;                   ///< more samples remain to materialize
+    unsigned int chunk;           ///< chunk to resume from
+    unsigned int chunk_sample;    ///< sample within the chunk to resume from
+    unsigned int current_sample;
+    unsigned int stts_index;
+    unsigned int stts_sample;
+    unsigned int stsc_index;
+    unsigned int stss_index;
+    unsigned int stps_index;
+    unsigned int rap_group_index;
+    unsigned int rap_group_sample;
+    unsigned int distance;
+    int key_off;
+    int64_t current_dts;
+    int64_t current_offset;       ///< offset to resume from when mid-chunk
+    uint64_t stream_size;
+} MOVIndexCursor;
+
 typedef struct MOVStreamContext {
     AVIOContext *pb;
     int refcount;
@@ -182,6 +206,8 @@ typedef struct MOVStreamContext {
     unsigned int tts_count;
     unsigned int tts_allocated_size;
     MOVTimeToSample *tts_data;
+    int tts_runs;         ///< tts_data holds run-length entries, not one per sample
+    MOVIndexCursor index_cursor;
     unsigned int stts_count;
     unsigned int stts_allocated_size;
     MOVStts *stts_data;
@@ -385,6 +411,7 @@ typedef struct MOVContext {
     int nb_heif_grid;
     int64_t idat_offset;
     int interleaved_read;
+    int lazy_index;
 } MOVContext;
 
 int ff_mp4_read_descr_len(AVIOContext *pb);
@@ -422,6 +422,10 @@ typedef struct MatroskaDemuxContext {
     int skip_to_keyframe;
     uint64_t skip_to_timecode;
 
+    /* Blocks are only parsed far enough to grow the seek index;
+     * no packets are output. Used when seeking past the indexed area. */
+    int index_scan;
+
     /* File has a CUES element, but we defer parsing until it is needed. */
     int cues_parsing_deferred;
 
@@ -4162,6 +4166,11 @@ static int matroska_parse_block(MatroskaDemuxContext *matroska, AVBufferRef *buf
         }
     }
 
+    /* When scanning for index entries only, the blocks themselves are
+     * not needed; the caller discards the packet queue anyway. */
+    if (matroska->index_scan)
+        return 0;
+
     if (matroska->skip_to_keyframe &&
         track->type != MATROSKA_TRACK_TYPE_SUBTITLE) {
         // Compare signed timecodes. Timecode may be negative due to codec delay
@@ -4347,12 +4356,14 @@ static int matroska_read_seek(AVFormatContext *s, int stream_index,
     if ((index = av_index_search_timestamp(st, timestamp, flags)) < 0 ||
          index == sti->nb_index_entries - 1) {
         matroska_reset_status(matroska, 0, sti->index_entries[sti->nb_index_entries - 1].pos);
+        matroska->index_scan = 1;
         while ((index = av_index_search_timestamp(st, timestamp, flags)) < 0 ||
                index == sti->nb_index_entries - 1) {
             matroska_clear_queue(matroska);
             if (matroska_parse_cluster(matroska) < 0)
                 break;
         }
+        matroska->index_scan = 0;
     }
 
     matroska_clear_queue(matroska);
@@ -288,9 +288,11 @@ static int ebml_id_size(uint32_t id)
 
 static void put_ebml_id(AVIOContext *pb, uint32_t id)
 {
-    int i = ebml_id_size(id);
-    while (i--)
-        avio_w8(pb, (uint8_t)(id >> (i * 8)));
+    uint8_t buf[4];
+    int bytes = ebml_id_size(id);
+
+    AV_WB32(buf, id << (32 - 8 * bytes));
+    avio_write(pb, buf, bytes);
 }
 
 /**
@@ -335,9 +337,11 @@ static int ebml_length_size(uint64_t length)
  */
 static void put_ebml_num(AVIOContext *pb, uint64_t num, int bytes)
 {
+    uint8_t buf[8];
+
     num |= 1ULL << bytes * 7;
-    for (int i = bytes - 1; i >= 0; i--)
-        avio_w8(pb, (uint8_t)(num >> i * 8));
+    AV_WB64(buf, num << (64 - 8 * bytes));
+    avio_write(pb, buf, bytes);
 }
 
 /**
@@ -373,15 +377,16 @@ static void put_ebml_uid(AVIOContext *pb, uint32_t elementid, uint64_t uid)
 
 static void put_ebml_uint(AVIOContext *pb, uint32_t elementid, uint64_t val)
 {
-    int i, bytes = 1;
+    uint8_t buf[8];
+    int bytes = 1;
     uint64_t tmp = val;
     while (tmp >>= 8)
         bytes++;
 
     put_ebml_id(pb, elementid);
     put_ebml_length(pb, bytes, 0);
-    for (i = bytes - 1; i >= 0; i--)
-        avio_w8(pb, (uint8_t)(val >> i * 8));
+    AV_WB64(buf, val << (64 - 8 * bytes));
+    avio_write(pb, buf, bytes);
 }
 
 static void put_ebml_float(AVIOContext *pb, uint32_t elementid, double val)
@@ -717,8 +722,9 @@ static int ebml_writer_elem_write(const EbmlElement *elem, AVIOContext *pb)
         case EBML_SINT: {
             uint64_t val = elem->type == EBML_UINT ? elem->priv.uint
                                                    : elem->priv.sint;
-            for (int i = elem->size; --i >= 0; )
-                avio_w8(pb, (uint8_t)(val >> i * 8));
+            uint8_t buf[8];
+            AV_WB64(buf, val << (64 - 8 * elem->size));
+            avio_write(pb, buf, elem->size);
             break;
         }
         case EBML_STR:
@@ -4636,61 +4636,258 @@ static int mov_merge_tts_data(MOVContext *mov, AVStream *st, int flags)
     MOVStreamContext *sc = st->priv_data;
     int ctts = sc->ctts_data && (flags & MOV_MERGE_CTTS);
     int stts = sc->stts_data && (flags & MOV_MERGE_STTS);
-    int idx = 0;
+    uint64_t total = 0;
+    unsigned int i = 0, j = 0;
+    unsigned int stts_sample = 0, ctts_sample = 0;
 
     if (!sc->ctts_data && !sc->stts_data)
         return 0;
-    // Expand time to sample entries such that we have a 1-1 mapping with samples
     if (!sc->sample_count || sc->sample_count >= UINT_MAX / sizeof(*sc->tts_data))
         return -1;
 
-    if (ctts) {
-        sc->tts_data = av_fast_realloc(NULL, &sc->tts_allocated_size,
-                                       sc->sample_count * sizeof(*sc->tts_data));
-        if (!sc->tts_data)
-            return -1;
+    /* Merge the time to sample tables into run-length entries, split at
+     * every run boundary of either table, so that the result stays
+     * O(table runs) rather than one entry per sample. */
+    while (total < sc->sample_count &&
+           ((stts && i < sc->stts_count) || (ctts && j < sc->ctts_count))) {
+        unsigned int duration = 0;
+        int offset = 0;
+        uint64_t avail = FFMIN(sc->sample_count - total, INT_MAX);
+
+        if (stts && i < sc->stts_count) {
+            if (sc->stts_data[i].count <= stts_sample) {
+                i++;
+                stts_sample = 0;
+                continue;
+            }
+            duration = sc->stts_data[i].duration;
+            avail = FFMIN(avail, sc->stts_data[i].count - stts_sample);
+        }
+        if (ctts && j < sc->ctts_count) {
+            if (sc->ctts_data[j].count <= ctts_sample) {
+                j++;
+                ctts_sample = 0;
+                continue;
+            }
+            offset = sc->ctts_data[j].offset;
+            avail = FFMIN(avail, (uint64_t)sc->ctts_data[j].count - ctts_sample);
+        }
 
-        memset(sc->tts_data, 0, sc->tts_allocated_size);
+        if (add_tts_entry(&sc->tts_data, &sc->tts_count, &sc->tts_allocated_size,
+                          avail, offset, duration) == -1)
+            return -1;
 
-        for (int i = 0; i < sc->ctts_count &&
-                    idx < sc->sample_count; i++)
-            for (int j = 0; j < sc->ctts_data[i].count &&
-                        idx < sc->sample_count; j++) {
-                sc->tts_data[idx].offset = sc->ctts_data[i].offset;
-                sc->tts_data[idx++].count = 1;
-            }
+        total       += avail;
+        stts_sample += avail;
+        ctts_sample += avail;
+    }
+    sc->tts_runs = 1;
 
-        sc->tts_count = idx;
-    } else
+    if (!ctts)
         sc->ctts_count = 0;
     av_freep(&sc->ctts_data);
     sc->ctts_allocated_size = 0;
 
-    idx = 0;
-    if (stts) {
-        MOVTimeToSample *tts_data = av_fast_realloc(sc->tts_data, &sc->tts_allocated_size,
-                                                    sc->sample_count * sizeof(*sc->tts_data));
-        if (!tts_data)
-            return -1;
+    if (!stts)
+        sc->stts_count = 0;
+    av_freep(&sc->stts_data);
+    sc->stts_allocated_size = 0;
+
+    return 0;
+}
 
-        if (!sc->tts_data)
-            memset(tts_data, 0, sc->tts_allocated_size);
-        sc->tts_data = tts_data;
+/**
+ * Expand run-length tts entries into a 1-1 mapping with samples. The
+ * fragment code indexes tts_data by index entry, so it needs the old
+ * expanded layout.
+ */
+static int mov_expand_tts_data(MOVStreamContext *sc)
+{
+    MOVTimeToSample *tts_data = NULL;
+    unsigned int allocated_size = 0;
+    uint64_t total = 0;
+    unsigned int idx = 0;
 
-        for (int i = 0; i < sc->stts_count &&
-                    idx < sc->sample_count; i++)
-            for (int j = 0; j < sc->stts_data[i].count &&
-                        idx < sc->sample_count; j++) {
-                sc->tts_data[idx].duration = sc->stts_data[i].duration;
-                sc->tts_data[idx++].count = 1;
+    if (!sc->tts_runs)
+        return 0;
+    sc->tts_runs = 0;
+    if (!sc->tts_data)
+        return 0;
+
+    for (unsigned int i = 0; i < sc->tts_count; i++)
+        total += sc->tts_data[i].count;
+    if (!total || total >= UINT_MAX / sizeof(*tts_data))
+        return -1;
+
+    tts_data = av_fast_realloc(NULL, &allocated_size, total * sizeof(*tts_data));
+    if (!tts_data)
+        return -1;
+
+    for (unsigned int i = 0; i < sc->tts_count; i++)
+        for (unsigned int j = 0; j < sc->tts_data[i].count; j++) {
+            tts_data[idx].count    = 1;
+            tts_data[idx].offset   = sc->tts_data[i].offset;
+            tts_data[idx].duration = sc->tts_data[i].duration;
+            idx++;
+        }
+
+    av_free(sc->tts_data);
+    sc->tts_data           = tts_data;
+    sc->tts_count          = idx;
+    sc->tts_allocated_size = allocated_size;
+
+    return 0;
+}
+
+#define MOV_INDEX_CHUNK 16384
+
+/**
+ * Materialize up to nb_samples further samples into the index, resuming
+ * from the stream's index cursor. With the lazy_index option this runs
+ * in batches from the read and seek paths; otherwise mov_build_index()
+ * calls it once for the whole sample table.
+ */
+static int mov_index_append(MOVContext *mov, AVStream *st, unsigned int nb_samples)
+{
+    MOVStreamContext *sc = st->priv_data;
+    FFStream *const sti = ffstream(st);
+    MOVIndexCursor *cur = &sc->index_cursor;
+    int rap_group_present = sc->rap_group_count && sc->rap_group;
+    uint64_t target;
+    size_t min_size_needed;
+    unsigned int i, j;
+
+    if (!cur->active)
+        return 0;
+
+    target = FFMIN((uint64_t)cur->current_sample + nb_samples, sc->sample_count);
+
+    min_size_needed = (sti->nb_index_entries + (target - cur->current_sample)) *
+                      sizeof(*sti->index_entries);
+    if (min_size_needed > sti->index_entries_allocated_size) {
+        AVIndexEntry *entries =
+            av_fast_realloc(sti->index_entries,
+                            &sti->index_entries_allocated_size,
+                            min_size_needed);
+        if (!entries) {
+            cur->active = 0;
+            return AVERROR(ENOMEM);
+        }
+        sti->index_entries = entries;
+    }
+
+    for (i = cur->chunk; i < sc->chunk_count; i++) {
+        int64_t next_offset = i+1 < sc->chunk_count ? sc->chunk_offsets[i+1] : INT64_MAX;
+        int64_t current_offset = cur->chunk_sample ? cur->current_offset
+                                                   : sc->chunk_offsets[i];
+        while (mov_stsc_index_valid(cur->stsc_index, sc->stsc_count) &&
+            i + 1 == sc->stsc_data[cur->stsc_index + 1].first)
+            cur->stsc_index++;
+
+        if (next_offset > current_offset && sc->sample_size>0 && sc->sample_size < sc->stsz_sample_size &&
+            sc->stsc_data[cur->stsc_index].count * (int64_t)sc->stsz_sample_size > next_offset - current_offset) {
+            av_log(mov->fc, AV_LOG_WARNING, "STSZ sample size %d invalid (too large), ignoring\n", sc->stsz_sample_size);
+            sc->stsz_sample_size = sc->sample_size;
+        }
+        if (sc->stsz_sample_size>0 && sc->stsz_sample_size < sc->sample_size) {
+            av_log(mov->fc, AV_LOG_WARNING, "STSZ sample size %d invalid (too small), ignoring\n", sc->stsz_sample_size);
+            sc->stsz_sample_size = sc->sample_size;
+        }
+
+        for (j = cur->chunk_sample; j < sc->stsc_data[cur->stsc_index].count; j++) {
+            int keyframe = 0;
+            unsigned int sample_size;
+            if (cur->current_sample >= sc->sample_count) {
+                av_log(mov->fc, AV_LOG_ERROR, "wrong sample count\n");
+                cur->active = 0;
+                return AVERROR_INVALIDDATA;
+            }
+            if (cur->current_sample >= target) {
+                cur->chunk          = i;
+                cur->chunk_sample   = j;
+                cur->current_offset = current_offset;
+                return 0;
             }
 
-        sc->tts_count = FFMAX(sc->tts_count, idx);
-    } else
-        sc->stts_count = 0;
-    av_freep(&sc->stts_data);
-    sc->stts_allocated_size = 0;
+            if (!sc->keyframe_absent && (!sc->keyframe_count || cur->current_sample + cur->key_off == sc->keyframes[cur->stss_index])) {
+                keyframe = 1;
+                if (cur->stss_index + 1 < sc->keyframe_count)
+                    cur->stss_index++;
+            } else if (sc->stps_count && cur->current_sample + cur->key_off == sc->stps_data[cur->stps_index]) {
+                keyframe = 1;
+                if (cur->stps_index + 1 < sc->stps_count)
+                    cur->stps_index++;
+            }
+            if (rap_group_present && cur->rap_group_index < sc->rap_group_count) {
+                if (sc->rap_group[cur->rap_group_index].index > 0)
+                    keyframe = 1;
+                if (++cur->rap_group_sample == sc->rap_group[cur->rap_group_index].count) {
+                    cur->rap_group_sample = 0;
+                    cur->rap_group_index++;
+                }
+            }
+            if (sc->keyframe_absent
+                && !sc->stps_count
+                && !rap_group_present
+                && (st->codecpar->codec_type == AVMEDIA_TYPE_AUDIO || (i==0 && j==0)))
+                 keyframe = 1;
+            if (keyframe)
+                cur->distance = 0;
+            sample_size = sc->stsz_sample_size > 0 ? sc->stsz_sample_size : sc->sample_sizes[cur->current_sample];
+            if (current_offset > INT64_MAX - sample_size) {
+                av_log(mov->fc, AV_LOG_ERROR, "Current offset %"PRId64" or sample size %u is too large\n",
+                       current_offset,
+                       sample_size);
+                cur->active = 0;
+                return AVERROR_INVALIDDATA;
+            }
+
+            if (sc->pseudo_stream_id == -1 ||
+               sc->stsc_data[cur->stsc_index].id - 1 == sc->pseudo_stream_id) {
+                AVIndexEntry *e;
+                if (sample_size > 0x3FFFFFFF) {
+                    av_log(mov->fc, AV_LOG_ERROR, "Sample size %u is too large\n", sample_size);
+                    cur->active = 0;
+                    return AVERROR_INVALIDDATA;
+                }
+                e = &sti->index_entries[sti->nb_index_entries++];
+                e->pos = current_offset;
+                e->timestamp = cur->current_dts;
+                e->size = sample_size;
+                e->min_distance = cur->distance;
+                e->flags = keyframe ? AVINDEX_KEYFRAME : 0;
+                av_log(mov->fc, AV_LOG_TRACE, "AVIndex stream %d, sample %u, offset %"PRIx64", dts %"PRId64", "
+                        "size %u, distance %u, keyframe %d\n", st->index, cur->current_sample,
+                        current_offset, cur->current_dts, sample_size, cur->distance, keyframe);
+                if (st->codecpar->codec_type == AVMEDIA_TYPE_VIDEO && sti->nb_index_entries < 100)
+                    ff_rfps_add_frame(mov->fc, st, cur->current_dts);
+            }
+
+            current_offset += sample_size;
+            cur->stream_size += sample_size;
+
+            cur->current_dts += sc->tts_data[cur->stts_index].duration;
 
+            cur->distance++;
+            cur->stts_sample++;
+            cur->current_sample++;
+            if (cur->stts_index + 1 < sc->tts_count && cur->stts_sample == sc->tts_data[cur->stts_index].count) {
+                cur->stts_sample = 0;
+                cur->stts_index++;
+            }
+        }
+        cur->chunk_sample = 0;
+    }
+
+    cur->active = 0;
+    if (st->duration > 0)
+        st->codecpar->bit_rate = cur->stream_size * 8 * sc->time_scale / st->duration;
+    /* Per-sample helper tables are only kept while indexing is pending. */
+    av_freep(&sc->chunk_offsets);
+    av_freep(&sc->sample_sizes);
+    av_freep(&sc->keyframes);
+    av_freep(&sc->stps_data);
+    av_freep(&sc->rap_group);
     return 0;
 }
 
@@ -4700,12 +4897,8 @@ static void mov_build_index(MOVContext *mov, AVStream *st)
     FFStream *const sti = ffstream(st);
     int64_t current_offset;
     int64_t current_dts = 0;
-    unsigned int stts_index = 0;
     unsigned int stsc_index = 0;
-    unsigned int stss_index = 0;
-    unsigned int stps_index = 0;
-    unsigned int i, j;
-    uint64_t stream_size = 0;
+    unsigned int i;
 
     int ret = build_open_gop_key_points(st);
     if (ret < 0)
@@ -4762,14 +4955,8 @@ static void mov_build_index(MOVContext *mov, AVStream *st)
     /* only use old uncompressed audio chunk demuxing when stts specifies it */
     if (!(st->codecpar->codec_type == AVMEDIA_TYPE_AUDIO &&
           sc->stts_count == 1 && sc->stts_data && sc->stts_data[0].duration == 1)) {
-        unsigned int current_sample = 0;
-        unsigned int stts_sample = 0;
-        unsigned int sample_size;
-        unsigned int distance = 0;
-        unsigned int rap_group_index = 0;
-        unsigned int rap_group_sample = 0;
-        int rap_group_present = sc->rap_group_count && sc->rap_group;
         int key_off = (sc->keyframe_count && sc->keyframes[0] > 0) || (sc->stps_count && sc->stps_data[0] > 0);
+        int lazy;
 
         current_dts -= sc->dts_shift;
 
@@ -4777,110 +4964,37 @@ static void mov_build_index(MOVContext *mov, AVStream *st)
             return;
         if (sc->sample_count >= UINT_MAX / sizeof(*sti->index_entries) - sti->nb_index_entries)
             return;
-        if (av_reallocp_array(&sti->index_entries,
-                              sti->nb_index_entries + sc->sample_count,
-                              sizeof(*sti->index_entries)) < 0) {
-            sti->nb_index_entries = 0;
-            return;
-        }
-        sti->index_entries_allocated_size = (sti->nb_index_entries + sc->sample_count) * sizeof(*sti->index_entries);
 
         ret = mov_merge_tts_data(mov, st, MOV_MERGE_CTTS | MOV_MERGE_STTS);
         if (ret < 0)
             return;
 
-        for (i = 0; i < sc->chunk_count; i++) {
-            int64_t next_offset = i+1 < sc->chunk_count ? sc->chunk_offsets[i+1] : INT64_MAX;
-            current_offset = sc->chunk_offsets[i];
-            while (mov_stsc_index_valid(stsc_index, sc->stsc_count) &&
-                i + 1 == sc->stsc_data[stsc_index + 1].first)
-                stsc_index++;
-
-            if (next_offset > current_offset && sc->sample_size>0 && sc->sample_size < sc->stsz_sample_size &&
-                sc->stsc_data[stsc_index].count * (int64_t)sc->stsz_sample_size > next_offset - current_offset) {
-                av_log(mov->fc, AV_LOG_WARNING, "STSZ sample size %d invalid (too large), ignoring\n", sc->stsz_sample_size);
-                sc->stsz_sample_size = sc->sample_size;
-            }
-            if (sc->stsz_sample_size>0 && sc->stsz_sample_size < sc->sample_size) {
-                av_log(mov->fc, AV_LOG_WARNING, "STSZ sample size %d invalid (too small), ignoring\n", sc->stsz_sample_size);
-                sc->stsz_sample_size = sc->sample_size;
-            }
-
-            for (j = 0; j < sc->stsc_data[stsc_index].count; j++) {
-                int keyframe = 0;
-                if (current_sample >= sc->sample_count) {
-                    av_log(mov->fc, AV_LOG_ERROR, "wrong sample count\n");
-                    return;
-                }
-
-                if (!sc->keyframe_absent && (!sc->keyframe_count || current_sample+key_off == sc->keyframes[stss_index])) {
-                    keyframe = 1;
-                    if (stss_index + 1 < sc->keyframe_count)
-                        stss_index++;
-                } else if (sc->stps_count && current_sample+key_off == sc->stps_data[stps_index]) {
-                    keyframe = 1;
-                    if (stps_index + 1 < sc->stps_count)
-                        stps_index++;
-                }
-                if (rap_group_present && rap_group_index < sc->rap_group_count) {
-                    if (sc->rap_group[rap_group_index].index > 0)
-                        keyframe = 1;
-                    if (++rap_group_sample == sc->rap_group[rap_group_index].count) {
-                        rap_group_sample = 0;
-                        rap_group_index++;
-                    }
-                }
-                if (sc->keyframe_absent
-                    && !sc->stps_count
-                    && !rap_group_present
-                    && (st->codecpar->codec_type == AVMEDIA_TYPE_AUDIO || (i==0 && j==0)))
-                     keyframe = 1;
-                if (keyframe)
-                    distance = 0;
-                sample_size = sc->stsz_sample_size > 0 ? sc->stsz_sample_size : sc->sample_sizes[current_sample];
-                if (current_offset > INT64_MAX - sample_size) {
-                    av_log(mov->fc, AV_LOG_ERROR, "Current offset %"PRId64" or sample size %u is too large\n",
-                           current_offset,
-                           sample_size);
-                    return;
-                }
-
-                if (sc->pseudo_stream_id == -1 ||
-                   sc->stsc_data[stsc_index].id - 1 == sc->pseudo_stream_id) {
-                    AVIndexEntry *e;
-                    if (sample_size > 0x3FFFFFFF) {
-                        av_log(mov->fc, AV_LOG_ERROR, "Sample size %u is too large\n", sample_size);
-                        return;
-                    }
-                    e = &sti->index_entries[sti->nb_index_entries++];
-                    e->pos = current_offset;
-                    e->timestamp = current_dts;
-                    e->size = sample_size;
-                    e->min_distance = distance;
-                    e->flags = keyframe ? AVINDEX_KEYFRAME : 0;
-                    av_log(mov->fc, AV_LOG_TRACE, "AVIndex stream %d, sample %u, offset %"PRIx64", dts %"PRId64", "
-                            "size %u, distance %u, keyframe %d\n", st->index, current_sample,
-                            current_offset, current_dts, sample_size, distance, keyframe);
-                    if (st->codecpar->codec_type == AVMEDIA_TYPE_VIDEO && sti->nb_index_entries < 100)
-                        ff_rfps_add_frame(mov->fc, st, current_dts);
-                }
-
-                current_offset += sample_size;
-                stream_size += sample_size;
-
-                current_dts += sc->tts_data[stts_index].duration;
-
-                distance++;
-                stts_sample++;
-                current_sample++;
-                if (stts_index + 1 < sc->tts_count && stts_sample == sc->tts_data[stts_index].count) {
-                    stts_sample = 0;
-                    stts_index++;
-                }
+        sc->index_cursor = (MOVIndexCursor) {
+            .active      = 1,
+            .key_off     = key_off,
+            .current_dts = current_dts,
+        };
+
+        /* Materializing the index on demand only pays off for large
+         * sample tables, and the edit list and IAMF paths need the
+         * whole index up front. */
+        lazy = mov->lazy_index &&
+               sc->sample_count >= MOV_INDEX_CHUNK &&
+               !sc->iamf &&
+               (mov->ignore_editlist || !mov->advanced_editlist || !sc->elst_count);
+
+        if (!lazy) {
+            if (av_reallocp_array(&sti->index_entries,
+                                  sti->nb_index_entries + sc->sample_count,
+                                  sizeof(*sti->index_entries)) < 0) {
+                sti->nb_index_entries = 0;
+                return;
             }
+            sti->index_entries_allocated_size = (sti->nb_index_entries + sc->sample_count) * sizeof(*sti->index_entries);
         }
-        if (st->duration > 0)
-            st->codecpar->bit_rate = stream_size*8*sc->time_scale/st->duration;
+
+        if (mov_index_append(mov, st, lazy ? MOV_INDEX_CHUNK : sc->sample_count) < 0)
+            return;
     } else {
         unsigned chunk_samples, total = 0;
 
@@ -5284,6 +5398,13 @@ static int mov_read_trak(MOVContext *c, AVIOContext *pb, MOVAtom atom)
                 continue;
             stts_constant = 0;
         }
+        /* The last entry is excused above as a single closing sample;
+         * with run-length entries only give it that pass when it really
+         * covers just one sample. */
+        if (stts_constant && sc->tts_count > 1 &&
+            sc->tts_data[sc->tts_count - 1].count > 1 &&
+            sc->tts_data[sc->tts_count - 1].duration != sc->tts_data[0].duration)
+            stts_constant = 0;
         if (stts_constant)
             av_reduce(&st->r_frame_rate.num, &st->r_frame_rate.den,
                       sc->time_scale, sc->tts_data[0].duration, INT_MAX);
@@ -5319,13 +5440,15 @@ static int mov_read_trak(MOVContext *c, AVIOContext *pb, MOVAtom atom)
         if (!stts_constant)
             ffstream(st)->need_parsing = AVSTREAM_PARSE_FULL;
     }
-    /* Do not need those anymore. */
-    av_freep(&sc->chunk_offsets);
-    av_freep(&sc->sample_sizes);
-    av_freep(&sc->keyframes);
-    av_freep(&sc->stps_data);
+    /* Do not need those anymore, unless index building is still pending. */
+    if (!sc->index_cursor.active) {
+        av_freep(&sc->chunk_offsets);
+        av_freep(&sc->sample_sizes);
+        av_freep(&sc->keyframes);
+        av_freep(&sc->stps_data);
+        av_freep(&sc->rap_group);
+    }
     av_freep(&sc->elst_data);
-    av_freep(&sc->rap_group);
     av_freep(&sc->sync_group);
     av_freep(&sc->sgpd_sync);
 
@@ -5831,6 +5954,15 @@ static int mov_read_trun(MOVContext *c, AVIOContext *pb, MOVAtom atom)
     if (sc->pseudo_stream_id+1 != frag->stsd_id && sc->pseudo_stream_id != -1)
         return 0;
 
+    // The fragment code below indexes tts_data 1:1 with index entries,
+    // so any pending moov index build must be finished and run-length
+    // tts entries expanded first.
+    if (sc->index_cursor.active &&
+        mov_index_append(c, st, sc->sample_count) < 0)
+        return AVERROR(ENOMEM);
+    if (mov_expand_tts_data(sc) < 0)
+        return AVERROR(ENOMEM);
+
     // Find the next frag_index index that has a valid index_entry for
     // the current track_id.
     //
@@ -11025,6 +11157,10 @@ static AVIndexEntry *mov_find_next_sample(AVFormatContext *s, AVStream **st)
         AVStream *avst = s->streams[i];
         FFStream *const avsti = ffstream(avst);
         MOVStreamContext *msc = avst->priv_data;
+        while (msc->index_cursor.active &&
+               msc->current_sample >= avsti->nb_index_entries)
+            if (mov_index_append(mov, avst, MOV_INDEX_CHUNK) < 0)
+                break;
         if (msc->pb && msc->current_sample < avsti->nb_index_entries) {
             AVIndexEntry *current_sample = &avsti->index_entries[msc->current_sample];
             int64_t dts = av_rescale(current_sample->timestamp, AV_TIME_BASE, msc->time_scale);
@@ -11484,6 +11620,13 @@ static int mov_seek_stream(AVFormatContext *s, AVStream *st, int64_t timestamp,
     // can search over the DTS timeline.
     timestamp -= (sc->min_corrected_pts + sc->dts_shift);
 
+    /* With lazy_index, make sure the index covers the seek target. */
+    while (sc->index_cursor.active &&
+           (!sti->nb_index_entries ||
+            sti->index_entries[sti->nb_index_entries - 1].timestamp <= timestamp))
+        if (mov_index_append(s->priv_data, st, MOV_INDEX_CHUNK) < 0)
+            break;
+
     ret = mov_seek_fragment(s, st, timestamp);
     if (ret < 0)
         return ret;
@@ -11669,6 +11812,7 @@ static const AVOption mov_options[] = {
         {.i64 = 0}, 0, 1, FLAGS },
     { "max_stts_delta", "treat offsets above this value as invalid", OFFSET(max_stts_delta), AV_OPT_TYPE_INT, {.i64 = UINT_MAX-48000*10 }, 0, UINT_MAX, .flags = AV_OPT_FLAG_DECODING_PARAM },
     { "interleaved_read", "Interleave packets from multiple tracks at demuxer level", OFFSET(interleaved_read), AV_OPT_TYPE_BOOL, {.i64 = 1 }, 0, 1, .flags = AV_OPT_FLAG_DECODING_PARAM },
+    { "lazy_index", "Build sample indexes of large tracks on demand while reading", OFFSET(lazy_index), AV_OPT_TYPE_BOOL, {.i64 = 0 }, 0, 1, .flags = AV_OPT_FLAG_DECODING_PARAM },
 
     { NULL },
 };
@@ -88,6 +88,7 @@ static const AVOption options[] = {
     { "iods_video_profile", "iods video profile atom.", offsetof(MOVMuxContext, iods_video_profile), AV_OPT_TYPE_INT, {.i64 = -1}, -1, 255, AV_OPT_FLAG_ENCODING_PARAM},
     { "ism_lookahead", "Number of lookahead entries for ISM files", offsetof(MOVMuxContext, ism_lookahead), AV_OPT_TYPE_INT, {.i64 = 0}, 0, 255, AV_OPT_FLAG_ENCODING_PARAM},
     { "movflags", "MOV muxer flags", offsetof(MOVMuxContext, flags), AV_OPT_TYPE_FLAGS, {.i64 = 0}, INT_MIN, INT_MAX, AV_OPT_FLAG_ENCODING_PARAM, .unit = "movflags" },
+      { "async_flush", "Write finished fragments to the output from a background thread", 0, AV_OPT_TYPE_CONST, {.i64 = FF_MOV_FLAG_ASYNC_FLUSH}, INT_MIN, INT_MAX, AV_OPT_FLAG_ENCODING_PARAM, .unit = "movflags" },
       { "cmaf", "Write CMAF compatible fragmented MP4", 0, AV_OPT_TYPE_CONST, {.i64 = FF_MOV_FLAG_CMAF}, INT_MIN, INT_MAX, AV_OPT_FLAG_ENCODING_PARAM, .unit = "movflags" },
       { "dash", "Write DASH compatible fragmented MP4", 0, AV_OPT_TYPE_CONST, {.i64 = FF_MOV_FLAG_DASH}, INT_MIN, INT_MAX, AV_OPT_FLAG_ENCODING_PARAM, .unit = "movflags" },
       { "default_base_moof", "Set the default-base-is-moof flag in tfhd atoms", 0, AV_OPT_TYPE_CONST, {.i64 = FF_MOV_FLAG_DEFAULT_BASE_MOOF}, INT_MIN, INT_MAX, AV_OPT_FLAG_ENCODING_PARAM, .unit = "movflags" },
@@ -5641,7 +5642,10 @@ static int mov_add_tfra_entries(AVIOContext *pb, MOVMuxContext *mov, int tracks,
             track->frag_info_capacity = new_capacity;
         }
         info = &track->frag_info[track->nb_frag_info - 1];
-        info->offset   = avio_tell(pb);
+        /* frag_base is nonzero when the moof is assembled into a buffer
+         * for the background writer; it holds the absolute position the
+         * buffer will be written at. */
+        info->offset   = mov->frag_base + avio_tell(pb);
         info->size     = size;
         // Try to recreate the original pts for the first packet
         // from the fields we have stored
@@ -6460,6 +6464,162 @@ static int mov_write_squashed_packets(AVFormatContext *s)
     return 0;
 }
 
+typedef struct MOVFragMarker {
+    int offset;                  ///< position within the fragment buffer
+    int64_t time;
+    enum AVIODataMarkerType type;
+} MOVFragMarker;
+
+typedef struct MOVFragBuf {
+    struct MOVFragBuf *next;
+    uint8_t *data;
+    int size;
+    MOVFragMarker *markers;
+    int nb_markers;
+} MOVFragBuf;
+
+#if HAVE_THREADS
+static void mov_frag_buf_free(MOVFragBuf *frag)
+{
+    if (!frag)
+        return;
+    av_free(frag->data);
+    av_free(frag->markers);
+    av_free(frag);
+}
+
+static void *mov_frag_write_thread(void *arg)
+{
+    AVFormatContext *s = arg;
+    MOVMuxContext *mov = s->priv_data;
+
+    pthread_mutex_lock(&mov->frag_lock);
+    for (;;) {
+        MOVFragBuf *frag;
+        while (!mov->frag_queue && !mov->frag_thread_exit)
+            pthread_cond_wait(&mov->frag_cond, &mov->frag_lock);
+        frag = mov->frag_queue;
+        if (!frag)
+            break;
+        mov->frag_queue = frag->next;
+        if (!mov->frag_queue)
+            mov->frag_queue_tail = NULL;
+        pthread_mutex_unlock(&mov->frag_lock);
+
+        if (!mov->frag_err) {
+            int pos = 0;
+            for (int i = 0; i < frag->nb_markers; i++) {
+                MOVFragMarker *m = &frag->markers[i];
+                if (m->offset > pos) {
+                    avio_write(s->pb, frag->data + pos, m->offset - pos);
+                    pos = m->offset;
+                }
+                avio_write_marker(s->pb, m->time, m->type);
+            }
+            if (frag->size > pos)
+                avio_write(s->pb, frag->data + pos, frag->size - pos);
+        }
+        mov_frag_buf_free(frag);
+
+        pthread_mutex_lock(&mov->frag_lock);
+        if (s->pb->error < 0 && !mov->frag_err)
+            mov->frag_err = s->pb->error;
+        pthread_cond_broadcast(&mov->frag_cond);
+    }
+    pthread_mutex_unlock(&mov->frag_lock);
+    return NULL;
+}
+
+static int mov_frag_thread_start(AVFormatContext *s)
+{
+    MOVMuxContext *mov = s->priv_data;
+    int ret;
+
+    pthread_mutex_init(&mov->frag_lock, NULL);
+    pthread_cond_init(&mov->frag_cond, NULL);
+    mov->frag_pos = avio_tell(s->pb);
+    ret = pthread_create(&mov->frag_thread, NULL, mov_frag_write_thread, s);
+    if (ret) {
+        pthread_cond_destroy(&mov->frag_cond);
+        pthread_mutex_destroy(&mov->frag_lock);
+        return AVERROR(ret);
+    }
+    mov->frag_thread_started = 1;
+    return 0;
+}
+
+static int mov_frag_enqueue(AVFormatContext *s, MOVFragBuf *frag)
+{
+    MOVMuxContext *mov = s->priv_data;
+    int ret;
+
+    pthread_mutex_lock(&mov->frag_lock);
+    ret = mov->frag_err;
+    if (ret < 0) {
+        pthread_mutex_unlock(&mov->frag_lock);
+        mov_frag_buf_free(frag);
+        return ret;
+    }
+    frag->next = NULL;
+    if (mov->frag_queue_tail)
+        mov->frag_queue_tail->next = frag;
+    else
+        mov->frag_queue = frag;
+    mov->frag_queue_tail = frag;
+    mov->frag_pos += frag->size;
+    pthread_cond_broadcast(&mov->frag_cond);
+    pthread_mutex_unlock(&mov->frag_lock);
+    return 0;
+}
+
+static int mov_frag_thread_stop(AVFormatContext *s)
+{
+    MOVMuxContext *mov = s->priv_data;
+
+    if (!mov->frag_thread_started)
+        return 0;
+    pthread_mutex_lock(&mov->frag_lock);
+    mov->frag_thread_exit = 1;
+    pthread_cond_broadcast(&mov->frag_cond);
+    pthread_mutex_unlock(&mov->frag_lock);
+    pthread_join(mov->frag_thread, NULL);
+    pthread_cond_destroy(&mov->frag_cond);
+    pthread_mutex_destroy(&mov->frag_lock);
+    mov->frag_thread_started = 0;
+    mov->frag_thread_exit = 0;
+    return mov->frag_err;
+}
+
+static int mov_frag_add_marker(MOVFragBuf *frag, AVIOContext *pb,
+                               int64_t time, enum AVIODataMarkerType type)
+{
+    MOVFragMarker *markers = av_realloc_array(frag->markers, frag->nb_markers + 1,
+                                              sizeof(*frag->markers));
+    if (!markers)
+        return AVERROR(ENOMEM);
+    frag->markers = markers;
+    markers[frag->nb_markers++] = (MOVFragMarker) {
+        .offset = avio_tell(pb),
+        .time   = time,
+        .type   = type,
+    };
+    return 0;
+}
+#endif
+
+/* Emit a marker directly, or record it when the fragment is assembled
+ * into a buffer for the background writer thread. */
+static int mov_flush_marker(AVIOContext *pb, MOVFragBuf *frag,
+                            int64_t time, enum AVIODataMarkerType type)
+{
+#if HAVE_THREADS
+    if (frag)
+        return mov_frag_add_marker(frag, pb, time, type);
+#endif
+    avio_write_marker(pb, time, type);
+    return 0;
+}
+
 static int mov_finish_fragment(MOVMuxContext *mov, MOVTrack *track,
                                int64_t ref_pos)
 {
@@ -6495,6 +6655,8 @@ static int mov_finish_fragment(MOVMuxContext *mov, MOVTrack *track,
 static int mov_flush_fragment(AVFormatContext *s, int force)
 {
     MOVMuxContext *mov = s->priv_data;
+    AVIOContext *pb = s->pb;
+    MOVFragBuf *frag = NULL;
     int i, first_track = -1;
     int64_t mdat_size = 0, mdat_start = 0;
     int ret;
@@ -6646,9 +6808,30 @@ static int mov_flush_fragment(AVFormatContext *s, int force)
     if (!mdat_size)
         return 0;
 
-    avio_write_marker(s->pb,
-                      av_rescale(mov->tracks[first_track].cluster[0].dts, AV_TIME_BASE, mov->tracks[first_track].timescale),
-                      (has_video ? starts_with_key : mov->tracks[first_track].cluster[0].flags & MOV_SYNC_SAMPLE) ? AVIO_DATA_MARKER_SYNC_POINT : AVIO_DATA_MARKER_BOUNDARY_POINT);
+    mov->frag_base = 0;
+#if HAVE_THREADS
+    if (mov->flags & FF_MOV_FLAG_ASYNC_FLUSH) {
+        if (!mov->frag_thread_started &&
+            (ret = mov_frag_thread_start(s)) < 0)
+            return ret;
+        if (mov->frag_err < 0)
+            return mov->frag_err;
+        frag = av_mallocz(sizeof(*frag));
+        if (!frag)
+            return AVERROR(ENOMEM);
+        if ((ret = avio_open_dyn_buf(&pb)) < 0) {
+            av_free(frag);
+            return ret;
+        }
+        mov->frag_base = mov->frag_pos;
+    }
+#endif
+
+    ret = mov_flush_marker(pb, frag,
+                           av_rescale(mov->tracks[first_track].cluster[0].dts, AV_TIME_BASE, mov->tracks[first_track].timescale),
+                           (has_video ? starts_with_key : mov->tracks[first_track].cluster[0].flags & MOV_SYNC_SAMPLE) ? AVIO_DATA_MARKER_SYNC_POINT : AVIO_DATA_MARKER_BOUNDARY_POINT);
+    if (ret < 0)
+        goto fail;
 
     for (i = first_track; i < mov->nb_tracks; i++) {
         MOVTrack *track = &mov->tracks[i];
@@ -6665,17 +6848,18 @@ static int mov_flush_fragment(AVFormatContext *s, int force)
         }
 
         if (write_moof) {
-            avio_write_marker(s->pb, AV_NOPTS_VALUE, AVIO_DATA_MARKER_FLUSH_POINT);
+            if ((ret = mov_flush_marker(pb, frag, AV_NOPTS_VALUE, AVIO_DATA_MARKER_FLUSH_POINT)) < 0)
+                goto fail;
 
-            mov_write_moof_tag(s->pb, mov, moof_tracks, mdat_size);
+            mov_write_moof_tag(pb, mov, moof_tracks, mdat_size);
             mov->fragments++;
 
             if (track->cenc.aes_ctr)
                 ff_mov_cenc_flush(&track->cenc);
 
-            avio_wb32(s->pb, mdat_size + 8);
-            ffio_wfourcc(s->pb, "mdat");
-            mdat_start = avio_tell(s->pb);
+            avio_wb32(pb, mdat_size + 8);
+            ffio_wfourcc(pb, "mdat");
+            mdat_start = mov->frag_base + avio_tell(pb);
         }
 
         mov_finish_fragment(mov, &mov->tracks[i], mdat_start);
@@ -6691,14 +6875,30 @@ static int mov_flush_fragment(AVFormatContext *s, int force)
             mov->mdat_buf = NULL;
         }
 
-        avio_write(s->pb, buf, buf_size);
+        avio_write(pb, buf, buf_size);
         av_free(buf);
     }
 
     mov->mdat_size = 0;
 
-    avio_write_marker(s->pb, AV_NOPTS_VALUE, AVIO_DATA_MARKER_FLUSH_POINT);
+    if ((ret = mov_flush_marker(pb, frag, AV_NOPTS_VALUE, AVIO_DATA_MARKER_FLUSH_POINT)) < 0)
+        goto fail;
+
+#if HAVE_THREADS
+    if (frag) {
+        frag->size = avio_close_dyn_buf(pb, &frag->data);
+        return mov_frag_enqueue(s, frag);
+    }
+#endif
     return 0;
+fail:
+#if HAVE_THREADS
+    if (frag) {
+        ffio_free_dyn_buf(&pb);
+        mov_frag_buf_free(frag);
+    }
+#endif
+    return ret;
 }
 
 static int mov_auto_flush_fragment(AVFormatContext *s, int force)
@@ -7700,6 +7900,10 @@ static void mov_free(AVFormatContext *s)
 {
     MOVMuxContext *mov = s->priv_data;
 
+#if HAVE_THREADS
+    mov_frag_thread_stop(s);
+#endif
+
     for (int i = 0; i < s->nb_streams; i++)
         s->streams[i]->priv_data = NULL;
 
@@ -8002,6 +8206,23 @@ static int mov_init(AVFormatContext *s)
         return AVERROR(EINVAL);
     }
 
+    if (mov->flags & FF_MOV_FLAG_ASYNC_FLUSH) {
+        const char *reason = NULL;
+        if (!HAVE_THREADS)
+            reason = "requires threading support";
+        else if (!(mov->flags & FF_MOV_FLAG_FRAGMENT))
+            reason = "only applies to fragmented output";
+        else if (mov->ism_lookahead)
+            reason = "is incompatible with ism_lookahead";
+        for (i = 0; !reason && i < s->nb_streams; i++)
+            if (s->streams[i]->codecpar->codec_id == AV_CODEC_ID_TIMED_ID3)
+                reason = "is incompatible with timed ID3 streams";
+        if (reason) {
+            av_log(s, AV_LOG_WARNING, "The async_flush flag %s; ignoring\n", reason);
+            mov->flags &= ~FF_MOV_FLAG_ASYNC_FLUSH;
+        }
+    }
+
     /* Non-seekable output is ok if using fragmentation. If ism_lookahead
      * is enabled, we don't support non-seekable output at all. */
     if (!(s->pb->seekable & AVIO_SEEKABLE_NORMAL) &&
@@ -8704,6 +8925,10 @@ static int mov_write_trailer(AVFormatContext *s)
         mov->flags & FF_MOV_FLAG_HYBRID_FRAGMENTED) {
         if (mov->flags & FF_MOV_FLAG_HYBRID_FRAGMENTED) {
             mov_auto_flush_fragment(s, 1);
+#if HAVE_THREADS
+            if ((res = mov_frag_thread_stop(s)) < 0)
+                return res;
+#endif
             mov->mdat_size = avio_tell(pb) - mov->mdat_pos - 8;
             for (i = 0; i < mov->nb_tracks; i++) {
                 MOVTrack *track = &mov->tracks[i];
@@ -8764,6 +8989,10 @@ static int mov_write_trailer(AVFormatContext *s)
         res = 0;
     } else {
         mov_auto_flush_fragment(s, 1);
+#if HAVE_THREADS
+        if ((res = mov_frag_thread_stop(s)) < 0)
+            return res;
+#endif
         for (i = 0; i < mov->nb_tracks; i++)
            mov->tracks[i].data_offset = 0;
         if (mov->flags & FF_MOV_FLAG_GLOBAL_SIDX) {
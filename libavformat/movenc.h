@@ -27,6 +27,7 @@
 #include "avformat.h"
 #include "movenccenc.h"
 #include "libavcodec/packet_internal.h"
+#include "libavutil/thread.h"
 
 #define MOV_FRAG_INFO_ALLOC_INCREMENT 64
 #define MOV_INDEX_CLUSTER_SIZE 1024
@@ -264,6 +265,17 @@ typedef struct MOVMuxContext {
     int avif_extent_length[2];   // index 0 is YUV and 1 is Alpha.
     int is_animated_avif;
     int avif_loop_count;
+
+    int64_t frag_base;           ///< logical position of the fragment being assembled
+    int64_t frag_pos;            ///< logical output position including queued fragments
+    struct MOVFragBuf *frag_queue;
+    struct MOVFragBuf *frag_queue_tail;
+    pthread_t frag_thread;
+    pthread_mutex_t frag_lock;
+    pthread_cond_t frag_cond;
+    int frag_thread_started;
+    int frag_thread_exit;
+    int frag_err;
 } MOVMuxContext;
 
 #define FF_MOV_FLAG_RTP_HINT              (1 <<  0)
@@ -291,6 +303,7 @@ typedef struct MOVMuxContext {
 #define FF_MOV_FLAG_CMAF                  (1 << 22)
 #define FF_MOV_FLAG_PREFER_ICC            (1 << 23)
 #define FF_MOV_FLAG_HYBRID_FRAGMENTED     (1 << 24)
+#define FF_MOV_FLAG_ASYNC_FLUSH           (1 << 25)
 
 int ff_mov_write_packet(AVFormatContext *s, AVPacket *pkt);
 
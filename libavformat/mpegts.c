@@ -3009,7 +3009,7 @@ static int handle_packets(MpegTSContext *ts, int64_t nb_packets)
     AVFormatContext *s = ts->stream;
     uint8_t packet[TS_PACKET_SIZE + AV_INPUT_BUFFER_PADDING_SIZE];
     const uint8_t *data;
-    int64_t packet_num;
+    int64_t packet_num, pos;
     int ret = 0;
 
     if (avio_tell(s->pb) != ts->last_pos) {
@@ -3035,7 +3035,12 @@ static int handle_packets(MpegTSContext *ts, int64_t nb_packets)
     ts->stop_parse = 0;
     packet_num = 0;
     memset(packet + TS_PACKET_SIZE, 0, AV_INPUT_BUFFER_PADDING_SIZE);
+    pos = avio_tell(s->pb);
     for (;;) {
+        AVIOContext *const pb = s->pb;
+        int raw  = ts->raw_packet_size;
+        int skip = raw == TS_DVHS_PACKET_SIZE ? 4 : 0;
+
         packet_num++;
         if (nb_packets != 0 && packet_num >= nb_packets ||
             ts->stop_parse > 1) {
@@ -3045,11 +3050,27 @@ static int handle_packets(MpegTSContext *ts, int64_t nb_packets)
         if (ts->stop_parse > 0)
             break;
 
+        /* Fast path: when the avio buffer holds a whole in-sync raw
+         * packet, hand it to the dispatcher in place and track the
+         * position incrementally, skipping the per-packet read, skip
+         * and tell calls. */
+        if (pb->buf_end - pb->buf_ptr >= raw && !pb->update_checksum &&
+            pb->buf_ptr[skip] == SYNC_BYTE) {
+            ret = handle_packet(ts, pb->buf_ptr + skip,
+                                pos + skip + TS_PACKET_SIZE);
+            pb->buf_ptr += raw;
+            pos         += raw;
+            if (ret != 0)
+                break;
+            continue;
+        }
+
         ret = read_packet(s, packet, ts->raw_packet_size, &data);
         if (ret != 0)
             break;
         ret = handle_packet(ts, data, avio_tell(s->pb));
         finished_reading_packet(s, ts->raw_packet_size);
+        pos = avio_tell(s->pb);
         if (ret != 0)
             break;
     }
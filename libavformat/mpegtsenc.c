@@ -131,6 +131,13 @@ typedef struct MpegTSWrite {
     uint8_t provider_name[256];
 
     int omit_video_pes_length;
+
+    uint8_t *batch_buf;          /* collects the TS packets of one PES packet */
+    unsigned int batch_buf_size; /* allocated size of batch_buf */
+    int batch_pos;
+    int batch_active;
+
+    uint8_t null_packet[TS_PACKET_SIZE]; /* preformed, null packets are all identical */
 } MpegTSWrite;
 
 /* a PES packet header is generated every DEFAULT_PES_HEADER_FREQ packets */
@@ -968,17 +975,53 @@ static int64_t get_pcr(const MpegTSWrite *ts)
            ts->first_pcr;
 }
 
+/* While a batch is active, write_packet() collects the TS packets into
+ * batch_buf instead of writing each one to the output separately; the
+ * whole burst is then handed to the protocol in a single avio_write. */
+static void write_packet_batch_end(AVFormatContext *s)
+{
+    MpegTSWrite *ts = s->priv_data;
+
+    if (ts->batch_pos)
+        avio_write(s->pb, ts->batch_buf, ts->batch_pos);
+    ts->batch_pos    = 0;
+    ts->batch_active = 0;
+}
+
 static void write_packet(AVFormatContext *s, const uint8_t *packet)
 {
     MpegTSWrite *ts = s->priv_data;
+    uint8_t *dst = NULL;
+
+    if (ts->batch_active) {
+        uint8_t *buf = av_fast_realloc(ts->batch_buf, &ts->batch_buf_size,
+                                       ts->batch_pos + TS_PACKET_SIZE + 4);
+        if (!buf) {
+            /* flush what was collected so far and fall back to
+             * writing each packet directly */
+            write_packet_batch_end(s);
+        } else {
+            ts->batch_buf = buf;
+            dst = buf + ts->batch_pos;
+        }
+    }
     if (ts->m2ts_mode) {
         int64_t pcr = get_pcr(s->priv_data);
         uint32_t tp_extra_header = pcr % 0x3fffffff;
         tp_extra_header = AV_RB32(&tp_extra_header);
-        avio_write(s->pb, (unsigned char *) &tp_extra_header,
-                   sizeof(tp_extra_header));
+        if (dst) {
+            memcpy(dst, &tp_extra_header, sizeof(tp_extra_header));
+            dst           += sizeof(tp_extra_header);
+            ts->batch_pos += sizeof(tp_extra_header);
+        } else
+            avio_write(s->pb, (unsigned char *) &tp_extra_header,
+                       sizeof(tp_extra_header));
     }
-    avio_write(s->pb, packet, TS_PACKET_SIZE);
+    if (dst) {
+        memcpy(dst, packet, TS_PACKET_SIZE);
+        ts->batch_pos += TS_PACKET_SIZE;
+    } else
+        avio_write(s->pb, packet, TS_PACKET_SIZE);
     ts->total_size += TS_PACKET_SIZE;
 }
 
@@ -1109,6 +1152,13 @@ static int mpegts_init(AVFormatContext *s)
         }
     }
 
+    ts->null_packet[0] = SYNC_BYTE;
+    ts->null_packet[1] = 0x00 | (NULL_PID >> 8);
+    ts->null_packet[2] = NULL_PID & 0xff;
+    ts->null_packet[3] = 0x10;
+    /* data_bytes may be assigned any value */
+    memset(ts->null_packet + 4, STUFFING_BYTE, TS_PACKET_SIZE - 4);
+
     ts->m2ts_video_pid   = M2TS_VIDEO_PID;
     ts->m2ts_audio_pid   = M2TS_AUDIO_START_PID;
     ts->m2ts_pgssub_pid  = M2TS_PGSSUB_START_PID;
@@ -1358,16 +1408,73 @@ static int write_pcr_bits(uint8_t *buf, int64_t pcr)
 /* Write a single null transport stream packet */
 static void mpegts_insert_null_packet(AVFormatContext *s)
 {
-    uint8_t *q;
-    uint8_t buf[TS_PACKET_SIZE];
+    MpegTSWrite *ts = s->priv_data;
 
-    q    = buf;
-    *q++ = SYNC_BYTE;
-    *q++ = 0x00 | (NULL_PID >> 8);
-    *q++ = NULL_PID & 0xff;
-    *q++ = 0x10;
-    memset(q, STUFFING_BYTE, TS_PACKET_SIZE - (q - buf)); /* data_bytes may be assigned any value */
-    write_packet(s, buf);
+    write_packet(s, ts->null_packet);
+}
+
+/* Write a run of null packets in one go. The packets are all identical,
+ * so the batch buffer is extended by doubling the run already written
+ * instead of stamping each packet separately. */
+static void mpegts_insert_null_packets(AVFormatContext *s, int64_t count)
+{
+    MpegTSWrite *ts = s->priv_data;
+
+    if (ts->batch_active && !ts->m2ts_mode && count > 1) {
+        uint8_t *buf = av_fast_realloc(ts->batch_buf, &ts->batch_buf_size,
+                                       ts->batch_pos + count * TS_PACKET_SIZE);
+        if (buf) {
+            uint8_t *dst = buf + ts->batch_pos;
+            int64_t done = 1;
+
+            ts->batch_buf = buf;
+            memcpy(dst, ts->null_packet, TS_PACKET_SIZE);
+            while (done < count) {
+                int64_t n = FFMIN(done, count - done);
+                memcpy(dst + done * TS_PACKET_SIZE, dst, n * TS_PACKET_SIZE);
+                done += n;
+            }
+            ts->batch_pos  += count * TS_PACKET_SIZE;
+            ts->total_size += count * TS_PACKET_SIZE;
+            return;
+        }
+    }
+    for (int64_t i = 0; i < count; i++)
+        write_packet(s, ts->null_packet);
+}
+
+/* Number of consecutive null packets that may be inserted before the
+ * next PCR, SI retransmission or payload deadline would fire, so a
+ * whole CBR padding run can be synthesized at once. Underestimating is
+ * harmless: the caller re-evaluates after the run. */
+static int64_t null_run_length(AVFormatContext *s, int64_t dts, int64_t delay)
+{
+    MpegTSWrite *ts = s->priv_data;
+    int64_t deadline = (dts - delay) * SYSTEM_CLOCK_FREQUENCY_DIVISOR;
+    int64_t bytes, count;
+
+    deadline = FFMIN(deadline, ts->next_pcr);
+    if (ts->last_sdt_ts != AV_NOPTS_VALUE)
+        deadline = FFMIN(deadline, ts->last_sdt_ts + ts->sdt_period);
+    if (ts->last_pat_ts != AV_NOPTS_VALUE)
+        deadline = FFMIN(deadline, ts->last_pat_ts + ts->pat_period);
+    if (ts->last_nit_ts != AV_NOPTS_VALUE)
+        deadline = FFMIN(deadline, ts->last_nit_ts + ts->nit_period);
+
+    if (deadline <= ts->first_pcr)
+        return 1;
+
+    bytes = av_rescale(deadline - ts->first_pcr, ts->mux_rate, 8 * PCR_TIME_BASE);
+    count = (bytes - ts->total_size - 11) / TS_PACKET_SIZE;
+    count = av_clip64(count, 1, 16384);
+    /* av_rescale rounds to nearest; step back while the check preceding
+     * the last packet of the run would already cross the deadline */
+    while (count > 1 &&
+           av_rescale(ts->total_size + (count - 1) * TS_PACKET_SIZE + 11,
+                      8 * PCR_TIME_BASE, ts->mux_rate) + ts->first_pcr >= deadline)
+        count--;
+
+    return count;
 }
 
 /* Write a single transport stream packet with a PCR and no payload */
@@ -1511,6 +1618,7 @@ static void mpegts_write_pes(AVFormatContext *s, AVStream *st,
     }
 
     is_start = 1;
+    ts->batch_active = 1;
     while (payload_size > 0) {
         int64_t pcr = AV_NOPTS_VALUE;
         if (ts->mux_rate > 1)
@@ -1555,7 +1663,7 @@ static void mpegts_write_pes(AVFormatContext *s, AVStream *st,
                 if (write_pcr)
                     mpegts_insert_pcr_only(s, st);
                 else
-                    mpegts_insert_null_packet(s);
+                    mpegts_insert_null_packets(s, null_run_length(s, dts, delay));
                 /* recalculate write_pcr and possibly retransmit si_info */
                 continue;
             }
@@ -1764,6 +1872,7 @@ static void mpegts_write_pes(AVFormatContext *s, AVStream *st,
         payload_size -= len;
         write_packet(s, buf);
     }
+    write_packet_batch_end(s);
     ts_st->prev_payload_key = key;
 }
 
@@ -2300,6 +2409,7 @@ static void mpegts_deinit(AVFormatContext *s)
         av_freep(&service);
     }
     av_freep(&ts->services);
+    av_freep(&ts->batch_buf);
 }
 
 static int mpegts_check_bitstream(AVFormatContext *s, AVStream *st,
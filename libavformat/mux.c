@@ -836,13 +836,18 @@ int ff_interleave_add_packet(AVFormatContext *s, AVPacket *pkt,
                              int (*compare)(AVFormatContext *, const AVPacket *, const AVPacket *))
 {
     int ret;
-    FFFormatContext *const si = ffformatcontext(s);
+    FormatContextInternal *const fci = ff_fc_internal(s);
+    FFFormatContext *const si = &fci->fc;
     PacketListEntry **next_point, *this_pktl;
     AVStream *st = s->streams[pkt->stream_index];
     FFStream *const sti = ffstream(st);
     int chunked  = s->max_chunk_size || s->max_chunk_duration;
 
-    this_pktl    = av_malloc(sizeof(*this_pktl));
+    if (fci->packet_pool) {
+        this_pktl        = fci->packet_pool;
+        fci->packet_pool = this_pktl->next;
+    } else
+        this_pktl = av_malloc(sizeof(*this_pktl));
     if (!this_pktl) {
         av_packet_unref(pkt);
         return AVERROR(ENOMEM);
@@ -945,6 +950,19 @@ int ff_interleave_packet_per_dts(AVFormatContext *s, AVPacket *pkt,
     int noninterleaved_count = 0;
     int ret;
 
+    /* With a single stream and an empty queue interleaving is the identity;
+     * skip the round trip through the packet buffer. Chunked interleaving
+     * still needs the buffer to mark chunk boundaries. */
+    if (has_packet && s->nb_streams == 1 && !si->packet_buffer.head &&
+        !s->max_chunk_size && !s->max_chunk_duration) {
+        ret = av_packet_make_refcounted(pkt);
+        if (ret < 0) {
+            av_packet_unref(pkt);
+            return ret;
+        }
+        return 1;
+    }
+
     if (has_packet) {
         if ((ret = ff_interleave_add_packet(s, pkt, interleave_compare_dts)) < 0)
             return ret;
@@ -1010,7 +1028,13 @@ int ff_interleave_packet_per_dts(AVFormatContext *s, AVPacket *pkt,
 
         if (sti->last_in_packet_buffer == pktl)
             sti->last_in_packet_buffer = NULL;
-        avpriv_packet_list_get(&si->packet_buffer, pkt);
+        si->packet_buffer.head = pktl->next;
+        if (!si->packet_buffer.head)
+            si->packet_buffer.tail = NULL;
+        av_packet_move_ref(pkt, &pktl->pkt);
+        /* Recycle the node for the next incoming packet. */
+        pktl->next       = fci->packet_pool;
+        fci->packet_pool = pktl;
 
         return 1;
     } else {
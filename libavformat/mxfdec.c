@@ -317,6 +317,9 @@ typedef struct MXFContext {
     int run_in;
     MXFPartition *current_partition;
     int parsing_backward;
+    /* highest partition_score() among partitions whose header metadata sets
+     * were actually parsed, used to skip lower-scored repetitions */
+    uint64_t parsed_metadata_score;
     int64_t last_forward_tell;
     int last_forward_partition;
     int nb_index_tables;
@@ -3847,11 +3850,23 @@ static int mxf_read_header(AVFormatContext *s)
         for (x = 0; x < FF_ARRAY_ELEMS(mxf_metadata_read_table); x++) {
             const MXFMetadataReadTableEntry *metadata = &mxf_metadata_read_table[x];
             if (IS_KLV_KEY(klv.key, metadata->key)) {
-                if (metadata->read) {
+                if (!metadata->read) {
+                    avio_skip(s->pb, klv.length);
+                } else if (metadata->ctx_size && metadata->type != IndexTableSegment &&
+                           partition_score(mxf->current_partition) < mxf->parsed_metadata_score) {
+                    /* Every set in this partition would lose against one we
+                     * already parsed (see mxf_add_metadata_set()), so don't
+                     * bother parsing this metadata repetition at all. This
+                     * keeps the cost of opening files with many partitions
+                     * proportional to the index data instead of having to
+                     * parse the header metadata over and over. */
+                    avio_skip(s->pb, klv.length);
+                } else {
+                    if (metadata->ctx_size && metadata->type != IndexTableSegment)
+                        mxf->parsed_metadata_score = FFMAX(mxf->parsed_metadata_score,
+                                                           partition_score(mxf->current_partition));
                     if ((ret = mxf_parse_klv(mxf, klv, metadata->read, metadata->ctx_size, metadata->type)) < 0)
                         return ret;
-                } else {
-                    avio_skip(s->pb, klv.length);
                 }
                 break;
             }
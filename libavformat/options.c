@@ -32,6 +32,7 @@
 #include "libavutil/intmath.h"
 #include "libavutil/mem.h"
 #include "libavutil/opt.h"
+#include "libavutil/thread.h"
 
 /**
  * @file
@@ -159,23 +160,51 @@ static int io_close2_default(AVFormatContext *s, AVIOContext *pb)
     return avio_close(pb);
 }
 
+/* A fully constructed context, initialized once and then copied into every
+ * new context, so that the AVOption defaults walk is not redone on every
+ * avformat_alloc_context() call. */
+static AVFormatContext format_context_template;
+
+static void init_format_context_template(void)
+{
+    AVFormatContext *s = &format_context_template;
+
+    s->av_class = &av_format_context_class;
+    s->io_open  = io_open_default;
+    s->io_close2= io_close2_default;
+
+    av_opt_set_defaults(s);
+}
+
 AVFormatContext *avformat_alloc_context(void)
 {
+    static AVOnce init_static_once = AV_ONCE_INIT;
     FormatContextInternal *fci;
     FFFormatContext *si;
     AVFormatContext *s;
 
+    ff_thread_once(&init_static_once, init_format_context_template);
+
     fci = av_mallocz(sizeof(*fci));
     if (!fci)
         return NULL;
 
     si = &fci->fc;
     s = &si->pub;
-    s->av_class = &av_format_context_class;
-    s->io_open  = io_open_default;
-    s->io_close2= io_close2_default;
-
-    av_opt_set_defaults(s);
+    memcpy(s, &format_context_template, sizeof(*s));
+
+    /* dump_separator is the only option whose default allocates; give the
+     * context its own copy instead of aliasing the template's. This must be
+     * kept in sync if other allocating defaults (non-NULL string/dict)
+     * are ever added to the options table. */
+    s->dump_separator = NULL;
+    if (format_context_template.dump_separator) {
+        s->dump_separator = av_strdup(format_context_template.dump_separator);
+        if (!s->dump_separator) {
+            avformat_free_context(s);
+            return NULL;
+        }
+    }
 
     si->pkt = av_packet_alloc();
     si->parse_pkt = av_packet_alloc();
@@ -312,9 +312,11 @@ int ff_rtmp_packet_write(URLContext *h, RTMPPacket *pkt,
                          int *nb_prev_pkt)
 {
     uint8_t pkt_hdr[16], *p = pkt_hdr;
+    uint8_t stack_buf[4096], *buf, *q;
     int mode = RTMP_PS_TWELVEBYTES;
     int off = 0;
     int written = 0;
+    int hdr_size, cont_size, nb_cont;
     int ret;
     RTMPPacket *prev_pkt;
     int use_delta; // flag if using timestamp delta, not RTMP_PS_TWELVEBYTES
@@ -379,34 +381,42 @@ int ff_rtmp_packet_write(URLContext *h, RTMPPacket *pkt,
     prev_pkt[pkt->channel_id].ts_field   = pkt->ts_field;
     prev_pkt[pkt->channel_id].extra      = pkt->extra;
 
-    // FIXME:
-    // Writing packets is currently not optimized to minimize system calls.
-    // Since system calls flush on exit which we cannot change in a system-independant way.
-    // We should fix this behavior and by writing packets in a single or in as few as possible system calls.
-    // Protocols like TCP and RTMP should benefit from this when enabling TCP_NODELAY.
+    /* Assemble the whole message - header, payload and the continuation
+     * headers interleaved at chunk boundaries - into a single buffer, so
+     * that every RTMP message costs one write call instead of one per
+     * chunk. This matters a lot when pushing many live outputs, and also
+     * keeps each message in as few TCP segments as possible when Nagle's
+     * algorithm is disabled. */
+    hdr_size     = p - pkt_hdr;
+    cont_size    = 1 + (pkt->ts_field == 0xFFFFFF ? 4 : 0);
+    nb_cont      = pkt->size > chunk_size ? (pkt->size - 1) / chunk_size : 0;
+    written      = hdr_size + pkt->size + nb_cont * cont_size;
+
+    buf = stack_buf;
+    if (written > sizeof(stack_buf)) {
+        buf = av_malloc(written);
+        if (!buf)
+            return AVERROR(ENOMEM);
+    }
 
-    if ((ret = ffurl_write(h, pkt_hdr, p - pkt_hdr)) < 0)
-        return ret;
-    written = p - pkt_hdr + pkt->size;
+    q = buf;
+    bytestream_put_buffer(&q, pkt_hdr, hdr_size);
     while (off < pkt->size) {
         int towrite = FFMIN(chunk_size, pkt->size - off);
-        if ((ret = ffurl_write(h, pkt->data + off, towrite)) < 0)
-            return ret;
+        bytestream_put_buffer(&q, pkt->data + off, towrite);
         off += towrite;
         if (off < pkt->size) {
-            uint8_t marker = 0xC0 | pkt->channel_id;
-            if ((ret = ffurl_write(h, &marker, 1)) < 0)
-                return ret;
-            written++;
-            if (pkt->ts_field == 0xFFFFFF) {
-                uint8_t ts_header[4];
-                AV_WB32(ts_header, timestamp);
-                if ((ret = ffurl_write(h, ts_header, 4)) < 0)
-                    return ret;
-                written += 4;
-            }
+            bytestream_put_byte(&q, 0xC0 | pkt->channel_id);
+            if (pkt->ts_field == 0xFFFFFF)
+                bytestream_put_be32(&q, timestamp);
         }
     }
+
+    ret = ffurl_write(h, buf, written);
+    if (buf != stack_buf)
+        av_free(buf);
+    if (ret < 0)
+        return ret;
     return written;
 }
 
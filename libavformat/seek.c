@@ -27,6 +27,7 @@
 #include "libavutil/timestamp.h"
 
 #include "libavcodec/avcodec.h"
+#include "libavcodec/bytestream.h"
 
 #include "avformat.h"
 #include "avformat_internal.h"
@@ -278,6 +279,135 @@ const AVIndexEntry *avformat_index_get_entry_from_timestamp(AVStream *st,
     return &sti->index_entries[idx];
 }
 
+#define INDEX_BLOB_MAGIC    MKBETAG('A', 'V', 'I', 'X')
+#define INDEX_BLOB_VERSION  1
+#define INDEX_BLOB_ENTRY_SIZE 24
+
+int avformat_index_export(AVFormatContext *s, uint8_t **data, size_t *size)
+{
+    uint64_t total = 12;
+    uint8_t *buf, *p;
+
+    *data = NULL;
+    *size = 0;
+
+    for (unsigned i = 0; i < s->nb_streams; i++)
+        total += 4 + (uint64_t)INDEX_BLOB_ENTRY_SIZE *
+                     ffstream(s->streams[i])->nb_index_entries;
+    if (total > SIZE_MAX)
+        return AVERROR(ERANGE);
+
+    buf = av_malloc(total);
+    if (!buf)
+        return AVERROR(ENOMEM);
+
+    p = buf;
+    bytestream_put_be32(&p, INDEX_BLOB_MAGIC);
+    bytestream_put_be32(&p, INDEX_BLOB_VERSION);
+    bytestream_put_be32(&p, s->nb_streams);
+    for (unsigned i = 0; i < s->nb_streams; i++) {
+        const FFStream *const sti = ffstream(s->streams[i]);
+
+        bytestream_put_be32(&p, sti->nb_index_entries);
+        for (int j = 0; j < sti->nb_index_entries; j++) {
+            const AVIndexEntry *const ie = &sti->index_entries[j];
+
+            bytestream_put_be64(&p, ie->pos);
+            bytestream_put_be64(&p, ie->timestamp);
+            bytestream_put_be32(&p, (uint32_t)(ie->flags & 3) << 30 | ie->size);
+            bytestream_put_be32(&p, ie->min_distance);
+        }
+    }
+    av_assert0(p - buf == total);
+
+    *data = buf;
+    *size = total;
+    return 0;
+}
+
+int avformat_index_import(AVFormatContext *s, const uint8_t *data, size_t size)
+{
+    GetByteContext gb;
+    AVIndexEntry **new_entries;
+    unsigned *new_counts;
+    int ret = AVERROR_INVALIDDATA;
+
+    if (size < 12 || size > INT_MAX)
+        return AVERROR_INVALIDDATA;
+    bytestream2_init(&gb, data, size);
+
+    if (bytestream2_get_be32(&gb) != INDEX_BLOB_MAGIC ||
+        bytestream2_get_be32(&gb) != INDEX_BLOB_VERSION)
+        return AVERROR_INVALIDDATA;
+    if (bytestream2_get_be32(&gb) != s->nb_streams)
+        return AVERROR_INVALIDDATA;
+
+    new_entries = av_calloc(s->nb_streams, sizeof(*new_entries));
+    new_counts  = av_calloc(s->nb_streams, sizeof(*new_counts));
+    if (!new_entries || !new_counts) {
+        ret = AVERROR(ENOMEM);
+        goto fail;
+    }
+
+    /* Parse everything into temporary arrays first, so that a truncated
+     * or corrupted blob leaves the context untouched. */
+    for (unsigned i = 0; i < s->nb_streams; i++) {
+        unsigned count;
+
+        if (bytestream2_get_bytes_left(&gb) < 4)
+            goto fail;
+        count = bytestream2_get_be32(&gb);
+        if (count > bytestream2_get_bytes_left(&gb) / INDEX_BLOB_ENTRY_SIZE ||
+            count >= UINT_MAX / sizeof(AVIndexEntry))
+            goto fail;
+        new_counts[i] = count;
+        if (!count)
+            continue;
+
+        new_entries[i] = av_malloc_array(count, sizeof(**new_entries));
+        if (!new_entries[i]) {
+            ret = AVERROR(ENOMEM);
+            goto fail;
+        }
+        for (unsigned j = 0; j < count; j++) {
+            AVIndexEntry *const ie = &new_entries[i][j];
+            uint32_t v;
+
+            ie->pos          = bytestream2_get_be64(&gb);
+            ie->timestamp    = bytestream2_get_be64(&gb);
+            v                = bytestream2_get_be32(&gb);
+            ie->flags        = v >> 30;
+            ie->size         = v & 0x3FFFFFFF;
+            ie->min_distance = bytestream2_get_be32(&gb);
+            /* The index must be sorted by strictly increasing timestamps
+             * for the binary search to work. */
+            if (j && ie->timestamp <= ie[-1].timestamp)
+                goto fail;
+        }
+    }
+    if (bytestream2_get_bytes_left(&gb))
+        goto fail;
+
+    for (unsigned i = 0; i < s->nb_streams; i++) {
+        FFStream *const sti = ffstream(s->streams[i]);
+
+        av_freep(&sti->index_entries);
+        sti->index_entries                = new_entries[i];
+        sti->nb_index_entries             = new_counts[i];
+        sti->index_entries_allocated_size = new_counts[i] * sizeof(AVIndexEntry);
+        new_entries[i] = NULL;
+    }
+    ret = 0;
+
+fail:
+    if (ret < 0 && new_entries)
+        for (unsigned i = 0; i < s->nb_streams; i++)
+            av_freep(&new_entries[i]);
+    av_freep(&new_entries);
+    av_freep(&new_counts);
+    return ret;
+}
+
 static int64_t read_timestamp(AVFormatContext *s, int stream_index, int64_t *ppos, int64_t pos_limit,
                               int64_t (*read_timestamp)(struct AVFormatContext *, int , int64_t *, int64_t ))
 {
@@ -749,6 +879,87 @@ int avformat_flush(AVFormatContext *s)
     return 0;
 }
 
+struct AVFormatReadState {
+    int64_t  pos;        ///< byte position raw reading resumes at
+    int64_t  ts;         ///< DTS at the bookmark, in ref_stream time base
+    int      ref_stream; ///< stream ts belongs to, -1 if ts is unreliable
+    unsigned nb_streams;
+};
+
+int avformat_read_state_save(AVFormatContext *s, AVFormatReadState **state)
+{
+    AVFormatReadState *st;
+
+    *state = NULL;
+    if (!(s->iformat && (ffifmt(s->iformat)->read_seek ||
+                         ffifmt(s->iformat)->read_seek2)) &&
+        (!s->pb || !(s->pb->seekable & AVIO_SEEKABLE_NORMAL)))
+        return AVERROR(EINVAL);
+
+    st = av_mallocz(sizeof(*st));
+    if (!st)
+        return AVERROR(ENOMEM);
+
+    st->ref_stream = -1;
+    st->ts         = AV_NOPTS_VALUE;
+    for (unsigned i = 0; i < s->nb_streams; i++) {
+        const FFStream *const sti = ffstream(s->streams[i]);
+
+        if (sti->cur_dts != AV_NOPTS_VALUE && !is_relative(sti->cur_dts)) {
+            st->ref_stream = i;
+            st->ts         = sti->cur_dts;
+            break;
+        }
+    }
+
+    /* Flushing drops buffered and parser-delayed packets, so that the raw
+     * byte position below is exactly where the next delivered packet starts;
+     * this makes the state after a save identical to the state after a
+     * restore. */
+    ff_read_frame_flush(s);
+    st->pos        = s->pb ? avio_tell(s->pb) : -1;
+    st->nb_streams = s->nb_streams;
+
+    *state = st;
+    return 0;
+}
+
+int avformat_read_state_restore(AVFormatContext *s, const AVFormatReadState *state)
+{
+    int64_t ret;
+
+    if (state->nb_streams != s->nb_streams)
+        return AVERROR(EINVAL);
+
+    /* Demuxers with their own seek callback resolve positions through an
+     * index that is already in memory, so going through it is cheap and,
+     * unlike a raw byte position, consistent with their internal state. */
+    if (ffifmt(s->iformat)->read_seek || ffifmt(s->iformat)->read_seek2) {
+        int64_t ts     = state->ts;
+        int stream_idx = state->ref_stream;
+
+        if (ts == AV_NOPTS_VALUE) {
+            ts = s->start_time != AV_NOPTS_VALUE ? s->start_time : 0;
+            stream_idx = -1;
+        }
+        return avformat_seek_file(s, stream_idx, INT64_MIN, ts, ts, 0);
+    }
+
+    if (state->pos < 0)
+        return AVERROR(EINVAL);
+
+    ff_read_frame_flush(s);
+    ret = avio_seek(s->pb, state->pos, SEEK_SET);
+    if (ret < 0)
+        return ret;
+    return 0;
+}
+
+void avformat_read_state_free(AVFormatReadState **state)
+{
+    av_freep(state);
+}
+
 void ff_rescale_interval(AVRational tb_in, AVRational tb_out,
                          int64_t *min_ts, int64_t *ts, int64_t *max_ts)
 {
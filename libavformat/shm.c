@@ -0,0 +1,352 @@
+/*
+ * Shared memory protocol
+ *
+ * This file is part of Librempeg
+ *
+ * Librempeg is free software; you can redistribute it and/or modify
+ * it under the terms of the GNU General Public License as published by
+ * the Free Software Foundation; either version 3 of the License, or
+ * (at your option) any later version.
+ *
+ * Librempeg is distributed in the hope that it will be useful,
+ * but WITHOUT ANY WARRANTY; without even the implied warranty of
+ * MERCHANTABILITY or FITNESS FOR A PARTICULAR PURPOSE.  See the
+ * GNU General Public License for more details.
+ *
+ * You should have received a copy of the GNU General Public License along
+ * with Librempeg; if not, write to the Free Software Foundation, Inc.,
+ * 51 Franklin Street, Fifth Floor, Boston, MA 02110-1301 USA.
+ */
+
+/**
+ * @file
+ *
+ * Shared memory url_protocol: a bounded byte ring in a POSIX shared
+ * memory segment, for moving data between the processes of a split
+ * pipeline without the syscall and copy overhead of a pipe. The writing
+ * side creates and initializes the segment, the reading side attaches
+ * to it; both block on a process-shared condition instead of polling.
+ */
+
+#include <fcntl.h>
+#include <stdatomic.h>
+#include <string.h>
+#include <sys/mman.h>
+#include <sys/stat.h>
+#include <unistd.h>
+
+#include "libavutil/avstring.h"
+#include "libavutil/opt.h"
+#include "libavutil/thread.h"
+#include "libavutil/time.h"
+#include "url.h"
+
+#define SHM_RING_MAGIC   MKTAG('f','s','h','m')
+#define SHM_RING_VERSION 1
+
+/* one state-change poll interval, also bounds interrupt_callback latency */
+#define SHM_WAIT_USEC 100000
+
+typedef struct ShmRing {
+    atomic_uint magic;        /**< set last by the creator, attach handshake */
+    uint32_t version;
+    uint32_t header_size;     /**< sizeof(ShmRing) of the creator, guards ABI mismatch */
+    uint32_t ring_size;
+    pthread_mutex_t lock;
+    pthread_cond_t update;    /**< signalled on every state change */
+    uint64_t wpos;            /**< total bytes written */
+    uint64_t rpos;            /**< total bytes read */
+    uint32_t eof;             /**< the writer detached */
+    uint32_t abort;           /**< the reader detached */
+    uint8_t data[];
+} ShmRing;
+
+typedef struct ShmContext {
+    const AVClass *class;
+    char name[256];
+    int fd;
+    ShmRing *ring;
+    size_t map_size;
+    int creator;
+    int ring_size;
+    int timeout;
+} ShmContext;
+
+#define OFFSET(x) offsetof(ShmContext, x)
+#define ED AV_OPT_FLAG_DECODING_PARAM|AV_OPT_FLAG_ENCODING_PARAM
+static const AVOption shm_options[] = {
+    { "ring_size", "Ring buffer size in bytes (writer only)", OFFSET(ring_size), AV_OPT_TYPE_INT, { .i64 = 8 * 1024 * 1024 }, 4096, INT_MAX - sizeof(ShmRing), AV_OPT_FLAG_ENCODING_PARAM },
+    { "timeout",   "Timeout in ms to wait for the writer",    OFFSET(timeout),   AV_OPT_TYPE_INT, { .i64 = 5000 },               0, INT_MAX, AV_OPT_FLAG_DECODING_PARAM },
+    { NULL }
+};
+
+static const AVClass shm_class = {
+    .class_name = "shm",
+    .option     = shm_options,
+    .version    = LIBAVUTIL_VERSION_INT,
+};
+
+/* wait for a state change for at most SHM_WAIT_USEC, with the lock held */
+static void shm_wait(ShmRing *ring)
+{
+    struct timespec ts;
+    int64_t t = av_gettime() + SHM_WAIT_USEC;
+
+    ts.tv_sec  = t / 1000000;
+    ts.tv_nsec = t % 1000000 * 1000;
+    pthread_cond_timedwait(&ring->update, &ring->lock, &ts);
+}
+
+static int shm_create(URLContext *h)
+{
+    ShmContext *s = h->priv_data;
+    pthread_mutexattr_t mattr;
+    pthread_condattr_t cattr;
+    ShmRing *ring;
+    int ret;
+
+    s->fd = shm_open(s->name, O_CREAT | O_EXCL | O_RDWR, 0666);
+    if (s->fd < 0)
+        return AVERROR(errno);
+    s->creator = 1;
+
+    s->map_size = sizeof(ShmRing) + s->ring_size;
+    if (ftruncate(s->fd, s->map_size) < 0)
+        return AVERROR(errno);
+
+    ring = mmap(NULL, s->map_size, PROT_READ | PROT_WRITE, MAP_SHARED, s->fd, 0);
+    if (ring == MAP_FAILED)
+        return AVERROR(errno);
+    s->ring = ring;
+
+    if ((ret = pthread_mutexattr_init(&mattr)) ||
+        (ret = pthread_mutexattr_setpshared(&mattr, PTHREAD_PROCESS_SHARED)) ||
+        (ret = pthread_mutex_init(&ring->lock, &mattr)))
+        return AVERROR(ret);
+    pthread_mutexattr_destroy(&mattr);
+
+    if ((ret = pthread_condattr_init(&cattr)) ||
+        (ret = pthread_condattr_setpshared(&cattr, PTHREAD_PROCESS_SHARED)) ||
+        (ret = pthread_cond_init(&ring->update, &cattr)))
+        return AVERROR(ret);
+    pthread_condattr_destroy(&cattr);
+
+    ring->version     = SHM_RING_VERSION;
+    ring->header_size = sizeof(ShmRing);
+    ring->ring_size   = s->ring_size;
+
+    /* the segment is only valid for attaching once everything above is
+     * visible, which the release store on the magic guarantees */
+    atomic_store_explicit(&ring->magic, SHM_RING_MAGIC, memory_order_release);
+
+    return 0;
+}
+
+static int shm_attach(URLContext *h)
+{
+    ShmContext *s = h->priv_data;
+    int64_t deadline = av_gettime() + s->timeout * INT64_C(1000);
+    struct stat st;
+    ShmRing *ring;
+
+    /* the writer may not have created the segment yet */
+    for (;;) {
+        s->fd = shm_open(s->name, O_RDWR, 0);
+        if (s->fd >= 0)
+            break;
+        if (errno != ENOENT)
+            return AVERROR(errno);
+        if (ff_check_interrupt(&h->interrupt_callback))
+            return AVERROR_EXIT;
+        if (av_gettime() >= deadline) {
+            av_log(h, AV_LOG_ERROR, "No writer on %s within %d ms\n",
+                   s->name, s->timeout);
+            return AVERROR(ETIMEDOUT);
+        }
+        av_usleep(10000);
+    }
+
+    if (fstat(s->fd, &st) < 0)
+        return AVERROR(errno);
+    if (st.st_size < sizeof(ShmRing))
+        return AVERROR_INVALIDDATA;
+    s->map_size = st.st_size;
+
+    ring = mmap(NULL, s->map_size, PROT_READ | PROT_WRITE, MAP_SHARED, s->fd, 0);
+    if (ring == MAP_FAILED)
+        return AVERROR(errno);
+    s->ring = ring;
+
+    while (atomic_load_explicit(&ring->magic, memory_order_acquire) != SHM_RING_MAGIC) {
+        if (ff_check_interrupt(&h->interrupt_callback))
+            return AVERROR_EXIT;
+        if (av_gettime() >= deadline) {
+            av_log(h, AV_LOG_ERROR, "Writer did not initialize %s within %d ms\n",
+                   s->name, s->timeout);
+            return AVERROR(ETIMEDOUT);
+        }
+        av_usleep(10000);
+    }
+
+    if (ring->version != SHM_RING_VERSION ||
+        ring->header_size != sizeof(ShmRing) ||
+        sizeof(ShmRing) + (uint64_t)ring->ring_size != s->map_size) {
+        av_log(h, AV_LOG_ERROR, "Incompatible shared memory ring layout on %s\n",
+               s->name);
+        return AVERROR_INVALIDDATA;
+    }
+
+    return 0;
+}
+
+static int shm_close(URLContext *h);
+
+static int shm_open_url(URLContext *h, const char *filename, int flags)
+{
+    ShmContext *s = h->priv_data;
+    int ret;
+
+    s->fd = -1;
+
+    av_strstart(filename, "shm:", &filename);
+    if (!*filename)
+        return AVERROR(EINVAL);
+    /* shm_open() wants a name starting with exactly one slash */
+    while (*filename == '/')
+        filename++;
+    snprintf(s->name, sizeof(s->name), "/%s", filename);
+
+    if ((flags & AVIO_FLAG_READ) && (flags & AVIO_FLAG_WRITE)) {
+        av_log(h, AV_LOG_ERROR, "shm cannot be opened for reading and writing at once\n");
+        return AVERROR(EINVAL);
+    }
+
+    ret = flags & AVIO_FLAG_WRITE ? shm_create(h) : shm_attach(h);
+    if (ret < 0) {
+        shm_close(h);
+        return ret;
+    }
+
+    h->is_streamed = 1;
+
+    return 0;
+}
+
+static int shm_read(URLContext *h, uint8_t *buf, int size)
+{
+    ShmContext *s = h->priv_data;
+    ShmRing *ring = s->ring;
+    uint32_t off, chunk;
+    uint64_t avail;
+
+    pthread_mutex_lock(&ring->lock);
+
+    while (!(avail = ring->wpos - ring->rpos) && !ring->eof) {
+        if (h->flags & AVIO_FLAG_NONBLOCK) {
+            pthread_mutex_unlock(&ring->lock);
+            return AVERROR(EAGAIN);
+        }
+        if (ff_check_interrupt(&h->interrupt_callback)) {
+            pthread_mutex_unlock(&ring->lock);
+            return AVERROR_EXIT;
+        }
+        shm_wait(ring);
+    }
+
+    if (!avail) {
+        pthread_mutex_unlock(&ring->lock);
+        return AVERROR_EOF;
+    }
+
+    size  = FFMIN(size, avail);
+    off   = ring->rpos % ring->ring_size;
+    chunk = FFMIN(size, ring->ring_size - off);
+    memcpy(buf, ring->data + off, chunk);
+    memcpy(buf + chunk, ring->data, size - chunk);
+    ring->rpos += size;
+
+    pthread_cond_broadcast(&ring->update);
+    pthread_mutex_unlock(&ring->lock);
+
+    return size;
+}
+
+static int shm_write(URLContext *h, const uint8_t *buf, int size)
+{
+    ShmContext *s = h->priv_data;
+    ShmRing *ring = s->ring;
+    uint32_t off, chunk;
+    uint64_t space;
+
+    pthread_mutex_lock(&ring->lock);
+
+    while (!(space = ring->ring_size - (ring->wpos - ring->rpos))) {
+        if (ring->abort)
+            break;
+        if (h->flags & AVIO_FLAG_NONBLOCK) {
+            pthread_mutex_unlock(&ring->lock);
+            return AVERROR(EAGAIN);
+        }
+        if (ff_check_interrupt(&h->interrupt_callback)) {
+            pthread_mutex_unlock(&ring->lock);
+            return AVERROR_EXIT;
+        }
+        shm_wait(ring);
+    }
+
+    if (ring->abort) {
+        pthread_mutex_unlock(&ring->lock);
+        return AVERROR(EPIPE);
+    }
+
+    size  = FFMIN(size, space);
+    off   = ring->wpos % ring->ring_size;
+    chunk = FFMIN(size, ring->ring_size - off);
+    memcpy(ring->data + off, buf, chunk);
+    memcpy(ring->data, buf + chunk, size - chunk);
+    ring->wpos += size;
+
+    pthread_cond_broadcast(&ring->update);
+    pthread_mutex_unlock(&ring->lock);
+
+    return size;
+}
+
+static int shm_close(URLContext *h)
+{
+    ShmContext *s = h->priv_data;
+    ShmRing *ring = s->ring;
+
+    if (ring) {
+        if (atomic_load(&ring->magic) == SHM_RING_MAGIC) {
+            pthread_mutex_lock(&ring->lock);
+            if (s->creator)
+                ring->eof = 1;
+            else
+                ring->abort = 1;
+            pthread_cond_broadcast(&ring->update);
+            pthread_mutex_unlock(&ring->lock);
+        }
+        munmap(ring, s->map_size);
+        s->ring = NULL;
+    }
+    if (s->fd >= 0) {
+        close(s->fd);
+        s->fd = -1;
+    }
+    /* once both sides detached, nothing can attach to the ring anymore */
+    if (s->creator)
+        shm_unlink(s->name);
+
+    return 0;
+}
+
+const URLProtocol ff_shm_protocol = {
+    .name            = "shm",
+    .url_open        = shm_open_url,
+    .url_read        = shm_read,
+    .url_write       = shm_write,
+    .url_close       = shm_close,
+    .priv_data_size  = sizeof(ShmContext),
+    .priv_data_class = &shm_class,
+};
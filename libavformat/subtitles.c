@@ -399,6 +399,37 @@ static inline int is_eol(char c)
     return c == '\r' || c == '\n';
 }
 
+/* Length of the initial run of p that contains neither line breaks nor NUL,
+ * so it can be copied in bulk instead of byte by byte through ff_text_r8().
+ * memchr() is vectorized by the libc, which makes a large difference when
+ * parsing big subtitle files at open time. */
+static size_t plain_run(const uint8_t *p, size_t len)
+{
+    const uint8_t *end = memchr(p, '\n', len);
+    if (end)
+        len = end - p;
+    end = memchr(p, '\r', len);
+    if (end)
+        len = end - p;
+    end = memchr(p, '\0', len);
+    if (end)
+        len = end - p;
+    return len;
+}
+
+/* Return the number of plain bytes that can be read in bulk from the avio
+ * buffer, 0 when the byte-wise path has to be taken (UTF-16 input, pending
+ * lookahead bytes, empty buffer, or a line break / NUL up next). */
+static size_t bulk_run(const FFTextReader *r)
+{
+    AVIOContext *pb = r->pb;
+
+    if (r->type != FF_UTF_8 || r->buf_pos < r->buf_len ||
+        pb->buf_ptr >= pb->buf_end || pb->error)
+        return 0;
+    return plain_run(pb->buf_ptr, pb->buf_end - pb->buf_ptr);
+}
+
 int ff_subtitles_read_text_chunk(FFTextReader *tr, AVBPrint *buf)
 {
     char eol_buf[5], last_was_cr = 0;
@@ -407,7 +438,24 @@ int ff_subtitles_read_text_chunk(FFTextReader *tr, AVBPrint *buf)
     av_bprint_clear(buf);
 
     for (;;) {
-        char c = ff_text_r8(tr);
+        size_t run = bulk_run(tr);
+        char c;
+
+        if (run) {
+            AVIOContext *pb = tr->pb;
+
+            if (i) {
+                eol_buf[i] = 0;
+                av_bprintf(buf, "%s", eol_buf);
+                i = nb_eol = 0;
+            }
+            av_bprint_append_data(buf, (const char *)pb->buf_ptr, run);
+            pb->buf_ptr += run;
+            n += run;
+            continue;
+        }
+
+        c = ff_text_r8(tr);
 
         if (!c)
             break;
@@ -458,7 +506,18 @@ ptrdiff_t ff_subtitles_read_line(FFTextReader *tr, char *buf, size_t size)
         return 0;
     buf[0] = '\0';
     while (cur + 1 < size) {
-        unsigned char c = ff_text_r8(tr);
+        unsigned char c;
+        size_t run = FFMIN(bulk_run(tr), size - 1 - cur);
+
+        if (run) {
+            memcpy(buf + cur, tr->pb->buf_ptr, run);
+            tr->pb->buf_ptr += run;
+            cur += run;
+            buf[cur] = '\0';
+            continue;
+        }
+
+        c = ff_text_r8(tr);
         if (!c)
             return ff_text_eof(tr) ? cur : AVERROR_INVALIDDATA;
         if (c == '\r' || c == '\n')
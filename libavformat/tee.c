@@ -364,14 +364,9 @@ static int open_slave(AVFormatContext *avf, char *slave, TeeSlave *tee_slave)
             continue;
 
         if (!tee_slave->bsfs[target_stream]) {
-            /* Add pass-through bitstream filter */
-            ret = av_bsf_get_null_filter(&tee_slave->bsfs[target_stream]);
-            if (ret < 0) {
-                av_log(avf, AV_LOG_ERROR,
-                       "Failed to create pass-through bitstream filter: %s\n",
-                       av_err2str(ret));
-                goto end;
-            }
+            /* No filtering requested for this stream: packets are handed to
+             * the slave muxer directly, see tee_write_packet(). */
+            continue;
         }
 
         tee_slave->bsfs[target_stream]->time_base_in = avf->streams[i]->time_base;
@@ -568,6 +563,20 @@ static int tee_write_packet(AVFormatContext *avf, AVPacket *pkt)
         bsfs = tee->slaves[i].bsfs[s2];
         pkt2->stream_index = s2;
 
+        if (!bsfs) {
+            /* Common case: no per-slave bitstream filtering, hand the
+             * reference straight to the slave muxer. */
+            av_packet_rescale_ts(pkt2, avf->streams[s]->time_base,
+                                 avf2->streams[s2]->time_base);
+            ret = av_interleaved_write_frame(avf2, pkt2);
+            if (ret < 0) {
+                ret = tee_process_slave_failure(avf, i, ret);
+                if (!ret_all && ret < 0)
+                    ret_all = ret;
+            }
+            continue;
+        }
+
         ret = av_bsf_send_packet(bsfs, pkt2);
         if (ret < 0) {
             av_packet_unref(pkt2);
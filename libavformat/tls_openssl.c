@@ -19,11 +19,15 @@
  * 51 Franklin Street, Fifth Floor, Boston, MA 02110-1301 USA.
  */
 
+#include "avformat.h"
 #include "network.h"
 #include "os_support.h"
 #include "url.h"
 #include "tls.h"
+#include "libavutil/avstring.h"
+#include "libavutil/mem.h"
 #include "libavutil/opt.h"
+#include "libavutil/thread.h"
 
 #include <openssl/bio.h>
 #include <openssl/ssl.h>
@@ -37,9 +41,87 @@ typedef struct TLSContext {
 #if OPENSSL_VERSION_NUMBER >= 0x1010000fL
     BIO_METHOD* url_bio_method;
 #endif
+    char *session_key;
     int io_err;
 } TLSContext;
 
+#if OPENSSL_VERSION_NUMBER >= 0x10100000L
+/* Per-process cache of recently negotiated sessions, keyed by host:port,
+ * so that reconnects to the same server can resume the session with an
+ * abbreviated handshake instead of redoing the full key exchange. */
+#define TLS_SESSION_CACHE_SIZE 16
+
+typedef struct TLSSessionCacheEntry {
+    char *key;
+    SSL_SESSION *session;
+} TLSSessionCacheEntry;
+
+static TLSSessionCacheEntry session_cache[TLS_SESSION_CACHE_SIZE];
+static int session_cache_pos;
+static AVMutex session_cache_mutex = AV_MUTEX_INITIALIZER;
+
+static SSL_SESSION *tls_session_cache_get(const char *key)
+{
+    SSL_SESSION *session = NULL;
+
+    ff_mutex_lock(&session_cache_mutex);
+    for (int i = 0; i < TLS_SESSION_CACHE_SIZE; i++) {
+        if (session_cache[i].key && !strcmp(session_cache[i].key, key)) {
+            session = session_cache[i].session;
+            SSL_SESSION_up_ref(session);
+            break;
+        }
+    }
+    ff_mutex_unlock(&session_cache_mutex);
+
+    return session;
+}
+
+/* Takes ownership of the reference passed by the caller. */
+static void tls_session_cache_put(const char *key, SSL_SESSION *session)
+{
+    TLSSessionCacheEntry *entry = NULL;
+
+    ff_mutex_lock(&session_cache_mutex);
+    for (int i = 0; i < TLS_SESSION_CACHE_SIZE; i++) {
+        if (session_cache[i].key && !strcmp(session_cache[i].key, key)) {
+            entry = &session_cache[i];
+            break;
+        }
+    }
+    if (!entry) {
+        entry = &session_cache[session_cache_pos];
+        session_cache_pos = (session_cache_pos + 1) % TLS_SESSION_CACHE_SIZE;
+        av_freep(&entry->key);
+        entry->key = av_strdup(key);
+        if (!entry->key) {
+            if (entry->session) {
+                SSL_SESSION_free(entry->session);
+                entry->session = NULL;
+            }
+            ff_mutex_unlock(&session_cache_mutex);
+            SSL_SESSION_free(session);
+            return;
+        }
+    }
+    if (entry->session)
+        SSL_SESSION_free(entry->session);
+    entry->session = session;
+    ff_mutex_unlock(&session_cache_mutex);
+}
+
+static int tls_new_session_cb(SSL *ssl, SSL_SESSION *session)
+{
+    TLSContext *c = SSL_get_app_data(ssl);
+
+    if (!c || !c->session_key)
+        return 0;
+    tls_session_cache_put(c->session_key, session);
+    /* The cache keeps the reference handed to the callback. */
+    return 1;
+}
+#endif
+
 /* OpenSSL 1.0.2 or below, then you would use SSL_library_init. If you are
  * using OpenSSL 1.1.0 or above, then the library will initialize
  * itself automatically.
@@ -155,6 +237,7 @@ static int tls_close(URLContext *h)
     if (c->ctx)
         SSL_CTX_free(c->ctx);
     ffurl_closep(&c->tls_shared.tcp);
+    av_freep(&c->session_key);
 #if OPENSSL_VERSION_NUMBER >= 0x1010000fL
     if (c->url_bio_method)
         BIO_meth_free(c->url_bio_method);
@@ -296,6 +379,28 @@ static int tls_open(URLContext *h, const char *uri, int flags, AVDictionary **op
     // the requested hostname.
     if (c->verify)
         SSL_CTX_set_verify(p->ctx, SSL_VERIFY_PEER|SSL_VERIFY_FAIL_IF_NO_PEER_CERT, NULL);
+#if OPENSSL_VERSION_NUMBER >= 0x10100000L
+    if (!c->listen) {
+        int port;
+        av_url_split(NULL, 0, NULL, 0, NULL, 0, &port, NULL, 0, uri);
+        /* Resuming a session skips certificate verification, so sessions
+         * must never be shared between connections with different
+         * verification settings; make those part of the key. */
+        p->session_key = av_asprintf("%s:%d:%d:%s:%s", c->underlying_host, port,
+                                     c->verify, c->ca_file ? c->ca_file : "",
+                                     c->cert_file ? c->cert_file : "");
+        if (!p->session_key) {
+            ret = AVERROR(ENOMEM);
+            goto fail;
+        }
+        /* With TLS 1.3 session tickets arrive after the handshake has
+         * completed, so the new session callback is the only way to
+         * capture them. */
+        SSL_CTX_set_session_cache_mode(p->ctx, SSL_SESS_CACHE_CLIENT |
+                                               SSL_SESS_CACHE_NO_INTERNAL_STORE);
+        SSL_CTX_sess_set_new_cb(p->ctx, tls_new_session_cb);
+    }
+#endif
     p->ssl = SSL_new(p->ctx);
     if (!p->ssl) {
         av_log(h, AV_LOG_ERROR, "%s\n", ERR_error_string(ERR_get_error(), NULL));
@@ -319,6 +424,16 @@ static int tls_open(URLContext *h, const char *uri, int flags, AVDictionary **op
     SSL_set_bio(p->ssl, bio, bio);
     if (!c->listen && !c->numerichost)
         SSL_set_tlsext_host_name(p->ssl, c->host);
+#if OPENSSL_VERSION_NUMBER >= 0x10100000L
+    if (p->session_key) {
+        SSL_SESSION *session = tls_session_cache_get(p->session_key);
+        SSL_set_app_data(p->ssl, p);
+        if (session) {
+            SSL_set_session(p->ssl, session);
+            SSL_SESSION_free(session);
+        }
+    }
+#endif
     ret = c->listen ? SSL_accept(p->ssl) : SSL_connect(p->ssl);
     if (ret == 0) {
         av_log(h, AV_LOG_ERROR, "Unable to negotiate TLS/SSL session\n");
@@ -24,6 +24,7 @@
  * UDP protocol
  */
 
+#define _GNU_SOURCE     /* Needed for recvmmsg */
 #define _DEFAULT_SOURCE
 #define _BSD_SOURCE     /* Needed for using struct ip_mreq with recent glibc */
 
@@ -78,6 +79,8 @@
 #define UDP_RX_BUF_SIZE 393216
 #define UDP_MAX_PKT_SIZE 65536
 #define UDP_HEADER_SIZE 8
+/* Number of datagrams read per recvmmsg call */
+#define UDP_RX_BATCH 32
 
 typedef struct UDPQueuedPacketHeader {
     int pkt_size;
@@ -106,6 +109,7 @@ typedef struct UDPContext {
     AVFifo *rx_fifo;
     AVFifo *tx_fifo;
     int circular_buffer_error;
+    int64_t packets_dropped;
     int64_t bitrate; /* number of bits to send per second */
     int64_t burst_bits;
     int close_req;
@@ -148,6 +152,7 @@ static const AVOption options[] = {
     { "connect",        "set if connect() should be called on socket",     OFFSET(is_connected),   AV_OPT_TYPE_BOOL,   { .i64 =  0 },     0, 1,       .flags = D|E },
     { "fifo_size",      "set the UDP circular buffer size (in 188-byte packets)", OFFSET(circular_buffer_size), AV_OPT_TYPE_INT, {.i64 = HAVE_PTHREAD_CANCEL ? 7*4096 : 0}, 0, INT_MAX, D },
     { "overrun_nonfatal", "survive in case of UDP receiving circular buffer overrun", OFFSET(overrun_nonfatal), AV_OPT_TYPE_BOOL, {.i64 = 0}, 0, 1,    D },
+    { "packets_dropped", "export the number of datagrams dropped on circular buffer overrun", OFFSET(packets_dropped), AV_OPT_TYPE_INT64, {.i64 = 0}, 0, INT64_MAX, AV_OPT_FLAG_EXPORT | AV_OPT_FLAG_READONLY },
     { "timeout",        "set raise error timeout, in microseconds (only in read mode)",OFFSET(timeout),         AV_OPT_TYPE_INT,  {.i64 = 0}, 0, INT_MAX, D },
     { "sources",        "Source list",                                     OFFSET(sources),        AV_OPT_TYPE_STRING, { .str = NULL },               .flags = D|E },
     { "block",          "Block list",                                      OFFSET(block),          AV_OPT_TYPE_STRING, { .str = NULL },               .flags = D|E },
@@ -529,6 +534,12 @@ static void *circular_buffer_task_rx( void *_URLContext)
     URLContext *h = _URLContext;
     UDPContext *s = h->priv_data;
     int old_cancelstate;
+#if HAVE_RECVMMSG
+    struct mmsghdr msgs[UDP_RX_BATCH];
+    struct iovec iov[UDP_RX_BATCH];
+    UDPQueuedPacketHeader headers[UDP_RX_BATCH];
+    uint8_t *slab = NULL;
+#endif
 
     ff_thread_setname("udp-rx");
 
@@ -539,6 +550,74 @@ static void *circular_buffer_task_rx( void *_URLContext)
         s->circular_buffer_error = AVERROR(EIO);
         goto end;
     }
+#if HAVE_RECVMMSG
+    /* Read datagrams in batches into a preallocated slab; draining
+     * several packets per syscall keeps up with high-bitrate multicast
+     * even when the thread is scheduled with some jitter. */
+    slab = av_malloc(UDP_RX_BATCH * UDP_MAX_PKT_SIZE);
+    if (!slab) {
+        s->circular_buffer_error = AVERROR(ENOMEM);
+        goto end;
+    }
+    while(1) {
+        int n;
+
+        for (int i = 0; i < UDP_RX_BATCH; i++) {
+            iov[i].iov_base = slab + i * UDP_MAX_PKT_SIZE;
+            iov[i].iov_len  = UDP_MAX_PKT_SIZE;
+            msgs[i].msg_hdr = (struct msghdr){
+                .msg_name    = &headers[i].addr,
+                .msg_namelen = sizeof(headers[i].addr),
+                .msg_iov     = &iov[i],
+                .msg_iovlen  = 1,
+            };
+        }
+
+        pthread_mutex_unlock(&s->mutex);
+        /* Blocking operations are always cancellation points;
+           see "General Information" / "Thread Cancellation Overview"
+           in Single Unix. */
+        pthread_setcancelstate(PTHREAD_CANCEL_ENABLE, &old_cancelstate);
+        n = recvmmsg(s->udp_fd, msgs, UDP_RX_BATCH, MSG_WAITFORONE, NULL);
+        pthread_setcancelstate(PTHREAD_CANCEL_DISABLE, &old_cancelstate);
+        pthread_mutex_lock(&s->mutex);
+        if (n < 0) {
+            if (ff_neterrno() != AVERROR(EAGAIN) && ff_neterrno() != AVERROR(EINTR)) {
+                s->circular_buffer_error = ff_neterrno();
+                goto end;
+            }
+            continue;
+        }
+        for (int i = 0; i < n; i++) {
+            UDPQueuedPacketHeader *pkt_header = &headers[i];
+            pkt_header->pkt_size = msgs[i].msg_len;
+            pkt_header->addr_len = msgs[i].msg_hdr.msg_namelen;
+
+            if (ff_ip_check_source_lists(&pkt_header->addr, &s->filters))
+                continue;
+
+            if (av_fifo_can_write(s->rx_fifo) < pkt_header->pkt_size + sizeof(*pkt_header)) {
+                /* No Space left */
+                s->packets_dropped++;
+                if (s->overrun_nonfatal) {
+                    av_log(h, AV_LOG_WARNING, "Circular buffer overrun. "
+                            "Surviving due to overrun_nonfatal option\n");
+                    continue;
+                } else {
+                    av_log(h, AV_LOG_ERROR, "Circular buffer overrun. "
+                            "To avoid, increase fifo_size URL option. "
+                            "To survive in such case, use overrun_nonfatal option\n");
+                    s->circular_buffer_error = AVERROR(EIO);
+                    goto end;
+                }
+            }
+            av_fifo_write(s->rx_fifo, pkt_header, sizeof(*pkt_header));
+            av_fifo_write(s->rx_fifo, iov[i].iov_base, pkt_header->pkt_size);
+        }
+        if (n > 0)
+            pthread_cond_signal(&s->cond);
+    }
+#else
     while(1) {
         UDPQueuedPacketHeader pkt_header;
         pkt_header.addr_len = sizeof(pkt_header.addr);
@@ -564,6 +643,7 @@ static void *circular_buffer_task_rx( void *_URLContext)
 
         if (av_fifo_can_write(s->rx_fifo) < pkt_header.pkt_size + sizeof(pkt_header)) {
             /* No Space left */
+            s->packets_dropped++;
             if (s->overrun_nonfatal) {
                 av_log(h, AV_LOG_WARNING, "Circular buffer overrun. "
                         "Surviving due to overrun_nonfatal option\n");
@@ -579,10 +659,14 @@ static void *circular_buffer_task_rx( void *_URLContext)
         av_fifo_write(s->rx_fifo, s->tmp, pkt_header.pkt_size + sizeof(pkt_header));
         pthread_cond_signal(&s->cond);
     }
+#endif
 
 end:
     pthread_cond_signal(&s->cond);
     pthread_mutex_unlock(&s->mutex);
+#if HAVE_RECVMMSG
+    av_free(slab);
+#endif
     return NULL;
 }
 
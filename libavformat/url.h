@@ -46,6 +46,9 @@ typedef struct URLContext {
     const char *protocol_whitelist;
     const char *protocol_blacklist;
     int min_packet_size;        /**< if non zero, the stream is packetized with this min packet size */
+    int64_t rw_rate_limit;      /**< if non zero, maximum average read/write rate in bytes per second */
+    int64_t rate_tokens;        /**< token bucket fill for rw_rate_limit, in bytes */
+    int64_t rate_last_time;     /**< time of the last token refill */
 } URLContext;
 
 typedef struct URLProtocol {
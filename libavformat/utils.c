@@ -27,6 +27,7 @@
 #include "libavutil/avassert.h"
 #include "libavutil/avstring.h"
 #include "libavutil/bprint.h"
+#include "libavutil/buffer.h"
 #include "libavutil/dict.h"
 #include "libavutil/internal.h"
 #include "libavutil/mem.h"
@@ -95,8 +96,36 @@ static int append_packet_chunked(AVIOContext *s, AVPacket *pkt, int size)
     return pkt->size > orig_size ? pkt->size - orig_size : ret;
 }
 
+/* Set up pkt with a buffer of size bytes (plus zeroed padding) drawn
+ * from the context's size-class pools, creating the pool on first use.
+ * Returns a negative error code if no buffer could be obtained. */
+static int packet_from_pool(FFIOContext *ctx, AVPacket *pkt, int size)
+{
+    int idx = av_ceil_log2(FFMAX(size + AV_INPUT_BUFFER_PADDING_SIZE,
+                                 1 << FFIO_PKT_POOL_MIN_LOG2)) -
+              FFIO_PKT_POOL_MIN_LOG2;
+
+    if (!ctx->pkt_pools[idx]) {
+        ctx->pkt_pools[idx] =
+            av_buffer_pool_init(1 << (idx + FFIO_PKT_POOL_MIN_LOG2), NULL);
+        if (!ctx->pkt_pools[idx])
+            return AVERROR(ENOMEM);
+    }
+
+    pkt->buf = av_buffer_pool_get(ctx->pkt_pools[idx]);
+    if (!pkt->buf)
+        return AVERROR(ENOMEM);
+
+    pkt->data = pkt->buf->data;
+    pkt->size = size;
+    memset(pkt->data + size, 0, AV_INPUT_BUFFER_PADDING_SIZE);
+    return 0;
+}
+
 int av_get_packet(AVIOContext *s, AVPacket *pkt, int size)
 {
+    FFIOContext *const ctx = ffiocontext(s);
+
 #if FF_API_INIT_PACKET
 FF_DISABLE_DEPRECATION_WARNINGS
     av_init_packet(pkt);
@@ -108,6 +137,45 @@ FF_ENABLE_DEPRECATION_WARNINGS
 #endif
     pkt->pos  = avio_tell(s);
 
+    if (ctx->mapped_buf && ctx->mapped_pkts_enabled && size > 0 &&
+        !s->write_flag && !s->update_checksum) {
+        /* Serve the packet as a refcounted slice of the mapping instead
+         * of copying, for demuxers that declared they can handle
+         * read-only packets whose padding is file data rather than
+         * zeroes. The data following the packet in the mapping acts as
+         * the padding, so stop short of the end of the file. */
+        if (s->buf_end - s->buf_ptr < size && !s->eof_reached)
+            avio_seek(s, pkt->pos, SEEK_SET);
+        if (s->buf_end - s->buf_ptr >= size &&
+            s->buf_ptr - ctx->mapped_buf->data + (int64_t)size +
+            AV_INPUT_BUFFER_PADDING_SIZE <= ctx->mapped_buf->size) {
+            pkt->buf = av_buffer_ref(ctx->mapped_buf);
+            if (pkt->buf) {
+                pkt->data   = s->buf_ptr;
+                pkt->size   = size;
+                s->buf_ptr += size;
+                return size;
+            }
+        }
+    }
+
+    if (ctx->pkt_pools_enabled && size > 0 &&
+        size <= (1 << FFIO_PKT_POOL_MAX_LOG2) - AV_INPUT_BUFFER_PADDING_SIZE &&
+        packet_from_pool(ctx, pkt, size) >= 0) {
+        int ret = avio_read(s, pkt->data, size);
+        if (ret < 0) {
+            av_packet_unref(pkt);
+            return ret;
+        }
+        if (ret < size) {
+            av_shrink_packet(pkt, ret);
+            pkt->flags |= AV_PKT_FLAG_CORRUPT;
+            if (!pkt->size)
+                av_packet_unref(pkt);
+        }
+        return ret;
+    }
+
     return append_packet_chunked(s, pkt, size);
 }
 
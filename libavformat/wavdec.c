@@ -79,11 +79,24 @@ static const AVOption demux_options[] = {
     { NULL },
 };
 
-static void set_max_size(AVStream *st, WAVDemuxContext *wav)
+static void set_max_size(AVFormatContext *s, AVStream *st, WAVDemuxContext *wav)
 {
     if (wav->max_size <= 0) {
         int max_size = ff_pcm_default_packet_size(st->codecpar);
         wav->max_size = max_size < 0 ? 4096 : max_size;
+        /* When the input is memory-mapped, let packets reference the
+         * mapping instead of being copied out of the avio buffer; raw PCM
+         * is never patched in place and no bitstream reader looks at its
+         * padding, so the read-only, unzeroed-padding packets are safe
+         * here. Much larger packets then cost nothing extra and cut
+         * per-packet bookkeeping. */
+        if (ffiocontext(s->pb)->mapped_buf && st->codecpar->block_align > 0 &&
+            av_get_exact_bits_per_sample(st->codecpar->codec_id) > 0) {
+            ffiocontext(s->pb)->mapped_pkts_enabled = 1;
+            wav->max_size = FFMAX(wav->max_size,
+                                  ((1 << 20) / st->codecpar->block_align) *
+                                  st->codecpar->block_align);
+        }
     }
 }
 
@@ -689,7 +702,7 @@ break_loop:
     ff_metadata_conv_ctx(s, NULL, ff_riff_info_conv);
 
     set_spdif(s, wav);
-    set_max_size(st, wav);
+    set_max_size(s, st, wav);
 
     if (st->codecpar->codec_id == AV_CODEC_ID_SONARC)
         avio_skip(pb, 4);
@@ -813,6 +826,12 @@ smv_out:
         return ret;
     pkt->stream_index = 0;
 
+    /* fixed-size PCM: the duration is a precomputed step, do not make the
+     * generic code re-derive it from the codec parameters per packet */
+    if (ret > 0 && st->codecpar->block_align > 0 &&
+        av_get_exact_bits_per_sample(st->codecpar->codec_id) > 0)
+        pkt->duration = ret / st->codecpar->block_align;
+
     return ret;
 }
 
@@ -1019,7 +1038,7 @@ static int w64_read_header(AVFormatContext *s)
     avio_seek(pb, data_ofs, SEEK_SET);
 
     set_spdif(s, wav);
-    set_max_size(st, wav);
+    set_max_size(s, st, wav);
 
     return 0;
 }
@@ -0,0 +1,284 @@
+/*
+ * Output write-behind protocol.
+ *
+ * This file is part of Librempeg
+ *
+ * Librempeg is free software; you can redistribute it and/or modify
+ * it under the terms of the GNU General Public License as published by
+ * the Free Software Foundation; either version 3 of the License, or
+ * (at your option) any later version.
+ *
+ * Librempeg is distributed in the hope that it will be useful,
+ * but WITHOUT ANY WARRANTY; without even the implied warranty of
+ * MERCHANTABILITY or FITNESS FOR A PARTICULAR PURPOSE.  See the
+ * GNU General Public License for more details.
+ *
+ * You should have received a copy of the GNU General Public License along
+ * with Librempeg; if not, write to the Free Software Foundation, Inc.,
+ * 51 Franklin Street, Fifth Floor, Boston, MA 02110-1301 USA.
+ *
+ * Based on libavformat/async.c
+ */
+
+/**
+ * @file
+ * Write-behind wrapper protocol. Muxed bytes are queued into a bounded
+ * dirty buffer and flushed to the inner protocol by a dedicated I/O
+ * thread, so storage stalls up to the buffer size never block the
+ * caller. The output is not seekable; use it with streamable muxers.
+ */
+
+#include "libavutil/avstring.h"
+#include "libavutil/error.h"
+#include "libavutil/fifo.h"
+#include "libavutil/log.h"
+#include "libavutil/opt.h"
+#include "libavutil/thread.h"
+#include "libavutil/time.h"
+#include "url.h"
+#include <stdint.h>
+
+#define BUFFER_CAPACITY         (4 * 1024 * 1024)
+/* maximum amount handed to the inner protocol in one write */
+#define WRITE_CHUNK             (256 * 1024)
+
+typedef struct WritebackContext {
+    AVClass        *class;
+    URLContext     *inner;
+
+    int             io_error;
+    int             abort_request;
+
+    AVFifo         *fifo;
+
+    /* options */
+    int             buffer_capacity;
+
+    /* flush statistics, reported at close */
+    int64_t         flushed_bytes;
+    int64_t         nb_flushes;
+    int64_t         flush_time;
+    int64_t         max_flush_time;
+    size_t          high_water;
+
+    pthread_cond_t  cond_wakeup_main;
+    pthread_cond_t  cond_wakeup_background;
+    pthread_mutex_t mutex;
+    pthread_t       flush_thread;
+} WritebackContext;
+
+static void *writeback_flush_task(void *arg)
+{
+    URLContext       *h = arg;
+    WritebackContext *c = h->priv_data;
+    uint8_t chunk[WRITE_CHUNK];
+
+    ff_thread_setname("writeback");
+
+    pthread_mutex_lock(&c->mutex);
+    while (1) {
+        size_t dirty = av_fifo_can_read(c->fifo);
+        int64_t start, elapsed;
+        int to_copy, ret;
+
+        if (c->io_error || (!dirty && c->abort_request))
+            break;
+
+        if (ff_check_interrupt(&h->interrupt_callback)) {
+            c->io_error = AVERROR_EXIT;
+            break;
+        }
+
+        if (!dirty) {
+            pthread_cond_signal(&c->cond_wakeup_main);
+            pthread_cond_wait(&c->cond_wakeup_background, &c->mutex);
+            continue;
+        }
+
+        to_copy = FFMIN(dirty, WRITE_CHUNK);
+        av_fifo_read(c->fifo, chunk, to_copy);
+        pthread_mutex_unlock(&c->mutex);
+
+        start   = av_gettime_relative();
+        ret     = ffurl_write(c->inner, chunk, to_copy);
+        elapsed = av_gettime_relative() - start;
+
+        pthread_mutex_lock(&c->mutex);
+        c->nb_flushes++;
+        c->flush_time     += elapsed;
+        c->max_flush_time  = FFMAX(c->max_flush_time, elapsed);
+        if (ret < 0)
+            c->io_error = ret;
+        else
+            c->flushed_bytes += to_copy;
+        pthread_cond_signal(&c->cond_wakeup_main);
+    }
+    pthread_cond_signal(&c->cond_wakeup_main);
+    pthread_mutex_unlock(&c->mutex);
+
+    return NULL;
+}
+
+static int writeback_open(URLContext *h, const char *arg, int flags, AVDictionary **options)
+{
+    WritebackContext *c = h->priv_data;
+    int ret;
+
+    av_strstart(arg, "writeback:", &arg);
+
+    if (!(flags & AVIO_FLAG_WRITE) || (flags & AVIO_FLAG_READ)) {
+        av_log(h, AV_LOG_ERROR, "writeback is a write-only protocol\n");
+        return AVERROR(EINVAL);
+    }
+
+    c->fifo = av_fifo_alloc2(c->buffer_capacity, 1, 0);
+    if (!c->fifo)
+        return AVERROR(ENOMEM);
+
+    ret = ffurl_open_whitelist(&c->inner, arg, flags, &h->interrupt_callback,
+                               options, h->protocol_whitelist, h->protocol_blacklist, h);
+    if (ret != 0) {
+        av_log(h, AV_LOG_ERROR, "ffurl_open failed : %s, %s\n", av_err2str(ret), arg);
+        goto url_fail;
+    }
+
+    h->is_streamed = 1;
+
+    ret = pthread_mutex_init(&c->mutex, NULL);
+    if (ret != 0) {
+        ret = AVERROR(ret);
+        av_log(h, AV_LOG_ERROR, "pthread_mutex_init failed : %s\n", av_err2str(ret));
+        goto mutex_fail;
+    }
+
+    ret = pthread_cond_init(&c->cond_wakeup_main, NULL);
+    if (ret != 0) {
+        ret = AVERROR(ret);
+        av_log(h, AV_LOG_ERROR, "pthread_cond_init failed : %s\n", av_err2str(ret));
+        goto cond_wakeup_main_fail;
+    }
+
+    ret = pthread_cond_init(&c->cond_wakeup_background, NULL);
+    if (ret != 0) {
+        ret = AVERROR(ret);
+        av_log(h, AV_LOG_ERROR, "pthread_cond_init failed : %s\n", av_err2str(ret));
+        goto cond_wakeup_background_fail;
+    }
+
+    ret = pthread_create(&c->flush_thread, NULL, writeback_flush_task, h);
+    if (ret) {
+        ret = AVERROR(ret);
+        av_log(h, AV_LOG_ERROR, "pthread_create failed : %s\n", av_err2str(ret));
+        goto thread_fail;
+    }
+
+    return 0;
+
+thread_fail:
+    pthread_cond_destroy(&c->cond_wakeup_background);
+cond_wakeup_background_fail:
+    pthread_cond_destroy(&c->cond_wakeup_main);
+cond_wakeup_main_fail:
+    pthread_mutex_destroy(&c->mutex);
+mutex_fail:
+    ffurl_closep(&c->inner);
+url_fail:
+    av_fifo_freep2(&c->fifo);
+    return ret;
+}
+
+static int writeback_write(URLContext *h, const unsigned char *buf, int size)
+{
+    WritebackContext *c = h->priv_data;
+    int written = 0;
+    int ret = size;
+
+    pthread_mutex_lock(&c->mutex);
+    while (written < size) {
+        size_t space = av_fifo_can_write(c->fifo);
+        int to_copy;
+
+        if (c->io_error) {
+            ret = c->io_error;
+            break;
+        }
+        if (!space) {
+            /* dirty buffer full: the storage is slower than the muxer,
+             * block until the flush thread makes room */
+            pthread_cond_signal(&c->cond_wakeup_background);
+            pthread_cond_wait(&c->cond_wakeup_main, &c->mutex);
+            continue;
+        }
+
+        to_copy = FFMIN((size_t)(size - written), space);
+        av_fifo_write(c->fifo, buf + written, to_copy);
+        written += to_copy;
+        c->high_water = FFMAX(c->high_water, av_fifo_can_read(c->fifo));
+        pthread_cond_signal(&c->cond_wakeup_background);
+    }
+    pthread_mutex_unlock(&c->mutex);
+
+    return ret;
+}
+
+static int writeback_close(URLContext *h)
+{
+    WritebackContext *c = h->priv_data;
+    int ret;
+
+    pthread_mutex_lock(&c->mutex);
+    c->abort_request = 1;
+    pthread_cond_signal(&c->cond_wakeup_background);
+    pthread_mutex_unlock(&c->mutex);
+
+    ret = pthread_join(c->flush_thread, NULL);
+    if (ret != 0)
+        av_log(h, AV_LOG_ERROR, "pthread_join(): %s\n", av_err2str(ret));
+
+    if (c->io_error)
+        av_log(h, AV_LOG_ERROR, "flushing failed : %s\n", av_err2str(c->io_error));
+
+    if (c->nb_flushes)
+        av_log(h, AV_LOG_VERBOSE,
+               "flushed %"PRId64" bytes in %"PRId64" writes, "
+               "mean/max flush latency %.1f/%.1f ms, high water %zu of %d bytes\n",
+               c->flushed_bytes, c->nb_flushes,
+               c->flush_time / (1000.0 * c->nb_flushes),
+               c->max_flush_time / 1000.0,
+               c->high_water, c->buffer_capacity);
+
+    pthread_cond_destroy(&c->cond_wakeup_background);
+    pthread_cond_destroy(&c->cond_wakeup_main);
+    pthread_mutex_destroy(&c->mutex);
+    ret = ffurl_closep(&c->inner);
+    av_fifo_freep2(&c->fifo);
+
+    return c->io_error ? c->io_error : ret;
+}
+
+#define OFFSET(x) offsetof(WritebackContext, x)
+#define E AV_OPT_FLAG_ENCODING_PARAM
+
+static const AVOption options[] = {
+    { "buffer_size", "maximum number of dirty bytes buffered ahead of the storage",
+        OFFSET(buffer_capacity), AV_OPT_TYPE_INT, { .i64 = BUFFER_CAPACITY }, WRITE_CHUNK, INT_MAX / 2, E },
+    {NULL},
+};
+
+#undef E
+#undef OFFSET
+
+static const AVClass writeback_context_class = {
+    .class_name = "Writeback",
+    .option     = options,
+    .version    = LIBAVUTIL_VERSION_INT,
+};
+
+const URLProtocol ff_writeback_protocol = {
+    .name                = "writeback",
+    .url_open2           = writeback_open,
+    .url_write           = writeback_write,
+    .url_close           = writeback_close,
+    .priv_data_size      = sizeof(WritebackContext),
+    .priv_data_class     = &writeback_context_class,
+};
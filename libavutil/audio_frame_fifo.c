@@ -0,0 +1,257 @@
+/*
+ * This file is part of Librempeg
+ *
+ * Librempeg is free software; you can redistribute it and/or modify
+ * it under the terms of the GNU General Public License as published by
+ * the Free Software Foundation; either version 3 of the License, or
+ * (at your option) any later version.
+ *
+ * Librempeg is distributed in the hope that it will be useful,
+ * but WITHOUT ANY WARRANTY; without even the implied warranty of
+ * MERCHANTABILITY or FITNESS FOR A PARTICULAR PURPOSE.  See the
+ * GNU General Public License for more details.
+ *
+ * You should have received a copy of the GNU General Public License along
+ * with Librempeg; if not, write to the Free Software Foundation, Inc.,
+ * 51 Franklin Street, Fifth Floor, Boston, MA 02110-1301 USA.
+ */
+
+/**
+ * @file
+ * Audio FIFO operating on frame references
+ */
+
+#include <limits.h>
+#include <string.h>
+
+#include "audio_frame_fifo.h"
+#include "channel_layout.h"
+#include "error.h"
+#include "fifo.h"
+#include "frame.h"
+#include "macros.h"
+#include "mathematics.h"
+#include "mem.h"
+#include "samplefmt.h"
+
+struct AVAudioFrameFifo {
+    AVFifo *frames;                 /**< FIFO of AVFrame* references */
+    int head_offset;                /**< samples already consumed from the head frame */
+    int nb_samples;                 /**< number of unread samples in the FIFO */
+
+    /* parameters locked in by the first frame written */
+    AVChannelLayout ch_layout;
+    enum AVSampleFormat sample_fmt;
+    int sample_rate;
+};
+
+AVAudioFrameFifo *av_audio_frame_fifo_alloc(void)
+{
+    AVAudioFrameFifo *aff = av_mallocz(sizeof(*aff));
+
+    if (!aff)
+        return NULL;
+
+    aff->frames = av_fifo_alloc2(8, sizeof(AVFrame*), AV_FIFO_FLAG_AUTO_GROW);
+    if (!aff->frames) {
+        av_free(aff);
+        return NULL;
+    }
+    aff->sample_fmt = AV_SAMPLE_FMT_NONE;
+
+    return aff;
+}
+
+void av_audio_frame_fifo_free(AVAudioFrameFifo **aff)
+{
+    if (!*aff)
+        return;
+
+    av_audio_frame_fifo_reset(*aff);
+    av_fifo_freep2(&(*aff)->frames);
+    av_freep(aff);
+}
+
+int av_audio_frame_fifo_write(AVAudioFrameFifo *aff, const AVFrame *frame)
+{
+    AVFrame *new;
+    int ret;
+
+    if (frame->format < 0 || frame->ch_layout.nb_channels <= 0 ||
+        frame->nb_samples < 0 || !frame->buf[0])
+        return AVERROR(EINVAL);
+
+    if (aff->ch_layout.nb_channels) {
+        if (frame->format      != aff->sample_fmt  ||
+            frame->sample_rate != aff->sample_rate ||
+            av_channel_layout_compare(&frame->ch_layout, &aff->ch_layout))
+            return AVERROR(EINVAL);
+    } else {
+        if ((ret = av_channel_layout_copy(&aff->ch_layout, &frame->ch_layout)) < 0)
+            return ret;
+        aff->sample_fmt  = frame->format;
+        aff->sample_rate = frame->sample_rate;
+    }
+
+    if (frame->nb_samples > INT_MAX - aff->nb_samples)
+        return AVERROR(EINVAL);
+    if (!frame->nb_samples)
+        return 0;
+
+    new = av_frame_clone(frame);
+    if (!new)
+        return AVERROR(ENOMEM);
+
+    if ((ret = av_fifo_write(aff->frames, &new, 1)) < 0) {
+        av_frame_free(&new);
+        return ret;
+    }
+    aff->nb_samples += frame->nb_samples;
+
+    return 0;
+}
+
+/**
+ * Discard nb_samples from the front of the FIFO, releasing head frames as
+ * they are fully consumed. nb_samples must not exceed aff->nb_samples.
+ */
+static void advance_head(AVAudioFrameFifo *aff, int nb_samples)
+{
+    aff->nb_samples -= nb_samples;
+
+    while (nb_samples > 0) {
+        AVFrame *head;
+        int count;
+
+        av_fifo_peek(aff->frames, &head, 1, 0);
+        count = FFMIN(nb_samples, head->nb_samples - aff->head_offset);
+
+        aff->head_offset += count;
+        nb_samples       -= count;
+        if (aff->head_offset == head->nb_samples) {
+            av_fifo_drain2(aff->frames, 1);
+            av_frame_free(&head);
+            aff->head_offset = 0;
+        }
+    }
+}
+
+/**
+ * Shift the pts of a frame taken off the FIFO by the number of samples
+ * consumed from the source frame before it, and make the duration cover
+ * exactly the samples being returned. Only possible when the source frame
+ * carried a valid time base.
+ */
+static void offset_frame_props(AVAudioFrameFifo *aff, AVFrame *frame,
+                               int offset, int nb_samples)
+{
+    const AVRational sample_tb = { 1, aff->sample_rate };
+
+    if (frame->time_base.num <= 0 || frame->time_base.den <= 0 ||
+        aff->sample_rate <= 0)
+        return;
+
+    if (frame->pts != AV_NOPTS_VALUE)
+        frame->pts += av_rescale_q(offset, sample_tb, frame->time_base);
+    frame->duration = av_rescale_q(nb_samples, sample_tb, frame->time_base);
+}
+
+int av_audio_frame_fifo_read(AVAudioFrameFifo *aff, AVFrame *frame,
+                             int nb_samples)
+{
+    const int planar   = av_sample_fmt_is_planar(aff->sample_fmt);
+    const int channels = aff->ch_layout.nb_channels;
+    AVFrame *head;
+    int ret;
+
+    if (nb_samples < 0)
+        return AVERROR(EINVAL);
+    nb_samples = FFMIN(nb_samples, aff->nb_samples);
+    if (!nb_samples)
+        return 0;
+
+    av_fifo_peek(aff->frames, &head, 1, 0);
+
+    if (nb_samples <= head->nb_samples - aff->head_offset) {
+        /* all samples come from the head frame; hand out a reference to
+         * its buffers with the data pointers advanced past the samples
+         * already consumed */
+        const int      nb_planes = planar ? channels : 1;
+        const ptrdiff_t   offset = (ptrdiff_t)aff->head_offset *
+                                   av_get_bytes_per_sample(aff->sample_fmt) *
+                                   (planar ? 1 : channels);
+
+        if ((ret = av_frame_ref(frame, head)) < 0)
+            return ret;
+
+        for (int i = 0; i < nb_planes; i++)
+            frame->extended_data[i] += offset;
+        if (frame->extended_data != frame->data)
+            memcpy(frame->data, frame->extended_data,
+                   FFMIN(nb_planes, AV_NUM_DATA_POINTERS) * sizeof(*frame->data));
+        frame->linesize[0] -= offset;
+        frame->nb_samples   = nb_samples;
+
+        offset_frame_props(aff, frame, aff->head_offset, nb_samples);
+    } else {
+        /* the request spans several queued frames, gather the samples
+         * into a new buffer */
+        int dst_offset = 0;
+
+        frame->format      = aff->sample_fmt;
+        frame->sample_rate = aff->sample_rate;
+        frame->nb_samples  = nb_samples;
+        if ((ret = av_channel_layout_copy(&frame->ch_layout, &aff->ch_layout)) < 0)
+            return ret;
+        if ((ret = av_frame_get_buffer(frame, 0)) < 0)
+            goto fail;
+        if ((ret = av_frame_copy_props(frame, head)) < 0)
+            goto fail;
+        offset_frame_props(aff, frame, aff->head_offset, nb_samples);
+
+        for (size_t i = 0; dst_offset < nb_samples; i++) {
+            AVFrame *src;
+            int src_offset = i ? 0 : aff->head_offset;
+            int count;
+
+            av_fifo_peek(aff->frames, &src, 1, i);
+            count = FFMIN(nb_samples - dst_offset, src->nb_samples - src_offset);
+            av_samples_copy(frame->extended_data, src->extended_data,
+                            dst_offset, src_offset, count, channels,
+                            aff->sample_fmt);
+            dst_offset += count;
+        }
+    }
+
+    advance_head(aff, nb_samples);
+
+    return nb_samples;
+
+fail:
+    av_frame_unref(frame);
+    return ret;
+}
+
+int av_audio_frame_fifo_drain(AVAudioFrameFifo *aff, int nb_samples)
+{
+    if (nb_samples < 0)
+        return AVERROR(EINVAL);
+
+    advance_head(aff, FFMIN(nb_samples, aff->nb_samples));
+
+    return 0;
+}
+
+void av_audio_frame_fifo_reset(AVAudioFrameFifo *aff)
+{
+    advance_head(aff, aff->nb_samples);
+
+    av_channel_layout_uninit(&aff->ch_layout);
+    aff->sample_fmt  = AV_SAMPLE_FMT_NONE;
+    aff->sample_rate = 0;
+}
+
+int av_audio_frame_fifo_size(const AVAudioFrameFifo *aff)
+{
+    return aff->nb_samples;
+}
@@ -0,0 +1,144 @@
+/*
+ * This file is part of Librempeg
+ *
+ * Librempeg is free software; you can redistribute it and/or modify
+ * it under the terms of the GNU General Public License as published by
+ * the Free Software Foundation; either version 3 of the License, or
+ * (at your option) any later version.
+ *
+ * Librempeg is distributed in the hope that it will be useful,
+ * but WITHOUT ANY WARRANTY; without even the implied warranty of
+ * MERCHANTABILITY or FITNESS FOR A PARTICULAR PURPOSE.  See the
+ * GNU General Public License for more details.
+ *
+ * You should have received a copy of the GNU General Public License along
+ * with Librempeg; if not, write to the Free Software Foundation, Inc.,
+ * 51 Franklin Street, Fifth Floor, Boston, MA 02110-1301 USA.
+ */
+
+#ifndef AVUTIL_AUDIO_FRAME_FIFO_H
+#define AVUTIL_AUDIO_FRAME_FIFO_H
+
+/**
+ * @file
+ * @ingroup lavu_audioframefifo
+ * Audio FIFO buffer operating on frame references.
+ */
+
+#include "frame.h"
+
+/**
+ * @addtogroup lavu_audio
+ * @{
+ *
+ * @defgroup lavu_audioframefifo Audio Frame FIFO Buffer
+ * @{
+ * An audio FIFO that stores references to the queued frames instead of
+ * copying their samples. Unlike AVAudioFifo, writing is always zero-copy,
+ * and reading only copies samples when a read request spans more than one
+ * queued frame; a request satisfied by a single frame returns a new
+ * reference to that frame's buffers. It is meant for repacketizing audio
+ * into fixed frame sizes (e.g. feeding an encoder with a fixed
+ * frame_size from arbitrarily sized decoder output) without paying for
+ * two sample copies per frame.
+ *
+ * All queued frames must share the same sample format, channel layout and
+ * sample rate; these are locked in by the first frame written after
+ * allocation or reset.
+ */
+
+/**
+ * Context for an audio frame FIFO buffer. This struct is opaque and not
+ * meant to be accessed directly.
+ */
+typedef struct AVAudioFrameFifo AVAudioFrameFifo;
+
+/**
+ * Allocate an AVAudioFrameFifo.
+ *
+ * @return newly allocated AVAudioFrameFifo, or NULL on error
+ */
+AVAudioFrameFifo *av_audio_frame_fifo_alloc(void);
+
+/**
+ * Free an AVAudioFrameFifo and all frame references it holds.
+ *
+ * @param aff  pointer to the AVAudioFrameFifo to free, will be set to NULL
+ */
+void av_audio_frame_fifo_free(AVAudioFrameFifo **aff);
+
+/**
+ * Add a new reference to a frame to an AVAudioFrameFifo.
+ *
+ * The frame data is not copied and the input frame remains owned by the
+ * caller. The frame must be refcounted and have the same sample format,
+ * channel layout and sample rate as the frames already in the FIFO.
+ *
+ * @param aff    AVAudioFrameFifo to write to
+ * @param frame  frame containing the samples to queue
+ * @return       0 on success, a negative AVERROR code on failure
+ */
+int av_audio_frame_fifo_write(AVAudioFrameFifo *aff, const AVFrame *frame);
+
+/**
+ * Read samples from an AVAudioFrameFifo.
+ *
+ * When all requested samples are contained in a single queued frame, no
+ * samples are copied: frame receives a new reference to that frame's
+ * buffers, with the data pointers offset to the first unread sample.
+ * Otherwise a new buffer is allocated for frame and the samples are
+ * gathered into it from the queued frames.
+ *
+ * The frame properties are copied from the first queued frame the samples
+ * are taken from. If that frame has a valid time_base, pts and duration
+ * are adjusted to cover exactly the returned samples.
+ *
+ * @param aff         AVAudioFrameFifo to read from
+ * @param frame       an empty frame to receive the samples; on failure it
+ *                    is left untouched
+ * @param nb_samples  number of samples to read
+ * @return            number of samples actually read, or negative AVERROR
+ *                    code on failure. The number of samples actually read
+ *                    will not be greater than nb_samples, and will only be
+ *                    less than nb_samples if av_audio_frame_fifo_size() is
+ *                    less than nb_samples.
+ */
+int av_audio_frame_fifo_read(AVAudioFrameFifo *aff, AVFrame *frame,
+                             int nb_samples);
+
+/**
+ * Remove samples from an AVAudioFrameFifo without reading them.
+ *
+ * Frame references are released as soon as their last sample is drained.
+ *
+ * @param aff         AVAudioFrameFifo to drain
+ * @param nb_samples  number of samples to drain
+ * @return            0 if OK, or negative AVERROR code on failure
+ */
+int av_audio_frame_fifo_drain(AVAudioFrameFifo *aff, int nb_samples);
+
+/**
+ * Empty an AVAudioFrameFifo, releasing all frame references it holds.
+ *
+ * This also unlocks the sample format, channel layout and sample rate, so
+ * frames with different parameters may be written afterwards.
+ *
+ * @param aff  AVAudioFrameFifo to reset
+ */
+void av_audio_frame_fifo_reset(AVAudioFrameFifo *aff);
+
+/**
+ * Get the current number of queued samples in the AVAudioFrameFifo
+ * available for reading.
+ *
+ * @param aff  the AVAudioFrameFifo to query
+ * @return     number of samples available for reading
+ */
+int av_audio_frame_fifo_size(const AVAudioFrameFifo *aff);
+
+/**
+ * @}
+ * @}
+ */
+
+#endif /* AVUTIL_AUDIO_FRAME_FIFO_H */
@@ -395,18 +395,29 @@ AVBufferRef *av_buffer_pool_get(AVBufferPool *pool)
     ff_mutex_lock(&pool->mutex);
     buf = pool->pool;
     if (buf) {
+        /* once unlinked the entry is owned by us, so creating the new
+         * reference does not need to keep other threads out of the pool */
+        pool->pool = buf->next;
+        ff_mutex_unlock(&pool->mutex);
+
+        buf->next = NULL;
         memset(&buf->buffer, 0, sizeof(buf->buffer));
         ret = buffer_create(&buf->buffer, buf->data, pool->size,
                             pool_release_buffer, buf, 0);
         if (ret) {
-            pool->pool = buf->next;
-            buf->next = NULL;
             buf->buffer.flags_internal |= BUFFER_FLAG_NO_FREE;
+        } else {
+            ff_mutex_lock(&pool->mutex);
+            buf->next  = pool->pool;
+            pool->pool = buf;
+            ff_mutex_unlock(&pool->mutex);
         }
     } else {
+        /* the alloc callbacks have never been invoked concurrently and
+         * callers may depend on that, so keep allocation under the lock */
         ret = pool_alloc_buffer(pool);
+        ff_mutex_unlock(&pool->mutex);
     }
-    ff_mutex_unlock(&pool->mutex);
 
     if (ret)
         atomic_fetch_add_explicit(&pool->refcount, 1, memory_order_relaxed);
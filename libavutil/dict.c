@@ -19,6 +19,7 @@
  */
 
 #include <inttypes.h>
+#include <stdatomic.h>
 #include <stdio.h>
 #include <string.h>
 
@@ -30,10 +31,125 @@
 #include "bprint.h"
 
 struct AVDictionary {
+    /* number of owners; storage is shared between the source and
+     * destination of av_dict_copy() until one of them is modified */
+    atomic_int refcount;
     int count;
     AVDictionaryEntry *elems;
+    /* lazily built open-addressing hash index over elems for exact-key
+     * lookups; slots hold indices into elems, -1 marks an empty slot.
+     * Cleared on every modification, rebuilt on the next lookup. */
+    _Atomic(int *) index;
 };
 
+/* Linear scans are faster than hashing for the tag-sized dictionaries
+ * that dominate; only index dictionaries at least this large. */
+#define DICT_INDEX_MIN_COUNT 8
+
+static AVDictionary *dict_alloc(void)
+{
+    AVDictionary *m = av_mallocz(sizeof(*m));
+
+    if (m) {
+        atomic_init(&m->refcount, 1);
+        atomic_init(&m->index, NULL);
+    }
+    return m;
+}
+
+static void dict_index_clear(AVDictionary *m)
+{
+    av_free(atomic_exchange_explicit(&m->index, NULL, memory_order_relaxed));
+}
+
+static int dict_index_size(int count)
+{
+    int size = 16;
+
+    while (size < 2 * count)
+        size <<= 1;
+    return size;
+}
+
+/* Case-insensitive, so that keys differing only in case collide and a
+ * probe sequence visits every candidate for both matching modes. */
+static unsigned dict_key_hash(const char *key)
+{
+    unsigned h = 5381;
+
+    while (*key)
+        h = h * 33 + av_toupper(*key++);
+    return h;
+}
+
+static const int *dict_index_get(AVDictionary *m)
+{
+    int size = dict_index_size(m->count);
+    int *expected = NULL;
+    int *index = atomic_load_explicit(&m->index, memory_order_acquire);
+
+    if (index)
+        return index;
+
+    index = av_malloc_array(size, sizeof(*index));
+    if (!index)
+        return NULL;
+    memset(index, -1, size * sizeof(*index));
+    /* Inserting in iteration order makes the first matching entry along
+     * any probe sequence the first matching entry in iteration order,
+     * preserving av_dict_get() semantics for duplicate keys. */
+    for (int i = 0; i < m->count; i++) {
+        unsigned slot = dict_key_hash(m->elems[i].key) & (size - 1);
+
+        while (index[slot] >= 0)
+            slot = (slot + 1) & (size - 1);
+        index[slot] = i;
+    }
+
+    if (!atomic_compare_exchange_strong_explicit(&m->index, &expected, index,
+                                                 memory_order_acq_rel,
+                                                 memory_order_acquire)) {
+        // another reader built the index concurrently, use theirs
+        av_free(index);
+        index = expected;
+    }
+    return index;
+}
+
+/**
+ * Ensure the dictionary does not share storage with another owner,
+ * cloning the entries if it does.
+ */
+static int dict_make_writable(AVDictionary **pm)
+{
+    AVDictionary *m = *pm, *copy;
+
+    if (!m || atomic_load_explicit(&m->refcount, memory_order_relaxed) == 1)
+        return 0;
+
+    copy = dict_alloc();
+    if (!copy)
+        return AVERROR(ENOMEM);
+    copy->elems = av_calloc(m->count, sizeof(*copy->elems));
+    if (!copy->elems) {
+        av_free(copy);
+        return AVERROR(ENOMEM);
+    }
+    for (int i = 0; i < m->count; i++) {
+        copy->elems[i].key   = av_strdup(m->elems[i].key);
+        copy->elems[i].value = av_strdup(m->elems[i].value);
+        copy->count++;
+        if (!copy->elems[i].key || !copy->elems[i].value) {
+            av_dict_free(&copy);
+            return AVERROR(ENOMEM);
+        }
+    }
+    *pm = copy;
+    av_dict_free(&m);
+
+    return 0;
+}
+
 int av_dict_count(const AVDictionary *m)
 {
     return m ? m->count : 0;
@@ -66,6 +182,26 @@ AVDictionaryEntry *av_dict_get(const AVDictionary *m, const char *key,
     if (!key)
         return NULL;
 
+    if (!prev && m && m->count >= DICT_INDEX_MIN_COUNT &&
+        !(flags & AV_DICT_IGNORE_SUFFIX)) {
+        /* The index is a cache over the entries, (re)built on demand. */
+        const int *index = dict_index_get((AVDictionary *)m);
+
+        if (index) {
+            int size = dict_index_size(m->count);
+            unsigned slot = dict_key_hash(key) & (size - 1);
+
+            for (int i; (i = index[slot]) >= 0; slot = (slot + 1) & (size - 1)) {
+                const char *s = m->elems[i].key;
+                int match = flags & AV_DICT_MATCH_CASE ? !strcmp(s, key)
+                                                       : !av_strcasecmp(s, key);
+                if (match)
+                    return &m->elems[i];
+            }
+            return NULL;
+        }
+    }
+
     while ((entry = av_dict_iterate(m, entry))) {
         const char *s = entry->key;
         if (flags & AV_DICT_MATCH_CASE)
@@ -106,6 +242,11 @@ int av_dict_set(AVDictionary **pm, const char *key, const char *value,
     if (!copy_key || (value && !copy_value))
         goto enomem;
 
+    err = dict_make_writable(pm);
+    if (err < 0)
+        goto err_out;
+    m = *pm;
+
     if (!(flags & AV_DICT_MULTIKEY)) {
         tag = av_dict_get(m, key, NULL, flags);
     } else if (flags & AV_DICT_DEDUP) {
@@ -119,9 +260,10 @@ int av_dict_set(AVDictionary **pm, const char *key, const char *value,
         }
     }
     if (!m)
-        m = *pm = av_mallocz(sizeof(*m));
+        m = *pm = dict_alloc();
     if (!m)
         goto enomem;
+    dict_index_clear(m);
 
     if (tag) {
         if (flags & AV_DICT_DONT_OVERWRITE) {
@@ -234,20 +376,48 @@ void av_dict_free(AVDictionary **pm)
 {
     AVDictionary *m = *pm;
 
-    if (m) {
+    if (m && atomic_fetch_sub_explicit(&m->refcount, 1, memory_order_acq_rel) == 1) {
         while (m->count--) {
             av_freep(&m->elems[m->count].key);
             av_freep(&m->elems[m->count].value);
         }
         av_freep(&m->elems);
+        dict_index_clear(m);
+        av_free(m);
     }
-    av_freep(pm);
+    *pm = NULL;
+}
+
+/**
+ * Check whether inserting any entry of m into a dictionary holding the
+ * preceding entries would overwrite one of them, using the same lookup
+ * rules av_dict_set() would apply with the given flags.
+ */
+static int dict_has_duplicate_keys(const AVDictionary *m, int flags)
+{
+    for (int i = 1; i < m->count; i++)
+        if (av_dict_get(m, m->elems[i].key, NULL, flags) != &m->elems[i])
+            return 1;
+    return 0;
 }
 
 int av_dict_copy(AVDictionary **dst, const AVDictionary *src, int flags)
 {
     const AVDictionaryEntry *t = NULL;
 
+    /* An empty destination can share the source storage outright; the
+     * entries are cloned only if either dictionary is modified later.
+     * This is equivalent to the entry-wise copy below only as long as
+     * no source entry would overwrite a previously copied one. */
+    if (!*dst && src &&
+        ((flags & AV_DICT_MULTIKEY) || !dict_has_duplicate_keys(src, flags))) {
+        AVDictionary *m = (AVDictionary *)src;
+
+        atomic_fetch_add_explicit(&m->refcount, 1, memory_order_relaxed);
+        *dst = m;
+        return 0;
+    }
+
     while ((t = av_dict_iterate(src, t))) {
         int ret = av_dict_set(dst, t->key, t->value, flags);
         if (ret < 0)
@@ -706,6 +706,93 @@ static int verify_expr(AVExpr *e)
     }
 }
 
+/**
+ * Check whether the subtree depends on nothing but literal values and is
+ * free of side effects, so that it can be evaluated at parse time.
+ */
+static int expr_is_foldable(const AVExpr *e)
+{
+    switch (e->type) {
+    case e_value:
+        return 1;
+    case e_func0:
+        /* all built-in func0s are pure functions of their argument,
+         * except time() */
+        if (e->a.func0 == etime)
+            return 0;
+        break;
+    case e_squish:
+    case e_gauss:
+    case e_isnan:
+    case e_isinf:
+    case e_mod:
+    case e_max:
+    case e_min:
+    case e_eq:
+    case e_gt:
+    case e_gte:
+    case e_lte:
+    case e_lt:
+    case e_pow:
+    case e_mul:
+    case e_div:
+    case e_add:
+    case e_last:
+    case e_floor:
+    case e_ceil:
+    case e_trunc:
+    case e_round:
+    case e_sqrt:
+    case e_not:
+    case e_hypot:
+    case e_gcd:
+    case e_if:
+    case e_ifnot:
+    case e_bitand:
+    case e_bitor:
+    case e_between:
+    case e_clip:
+    case e_atan2:
+    case e_lerp:
+    case e_sgn:
+        break;
+    default:
+        /* constants, variable loads/stores, user callbacks, print,
+         * random and the iterating constructs */
+        return 0;
+    }
+
+    for (int i = 0; i < 3; i++)
+        if (e->param[i] && !expr_is_foldable(e->param[i]))
+            return 0;
+    return 1;
+}
+
+/**
+ * Fold subtrees without runtime dependencies into single values, so that
+ * constant subexpressions are not re-evaluated on every av_expr_eval().
+ */
+static void fold_expr(AVExpr *e)
+{
+    if (!e || e->type == e_value)
+        return;
+
+    if (expr_is_foldable(e)) {
+        Parser p = { .class = &eval_class };
+
+        e->value = eval_expr(&p, e);
+        e->type  = e_value;
+        for (int i = 0; i < 3; i++) {
+            av_expr_free(e->param[i]);
+            e->param[i] = NULL;
+        }
+        return;
+    }
+
+    for (int i = 0; i < 3; i++)
+        fold_expr(e->param[i]);
+}
+
 int av_expr_parse(AVExpr **expr, const char *s,
                   const char * const *const_names,
                   const char * const *func1_names, double (* const *funcs1)(void *, double),
@@ -748,6 +835,7 @@ int av_expr_parse(AVExpr **expr, const char *s,
         ret = AVERROR(EINVAL);
         goto end;
     }
+    fold_expr(e);
     e->var= av_mallocz(sizeof(double) *VARS);
     e->prng_state = av_mallocz(sizeof(*e->prng_state) *VARS);
     if (!e->var || !e->prng_state) {
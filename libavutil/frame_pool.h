@@ -0,0 +1,126 @@
+/*
+ * This file is part of Librempeg
+ *
+ * Librempeg is free software; you can redistribute it and/or modify
+ * it under the terms of the GNU General Public License as published by
+ * the Free Software Foundation; either version 3 of the License, or
+ * (at your option) any later version.
+ *
+ * Librempeg is distributed in the hope that it will be useful,
+ * but WITHOUT ANY WARRANTY; without even the implied warranty of
+ * MERCHANTABILITY or FITNESS FOR A PARTICULAR PURPOSE.  See the
+ * GNU General Public License for more details.
+ *
+ * You should have received a copy of the GNU General Public License along
+ * with Librempeg; if not, write to the Free Software Foundation, Inc.,
+ * 51 Franklin Street, Fifth Floor, Boston, MA 02110-1301 USA.
+ */
+
+#ifndef AVUTIL_FRAME_POOL_H
+#define AVUTIL_FRAME_POOL_H
+
+/**
+ * @file
+ * @ingroup lavu_frame_pool
+ * Pools of frame buffers with a fixed, caller-configured layout.
+ */
+
+#include <stddef.h>
+
+#include "buffer.h"
+#include "frame.h"
+#include "pixfmt.h"
+#include "samplefmt.h"
+
+/**
+ * @defgroup lavu_frame_pool AVFramePool
+ * @ingroup lavu_data
+ *
+ * @{
+ * A pool handing out frame buffers with a stable plane layout: every frame
+ * obtained from the pool has identical linesizes, plane sizes and data
+ * alignment, and buffers are recycled rather than reallocated. The caller
+ * supplies the allocator, so the underlying memory can come from anywhere:
+ * page-locked (pinned) memory registered with a GPU API, a shared-memory
+ * segment, or plain av_buffer_alloc().
+ *
+ * The main use case is an AVCodecContext.get_buffer2() callback that places
+ * decoded frames directly into memory a downstream consumer can use without
+ * a copy. Such a callback should create the pool on the first call (or when
+ * the frame parameters change), using an alignment at least as large as the
+ * one the decoder requires, and simply call av_frame_pool_get() afterwards.
+ * The returned buffers are refcounted, satisfying the requirements of
+ * AV_CODEC_CAP_DR1 decoders.
+ *
+ * All functions in this API are thread-safe with respect to a given pool,
+ * so frames may be requested from several decoder threads at once.
+ */
+
+/**
+ * Frame buffer pool. This structure is opaque and not meant to be accessed
+ * directly.
+ */
+typedef struct AVFramePool AVFramePool;
+
+/**
+ * Allocate and initialize a video frame buffer pool.
+ *
+ * @param alloc  function used to allocate new buffers when the pool is
+ *               empty; may be NULL, then av_buffer_alloc() is used.
+ *               Each returned buffer is used for a single plane, and the
+ *               plane data is aligned within it, so the allocator itself
+ *               does not need to return aligned memory.
+ * @param width  width of each frame in this pool
+ * @param height height of each frame in this pool
+ * @param format pixel format of each frame in this pool
+ * @param align  alignment of the plane buffers and linesizes, must be a
+ *               power of two
+ * @return newly created frame pool on success, NULL on error
+ */
+AVFramePool *av_frame_pool_video_alloc(AVBufferRef *(*alloc)(size_t size),
+                                       int width, int height,
+                                       enum AVPixelFormat format, int align);
+
+/**
+ * Allocate and initialize an audio frame buffer pool.
+ *
+ * @param alloc      function used to allocate new buffers when the pool is
+ *                   empty; may be NULL, then av_buffer_alloc() is used
+ * @param nb_channels number of channels of each frame in this pool
+ * @param nb_samples number of samples of each frame in this pool
+ * @param format     sample format of each frame in this pool
+ * @param align      alignment of the plane buffers, must be a power of two
+ * @return newly created frame pool on success, NULL on error
+ */
+AVFramePool *av_frame_pool_audio_alloc(AVBufferRef *(*alloc)(size_t size),
+                                       int nb_channels, int nb_samples,
+                                       enum AVSampleFormat format, int align);
+
+/**
+ * Fill a frame with buffers from the pool.
+ *
+ * The frame parameters (dimensions or channel count and sample count,
+ * format, linesizes) are set from the pool configuration; the frame must
+ * not have any buffers attached. On failure the frame is left untouched.
+ *
+ * For audio frames the channel layout is set to the default layout for the
+ * pool's channel count; the caller may overwrite it afterwards.
+ *
+ * @return 0 on success, a negative AVERROR code on failure
+ */
+int av_frame_pool_get(AVFramePool *pool, AVFrame *frame);
+
+/**
+ * Free the frame pool. It is safe to call this function while some of the
+ * allocated buffers are still in use; they are returned to the allocator
+ * when their last reference is released.
+ *
+ * @param pool pointer to the pool to be freed, will be set to NULL
+ */
+void av_frame_pool_free(AVFramePool **pool);
+
+/**
+ * @}
+ */
+
+#endif /* AVUTIL_FRAME_POOL_H */
@@ -394,6 +394,12 @@ int av_hwframe_get_buffer(AVBufferRef *hwframe_ctx, AVFrame *frame, int flags);
  * smaller than the allocated dimensions, the content of the padding in the
  * destination frame is unspecified.
  *
+ * The copy is synchronous: when this function returns successfully, the data
+ * has fully landed in dst and both frames may be used immediately. Callers
+ * that want to overlap transfers with other work should issue them from a
+ * separate thread; device-internal ordering (e.g. against pending decode
+ * output) is handled by the backends themselves.
+ *
  * @param dst the destination frame. dst is not touched on failure.
  * @param src the source frame.
  * @param flags currently unused, should be set to zero
@@ -102,6 +102,11 @@ typedef struct VAAPIFramesContext {
     // Caches whether VA_SURFACE_ATTRIB_MEM_TYPE_DRM_PRIME_2 is unsupported for
     // surface imports.
     int prime_2_import_unsupported;
+
+    // Number of surfaces actually created and number of frame requests
+    // served by the pool, for recycling statistics.
+    uint64_t nb_surface_allocs;
+    uint64_t nb_frame_requests;
 } VAAPIFramesContext;
 
 typedef struct VAAPIMapping {
@@ -552,6 +557,7 @@ static AVBufferRef *vaapi_pool_alloc(void *opaque, size_t size)
         return NULL;
     }
     av_log(hwfc, AV_LOG_DEBUG, "Created surface %#x.\n", surface_id);
+    ctx->nb_surface_allocs++;
 
     ref = av_buffer_create((uint8_t*)(uintptr_t)surface_id,
                            sizeof(surface_id), &vaapi_buffer_free,
@@ -730,16 +736,25 @@ static void vaapi_frames_uninit(AVHWFramesContext *hwfc)
     VAAPIFramesContext    *ctx = hwfc->hwctx;
     AVVAAPIFramesContext *avfc = &ctx->p;
 
+    if (ctx->nb_frame_requests)
+        av_log(hwfc, AV_LOG_VERBOSE, "Surface pool served %"PRIu64" frame "
+               "requests with %"PRIu64" surfaces (%"PRIu64" recycled).\n",
+               ctx->nb_frame_requests, ctx->nb_surface_allocs,
+               ctx->nb_frame_requests - ctx->nb_surface_allocs);
+
     av_freep(&avfc->surface_ids);
     av_freep(&ctx->attributes);
 }
 
 static int vaapi_get_buffer(AVHWFramesContext *hwfc, AVFrame *frame)
 {
+    VAAPIFramesContext *ctx = hwfc->hwctx;
+
     frame->buf[0] = av_buffer_pool_get(hwfc->pool);
     if (!frame->buf[0])
         return AVERROR(ENOMEM);
 
+    ctx->nb_frame_requests++;
     frame->data[3] = frame->buf[0]->data;
     frame->format  = AV_PIX_FMT_VAAPI;
     frame->width   = hwfc->width;
@@ -25,6 +25,7 @@
  */
 
 #define _XOPEN_SOURCE 600
+#define _DEFAULT_SOURCE // for MADV_HUGEPAGE
 
 #include "config.h"
 
@@ -36,6 +37,9 @@
 #if HAVE_MALLOC_H
 #include <malloc.h>
 #endif
+#if HAVE_MADVISE
+#include <sys/mman.h>
+#endif
 
 #include "attributes.h"
 #include "avassert.h"
@@ -64,6 +68,8 @@ void  free(void *ptr);
 
 #define ALIGN (HAVE_SIMD_ALIGN_64 ? 64 : (HAVE_SIMD_ALIGN_32 ? 32 : 16))
 
+#define HUGE_PAGE_SIZE (2 * 1024 * 1024)
+
 #define FF_MEMORY_POISON 0x2a
 
 /* NOTE: if you want to override these functions with your own
@@ -72,11 +78,17 @@ void  free(void *ptr);
  * Note that this will cost performance. */
 
 static atomic_size_t max_alloc_size = INT_MAX;
+static atomic_size_t hugepage_threshold = 0;
 
 void av_max_alloc(size_t max){
     atomic_store_explicit(&max_alloc_size, max, memory_order_relaxed);
 }
 
+void av_malloc_set_hugepage_threshold(size_t size)
+{
+    atomic_store_explicit(&hugepage_threshold, size, memory_order_relaxed);
+}
+
 static int size_mult(size_t a, size_t b, size_t *r)
 {
     size_t t;
@@ -145,6 +157,21 @@ void *av_malloc(size_t size)
         size = 1;
         ptr= av_malloc(1);
     }
+#if HAVE_MADVISE && defined(MADV_HUGEPAGE)
+    if (ptr) {
+        size_t threshold = atomic_load_explicit(&hugepage_threshold,
+                                                memory_order_relaxed);
+        if (threshold && size >= threshold) {
+            /* advise the huge page aligned interior of the block; the kernel
+             * only backs fully covered aligned regions with huge pages */
+            uintptr_t start = FFALIGN((uintptr_t)ptr, HUGE_PAGE_SIZE);
+            uintptr_t end   = ((uintptr_t)ptr + size) &
+                              ~(uintptr_t)(HUGE_PAGE_SIZE - 1);
+            if (end > start)
+                madvise((void*)start, end - start, MADV_HUGEPAGE);
+        }
+    }
+#endif
 #if CONFIG_MEMORY_POISONING
     if (ptr)
         memset(ptr, FF_MEMORY_POISON, size);
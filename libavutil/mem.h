@@ -599,6 +599,21 @@ int av_size_mult(size_t a, size_t b, size_t *r);
  */
 void av_max_alloc(size_t max);
 
+/**
+ * Set the minimum allocation size for which huge pages are requested.
+ *
+ * Allocations of at least this size are advised to the kernel as candidates
+ * for transparent huge pages where madvise(MADV_HUGEPAGE) is available,
+ * reducing TLB pressure for large buffers such as video frames. The advice
+ * covers the huge page aligned interior of each allocation; on other
+ * platforms this function has no effect.
+ *
+ * By default the threshold is 0, which disables the advice entirely.
+ *
+ * @param size Minimum allocation size in bytes, or 0 to disable
+ */
+void av_malloc_set_hugepage_threshold(size_t size);
+
 /**
  * @}
  * @}
@@ -0,0 +1,144 @@
+/*
+ * This file is part of Librempeg
+ *
+ * Librempeg is free software; you can redistribute it and/or modify
+ * it under the terms of the GNU General Public License as published by
+ * the Free Software Foundation; either version 3 of the License, or
+ * (at your option) any later version.
+ *
+ * Librempeg is distributed in the hope that it will be useful,
+ * but WITHOUT ANY WARRANTY; without even the implied warranty of
+ * MERCHANTABILITY or FITNESS FOR A PARTICULAR PURPOSE.  See the
+ * GNU General Public License for more details.
+ *
+ * You should have received a copy of the GNU General Public License along
+ * with Librempeg; if not, write to the Free Software Foundation, Inc.,
+ * 51 Franklin Street, Fifth Floor, Boston, MA 02110-1301 USA.
+ */
+
+#include <inttypes.h>
+#include <stdio.h>
+#include <stdlib.h>
+
+#include "libavutil/audio_frame_fifo.h"
+#include "libavutil/channel_layout.h"
+#include "libavutil/frame.h"
+#include "libavutil/samplefmt.h"
+
+#define SAMPLE_RATE 48000
+
+static void ERROR(const char *str)
+{
+    fprintf(stderr, "%s\n", str);
+    exit(1);
+}
+
+static AVFrame *new_frame(enum AVSampleFormat format, int nb_channels,
+                          int nb_samples, int64_t pts, int *counter)
+{
+    AVFrame *frame = av_frame_alloc();
+
+    if (!frame)
+        ERROR("failed to allocate frame");
+
+    frame->format      = format;
+    frame->nb_samples  = nb_samples;
+    frame->sample_rate = SAMPLE_RATE;
+    frame->pts         = pts;
+    frame->time_base   = (AVRational){ 1, SAMPLE_RATE };
+    av_channel_layout_default(&frame->ch_layout, nb_channels);
+
+    if (av_frame_get_buffer(frame, 0) < 0)
+        ERROR("failed to allocate frame buffer");
+
+    for (int ch = 0; ch < nb_channels; ch++) {
+        const int planar = av_sample_fmt_is_planar(format);
+        int16_t *samples = (int16_t *)frame->extended_data[planar ? ch : 0];
+        int      stride  = planar ? 1 : nb_channels;
+
+        if (!planar)
+            samples += ch;
+        for (int i = 0; i < nb_samples; i++)
+            samples[i * stride] = (*counter + i) * 10 + ch;
+    }
+    *counter += nb_samples;
+
+    return frame;
+}
+
+static void print_frame(const AVFrame *frame, const AVFrame *src)
+{
+    const int planar = av_sample_fmt_is_planar(frame->format);
+
+    printf("read %3d samples pts %5"PRId64" duration %3"PRId64" %s:",
+           frame->nb_samples, frame->pts, frame->duration,
+           src && frame->extended_data[0] >= src->extended_data[0] &&
+           frame->extended_data[0] < src->extended_data[0] +
+                                     src->linesize[0] ? "ref " : "copy");
+    for (int i = 0; i < frame->nb_samples; i++) {
+        for (int ch = 0; ch < frame->ch_layout.nb_channels; ch++) {
+            const int16_t *samples = (const int16_t *)
+                frame->extended_data[planar ? ch : 0];
+            int stride = planar ? 1 : frame->ch_layout.nb_channels;
+
+            printf(" %d", samples[i * stride + (planar ? 0 : ch)]);
+        }
+    }
+    printf("\n");
+}
+
+static void test_fifo(enum AVSampleFormat format, int nb_channels,
+                      const int *write_sizes, int nb_writes, int read_size)
+{
+    AVAudioFrameFifo *aff = av_audio_frame_fifo_alloc();
+    AVFrame *inputs[16];
+    AVFrame *frame = av_frame_alloc();
+    int counter = 0, ret;
+
+    if (!aff || !frame || nb_writes > 16)
+        ERROR("failed to allocate FIFO");
+
+    printf("%s %d channels, reads of %d\n",
+           av_get_sample_fmt_name(format), nb_channels, read_size);
+
+    for (int i = 0; i < nb_writes; i++) {
+        inputs[i] = new_frame(format, nb_channels, write_sizes[i],
+                              counter, &counter);
+        if (av_audio_frame_fifo_write(aff, inputs[i]) < 0)
+            ERROR("write failed");
+    }
+    printf("queued %d samples\n", av_audio_frame_fifo_size(aff));
+
+    while ((ret = av_audio_frame_fifo_read(aff, frame, read_size)) > 0) {
+        AVFrame *src = NULL;
+
+        for (int i = 0; i < nb_writes; i++)
+            if (frame->buf[0] && inputs[i]->buf[0] &&
+                frame->buf[0]->buffer == inputs[i]->buf[0]->buffer)
+                src = inputs[i];
+        print_frame(frame, src);
+        av_frame_unref(frame);
+    }
+    if (ret < 0)
+        ERROR("read failed");
+
+    for (int i = 0; i < nb_writes; i++)
+        av_frame_free(&inputs[i]);
+    av_frame_free(&frame);
+    av_audio_frame_fifo_free(&aff);
+    if (aff)
+        ERROR("free did not reset the FIFO pointer");
+}
+
+int main(void)
+{
+    static const int sizes1[] = { 12, 12, 12 };
+    static const int sizes2[] = { 5, 11, 7, 13 };
+    static const int sizes3[] = { 40, 2, 30 };
+
+    test_fifo(AV_SAMPLE_FMT_S16P, 2, sizes1, 3, 12);
+    test_fifo(AV_SAMPLE_FMT_S16P, 1, sizes2, 4, 9);
+    test_fifo(AV_SAMPLE_FMT_S16,  2, sizes3, 3, 24);
+
+    return 0;
+}
@@ -22,6 +22,7 @@
 #include "mem.h"
 #include "qsort.h"
 #include "bprint.h"
+#include "thread.h"
 
 #include "tx_priv.h"
 
@@ -694,6 +695,25 @@ static int cmp_matches(TXCodeletMatch *a, TXCodeletMatch *b)
     return FFDIFFSIGN(b->prio, a->prio);
 }
 
+/* The list of codelets matching a given transform request is fully determined
+ * by the request parameters, so cache the sorted results; programs commonly
+ * create many contexts with identical parameters, and each one would
+ * otherwise re-walk and re-sort every codelet list. */
+#define TX_MATCH_CACHE_SIZE        32
+#define TX_MATCH_CACHE_MAX_MATCHES 16
+
+typedef struct TXMatchCacheEntry {
+    enum AVTXType type;
+    uint64_t flags;
+    int len, inv, cpu_flags;
+    int nb_matches; /* zero if the entry is unused */
+    TXCodeletMatch matches[TX_MATCH_CACHE_MAX_MATCHES];
+} TXMatchCacheEntry;
+
+static TXMatchCacheEntry match_cache[TX_MATCH_CACHE_SIZE];
+static int match_cache_pos;
+static AVMutex match_cache_lock = AV_MUTEX_INITIALIZER;
+
 /* We want all factors to completely cover the length */
 static inline int check_cd_factors(const FFTXCodelet *cd, int len)
 {
@@ -740,7 +760,7 @@ av_cold int ff_tx_init_subtx(AVTXContext *s, enum AVTXType type,
     TXCodeletMatch *cd_tmp, *cd_matches = NULL;
     unsigned int cd_matches_size = 0;
     int codelet_list_idx = codelet_list_num;
-    int nb_cd_matches = 0;
+    int nb_cd_matches = 0, cached;
 #if !CONFIG_SMALL
     AVBPrint bp;
 #endif
@@ -769,9 +789,28 @@ av_cold int ff_tx_init_subtx(AVTXContext *s, enum AVTXType type,
     if ((req_flags & FF_TX_ALIGNED) && (req_flags & AV_TX_UNALIGNED))
         req_flags &= ~(FF_TX_ALIGNED | AV_TX_UNALIGNED);
 
+    /* Check the cache for an identical previous request */
+    ff_mutex_lock(&match_cache_lock);
+    for (int i = 0; i < TX_MATCH_CACHE_SIZE; i++) {
+        const TXMatchCacheEntry *e = &match_cache[i];
+        if (e->nb_matches && e->type == type && e->flags == req_flags &&
+            e->len == len && e->inv == inv && e->cpu_flags == cpu_flags) {
+            cd_matches = av_memdup(e->matches,
+                                   e->nb_matches * sizeof(*cd_matches));
+            if (!cd_matches) {
+                ff_mutex_unlock(&match_cache_lock);
+                return AVERROR(ENOMEM);
+            }
+            nb_cd_matches = e->nb_matches;
+            break;
+        }
+    }
+    ff_mutex_unlock(&match_cache_lock);
+    cached = nb_cd_matches > 0;
+
     /* Loop through all codelets in all codelet lists to find matches
      * to the requirements */
-    while (codelet_list_idx--) {
+    while (!cached && codelet_list_idx--) {
         const FFTXCodelet * const * list = codelet_list[codelet_list_idx];
         const FFTXCodelet *cd = NULL;
 
@@ -836,8 +875,27 @@ av_cold int ff_tx_init_subtx(AVTXContext *s, enum AVTXType type,
     if (!nb_cd_matches)
         return AVERROR(ENOSYS);
 
-    /* Sort the list */
-    AV_QSORT(cd_matches, nb_cd_matches, TXCodeletMatch, cmp_matches);
+    if (!cached) {
+        /* Sort the list */
+        AV_QSORT(cd_matches, nb_cd_matches, TXCodeletMatch, cmp_matches);
+
+        /* Remember the result for subsequent identical requests */
+        if (nb_cd_matches <= TX_MATCH_CACHE_MAX_MATCHES) {
+            TXMatchCacheEntry *e;
+
+            ff_mutex_lock(&match_cache_lock);
+            e = &match_cache[match_cache_pos];
+            match_cache_pos = (match_cache_pos + 1) % TX_MATCH_CACHE_SIZE;
+            e->type       = type;
+            e->flags      = req_flags;
+            e->len        = len;
+            e->inv        = inv;
+            e->cpu_flags  = cpu_flags;
+            e->nb_matches = nb_cd_matches;
+            memcpy(e->matches, cd_matches, nb_cd_matches * sizeof(*cd_matches));
+            ff_mutex_unlock(&match_cache_lock);
+        }
+    }
 
 #if !CONFIG_SMALL
     av_log(NULL, AV_LOG_TRACE, "%s\n", bp.str);
@@ -959,3 +1017,18 @@ av_cold int av_tx_init(AVTXContext **ctx, av_tx_fn *tx, enum AVTXType type,
 
     return ret;
 }
+
+void av_tx_exec_batch(AVTXContext *s, int count,
+                      void *out, ptrdiff_t out_stride,
+                      void *in, ptrdiff_t in_stride, ptrdiff_t stride)
+{
+    const av_tx_fn fn = s->cd_self->function;
+    uint8_t *o = out;
+    uint8_t *i = in;
+
+    for (int n = 0; n < count; n++) {
+        fn(s, o, i, stride);
+        o += out_stride;
+        i += in_stride;
+    }
+}
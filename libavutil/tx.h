@@ -202,6 +202,26 @@ enum AVTXFlags {
 int av_tx_init(AVTXContext **ctx, av_tx_fn *tx, enum AVTXType type,
                int inv, int len, const void *scale, uint64_t flags);
 
+/**
+ * Perform several transforms of the same kind in a single call.
+ *
+ * Equivalent to invoking the transform function returned by av_tx_init()
+ * count times, advancing the input and output pointers by in_stride and
+ * out_stride bytes between transforms. Running same-size transforms
+ * back-to-back keeps the tables of the transform tree hot in the cache.
+ *
+ * @param ctx the transform context allocated by av_tx_init()
+ * @param count the number of transforms to perform
+ * @param out pointer to the output array of the first transform
+ * @param out_stride distance between consecutive output arrays, in bytes
+ * @param in pointer to the input array of the first transform
+ * @param in_stride distance between consecutive input arrays, in bytes
+ * @param stride the stride to pass to each transform, as with av_tx_fn()
+ */
+void av_tx_exec_batch(AVTXContext *ctx, int count,
+                      void *out, ptrdiff_t out_stride,
+                      void *in, ptrdiff_t in_stride, ptrdiff_t stride);
+
 /**
  * Frees a context and sets *ctx to NULL, does nothing when *ctx == NULL.
  */
@@ -325,6 +325,64 @@ cglobal vector_fmul_window, 5, 6, 6, dst, src0, src1, win, len, len1
     jl .loop
     RET
 
+%if HAVE_AVX2_EXTERNAL
+; The API only guarantees 16 byte alignment and a length that is a multiple
+; of 4, so use unaligned accesses and finish up with an xmm pass if needed.
+INIT_YMM avx2
+cglobal vector_fmul_window, 5, 6, 7, dst, src0, src1, win, len, len1
+    shl      lend, 2
+    lea     len1q, [lenq - mmsize]
+    add     src0q, lenq
+    add      dstq, lenq
+    add      winq, lenq
+    neg      lenq
+    movaps     m6, [pd_reverse]
+    cmp      lenq, -mmsize
+    jg .tail
+.loop:
+    movups     m0, [winq  + lenq]
+    movups     m4, [src0q + lenq]
+    vpermps    m1, m6, [winq  + len1q]
+    vpermps    m5, m6, [src1q + len1q]
+    mulps      m2, m0, m4
+    mulps      m3, m1, m5
+    mulps      m1, m1, m4
+    mulps      m0, m0, m5
+    addps      m2, m2, m3
+    subps      m1, m1, m0
+    vpermps    m2, m6, m2
+    movups     [dstq + lenq], m1
+    movups     [dstq + len1q], m2
+    sub     len1q, mmsize
+    add      lenq, mmsize
+    cmp      lenq, -mmsize
+    jle .loop
+.tail:
+    test     lenq, lenq
+    jns .end
+    ; four floats left on each side
+    mov     len1q, lenq
+    neg     len1q
+    sub     len1q, 16
+    movups    xm0, [winq  + lenq]
+    movups    xm4, [src0q + lenq]
+    movups    xm1, [winq  + len1q]
+    movups    xm5, [src1q + len1q]
+    shufps    xm1, xm1, 0x1b
+    shufps    xm5, xm5, 0x1b
+    mulps     xm2, xm0, xm4
+    mulps     xm3, xm1, xm5
+    mulps     xm1, xm1, xm4
+    mulps     xm0, xm0, xm5
+    addps     xm2, xm2, xm3
+    subps     xm1, xm1, xm0
+    shufps    xm2, xm2, 0x1b
+    movups    [dstq + lenq], xm1
+    movups    [dstq + len1q], xm2
+.end:
+    RET
+%endif
+
 ;-----------------------------------------------------------------------------
 ; vector_fmul_add(float *dst, const float *src0, const float *src1,
 ;                 const float *src2, int len)
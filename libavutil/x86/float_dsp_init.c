@@ -55,6 +55,8 @@ void ff_vector_dmul_scalar_avx(double *dst, const double *src,
 
 void ff_vector_fmul_window_sse(float *dst, const float *src0,
                                const float *src1, const float *win, int len);
+void ff_vector_fmul_window_avx2(float *dst, const float *src0,
+                                const float *src1, const float *win, int len);
 
 void ff_vector_fmul_add_sse(float *dst, const float *src0, const float *src1,
                             const float *src2, int len);
@@ -110,6 +112,7 @@ av_cold void ff_float_dsp_init_x86(AVFloatDSPContext *fdsp)
     }
     if (EXTERNAL_AVX2_FAST(cpu_flags)) {
         fdsp->vector_fmul_reverse = ff_vector_fmul_reverse_avx2;
+        fdsp->vector_fmul_window  = ff_vector_fmul_window_avx2;
     }
     if (EXTERNAL_FMA3_FAST(cpu_flags)) {
         fdsp->vector_fmac_scalar = ff_vector_fmac_scalar_fma3;
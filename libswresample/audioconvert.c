@@ -129,6 +129,50 @@ static conv_func_type * const fmt_pair_to_conv_functions[AV_SAMPLE_FMT_NB*AV_SAM
     FMT_PAIR_FUNC(AV_SAMPLE_FMT_S64, AV_SAMPLE_FMT_S64),
 };
 
+#define BULK_CONV_FUNC_NAME(dst_fmt, src_fmt) bulk_ ## src_fmt ## _to_ ## dst_fmt
+
+/* Contiguous variants of the conversions above, usable whenever input and
+ * output have the same interleaving. With unit stride known at compile time
+ * the compiler auto-vectorizes these, unlike the generic strided loops. */
+#define BULK_CONV_FUNC(ofmt, otype, ifmt, itype, expr)\
+static void BULK_CONV_FUNC_NAME(ofmt, ifmt)(uint8_t **dst, const uint8_t **src, int len)\
+{\
+    otype *restrict po       = (otype *)*dst;\
+    const itype *restrict pi = (const itype *)*src;\
+    for (int i = 0; i < len; i++)\
+        po[i] = expr;\
+}
+
+BULK_CONV_FUNC(AV_SAMPLE_FMT_S32, int32_t, AV_SAMPLE_FMT_S16, int16_t, pi[i] * (1 << 16))
+BULK_CONV_FUNC(AV_SAMPLE_FMT_FLT, float  , AV_SAMPLE_FMT_S16, int16_t, pi[i] * (1.0f/ (1<<15)))
+BULK_CONV_FUNC(AV_SAMPLE_FMT_DBL, double , AV_SAMPLE_FMT_S16, int16_t, pi[i] * (1.0 / (1<<15)))
+BULK_CONV_FUNC(AV_SAMPLE_FMT_S16, int16_t, AV_SAMPLE_FMT_S32, int32_t, pi[i] >> 16)
+BULK_CONV_FUNC(AV_SAMPLE_FMT_FLT, float  , AV_SAMPLE_FMT_S32, int32_t, pi[i] * (1.0f/ (1U<<31)))
+BULK_CONV_FUNC(AV_SAMPLE_FMT_DBL, double , AV_SAMPLE_FMT_S32, int32_t, pi[i] * (1.0 / (1U<<31)))
+BULK_CONV_FUNC(AV_SAMPLE_FMT_S16, int16_t, AV_SAMPLE_FMT_FLT, float  , av_clip_int16(  lrintf(pi[i] * (1<<15))))
+BULK_CONV_FUNC(AV_SAMPLE_FMT_S32, int32_t, AV_SAMPLE_FMT_FLT, float  , av_clipl_int32(llrintf(pi[i] * (1U<<31))))
+BULK_CONV_FUNC(AV_SAMPLE_FMT_DBL, double , AV_SAMPLE_FMT_FLT, float  , pi[i])
+BULK_CONV_FUNC(AV_SAMPLE_FMT_S16, int16_t, AV_SAMPLE_FMT_DBL, double , av_clip_int16(  lrint(pi[i] * (1<<15))))
+BULK_CONV_FUNC(AV_SAMPLE_FMT_S32, int32_t, AV_SAMPLE_FMT_DBL, double , av_clipl_int32(llrint(pi[i] * (1U<<31))))
+BULK_CONV_FUNC(AV_SAMPLE_FMT_FLT, float  , AV_SAMPLE_FMT_DBL, double , pi[i])
+
+#define BULK_PAIR_FUNC(out, in) [(out) + AV_SAMPLE_FMT_NB*(in)] = BULK_CONV_FUNC_NAME(out, in)
+
+static simd_func_type * const fmt_pair_to_bulk_functions[AV_SAMPLE_FMT_NB*AV_SAMPLE_FMT_NB] = {
+    BULK_PAIR_FUNC(AV_SAMPLE_FMT_S32, AV_SAMPLE_FMT_S16),
+    BULK_PAIR_FUNC(AV_SAMPLE_FMT_FLT, AV_SAMPLE_FMT_S16),
+    BULK_PAIR_FUNC(AV_SAMPLE_FMT_DBL, AV_SAMPLE_FMT_S16),
+    BULK_PAIR_FUNC(AV_SAMPLE_FMT_S16, AV_SAMPLE_FMT_S32),
+    BULK_PAIR_FUNC(AV_SAMPLE_FMT_FLT, AV_SAMPLE_FMT_S32),
+    BULK_PAIR_FUNC(AV_SAMPLE_FMT_DBL, AV_SAMPLE_FMT_S32),
+    BULK_PAIR_FUNC(AV_SAMPLE_FMT_S16, AV_SAMPLE_FMT_FLT),
+    BULK_PAIR_FUNC(AV_SAMPLE_FMT_S32, AV_SAMPLE_FMT_FLT),
+    BULK_PAIR_FUNC(AV_SAMPLE_FMT_DBL, AV_SAMPLE_FMT_FLT),
+    BULK_PAIR_FUNC(AV_SAMPLE_FMT_S16, AV_SAMPLE_FMT_DBL),
+    BULK_PAIR_FUNC(AV_SAMPLE_FMT_S32, AV_SAMPLE_FMT_DBL),
+    BULK_PAIR_FUNC(AV_SAMPLE_FMT_FLT, AV_SAMPLE_FMT_DBL),
+};
+
 static void cpy1(uint8_t **dst, const uint8_t **src, int len){
     memcpy(*dst, *src, len);
 }
@@ -176,6 +220,10 @@ AudioConvert *swri_audio_convert_alloc(enum AVSampleFormat out_fmt,
         }
     }
 
+    if (!ctx->simd_f && !ch_map &&
+        av_sample_fmt_is_planar(out_fmt) == av_sample_fmt_is_planar(in_fmt))
+        ctx->simd_f = fmt_pair_to_bulk_functions[av_get_packed_sample_fmt(out_fmt) + AV_SAMPLE_FMT_NB*av_get_packed_sample_fmt(in_fmt)];
+
 #if ARCH_X86 && HAVE_X86ASM && HAVE_MMX
     swri_audio_convert_init_x86(ctx, out_fmt, in_fmt, channels);
 #elif ARCH_ARM
@@ -50,7 +50,54 @@ void RENAME(swri_noise_shaping)(SwrContext *s, AudioData *dsts, const AudioData
     av_assert2((taps&3) != 2);
     av_assert2((taps&3) != 3 || s->dither.ns_coeffs[taps] == 0);
 
-    for (ch=0; ch<srcs->ch_count; ch++) {
+    /* The error feedback makes each channel a serial dependency chain, so a
+     * single channel cannot keep the FPU busy; process channels in pairs to
+     * overlap two independent chains and share the coefficient loads. The
+     * error positions advance identically for every channel. */
+    for (ch=0; ch+1<srcs->ch_count; ch+=2) {
+        const float *noise0 = ((const float *)noises->ch[ch    ]) + s->dither.noise_pos;
+        const float *noise1 = ((const float *)noises->ch[ch + 1]) + s->dither.noise_pos;
+        const DELEM *src0 = (const DELEM*)srcs->ch[ch    ];
+        const DELEM *src1 = (const DELEM*)srcs->ch[ch + 1];
+        DELEM *dst0 = (DELEM*)dsts->ch[ch    ];
+        DELEM *dst1 = (DELEM*)dsts->ch[ch + 1];
+        float *ns_errors0 = s->dither.ns_errors[ch    ];
+        float *ns_errors1 = s->dither.ns_errors[ch + 1];
+        const float *ns_coeffs = s->dither.ns_coeffs;
+        pos  = s->dither.ns_pos;
+        for (i=0; i<count; i++) {
+            double r0, r1;
+            double d0 = src0[i]*S_1;
+            double d1 = src1[i]*S_1;
+            for(j=0; j<taps-2; j+=4) {
+                d0 -= ns_coeffs[j    ] * ns_errors0[pos + j    ]
+                     +ns_coeffs[j + 1] * ns_errors0[pos + j + 1]
+                     +ns_coeffs[j + 2] * ns_errors0[pos + j + 2]
+                     +ns_coeffs[j + 3] * ns_errors0[pos + j + 3];
+                d1 -= ns_coeffs[j    ] * ns_errors1[pos + j    ]
+                     +ns_coeffs[j + 1] * ns_errors1[pos + j + 1]
+                     +ns_coeffs[j + 2] * ns_errors1[pos + j + 2]
+                     +ns_coeffs[j + 3] * ns_errors1[pos + j + 3];
+            }
+            if(j < taps){
+                d0 -= ns_coeffs[j] * ns_errors0[pos + j];
+                d1 -= ns_coeffs[j] * ns_errors1[pos + j];
+            }
+            pos = pos ? pos - 1 : taps - 1;
+            r0 = rint(d0 + noise0[i]);
+            r1 = rint(d1 + noise1[i]);
+            ns_errors0[pos + taps] = ns_errors0[pos] = r0 - d0;
+            ns_errors1[pos + taps] = ns_errors1[pos] = r1 - d1;
+            r0 *= S;
+            r1 *= S;
+            CLIP(r0);
+            CLIP(r1);
+            dst0[i] = r0;
+            dst1[i] = r1;
+        }
+    }
+
+    for (; ch<srcs->ch_count; ch++) {
         const float *noise = ((const float *)noises->ch[ch]) + s->dither.noise_pos;
         const DELEM *src = (const DELEM*)srcs->ch[ch];
         DELEM *dst = (DELEM*)dsts->ch[ch];
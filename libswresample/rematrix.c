@@ -611,35 +611,48 @@ int swri_rematrix(SwrContext *s, AudioData *out, AudioData *in, int len, int mus
             if(len != len1)
                 s->mix_2_1_f   (out->ch[out_i]+off, in->ch[in_i1]+off, in->ch[in_i2]+off, s->native_matrix, in->ch_count*out_i + in_i1, in->ch_count*out_i + in_i2, len-len1);
             break;}
-        default:
+        default: {
+            /* gather the nonzero inputs of this row into dense local arrays,
+             * so the sample loops below index neither the channel list nor
+             * the sparse matrix and are free to get vectorized */
+            const int nb_in_ch = s->matrix_ch[out_i][0];
+            const uint8_t *ch[SWR_CH_MAX];
+
+            for(j=0; j<nb_in_ch; j++)
+                ch[j]= in->ch[s->matrix_ch[out_i][1+j]];
+
             if(s->int_sample_fmt == AV_SAMPLE_FMT_FLTP){
+                float coeff[SWR_CH_MAX];
+                for(j=0; j<nb_in_ch; j++)
+                    coeff[j]= s->matrix_flt[out_i][s->matrix_ch[out_i][1+j]];
                 for(i=0; i<len; i++){
                     float v=0;
-                    for(j=0; j<s->matrix_ch[out_i][0]; j++){
-                        in_i= s->matrix_ch[out_i][1+j];
-                        v+= ((float*)in->ch[in_i])[i] * s->matrix_flt[out_i][in_i];
-                    }
+                    for(j=0; j<nb_in_ch; j++)
+                        v+= ((const float*)ch[j])[i] * coeff[j];
                     ((float*)out->ch[out_i])[i]= v;
                 }
             }else if(s->int_sample_fmt == AV_SAMPLE_FMT_DBLP){
+                double coeff[SWR_CH_MAX];
+                for(j=0; j<nb_in_ch; j++)
+                    coeff[j]= s->matrix[out_i][s->matrix_ch[out_i][1+j]];
                 for(i=0; i<len; i++){
                     double v=0;
-                    for(j=0; j<s->matrix_ch[out_i][0]; j++){
-                        in_i= s->matrix_ch[out_i][1+j];
-                        v+= ((double*)in->ch[in_i])[i] * s->matrix[out_i][in_i];
-                    }
+                    for(j=0; j<nb_in_ch; j++)
+                        v+= ((const double*)ch[j])[i] * coeff[j];
                     ((double*)out->ch[out_i])[i]= v;
                 }
             }else{
+                int32_t coeff[SWR_CH_MAX];
+                for(j=0; j<nb_in_ch; j++)
+                    coeff[j]= s->matrix32[out_i][s->matrix_ch[out_i][1+j]];
                 for(i=0; i<len; i++){
                     int v=0;
-                    for(j=0; j<s->matrix_ch[out_i][0]; j++){
-                        in_i= s->matrix_ch[out_i][1+j];
-                        v+= ((int16_t*)in->ch[in_i])[i] * s->matrix32[out_i][in_i];
-                    }
+                    for(j=0; j<nb_in_ch; j++)
+                        v+= ((const int16_t*)ch[j])[i] * coeff[j];
                     ((int16_t*)out->ch[out_i])[i]= (v + 16384)>>15;
                 }
             }
+            break;}
         }
     }
     return 0;
@@ -384,12 +384,27 @@ static int multiple_resample(ResampleContext *c, AudioData *dst, int dst_size, A
 
         dst_size = FFMAX(FFMIN(dst_size, delta_n), 0);
         if (dst_size > 0) {
+            int dst_done = 0;
             /* resample_linear and resample_common should have same behavior
              * when frac and dst_incr_mod are zero */
             resample_func = (c->linear && (c->frac || c->dst_incr_mod)) ?
                             c->dsp.resample_linear : c->dsp.resample_common;
-            for (i = 0; i < dst->ch_count; i++)
-                *consumed = resample_func(c, dst->ch[i], src->ch[i], dst_size, i+1 == dst->ch_count);
+            while (dst_done < dst_size) {
+                /* With many channels, process the output in blocks so the
+                 * filter phases and source window read for the first channel
+                 * are still cached when the remaining channels reuse them */
+                int block = dst->ch_count > 1 ?
+                            FFMIN(dst_size - dst_done, 256) : dst_size;
+                int block_consumed = 0;
+
+                for (i = 0; i < dst->ch_count; i++)
+                    block_consumed = resample_func(c,
+                                                   dst->ch[i] + dst_done  * (ptrdiff_t)dst->bps,
+                                                   src->ch[i] + *consumed * (ptrdiff_t)src->bps,
+                                                   block, i+1 == dst->ch_count);
+                *consumed += block_consumed;
+                dst_done  += block;
+            }
         }
     }
 
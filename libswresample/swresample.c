@@ -114,6 +114,7 @@ static void clear_context(SwrContext *s){
 
     s->delayed_samples_fixup = 0;
     s->flushed = 0;
+    s->draining = 0;
 }
 
 av_cold void swr_free(SwrContext **ss){
@@ -563,6 +563,47 @@ const char *swresample_license(void);
 int swr_convert_frame(SwrContext *swr,
                       AVFrame *output, const AVFrame *input);
 
+/**
+ * Submit an AVFrame of input samples for resampling.
+ *
+ * The samples are consumed and buffered immediately, decoupling input
+ * submission from output retrieval so that both can be driven from
+ * different stages of a processing pipeline. Output is produced by
+ * swr_receive_frame().
+ *
+ * If the context is not initialized yet it is configured from the input
+ * frame parameters, as with swr_convert_frame().
+ *
+ * @see swr_receive_frame()
+ *
+ * @param swr             audio resample context
+ * @param input           input AVFrame, or NULL to signal the end of the
+ *                        stream and enter draining mode
+ * @return                0 on success, AVERROR_EOF if a NULL frame was
+ *                        already submitted, another AVERROR on failure or
+ *                        nonmatching configuration.
+ */
+int swr_send_frame(SwrContext *swr, const AVFrame *input);
+
+/**
+ * Retrieve resampled samples from previously submitted input.
+ *
+ * If the output AVFrame does not have its data pointers allocated, it is
+ * sized to hold all currently available output and allocated with
+ * av_frame_get_buffer().
+ *
+ * @see swr_send_frame()
+ *
+ * @param swr             audio resample context
+ * @param output          output AVFrame with channel_layout, sample_rate
+ *                        and format set
+ * @return                0 on success, AVERROR(EAGAIN) if more input is
+ *                        required, AVERROR_EOF when draining is complete,
+ *                        another AVERROR on failure or nonmatching
+ *                        configuration.
+ */
+int swr_receive_frame(SwrContext *swr, AVFrame *output);
+
 /**
  * Configure or reconfigure the SwrContext using the information
  * provided by the AVFrames.
@@ -136,6 +136,75 @@ static inline int available_samples(AVFrame *out)
     }
 }
 
+int swr_send_frame(SwrContext *s, const AVFrame *in)
+{
+    int ret;
+
+    if (!in) {
+        if (swr_is_initialized(s))
+            s->draining = 1;
+        return 0;
+    }
+
+    if (s->draining)
+        return AVERROR_EOF;
+
+    if (!swr_is_initialized(s)) {
+        if ((ret = swr_config_frame(s, NULL, in)) < 0)
+            return ret;
+        if ((ret = swr_init(s)) < 0)
+            return ret;
+    } else {
+        if ((ret = config_changed(s, NULL, in)))
+            return ret;
+    }
+
+    /* buffer the input; output is produced by swr_receive_frame() */
+    return convert_frame(s, NULL, in);
+}
+
+int swr_receive_frame(SwrContext *s, AVFrame *out)
+{
+    const uint8_t *dummy_in[SWR_CH_MAX] = { NULL };
+    int ret;
+
+    if (!swr_is_initialized(s))
+        return AVERROR(EINVAL);
+
+    if ((ret = config_changed(s, out, NULL)))
+        return ret;
+
+    if (!out->linesize[0]) {
+        out->nb_samples = swr_get_out_samples(s, 0);
+        if (s->draining)
+            out->nb_samples += swr_get_delay(s, s->out_sample_rate) + 3;
+        if (out->nb_samples <= 0)
+            return s->draining ? AVERROR_EOF : AVERROR(EAGAIN);
+        if ((ret = av_frame_get_buffer(out, 0)) < 0)
+            return ret;
+    } else {
+        if (!out->nb_samples)
+            out->nb_samples = available_samples(out);
+    }
+
+    /* a non-NULL input with zero samples converts the buffered data without
+     * flushing the resampler; a NULL input signals end of stream and drains
+     * the remaining delay */
+    ret = swr_convert(s, out->extended_data, out->nb_samples,
+                      s->draining ? NULL : dummy_in, 0);
+    if (ret < 0) {
+        out->nb_samples = 0;
+        return ret;
+    }
+    if (!ret) {
+        out->nb_samples = 0;
+        return s->draining ? AVERROR_EOF : AVERROR(EAGAIN);
+    }
+
+    out->nb_samples = ret;
+    return 0;
+}
+
 int swr_convert_frame(SwrContext *s,
                       AVFrame *out, const AVFrame *in)
 {
@@ -133,6 +133,24 @@ static inline int ff_fmt_equal(const SwsFormat *fmt1, const SwsFormat *fmt2)
            ff_props_equal(fmt1, fmt2);
 }
 
+/**
+ * Returns the canonical pixel format for the deprecated YUVJ aliases, which
+ * share their memory layout with the corresponding YUV formats and differ
+ * only in the implied color range; the actual range is carried separately
+ * in SwsFormat. Returns the format unchanged otherwise.
+ */
+static inline enum AVPixelFormat ff_fmt_canonical(enum AVPixelFormat fmt)
+{
+    switch (fmt) {
+    case AV_PIX_FMT_YUVJ411P: return AV_PIX_FMT_YUV411P;
+    case AV_PIX_FMT_YUVJ420P: return AV_PIX_FMT_YUV420P;
+    case AV_PIX_FMT_YUVJ422P: return AV_PIX_FMT_YUV422P;
+    case AV_PIX_FMT_YUVJ440P: return AV_PIX_FMT_YUV440P;
+    case AV_PIX_FMT_YUVJ444P: return AV_PIX_FMT_YUV444P;
+    default:                  return fmt;
+    }
+}
+
 static inline int ff_fmt_align(enum AVPixelFormat fmt)
 {
     const AVPixFmtDescriptor *desc = av_pix_fmt_desc_get(fmt);
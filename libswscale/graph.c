@@ -648,6 +648,13 @@ static int init_passes(SwsGraph *graph)
     SwsPass *pass = NULL; /* read from main input image */
     int ret;
 
+    /* The deprecated YUVJ aliases differ from the corresponding YUV formats
+     * only in the implied color range, which ff_fmt_from_frame() has already
+     * resolved; fold them together so alias-only conversions are recognized
+     * as noops and take the zero-copy path in sws_scale_frame(). */
+    src.format = ff_fmt_canonical(src.format);
+    dst.format = ff_fmt_canonical(dst.format);
+
     ret = adapt_colors(graph, src, dst, pass, &pass);
     if (ret < 0)
         return ret;
@@ -247,6 +247,42 @@ void ff_sws_lut3d_update(SwsLut3D *lut3d, const SwsColor *new_src)
     ff_sws_tone_map_generate(lut3d->tone_map, TONE_LUT_SIZE, &lut3d->map);
 }
 
+static av_always_inline
+v3u16_t lookup_pixel(const SwsLut3D *lut3d, v3u16_t c, const int dynamic)
+{
+    c = lookup_input16(lut3d, c);
+    if (dynamic) {
+        c = apply_tone_map(lut3d, c);
+        c = lookup_output(lut3d, c);
+    }
+    return c;
+}
+
+static av_always_inline
+void apply_row(const SwsLut3D *lut3d, const uint16_t *in16, uint16_t *out16,
+               const int w, const int dynamic)
+{
+    /* Flat regions repeat the same value for long runs of pixels; remember
+     * the previous mapping to skip the entire interpolation chain */
+    v3u16_t prev_in  = { in16[0], in16[1], in16[2] };
+    v3u16_t prev_out = lookup_pixel(lut3d, prev_in, dynamic);
+
+    for (int x = 0; x < w; x++) {
+        const v3u16_t c = { in16[0], in16[1], in16[2] };
+        if (c.x != prev_in.x || c.y != prev_in.y || c.z != prev_in.z) {
+            prev_in  = c;
+            prev_out = lookup_pixel(lut3d, c, dynamic);
+        }
+
+        out16[0] = prev_out.x;
+        out16[1] = prev_out.y;
+        out16[2] = prev_out.z;
+        out16[3] = in16[3];
+        in16  += 4;
+        out16 += 4;
+    }
+}
+
 void ff_sws_lut3d_apply(const SwsLut3D *lut3d, const uint8_t *in, int in_stride,
                         uint8_t *out, int out_stride, int w, int h)
 {
@@ -254,22 +290,10 @@ void ff_sws_lut3d_apply(const SwsLut3D *lut3d, const uint8_t *in, int in_stride,
         const uint16_t *in16 = (const uint16_t *) in;
         uint16_t *out16 = (uint16_t *) out;
 
-        for (int x = 0; x < w; x++) {
-            v3u16_t c = { in16[0], in16[1], in16[2] };
-            c = lookup_input16(lut3d, c);
-
-            if (lut3d->dynamic) {
-                c = apply_tone_map(lut3d, c);
-                c = lookup_output(lut3d, c);
-            }
-
-            out16[0] = c.x;
-            out16[1] = c.y;
-            out16[2] = c.z;
-            out16[3] = in16[3];
-            in16  += 4;
-            out16 += 4;
-        }
+        if (lut3d->dynamic)
+            apply_row(lut3d, in16, out16, w, 1);
+        else
+            apply_row(lut3d, in16, out16, w, 0);
 
         in  += in_stride;
         out += out_stride;
@@ -18,11 +18,15 @@
  * Foundation, Inc., 51 Franklin Street, Fifth Floor, Boston, MA 02110-1301 USA
  */
 
+#include <inttypes.h>
+#include <stdatomic.h>
+
 #include "libavutil/avassert.h"
 #include "libavutil/bswap.h"
 #include "libavutil/mem.h"
 #include "libavutil/rational.h"
 #include "libavutil/refstruct.h"
+#include "libavutil/time.h"
 
 #include "ops.h"
 #include "ops_internal.h"
@@ -815,8 +819,13 @@ int ff_sws_ops_compile(SwsContext *ctx, const SwsOpList *ops, SwsCompiledOp *out
 }
 
 typedef struct SwsOpPass {
+    SwsContext *ctx;
     SwsCompiledOp comp;
     SwsOpExec exec_base;
+    /* accumulated timing statistics, only collected with debug logging */
+    bool stats;
+    atomic_uint_least64_t busy_time; /* in us */
+    atomic_uint_least64_t pixels;
     int num_blocks;
     int tail_off_in;
     int tail_off_out;
@@ -836,6 +845,16 @@ static void op_pass_free(void *ptr)
     if (!p)
         return;
 
+    if (p->stats) {
+        const uint64_t pixels = atomic_load_explicit(&p->pixels, memory_order_relaxed);
+        const uint64_t busy   = atomic_load_explicit(&p->busy_time, memory_order_relaxed);
+        if (pixels) {
+            av_log(p->ctx, AV_LOG_DEBUG,
+                   "ops pass stats: %"PRIu64" pixels in %.2f ms, %.2f ns/pixel\n",
+                   pixels, busy / 1000.0, 1000.0 * busy / pixels);
+        }
+    }
+
     if (p->comp.free)
         p->comp.free(p->comp.priv);
 
@@ -959,7 +978,8 @@ handle_tail(const SwsOpPass *p, SwsOpExec *exec,
 static void op_pass_run(const SwsImg *out_base, const SwsImg *in_base,
                         const int y, const int h, const SwsPass *pass)
 {
-    const SwsOpPass *p = pass->priv;
+    SwsOpPass *p = pass->priv;
+    const int64_t t0 = p->stats ? av_gettime_relative() : 0;
     const SwsCompiledOp *comp = &p->comp;
     const SwsImg in  = ff_sws_img_shift(in_base,  y);
     const SwsImg out = ff_sws_img_shift(out_base, y);
@@ -1014,6 +1034,13 @@ static void op_pass_run(const SwsImg *out_base, const SwsImg *in_base,
         handle_tail(p, &exec, out_base, true, in_base, false, y, h_main);
     if (memcpy_in)
         handle_tail(p, &exec, out_base, memcpy_out, in_base, true, y + h_main, 1);
+
+    if (p->stats) {
+        atomic_fetch_add_explicit(&p->busy_time, av_gettime_relative() - t0,
+                                  memory_order_relaxed);
+        atomic_fetch_add_explicit(&p->pixels, (uint64_t) exec.width * h,
+                                  memory_order_relaxed);
+    }
 }
 
 static int rw_planes(const SwsOp *op)
@@ -1060,6 +1087,11 @@ int ff_sws_compile_pass(SwsGraph *graph, SwsOpList *ops, int flags, SwsFormat ds
     if (!p)
         return AVERROR(ENOMEM);
 
+    p->ctx   = ctx;
+    p->stats = av_log_get_level() >= AV_LOG_DEBUG;
+    atomic_init(&p->busy_time, 0);
+    atomic_init(&p->pixels, 0);
+
     ret = ff_sws_ops_compile(ctx, ops, &p->comp);
     if (ret < 0)
         goto fail;
@@ -24,15 +24,8 @@
 static void free_lines(SwsSlice *s)
 {
     int i;
-    for (i = 0; i < 2; ++i) {
-        int n = s->plane[i].available_lines;
-        int j;
-        for (j = 0; j < n; ++j) {
-            av_freep(&s->plane[i].line[j]);
-            if (s->is_ring)
-               s->plane[i].line[j+n] = NULL;
-        }
-    }
+    for (i = 0; i < 2; ++i)
+        av_freep(&s->blocks[i]);
 
     for (i = 0; i < 4; ++i)
         memset(s->plane[i].line, 0, sizeof(uint8_t*) * s->plane[i].available_lines * (s->is_ring ? 3 : 1));
@@ -45,6 +38,7 @@ static void free_lines(SwsSlice *s)
 */
 static int alloc_lines(SwsSlice *s, int size, int width)
 {
+    const size_t line_size = size * 2 + 32;
     int i;
     int idx[2] = {3, 2};
 
@@ -57,14 +51,21 @@ static int alloc_lines(SwsSlice *s, int size, int width)
         int ii = idx[i];
 
         av_assert0(n == s->plane[ii].available_lines);
+
+        // allocate the lines of each plane pair as one contiguous block;
+        // the ring between the horizontal and the vertical scaler is
+        // walked line after line and wide images benefit from a backing
+        // store the hardware prefetcher can follow
+        s->blocks[i] = av_calloc(n, line_size);
+        if (!s->blocks[i]) {
+            free_lines(s);
+            return AVERROR(ENOMEM);
+        }
+
         for (j = 0; j < n; ++j) {
             // chroma plane line U and V are expected to be contiguous in memory
             // by mmx vertical scaler code
-            s->plane[i].line[j] = av_mallocz(size * 2 + 32);
-            if (!s->plane[i].line[j]) {
-                free_lines(s);
-                return AVERROR(ENOMEM);
-            }
+            s->plane[i].line[j] = s->blocks[i] + j * line_size;
             s->plane[ii].line[j] = s->plane[i].line[j] + size + 16;
             if (s->is_ring) {
                s->plane[i].line[j+n] = s->plane[i].line[j];
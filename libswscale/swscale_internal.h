@@ -1118,6 +1118,7 @@ typedef struct SwsSlice
     int is_ring;            ///< flag to identify if this slice is a ring buffer
     int should_free_lines;  ///< flag to identify if there are dynamic allocated lines
     enum AVPixelFormat fmt; ///< planes pixel format
+    uint8_t *blocks[2];     ///< backing store of the dynamically allocated lines
     SwsPlane plane[MAX_SLICE_PLANES];   ///< color planes
 } SwsSlice;
 
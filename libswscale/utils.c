@@ -607,6 +607,25 @@ done:
     return ret;
 }
 
+/*
+ * Duplicate an already initialized filter table, so the chroma filter can
+ * reuse the luma one when both are computed from the same parameters.
+ */
+static av_cold int dupFilter(int16_t **outFilter, int32_t **filterPos,
+                             int *outFilterSize, const int16_t *srcOutFilter,
+                             const int32_t *srcFilterPos, int srcOutFilterSize,
+                             int dstW)
+{
+    *outFilterSize = srcOutFilterSize;
+    *filterPos = av_memdup(srcFilterPos, (dstW + 3) * sizeof(**filterPos));
+    *outFilter = av_memdup(srcOutFilter,
+                           (dstW + 3) * srcOutFilterSize * sizeof(**outFilter));
+    if (!*filterPos || !*outFilter)
+        return AVERROR(ENOMEM);
+
+    return 0;
+}
+
 static void fill_rgb2yuv_table(SwsInternal *c, const int table[4], int dstRange)
 {
     int64_t W, V, Z, Cy, Cu, Cv;
@@ -1685,17 +1704,33 @@ av_cold int ff_sws_init_single_context(SwsContext *sws, SwsFilter *srcFilter,
                 goto fail;
             if (ff_shuffle_filter_coefficients(c, c->hLumFilterPos, c->hLumFilterSize, c->hLumFilter, dstW) < 0)
                 goto nomem;
-            if ((ret = initFilter(&c->hChrFilter, &c->hChrFilterPos,
-                           &c->hChrFilterSize, c->chrXInc,
-                           c->chrSrcW, c->chrDstW, filterAlign, 1 << 14,
-                           (flags & SWS_BICUBLIN) ? (flags | SWS_BILINEAR) : flags,
-                           cpu_flags, srcFilter->chrH, dstFilter->chrH,
-                           sws->scaler_params,
-                           get_local_pos(c, c->chrSrcHSubSample, sws->src_h_chr_pos, 0),
-                           get_local_pos(c, c->chrDstHSubSample, sws->dst_h_chr_pos, 0))) < 0)
-                goto fail;
-            if (ff_shuffle_filter_coefficients(c, c->hChrFilterPos, c->hChrFilterSize, c->hChrFilter, c->chrDstW) < 0)
-                goto nomem;
+            if (c->chrSrcW == srcW && c->chrDstW == dstW &&
+                !(flags & SWS_BICUBLIN) &&
+                srcFilter->chrH == srcFilter->lumH &&
+                dstFilter->chrH == dstFilter->lumH &&
+                get_local_pos(c, c->chrSrcHSubSample, sws->src_h_chr_pos, 0) ==
+                    get_local_pos(c, 0, 0, 0) &&
+                get_local_pos(c, c->chrDstHSubSample, sws->dst_h_chr_pos, 0) ==
+                    get_local_pos(c, 0, 0, 0)) {
+                /* chroma is scaled exactly like luma, reuse the freshly
+                 * computed (and shuffled) filter instead of recomputing it */
+                if (dupFilter(&c->hChrFilter, &c->hChrFilterPos,
+                              &c->hChrFilterSize, c->hLumFilter,
+                              c->hLumFilterPos, c->hLumFilterSize, dstW) < 0)
+                    goto nomem;
+            } else {
+                if ((ret = initFilter(&c->hChrFilter, &c->hChrFilterPos,
+                               &c->hChrFilterSize, c->chrXInc,
+                               c->chrSrcW, c->chrDstW, filterAlign, 1 << 14,
+                               (flags & SWS_BICUBLIN) ? (flags | SWS_BILINEAR) : flags,
+                               cpu_flags, srcFilter->chrH, dstFilter->chrH,
+                               sws->scaler_params,
+                               get_local_pos(c, c->chrSrcHSubSample, sws->src_h_chr_pos, 0),
+                               get_local_pos(c, c->chrDstHSubSample, sws->dst_h_chr_pos, 0))) < 0)
+                    goto fail;
+                if (ff_shuffle_filter_coefficients(c, c->hChrFilterPos, c->hChrFilterSize, c->hChrFilter, c->chrDstW) < 0)
+                    goto nomem;
+            }
         }
     } // initialize horizontal stuff
 
@@ -1713,7 +1748,20 @@ av_cold int ff_sws_init_single_context(SwsContext *sws, SwsFilter *srcFilter,
                        get_local_pos(c, 0, 0, 1),
                        get_local_pos(c, 0, 0, 1))) < 0)
             goto fail;
-        if ((ret = initFilter(&c->vChrFilter, &c->vChrFilterPos, &c->vChrFilterSize,
+        if (c->chrSrcH == srcH && c->chrDstH == dstH &&
+            !(flags & SWS_BICUBLIN) &&
+            srcFilter->chrV == srcFilter->lumV &&
+            dstFilter->chrV == dstFilter->lumV &&
+            get_local_pos(c, c->chrSrcVSubSample, sws->src_v_chr_pos, 1) ==
+                get_local_pos(c, 0, 0, 1) &&
+            get_local_pos(c, c->chrDstVSubSample, sws->dst_v_chr_pos, 1) ==
+                get_local_pos(c, 0, 0, 1)) {
+            /* chroma is scaled exactly like luma, reuse its filter */
+            if (dupFilter(&c->vChrFilter, &c->vChrFilterPos, &c->vChrFilterSize,
+                          c->vLumFilter, c->vLumFilterPos, c->vLumFilterSize,
+                          dstH) < 0)
+                goto nomem;
+        } else if ((ret = initFilter(&c->vChrFilter, &c->vChrFilterPos, &c->vChrFilterSize,
                        c->chrYInc, c->chrSrcH, c->chrDstH,
                        filterAlign, (1 << 12),
                        (flags & SWS_BICUBLIN) ? (flags | SWS_BILINEAR) : flags,
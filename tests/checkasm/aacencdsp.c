@@ -97,6 +97,31 @@ static void test_quant_bands(AACEncDSPContext *s)
     report("quant_bands");
 }
 
+static void test_energy_form_factor(AACEncDSPContext *s)
+{
+    LOCAL_ALIGNED_32(float, in, [BUF_SIZE]);
+
+    declare_func(void, float *, float *, const float *, int);
+
+    randomize_float(in, BUF_SIZE);
+
+    if (check_func(s->energy_form_factor, "energy_form_factor")) {
+        for (int len = 4; len <= 96; len += 4) {
+            float energy0, form0, energy1, form1;
+
+            call_ref(&energy0, &form0, in, len);
+            call_new(&energy1, &form1, in, len);
+
+            if (!float_near_ulp(energy0, energy1, 64) ||
+                !float_near_ulp(form0, form1, 64))
+                fail();
+        }
+        bench_new(&(float){ 0 }, &(float){ 0 }, in, 128);
+    }
+
+    report("energy_form_factor");
+}
+
 void checkasm_check_aacencdsp(void)
 {
     AACEncDSPContext s = { 0 };
@@ -104,4 +129,5 @@ void checkasm_check_aacencdsp(void)
 
     test_abs_pow34(&s);
     test_quant_bands(&s);
+    test_energy_form_factor(&s);
 }
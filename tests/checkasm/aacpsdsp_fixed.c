@@ -0,0 +1,92 @@
+/*
+ * This file is part of Librempeg.
+ *
+ * Librempeg is free software; you can redistribute it and/or modify
+ * it under the terms of the GNU General Public License as published by
+ * the Free Software Foundation; either version 2 of the License, or
+ * (at your option) any later version.
+ *
+ * Librempeg is distributed in the hope that it will be useful,
+ * but WITHOUT ANY WARRANTY; without even the implied warranty of
+ * MERCHANTABILITY or FITNESS FOR A PARTICULAR PURPOSE.  See the
+ * GNU General Public License for more details.
+ *
+ * You should have received a copy of the GNU General Public License along
+ * with FFmpeg; if not, write to the Free Software Foundation, Inc.,
+ * 51 Franklin Street, Fifth Floor, Boston, MA 02110-1301 USA.
+ */
+
+#define USE_FIXED 1
+
+#include <string.h>
+
+#include "libavutil/mem_internal.h"
+
+#include "libavcodec/aacpsdsp.h"
+#include "libavcodec/mathops.h"
+
+#include "checkasm.h"
+
+#define BUF_SIZE 32
+
+/* input headroom so that the C reference never overflows int */
+#define randomize(buf, len) do {                                \
+    int i;                                                      \
+    for (i = 0; i < len; i++)                                   \
+        (buf)[i] = sign_extend(rnd(), 28);                      \
+} while (0)
+
+static void test_add_squares(void)
+{
+    LOCAL_ALIGNED_16(int, dst0, [BUF_SIZE]);
+    LOCAL_ALIGNED_16(int, dst1, [BUF_SIZE]);
+    LOCAL_ALIGNED_16(int, src, [BUF_SIZE], [2]);
+
+    declare_func(void, int *dst,
+                 const int (*src)[2], int n);
+
+    randomize((int *)src, BUF_SIZE * 2);
+    randomize(dst0, BUF_SIZE);
+    memcpy(dst1, dst0, BUF_SIZE * sizeof(int));
+    call_ref(dst0, src, BUF_SIZE);
+    call_new(dst1, src, BUF_SIZE);
+    if (memcmp(dst0, dst1, BUF_SIZE * sizeof(int)))
+        fail();
+    bench_new(dst1, src, BUF_SIZE);
+}
+
+static void test_mul_pair_single(void)
+{
+    LOCAL_ALIGNED_16(int, dst0, [BUF_SIZE], [2]);
+    LOCAL_ALIGNED_16(int, dst1, [BUF_SIZE], [2]);
+    LOCAL_ALIGNED_16(int, src0, [BUF_SIZE], [2]);
+    LOCAL_ALIGNED_16(int, src1, [BUF_SIZE]);
+
+    declare_func(void, int (*dst)[2],
+                       int (*src0)[2], int *src1, int n);
+
+    randomize((int *)src0, BUF_SIZE * 2);
+    /* Q16 gains; products must stay within int after the >>16 */
+    for (int i = 0; i < BUF_SIZE; i++)
+        src1[i] = sign_extend(rnd(), 20);
+    call_ref(dst0, src0, src1, BUF_SIZE);
+    call_new(dst1, src0, src1, BUF_SIZE);
+    if (memcmp(dst0, dst1, BUF_SIZE * 2 * sizeof(int)))
+        fail();
+    bench_new(dst1, src0, src1, BUF_SIZE);
+}
+
+void checkasm_check_aacpsdsp_fixed(void)
+{
+    PSDSPContext psdsp;
+
+    ff_psdsp_init_fixed(&psdsp);
+
+    if (check_func(psdsp.add_squares, "ps_add_squares_fixed"))
+        test_add_squares();
+    report("add_squares");
+
+    if (check_func(psdsp.mul_pair_single, "ps_mul_pair_single_fixed"))
+        test_mul_pair_single();
+    report("mul_pair_single");
+}
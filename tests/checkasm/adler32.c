@@ -0,0 +1,71 @@
+/*
+ * This file is part of FFmpeg.
+ *
+ * FFmpeg is free software; you can redistribute it and/or modify
+ * it under the terms of the GNU General Public License as published by
+ * the Free Software Foundation; either version 2 of the License, or
+ * (at your option) any later version.
+ *
+ * FFmpeg is distributed in the hope that it will be useful,
+ * but WITHOUT ANY WARRANTY; without even the implied warranty of
+ * MERCHANTABILITY or FITNESS FOR A PARTICULAR PURPOSE.  See the
+ * GNU General Public License for more details.
+ *
+ * You should have received a copy of the GNU General Public License along
+ * with FFmpeg; if not, write to the Free Software Foundation, Inc.,
+ * 51 Franklin Street, Fifth Floor, Boston, MA 02110-1301 USA.
+ */
+
+#include <stddef.h>
+#include <stdint.h>
+
+#include "checkasm.h"
+#include "libavutil/attributes.h"
+// Undefine av_pure so that calls to av_adler32_update are not optimized away.
+#undef av_pure
+#define av_pure
+#include "libavutil/adler32.h"
+#include "libavutil/intreadwrite.h"
+#include "libavutil/mem_internal.h"
+
+#define ADLER_BASE 65521
+
+// Plain bytewise implementation used as a reference for the optimized
+// paths inside av_adler32_update().
+static AVAdler adler32_ref(AVAdler adler, const uint8_t *buf, size_t len)
+{
+    uint32_t s1 = adler & 0xffff;
+    uint32_t s2 = adler >> 16;
+
+    for (size_t i = 0; i < len; i++) {
+        s1 = (s1 + buf[i]) % ADLER_BASE;
+        s2 = (s2 + s1)     % ADLER_BASE;
+    }
+    return (s2 << 16) | s1;
+}
+
+void checkasm_check_adler32(void)
+{
+    declare_func(AVAdler, AVAdler adler, const uint8_t *buf, size_t len);
+
+    if (check_func(av_adler32_update, "adler32")) {
+        DECLARE_ALIGNED(4, uint8_t, buf)[8192];
+        AVAdler prev = 1 + (rnd() % ADLER_BASE) + ((rnd() % ADLER_BASE) << 16);
+
+        for (size_t j = 0; j < sizeof(buf); j += 4)
+            AV_WN32A(buf + j, rnd());
+
+        for (int i = 0; i < 32; i++) {
+            size_t offset = rnd() & 31;
+            size_t size   = rnd() % (sizeof(buf) - offset);
+
+            AVAdler res = call_new(prev, buf + offset, size);
+
+            if (res != adler32_ref(prev, buf + offset, size))
+                fail();
+        }
+
+        bench(av_adler32_update, prev, buf, sizeof(buf));
+    }
+    report("adler32");
+}
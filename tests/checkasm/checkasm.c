@@ -126,6 +126,10 @@ static const struct {
     #if CONFIG_AAC_ENCODER
         { "aacencdsp", checkasm_check_aacencdsp },
     #endif
+    #if CONFIG_AAC_FIXED_DECODER
+        { "aacpsdsp_fixed", checkasm_check_aacpsdsp_fixed },
+        { "sbrdsp_fixed",   checkasm_check_sbrdsp_fixed },
+    #endif
     #if CONFIG_AC3DSP
         { "ac3dsp", checkasm_check_ac3dsp },
     #endif
@@ -230,6 +234,9 @@ static const struct {
     #if CONFIG_PIXBLOCKDSP
         { "pixblockdsp", checkasm_check_pixblockdsp },
     #endif
+    #if CONFIG_PNG_DECODER
+        { "pngdsp", checkasm_check_pngdsp },
+    #endif
     #if CONFIG_QPELDSP
         { "qpeldsp", checkasm_check_qpeldsp },
     #endif
@@ -342,11 +349,16 @@ static const struct {
     { "sw_yuv2yuv", checkasm_check_sw_yuv2yuv },
     { "sw_ops", checkasm_check_sw_ops },
 #endif
+#if CONFIG_SWRESAMPLE
+    { "swr_audioconvert", checkasm_check_swr_audioconvert },
+#endif
 #if CONFIG_AVUTIL
+        { "adler32",   checkasm_check_adler32 },
         { "aes",       checkasm_check_aes },
         { "crc",       checkasm_check_crc },
         { "fixed_dsp", checkasm_check_fixed_dsp },
         { "float_dsp", checkasm_check_float_dsp },
+        { "hash",      checkasm_check_hash },
         { "lls",       checkasm_check_lls },
         { "av_tx",     checkasm_check_av_tx },
 #endif
@@ -456,6 +468,7 @@ static struct {
     int cpu_flag;
     const char *cpu_flag_name;
     const char *test_pattern;
+    const char *json_path;
     int verbose;
     int csv;
     int tsv;
@@ -715,6 +728,73 @@ static void print_benchs(CheckasmFunc *f)
     }
 }
 
+/* Get the name of the specified cpu flag */
+static const char *cpu_flag_name(int cpu)
+{
+    int i = FF_ARRAY_ELEMS(cpus);
+
+    while (--i >= 0)
+        if (cpu & cpus[i].flag)
+            return cpus[i].name;
+
+    return "c";
+}
+
+/* Print benchmark results as JSON array entries. Function names only
+ * contain identifier characters, so no string escaping is needed. */
+static void print_benchs_json(FILE *out, const CheckasmFunc *f, int *first)
+{
+    if (f) {
+        const CheckasmFuncVersion *v = &f->versions;
+
+        print_benchs_json(out, f->child[0], first);
+
+        do {
+            const CheckasmPerf *p = &v->perf;
+            if (p->iterations) {
+                fprintf(out,
+                        "%s    { \"name\": \"%s\", \"variant\": \"%s\", "
+                        "\"cpu_flag\": \"%s\", \"cycles\": %.2f, "
+                        "\"raw_cycles\": %" PRIu64 ", \"iterations\": %d }",
+                        *first ? "" : ",\n", f->name, cpu_suffix(v->cpu),
+                        cpu_flag_name(v->cpu), avg_cycles_per_call(p) / 10.0,
+                        p->cycles, p->iterations);
+                *first = 0;
+            }
+        } while ((v = v->next));
+
+        print_benchs_json(out, f->child[1], first);
+    }
+}
+
+/* Write benchmark results and the measurement parameters needed to judge
+ * them to a machine-readable JSON file ("-" for stdout) */
+static int write_benchs_json(const char *path, unsigned int seed)
+{
+    FILE *out = strcmp(path, "-") ? fopen(path, "w") : stdout;
+    int first = 1;
+
+    if (!out) {
+        fprintf(stderr, "checkasm: could not open %s for writing\n", path);
+        return -1;
+    }
+
+    fprintf(out,
+            "{\n"
+            "  \"seed\": %u,\n"
+            "  \"runs\": %" PRIu64 ",\n"
+            "  \"nop_time\": %d,\n"
+            "  \"benchmarks\": [\n", seed, bench_runs, state.nop_time);
+    print_benchs_json(out, state.funcs, &first);
+    fprintf(out, "%s  ]\n}\n", first ? "" : "\n");
+
+    if (out != stdout && fclose(out)) {
+        fprintf(stderr, "checkasm: error writing %s\n", path);
+        return -1;
+    }
+    return 0;
+}
+
 /* ASCIIbetical sort except preserving natural order for numbers */
 static int cmp_func_names(const char *a, const char *b)
 {
@@ -969,6 +1049,7 @@ static int usage(const char *path)
             "  --test=<pattern> Run specific test.\n"
             "  --bench          Run benchmark.\n"
             "  --csv, --tsv     Output results in rows of comma or tab separated values.\n"
+            "  --json=<file>    Write benchmark results as JSON to <file> (\"-\" for stdout).\n"
             "  --runs=<ptwo>    Manual number of benchmark iterations to run 2**<ptwo>.\n"
             "  --verbose        Increase verbosity.\n",
             path);
@@ -1023,6 +1104,8 @@ int main(int argc, char *argv[])
             state.csv = 1; state.tsv = 0;
         } else if (!strcmp(arg, "--tsv")) {
             state.csv = 0; state.tsv = 1;
+        } else if (!strncmp(arg, "--json=", 7)) {
+            state.json_path = arg + 7;
         } else if (!strcmp(arg, "--verbose") || !strcmp(arg, "-v")) {
             state.verbose = 1;
         } else if (!strncmp(arg, "--runs=", 7)) {
@@ -1070,6 +1153,8 @@ int main(int argc, char *argv[])
         fprintf(stderr, "checkasm: all %d tests passed\n", state.num_checked);
         if (state.bench_pattern) {
             print_benchs(state.funcs);
+            if (state.json_path && write_benchs_json(state.json_path, seed) < 0)
+                ret = 1;
         }
     }
 
@@ -79,7 +79,9 @@ typedef sigjmp_buf checkasm_context;
 
 void checkasm_check_aacencdsp(void);
 void checkasm_check_aacpsdsp(void);
+void checkasm_check_aacpsdsp_fixed(void);
 void checkasm_check_ac3dsp(void);
+void checkasm_check_adler32(void);
 void checkasm_check_aes(void);
 void checkasm_check_afir(void);
 void checkasm_check_alacdsp(void);
@@ -108,6 +110,7 @@ void checkasm_check_h264chroma(void);
 void checkasm_check_h264dsp(void);
 void checkasm_check_h264pred(void);
 void checkasm_check_h264qpel(void);
+void checkasm_check_hash(void);
 void checkasm_check_hevc_add_res(void);
 void checkasm_check_hevc_deblock(void);
 void checkasm_check_hevc_idct(void);
@@ -129,8 +132,10 @@ void checkasm_check_mpegvideoencdsp(void);
 void checkasm_check_nlmeans(void);
 void checkasm_check_opusdsp(void);
 void checkasm_check_pixblockdsp(void);
+void checkasm_check_pngdsp(void);
 void checkasm_check_qpeldsp(void);
 void checkasm_check_sbrdsp(void);
+void checkasm_check_sbrdsp_fixed(void);
 void checkasm_check_rv34dsp(void);
 void checkasm_check_rv40dsp(void);
 void checkasm_check_scene_sad(void);
@@ -144,6 +149,7 @@ void checkasm_check_sw_xyz2rgb(void);
 void checkasm_check_sw_yuv2rgb(void);
 void checkasm_check_sw_yuv2yuv(void);
 void checkasm_check_sw_ops(void);
+void checkasm_check_swr_audioconvert(void);
 void checkasm_check_takdsp(void);
 void checkasm_check_utvideodsp(void);
 void checkasm_check_v210dec(void);
@@ -141,14 +141,21 @@ static void test_vector_fmul_window(const float *src0, const float *src1, const
     declare_func(void, float *dst, const float *src0, const float *src1,
                  const float *win, int len);
 
-    call_ref(cdst, src0, src1, win, LEN / 2);
-    call_new(odst, src0, src1, win, LEN / 2);
-    for (i = 0; i < LEN; i++) {
-        if (!float_near_abs_eps(cdst[i], odst[i], ARBITRARY_FMUL_WINDOW_CONST)) {
-            fprintf(stderr, "%d: %- .12f - %- .12f = % .12g\n",
-                    i, cdst[i], odst[i], cdst[i] - odst[i]);
-            fail();
-            break;
+    /* also test lengths that are only a multiple of 4, as used by CELT */
+    static const int lens[] = { LEN / 2, 60, 4 };
+
+    for (size_t l = 0; l < FF_ARRAY_ELEMS(lens); l++) {
+        const int len = lens[l];
+
+        call_ref(cdst, src0, src1, win, len);
+        call_new(odst, src0, src1, win, len);
+        for (i = 0; i < 2 * len; i++) {
+            if (!float_near_abs_eps(cdst[i], odst[i], ARBITRARY_FMUL_WINDOW_CONST)) {
+                fprintf(stderr, "%d: %- .12f - %- .12f = % .12g\n",
+                        i, cdst[i], odst[i], cdst[i] - odst[i]);
+                fail();
+                break;
+            }
         }
     }
     bench_new(odst, src0, src1, win, LEN / 2);
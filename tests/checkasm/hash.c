@@ -0,0 +1,77 @@
+/*
+ * This file is part of FFmpeg.
+ *
+ * FFmpeg is free software; you can redistribute it and/or modify
+ * it under the terms of the GNU General Public License as published by
+ * the Free Software Foundation; either version 2 of the License, or
+ * (at your option) any later version.
+ *
+ * FFmpeg is distributed in the hope that it will be useful,
+ * but WITHOUT ANY WARRANTY; without even the implied warranty of
+ * MERCHANTABILITY or FITNESS FOR A PARTICULAR PURPOSE.  See the
+ * GNU General Public License for more details.
+ *
+ * You should have received a copy of the GNU General Public License along
+ * with FFmpeg; if not, write to the Free Software Foundation, Inc.,
+ * 51 Franklin Street, Fifth Floor, Boston, MA 02110-1301 USA.
+ */
+
+#include <stddef.h>
+#include <stdint.h>
+#include <string.h>
+
+#include "checkasm.h"
+#include "libavutil/avassert.h"
+#include "libavutil/hash.h"
+#include "libavutil/intreadwrite.h"
+#include "libavutil/mem_internal.h"
+
+#define BUF_SIZE 4096
+
+static void check_hash(const char *name)
+{
+    declare_func(void, struct AVHashContext *ctx, const uint8_t *src, size_t len);
+
+    if (check_func(av_hash_update, "hash_%s", name)) {
+        DECLARE_ALIGNED(4, uint8_t, buf)[BUF_SIZE];
+        uint8_t digest_whole[AV_HASH_MAX_SIZE];
+        uint8_t digest_split[AV_HASH_MAX_SIZE];
+        struct AVHashContext *ctx;
+        size_t pos = 0;
+
+        av_assert0(av_hash_alloc(&ctx, name) >= 0);
+
+        for (size_t j = 0; j < sizeof(buf); j += 4)
+            AV_WN32A(buf + j, rnd());
+
+        /* hashing in arbitrary chunks must match hashing in one call */
+        av_hash_init(ctx);
+        call_new(ctx, buf, sizeof(buf));
+        av_hash_final(ctx, digest_whole);
+
+        av_hash_init(ctx);
+        while (pos < sizeof(buf)) {
+            size_t chunk = FFMIN(1 + (rnd() & 255), sizeof(buf) - pos);
+            av_hash_update(ctx, buf + pos, chunk);
+            pos += chunk;
+        }
+        av_hash_final(ctx, digest_split);
+
+        if (memcmp(digest_whole, digest_split, av_hash_get_size(ctx)))
+            fail();
+
+        av_hash_init(ctx);
+        bench(av_hash_update, ctx, buf, sizeof(buf));
+
+        av_hash_freep(&ctx);
+    }
+}
+
+void checkasm_check_hash(void)
+{
+    const char *name;
+
+    for (int i = 0; (name = av_hash_names(i)); i++)
+        check_hash(name);
+    report("hash");
+}
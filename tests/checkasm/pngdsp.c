@@ -0,0 +1,112 @@
+/*
+ * This file is part of Librempeg
+ *
+ * Librempeg is free software; you can redistribute it and/or modify
+ * it under the terms of the GNU General Public License as published by
+ * the Free Software Foundation; either version 2 of the License, or
+ * (at your option) any later version.
+ *
+ * Librempeg is distributed in the hope that it will be useful,
+ * but WITHOUT ANY WARRANTY; without even the implied warranty of
+ * MERCHANTABILITY or FITNESS FOR A PARTICULAR PURPOSE.  See the
+ * GNU General Public License for more details.
+ *
+ * You should have received a copy of the GNU General Public License along
+ * with Librempeg; if not, write to the Free Software Foundation, Inc.,
+ * 51 Franklin Street, Fifth Floor, Boston, MA 02110-1301 USA.
+ */
+
+#include <string.h>
+
+#include "libavutil/mem_internal.h"
+
+#include "libavcodec/pngdsp.h"
+
+#include "checkasm.h"
+
+#define BUF_SIZE 512
+
+#define randomize_buffers(buf, size)         \
+    do {                                     \
+        for (int j = 0; j < size; j++)       \
+            buf[j] = rnd() & 0xFF;           \
+    } while (0)
+
+static void check_add_bytes_l2(PNGDSPContext *dsp)
+{
+    LOCAL_ALIGNED_16(uint8_t, src1, [BUF_SIZE]);
+    LOCAL_ALIGNED_16(uint8_t, src2, [BUF_SIZE]);
+    LOCAL_ALIGNED_16(uint8_t, dst0, [BUF_SIZE]);
+    LOCAL_ALIGNED_16(uint8_t, dst1, [BUF_SIZE]);
+
+    declare_func(void, uint8_t *dst, const uint8_t *src1,
+                 const uint8_t *src2, int w);
+
+    randomize_buffers(src1, BUF_SIZE);
+    randomize_buffers(src2, BUF_SIZE);
+
+    if (check_func(dsp->add_bytes_l2, "add_bytes_l2")) {
+        for (int w = 1; w <= BUF_SIZE; w <<= 1) {
+            memset(dst0, 0, BUF_SIZE);
+            memset(dst1, 0, BUF_SIZE);
+            call_ref(dst0, src1, src2, w);
+            call_new(dst1, src1, src2, w);
+            if (memcmp(dst0, dst1, w))
+                fail();
+        }
+        bench_new(dst1, src1, src2, BUF_SIZE);
+    }
+
+    report("add_bytes_l2");
+}
+
+static void check_add_paeth_prediction(PNGDSPContext *dsp)
+{
+    /* add_paeth_prediction is allowed to write past w */
+    LOCAL_ALIGNED_16(uint8_t, src,  [BUF_SIZE + 8]);
+    LOCAL_ALIGNED_16(uint8_t, top,  [BUF_SIZE + 8]);
+    LOCAL_ALIGNED_16(uint8_t, dst0, [BUF_SIZE + 8]);
+    LOCAL_ALIGNED_16(uint8_t, dst1, [BUF_SIZE + 8]);
+    /* the decoder only hands rows with more than 2 bytes per pixel
+     * to the dsp function */
+    static const int bpps[] = { 3, 4, 6, 8 };
+
+    declare_func(void, uint8_t *dst, const uint8_t *src,
+                 const uint8_t *top, int w, int bpp);
+
+    randomize_buffers(src, BUF_SIZE + 8);
+    randomize_buffers(top, BUF_SIZE + 8);
+
+    for (int i = 0; i < FF_ARRAY_ELEMS(bpps); i++) {
+        const int bpp = bpps[i];
+
+        if (check_func(dsp->add_paeth_prediction, "add_paeth_prediction_bpp%d", bpp)) {
+            const int w = BUF_SIZE - (BUF_SIZE % bpp);
+
+            memset(dst0, 0, BUF_SIZE + 8);
+            memset(dst1, 0, BUF_SIZE + 8);
+            /* the first pixel is predicted from the top row only and
+             * handled by the caller, the dsp function continues the row */
+            memcpy(dst0, top, bpp);
+            memcpy(dst1, top, bpp);
+            call_ref(dst0 + bpp, src + bpp, top + bpp, w - bpp, bpp);
+            call_new(dst1 + bpp, src + bpp, top + bpp, w - bpp, bpp);
+            if (memcmp(dst0, dst1, w))
+                fail();
+
+            bench_new(dst1 + bpp, src + bpp, top + bpp, w - bpp, bpp);
+        }
+    }
+
+    report("add_paeth_prediction");
+}
+
+void checkasm_check_pngdsp(void)
+{
+    PNGDSPContext dsp;
+
+    ff_pngdsp_init(&dsp);
+
+    check_add_bytes_l2(&dsp);
+    check_add_paeth_prediction(&dsp);
+}
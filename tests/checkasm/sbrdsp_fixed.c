@@ -0,0 +1,167 @@
+/*
+ * This file is part of Librempeg.
+ *
+ * Librempeg is free software; you can redistribute it and/or modify
+ * it under the terms of the GNU General Public License as published by
+ * the Free Software Foundation; either version 2 of the License, or
+ * (at your option) any later version.
+ *
+ * Librempeg is distributed in the hope that it will be useful,
+ * but WITHOUT ANY WARRANTY; without even the implied warranty of
+ * MERCHANTABILITY or FITNESS FOR A PARTICULAR PURPOSE.  See the
+ * GNU General Public License for more details.
+ *
+ * You should have received a copy of the GNU General Public License along
+ * with FFmpeg; if not, write to the Free Software Foundation, Inc.,
+ * 51 Franklin Street, Fifth Floor, Boston, MA 02110-1301 USA.
+ */
+
+#define USE_FIXED 1
+
+#include <string.h>
+
+#include "libavutil/mem_internal.h"
+
+#include "libavcodec/mathops.h"
+#include "libavcodec/sbrdsp.h"
+
+#include "checkasm.h"
+
+/* input headroom so that the C reference never overflows int */
+#define randomize(buf, len) do {                                \
+    int i;                                                      \
+    for (i = 0; i < len; i++)                                   \
+        (buf)[i] = sign_extend(rnd(), 28);                      \
+} while (0)
+
+static void test_sum64x5(void)
+{
+    LOCAL_ALIGNED_16(int, dst0, [64 + 256]);
+    LOCAL_ALIGNED_16(int, dst1, [64 + 256]);
+
+    declare_func(void, int *z);
+
+    randomize(dst0, 64 + 256);
+    memcpy(dst1, dst0, (64 + 256) * sizeof(int));
+    call_ref(dst0);
+    call_new(dst1);
+    if (memcmp(dst0, dst1, (64 + 256) * sizeof(int)))
+        fail();
+    bench_new(dst1);
+}
+
+static void test_neg_odd_64(void)
+{
+    LOCAL_ALIGNED_16(int, dst0, [64]);
+    LOCAL_ALIGNED_16(int, dst1, [64]);
+
+    declare_func(void, int *x);
+
+    randomize(dst0, 64);
+    memcpy(dst1, dst0, (64) * sizeof(int));
+    call_ref(dst0);
+    call_new(dst1);
+    if (memcmp(dst0, dst1, (64) * sizeof(int)))
+        fail();
+    bench_new(dst1);
+}
+
+static void test_qmf_pre_shuffle(void)
+{
+    LOCAL_ALIGNED_16(int, dst0, [128]);
+    LOCAL_ALIGNED_16(int, dst1, [128]);
+
+    declare_func(void, int *z);
+
+    randomize(dst0, 128);
+    memcpy(dst1, dst0, (128) * sizeof(int));
+    call_ref(dst0);
+    call_new(dst1);
+    if (memcmp(dst0, dst1, (128) * sizeof(int)))
+        fail();
+    bench_new(dst1);
+}
+
+static void test_qmf_post_shuffle(void)
+{
+    LOCAL_ALIGNED_16(int, src, [64]);
+    LOCAL_ALIGNED_16(int, dst0, [32], [2]);
+    LOCAL_ALIGNED_16(int, dst1, [32], [2]);
+
+    declare_func(void, int W[32][2], const int *z);
+
+    randomize(src, 64);
+    call_ref(dst0, src);
+    call_new(dst1, src);
+    if (memcmp(dst0, dst1, 32 * 2 * sizeof(int)))
+        fail();
+    bench_new(dst1, src);
+}
+
+static void test_qmf_deint_neg(void)
+{
+    LOCAL_ALIGNED_16(int, src, [64]);
+    LOCAL_ALIGNED_16(int, dst0, [64]);
+    LOCAL_ALIGNED_16(int, dst1, [64]);
+
+    declare_func(void, int *v, const int *src);
+
+    randomize(src, 64);
+    call_ref(dst0, src);
+    call_new(dst1, src);
+    if (memcmp(dst0, dst1, (64) * sizeof(int)))
+        fail();
+    bench_new(dst1, src);
+}
+
+static void test_qmf_deint_bfly(void)
+{
+    LOCAL_ALIGNED_16(int, src0, [64]);
+    LOCAL_ALIGNED_16(int, src1, [64]);
+    LOCAL_ALIGNED_16(int, dst0, [128]);
+    LOCAL_ALIGNED_16(int, dst1, [128]);
+
+    declare_func(void, int *v, const int *src0, const int *src1);
+
+    memset(dst0, 0, 128 * sizeof(int));
+    memset(dst1, 0, 128 * sizeof(int));
+
+    randomize(src0, 64);
+    randomize(src1, 64);
+    call_ref(dst0, src0, src1);
+    call_new(dst1, src0, src1);
+    if (memcmp(dst0, dst1, (128) * sizeof(int)))
+        fail();
+    bench_new(dst1, src0, src1);
+}
+
+void checkasm_check_sbrdsp_fixed(void)
+{
+    SBRDSPContext sbrdsp;
+
+    ff_sbrdsp_init_fixed(&sbrdsp);
+
+    if (check_func(sbrdsp.sum64x5, "sum64x5_fixed"))
+        test_sum64x5();
+    report("sum64x5");
+
+    if (check_func(sbrdsp.neg_odd_64, "neg_odd_64_fixed"))
+        test_neg_odd_64();
+    report("neg_odd_64");
+
+    if (check_func(sbrdsp.qmf_pre_shuffle, "qmf_pre_shuffle_fixed"))
+        test_qmf_pre_shuffle();
+    report("qmf_pre_shuffle");
+
+    if (check_func(sbrdsp.qmf_post_shuffle, "qmf_post_shuffle_fixed"))
+        test_qmf_post_shuffle();
+    report("qmf_post_shuffle");
+
+    if (check_func(sbrdsp.qmf_deint_neg, "qmf_deint_neg_fixed"))
+        test_qmf_deint_neg();
+    report("qmf_deint_neg");
+
+    if (check_func(sbrdsp.qmf_deint_bfly, "qmf_deint_bfly_fixed"))
+        test_qmf_deint_bfly();
+    report("qmf_deint_bfly");
+}
@@ -0,0 +1,106 @@
+/*
+ * This file is part of Librempeg.
+ *
+ * Librempeg is free software; you can redistribute it and/or modify
+ * it under the terms of the GNU General Public License as published by
+ * the Free Software Foundation; either version 2 of the License, or
+ * (at your option) any later version.
+ *
+ * Librempeg is distributed in the hope that it will be useful,
+ * but WITHOUT ANY WARRANTY; without even the implied warranty of
+ * MERCHANTABILITY or FITNESS FOR A PARTICULAR PURPOSE.  See the
+ * GNU General Public License for more details.
+ *
+ * You should have received a copy of the GNU General Public License along
+ * with FFmpeg; if not, write to the Free Software Foundation, Inc.,
+ * 51 Franklin Street, Fifth Floor, Boston, MA 02110-1301 USA.
+ */
+
+#include <stdint.h>
+#include <string.h>
+
+#include "libavutil/common.h"
+#include "libavutil/mem_internal.h"
+#include "libavutil/samplefmt.h"
+
+#include "libswresample/audioconvert.h"
+
+#include "checkasm.h"
+
+#define BUF_SIZE 1024
+
+static void randomize_input(uint8_t *buf, enum AVSampleFormat fmt)
+{
+    switch (av_get_packed_sample_fmt(fmt)) {
+    case AV_SAMPLE_FMT_S16: {
+        int16_t *p = (int16_t *)buf;
+        for (int k = 0; k < BUF_SIZE; k++)
+            p[k] = rnd();
+        break;
+    }
+    case AV_SAMPLE_FMT_S32: {
+        int32_t *p = (int32_t *)buf;
+        for (int k = 0; k < BUF_SIZE; k++)
+            p[k] = rnd();
+        break;
+    }
+    case AV_SAMPLE_FMT_FLT: {
+        float *p = (float *)buf;
+        /* overshoot full scale a little so the clipping paths are hit */
+        for (int k = 0; k < BUF_SIZE; k++)
+            p[k] = (int32_t)rnd() * (1.1f / INT32_MAX);
+        break;
+    }
+    case AV_SAMPLE_FMT_DBL: {
+        double *p = (double *)buf;
+        for (int k = 0; k < BUF_SIZE; k++)
+            p[k] = (int32_t)rnd() * (1.1 / INT32_MAX);
+        break;
+    }
+    }
+}
+
+void checkasm_check_swr_audioconvert(void)
+{
+    static const enum AVSampleFormat fmts[] = {
+        AV_SAMPLE_FMT_S16P, AV_SAMPLE_FMT_S32P,
+        AV_SAMPLE_FMT_FLTP, AV_SAMPLE_FMT_DBLP,
+    };
+    LOCAL_ALIGNED(32, uint8_t, in,   [BUF_SIZE * 8]);
+    LOCAL_ALIGNED(32, uint8_t, dst0, [BUF_SIZE * 8]);
+    LOCAL_ALIGNED(32, uint8_t, dst1, [BUF_SIZE * 8]);
+
+    for (int i = 0; i < FF_ARRAY_ELEMS(fmts); i++) {
+        for (int j = 0; j < FF_ARRAY_ELEMS(fmts); j++) {
+            AudioConvert *ctx;
+
+            if (i == j)
+                continue;
+            ctx = swri_audio_convert_alloc(fmts[j], fmts[i], 1, NULL, 0);
+            if (!ctx)
+                continue;
+            if (ctx->simd_f &&
+                check_func(ctx->simd_f, "audioconvert_%s_to_%s",
+                           av_get_sample_fmt_name(av_get_packed_sample_fmt(fmts[i])),
+                           av_get_sample_fmt_name(av_get_packed_sample_fmt(fmts[j])))) {
+                uint8_t *d0 = dst0, *d1 = dst1;
+                const uint8_t *s = in;
+                declare_func(void, uint8_t **, const uint8_t **, int);
+
+                randomize_input(in, fmts[i]);
+                memset(dst0, 0, BUF_SIZE * 8);
+                memset(dst1, 0, BUF_SIZE * 8);
+
+                call_ref(&d0, &s, BUF_SIZE);
+                call_new(&d1, &s, BUF_SIZE);
+
+                if (memcmp(dst0, dst1, BUF_SIZE * av_get_bytes_per_sample(fmts[j])))
+                    fail();
+
+                bench_new(&d1, &s, BUF_SIZE);
+            }
+            swri_audio_convert_free(&ctx);
+        }
+    }
+    report("audioconvert");
+}
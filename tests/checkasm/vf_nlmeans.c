@@ -18,6 +18,8 @@
  * 51 Franklin Street, Fifth Floor, Boston, MA 02110-1301 USA.
  */
 
+#include <math.h>
+
 #include "checkasm.h"
 #include "libavfilter/vf_nlmeans_init.h"
 #include "libavutil/avassert.h"
@@ -110,5 +112,69 @@ void checkasm_check_nlmeans(void)
         av_freep(&src);
     }
 
+    if (check_func(dsp.compute_weights_line, "compute_weights_line")) {
+        const int max_meaningful_diff = 512;
+        // SIMD versions process up to a whole register of pixels past endx,
+        // so leave readable/writable padding after the line
+        const int buf_w = FFALIGN(w, 16) + 16;
+        uint32_t *iia = av_malloc_array(buf_w, sizeof(*iia));
+        uint32_t *iib = av_malloc_array(buf_w, sizeof(*iib));
+        uint32_t *iid = av_malloc_array(buf_w, sizeof(*iid));
+        uint32_t *iie = av_malloc_array(buf_w, sizeof(*iie));
+        uint8_t *src = av_malloc(buf_w);
+        float *total_ref = av_malloc_array(buf_w, sizeof(*total_ref));
+        float *total_new = av_malloc_array(buf_w, sizeof(*total_new));
+        float *sum_ref = av_malloc_array(buf_w, sizeof(*sum_ref));
+        float *sum_new = av_malloc_array(buf_w, sizeof(*sum_new));
+        float *weight_lut = av_calloc(max_meaningful_diff + 1, sizeof(*weight_lut));
+
+        declare_func(void, const uint32_t *const iia, const uint32_t *const iib,
+                     const uint32_t *const iid, const uint32_t *const iie,
+                     const uint8_t *const src, float *total_weight, float *sum,
+                     const float *const weight_lut, int max_meaningful_diff,
+                     int startx, int endx);
+
+        /* the filter leaves the last entry at 0 so that the out-of-range
+         * pixels processed by the SIMD versions do not contribute */
+        for (int i = 0; i < max_meaningful_diff; i++)
+            weight_lut[i] = exp(-i / 300.);
+
+        for (int i = 0; i < buf_w; i++) {
+            iia[i] = rnd() % 256;
+            iib[i] = rnd() % 128;
+            iid[i] = rnd() % 128;
+            iie[i] = rnd() % 512;
+            src[i] = rnd();
+            total_ref[i] = total_new[i] = (rnd() & 0xfff) / 256.f;
+            sum_ref[i]   = sum_new[i]   = (rnd() & 0xfff) / 256.f;
+        }
+
+        for (int startx = 0; startx < 4; startx++) {
+            const int endx = w - (rnd() % 8);
+
+            call_ref(iia, iib, iid, iie, src, total_ref, sum_ref,
+                     weight_lut, max_meaningful_diff, startx, endx);
+            call_new(iia, iib, iid, iie, src, total_new, sum_new,
+                     weight_lut, max_meaningful_diff, startx, endx);
+
+            if (!float_near_abs_eps_array(total_ref, total_new, 1e-3, buf_w) ||
+                !float_near_abs_eps_array(sum_ref, sum_new, 1e-1, buf_w))
+                fail();
+        }
+        bench_new(iia, iib, iid, iie, src, total_new, sum_new,
+                  weight_lut, max_meaningful_diff, 0, w);
+
+        av_freep(&iia);
+        av_freep(&iib);
+        av_freep(&iid);
+        av_freep(&iie);
+        av_freep(&src);
+        av_freep(&total_ref);
+        av_freep(&total_new);
+        av_freep(&sum_ref);
+        av_freep(&sum_new);
+        av_freep(&weight_lut);
+    }
+
     report("dsp");
 }
@@ -680,6 +680,43 @@ venc_data(){
     run tools/venc_data_dump${EXECSUF} ${file} ${stream} ${frames} ${threads} ${thread_type}
 }
 
+# Time a conversion with ffmpeg's -benchmark timers and compare the user
+# time against a stored baseline. The best of FATE_PERF_RUNS runs counts;
+# a run slower than the baseline by more than FATE_PERF_TOLERANCE percent
+# fails the test. A missing baseline (or FATE_PERF_UPDATE=1) records the
+# measured time instead of comparing.
+perf(){
+    benchfile="${outdir}/${test}.bench"
+    cleanfiles="$cleanfiles $benchfile"
+    baseline="${FATE_PERF_DB:-tests/data/perf}/${test}"
+    tolerance=${FATE_PERF_TOLERANCE:-15}
+    runs=${FATE_PERF_RUNS:-3}
+    best=
+    i=1
+    while [ $i -le $runs ]; do
+        ffmpeg -benchmark "$@" -f null - 2>"$benchfile" || { cat "$benchfile"; return 1; }
+        t=$(sed -n 's/^bench: utime=\([0-9.]*\)s.*/\1/p' "$benchfile")
+        if [ -z "$t" ]; then
+            echo "no benchmark data in ffmpeg output"
+            return 1
+        fi
+        best=$(awk "BEGIN { b = \"$best\"; print (b == \"\" || $t < b) ? $t : b }" < /dev/null)
+        i=$(($i + 1))
+    done
+    if [ "${FATE_PERF_UPDATE:-0}" != 0 ] || ! [ -e "$baseline" ]; then
+        mkdir -p "$(dirname $baseline)"
+        echo "$best" > "$baseline" || return
+        echo "recorded baseline utime ${best}s"
+    else
+        expected=$(cat "$baseline")
+        echo "utime ${best}s, baseline ${expected}s, tolerance ${tolerance}%"
+        if [ "$(awk "BEGIN { print ($best > $expected * (100 + $tolerance) / 100) }" < /dev/null)" != 0 ]; then
+            echo "performance regression: exceeds baseline by more than ${tolerance}%"
+            return 1
+        fi
+    fi
+}
+
 null(){
     :
 }
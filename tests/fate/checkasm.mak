@@ -1,6 +1,8 @@
 FATE_CHECKASM = fate-checkasm-aacencdsp                                 \
                 fate-checkasm-aacpsdsp                                  \
+                fate-checkasm-aacpsdsp_fixed                            \
                 fate-checkasm-ac3dsp                                    \
+                fate-checkasm-adler32                                   \
                 fate-checkasm-aes                                       \
                 fate-checkasm-af_afir                                   \
                 fate-checkasm-alacdsp                                   \
@@ -25,6 +27,7 @@ FATE_CHECKASM = fate-checkasm-aacencdsp                                 \
                 fate-checkasm-h264dsp                                   \
                 fate-checkasm-h264pred                                  \
                 fate-checkasm-h264qpel                                  \
+                fate-checkasm-hash                                      \
                 fate-checkasm-hevc_add_res                              \
                 fate-checkasm-hevc_deblock                              \
                 fate-checkasm-hevc_idct                                 \
@@ -46,6 +49,7 @@ FATE_CHECKASM = fate-checkasm-aacencdsp                                 \
                 fate-checkasm-pixblockdsp                               \
                 fate-checkasm-qpeldsp                                   \
                 fate-checkasm-sbrdsp                                    \
+                fate-checkasm-sbrdsp_fixed                              \
                 fate-checkasm-rv34dsp                                   \
                 fate-checkasm-rv40dsp                                   \
                 fate-checkasm-scene_sad                                 \
@@ -31,6 +31,10 @@ FATE_LIBAVUTIL += fate-audio_fifo
 fate-audio_fifo: libavutil/tests/audio_fifo$(EXESUF)
 fate-audio_fifo: CMD = run libavutil/tests/audio_fifo$(EXESUF)
 
+FATE_LIBAVUTIL += fate-audio_frame_fifo
+fate-audio_frame_fifo: libavutil/tests/audio_frame_fifo$(EXESUF)
+fate-audio_frame_fifo: CMD = run libavutil/tests/audio_frame_fifo$(EXESUF)
+
 FATE_LIBAVUTIL += fate-avstring
 fate-avstring: libavutil/tests/avstring$(EXESUF)
 fate-avstring: CMD = run libavutil/tests/avstring$(EXESUF)
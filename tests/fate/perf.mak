@@ -0,0 +1,15 @@
+# Performance tests: these time conversions with ffmpeg's -benchmark
+# timers instead of verifying output, comparing the user time against
+# per-machine baselines stored under $(FATE_PERF_DB) (default
+# tests/data/perf); the first run records the baseline. They are only
+# run by the fate-perf target, never by a plain fate run, and are only
+# meaningful on an otherwise idle, ideally pinned, CPU.
+
+FATE_PERF-$(call ALLYES, LAVFI_INDEV TESTSRC2_FILTER SCALE_FILTER NULL_MUXER) += fate-perf-scale
+fate-perf-scale: CMD = perf -f lavfi -i testsrc2=size=1280x720:rate=25:duration=10 -vf scale=640x360,format=yuv420p
+
+FATE_PERF-$(call ALLYES, LAVFI_INDEV SINE_FILTER AAC_ENCODER NULL_MUXER) += fate-perf-aac-enc
+fate-perf-aac-enc: CMD = perf -f lavfi -i sine=frequency=440:sample_rate=44100:duration=30 -c:a aac -b:a 128k
+
+FATE_PERF_SAMPLES-$(call ALLYES, MOV_DEMUXER H264_DECODER NULL_MUXER) += fate-perf-h264-dec
+fate-perf-h264-dec: CMD = perf -i $(TARGET_SAMPLES)/h264/interlaced_crop.mp4
@@ -0,0 +1,71 @@
+#!/usr/bin/env python3
+
+import argparse
+import json
+import sys
+
+HELP = '''
+Compare two checkasm benchmark runs.
+
+Both inputs must be JSON files produced by checkasm --bench --json=<file>.
+Benchmarked functions are matched by name and cpu variant, and any change
+in cycles per call beyond the noise threshold is reported. The exit code
+is non-zero when at least one regression is found, so the script can gate
+automated builds.
+'''
+
+
+def load(path):
+    with open(path) as f:
+        data = json.load(f)
+    return {(b['name'], b['variant']): b for b in data['benchmarks']}
+
+
+def main():
+    parser = argparse.ArgumentParser(
+        description=HELP, formatter_class=argparse.RawDescriptionHelpFormatter)
+    parser.add_argument('before', help='baseline JSON report')
+    parser.add_argument('after', help='new JSON report')
+    parser.add_argument('--threshold', type=float, default=5.0,
+                        help='relative change considered noise, in percent (default: 5)')
+    parser.add_argument('--min-cycles', type=float, default=10.0,
+                        help='ignore functions faster than this many cycles per call (default: 10)')
+    parser.add_argument('--all', action='store_true',
+                        help='print unchanged functions too')
+    args = parser.parse_args()
+
+    before = load(args.before)
+    after = load(args.after)
+
+    regressions = improvements = 0
+    for key in sorted(before.keys() & after.keys()):
+        old = before[key]['cycles']
+        new = after[key]['cycles']
+        if old < args.min_cycles and new < args.min_cycles:
+            continue
+        change = (new - old) / old * 100.0 if old else float('inf')
+        if abs(change) < args.threshold:
+            if args.all:
+                print('          %s_%s: %.1f -> %.1f (%+.1f%%)'
+                      % (*key, old, new, change))
+            continue
+        if change > 0:
+            regressions += 1
+            tag = 'SLOWER'
+        else:
+            improvements += 1
+            tag = 'faster'
+        print('%-8s  %s_%s: %.1f -> %.1f (%+.1f%%)' % (tag, *key, old, new, change))
+
+    for key in sorted(before.keys() - after.keys()):
+        print('removed   %s_%s' % key)
+    for key in sorted(after.keys() - before.keys()):
+        print('added     %s_%s' % key)
+
+    print('%d regression(s), %d improvement(s), %d function(s) compared'
+          % (regressions, improvements, len(before.keys() & after.keys())))
+    return 1 if regressions else 0
+
+
+if __name__ == '__main__':
+    sys.exit(main())
@@ -0,0 +1,244 @@
+/*
+ * This file is part of Librempeg
+ *
+ * Librempeg is free software; you can redistribute it and/or modify
+ * it under the terms of the GNU General Public License as published by
+ * the Free Software Foundation; either version 3 of the License, or
+ * (at your option) any later version.
+ *
+ * Librempeg is distributed in the hope that it will be useful,
+ * but WITHOUT ANY WARRANTY; without even the implied warranty of
+ * MERCHANTABILITY or FITNESS FOR A PARTICULAR PURPOSE.  See the
+ * GNU General Public License for more details.
+ *
+ * You should have received a copy of the GNU General Public License along
+ * with Librempeg; if not, write to the Free Software Foundation, Inc.,
+ * 51 Franklin Street, Fifth Floor, Boston, MA 02110-1301 USA.
+ */
+
+/*
+ * Whole-decoder throughput benchmark, the full-decoder counterpart to
+ * the per-function benchmarks in checkasm. The input is demuxed into
+ * memory up front, so the timed loop measures only the decoder; the
+ * result is printed as one key=value line per run for easy consumption
+ * by CI scripts.
+ */
+
+#include <stdio.h>
+#include <stdlib.h>
+#include <string.h>
+#include <time.h>
+
+#include "libavcodec/avcodec.h"
+
+#include "libavformat/avformat.h"
+
+#include "libavutil/error.h"
+#include "libavutil/frame.h"
+#include "libavutil/mem.h"
+#include "libavutil/time.h"
+#include "libavutil/timer.h"
+
+static int drain_frames(AVCodecContext *dec, AVFrame *frame, int64_t *nb_frames)
+{
+    int ret;
+
+    while ((ret = avcodec_receive_frame(dec, frame)) >= 0) {
+        (*nb_frames)++;
+        av_frame_unref(frame);
+    }
+    return ret == AVERROR(EAGAIN) || ret == AVERROR_EOF ? 0 : ret;
+}
+
+static int run_once(const AVCodec *codec, const AVCodecParameters *par,
+                    AVPacket **pkts, int nb_pkts, int threads, int run)
+{
+    AVCodecContext *dec = NULL;
+    AVFrame *frame = NULL;
+    int64_t nb_frames = 0;
+    int64_t wall;
+    clock_t cpu;
+#ifdef AV_READ_TIME
+    uint64_t cycles;
+#endif
+    int ret;
+
+    dec = avcodec_alloc_context3(codec);
+    frame = av_frame_alloc();
+    if (!dec || !frame) {
+        ret = AVERROR(ENOMEM);
+        goto fail;
+    }
+
+    ret = avcodec_parameters_to_context(dec, par);
+    if (ret < 0)
+        goto fail;
+    dec->thread_count = threads;
+
+    ret = avcodec_open2(dec, NULL, NULL);
+    if (ret < 0) {
+        fprintf(stderr, "Error opening decoder: %s\n", av_err2str(ret));
+        goto fail;
+    }
+
+    wall = av_gettime_relative();
+    cpu  = clock();
+#ifdef AV_READ_TIME
+    cycles = AV_READ_TIME();
+#endif
+
+    for (int i = 0; i < nb_pkts; i++) {
+        ret = avcodec_send_packet(dec, pkts[i]);
+        if (ret < 0) {
+            fprintf(stderr, "Error decoding: %s\n", av_err2str(ret));
+            goto fail;
+        }
+        ret = drain_frames(dec, frame, &nb_frames);
+        if (ret < 0)
+            goto fail;
+    }
+    ret = avcodec_send_packet(dec, NULL);
+    if (ret >= 0)
+        ret = drain_frames(dec, frame, &nb_frames);
+    if (ret < 0)
+        goto fail;
+
+#ifdef AV_READ_TIME
+    cycles = AV_READ_TIME() - cycles;
+#endif
+    cpu  = clock() - cpu;
+    wall = av_gettime_relative() - wall;
+
+    if (!nb_frames || !wall) {
+        fprintf(stderr, "Nothing was decoded\n");
+        ret = AVERROR(EINVAL);
+        goto fail;
+    }
+
+    printf("decode_bench: run=%d codec=%s threads=%d frames=%"PRId64
+           " wall_ms=%.1f cpu_ms=%.1f fps=%.2f cpu_util=%.3f",
+           run, codec->name, dec->thread_count, nb_frames,
+           wall / 1000.0, cpu * 1000.0 / CLOCKS_PER_SEC,
+           nb_frames * 1000000.0 / wall,
+           (double)cpu / CLOCKS_PER_SEC * 1000000.0 /
+               (wall * (int64_t)dec->thread_count));
+#ifdef AV_READ_TIME
+    printf(" cycles_per_frame=%"PRIu64, cycles / nb_frames);
+#endif
+    printf("\n");
+    ret = 0;
+
+fail:
+    av_frame_free(&frame);
+    avcodec_free_context(&dec);
+    return ret;
+}
+
+int main(int argc, char **argv)
+{
+    AVFormatContext *demuxer = NULL;
+    AVCodecParameters *par = NULL;
+    const AVCodec *codec;
+    AVPacket *pkt = NULL, **pkts = NULL;
+    int nb_pkts = 0, alloc_pkts = 0;
+    int stream_idx, threads = 0, runs = 1;
+    int ret;
+
+    if (argc < 2) {
+        fprintf(stderr, "Usage: %s <input> [<threads> [<runs>]]\n"
+                "Decodes the best video stream of <input> from preloaded "
+                "packets and reports throughput.\n", argv[0]);
+        return 1;
+    }
+    if (argc > 2)
+        threads = atoi(argv[2]);
+    if (argc > 3)
+        runs = atoi(argv[3]);
+    if (threads < 0 || runs < 1) {
+        fprintf(stderr, "Invalid thread/run count\n");
+        return 1;
+    }
+
+    ret = avformat_open_input(&demuxer, argv[1], NULL, NULL);
+    if (ret < 0) {
+        fprintf(stderr, "Error opening input file: %s\n", av_err2str(ret));
+        return 1;
+    }
+    ret = avformat_find_stream_info(demuxer, NULL);
+    if (ret < 0)
+        goto fail;
+
+    ret = av_find_best_stream(demuxer, AVMEDIA_TYPE_VIDEO, -1, -1, NULL, 0);
+    if (ret < 0) {
+        fprintf(stderr, "No video stream found\n");
+        goto fail;
+    }
+    stream_idx = ret;
+
+    par = avcodec_parameters_alloc();
+    if (!par) {
+        ret = AVERROR(ENOMEM);
+        goto fail;
+    }
+    ret = avcodec_parameters_copy(par, demuxer->streams[stream_idx]->codecpar);
+    if (ret < 0)
+        goto fail;
+
+    codec = avcodec_find_decoder(par->codec_id);
+    if (!codec) {
+        fprintf(stderr, "No decoder for %s\n", avcodec_get_name(par->codec_id));
+        ret = AVERROR_DECODER_NOT_FOUND;
+        goto fail;
+    }
+
+    /* preload the whole stream, so the timed loop does no I/O */
+    pkt = av_packet_alloc();
+    if (!pkt) {
+        ret = AVERROR(ENOMEM);
+        goto fail;
+    }
+    while ((ret = av_read_frame(demuxer, pkt)) >= 0) {
+        if (pkt->stream_index != stream_idx) {
+            av_packet_unref(pkt);
+            continue;
+        }
+        if (nb_pkts == alloc_pkts) {
+            alloc_pkts = alloc_pkts ? alloc_pkts * 2 : 1024;
+            ret = av_reallocp_array(&pkts, alloc_pkts, sizeof(*pkts));
+            if (ret < 0)
+                goto fail;
+        }
+        pkts[nb_pkts] = av_packet_clone(pkt);
+        if (!pkts[nb_pkts]) {
+            ret = AVERROR(ENOMEM);
+            goto fail;
+        }
+        nb_pkts++;
+        av_packet_unref(pkt);
+    }
+    if (ret != AVERROR_EOF)
+        goto fail;
+    avformat_close_input(&demuxer);
+
+    if (!nb_pkts) {
+        fprintf(stderr, "No packets in the selected stream\n");
+        ret = AVERROR(EINVAL);
+        goto fail;
+    }
+
+    for (int i = 0; i < runs; i++) {
+        ret = run_once(codec, par, pkts, nb_pkts, threads, i);
+        if (ret < 0)
+            goto fail;
+    }
+    ret = 0;
+
+fail:
+    for (int i = 0; i < nb_pkts; i++)
+        av_packet_free(&pkts[i]);
+    av_freep(&pkts);
+    av_packet_free(&pkt);
+    avcodec_parameters_free(&par);
+    avformat_close_input(&demuxer);
+    return ret < 0;
+}
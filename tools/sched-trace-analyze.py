@@ -0,0 +1,117 @@
+#!/usr/bin/env python3
+
+import argparse
+import sys
+from collections import defaultdict
+
+HELP = '''
+Analyze an ffmpeg scheduler queue trace.
+
+The input is the file written when ffmpeg runs with the FFMPEG_SCHED_TRACE
+environment variable set to a path. Each line records one completed queue
+operation:
+
+    <time_us> <queue> <stream> <op> <fill> <blocked_us>
+
+where <queue> names the inter-thread queue feeding a node (dec0, fg0,
+enc0, mux0, ...), <op> is 's' for a send or 'r' for a receive, <fill> is
+the queue fill level after the operation and <blocked_us> is how long the
+thread had to wait for that operation to become possible.
+
+A producer blocked on sends points at a slow consumer downstream of the
+queue; a consumer blocked on receives points at a slow producer upstream.
+The report totals blocked time per queue and direction and lists the
+longest individual stalls, so the node limiting the pipeline can be read
+off directly.
+'''
+
+
+class QueueStats:
+    def __init__(self):
+        self.nb_sent = 0
+        self.nb_received = 0
+        self.send_blocked_us = 0
+        self.recv_blocked_us = 0
+        self.max_fill = 0
+
+
+def main():
+    parser = argparse.ArgumentParser(
+        description=HELP, formatter_class=argparse.RawDescriptionHelpFormatter)
+    parser.add_argument('trace', help='trace file written by FFMPEG_SCHED_TRACE')
+    parser.add_argument('--stalls', type=int, default=10,
+                        help='number of longest individual stalls to list (default: 10)')
+    args = parser.parse_args()
+
+    queues = defaultdict(QueueStats)
+    stalls = []
+    first_time = last_time = None
+
+    with open(args.trace) as f:
+        for line in f:
+            try:
+                time_us, queue, stream, op, fill, blocked_us = line.split()
+                time_us = int(time_us)
+                fill = int(fill)
+                blocked_us = int(blocked_us)
+            except ValueError:
+                print(f'malformed trace line: {line.rstrip()}', file=sys.stderr)
+                continue
+
+            if first_time is None:
+                first_time = time_us
+            last_time = time_us
+
+            q = queues[queue]
+            q.max_fill = max(q.max_fill, fill)
+            if op == 's':
+                q.nb_sent += 1
+                q.send_blocked_us += blocked_us
+            else:
+                q.nb_received += 1
+                q.recv_blocked_us += blocked_us
+
+            if blocked_us > 0:
+                stalls.append((blocked_us, time_us, queue, stream, op))
+
+    if first_time is None:
+        print('empty trace', file=sys.stderr)
+        return 1
+
+    duration_us = max(last_time - first_time, 1)
+    print(f'trace spans {duration_us / 1e6:.3f} s, {len(queues)} queues')
+    print()
+
+    header = f'{"queue":<10} {"sent":>10} {"recv":>10} {"max_fill":>8} ' \
+             f'{"send_blocked":>14} {"recv_blocked":>14}'
+    print(header)
+    for name in sorted(queues):
+        q = queues[name]
+        print(f'{name:<10} {q.nb_sent:>10} {q.nb_received:>10} {q.max_fill:>8} '
+              f'{q.send_blocked_us / 1e6:>12.3f} s {q.recv_blocked_us / 1e6:>12.3f} s')
+    print()
+
+    # the node whose consumers starve the most is the likely bottleneck
+    bottleneck = max(queues, key=lambda n: queues[n].send_blocked_us)
+    blocked = queues[bottleneck].send_blocked_us
+    if blocked > 0:
+        print(f'producers into {bottleneck} were blocked for '
+              f'{blocked / 1e6:.3f} s ({100 * blocked / duration_us:.1f}% of the trace); '
+              f'the node reading from {bottleneck} limits the pipeline')
+    else:
+        print('no producer was ever blocked; the pipeline is input-limited')
+    print()
+
+    stalls.sort(reverse=True)
+    if stalls:
+        print(f'{len(stalls)} stalls, longest {args.stalls}:')
+        for blocked_us, time_us, queue, stream, op in stalls[:args.stalls]:
+            what = 'send' if op == 's' else 'receive'
+            print(f'  +{(time_us - first_time) / 1e6:>9.3f}s  {queue} stream {stream}: '
+                  f'{what} blocked for {blocked_us / 1e6:.3f} s')
+
+    return 0
+
+
+if __name__ == '__main__':
+    sys.exit(main())
@@ -0,0 +1,185 @@
+#!/usr/bin/env python3
+
+import argparse
+import json
+import logging
+import os
+import shlex
+import subprocess
+import sys
+import tempfile
+
+HELP = '''
+Frame-accurate cutting with bitstream pass-through ("smart cut").
+
+Cut points usually fall in the middle of a GOP, so a frame-accurate cut
+with -c copy is impossible and re-encoding the whole clip is wasteful.
+This command re-encodes only the GOPs containing the in and out points:
+it uses ffprobe to locate the keyframes surrounding the cut points,
+re-encodes the head (from the in point to the next keyframe) and the
+tail (from the last keyframe before the out point), stream-copies
+everything in between, and stitches the segments with the concat
+demuxer.
+
+For the stitch to be valid the re-encoded segments must match the
+copied bitstream (codec, profile/level, resolution, pixel format, ...).
+The command derives an encoder and basic parameters from the input, but
+exact parameter matching is codec and encoder specific; pass explicit
+encoding arguments after options when needed, for example:
+smartcut.py -i in.mp4 -o out.mp4 -ss 63.2 -to 247.9 -- -c:v libx264 -profile:v high -level 4.1
+'''
+
+logging.basicConfig(format='smartcut|%(levelname)s> %(message)s', level=logging.INFO)
+log = logging.getLogger()
+
+# default encoders used to re-encode the boundary GOPs
+ENCODERS = {
+    'h264':       'libx264',
+    'hevc':       'libx265',
+    'mpeg2video': 'mpeg2video',
+    'mpeg4':      'mpeg4',
+    'vp8':        'libvpx',
+    'vp9':        'libvpx-vp9',
+    'av1':        'libaom-av1',
+}
+
+
+class Formatter(
+    argparse.ArgumentDefaultsHelpFormatter, argparse.RawDescriptionHelpFormatter
+):
+    pass
+
+
+def run_command(cmd, dry_run=False, output=False):
+    log.info(f"Running command:\n$ {shlex.join(cmd)}")
+    if dry_run:
+        return None
+    return subprocess.run(cmd, check=True,
+                          stdout=subprocess.PIPE if output else None)
+
+
+def probe_video_stream(ffprobe, path):
+    cmd = [
+        ffprobe, '-v', 'error', '-select_streams', 'v:0', '-show_entries',
+        'stream=codec_name,width,height,pix_fmt,avg_frame_rate', '-of', 'json',
+        path,
+    ]
+    result = run_command(cmd, output=True)
+    streams = json.loads(result.stdout).get('streams')
+    if not streams:
+        raise SystemExit(f"no video stream found in {path}")
+    return streams[0]
+
+
+def probe_keyframes(ffprobe, path, interval):
+    cmd = [
+        ffprobe, '-v', 'error', '-select_streams', 'v:0',
+        '-skip_frame', 'nokey', '-show_entries', 'frame=pts_time',
+        '-of', 'csv=p=0', '-read_intervals', interval, path,
+    ]
+    result = run_command(cmd, output=True)
+    return sorted(float(line) for line in result.stdout.splitlines() if line.strip())
+
+
+def smartcut():
+    parser = argparse.ArgumentParser(description=HELP, formatter_class=Formatter)
+    parser.add_argument('--input', '-i', required=True, help='specify input file')
+    parser.add_argument('--output', '-o', required=True, help='specify output file')
+    parser.add_argument('--start', '-ss', type=float, required=True, help='cut in point in seconds')
+    parser.add_argument('--end', '-to', type=float, required=True, help='cut out point in seconds')
+    parser.add_argument('--ffmpeg', default='ffmpeg', help='ffmpeg executable')
+    parser.add_argument('--ffprobe', default='ffprobe', help='ffprobe executable')
+    parser.add_argument('--probe-window', type=float, default=600,
+                        help='how far around the cut points to look for keyframes, in seconds')
+    parser.add_argument('--keep-temp', action='store_true', help='keep the intermediate segments')
+    parser.add_argument('--dry-run', '-n', help='simulate commands', action='store_true')
+    parser.add_argument('encode_arguments', nargs='*',
+                        help='specify encode options used for the boundary segments')
+
+    args = parser.parse_args()
+    if args.end <= args.start:
+        parser.error('end point must be after start point')
+
+    stream = probe_video_stream(args.ffprobe, args.input)
+    codec = stream['codec_name']
+    encoder = ENCODERS.get(codec)
+    if not encoder and not args.encode_arguments:
+        raise SystemExit(f"no default encoder known for {codec}, "
+                         "pass encoding arguments explicitly")
+
+    # half a frame of tolerance when comparing cut points against keyframes
+    epsilon = 0.001
+    rate = stream.get('avg_frame_rate', '')
+    if '/' in rate and not rate.endswith('/0'):
+        num, den = rate.split('/')
+        epsilon = float(den) / float(num) / 2
+
+    head_kfs = probe_keyframes(args.ffprobe, args.input,
+                               f'{args.start}%+{args.probe_window}')
+    tail_kfs = probe_keyframes(args.ffprobe, args.input,
+                               f'{max(args.end - args.probe_window, 0)}%{args.end + epsilon}')
+
+    # first keyframe at/after the in point and last keyframe at/before the
+    # out point delimit the stream-copied middle
+    kf_in  = next((t for t in head_kfs if t >= args.start - epsilon), None)
+    kf_out = next((t for t in reversed(tail_kfs) if t <= args.end + epsilon), None)
+
+    encode_args = ['-c:v', encoder] if encoder else []
+    if 'pix_fmt' in stream:
+        encode_args += ['-pix_fmt', stream['pix_fmt']]
+    encode_args += args.encode_arguments
+
+    def segment_cmd(start, end, codec_args, out):
+        return [args.ffmpeg, '-v', 'error', '-y', '-ss', f'{start:.6f}',
+                '-to', f'{end:.6f}', '-i', args.input, '-map', '0',
+                '-avoid_negative_ts', 'make_zero', '-c', 'copy',
+                *codec_args, out]
+
+    ext = os.path.splitext(args.output)[1] or '.mkv'
+    tmp = tempfile.mkdtemp(prefix='smartcut-')
+    segments = []
+
+    def add_segment(kind, start, end, codec_args):
+        out = os.path.join(tmp, f'{len(segments):02d}-{kind}{ext}')
+        log.info(f'{kind} segment: [{start:.6f}, {end:.6f}]')
+        run_command(segment_cmd(start, end, codec_args, out), args.dry_run)
+        segments.append(out)
+
+    if kf_in is None or kf_out is None or kf_out - kf_in <= epsilon:
+        log.info('no keyframe span to copy, re-encoding the whole cut')
+        add_segment('encode', args.start, args.end, encode_args)
+    else:
+        if kf_in - args.start > epsilon:
+            add_segment('head', args.start, kf_in, encode_args)
+        add_segment('copy', kf_in, kf_out, [])
+        if args.end - kf_out > epsilon:
+            add_segment('tail', kf_out, args.end, encode_args)
+
+    if len(segments) == 1:
+        run_command([args.ffmpeg, '-v', 'error', '-y', '-i', segments[0],
+                     '-map', '0', '-c', 'copy', args.output], args.dry_run)
+    else:
+        concat = os.path.join(tmp, 'segments.ffconcat')
+        if not args.dry_run:
+            with open(concat, 'w') as f:
+                f.write('ffconcat version 1.0\n')
+                for seg in segments:
+                    f.write(f"file '{seg}'\n")
+        run_command([args.ffmpeg, '-v', 'error', '-y', '-f', 'concat',
+                     '-safe', '0', '-i', concat, '-map', '0', '-c', 'copy',
+                     args.output], args.dry_run)
+
+    if args.keep_temp:
+        log.info(f'intermediate segments kept in {tmp}')
+    else:
+        for name in os.listdir(tmp):
+            os.unlink(os.path.join(tmp, name))
+        os.rmdir(tmp)
+    log.info(f'wrote {args.output}')
+
+
+if __name__ == '__main__':
+    try:
+        smartcut()
+    except subprocess.CalledProcessError as e:
+        sys.exit(f'command failed with status {e.returncode}')